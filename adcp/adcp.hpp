@@ -407,7 +407,7 @@ ToOneCTx CreateCTx(PP &pp, Account &Acct_sender, BigInt &v, ECPoint &pkr)
 
     auto start_time = std::chrono::steady_clock::now(); 
 
-    std::string transcript_str = "";
+    Transcript transcript;
     newCTx.sn = Acct_sender.sn;
     newCTx.pks = Acct_sender.pk; 
     newCTx.pkr = pkr; 
@@ -434,7 +434,7 @@ ToOneCTx CreateCTx(PP &pp, Account &Acct_sender, BigInt &v, ECPoint &pkr)
     plaintext_equality_witness.v = v; 
 
     newCTx.plaintext_equality_proof = PlaintextEquality::Prove(plaintext_equality_pp, plaintext_equality_instance, plaintext_equality_witness, 
-                             transcript_str);
+                             transcript);
 
     // PlaintextEquality::PrintProof(newCTx.plaintext_equality_proof); 
 
@@ -471,7 +471,7 @@ ToOneCTx CreateCTx(PP &pp, Account &Acct_sender, BigInt &v, ECPoint &pkr)
     plaintext_knowledge_witness.v = Acct_sender.m - v; 
 
     newCTx.plaintext_knowledge_proof = PlaintextKnowledge::Prove(plaintext_knowledge_pp, plaintext_knowledge_instance, plaintext_knowledge_witness, 
-                              transcript_str); 
+                              transcript); 
 
     #ifdef DEMO
         std::cout << "6. generate range proofs for transfer amount and updated balance" << std::endl;    
@@ -485,7 +485,7 @@ ToOneCTx CreateCTx(PP &pp, Account &Acct_sender, BigInt &v, ECPoint &pkr)
     bullet_witness.r = {plaintext_equality_witness.r, plaintext_knowledge_witness.r}; 
     bullet_witness.v = {plaintext_equality_witness.v, plaintext_knowledge_witness.v};
 
-    Bullet::Prove(pp.bullet_part, bullet_instance, bullet_witness, transcript_str, newCTx.bullet_right_solvent_proof); 
+    Bullet::Prove(pp.bullet_part, bullet_instance, bullet_witness, transcript, newCTx.bullet_right_solvent_proof); 
 
     #ifdef DEMO
         std::cout << "7. generate NIZKPoK for correct refreshing and authenticate the ctx" << std::endl;  
@@ -503,9 +503,9 @@ ToOneCTx CreateCTx(PP &pp, Account &Acct_sender, BigInt &v, ECPoint &pkr)
     DLOGEquality::Witness dlog_equality_witness;  
     dlog_equality_witness.w = Acct_sender.sk; 
 
-    transcript_str += ExtractToSignMessageFromCTx(newCTx);
+    transcript.Append("CTx", ExtractToSignMessageFromCTx(newCTx));
     newCTx.correct_refresh_proof = DLOGEquality::Prove(dlog_equality_pp, dlog_equality_instance, dlog_equality_witness, 
-                        transcript_str); 
+                        transcript); 
 
     #ifdef DEMO
         PrintSplitLine('-'); 
@@ -533,7 +533,7 @@ bool VerifyCTx(PP &pp, ToOneCTx &newCTx)
     bool Validity; 
     bool condition1, condition2, condition3, condition4; 
 
-    std::string transcript_str = "";
+    Transcript transcript;
 
     PlaintextEquality::PP plaintext_equality_pp = PlaintextEquality::Setup(pp.enc_part);
 
@@ -542,7 +542,7 @@ bool VerifyCTx(PP &pp, ToOneCTx &newCTx)
     plaintext_equality_instance.ct = newCTx.transfer_ct;
 
     condition1 = PlaintextEquality::Verify(plaintext_equality_pp, plaintext_equality_instance, 
-                                   transcript_str, newCTx.plaintext_equality_proof);
+                                   transcript, newCTx.plaintext_equality_proof);
     #ifdef DEMO
         if (condition1) std::cout << "NIZKPoK for plaintext equality accepts" << std::endl; 
         else std::cout << "NIZKPoK for plaintext equality rejects" << std::endl; 
@@ -555,7 +555,7 @@ bool VerifyCTx(PP &pp, ToOneCTx &newCTx)
     plaintext_knowledge_instance.ct = newCTx.refresh_sender_updated_balance_ct;  
 
     condition2 = PlaintextKnowledge::Verify(plaintext_knowledge_pp, plaintext_knowledge_instance, 
-                                    transcript_str, newCTx.plaintext_knowledge_proof);
+                                    transcript, newCTx.plaintext_knowledge_proof);
 
     #ifdef DEMO
         if (condition2) std::cout << "NIZKPoK for refresh updated balance accepts" << std::endl; 
@@ -567,7 +567,7 @@ bool VerifyCTx(PP &pp, ToOneCTx &newCTx)
     Bullet::Instance bullet_instance;
     bullet_instance.C = {newCTx.transfer_ct.Y, newCTx.refresh_sender_updated_balance_ct.Y};
 
-    condition3 = Bullet::FastVerify(pp.bullet_part, bullet_instance, transcript_str, newCTx.bullet_right_solvent_proof); 
+    condition3 = Bullet::FastVerify(pp.bullet_part, bullet_instance, transcript, newCTx.bullet_right_solvent_proof); 
 
     #ifdef DEMO
         if (condition3) std::cout << "range proofs for transfer amount and updated balance accept" << std::endl; 
@@ -590,8 +590,8 @@ bool VerifyCTx(PP &pp, ToOneCTx &newCTx)
     dlog_equality_instance.g2 = pp.enc_part.g; 
     dlog_equality_instance.h2 = newCTx.pks;  
 
-    transcript_str += ExtractToSignMessageFromCTx(newCTx);
-    condition4 = DLOGEquality::Verify(dlog_equality_pp, dlog_equality_instance, transcript_str, newCTx.correct_refresh_proof); 
+    transcript.Append("CTx", ExtractToSignMessageFromCTx(newCTx));
+    condition4 = DLOGEquality::Verify(dlog_equality_pp, dlog_equality_instance, transcript, newCTx.correct_refresh_proof); 
     #ifdef DEMO
         if (condition4) std::cout << "NIZKPoK for refreshing correctness accepts and memo info is authenticated" << std::endl; 
         else std::cout << "NIZKPoK for refreshing correctness rejects or memo info is unauthenticated" << std::endl; 
@@ -685,8 +685,8 @@ DLOGEquality::Proof JustifyPolicy(PP &pp, Account &Acct_user, ToOneCTx &doubtCTx
     DLOGEquality::Witness dlogeq_witness; 
     dlogeq_witness.w = Acct_user.sk; 
 
-    std::string transcript_str = ""; 
-    DLOGEquality::Proof open_proof = DLOGEquality::Prove(dlogeq_pp, dlogeq_instance, dlogeq_witness, transcript_str); 
+    Transcript transcript; 
+    DLOGEquality::Proof open_proof = DLOGEquality::Prove(dlogeq_pp, dlogeq_instance, dlogeq_witness, transcript); 
     
     auto end_time = std::chrono::steady_clock::now(); 
 
@@ -723,8 +723,8 @@ bool AuditPolicy(PP &pp, Account &Acct_user, ToOneCTx &doubtCTx,
     }
     bool validity;
 
-    std::string transcript_str = "";
-    validity = DLOGEquality::Verify(dlogeq_pp, dlogeq_instance, transcript_str, open_proof); 
+    Transcript transcript;
+    validity = DLOGEquality::Verify(dlogeq_pp, dlogeq_instance, transcript, open_proof); 
 
     auto end_time = std::chrono::steady_clock::now(); 
 
@@ -760,6 +760,7 @@ DLOGEquality::Proof JustifyPolicy(PP &pp, Account &Acct_user, ToOneCTx &ctx1, To
 
     DLOGEquality::Instance dlogeq_instance; 
     dlogeq_instance.g1 = pp.enc_part.g;     // g1 = g 
+    dlogeq_instance.G1_IS_GENERATOR = pp.enc_part.G_IS_GENERATOR; 
     dlogeq_instance.h1 = Acct_user.pk; // g2 = pk = g^sk
 
     TwistedExponentialElGamal::CT ct_in; 
@@ -780,8 +781,8 @@ DLOGEquality::Proof JustifyPolicy(PP &pp, Account &Acct_user, ToOneCTx &ctx1, To
     DLOGEquality::Witness dlogeq_witness; 
     dlogeq_witness.w = Acct_user.sk; 
 
-    std::string transcript_str = ""; 
-    DLOGEquality::Proof rate_proof = DLOGEquality::Prove(dlogeq_pp, dlogeq_instance, dlogeq_witness, transcript_str); 
+    Transcript transcript; 
+    DLOGEquality::Proof rate_proof = DLOGEquality::Prove(dlogeq_pp, dlogeq_instance, dlogeq_witness, transcript); 
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
@@ -806,6 +807,7 @@ bool AuditPolicy(PP &pp, ECPoint pk, ToOneCTx &ctx1, ToOneCTx &ctx2,
 
     DLOGEquality::Instance dlogeq_instance; 
     dlogeq_instance.g1 = pp.enc_part.g;     // g1 = g 
+    dlogeq_instance.G1_IS_GENERATOR = pp.enc_part.G_IS_GENERATOR; 
     dlogeq_instance.h1 = pk; // g2 = pk = g^sk
 
     TwistedExponentialElGamal::CT ct_in; 
@@ -823,8 +825,8 @@ bool AuditPolicy(PP &pp, ECPoint pk, ToOneCTx &ctx1, ToOneCTx &ctx2,
     dlogeq_instance.g2 = ct_diff.Y; 
     dlogeq_instance.h2 = ct_diff.X; 
 
-    std::string transcript_str = ""; 
-    bool validity = DLOGEquality::Verify(dlogeq_pp, dlogeq_instance, transcript_str, rate_proof); 
+    Transcript transcript; 
+    bool validity = DLOGEquality::Verify(dlogeq_pp, dlogeq_instance, transcript, rate_proof); 
 
     auto end_time = std::chrono::steady_clock::now(); 
 
@@ -879,9 +881,9 @@ bool JustifyPolicy(PP &pp, Account &Acct_user, std::vector<ToOneCTx> &ctx_set,
     Gadget::Witness_type2 witness;
     witness.sk = Acct_user.sk;  
 
-    std::string transcript_str = ""; 
+    Transcript transcript; 
 
-    Gadget::Prove(gadget_pp, instance, policy.LEFT_BOUND, policy.RIGHT_BOUND, witness, transcript_str, limit_proof); 
+    Gadget::Prove(gadget_pp, instance, policy.LEFT_BOUND, policy.RIGHT_BOUND, witness, transcript, limit_proof); 
     
     auto end_time = std::chrono::steady_clock::now(); 
 
@@ -921,9 +923,9 @@ bool AuditPolicy(PP &pp, ECPoint pk, std::vector<ToOneCTx> &ctx_set,
     instance.pk = pk; 
     instance.ct.X = ct_sum.X; instance.ct.Y = ct_sum.Y; 
 
-    std::string transcript_str = ""; 
+    Transcript transcript; 
 
-    bool validity = Gadget::Verify(gadget_pp, instance,  policy.LEFT_BOUND, policy.RIGHT_BOUND, transcript_str, limit_proof); 
+    bool validity = Gadget::Verify(gadget_pp, instance,  policy.LEFT_BOUND, policy.RIGHT_BOUND, transcript, limit_proof); 
 
     auto end_time = std::chrono::steady_clock::now(); 
 
@@ -1056,7 +1058,7 @@ ToManyCTx CreateCTx(PP &pp, Account &Acct_sender, std::vector<BigInt> &vec_v, st
 
     auto start_time = std::chrono::steady_clock::now();
 
-    std::string transcript_str = "";  
+    Transcript transcript;  
     newCTx.sn = Acct_sender.sn;
     newCTx.pks = Acct_sender.pk; 
     newCTx.vec_pkr = vec_pkr; 
@@ -1096,7 +1098,7 @@ ToManyCTx CreateCTx(PP &pp, Account &Acct_sender, std::vector<BigInt> &vec_v, st
         plaintext_equality_witness.r = vec_r[i]; 
         plaintext_equality_witness.v = vec_v[i]; 
         newCTx.vec_plaintext_equality_proof[i] = PlaintextEquality::Prove(plaintext_equality_pp, plaintext_equality_instance, 
-                                 plaintext_equality_witness, transcript_str);
+                                 plaintext_equality_witness, transcript);
     }
 
     #ifdef DEMO
@@ -1130,7 +1132,7 @@ ToManyCTx CreateCTx(PP &pp, Account &Acct_sender, std::vector<BigInt> &vec_v, st
     plaintext_knowledge_witness.v = Acct_sender.m - v; 
 
     newCTx.plaintext_knowledge_proof = PlaintextKnowledge::Prove(plaintext_knowledge_pp, plaintext_knowledge_instance, plaintext_knowledge_witness, 
-                              transcript_str); 
+                              transcript); 
 
 
     #ifdef DEMO
@@ -1152,7 +1154,7 @@ ToManyCTx CreateCTx(PP &pp, Account &Acct_sender, std::vector<BigInt> &vec_v, st
     bullet_witness.r.emplace_back(plaintext_knowledge_witness.r); 
     bullet_witness.v.emplace_back(plaintext_knowledge_witness.v);
 
-    Bullet::Prove(pp.bullet_part, bullet_instance, bullet_witness, transcript_str, newCTx.bullet_right_solvent_proof); 
+    Bullet::Prove(pp.bullet_part, bullet_instance, bullet_witness, transcript, newCTx.bullet_right_solvent_proof); 
 
     #ifdef DEMO
         std::cout << "7. generate NIZKPoK for v = v_1+...+v_n" << std::endl;    
@@ -1161,6 +1163,7 @@ ToManyCTx CreateCTx(PP &pp, Account &Acct_sender, std::vector<BigInt> &vec_v, st
 
     DLOGKnowledge::Instance dlog_knowledge_instance;
     dlog_knowledge_instance.g = pp.enc_part.g; 
+    dlog_knowledge_instance.G_IS_GENERATOR = pp.enc_part.G_IS_GENERATOR; 
     dlog_knowledge_instance.h = newCTx.sender_transfer_ct.Y; 
     for(auto i = 0; i < n; i++){
         dlog_knowledge_instance.h -= newCTx.vec_receiver_transfer_ct[i].Y; 
@@ -1172,7 +1175,7 @@ ToManyCTx CreateCTx(PP &pp, Account &Acct_sender, std::vector<BigInt> &vec_v, st
     }
 
     newCTx.balance_proof = DLOGKnowledge::Prove(dlog_knowledge_pp, dlog_knowledge_instance, dlog_knowledge_witness, 
-                         transcript_str);
+                         transcript);
 
     #ifdef DEMO
         std::cout << "8. generate NIZKPoK for correct refreshing and authenticate the ctx" << std::endl;  
@@ -1190,9 +1193,9 @@ ToManyCTx CreateCTx(PP &pp, Account &Acct_sender, std::vector<BigInt> &vec_v, st
     DLOGEquality::Witness dlog_equality_witness;  
     dlog_equality_witness.w = Acct_sender.sk; 
 
-    transcript_str += ExtractToSignMessageFromCTx(newCTx); 
+    transcript.Append("CTx", ExtractToSignMessageFromCTx(newCTx)); 
     newCTx.correct_refresh_proof = DLOGEquality::Prove(dlog_equality_pp, dlog_equality_instance, dlog_equality_witness, 
-                        transcript_str); 
+                        transcript); 
 
     #ifdef DEMO
         PrintSplitLine('-'); 
@@ -1220,7 +1223,7 @@ bool VerifyCTx(PP &pp, ToManyCTx &newCTx)
         std::cout << "begin to verify " <<ctx_type << " ctx >>>>>>" << std::endl; 
     #endif
 
-    std::string transcript_str = "";
+    Transcript transcript;
 
 
     auto start_time = std::chrono::steady_clock::now(); 
@@ -1234,7 +1237,7 @@ bool VerifyCTx(PP &pp, ToManyCTx &newCTx)
         plaintext_equality_instance.vec_pk = {newCTx.vec_pkr[i], pp.pka}; 
         plaintext_equality_instance.ct = newCTx.vec_receiver_transfer_ct[i]; 
         if(PlaintextEquality::Verify(plaintext_equality_pp, plaintext_equality_instance, 
-                                     transcript_str, newCTx.vec_plaintext_equality_proof[i]) == false){
+                                     transcript, newCTx.vec_plaintext_equality_proof[i]) == false){
             condition1 = false;
         }
     }
@@ -1254,7 +1257,7 @@ bool VerifyCTx(PP &pp, ToManyCTx &newCTx)
     plaintext_knowledge_instance.ct = newCTx.refresh_sender_updated_balance_ct;  
 
     condition2 = PlaintextKnowledge::Verify(plaintext_knowledge_pp, plaintext_knowledge_instance, 
-                                            transcript_str, newCTx.plaintext_knowledge_proof);
+                                            transcript, newCTx.plaintext_knowledge_proof);
 
     #ifdef DEMO
         if (condition2) std::cout << "NIZKPoK for refresh updated balance accepts" << std::endl; 
@@ -1270,7 +1273,7 @@ bool VerifyCTx(PP &pp, ToManyCTx &newCTx)
     }
 
     bullet_instance.C.emplace_back(newCTx.refresh_sender_updated_balance_ct.Y);
-    condition3 = Bullet::FastVerify(pp.bullet_part, bullet_instance, transcript_str, newCTx.bullet_right_solvent_proof); 
+    condition3 = Bullet::FastVerify(pp.bullet_part, bullet_instance, transcript, newCTx.bullet_right_solvent_proof); 
 
     #ifdef DEMO
         if (condition3) std::cout << "range proofs for transfer amount and updated balance accept" << std::endl; 
@@ -1284,12 +1287,13 @@ bool VerifyCTx(PP &pp, ToManyCTx &newCTx)
 
     DLOGKnowledge::Instance dlog_knowledge_instance;
     dlog_knowledge_instance.g = pp.enc_part.g; 
+    dlog_knowledge_instance.G_IS_GENERATOR = pp.enc_part.G_IS_GENERATOR; 
     dlog_knowledge_instance.h = newCTx.sender_transfer_ct.Y; 
     for(auto i = 0; i < n; i++){
         dlog_knowledge_instance.h -= newCTx.vec_receiver_transfer_ct[i].Y; 
     } 
 
-    condition4 = DLOGKnowledge::Verify(dlog_knowledge_pp, dlog_knowledge_instance, transcript_str, newCTx.balance_proof);
+    condition4 = DLOGKnowledge::Verify(dlog_knowledge_pp, dlog_knowledge_instance, transcript, newCTx.balance_proof);
 
     #ifdef DEMO
         if (condition4) std::cout << "NIZKPoK for balance proof accepts" << std::endl; 
@@ -1309,9 +1313,9 @@ bool VerifyCTx(PP &pp, ToManyCTx &newCTx)
     dlog_equality_instance.g2 = pp.enc_part.g; 
     dlog_equality_instance.h2 = newCTx.pks;  
 
-    transcript_str += ExtractToSignMessageFromCTx(newCTx);
+    transcript.Append("CTx", ExtractToSignMessageFromCTx(newCTx));
     condition5 = DLOGEquality::Verify(dlog_equality_pp, dlog_equality_instance, 
-                                      transcript_str, newCTx.correct_refresh_proof); 
+                                      transcript, newCTx.correct_refresh_proof); 
 
     #ifdef DEMO
         if (condition5) std::cout << "NIZKPoK for refreshing correctness accepts and ctx is authenticated" << std::endl; 
@@ -8,6 +8,7 @@ namespace Pedersen{
 struct PP
 {
     ECPoint g; 
+    bool G_IS_GENERATOR = false;
     std::vector<ECPoint> vec_h;  
     size_t N_max; 
 };
@@ -18,6 +19,7 @@ PP Setup(size_t N_max)
     PP pp;
     pp.N_max = N_max;
     pp.g = ECPoint(generator); 
+    pp.G_IS_GENERATOR = true; 
     /* 
     ** warning: the following method is ad-hoc and insafe cause it is not transparent
     ** we left a secure hash to many points mapping as the future work   
@@ -34,7 +36,7 @@ ECPoint Commit(PP &pp, std::vector<BigInt>& vec_m, BigInt r)
     }
     size_t LEN = vec_m.size();
     std::vector<ECPoint> subvec_h(pp.vec_h.begin(), pp.vec_h.begin() + LEN);
-    ECPoint commitment = pp.g * r + ECPointVectorMul(subvec_h, vec_m);
+    ECPoint commitment = GPower(pp.g, pp.G_IS_GENERATOR, r) + ECPointVectorMul(subvec_h, vec_m);
     return commitment;   
 }
 
@@ -9,6 +9,9 @@
 #include "../include/global.hpp"
 #include "block.hpp"
 
+// comment this line if the compiler does not know the vaes/avx512f targets (gcc < 8, clang < 6)
+#define ENABLE_VAES
+
 namespace AES{
 
 using Serialization::operator<<; 
@@ -16,6 +19,8 @@ using Serialization::operator>>;
 
 inline const block IV = Block::zero_block; 
 inline const size_t BATCH_SIZE = 8;
+// ECBEnc/ECBDec on fewer blocks run on the calling thread: waking a thread team costs more than the AES work
+inline const size_t ECB_PARALLEL_BLOCK_LEN = 1 << 10;
 
 struct Key{ 
     block roundkey[11]; 
@@ -54,6 +59,37 @@ std::ifstream &operator>>(std::ifstream &fin, Key &key)
 inline Key fixed_enc_key; // global aes enc key
 inline Key fixed_dec_key; // global aes dec key
 
+/*
+** FastECBEnc picks its kernel at runtime: AES-NI (8 blocks per round key) runs everywhere,
+** VAES on ymm (16 blocks) and on zmm (32 blocks) are used when cpuid reports them
+*/
+enum Backend{
+    AESNI = 0,
+    VAES256 = 1, // VAES + AVX2
+    VAES512 = 2, // VAES + AVX-512F
+};
+
+inline Backend backend = AESNI; // set by AES_Initialize()
+
+Backend DetectBackend()
+{
+    #ifdef ENABLE_VAES
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("vaes") && __builtin_cpu_supports("avx512f")) return VAES512;
+        if (__builtin_cpu_supports("vaes") && __builtin_cpu_supports("avx2")) return VAES256;
+    #endif
+    return AESNI;
+}
+
+std::string BackendName(Backend b)
+{
+    switch (b){
+        case VAES512: return "VAES-512";
+        case VAES256: return "VAES-256";
+        default: return "AES-NI";
+    }
+}
+
 
 #define EXPAND_ASSIST(v1, v2, v3, v4, SHUFFLE_CONST, AES_CONST)                               \
     v2 = _mm_aeskeygenassist_si128(v4, AES_CONST);                                          \
@@ -138,7 +174,7 @@ inline void Dec(const Key &key, block &data)
 __attribute__((target("aes,sse2")))
 inline void ECBEnc(const Key &key, block* data, size_t BLOCK_LEN) 
 {
-    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS) if(BLOCK_LEN >= ECB_PARALLEL_BLOCK_LEN)
     for (auto i = 0; i < BLOCK_LEN; i++)
         Enc(key, data[i]);
 }
@@ -148,9 +184,8 @@ inline void ECBEnc(const Key &key, block* data, size_t BLOCK_LEN)
 ** but more efficient since it unroll the loop
 */
 __attribute__((target("aes,sse2")))
-inline void FastECBEnc(const Key &key, block* plaintext, size_t BLOCK_LEN, block* ciphertext = nullptr) 
+inline void FastECBEncAESNI(const Key &key, const block* plaintext, size_t BLOCK_LEN, block* ciphertext) 
 {   
-    if(ciphertext == nullptr) ciphertext = plaintext;
     const size_t BATCH_SIZE = 8;
     size_t LEN = BLOCK_LEN - BLOCK_LEN % BATCH_SIZE; // ensure LEN = 8*n
 
@@ -178,10 +213,83 @@ inline void FastECBEnc(const Key &key, block* plaintext, size_t BLOCK_LEN, block
     }
 }
 
+#ifdef ENABLE_VAES
+/*
+** the VAES kernels encrypt whole batches only and return the number of blocks done;
+** the round keys are broadcast once per call and every round key load serves the whole batch
+*/
+__attribute__((target("aes,vaes,avx2")))
+inline size_t FastECBEncVAES256(const Key &key, const block* plaintext, size_t BLOCK_LEN, block* ciphertext) 
+{
+    const size_t LANE_NUM = 8; // 8 ymm registers of 2 blocks each
+    __m256i roundkey[11];
+    for (auto k = 0; k <= key.ROUND_NUM; k++) roundkey[k] = _mm256_broadcastsi128_si256(key.roundkey[k]);
+
+    size_t LEN = BLOCK_LEN - BLOCK_LEN % (2*LANE_NUM);
+    __m256i temp[LANE_NUM];
+    for (auto i = 0; i < LEN; i += 2*LANE_NUM)
+    {
+        for (auto j = 0; j < LANE_NUM; j++)
+            temp[j] = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(plaintext + i + 2*j)), roundkey[0]);
+
+        for (auto k = 1; k < key.ROUND_NUM; k++)
+            for (auto j = 0; j < LANE_NUM; j++)
+                temp[j] = _mm256_aesenc_epi128(temp[j], roundkey[k]);
+
+        for (auto j = 0; j < LANE_NUM; j++)
+            _mm256_storeu_si256((__m256i*)(ciphertext + i + 2*j), _mm256_aesenclast_epi128(temp[j], roundkey[key.ROUND_NUM]));
+    }
+    return LEN;
+}
+
+__attribute__((target("aes,vaes,avx512f")))
+inline size_t FastECBEncVAES512(const Key &key, const block* plaintext, size_t BLOCK_LEN, block* ciphertext) 
+{
+    const size_t LANE_NUM = 8; // 8 zmm registers of 4 blocks each
+    __m512i roundkey[11];
+    for (auto k = 0; k <= key.ROUND_NUM; k++) roundkey[k] = _mm512_broadcast_i32x4(key.roundkey[k]);
+
+    size_t LEN = BLOCK_LEN - BLOCK_LEN % (4*LANE_NUM);
+    __m512i temp[LANE_NUM];
+    for (auto i = 0; i < LEN; i += 4*LANE_NUM)
+    {
+        for (auto j = 0; j < LANE_NUM; j++)
+            temp[j] = _mm512_xor_si512(_mm512_loadu_si512((const void*)(plaintext + i + 4*j)), roundkey[0]);
+
+        for (auto k = 1; k < key.ROUND_NUM; k++)
+            for (auto j = 0; j < LANE_NUM; j++)
+                temp[j] = _mm512_aesenc_epi128(temp[j], roundkey[k]);
+
+        for (auto j = 0; j < LANE_NUM; j++)
+            _mm512_storeu_si512((void*)(ciphertext + i + 4*j), _mm512_aesenclast_epi128(temp[j], roundkey[key.ROUND_NUM]));
+    }
+    // a single zmm register at a time for the rest
+    for (; LEN + 4 <= BLOCK_LEN; LEN += 4)
+    {
+        __m512i t = _mm512_xor_si512(_mm512_loadu_si512((const void*)(plaintext + LEN)), roundkey[0]);
+        for (auto k = 1; k < key.ROUND_NUM; k++) t = _mm512_aesenc_epi128(t, roundkey[k]);
+        _mm512_storeu_si512((void*)(ciphertext + LEN), _mm512_aesenclast_epi128(t, roundkey[key.ROUND_NUM]));
+    }
+    return LEN;
+}
+#endif
+
+// ciphertext = nullptr means in-place encryption
+inline void FastECBEnc(const Key &key, block* plaintext, size_t BLOCK_LEN, block* ciphertext = nullptr) 
+{
+    if(ciphertext == nullptr) ciphertext = plaintext;
+    size_t DONE_LEN = 0;
+    #ifdef ENABLE_VAES
+        if (backend == VAES512) DONE_LEN = FastECBEncVAES512(key, plaintext, BLOCK_LEN, ciphertext);
+        else if (backend == VAES256) DONE_LEN = FastECBEncVAES256(key, plaintext, BLOCK_LEN, ciphertext);
+    #endif
+    FastECBEncAESNI(key, plaintext + DONE_LEN, BLOCK_LEN - DONE_LEN, ciphertext + DONE_LEN);
+}
+
 __attribute__((target("aes,sse2")))
 inline void ECBDec(const Key &key, block* data, size_t BLOCK_LEN) 
 {
-    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS) if(BLOCK_LEN >= ECB_PARALLEL_BLOCK_LEN)
     for (auto i = 0; i < BLOCK_LEN; i++)
         Dec(key, data[i]);
 }
@@ -220,6 +328,7 @@ void AES_Initialize()
     block salt = Block::zero_block;
     AES::fixed_enc_key = AES::GenEncKey(salt); 
     AES::fixed_dec_key = AES::DeriveDecKeyFromEncKey(AES::fixed_enc_key); 
+    AES::backend = AES::DetectBackend(); 
 }
 #endif
 
@@ -4,27 +4,65 @@
 #include "../include/openssl.inc"
 #include "../include/std.inc"
 #include "../include/global.hpp"
+#include "prg.hpp"
 
 inline size_t BN_BYTE_LEN;    // the byte length of bigint
 inline size_t INT_BYTE_LEN; 
 //inline size_t FIELD_BYTE_LEN;  // each scalar field element is 256 bit 
 
-inline BN_CTX *bn_ctx[NUMBER_OF_THREADS]; // define ctx for ecc operations
+/* 
+** every thread (OpenMP worker or not) lazily creates its own BN_CTX on first use;
+** the context is freed when the thread exits or by BN_Finalize, whichever comes first:
+** pooled OpenMP workers outlive the protocol, so their contexts are kept in a registry for BN_Finalize to release
+*/
+struct ThreadBNCtx; 
+inline std::mutex bn_ctx_mutex; 
 
+// never destroyed, so a thread exiting during static destruction can still unregister
+inline std::unordered_set<ThreadBNCtx*> &BNCtxRegistry()
+{
+    static std::unordered_set<ThreadBNCtx*> *registry = new std::unordered_set<ThreadBNCtx*>(); 
+    return *registry; 
+}
 
-void BN_Initialize(){
-    for(auto i = 0; i < NUMBER_OF_THREADS; i++){
-        bn_ctx[i] = BN_CTX_new();
-        if (bn_ctx[i] == nullptr) std::cerr << "bn_ctx initialize fails" << std::endl;
+struct ThreadBNCtx{
+    BN_CTX *ctx = nullptr; 
+    ~ThreadBNCtx(){
+        std::lock_guard<std::mutex> lock(bn_ctx_mutex); 
+        BNCtxRegistry().erase(this); 
+        if (ctx != nullptr) BN_CTX_free(ctx); 
+    }
+};
+
+inline thread_local ThreadBNCtx thread_bn_ctx; 
+
+// Returns the BN_CTX of the calling thread
+inline BN_CTX *GetBNCtx()
+{
+    if (thread_bn_ctx.ctx == nullptr){
+        thread_bn_ctx.ctx = BN_CTX_new(); 
+        if (thread_bn_ctx.ctx == nullptr) std::cerr << "bn_ctx initialize fails" << std::endl;
+        std::lock_guard<std::mutex> lock(bn_ctx_mutex); 
+        BNCtxRegistry().insert(&thread_bn_ctx); 
     }
+    return thread_bn_ctx.ctx; 
+}
+
+
+void BN_Initialize(){
+    GetBNCtx(); 
     //BN_BIT_LEN = BN_BYTE_LEN * 8; 
     INT_BYTE_LEN = sizeof(size_t); 
 }
 
+// frees the contexts of all threads: call it when no other thread is using BigInt
 void BN_Finalize(){
-    for(auto i = 0; i < NUMBER_OF_THREADS; i++){
-        BN_CTX_free(bn_ctx[i]);
+    std::lock_guard<std::mutex> lock(bn_ctx_mutex); 
+    for (ThreadBNCtx *holder : BNCtxRegistry()){
+        BN_CTX_free(holder->ctx); 
+        holder->ctx = nullptr; 
     }
+    BNCtxRegistry().clear(); 
 } 
 
 
@@ -37,6 +75,7 @@ public:
     // constructor functions
     BigInt();
     BigInt(const BigInt& other);
+    BigInt(BigInt&& other) noexcept;
     BigInt(const BIGNUM *other);
     BigInt(size_t number);
 
@@ -124,9 +163,40 @@ public:
     // Returns a BigInt whose value is (*this << n).
     BigInt Rshift(int n) const;
 
+    // in-place arithmetic operations: overwrite *this, no temporary BIGNUM is allocated
+
+    // Sets *this = *this + other.
+    BigInt& AddInPlace(const BigInt& other);
+
+    // Sets *this = *this - other.
+    BigInt& SubInPlace(const BigInt& other);
+
+    // Sets *this = *this * other.
+    BigInt& MulInPlace(const BigInt& other);
+
+    // Sets *this = *this mod m (non-negative residue).
+    BigInt& ModInPlace(const BigInt& modulus);
+
+    // Sets *this = *this + other mod m.
+    BigInt& ModAddInPlace(const BigInt& other, const BigInt& modulus);
+
+    // Sets *this = *this - other mod m.
+    BigInt& ModSubInPlace(const BigInt& other, const BigInt& modulus);
+
+    // Sets *this = *this * other mod m.
+    BigInt& ModMulInPlace(const BigInt& other, const BigInt& modulus);
+
     // operator overload
 
-    inline BigInt& operator=(const BigInt& other) { BN_copy(this->bn_ptr, other.bn_ptr); return *this; }
+    // a moved-from BigInt holds no BIGNUM: re-allocate it lazily when it is assigned again
+    inline BigInt& operator=(const BigInt& other) { 
+        if (this->bn_ptr == nullptr) this->bn_ptr = BN_new(); 
+        BN_copy(this->bn_ptr, other.bn_ptr); 
+        return *this; 
+    }
+
+    // steal the BIGNUM of other: the old one of *this is released when other dies
+    inline BigInt& operator=(BigInt&& other) noexcept { std::swap(this->bn_ptr, other.bn_ptr); return *this; }
 
     inline BigInt operator-() const { return this->Negate(); }
 
@@ -138,11 +208,11 @@ public:
 
     inline BigInt operator/(const BigInt& other) const { return this->Div(other); }
 
-    inline BigInt& operator+=(const BigInt& other) { return *this = *this + other; }
+    inline BigInt& operator+=(const BigInt& other) { return this->AddInPlace(other); }
 
-    inline BigInt& operator*=(const BigInt& other) { return *this = *this * other; }
+    inline BigInt& operator*=(const BigInt& other) { return this->MulInPlace(other); }
 
-    inline BigInt& operator-=(const BigInt& other) { return *this = *this - other; }
+    inline BigInt& operator-=(const BigInt& other) { return this->SubInPlace(other); }
 
     inline BigInt& operator/=(const BigInt& other) { return *this = *this / other; }
 
@@ -164,7 +234,7 @@ public:
 
     inline BigInt operator<<(int n) { return this->Lshift(n); }
 
-    inline BigInt& operator%=(const BigInt& other) { return *this = *this % other; }
+    inline BigInt& operator%=(const BigInt& other) { return this->ModInPlace(other); }
 
     inline BigInt& operator>>=(int n) { return *this = *this >> n; }
 
@@ -245,6 +315,12 @@ BigInt::BigInt(const BigInt& other){
     BN_copy(this->bn_ptr, other.bn_ptr);
 }
 
+// Takes over the BIGNUM of other, leaving other empty.
+BigInt::BigInt(BigInt&& other) noexcept{
+    this->bn_ptr = other.bn_ptr;
+    other.bn_ptr = nullptr; 
+}
+
 BigInt::BigInt(const BIGNUM *other){
     this->bn_ptr = BN_new(); 
     BN_copy(this->bn_ptr, other); 
@@ -346,8 +422,7 @@ BigInt BigInt::Sub(const BigInt& other) const {
 // Causes a check failure if the operation fails.
 BigInt BigInt::Mul(const BigInt& other) const {
     BigInt result;
-    int thread_num = omp_get_thread_num();
-    CRYPTO_CHECK(1 == BN_mul(result.bn_ptr, this->bn_ptr, other.bn_ptr, bn_ctx[thread_num]));
+    CRYPTO_CHECK(1 == BN_mul(result.bn_ptr, this->bn_ptr, other.bn_ptr, GetBNCtx()));
     return result;
 }
 
@@ -356,8 +431,7 @@ BigInt BigInt::Mul(const BigInt& other) const {
 BigInt BigInt::Div(const BigInt& other) const {
     BigInt result;
     BigInt remainder;
-    int thread_num = omp_get_thread_num();
-    CRYPTO_CHECK(1 == BN_div(result.bn_ptr, remainder.bn_ptr, this->bn_ptr, other.bn_ptr, bn_ctx[thread_num]));
+    CRYPTO_CHECK(1 == BN_div(result.bn_ptr, remainder.bn_ptr, this->bn_ptr, other.bn_ptr, GetBNCtx()));
     if (BN_is_zero(remainder.bn_ptr)){
         std::cerr << "Use DivAndTruncate() instead of Div() if you want truncated division." << std::endl;  
     } 
@@ -369,8 +443,7 @@ BigInt BigInt::Div(const BigInt& other) const {
 BigInt BigInt::DivAndTruncate(const BigInt& other) const {
     BigInt result;
     BigInt remainder;
-    int thread_num = omp_get_thread_num();
-    CRYPTO_CHECK(1 == BN_div(result.bn_ptr, remainder.bn_ptr, this->bn_ptr, other.bn_ptr, bn_ctx[thread_num]));
+    CRYPTO_CHECK(1 == BN_div(result.bn_ptr, remainder.bn_ptr, this->bn_ptr, other.bn_ptr, GetBNCtx()));
     return result;
 }
 
@@ -384,24 +457,21 @@ int BigInt::CompareTo(const BigInt& other) const {
 // Causes a check failure if the operation fails.
 BigInt BigInt::Exp(const BigInt& exponent) const{
     BigInt result;
-    int thread_num = omp_get_thread_num();
-    CRYPTO_CHECK(1 == BN_exp(result.bn_ptr, this->bn_ptr, exponent.bn_ptr, bn_ctx[thread_num]));
+    CRYPTO_CHECK(1 == BN_exp(result.bn_ptr, this->bn_ptr, exponent.bn_ptr, GetBNCtx()));
     return result;
 }
 
 // return square
 BigInt BigInt::Square() const{
     BigInt result;
-    int thread_num = omp_get_thread_num();
-    CRYPTO_CHECK(1 == BN_sqr(result.bn_ptr, this->bn_ptr, bn_ctx[thread_num]));
+    CRYPTO_CHECK(1 == BN_sqr(result.bn_ptr, this->bn_ptr, GetBNCtx()));
     return result;
 }
 
 // Returns a BigInt whose value is (*this mod m).
 BigInt BigInt::Mod(const BigInt& modulus) const {
     BigInt result;
-    int thread_num = omp_get_thread_num();
-    CRYPTO_CHECK(1 == BN_nnmod(result.bn_ptr, this->bn_ptr, modulus.bn_ptr, bn_ctx[thread_num]));
+    CRYPTO_CHECK(1 == BN_nnmod(result.bn_ptr, this->bn_ptr, modulus.bn_ptr, GetBNCtx()));
     return result;
 }
 
@@ -409,8 +479,7 @@ BigInt BigInt::Mod(const BigInt& modulus) const {
 // Causes a check failure if the operation fails.
 BigInt BigInt::ModAdd(const BigInt& other, const BigInt& modulus) const {
     BigInt result;
-    int thread_num = omp_get_thread_num();
-    CRYPTO_CHECK(1 == BN_mod_add(result.bn_ptr, this->bn_ptr, other.bn_ptr, modulus.bn_ptr, bn_ctx[thread_num]));
+    CRYPTO_CHECK(1 == BN_mod_add(result.bn_ptr, this->bn_ptr, other.bn_ptr, modulus.bn_ptr, GetBNCtx()));
     return result;
 }
 
@@ -418,16 +487,14 @@ BigInt BigInt::ModAdd(const BigInt& other, const BigInt& modulus) const {
 // Causes a check failure if the operation fails.
 BigInt BigInt::ModSub(const BigInt& other, const BigInt& modulus) const {
     BigInt result;
-    int thread_num = omp_get_thread_num();
-    CRYPTO_CHECK(1 == BN_mod_sub(result.bn_ptr, this->bn_ptr, other.bn_ptr, modulus.bn_ptr, bn_ctx[thread_num]));
+    CRYPTO_CHECK(1 == BN_mod_sub(result.bn_ptr, this->bn_ptr, other.bn_ptr, modulus.bn_ptr, GetBNCtx()));
     return result;
 }
 
 // Returns a BigInt whose value is (*this * val mod m).
 BigInt BigInt::ModMul(const BigInt& other, const BigInt& modulus) const {
     BigInt result;
-    int thread_num = omp_get_thread_num();
-    CRYPTO_CHECK(1 == BN_mod_mul(result.bn_ptr, this->bn_ptr, other.bn_ptr, modulus.bn_ptr, bn_ctx[thread_num]));
+    CRYPTO_CHECK(1 == BN_mod_mul(result.bn_ptr, this->bn_ptr, other.bn_ptr, modulus.bn_ptr, GetBNCtx()));
     return result;
 }
 
@@ -438,8 +505,7 @@ BigInt BigInt::ModExp(const BigInt& exponent, const BigInt& modulus) const {
         std::cerr << "Cannot use a negative exponent in BigInt ModExp." << std::endl; 
     } 
     BigInt result;
-    int thread_num = omp_get_thread_num();
-    CRYPTO_CHECK(1 == BN_mod_exp(result.bn_ptr, this->bn_ptr, exponent.bn_ptr, modulus.bn_ptr, bn_ctx[thread_num]));
+    CRYPTO_CHECK(1 == BN_mod_exp(result.bn_ptr, this->bn_ptr, exponent.bn_ptr, modulus.bn_ptr, GetBNCtx()));
     return result;
 }
 
@@ -447,8 +513,7 @@ BigInt BigInt::ModExp(const BigInt& exponent, const BigInt& modulus) const {
 // Causes a check failure if the operation fails.
 BigInt BigInt::ModSquare(const BigInt& modulus) const {
     BigInt result;
-    int thread_num = omp_get_thread_num();
-    CRYPTO_CHECK(1 == BN_mod_sqr(result.bn_ptr, this->bn_ptr, modulus.bn_ptr, bn_ctx[thread_num]));
+    CRYPTO_CHECK(1 == BN_mod_sqr(result.bn_ptr, this->bn_ptr, modulus.bn_ptr, GetBNCtx()));
     return result;
 }
 
@@ -456,8 +521,7 @@ BigInt BigInt::ModSquare(const BigInt& modulus) const {
 // Causes a check failure if the operation fails.
 BigInt BigInt::ModInverse(const BigInt& modulus) const {
     BigInt result;
-    int thread_num = omp_get_thread_num();
-    CRYPTO_CHECK(nullptr != BN_mod_inverse(result.bn_ptr, this->bn_ptr, modulus.bn_ptr, bn_ctx[thread_num]));
+    CRYPTO_CHECK(nullptr != BN_mod_inverse(result.bn_ptr, this->bn_ptr, modulus.bn_ptr, GetBNCtx()));
     return result;
 }
 
@@ -465,8 +529,7 @@ BigInt BigInt::ModInverse(const BigInt& modulus) const {
 // Causes a check failure if the operation fails.
 BigInt BigInt::ModSquareRoot(const BigInt& modulus) const {
     BigInt result;
-    int thread_num = omp_get_thread_num();
-    CRYPTO_CHECK(nullptr != BN_mod_sqrt(result.bn_ptr, bn_ptr, modulus.bn_ptr, bn_ctx[thread_num]));
+    CRYPTO_CHECK(nullptr != BN_mod_sqrt(result.bn_ptr, bn_ptr, modulus.bn_ptr, GetBNCtx()));
     return result;
 }
 
@@ -494,12 +557,78 @@ BigInt BigInt::Rshift(int n) const {
     return result;
 }
 
+// Sets *this = *this + other.
+BigInt& BigInt::AddInPlace(const BigInt& other) {
+    CRYPTO_CHECK(1 == BN_add(this->bn_ptr, this->bn_ptr, other.bn_ptr));
+    return *this;
+}
+
+// Sets *this = *this - other.
+BigInt& BigInt::SubInPlace(const BigInt& other) {
+    CRYPTO_CHECK(1 == BN_sub(this->bn_ptr, this->bn_ptr, other.bn_ptr));
+    return *this;
+}
+
+// Sets *this = *this * other.
+BigInt& BigInt::MulInPlace(const BigInt& other) {
+    CRYPTO_CHECK(1 == BN_mul(this->bn_ptr, this->bn_ptr, other.bn_ptr, GetBNCtx()));
+    return *this;
+}
+
+// Sets *this = *this mod m.
+BigInt& BigInt::ModInPlace(const BigInt& modulus) {
+    CRYPTO_CHECK(1 == BN_nnmod(this->bn_ptr, this->bn_ptr, modulus.bn_ptr, GetBNCtx()));
+    return *this;
+}
+
+// Sets *this = *this + other mod m.
+BigInt& BigInt::ModAddInPlace(const BigInt& other, const BigInt& modulus) {
+    CRYPTO_CHECK(1 == BN_mod_add(this->bn_ptr, this->bn_ptr, other.bn_ptr, modulus.bn_ptr, GetBNCtx()));
+    return *this;
+}
+
+// Sets *this = *this - other mod m.
+BigInt& BigInt::ModSubInPlace(const BigInt& other, const BigInt& modulus) {
+    CRYPTO_CHECK(1 == BN_mod_sub(this->bn_ptr, this->bn_ptr, other.bn_ptr, modulus.bn_ptr, GetBNCtx()));
+    return *this;
+}
+
+// Sets *this = *this * other mod m.
+BigInt& BigInt::ModMulInPlace(const BigInt& other, const BigInt& modulus) {
+    CRYPTO_CHECK(1 == BN_mod_mul(this->bn_ptr, this->bn_ptr, other.bn_ptr, modulus.bn_ptr, GetBNCtx()));
+    return *this;
+}
+
+/* 
+** write-into variants: result must be an existing BigInt, its BIGNUM is reused
+** result may alias a or b
+*/
+
+// result = (a + b) mod m
+void ModAddInto(BigInt &result, const BigInt &a, const BigInt &b, const BigInt &modulus) {
+    CRYPTO_CHECK(1 == BN_mod_add(result.bn_ptr, a.bn_ptr, b.bn_ptr, modulus.bn_ptr, GetBNCtx()));
+}
+
+// result = (a - b) mod m
+void ModSubInto(BigInt &result, const BigInt &a, const BigInt &b, const BigInt &modulus) {
+    CRYPTO_CHECK(1 == BN_mod_sub(result.bn_ptr, a.bn_ptr, b.bn_ptr, modulus.bn_ptr, GetBNCtx()));
+}
+
+// result = (a * b) mod m
+void ModMulInto(BigInt &result, const BigInt &a, const BigInt &b, const BigInt &modulus) {
+    CRYPTO_CHECK(1 == BN_mod_mul(result.bn_ptr, a.bn_ptr, b.bn_ptr, modulus.bn_ptr, GetBNCtx()));
+}
+
+// result = a * b
+void MulInto(BigInt &result, const BigInt &a, const BigInt &b) {
+    CRYPTO_CHECK(1 == BN_mul(result.bn_ptr, a.bn_ptr, b.bn_ptr, GetBNCtx()));
+}
+
 // Computes the greatest common divisor of *this and val.
 // Causes a check failure if the operation fails.
 BigInt BigInt::GCD(const BigInt& other) const {
     BigInt result;
-    int thread_num = omp_get_thread_num();
-    CRYPTO_CHECK(1 == BN_gcd(result.bn_ptr, this->bn_ptr, other.bn_ptr, bn_ctx[thread_num]));
+    CRYPTO_CHECK(1 == BN_gcd(result.bn_ptr, this->bn_ptr, other.bn_ptr, GetBNCtx()));
     return result;
 }
 
@@ -508,8 +637,7 @@ BigInt BigInt::GCD(const BigInt& other) const {
 // True if it is prime with an error probability of 1e-40, which gives at least 128 bit security.
 bool BigInt::IsPrime(double prime_error_probability) const {
     int rounds = static_cast<int>(ceil(-log(prime_error_probability) / log(4)));
-    int thread_num = omp_get_thread_num();
-    return (1 == BN_is_prime_ex(this->bn_ptr, rounds, bn_ctx[thread_num], nullptr));
+    return (1 == BN_is_prime_ex(this->bn_ptr, rounds, GetBNCtx(), nullptr));
 }
 
 bool BigInt::IsSafePrime(double prime_error_probability = 1e-40) const {
@@ -678,7 +806,7 @@ std::vector<BigInt> BigIntVectorModAdd(std::vector<BigInt> &vec_a, std::vector<B
     std::vector<BigInt> vec_result(LEN);
     
     for (auto i = 0; i < vec_a.size(); i++) {
-        vec_result[i] = (vec_a[i] + vec_b[i]) % modulus;  
+        ModAddInto(vec_result[i], vec_a[i], vec_b[i], modulus);  
     }
     return vec_result; 
 }
@@ -694,7 +822,7 @@ std::vector<BigInt> BigIntVectorModSub(std::vector<BigInt> &vec_a, std::vector<B
     std::vector<BigInt> vec_result(LEN);
 
     for (auto i = 0; i < LEN; i++) {
-        vec_result[i] = (vec_a[i] - vec_b[i]) % modulus;
+        ModSubInto(vec_result[i], vec_a[i], vec_b[i], modulus);
     } 
     return vec_result; 
 }
@@ -710,7 +838,7 @@ std::vector<BigInt> BigIntVectorModProduct(std::vector<BigInt> &vec_a, std::vect
     std::vector<BigInt> vec_result(LEN);
 
     for (auto i = 0; i < vec_a.size(); i++) {
-        vec_result[i] = (vec_a[i] * vec_b[i]) % modulus; // product = (vec_a[i]*vec_b[i]) mod modulus
+        ModMulInto(vec_result[i], vec_a[i], vec_b[i], modulus); // product = (vec_a[i]*vec_b[i]) mod modulus
     }
     return vec_result; 
 }
@@ -727,7 +855,7 @@ std::vector<BigInt> BigIntVectorProduct(std::vector<BigInt> &vec_a, std::vector<
 
     std::vector<BigInt> vec_result(LEN);
     for (auto i = 0; i < vec_a.size(); i++) {
-        vec_result[i] = vec_a[i] * vec_b[i]; 
+        MulInto(vec_result[i], vec_a[i], vec_b[i]); 
     }
     return vec_result; 
 }
@@ -754,7 +882,7 @@ std::vector<BigInt> BigIntVectorModScalar(std::vector<BigInt> &vec_a, BigInt &c,
     std::vector<BigInt> vec_result(LEN);
 
     for (auto i = 0; i < LEN; i++) {
-        vec_result[i] = (vec_a[i] * c) % modulus;
+        ModMulInto(vec_result[i], vec_a[i], c, modulus);
     } 
     return vec_result; 
 }
@@ -766,7 +894,7 @@ std::vector<BigInt> BigIntVectorScalar(std::vector<BigInt> &vec_a, BigInt &c)
     std::vector<BigInt> vec_result(LEN); 
 
     for (auto i = 0; i < vec_a.size(); i++) {
-        vec_result[i] = vec_a[i] * c;
+        MulInto(vec_result[i], vec_a[i], c);
     } 
     return vec_result;
 }
@@ -794,10 +922,12 @@ BigInt BigIntVectorModInnerProduct(std::vector<BigInt> &vec_a, std::vector<BigIn
         exit(EXIT_FAILURE); 
     } 
 
+    BigInt product; 
     for (auto i = 0; i < vec_a.size(); i++) {
-        result += vec_a[i] * vec_b[i]; // product = (vec_a[i]*vec_b[i]) mod modulus
+        MulInto(product, vec_a[i], vec_b[i]); 
+        result.AddInPlace(product); // product = (vec_a[i]*vec_b[i]) mod modulus
     }
-    result = result % modulus;
+    result.ModInPlace(modulus);
     return result; 
 }
 
@@ -811,23 +941,63 @@ BigInt BigIntVectorInnerProduct(std::vector<BigInt> &vec_a, std::vector<BigInt>
         exit(EXIT_FAILURE); 
     } 
 
+    BigInt product; 
     for (auto i = 0; i < vec_a.size(); i++) {
-        result += vec_a[i] * vec_b[i]; 
+        MulInto(product, vec_a[i], vec_b[i]); 
+        result.AddInPlace(product); 
     }
-    return result % modulus; 
+    result.ModInPlace(modulus); 
+    return result; 
 }
 
 
-/* generate a vector of random EC points */  
+/*
+** generate LEN uniform random integers in [0, modulus)
+** BN_rand_range goes through the locked global DRBG, so a batch is instead drawn from the AES PRG:
+** every thread seeds its own PRG from fresh randomness and does rejection sampling on
+** candidates of modulus' bit length (at least half of them are accepted)
+*/
 std::vector<BigInt> GenRandomBigIntVectorLessThan(size_t LEN, const BigInt &modulus)
 {
+    if (BN_is_zero(modulus.bn_ptr) || BN_is_negative(modulus.bn_ptr)){
+        std::cerr << "modulus must be positive" << std::endl;
+        exit(EXIT_FAILURE);
+    }
     std::vector<BigInt> vec_result(LEN);
-    
-    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-    for(auto i = 0; i < LEN; i++){ 
-        vec_result[i] = GenRandomBigIntLessThan(modulus); 
+
+    size_t BIT_LEN = BN_num_bits(modulus.bn_ptr);
+    size_t BYTE_LEN = (BIT_LEN + 7) / 8;
+    uint8_t TOP_MASK = 0xFF >> (8*BYTE_LEN - BIT_LEN); // the candidate is big-endian
+    size_t BLOCK_NUM = (BYTE_LEN + 15) / 16;            // blocks per candidate
+
+    size_t THREAD_NUM = omp_in_parallel() ? 1 : std::max<size_t>(1, std::min(NUMBER_OF_THREADS, LEN/64));
+    size_t CHUNK_LEN = (LEN + THREAD_NUM - 1) / THREAD_NUM;
+
+    #pragma omp parallel for num_threads(THREAD_NUM)
+    for (auto t = 0; t < THREAD_NUM; t++){
+        size_t begin = t * CHUNK_LEN;
+        size_t end = std::min(LEN, begin + CHUNK_LEN);
+        if (begin >= end) continue;
+
+        PRG::Seed seed = PRG::SetSeed(nullptr, t);
+        std::vector<block> vec_candidate;
+        size_t used = 0, available = 0;
+        for (auto i = begin; i < end; i++){
+            do{
+                if (used == available){
+                    // twice the remaining demand is almost always enough for one refill
+                    available = 2*(end - i) + 8;
+                    vec_candidate = PRG::GenRandomBlocks(seed, available * BLOCK_NUM);
+                    used = 0;
+                }
+                unsigned char *buffer = (unsigned char *)(vec_candidate.data() + used * BLOCK_NUM);
+                used++;
+                buffer[0] &= TOP_MASK;
+                BN_bin2bn(buffer, BYTE_LEN, vec_result[i].bn_ptr);
+            } while (BN_cmp(vec_result[i].bn_ptr, modulus.bn_ptr) >= 0);
+        }
     }
-    return vec_result; 
+    return vec_result;
 }
 
 #endif  // KUNLUN_CRYPTO_BIGINT_HPP_
\ No newline at end of file
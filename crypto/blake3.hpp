@@ -0,0 +1,168 @@
+/****************************************************************************
+this hpp implements BLAKE3 (hash mode, 256-bit output), portable version
+an alternative backend of BasicHash, see hash.hpp
+the input is split into 1KB chunks, the chaining values of the chunks are merged into a binary tree
+on a stack, and the root node is compressed once more with the ROOT flag
+*****************************************************************************
+* @copyright  MIT license (see LICENSE file)
+*****************************************************************************/
+#ifndef KUNLUN_CRYPTO_BLAKE3_HPP_
+#define KUNLUN_CRYPTO_BLAKE3_HPP_
+
+#include "../include/global.hpp"
+
+namespace BLAKE3{
+
+inline const size_t BLOCK_LEN = 64;
+inline const size_t CHUNK_LEN = 1024;
+inline const size_t OUTPUT_LEN = 32;
+
+inline const uint32_t IV[8] = {0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+                               0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19};
+
+inline const uint8_t MSG_PERMUTATION[16] = {2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8};
+
+enum Flag : uint32_t {CHUNK_START = 1, CHUNK_END = 2, PARENT = 4, ROOT = 8};
+
+// the input of the last compression of a node: it yields either the chaining value or, with ROOT, the digest
+struct Output{
+    uint32_t cv[8];
+    uint32_t block_words[16];
+    uint64_t counter;
+    uint32_t block_len;
+    uint32_t flags;
+};
+
+inline uint32_t RotateRight(uint32_t x, int n)
+{
+    return (x >> n) | (x << (32 - n));
+}
+
+inline void G(uint32_t *state, size_t a, size_t b, size_t c, size_t d, uint32_t mx, uint32_t my)
+{
+    state[a] = state[a] + state[b] + mx;
+    state[d] = RotateRight(state[d] ^ state[a], 16);
+    state[c] = state[c] + state[d];
+    state[b] = RotateRight(state[b] ^ state[c], 12);
+    state[a] = state[a] + state[b] + my;
+    state[d] = RotateRight(state[d] ^ state[a], 8);
+    state[c] = state[c] + state[d];
+    state[b] = RotateRight(state[b] ^ state[c], 7);
+}
+
+inline void Compress(const uint32_t cv[8], const uint32_t block_words[16], uint64_t counter,
+                     uint32_t block_len, uint32_t flags, uint32_t out[16])
+{
+    uint32_t state[16] = {cv[0], cv[1], cv[2], cv[3], cv[4], cv[5], cv[6], cv[7],
+                          IV[0], IV[1], IV[2], IV[3], uint32_t(counter), uint32_t(counter >> 32), block_len, flags};
+    uint32_t m[16], permuted[16];
+    memcpy(m, block_words, sizeof(m));
+
+    for (auto round = 0; round < 7; round++){
+        // columns, then diagonals
+        G(state, 0, 4, 8, 12, m[0], m[1]);
+        G(state, 1, 5, 9, 13, m[2], m[3]);
+        G(state, 2, 6, 10, 14, m[4], m[5]);
+        G(state, 3, 7, 11, 15, m[6], m[7]);
+        G(state, 0, 5, 10, 15, m[8], m[9]);
+        G(state, 1, 6, 11, 12, m[10], m[11]);
+        G(state, 2, 7, 8, 13, m[12], m[13]);
+        G(state, 3, 4, 9, 14, m[14], m[15]);
+
+        for (auto i = 0; i < 16; i++) permuted[i] = m[MSG_PERMUTATION[i]];
+        memcpy(m, permuted, sizeof(m));
+    }
+    for (auto i = 0; i < 8; i++){
+        out[i] = state[i] ^ state[i+8];
+        out[i+8] = state[i+8] ^ cv[i];
+    }
+}
+
+// little-endian words of a block, zero padded when LEN < 64 (x86 is little-endian)
+inline void LoadBlockWords(const unsigned char *block, size_t LEN, uint32_t block_words[16])
+{
+    memset(block_words, 0, BLOCK_LEN);
+    memcpy(block_words, block, LEN);
+}
+
+inline void ChainingValue(const Output &node, uint32_t cv[8])
+{
+    uint32_t out[16];
+    Compress(node.cv, node.block_words, node.counter, node.block_len, node.flags, out);
+    memcpy(cv, out, 32);
+}
+
+// compress all but the last block of a chunk (LEN <= 1KB, an empty input is a chunk with one empty block)
+inline Output ChunkOutput(const unsigned char *chunk, size_t LEN, uint64_t chunk_counter)
+{
+    Output node;
+    memcpy(node.cv, IV, sizeof(IV));
+    size_t BLOCK_NUM = std::max<size_t>(1, (LEN + BLOCK_LEN - 1) / BLOCK_LEN);
+    uint32_t block_words[16], out[16];
+    for (auto j = 0; j < BLOCK_NUM - 1; j++){
+        LoadBlockWords(chunk + j*BLOCK_LEN, BLOCK_LEN, block_words);
+        Compress(node.cv, block_words, chunk_counter, BLOCK_LEN, j == 0 ? CHUNK_START : 0, out);
+        memcpy(node.cv, out, 32);
+    }
+    size_t LAST_LEN = LEN - (BLOCK_NUM - 1)*BLOCK_LEN;
+    LoadBlockWords(chunk + (BLOCK_NUM - 1)*BLOCK_LEN, LAST_LEN, node.block_words);
+    node.counter = chunk_counter;
+    node.block_len = LAST_LEN;
+    node.flags = CHUNK_END | (BLOCK_NUM == 1 ? CHUNK_START : 0);
+    return node;
+}
+
+inline Output ParentOutput(const uint32_t left_cv[8], const uint32_t right_cv[8])
+{
+    Output node;
+    memcpy(node.cv, IV, sizeof(IV));
+    memcpy(node.block_words, left_cv, 32);
+    memcpy(node.block_words + 8, right_cv, 32);
+    node.counter = 0;
+    node.block_len = BLOCK_LEN;
+    node.flags = PARENT;
+    return node;
+}
+
+// output must have OUTPUT_LEN = 32 bytes
+inline void Hash(const unsigned char *input, size_t LEN, unsigned char *output)
+{
+    size_t CHUNK_NUM = std::max<size_t>(1, (LEN + CHUNK_LEN - 1) / CHUNK_LEN);
+
+    // the stack holds the roots of complete subtrees, at most one per bit of the chunk count
+    uint32_t cv_stack[64][8];
+    size_t stack_len = 0;
+    uint32_t cv[8];
+    for (auto i = 0; i < CHUNK_NUM - 1; i++){
+        ChainingValue(ChunkOutput(input + i*CHUNK_LEN, CHUNK_LEN, i), cv);
+        // every trailing zero of the chunk count closes a subtree
+        for (uint64_t total_chunks = i + 1; (total_chunks & 1) == 0; total_chunks >>= 1){
+            stack_len--;
+            ChainingValue(ParentOutput(cv_stack[stack_len], cv), cv);
+        }
+        memcpy(cv_stack[stack_len], cv, 32);
+        stack_len++;
+    }
+
+    Output node = ChunkOutput(input + (CHUNK_NUM - 1)*CHUNK_LEN, LEN - (CHUNK_NUM - 1)*CHUNK_LEN, CHUNK_NUM - 1);
+    while (stack_len > 0){
+        stack_len--;
+        ChainingValue(node, cv);
+        node = ParentOutput(cv_stack[stack_len], cv);
+    }
+
+    uint32_t out[16];
+    Compress(node.cv, node.block_words, 0, node.block_len, node.flags | ROOT, out);
+    memcpy(output, out, OUTPUT_LEN);
+}
+
+// NUM inputs of HASH_INPUT_LEN bytes each, stored back to back; the digests are stored back to back as well
+inline void HashMany(const unsigned char *input, size_t HASH_INPUT_LEN, size_t NUM, unsigned char *output)
+{
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS) if(NUM >= 1024)
+    for (auto i = 0; i < NUM; i++) Hash(input + i*HASH_INPUT_LEN, HASH_INPUT_LEN, output + i*OUTPUT_LEN);
+}
+
+}
+
+#endif
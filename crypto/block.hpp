@@ -6,7 +6,7 @@
 #ifndef KUNLUN_CRYPTO_BLOCK_HPP_
 #define KUNLUN_CRYPTO_BLOCK_HPP_
 
-#include "../include/std.inc"
+#include "../include/global.hpp"
 #include "../utility/serialization.hpp"
 
 
@@ -57,7 +57,169 @@ void ClearBit(block &a, size_t n)
     a = _mm_andnot_si128(a, GenMaskBlock(n));
 }
 
-inline std::vector<block> AND(std::vector<block> &vec_a, std::vector<block> &vec_b) 
+/*
+** span kernels on block arrays: nothing is allocated, and dst may alias an input
+** below PARALLEL_BLOCK_LEN blocks they run on the calling thread; the per-call cost of a thread team
+** exceeds the work of such short calls (e.g. one column in the OT extension loops)
+*/
+inline const size_t PARALLEL_BLOCK_LEN = 1 << 14;
+
+enum SIMDLevel{SSE2 = 0, AVX2 = 1, AVX512 = 2};
+
+inline SIMDLevel DetectSIMDLevel()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return AVX512;
+    if (__builtin_cpu_supports("avx2")) return AVX2;
+    return SSE2;
+}
+
+inline const SIMDLevel simd_level = DetectSIMDLevel();
+
+// SSE4.1 is not part of the x86-64 baseline, so PTEST is only used once the CPU reports it
+inline const bool sse41_support = (__builtin_cpu_init(), __builtin_cpu_supports("sse4.1"));
+
+// call f(begin, end) on chunks of [0, LEN), in parallel only for long arrays
+template <typename Function>
+inline void ForEachChunk(size_t LEN, Function f)
+{
+    size_t THREAD_NUM = omp_in_parallel() ? 1 : std::max<size_t>(1, std::min<size_t>(NUMBER_OF_THREADS, LEN/PARALLEL_BLOCK_LEN));
+    if (THREAD_NUM == 1){
+        f(0, LEN);
+        return;
+    }
+    // chunks are a multiple of 4 blocks, so only the last one has a tail
+    size_t CHUNK_LEN = ((LEN + THREAD_NUM - 1) / THREAD_NUM + 3) / 4 * 4;
+    #pragma omp parallel for num_threads(THREAD_NUM)
+    for (auto t = 0; t < THREAD_NUM; t++){
+        size_t begin = std::min(LEN, t * CHUNK_LEN);
+        f(begin, std::min(LEN, begin + CHUNK_LEN));
+    }
+}
+
+// op is 0 for XOR, 1 for AND; b_stride = 0 broadcasts b[0]
+template <int op>
+__attribute__((target("sse2")))
+inline void BinaryOpSSE2(block *dst, const block *a, const block *b, size_t b_stride, size_t LEN)
+{
+    for (auto i = 0; i < LEN; i++){
+        dst[i] = (op == 0) ? _mm_xor_si128(a[i], b[i*b_stride]) : _mm_and_si128(a[i], b[i*b_stride]);
+    }
+}
+
+template <int op>
+__attribute__((target("avx2")))
+inline void BinaryOpAVX2(block *dst, const block *a, const block *b, size_t b_stride, size_t LEN)
+{
+    size_t i = 0;
+    __m256i vb = (b_stride == 0) ? _mm256_broadcastsi128_si256(b[0]) : _mm256_setzero_si256();
+    for (; i + 2 <= LEN; i += 2){
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        if (b_stride) vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), (op == 0) ? _mm256_xor_si256(va, vb) : _mm256_and_si256(va, vb));
+    }
+    BinaryOpSSE2<op>(dst + i, a + i, b + i*b_stride, b_stride, LEN - i);
+}
+
+template <int op>
+__attribute__((target("avx512f")))
+inline void BinaryOpAVX512(block *dst, const block *a, const block *b, size_t b_stride, size_t LEN)
+{
+    size_t i = 0;
+    __m512i vb = (b_stride == 0) ? _mm512_broadcast_i32x4(b[0]) : _mm512_setzero_si512();
+    for (; i + 4 <= LEN; i += 4){
+        __m512i va = _mm512_loadu_si512((const void*)(a + i));
+        if (b_stride) vb = _mm512_loadu_si512((const void*)(b + i));
+        _mm512_storeu_si512((void*)(dst + i), (op == 0) ? _mm512_xor_si512(va, vb) : _mm512_and_si512(va, vb));
+    }
+    BinaryOpSSE2<op>(dst + i, a + i, b + i*b_stride, b_stride, LEN - i);
+}
+
+template <int op>
+inline void BinaryOp(block *dst, const block *a, const block *b, size_t b_stride, size_t LEN)
+{
+    ForEachChunk(LEN, [&](size_t begin, size_t end){
+        if (simd_level == AVX512) BinaryOpAVX512<op>(dst + begin, a + begin, b + begin*b_stride, b_stride, end - begin);
+        else if (simd_level == AVX2) BinaryOpAVX2<op>(dst + begin, a + begin, b + begin*b_stride, b_stride, end - begin);
+        else BinaryOpSSE2<op>(dst + begin, a + begin, b + begin*b_stride, b_stride, end - begin);
+    });
+}
+
+// dst[i] = a[i] xor b[i]
+inline void XorInto(block *dst, const block *a, const block *b, size_t LEN)
+{
+    BinaryOp<0>(dst, a, b, 1, LEN);
+}
+
+// dst[i] = a[i] and b[i]
+inline void AndInto(block *dst, const block *a, const block *b, size_t LEN)
+{
+    BinaryOp<1>(dst, a, b, 1, LEN);
+}
+
+// dst[i] = a[i] xor b
+inline void XorScalarInto(block *dst, const block *a, const block &b, size_t LEN)
+{
+    BinaryOp<0>(dst, a, &b, 0, LEN);
+}
+
+// mask[i] = 1 iff a[i] = b[i]
+__attribute__((target("sse2")))
+inline void EqualMaskSSE2(uint8_t *mask, const block *a, const block *b, size_t LEN)
+{
+    for (auto i = 0; i < LEN; i++){
+        mask[i] = _mm_movemask_epi8(_mm_cmpeq_epi8(a[i], b[i])) == 0xFFFF;
+    }
+}
+
+__attribute__((target("sse4.1")))
+inline void EqualMaskSSE4(uint8_t *mask, const block *a, const block *b, size_t LEN)
+{
+    for (auto i = 0; i < LEN; i++){
+        __m128i diff = _mm_xor_si128(a[i], b[i]);
+        mask[i] = _mm_testz_si128(diff, diff);
+    }
+}
+
+__attribute__((target("avx2")))
+inline void EqualMaskAVX2(uint8_t *mask, const block *a, const block *b, size_t LEN)
+{
+    size_t i = 0;
+    for (; i + 2 <= LEN; i += 2){
+        __m256i eq = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(a + i)), _mm256_loadu_si256((const __m256i*)(b + i)));
+        // one bit per 64-bit lane; a block is equal iff both of its lanes are
+        uint32_t lane = _mm256_movemask_pd(_mm256_castsi256_pd(eq));
+        uint32_t both = lane & (lane >> 1);
+        mask[i] = both & 1;
+        mask[i+1] = (both >> 2) & 1;
+    }
+    EqualMaskSSE2(mask + i, a + i, b + i, LEN - i);
+}
+
+__attribute__((target("avx512f")))
+inline void EqualMaskAVX512(uint8_t *mask, const block *a, const block *b, size_t LEN)
+{
+    size_t i = 0;
+    for (; i + 4 <= LEN; i += 4){
+        __mmask8 eq = _mm512_cmpeq_epi64_mask(_mm512_loadu_si512((const void*)(a + i)), _mm512_loadu_si512((const void*)(b + i)));
+        // a block is equal iff both of its 64-bit lanes are
+        uint32_t both = eq & (eq >> 1);
+        for (auto j = 0; j < 4; j++) mask[i+j] = (both >> (2*j)) & 1;
+    }
+    EqualMaskSSE2(mask + i, a + i, b + i, LEN - i);
+}
+
+inline void EqualMask(uint8_t *mask, const block *a, const block *b, size_t LEN)
+{
+    ForEachChunk(LEN, [&](size_t begin, size_t end){
+        if (simd_level == AVX512) EqualMaskAVX512(mask + begin, a + begin, b + begin, end - begin);
+        else if (simd_level == AVX2) EqualMaskAVX2(mask + begin, a + begin, b + begin, end - begin);
+        else if (sse41_support) EqualMaskSSE4(mask + begin, a + begin, b + begin, end - begin);
+        else EqualMaskSSE2(mask + begin, a + begin, b + begin, end - begin);
+    });
+}
+
+inline std::vector<block> AND(const std::vector<block> &vec_a, const std::vector<block> &vec_b) 
 {
     if(vec_a.size()!=vec_b.size()){
         std::cerr << "XORBlocks: size does not match" << std::endl;
@@ -65,14 +227,12 @@ inline std::vector<block> AND(std::vector<block> &vec_a, std::vector<block> &vec
     size_t LEN = vec_a.size();
 
 	std::vector<block> vec_result(LEN); 
-    for (auto i = 0; i < LEN; i++){
-        vec_result[i] = _mm_and_si128(vec_a[i], vec_b[i]);
-    }
+    AndInto(vec_result.data(), vec_a.data(), vec_b.data(), LEN); 
     return vec_result;
 }
 
 
-inline std::vector<block> XOR(std::vector<block> &vec_a, std::vector<block> &vec_b) 
+inline std::vector<block> XOR(const std::vector<block> &vec_a, const std::vector<block> &vec_b) 
 {
     if(vec_a.size()!=vec_b.size()){
         std::cerr << "XORBlocks: size does not match" << std::endl;
@@ -80,19 +240,15 @@ inline std::vector<block> XOR(std::vector<block> &vec_a, std::vector<block> &vec
     size_t LEN = vec_a.size();
 
 	std::vector<block> vec_result(LEN); 
-    for (auto i = 0; i < LEN; i++){
-        vec_result[i] = vec_a[i] ^ vec_b[i];
-    }
+    XorInto(vec_result.data(), vec_a.data(), vec_b.data(), LEN); 
     return vec_result;
 }
 
-inline std::vector<block> FixXOR(std::vector<block> &vec_a, block &b) 
+inline std::vector<block> FixXOR(const std::vector<block> &vec_a, const block &b) 
 {
     size_t LEN = vec_a.size();
     std::vector<block> vec_result(LEN); 
-    for (auto i = 0; i < LEN; i++){
-        vec_result[i] = vec_a[i] ^ b;
-    }
+    XorScalarInto(vec_result.data(), vec_a.data(), b, LEN); 
     return vec_result; 
 }
 
@@ -342,5 +498,163 @@ inline void BitMatrixTranspose(uint8_t const *input, uint64_t ROW_NUM, uint64_t
 }
 
 
+/*
+** cache-blocked transpose for OT extension
+** input: COLUMN_NUM columns of ROW_NUM bits, column j takes ROW_NUM/128 blocks (matrix Q and T in IKNP/ALSZ)
+** output: ROW_NUM rows of COLUMN_NUM bits, row i takes COLUMN_NUM/128 blocks
+** same result as BitMatrixTranspose((uint8_t*)input, COLUMN_NUM, ROW_NUM, (uint8_t*)output)
+** ROW_NUM and COLUMN_NUM must be multiples of 128
+**
+** the matrix is cut into 128x128 tiles: a tile reads 16 bytes of 128 columns and writes 2KB, so it stays in L1,
+** and the next tile reads the rest of the same cache lines; tiles of different rows run in parallel
+** a tile first transposes bytes with in-lane unpacks, then peels off one bit plane per movemask
+*/
+
+/*
+** transpose a 128x128 tile: bit y of column k (column k starts at input + k*IN_STRIDE) 
+** goes to bit k of row y (row y starts at output + y*OUT_STRIDE)
+*/
+__attribute__((target("sse2")))
+inline void TransposeTileSSE2(const block *input, size_t IN_STRIDE, block *output, size_t OUT_STRIDE)
+{
+    __m128i vec[16], tmp[16];
+    for (auto g = 0; g < 8; g++) {
+        for (auto k = 0; k < 16; k++) vec[k] = _mm_loadu_si128(input + (16*g + k)*IN_STRIDE);
+        // each round maps (vector index | byte index) to its rotation by one bit, four rounds swap them
+        for (auto round = 0; round < 2; round++) {
+            for (auto k = 0; k < 8; k++) {
+                tmp[2*k] = _mm_unpacklo_epi8(vec[k], vec[k+8]);
+                tmp[2*k+1] = _mm_unpackhi_epi8(vec[k], vec[k+8]);
+            }
+            for (auto k = 0; k < 8; k++) {
+                vec[2*k] = _mm_unpacklo_epi8(tmp[k], tmp[k+8]);
+                vec[2*k+1] = _mm_unpackhi_epi8(tmp[k], tmp[k+8]);
+            }
+        }
+        // byte k of vec[c] is byte c of column 16g+k
+        for (auto c = 0; c < 16; c++) {
+            __m128i v = vec[c];
+            for (auto b = 8; --b >= 0; v = _mm_slli_epi64(v, 1))
+                ((uint16_t*)(output + (8*c + b)*OUT_STRIDE))[g] = _mm_movemask_epi8(v);
+        }
+    }
+}
+
+// two 16x16 byte transposes per round: lane 0 holds columns 32g..32g+15, lane 1 holds the next 16
+__attribute__((target("avx2")))
+inline void TransposeTileAVX2(const block *input, size_t IN_STRIDE, block *output, size_t OUT_STRIDE)
+{
+    __m256i vec[16], tmp[16];
+    for (auto g = 0; g < 4; g++) {
+        for (auto k = 0; k < 16; k++) {
+            __m128i lo = _mm_loadu_si128(input + (32*g + k)*IN_STRIDE);
+            __m128i hi = _mm_loadu_si128(input + (32*g + 16 + k)*IN_STRIDE);
+            vec[k] = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        }
+        for (auto round = 0; round < 2; round++) {
+            for (auto k = 0; k < 8; k++) {
+                tmp[2*k] = _mm256_unpacklo_epi8(vec[k], vec[k+8]);
+                tmp[2*k+1] = _mm256_unpackhi_epi8(vec[k], vec[k+8]);
+            }
+            for (auto k = 0; k < 8; k++) {
+                vec[2*k] = _mm256_unpacklo_epi8(tmp[k], tmp[k+8]);
+                vec[2*k+1] = _mm256_unpackhi_epi8(tmp[k], tmp[k+8]);
+            }
+        }
+        for (auto c = 0; c < 16; c++) {
+            __m256i v = vec[c];
+            for (auto b = 8; --b >= 0; v = _mm256_slli_epi64(v, 1))
+                ((uint32_t*)(output + (8*c + b)*OUT_STRIDE))[g] = _mm256_movemask_epi8(v);
+        }
+    }
+}
+
+// four 16x16 byte transposes per round: lane l holds columns 64g+16l..64g+16l+15
+__attribute__((target("avx512f,avx512bw")))
+inline void TransposeTileAVX512(const block *input, size_t IN_STRIDE, block *output, size_t OUT_STRIDE)
+{
+    __m512i vec[16], tmp[16];
+    for (auto g = 0; g < 2; g++) {
+        for (auto k = 0; k < 16; k++) {
+            __m512i v = _mm512_castsi128_si512(_mm_loadu_si128(input + (64*g + k)*IN_STRIDE));
+            v = _mm512_inserti32x4(v, _mm_loadu_si128(input + (64*g + 16 + k)*IN_STRIDE), 1);
+            v = _mm512_inserti32x4(v, _mm_loadu_si128(input + (64*g + 32 + k)*IN_STRIDE), 2);
+            vec[k] = _mm512_inserti32x4(v, _mm_loadu_si128(input + (64*g + 48 + k)*IN_STRIDE), 3);
+        }
+        for (auto round = 0; round < 2; round++) {
+            for (auto k = 0; k < 8; k++) {
+                tmp[2*k] = _mm512_unpacklo_epi8(vec[k], vec[k+8]);
+                tmp[2*k+1] = _mm512_unpackhi_epi8(vec[k], vec[k+8]);
+            }
+            for (auto k = 0; k < 8; k++) {
+                vec[2*k] = _mm512_unpacklo_epi8(tmp[k], tmp[k+8]);
+                vec[2*k+1] = _mm512_unpackhi_epi8(tmp[k], tmp[k+8]);
+            }
+        }
+        for (auto c = 0; c < 16; c++) {
+            __m512i v = vec[c];
+            for (auto b = 8; --b >= 0; v = _mm512_slli_epi64(v, 1))
+                ((uint64_t*)(output + (8*c + b)*OUT_STRIDE))[g] = _mm512_movepi8_mask(v);
+        }
+    }
+}
+
+typedef void (*TransposeTileFunction)(const block*, size_t, block*, size_t);
+
+inline TransposeTileFunction SelectTransposeTile()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512bw")) return TransposeTileAVX512;
+    if (__builtin_cpu_supports("avx2")) return TransposeTileAVX2;
+    return TransposeTileSSE2;
+}
+
+inline void CheckTransposeSize(size_t ROW_NUM, size_t COLUMN_NUM)
+{
+    if (ROW_NUM%128 != 0 || COLUMN_NUM%128 != 0){
+        std::cerr << "FastBitMatrixTranspose: sizes must be multiples of 128" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+// transpose the 128 rows starting at row 128*t: row 128*t+i goes to output + i*COLUMN_NUM/128
+inline void TransposeTileRow(TransposeTileFunction TransposeTile, const block *input, size_t COLUMN_NUM, size_t ROW_NUM, 
+                             size_t t, block *output)
+{
+    for (auto h = 0; h < COLUMN_NUM/128; h++)
+        TransposeTile(input + h*128*ROW_NUM/128 + t, ROW_NUM/128, output + h, COLUMN_NUM/128);
+}
+
+inline void FastBitMatrixTranspose(const block *input, size_t COLUMN_NUM, size_t ROW_NUM, block *output)
+{
+    CheckTransposeSize(ROW_NUM, COLUMN_NUM);
+    TransposeTileFunction TransposeTile = SelectTransposeTile();
+    size_t TILE_NUM = ROW_NUM/128;
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS) if(TILE_NUM >= 64)
+    for (auto t = 0; t < TILE_NUM; t++)
+        TransposeTileRow(TransposeTile, input, COLUMN_NUM, ROW_NUM, t, output + t*COLUMN_NUM);
+}
+
+/*
+** fused transpose-then-hash: the transposed matrix is never stored in full
+** f(ROW_BEGIN, rows) is called once per tile with rows ROW_BEGIN..ROW_BEGIN+127 (COLUMN_NUM/128 blocks each) 
+** in a per-thread scratch buffer that f may overwrite; calls for different tiles may run in parallel
+*/
+template <typename Function>
+inline void FastBitMatrixTransposeRows(const block *input, size_t COLUMN_NUM, size_t ROW_NUM, Function f)
+{
+    CheckTransposeSize(ROW_NUM, COLUMN_NUM);
+    TransposeTileFunction TransposeTile = SelectTransposeTile();
+    size_t TILE_NUM = ROW_NUM/128;
+    #pragma omp parallel num_threads(NUMBER_OF_THREADS) if(TILE_NUM >= 64)
+    {
+        std::vector<block> tile(COLUMN_NUM);
+        #pragma omp for schedule(static)
+        for (auto t = 0; t < TILE_NUM; t++) {
+            TransposeTileRow(TransposeTile, input, COLUMN_NUM, ROW_NUM, t, tile.data());
+            f(t*128, tile.data());
+        }
+    }
+}
 
 #endif
@@ -89,7 +89,6 @@ EC25519Point EC25519Point::Mul(const std::vector<uint8_t> scalar) const {
 
 EC25519Point EC25519Point::XOR(const EC25519Point& other) const {  
     EC25519Point result;
-    int thread_num = omp_get_thread_num();
     #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
     for(auto i = 0; i < 32; i++){
         result.px[i] = this->px[i]^other.px[i];
@@ -137,11 +136,14 @@ std::ifstream &operator>>(std::ifstream &fin, EC25519Point &A)
     return fin;            
 }
 
+// the first 8 bytes of the pseudo-random u-coordinate serve as hash value: no allocation per lookup
 class EC25519PointHash{
 public:
     size_t operator()(const EC25519Point& A) const
     {
-        return std::hash<std::string>{}(A.ToByteString());
+        size_t hashvalue; 
+        memcpy(&hashvalue, A.px, sizeof(hashvalue)); 
+        return hashvalue; 
     }
 };
 
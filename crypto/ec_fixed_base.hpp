@@ -0,0 +1,283 @@
+/****************************************************************************
+this hpp implements fixed-base precomputation tables for long-lived points
+(public keys, commitment generators, the h of twisted ElGamal, ...)
+for each window j and each signed digit d the table keeps d*2^{jw}*A in affine form,
+so that A*a costs one mixed addition per window and no doubling at all
+table lookups depend on the scalar, so avoid using the table with secret scalars
+if timing side channels are a concern
+*****************************************************************************
+* @copyright  MIT license (see LICENSE file)
+*****************************************************************************/
+#ifndef KUNLUN_EC_FIXED_BASE_HPP_
+#define KUNLUN_EC_FIXED_BASE_HPP_
+
+#include "ec_point.hpp"
+
+class FixedBaseTable{
+public:
+    ECPoint base;
+    size_t WINDOW_SIZE = 0;
+    size_t WINDOW_NUM = 0;
+    // table[j*2^{w-1} + (d-1)] = d*2^{jw}*base for d in [1, 2^{w-1}]; empty if the native backend is not available
+    std::vector<AffinePoint> table;
+
+    FixedBaseTable() {}
+    FixedBaseTable(const ECPoint &A, size_t WINDOW_SIZE = 6) { this->Build(A, WINDOW_SIZE); }
+
+    // precompute the table of A
+    void Build(const ECPoint &A, size_t WINDOW_SIZE = 6);
+
+    // Returns base * scalar
+    ECPoint Mul(const BigInt &scalar) const;
+    // Returns (base * vec_a[0], ..., base * vec_a[n-1])
+    std::vector<ECPoint> MulMany(const std::vector<BigInt> &vec_a) const;
+
+    inline ECPoint operator*(const BigInt &scalar) const { return this->Mul(scalar); }
+
+    friend std::ofstream &operator<<(std::ofstream &fout, const FixedBaseTable &T);
+    friend std::ifstream &operator>>(std::ifstream &fin, FixedBaseTable &T);
+
+private:
+    bool IsConsistent() const;
+    void MulJacobian(JacobianPoint &result, const BigInt &scalar, BN_CTX *ctx) const;
+};
+
+void FixedBaseTable::Build(const ECPoint &A, size_t WINDOW_SIZE)
+{
+    if (WINDOW_SIZE < 2 || WINDOW_SIZE > 16){
+        std::cerr << "window size of fixed-base table must lie in [2, 16]" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    this->base = A;
+    this->WINDOW_SIZE = WINDOW_SIZE;
+    // one more bit to absorb the carry of the signed-digit recoding
+    this->WINDOW_NUM = (BN_num_bits(order) + 1 + WINDOW_SIZE - 1) / WINDOW_SIZE;
+    this->table.clear();
+    if (!ECJacobian::ENABLE || A.IsAtInfinity()) return;
+
+    size_t HALF = size_t(1) << (WINDOW_SIZE - 1);
+
+    // window_base[j] = 2^{jw}*A
+    std::vector<JacobianPoint> window_base(this->WINDOW_NUM);
+    BIGNUM *X = BN_new();
+    BIGNUM *Y = BN_new();
+    BIGNUM *Z = BN_new();
+    ECJacobian::FromECPoint(window_base[0], A.point_ptr, X, Y, Z, GetBNCtx());
+    BN_free(X);
+    BN_free(Y);
+    BN_free(Z);
+    for (auto j = 1; j < this->WINDOW_NUM; j++){
+        window_base[j] = window_base[j-1];
+        for (auto t = 0; t < WINDOW_SIZE; t++) ECJacobian::Double(window_base[j], window_base[j]);
+    }
+
+    std::vector<JacobianPoint> jacobian_table(this->WINDOW_NUM * HALF);
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for (auto j = 0; j < this->WINDOW_NUM; j++){
+        JacobianPoint *row = jacobian_table.data() + j*HALF;
+        row[0] = window_base[j];
+        for (auto d = 1; d < HALF; d++) ECJacobian::Add(row[d], row[d-1], window_base[j]);
+    }
+
+    this->table.resize(this->WINDOW_NUM * HALF);
+    ECJacobian::BatchNormalize(this->table.data(), jacobian_table.data(), jacobian_table.size());
+}
+
+/*
+** a loaded table must belong to base: every entry lies on the curve, and the first and last entry of 
+** each row are recomputed from base (2^{jw}*base and 2^{w-1}*2^{jw}*base, WINDOW_NUM*w doublings in all)
+*/
+bool FixedBaseTable::IsConsistent() const
+{
+    if (this->base.IsAtInfinity()) return false;
+    size_t HALF = size_t(1) << (this->WINDOW_SIZE - 1);
+    for (auto i = 0; i < this->table.size(); i++){
+        if (this->table[i].infinity || !ECJacobian::IsOnCurve(this->table[i])) return false;
+    }
+
+    // expected[2j] = 2^{jw}*base, expected[2j+1] = 2^{w-1}*2^{jw}*base
+    std::vector<JacobianPoint> expected(2 * this->WINDOW_NUM);
+    BIGNUM *X = BN_new();
+    BIGNUM *Y = BN_new();
+    BIGNUM *Z = BN_new();
+    ECJacobian::FromECPoint(expected[0], this->base.point_ptr, X, Y, Z, GetBNCtx());
+    BN_free(X);
+    BN_free(Y);
+    BN_free(Z);
+    for (auto j = 0; j < this->WINDOW_NUM; j++){
+        if (j > 0){
+            expected[2*j] = expected[2*j-1];
+            ECJacobian::Double(expected[2*j], expected[2*j]);
+        }
+        expected[2*j+1] = expected[2*j];
+        for (auto t = 1; t < this->WINDOW_SIZE; t++) ECJacobian::Double(expected[2*j+1], expected[2*j+1]);
+    }
+    std::vector<AffinePoint> affine_expected(expected.size());
+    ECJacobian::BatchNormalize(affine_expected.data(), expected.data(), expected.size());
+
+    for (auto j = 0; j < this->WINDOW_NUM; j++){
+        if (!ECJacobian::IsEqual(this->table[j*HALF], affine_expected[2*j])) return false;
+        if (!ECJacobian::IsEqual(this->table[j*HALF + HALF-1], affine_expected[2*j+1])) return false;
+    }
+    return true;
+}
+
+void FixedBaseTable::MulJacobian(JacobianPoint &result, const BigInt &scalar, BN_CTX *ctx) const
+{
+    size_t LIMB_NUM = (this->WINDOW_NUM * this->WINDOW_SIZE + 63) / 64;
+    std::vector<uint64_t> limbs(LIMB_NUM);
+    BigInt k;
+    CRYPTO_CHECK(1 == BN_nnmod(k.bn_ptr, scalar.bn_ptr, order, ctx));
+    BN_bn2lebinpad(k.bn_ptr, reinterpret_cast<unsigned char*>(limbs.data()), LIMB_NUM*8);
+
+    size_t HALF = size_t(1) << (this->WINDOW_SIZE - 1);
+    size_t carry = 0;
+    ECJacobian::SetInfinity(result);
+    for (auto j = 0; j < this->WINDOW_NUM; j++){
+        // signed digit in [-(2^{w-1}-1), 2^{w-1}]
+        size_t digit = PippengerGetWindow(limbs.data(), LIMB_NUM, j, this->WINDOW_SIZE) + carry;
+        carry = (digit > HALF);
+        if (carry == 1) digit = (size_t(1) << this->WINDOW_SIZE) - digit;
+        if (digit == 0) continue;
+
+        const AffinePoint &entry = this->table[j*HALF + digit - 1];
+        if (carry == 1){
+            AffinePoint neg_entry = entry;
+            ECJacobian::field.Neg(neg_entry.y, entry.y);
+            ECJacobian::MixedAdd(result, result, neg_entry);
+        }
+        else ECJacobian::MixedAdd(result, result, entry);
+    }
+}
+
+ECPoint FixedBaseTable::Mul(const BigInt &scalar) const
+{
+    ECPoint result;
+    if (this->table.empty()){
+        CRYPTO_CHECK(1 == EC_POINT_mul(group, result.point_ptr, nullptr, this->base.point_ptr, scalar.bn_ptr, GetBNCtx()));
+        return result;
+    }
+    JacobianPoint R;
+    this->MulJacobian(R, scalar, GetBNCtx());
+    ECJacobian::ToECPoint(result.point_ptr, R, GetBNCtx());
+    return result;
+}
+
+std::vector<ECPoint> FixedBaseTable::MulMany(const std::vector<BigInt> &vec_a) const
+{
+    size_t LEN = vec_a.size();
+    std::vector<ECPoint> vec_result(LEN);
+
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for (auto i = 0; i < LEN; i++){
+        BN_CTX *ctx = GetBNCtx();
+        if (this->table.empty()){
+            CRYPTO_CHECK(1 == EC_POINT_mul(group, vec_result[i].point_ptr, nullptr, this->base.point_ptr, vec_a[i].bn_ptr, ctx));
+            continue;
+        }
+        JacobianPoint R;
+        this->MulJacobian(R, vec_a[i], ctx);
+        ECJacobian::ToECPoint(vec_result[i].point_ptr, R, ctx);
+    }
+    return vec_result;
+}
+
+/*
+** layout: base || WINDOW_SIZE || TABLE_SIZE || entries
+** each entry is x || y in big-endian bytes, the same encoding for any build of the library
+*/
+std::ofstream &operator<<(std::ofstream &fout, const FixedBaseTable &T)
+{
+    using Serialization::operator<<;
+    fout << T.base;
+    fout << T.WINDOW_SIZE;
+    fout << T.table.size();
+
+    std::vector<unsigned char> buffer(T.table.size() * 64);
+    for (auto i = 0; i < T.table.size(); i++){
+        ECJacobian::field.ToBytes(buffer.data() + 64*i, T.table[i].x);
+        ECJacobian::field.ToBytes(buffer.data() + 64*i + 32, T.table[i].y);
+    }
+    fout.write(reinterpret_cast<char *>(buffer.data()), buffer.size());
+    return fout;
+}
+
+std::ifstream &operator>>(std::ifstream &fin, FixedBaseTable &T)
+{
+    using Serialization::operator>>;
+    size_t TABLE_SIZE;
+    fin >> T.base;
+    fin >> T.WINDOW_SIZE;
+    fin >> TABLE_SIZE;
+    if (!fin){
+        std::cerr << "fixed-base table file is truncated" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    T.table.clear();
+    // a default-constructed table is written as WINDOW_SIZE = TABLE_SIZE = 0
+    if (T.WINDOW_SIZE == 0 && TABLE_SIZE == 0){
+        T.WINDOW_NUM = 0;
+        return fin;
+    }
+    if (T.WINDOW_SIZE < 2 || T.WINDOW_SIZE > 16){
+        std::cerr << "window size of fixed-base table must lie in [2, 16]" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    T.WINDOW_NUM = (BN_num_bits(order) + 1 + T.WINDOW_SIZE - 1) / T.WINDOW_SIZE;
+    // Build leaves the table empty without the native backend or for the infinity
+    if (TABLE_SIZE != 0 && TABLE_SIZE != (T.WINDOW_NUM << (T.WINDOW_SIZE - 1))){
+        std::cerr << "fixed-base table size does not match its window size" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    std::vector<unsigned char> buffer(TABLE_SIZE * 64);
+    fin.read(reinterpret_cast<char *>(buffer.data()), buffer.size());
+    if (!fin){
+        std::cerr << "fixed-base table file is truncated" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    // the entries are of no use to a build without the native backend
+    if (!ECJacobian::ENABLE) return fin;
+
+    T.table.resize(TABLE_SIZE);
+    for (auto i = 0; i < TABLE_SIZE; i++){
+        ECJacobian::field.FromBytes(T.table[i].x, buffer.data() + 64*i);
+        ECJacobian::field.FromBytes(T.table[i].y, buffer.data() + 64*i + 32);
+        T.table[i].infinity = false;
+    }
+    if (TABLE_SIZE != 0 && !T.IsConsistent()){
+        std::cerr << "fixed-base table does not match its base point" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    return fin;
+}
+
+// save the table to file
+void SaveFixedBaseTable(const FixedBaseTable &T, std::string table_filename)
+{
+    std::ofstream fout;
+    fout.open(table_filename, std::ios::binary);
+    if(!fout)
+    {
+        std::cerr << table_filename << " open error" << std::endl;
+        exit(1);
+    }
+    fout << T;
+    fout.close();
+}
+
+// fetch the table from file
+void FetchFixedBaseTable(FixedBaseTable &T, std::string table_filename)
+{
+    std::ifstream fin;
+    fin.open(table_filename, std::ios::binary);
+    if(!fin)
+    {
+        std::cerr << table_filename << " open error" << std::endl;
+        exit(1);
+    }
+    fin >> T;
+    fin.close();
+}
+
+#endif
@@ -16,6 +16,8 @@
 inline int curve_id = NID_X9_62_prime256v1;  
 //#define ECPOINT_COMPRESSED
 #define ENABLE_X25519_ACCELERATION
+// run the group-generic protocols (see GroupPoint in ec_ristretto.hpp) on ristretto255
+//#define ENABLE_RISTRETTO_GROUP
 
 inline EC_GROUP *group;
 const inline EC_POINT *generator; 
@@ -41,19 +43,19 @@ void ECGroup_Initialize(){
     generator = EC_GROUP_get0_generator(group);
 
     order = BN_new(); 
-    CRYPTO_CHECK(EC_GROUP_get_order(group, order, bn_ctx[0]) == 1);
+    CRYPTO_CHECK(EC_GROUP_get_order(group, order, GetBNCtx()) == 1);
 
     cofactor = BN_new(); 
-    CRYPTO_CHECK(EC_GROUP_get_cofactor(group, cofactor, bn_ctx[0]) == 1); 
+    CRYPTO_CHECK(EC_GROUP_get_cofactor(group, cofactor, GetBNCtx()) == 1); 
 
     curve_params_p = BN_new(); 
     curve_params_a = BN_new();
     curve_params_b = BN_new(); 
 
-    CRYPTO_CHECK(EC_GROUP_get_curve_GFp(group, curve_params_p, curve_params_a, curve_params_b, bn_ctx[0]) == 1); 
+    CRYPTO_CHECK(EC_GROUP_get_curve_GFp(group, curve_params_p, curve_params_a, curve_params_b, GetBNCtx()) == 1); 
 
     size_t rounds = 100; 
-    CRYPTO_CHECK(BN_is_prime_ex(curve_params_p, rounds, bn_ctx[0], nullptr) == 1);
+    CRYPTO_CHECK(BN_is_prime_ex(curve_params_p, rounds, GetBNCtx(), nullptr) == 1);
 
     curve_params_q = BN_new(); 
     BN_rshift(curve_params_q, curve_params_p, 1); // p_minus_one_over_two = (p-1)/2
@@ -74,7 +76,7 @@ void ECGroup_Initialize(){
      
     
     #ifdef PRECOMPUTE_ENABLE
-        EC_GROUP_precompute_mult((EC_GROUP*) group, bn_ctx[0]); // pre-compute the table of g    
+        EC_GROUP_precompute_mult((EC_GROUP*) group, GetBNCtx()); // pre-compute the table of g    
         // check if precomputation have been done properly
         if(EC_GROUP_have_precompute_mult((EC_GROUP*) group) == 0){
             std::cerr << "pre-computation is not done properly" << std::endl;
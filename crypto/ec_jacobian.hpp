@@ -0,0 +1,630 @@
+/****************************************************************************
+this hpp implements native Jacobian-coordinate arithmetic for short Weierstrass
+curves whose base field fits in 256 bits (e.g. prime256v1, secp256k1)
+field elements are 4x64-bit limbs in Montgomery form, no heap allocation involved
+it is used as the backend of the bucket-method multi-scalar multiplication
+*****************************************************************************
+* @copyright  MIT license (see LICENSE file)
+*****************************************************************************/
+#ifndef KUNLUN_EC_JACOBIAN_HPP_
+#define KUNLUN_EC_JACOBIAN_HPP_
+
+#include "ec_group.hpp"
+
+typedef unsigned __int128 uint128_t;
+
+inline const size_t FIELD_LIMB_NUM = 4;
+
+struct FieldElement{
+    uint64_t limb[FIELD_LIMB_NUM]; // little-endian limbs
+};
+
+// Montgomery arithmetic modulo an odd modulus m < 2^256, R = 2^256
+class MontField{
+public:
+    uint64_t modulus[FIELD_LIMB_NUM];
+    uint64_t n0;                    // -m^{-1} mod 2^64
+    FieldElement R2;                // R^2 mod m
+    FieldElement one;               // R mod m (1 in Montgomery form)
+    FieldElement zero;
+
+    // set up the constants for the given modulus, return false if it does not fit
+    bool Initialize(const BIGNUM *m);
+
+    inline bool IsZero(const FieldElement &a) const;
+    inline bool IsEqual(const FieldElement &a, const FieldElement &b) const;
+
+    inline void Add(FieldElement &r, const FieldElement &a, const FieldElement &b) const;
+    inline void Sub(FieldElement &r, const FieldElement &a, const FieldElement &b) const;
+    inline void Neg(FieldElement &r, const FieldElement &a) const;
+    inline void Mul(FieldElement &r, const FieldElement &a, const FieldElement &b) const;
+    inline void Sqr(FieldElement &r, const FieldElement &a) const;
+
+    // r = a^e where e is given as little-endian limbs
+    void Exp(FieldElement &r, const FieldElement &a, const uint64_t *e, size_t LIMB_NUM) const;
+    // r = a^{-1} via Fermat's little theorem: requires a prime modulus
+    void Inv(FieldElement &r, const FieldElement &a) const;
+    // r[i] = a[i]^{-1} with one inversion (Montgomery's trick), zero entries are left as zero
+    void BatchInv(FieldElement *r, const FieldElement *a, size_t LEN) const;
+
+    // conversions between BIGNUM (normal form, must lie in [0, m)) and Montgomery form
+    void FromBigNum(FieldElement &r, const BIGNUM *a) const;
+    void ToBigNum(BIGNUM *r, const FieldElement &a) const;
+    void FromBytes(FieldElement &r, const unsigned char *buffer) const; // 32 bytes big-endian
+    void ToBytes(unsigned char *buffer, const FieldElement &a) const;
+
+private:
+    inline void Reduce(FieldElement &r, uint64_t carry, const uint64_t *t) const;
+};
+
+inline bool MontField::IsZero(const FieldElement &a) const
+{
+    return (a.limb[0] | a.limb[1] | a.limb[2] | a.limb[3]) == 0;
+}
+
+inline bool MontField::IsEqual(const FieldElement &a, const FieldElement &b) const
+{
+    return ((a.limb[0]^b.limb[0]) | (a.limb[1]^b.limb[1]) | (a.limb[2]^b.limb[2]) | (a.limb[3]^b.limb[3])) == 0;
+}
+
+/*
+** the kernels below copy the operands and the modulus into locals first: r may alias a, b or the 
+** members of the field, and without the copies the compiler has to reload them after every store
+*/
+
+// r = t - m if (carry:t) >= m else t
+inline void MontField::Reduce(FieldElement &r, uint64_t carry, const uint64_t *t) const
+{
+    uint64_t s[FIELD_LIMB_NUM];
+    unsigned char borrow = 0;
+    for (auto i = 0; i < FIELD_LIMB_NUM; i++){
+        borrow = _subborrow_u64(borrow, t[i], this->modulus[i], (unsigned long long*)&s[i]);
+    }
+    // keep t only if it was smaller than m, i.e. the subtraction borrowed and there is no carry
+    uint64_t mask = 0 - (uint64_t)((borrow == 1) && (carry == 0));
+    for (auto i = 0; i < FIELD_LIMB_NUM; i++){
+        r.limb[i] = (t[i] & mask) | (s[i] & ~mask);
+    }
+}
+
+inline void MontField::Add(FieldElement &r, const FieldElement &a, const FieldElement &b) const
+{
+    uint64_t t[FIELD_LIMB_NUM];
+    unsigned char carry = 0;
+    for (auto i = 0; i < FIELD_LIMB_NUM; i++){
+        carry = _addcarry_u64(carry, a.limb[i], b.limb[i], (unsigned long long*)&t[i]);
+    }
+    Reduce(r, carry, t);
+}
+
+inline void MontField::Sub(FieldElement &r, const FieldElement &a, const FieldElement &b) const
+{
+    uint64_t t[FIELD_LIMB_NUM];
+    unsigned char borrow = 0;
+    for (auto i = 0; i < FIELD_LIMB_NUM; i++){
+        borrow = _subborrow_u64(borrow, a.limb[i], b.limb[i], (unsigned long long*)&t[i]);
+    }
+    // add m back if a < b
+    uint64_t mask = 0 - (uint64_t)borrow;
+    unsigned char carry = 0;
+    for (auto i = 0; i < FIELD_LIMB_NUM; i++){
+        carry = _addcarry_u64(carry, t[i], this->modulus[i] & mask, (unsigned long long*)&t[i]);
+    }
+    r.limb[0] = t[0]; r.limb[1] = t[1]; r.limb[2] = t[2]; r.limb[3] = t[3];
+}
+
+inline void MontField::Neg(FieldElement &r, const FieldElement &a) const
+{
+    Sub(r, this->zero, a);
+}
+
+// (carry:lo) = a*b + t + carry
+inline void MulAddCarry(uint64_t &lo, uint64_t &carry, uint64_t a, uint64_t b, uint64_t t)
+{
+    uint128_t x = (uint128_t)a * b + t + carry;
+    lo = (uint64_t)x;
+    carry = (uint64_t)(x >> 64);
+}
+
+// CIOS Montgomery multiplication: r = a*b*R^{-1} mod m
+inline void MontField::Mul(FieldElement &r, const FieldElement &a, const FieldElement &b) const
+{
+    uint64_t a0 = a.limb[0], a1 = a.limb[1], a2 = a.limb[2], a3 = a.limb[3];
+    uint64_t m0 = this->modulus[0], m1 = this->modulus[1], m2 = this->modulus[2], m3 = this->modulus[3];
+    uint64_t b_copy[FIELD_LIMB_NUM] = {b.limb[0], b.limb[1], b.limb[2], b.limb[3]};
+    uint64_t m_inverse = this->n0;
+
+    uint64_t t[FIELD_LIMB_NUM+1] = {0};
+    for (auto i = 0; i < FIELD_LIMB_NUM; i++){
+        // t = t + a*b[i]
+        uint64_t carry = 0;
+        MulAddCarry(t[0], carry, a0, b_copy[i], t[0]);
+        MulAddCarry(t[1], carry, a1, b_copy[i], t[1]);
+        MulAddCarry(t[2], carry, a2, b_copy[i], t[2]);
+        MulAddCarry(t[3], carry, a3, b_copy[i], t[3]);
+        uint128_t x = (uint128_t)t[4] + carry;
+        t[4] = (uint64_t)x;
+        uint64_t t5 = (uint64_t)(x >> 64);
+
+        // t = (t + u*m) / 2^64
+        uint64_t u = t[0] * m_inverse;
+        carry = 0;
+        MulAddCarry(t[0], carry, u, m0, t[0]);
+        MulAddCarry(t[0], carry, u, m1, t[1]);
+        MulAddCarry(t[1], carry, u, m2, t[2]);
+        MulAddCarry(t[2], carry, u, m3, t[3]);
+        x = (uint128_t)t[4] + carry;
+        t[3] = (uint64_t)x;
+        t[4] = t5 + (uint64_t)(x >> 64);
+    }
+    Reduce(r, t[FIELD_LIMB_NUM], t);
+}
+
+// r = a^2*R^{-1} mod m: the 6 cross products are computed once and doubled, then the 512-bit square is reduced
+inline void MontField::Sqr(FieldElement &r, const FieldElement &a) const
+{
+    uint64_t a0 = a.limb[0], a1 = a.limb[1], a2 = a.limb[2], a3 = a.limb[3];
+    uint64_t m_copy[FIELD_LIMB_NUM] = {this->modulus[0], this->modulus[1], this->modulus[2], this->modulus[3]};
+    uint64_t m_inverse = this->n0;
+
+    uint64_t t[2*FIELD_LIMB_NUM];
+    uint64_t carry = 0;
+    MulAddCarry(t[1], carry, a0, a1, 0);
+    MulAddCarry(t[2], carry, a0, a2, 0);
+    MulAddCarry(t[3], carry, a0, a3, 0);
+    t[4] = carry; carry = 0;
+    MulAddCarry(t[3], carry, a1, a2, t[3]);
+    MulAddCarry(t[4], carry, a1, a3, t[4]);
+    t[5] = carry; carry = 0;
+    MulAddCarry(t[5], carry, a2, a3, t[5]);
+    t[6] = carry;
+
+    // double the cross products and add the squares
+    t[7] = t[6] >> 63;
+    t[6] = (t[6] << 1) | (t[5] >> 63);
+    t[5] = (t[5] << 1) | (t[4] >> 63);
+    t[4] = (t[4] << 1) | (t[3] >> 63);
+    t[3] = (t[3] << 1) | (t[2] >> 63);
+    t[2] = (t[2] << 1) | (t[1] >> 63);
+    t[1] = t[1] << 1;
+    uint64_t a_copy[FIELD_LIMB_NUM] = {a0, a1, a2, a3};
+    unsigned char c = 0;
+    for (auto i = 0; i < FIELD_LIMB_NUM; i++){
+        uint128_t x = (uint128_t)a_copy[i] * a_copy[i];
+        c = _addcarry_u64(c, (i == 0) ? 0 : t[2*i], (uint64_t)x, (unsigned long long*)&t[2*i]);
+        c = _addcarry_u64(c, t[2*i+1], (uint64_t)(x >> 64), (unsigned long long*)&t[2*i+1]);
+    }
+
+    // Montgomery reduction, one limb at a time
+    uint64_t top = 0;
+    for (auto i = 0; i < FIELD_LIMB_NUM; i++){
+        uint64_t u = t[i] * m_inverse;
+        carry = 0;
+        MulAddCarry(t[i], carry, u, m_copy[0], t[i]);
+        MulAddCarry(t[i+1], carry, u, m_copy[1], t[i+1]);
+        MulAddCarry(t[i+2], carry, u, m_copy[2], t[i+2]);
+        MulAddCarry(t[i+3], carry, u, m_copy[3], t[i+3]);
+        for (auto j = i + FIELD_LIMB_NUM; j < 2*FIELD_LIMB_NUM; j++){
+            c = _addcarry_u64(0, t[j], carry, (unsigned long long*)&t[j]);
+            carry = c;
+        }
+        top += carry;
+    }
+    Reduce(r, top, t + FIELD_LIMB_NUM);
+}
+
+bool MontField::Initialize(const BIGNUM *m)
+{
+    if (BN_num_bits(m) > 64*FIELD_LIMB_NUM || BN_is_odd(m) == 0) return false;
+
+    BN_bn2lebinpad(m, reinterpret_cast<unsigned char*>(this->modulus), 8*FIELD_LIMB_NUM);
+
+    // Newton iteration for m^{-1} mod 2^64: each step doubles the number of correct bits
+    uint64_t inv = 1;
+    for (auto i = 0; i < 6; i++) inv *= 2 - this->modulus[0] * inv;
+    this->n0 = 0 - inv;
+
+    BN_CTX *ctx = BN_CTX_new();
+    BIGNUM *bn_r = BN_new();
+    BN_set_bit(bn_r, 64*FIELD_LIMB_NUM);
+    BN_mod(bn_r, bn_r, m, ctx);
+    BN_bn2lebinpad(bn_r, reinterpret_cast<unsigned char*>(this->one.limb), 8*FIELD_LIMB_NUM);
+    BN_mod_sqr(bn_r, bn_r, m, ctx);
+    BN_bn2lebinpad(bn_r, reinterpret_cast<unsigned char*>(this->R2.limb), 8*FIELD_LIMB_NUM);
+    BN_free(bn_r);
+    BN_CTX_free(ctx);
+
+    memset(this->zero.limb, 0, sizeof(this->zero.limb));
+    return true;
+}
+
+// fixed 4-bit windows: 4 squarings and at most one multiplication per window
+void MontField::Exp(FieldElement &r, const FieldElement &a, const uint64_t *e, size_t LIMB_NUM) const
+{
+    FieldElement table[16];
+    table[0] = this->one;
+    table[1] = a;
+    for (auto i = 2; i < 16; i++) Mul(table[i], table[i-1], a);
+
+    FieldElement result = this->one;
+    bool leading = true;
+    for (auto i = LIMB_NUM; i > 0; i--){
+        for (auto j = 60; j >= 0; j -= 4){
+            size_t digit = (e[i-1] >> j) & 0xF;
+            if (leading){
+                if (digit == 0) continue;
+                result = table[digit];
+                leading = false;
+                continue;
+            }
+            Sqr(result, result);
+            Sqr(result, result);
+            Sqr(result, result);
+            Sqr(result, result);
+            if (digit != 0) Mul(result, result, table[digit]);
+        }
+    }
+    r = result;
+}
+
+void MontField::Inv(FieldElement &r, const FieldElement &a) const
+{
+    // e = m - 2
+    uint64_t e[FIELD_LIMB_NUM];
+    uint128_t borrow = 2;
+    for (auto i = 0; i < FIELD_LIMB_NUM; i++){
+        uint128_t d = (uint128_t)this->modulus[i] - borrow;
+        e[i] = (uint64_t)d;
+        borrow = (d >> 64) & 1;
+    }
+    Exp(r, a, e, FIELD_LIMB_NUM);
+}
+
+void MontField::BatchInv(FieldElement *r, const FieldElement *a, size_t LEN) const
+{
+    if (LEN == 0) return;
+    // prefix[i] = a[0]*...*a[i], skipping zeros
+    std::vector<FieldElement> prefix(LEN);
+    FieldElement acc = this->one;
+    for (auto i = 0; i < LEN; i++){
+        if (!IsZero(a[i])) Mul(acc, acc, a[i]);
+        prefix[i] = acc;
+    }
+    FieldElement acc_inverse;
+    Inv(acc_inverse, acc);
+    for (auto i = LEN; i > 0; i--){
+        if (IsZero(a[i-1])){
+            r[i-1] = this->zero;
+            continue;
+        }
+        FieldElement a_copy = a[i-1]; // r may alias a
+        if (i > 1) Mul(r[i-1], acc_inverse, prefix[i-2]);
+        else r[i-1] = acc_inverse;
+        Mul(acc_inverse, acc_inverse, a_copy);
+    }
+}
+
+void MontField::FromBigNum(FieldElement &r, const BIGNUM *a) const
+{
+    FieldElement t;
+    BN_bn2lebinpad(a, reinterpret_cast<unsigned char*>(t.limb), 8*FIELD_LIMB_NUM);
+    Mul(r, t, this->R2);
+}
+
+void MontField::ToBigNum(BIGNUM *r, const FieldElement &a) const
+{
+    FieldElement t;
+    FieldElement raw_one = this->zero;
+    raw_one.limb[0] = 1;
+    Mul(t, a, raw_one);
+    BN_lebin2bn(reinterpret_cast<const unsigned char*>(t.limb), 8*FIELD_LIMB_NUM, r);
+}
+
+void MontField::FromBytes(FieldElement &r, const unsigned char *buffer) const
+{
+    FieldElement t;
+    for (auto i = 0; i < FIELD_LIMB_NUM; i++){
+        uint64_t word = 0;
+        for (auto j = 0; j < 8; j++) word = (word << 8) | buffer[8*(FIELD_LIMB_NUM-1-i) + j];
+        t.limb[i] = word;
+    }
+    Mul(r, t, this->R2);
+}
+
+void MontField::ToBytes(unsigned char *buffer, const FieldElement &a) const
+{
+    FieldElement t;
+    FieldElement raw_one = this->zero;
+    raw_one.limb[0] = 1;
+    Mul(t, a, raw_one);
+    for (auto i = 0; i < FIELD_LIMB_NUM; i++){
+        uint64_t word = t.limb[i];
+        for (auto j = 7; j >= 0; j--){
+            buffer[8*(FIELD_LIMB_NUM-1-i) + j] = (unsigned char)(word & 0xFF);
+            word >>= 8;
+        }
+    }
+}
+
+
+// the point at infinity is encoded as Z = 0
+struct JacobianPoint{
+    FieldElement X, Y, Z;
+};
+
+struct AffinePoint{
+    FieldElement x, y;
+    bool infinity;
+};
+
+namespace ECJacobian{
+
+inline MontField field;      // base field of the current EC group
+inline FieldElement curve_a; // curve coefficient a in Montgomery form
+inline FieldElement curve_b; // curve coefficient b in Montgomery form
+inline bool ENABLE = false;  // false if the curve does not fit the native arithmetic
+
+void Initialize()
+{
+    ENABLE = field.Initialize(curve_params_p);
+    if (ENABLE){
+        field.FromBigNum(curve_a, curve_params_a);
+        field.FromBigNum(curve_b, curve_params_b);
+    }
+}
+
+inline bool IsAtInfinity(const JacobianPoint &P)
+{
+    return field.IsZero(P.Z);
+}
+
+inline void SetInfinity(JacobianPoint &P)
+{
+    P.X = field.one;
+    P.Y = field.one;
+    P.Z = field.zero;
+}
+
+// dbl-2007-bl for generic a
+inline void Double(JacobianPoint &R, const JacobianPoint &P)
+{
+    if (field.IsZero(P.Z) || field.IsZero(P.Y)){
+        SetInfinity(R);
+        return;
+    }
+    FieldElement XX, YY, YYYY, ZZ, S, M, T, U;
+    field.Sqr(XX, P.X);
+    field.Sqr(YY, P.Y);
+    field.Sqr(YYYY, YY);
+    field.Sqr(ZZ, P.Z);
+
+    // S = 2*((X+YY)^2 - XX - YYYY)
+    field.Add(S, P.X, YY);
+    field.Sqr(S, S);
+    field.Sub(S, S, XX);
+    field.Sub(S, S, YYYY);
+    field.Add(S, S, S);
+
+    // M = 3*XX + a*ZZ^2
+    field.Add(M, XX, XX);
+    field.Add(M, M, XX);
+    field.Sqr(U, ZZ);
+    field.Mul(U, U, curve_a);
+    field.Add(M, M, U);
+
+    // Z3 = (Y+Z)^2 - YY - ZZ, computed first since R may alias P
+    field.Add(U, P.Y, P.Z);
+    field.Sqr(U, U);
+    field.Sub(U, U, YY);
+    field.Sub(R.Z, U, ZZ);
+
+    // X3 = M^2 - 2*S
+    field.Sqr(T, M);
+    field.Sub(T, T, S);
+    field.Sub(T, T, S);
+
+    // Y3 = M*(S - X3) - 8*YYYY
+    field.Sub(S, S, T);
+    field.Mul(S, M, S);
+    field.Add(YYYY, YYYY, YYYY);
+    field.Add(YYYY, YYYY, YYYY);
+    field.Add(YYYY, YYYY, YYYY);
+    field.Sub(R.Y, S, YYYY);
+    R.X = T;
+}
+
+// madd-2007-bl: R = P + Q with Q affine
+inline void MixedAdd(JacobianPoint &R, const JacobianPoint &P, const AffinePoint &Q)
+{
+    if (Q.infinity){
+        R = P;
+        return;
+    }
+    if (field.IsZero(P.Z)){
+        R.X = Q.x; R.Y = Q.y; R.Z = field.one;
+        return;
+    }
+    FieldElement Z1Z1, U2, S2, H, HH, I, J, r, V;
+    field.Sqr(Z1Z1, P.Z);
+    field.Mul(U2, Q.x, Z1Z1);
+    field.Mul(S2, Q.y, P.Z);
+    field.Mul(S2, S2, Z1Z1);
+    field.Sub(H, U2, P.X);
+    field.Sub(r, S2, P.Y);
+
+    if (field.IsZero(H)){
+        if (field.IsZero(r)){
+            JacobianPoint T = {Q.x, Q.y, field.one};
+            Double(R, T);
+        }
+        else SetInfinity(R);
+        return;
+    }
+
+    field.Sqr(HH, H);
+    field.Add(I, HH, HH);
+    field.Add(I, I, I);
+    field.Mul(J, H, I);
+    field.Add(r, r, r);
+    field.Mul(V, P.X, I);
+
+    // Z3 = (Z1+H)^2 - Z1Z1 - HH
+    FieldElement Z3;
+    field.Add(Z3, P.Z, H);
+    field.Sqr(Z3, Z3);
+    field.Sub(Z3, Z3, Z1Z1);
+    field.Sub(Z3, Z3, HH);
+
+    // X3 = r^2 - J - 2*V
+    FieldElement X3;
+    field.Sqr(X3, r);
+    field.Sub(X3, X3, J);
+    field.Sub(X3, X3, V);
+    field.Sub(X3, X3, V);
+
+    // Y3 = r*(V - X3) - 2*Y1*J
+    FieldElement Y3;
+    field.Sub(V, V, X3);
+    field.Mul(Y3, r, V);
+    field.Mul(J, P.Y, J);
+    field.Add(J, J, J);
+    field.Sub(Y3, Y3, J);
+
+    R.X = X3; R.Y = Y3; R.Z = Z3;
+}
+
+// add-2007-bl: R = P + Q
+inline void Add(JacobianPoint &R, const JacobianPoint &P, const JacobianPoint &Q)
+{
+    if (field.IsZero(P.Z)){
+        R = Q;
+        return;
+    }
+    if (field.IsZero(Q.Z)){
+        R = P;
+        return;
+    }
+    FieldElement Z1Z1, Z2Z2, U1, U2, S1, S2, H, I, J, r, V;
+    field.Sqr(Z1Z1, P.Z);
+    field.Sqr(Z2Z2, Q.Z);
+    field.Mul(U1, P.X, Z2Z2);
+    field.Mul(U2, Q.X, Z1Z1);
+    field.Mul(S1, P.Y, Q.Z);
+    field.Mul(S1, S1, Z2Z2);
+    field.Mul(S2, Q.Y, P.Z);
+    field.Mul(S2, S2, Z1Z1);
+    field.Sub(H, U2, U1);
+    field.Sub(r, S2, S1);
+
+    if (field.IsZero(H)){
+        if (field.IsZero(r)) Double(R, P);
+        else SetInfinity(R);
+        return;
+    }
+
+    field.Add(I, H, H);
+    field.Sqr(I, I);
+    field.Mul(J, H, I);
+    field.Add(r, r, r);
+    field.Mul(V, U1, I);
+
+    // Z3 = ((Z1+Z2)^2 - Z1Z1 - Z2Z2)*H
+    FieldElement Z3;
+    field.Add(Z3, P.Z, Q.Z);
+    field.Sqr(Z3, Z3);
+    field.Sub(Z3, Z3, Z1Z1);
+    field.Sub(Z3, Z3, Z2Z2);
+    field.Mul(Z3, Z3, H);
+
+    // X3 = r^2 - J - 2*V
+    FieldElement X3;
+    field.Sqr(X3, r);
+    field.Sub(X3, X3, J);
+    field.Sub(X3, X3, V);
+    field.Sub(X3, X3, V);
+
+    // Y3 = r*(V - X3) - 2*S1*J
+    FieldElement Y3;
+    field.Sub(V, V, X3);
+    field.Mul(Y3, r, V);
+    field.Mul(J, S1, J);
+    field.Add(J, J, J);
+    field.Sub(Y3, Y3, J);
+
+    R.X = X3; R.Y = Y3; R.Z = Z3;
+}
+
+// y^2 = x^3 + a*x + b
+inline bool IsOnCurve(const AffinePoint &Q)
+{
+    if (Q.infinity) return true;
+    FieldElement lhs, rhs;
+    field.Sqr(lhs, Q.y);
+    field.Sqr(rhs, Q.x);
+    field.Add(rhs, rhs, curve_a);
+    field.Mul(rhs, rhs, Q.x);
+    field.Add(rhs, rhs, curve_b);
+    return field.IsEqual(lhs, rhs);
+}
+
+inline bool IsEqual(const AffinePoint &P, const AffinePoint &Q)
+{
+    if (P.infinity || Q.infinity) return P.infinity == Q.infinity;
+    return field.IsEqual(P.x, Q.x) && field.IsEqual(P.y, Q.y);
+}
+
+// convert a batch of Jacobian points to affine form with a single field inversion
+void BatchNormalize(AffinePoint *Q, const JacobianPoint *P, size_t LEN)
+{
+    std::vector<FieldElement> vec_z_inverse(LEN);
+    for (auto i = 0; i < LEN; i++) vec_z_inverse[i] = P[i].Z;
+    field.BatchInv(vec_z_inverse.data(), vec_z_inverse.data(), LEN);
+
+    FieldElement zz, zzz;
+    for (auto i = 0; i < LEN; i++){
+        if (field.IsZero(P[i].Z)){
+            Q[i].infinity = true;
+            continue;
+        }
+        Q[i].infinity = false;
+        field.Sqr(zz, vec_z_inverse[i]);
+        field.Mul(zzz, zz, vec_z_inverse[i]);
+        field.Mul(Q[i].x, P[i].X, zz);
+        field.Mul(Q[i].y, P[i].Y, zzz);
+    }
+}
+
+// load an EC_POINT without any field inversion
+void FromECPoint(JacobianPoint &R, const EC_POINT *A, BIGNUM *X, BIGNUM *Y, BIGNUM *Z, BN_CTX *ctx)
+{
+    if (EC_POINT_is_at_infinity(group, A)){
+        SetInfinity(R);
+        return;
+    }
+    CRYPTO_CHECK(1 == EC_POINT_get_Jprojective_coordinates_GFp(group, A, X, Y, Z, ctx));
+    field.FromBigNum(R.X, X);
+    field.FromBigNum(R.Y, Y);
+    field.FromBigNum(R.Z, Z);
+}
+
+void ToECPoint(EC_POINT *A, const JacobianPoint &R, BN_CTX *ctx)
+{
+    if (IsAtInfinity(R)){
+        EC_POINT_set_to_infinity(group, A);
+        return;
+    }
+    BIGNUM *X = BN_new();
+    BIGNUM *Y = BN_new();
+    BIGNUM *Z = BN_new();
+    field.ToBigNum(X, R.X);
+    field.ToBigNum(Y, R.Y);
+    field.ToBigNum(Z, R.Z);
+    CRYPTO_CHECK(1 == EC_POINT_set_Jprojective_coordinates_GFp(group, A, X, Y, Z, ctx));
+    BN_free(X);
+    BN_free(Y);
+    BN_free(Z);
+}
+
+}
+
+#endif
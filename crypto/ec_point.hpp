@@ -8,6 +8,7 @@
 #define KUNLUN_EC_POINT_HPP_
 
 #include "ec_group.hpp"
+#include "ec_jacobian.hpp"
 #include "aes.hpp"
 #include "../utility/murmurhash2.hpp"
 #include "../utility/routines.hpp"
@@ -23,11 +24,14 @@ public:
     
     ECPoint(); 
     ECPoint(const ECPoint& other);
+    ECPoint(ECPoint&& other) noexcept;
     ECPoint(const EC_POINT* &other);
     
     // Creates an ECPoint object with given x, y affine coordinates.
     ECPoint(const BigInt& x, const BigInt& y);
 
+    ~ECPoint();
+
     /* 
     ** Re-initialization function
     ** this function is somewhat dirty, only used as a ad-hoc bypass to initialize 
@@ -54,6 +58,20 @@ public:
     // Returns an ECPoint whose value is (this - other).
     ECPoint Sub(const ECPoint& other) const; 
 
+    // in-place group operations: overwrite this, no temporary EC_POINT is allocated
+
+    // Sets this = this * scalar.
+    ECPoint& MulInPlace(const BigInt& scalar);
+
+    // Sets this = this + other.
+    ECPoint& AddInPlace(const ECPoint& other);
+
+    // Sets this = this - other.
+    ECPoint& SubInPlace(const ECPoint& other);
+
+    // Sets this = - this.
+    ECPoint& InvertInPlace();
+
 
     // attribute check operations
 
@@ -67,7 +85,15 @@ public:
     bool CompareTo(const ECPoint& point) const;
 
 
-    inline ECPoint& operator=(const ECPoint& other) { EC_POINT_copy(this->point_ptr, other.point_ptr); return *this; }
+    // a moved-from ECPoint holds no EC_POINT: re-allocate it lazily when it is assigned again
+    inline ECPoint& operator=(const ECPoint& other) { 
+        if (this->point_ptr == nullptr) this->point_ptr = EC_POINT_new(group); 
+        EC_POINT_copy(this->point_ptr, other.point_ptr); 
+        return *this; 
+    }
+
+    // steal the EC_POINT of other: the old one of this is handed to other and freed by its destructor
+    inline ECPoint& operator=(ECPoint&& other) noexcept { std::swap(this->point_ptr, other.point_ptr); return *this; }
 
     inline bool operator==(const ECPoint& other) const{ return this->CompareTo(other); }
 
@@ -81,11 +107,11 @@ public:
 
     inline ECPoint operator-(const ECPoint& other) const { return this->Sub(other); }
 
-    inline ECPoint& operator+=(const ECPoint& other) { return *this = *this + other; }
+    inline ECPoint& operator+=(const ECPoint& other) { return this->AddInPlace(other); }
 
-    inline ECPoint& operator*=(const BigInt& scalar) { return *this = *this * scalar; }
+    inline ECPoint& operator*=(const BigInt& scalar) { return this->MulInPlace(scalar); }
 
-    inline ECPoint& operator-=(const ECPoint& other) { return *this = *this - other; }
+    inline ECPoint& operator-=(const ECPoint& other) { return this->SubInPlace(other); }
 
     void Print() const;
 
@@ -112,6 +138,12 @@ ECPoint::ECPoint(const ECPoint& other){
     EC_POINT_copy(this->point_ptr, other.point_ptr);
 }
 
+// Takes over the EC_POINT of other, leaving other empty.
+ECPoint::ECPoint(ECPoint&& other) noexcept{
+    this->point_ptr = other.point_ptr;
+    other.point_ptr = nullptr; 
+}
+
 ECPoint::ECPoint(const EC_POINT* &other){
     this->point_ptr = EC_POINT_new(group);
     EC_POINT_copy(this->point_ptr, other);
@@ -119,8 +151,12 @@ ECPoint::ECPoint(const EC_POINT* &other){
 
 ECPoint::ECPoint(const BigInt& x, const BigInt& y){
     this->point_ptr = EC_POINT_new(group);
-    int thread_num = omp_get_thread_num();
-    EC_POINT_set_affine_coordinates_GFp(group, this->point_ptr, x.bn_ptr, y.bn_ptr, bn_ctx[thread_num]);
+    EC_POINT_set_affine_coordinates_GFp(group, this->point_ptr, x.bn_ptr, y.bn_ptr, GetBNCtx());
+}
+
+// a moved-from ECPoint holds nullptr, which EC_POINT_free ignores
+ECPoint::~ECPoint(){
+    EC_POINT_free(this->point_ptr); 
 }
 
 void ECPoint::ReInitialize(){
@@ -129,26 +165,35 @@ void ECPoint::ReInitialize(){
     }
 }
 
+// variable-base: use GeneratorMul for the generator, or a FixedBaseTable for other long-lived points
 ECPoint ECPoint::Mul(const BigInt& scalar) const {
     ECPoint result; 
-    int thread_num = omp_get_thread_num();
-    // use fix-point exp with precomputation
-    if (EC_POINT_cmp(group, this->point_ptr, generator, bn_ctx[thread_num]) == 0){
-        CRYPTO_CHECK(1 == EC_POINT_mul(group, result.point_ptr, scalar.bn_ptr, nullptr, nullptr, bn_ctx[thread_num]));
-    }
-    else{
-        CRYPTO_CHECK(1 == EC_POINT_mul(group, result.point_ptr, nullptr, this->point_ptr, scalar.bn_ptr, bn_ctx[thread_num]));
-    }
- 
+    CRYPTO_CHECK(1 == EC_POINT_mul(group, result.point_ptr, nullptr, this->point_ptr, scalar.bn_ptr, GetBNCtx()));
     return result;
 }
 
+// Returns generator * scalar, using the precomputation made in ECGroup_Initialize.
+ECPoint GeneratorMul(const BigInt& scalar) {
+    ECPoint result; 
+    CRYPTO_CHECK(1 == EC_POINT_mul(group, result.point_ptr, scalar.bn_ptr, nullptr, nullptr, GetBNCtx()));
+    return result;
+}
+
+/*
+** Returns g * scalar for the g held in a scheme's pp. Whether g is the generator is checked once, 
+** in Setup or on load, and passed as g_is_generator, so that g^r takes the generator precomputation 
+** without comparing the points on every multiplication.
+*/
+inline ECPoint GPower(const ECPoint &g, bool g_is_generator, const BigInt& scalar) {
+    if (g_is_generator) return GeneratorMul(scalar); 
+    return g * scalar; 
+}
+
 
 ECPoint ECPoint::Add(const ECPoint& other) const {  
 
     ECPoint result; 
-    int thread_num = omp_get_thread_num();
-    CRYPTO_CHECK(1 == EC_POINT_add(group, result.point_ptr, this->point_ptr, other.point_ptr, bn_ctx[thread_num])); 
+    CRYPTO_CHECK(1 == EC_POINT_add(group, result.point_ptr, this->point_ptr, other.point_ptr, GetBNCtx())); 
     return result; 
 }
 
@@ -156,20 +201,60 @@ ECPoint ECPoint::Add(const ECPoint& other) const {
 ECPoint ECPoint::Invert() const {
     // Create a copy of this.
     ECPoint result = (*this);  
-    int thread_num = omp_get_thread_num();
-    CRYPTO_CHECK(1 == EC_POINT_invert(group, result.point_ptr, bn_ctx[thread_num])); 
+    CRYPTO_CHECK(1 == EC_POINT_invert(group, result.point_ptr, GetBNCtx())); 
     return result; 
 }
 
 
 ECPoint ECPoint::Sub(const ECPoint& other) const { 
     ECPoint result = other.Invert(); 
-    int thread_num = omp_get_thread_num();
-    CRYPTO_CHECK(1 == EC_POINT_add(group, result.point_ptr, this->point_ptr, result.point_ptr, bn_ctx[thread_num]));
+    CRYPTO_CHECK(1 == EC_POINT_add(group, result.point_ptr, this->point_ptr, result.point_ptr, GetBNCtx()));
     return result; 
 }
 
 
+ECPoint& ECPoint::MulInPlace(const BigInt& scalar) {
+    CRYPTO_CHECK(1 == EC_POINT_mul(group, this->point_ptr, nullptr, this->point_ptr, scalar.bn_ptr, GetBNCtx()));
+    return *this;
+}
+
+ECPoint& ECPoint::AddInPlace(const ECPoint& other) {
+    CRYPTO_CHECK(1 == EC_POINT_add(group, this->point_ptr, this->point_ptr, other.point_ptr, GetBNCtx())); 
+    return *this;
+}
+
+ECPoint& ECPoint::SubInPlace(const ECPoint& other) {
+    if (this == &other) { 
+        this->SetInfinity(); 
+        return *this; 
+    }
+    // this - other = -(-this + other): avoids a temporary copy of other
+    CRYPTO_CHECK(1 == EC_POINT_invert(group, this->point_ptr, GetBNCtx())); 
+    CRYPTO_CHECK(1 == EC_POINT_add(group, this->point_ptr, this->point_ptr, other.point_ptr, GetBNCtx())); 
+    CRYPTO_CHECK(1 == EC_POINT_invert(group, this->point_ptr, GetBNCtx())); 
+    return *this;
+}
+
+ECPoint& ECPoint::InvertInPlace() {
+    CRYPTO_CHECK(1 == EC_POINT_invert(group, this->point_ptr, GetBNCtx())); 
+    return *this;
+}
+
+/* 
+** write-into variants: result must be an existing ECPoint, its EC_POINT is reused
+** result may alias A or B
+*/
+
+// result = A + B
+void AddInto(ECPoint &result, const ECPoint &A, const ECPoint &B) {
+    CRYPTO_CHECK(1 == EC_POINT_add(group, result.point_ptr, A.point_ptr, B.point_ptr, GetBNCtx())); 
+}
+
+// result = A * scalar
+void MulInto(ECPoint &result, const ECPoint &A, const BigInt &scalar) {
+    CRYPTO_CHECK(1 == EC_POINT_mul(group, result.point_ptr, nullptr, A.point_ptr, scalar.bn_ptr, GetBNCtx()));
+}
+
 void ECPoint::Clone(const ECPoint& other) const {
     CRYPTO_CHECK(1 == EC_POINT_copy(this->point_ptr, other.point_ptr)); 
 }
@@ -181,8 +266,7 @@ bool ECPoint::IsAtInfinity() const {
 
 // Returns true if the given point is in the group.
 bool ECPoint::IsOnCurve() const {
-    int thread_num = omp_get_thread_num();
-    return (1 == EC_POINT_is_on_curve(group, this->point_ptr, bn_ctx[thread_num]));
+    return (1 == EC_POINT_is_on_curve(group, this->point_ptr, GetBNCtx()));
 }
 
 // Checks if the given point is valid. Returns false if the point is not in the group or if it is the point is at infinity.
@@ -194,8 +278,7 @@ bool ECPoint::IsValid() const{
 }
 
 bool ECPoint::CompareTo(const ECPoint& other) const{
-    int thread_num = omp_get_thread_num();
-    return (0 == EC_POINT_cmp(group, this->point_ptr, other.point_ptr, bn_ctx[thread_num]));
+    return (0 == EC_POINT_cmp(group, this->point_ptr, other.point_ptr, GetBNCtx()));
 }
 
 
@@ -206,8 +289,7 @@ void ECPoint::SetInfinity()
 
 void ECPoint::Print() const
 { 
-    int thread_num = omp_get_thread_num();
-    char *ecp_str = EC_POINT_point2hex(group, this->point_ptr, POINT_CONVERSION_UNCOMPRESSED, bn_ctx[thread_num]);
+    char *ecp_str = EC_POINT_point2hex(group, this->point_ptr, POINT_CONVERSION_UNCOMPRESSED, GetBNCtx());
     std::cout << ecp_str << std::endl; 
     OPENSSL_free(ecp_str); 
 }
@@ -223,9 +305,8 @@ void ECPoint::Print(std::string note) const
 std::string ECPoint::ToByteString() const
 {
     std::string ecp_str(POINT_COMPRESSED_BYTE_LEN, '0'); 
-    int thread_num = omp_get_thread_num();
     EC_POINT_point2oct(group, this->point_ptr, POINT_CONVERSION_COMPRESSED, 
-                       reinterpret_cast<unsigned char *>(&ecp_str[0]), POINT_COMPRESSED_BYTE_LEN, bn_ctx[thread_num]);
+                       reinterpret_cast<unsigned char *>(&ecp_str[0]), POINT_COMPRESSED_BYTE_LEN, GetBNCtx());
     return ecp_str; 
 }
 
@@ -233,8 +314,7 @@ std::string ECPoint::ToByteString() const
 std::string ECPoint::ToHexString() const
 {
     std::stringstream ss; 
-    int thread_num = omp_get_thread_num();
-    ss << EC_POINT_point2hex(group, this->point_ptr, POINT_CONVERSION_COMPRESSED, bn_ctx[thread_num]);
+    ss << EC_POINT_point2hex(group, this->point_ptr, POINT_CONVERSION_COMPRESSED, GetBNCtx());
     return ss.str();  
 }
 
@@ -244,9 +324,8 @@ size_t ECPoint::ToUint64() const
     // standard method
     unsigned char buffer[POINT_COMPRESSED_BYTE_LEN];
     memset(buffer, 0, POINT_COMPRESSED_BYTE_LEN); 
-    int thread_num = omp_get_thread_num();
     EC_POINT_point2oct(group, this->point_ptr, POINT_CONVERSION_COMPRESSED, buffer, 
-                       POINT_COMPRESSED_BYTE_LEN, bn_ctx[thread_num]);
+                       POINT_COMPRESSED_BYTE_LEN, GetBNCtx());
     return MurmurHash64A(buffer, POINT_COMPRESSED_BYTE_LEN, fixed_salt64); 
 }
 
@@ -255,9 +334,8 @@ size_t ECPoint::FastToUint64() const
 {
     unsigned char buffer[POINT_COMPRESSED_BYTE_LEN];
     memset(buffer, 0, POINT_COMPRESSED_BYTE_LEN); 
-    int thread_num = omp_get_thread_num();
     EC_POINT_point2oct(group, this->point_ptr, POINT_CONVERSION_COMPRESSED, buffer, 
-                       POINT_COMPRESSED_BYTE_LEN, bn_ctx[thread_num]);
+                       POINT_COMPRESSED_BYTE_LEN, GetBNCtx());
 
     block data[2];
     data[0] = _mm_load_si128((block *)(buffer));
@@ -276,14 +354,13 @@ size_t ECPoint::FastToUint64() const
 
 std::ofstream &operator<<(std::ofstream &fout, const ECPoint &A)
 { 
-    int thread_num = omp_get_thread_num();
 	#ifdef ECPOINT_COMPRESSED
 		unsigned char buffer[POINT_COMPRESSED_BYTE_LEN];
-		EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_COMPRESSED, buffer, POINT_COMPRESSED_BYTE_LEN, bn_ctx[thread_num]);
+		EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_COMPRESSED, buffer, POINT_COMPRESSED_BYTE_LEN, GetBNCtx());
         fout.write(reinterpret_cast<char *>(buffer), POINT_COMPRESSED_BYTE_LEN); 
 	#else
 		unsigned char buffer[POINT_BYTE_LEN];
-		EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_UNCOMPRESSED, buffer, POINT_BYTE_LEN, bn_ctx[thread_num]);
+		EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_UNCOMPRESSED, buffer, POINT_BYTE_LEN, GetBNCtx());
         fout.write(reinterpret_cast<char *>(buffer), POINT_BYTE_LEN); 
 	#endif
 
@@ -292,15 +369,14 @@ std::ofstream &operator<<(std::ofstream &fout, const ECPoint &A)
  
 std::ifstream &operator>>(std::ifstream &fin, ECPoint &A)
 { 
-    int thread_num = omp_get_thread_num();
     #ifdef ECPOINT_COMPRESSED
         unsigned char buffer[POINT_COMPRESSED_BYTE_LEN];
         fin.read(reinterpret_cast<char *>(buffer), POINT_COMPRESSED_BYTE_LEN); 
-        EC_POINT_oct2point(group, A.point_ptr, buffer, POINT_COMPRESSED_BYTE_LEN, bn_ctx[thread_num]);
+        EC_POINT_oct2point(group, A.point_ptr, buffer, POINT_COMPRESSED_BYTE_LEN, GetBNCtx());
     #else
         unsigned char buffer[POINT_BYTE_LEN];
         fin.read(reinterpret_cast<char *>(buffer), POINT_BYTE_LEN); 
-        EC_POINT_oct2point(group, A.point_ptr, buffer, POINT_BYTE_LEN, bn_ctx[thread_num]); 
+        EC_POINT_oct2point(group, A.point_ptr, buffer, POINT_BYTE_LEN, GetBNCtx()); 
     #endif
     return fin;            
 }
@@ -342,7 +418,7 @@ ECPoint CreateECPoint(const BigInt& x, const BigInt& y)
 ECPoint GenRandomGenerator()
 {
     BigInt bn_order(order); 
-    ECPoint result = ECPoint(generator) * GenRandomBigIntBetween(bn_1, bn_order);
+    ECPoint result = GeneratorMul(GenRandomBigIntBetween(bn_1, bn_order));
     return result; 
 }
 
@@ -361,25 +437,241 @@ bool IsSquare(const BigInt& q) {
 
 // ecpoint vector operations
 
+/*
+** multi-scalar multiplication: sum_i A[i]*a[i]
+** short vectors go to OpenSSL's interleaved wNAF (EC_POINTs_mul), long ones to the bucket method of Pippenger. 
+** on one core the two cross over at about PIPPENGER_SINGLE_THREAD_THRESHOLD terms; Pippenger spreads its 
+** windows over the thread team while EC_POINTs_mul stays on one core, so the crossover drops with the 
+** number of threads (see benchmark_multi_scalar_mul in test/test_misc.cpp)
+*/
+inline const size_t PIPPENGER_SINGLE_THREAD_THRESHOLD = 4096;
+inline const size_t PIPPENGER_MIN_THRESHOLD = 512;
+
+// inside a parallel region the bucket method runs on a single thread
+inline size_t PippengerThreshold()
+{
+    size_t THREAD_NUM = omp_in_parallel() ? 1 : NUMBER_OF_THREADS; 
+    return std::max(PIPPENGER_MIN_THRESHOLD, PIPPENGER_SINGLE_THREAD_THRESHOLD / THREAD_NUM); 
+}
+
+// choose the window size c ~ ln(n) + 2, which balances bucket additions (n per window) and bucket aggregation (2^c per window)
+inline size_t PippengerWindowSize(size_t LEN)
+{
+    if (LEN < 32) return 3; 
+    size_t c = size_t(std::log(double(LEN))) + 2; 
+    return std::min<size_t>(c, 16); 
+}
+
+/*
+** window size for signed digits: each of the SCALAR_BIT_LEN/c + 1 windows costs LEN mixed additions 
+** plus 2*2^{c-1} full additions (about 1.4 mixed additions each) to aggregate the buckets
+*/
+inline size_t PippengerSignedWindowSize(size_t LEN, size_t SCALAR_BIT_LEN)
+{
+    size_t best_c = 2; 
+    double best_cost = 0; 
+    for (size_t c = 2; c <= 16; c++){
+        double cost = double(SCALAR_BIT_LEN / c + 1) * (double(LEN) + 2.8 * double(size_t(1) << (c-1))); 
+        if (c == 2 || cost < best_cost){
+            best_c = c; 
+            best_cost = cost; 
+        }
+    }
+    return best_c; 
+}
+
+// extract the j-th c-bit window of a little-endian limb array
+inline size_t PippengerGetWindow(const uint64_t *limbs, size_t LIMB_NUM, size_t j, size_t c)
+{
+    size_t bit_index = j * c; 
+    size_t limb_index = bit_index >> 6; 
+    size_t bit_offset = bit_index & 63; 
+    if (limb_index >= LIMB_NUM) return 0; 
+
+    uint64_t window = limbs[limb_index] >> bit_offset; 
+    if (bit_offset + c > 64 && limb_index + 1 < LIMB_NUM){
+        window |= limbs[limb_index+1] << (64 - bit_offset); 
+    }
+    return window & ((uint64_t(1) << c) - 1); 
+}
+
+/*
+** native path: the points are normalized to affine form once (one inversion per thread chunk), 
+** buckets are accumulated with mixed Jacobian-affine additions and aggregated in Jacobian coordinates. 
+** the digits are signed, so a window needs only 2^{c-1} buckets and a negative digit adds the negated point
+*/
+inline void PippengerWindowSum(JacobianPoint &window_sum, const AffinePoint *A, const AffinePoint *neg_A, 
+                               const int32_t *digits, size_t WINDOW_NUM, size_t LEN, size_t j, size_t c)
+{
+    size_t BUCKET_NUM = size_t(1) << (c-1); // digit 0 contributes nothing
+    std::vector<JacobianPoint> buckets(BUCKET_NUM); 
+    for (auto k = 0; k < BUCKET_NUM; k++) ECJacobian::SetInfinity(buckets[k]); 
+
+    for (auto i = 0; i < LEN; i++){
+        int32_t digit = digits[i*WINDOW_NUM + j]; 
+        if (digit > 0) ECJacobian::MixedAdd(buckets[digit-1], buckets[digit-1], A[i]); 
+        else if (digit < 0) ECJacobian::MixedAdd(buckets[-digit-1], buckets[-digit-1], neg_A[i]); 
+    }
+
+    // sum_k k*B_k = B_{m} + (B_{m} + B_{m-1}) + ... + (B_{m} + ... + B_1)
+    JacobianPoint running_sum; 
+    ECJacobian::SetInfinity(running_sum); 
+    ECJacobian::SetInfinity(window_sum); 
+    for (auto k = BUCKET_NUM; k > 0; k--){
+        ECJacobian::Add(running_sum, running_sum, buckets[k-1]); 
+        ECJacobian::Add(window_sum, window_sum, running_sum); 
+    }
+}
+
+// generic path for curves that do not fit the native arithmetic: same bucket method on EC_POINT
+inline void PippengerWindowSum(EC_POINT *window_sum, const ECPoint *A, const uint64_t *scalar_limbs, size_t LIMB_NUM, 
+                               size_t LEN, size_t j, size_t c, BN_CTX *ctx)
+{
+    size_t BUCKET_NUM = (size_t(1) << c) - 1; 
+    std::vector<EC_POINT*> buckets(BUCKET_NUM); 
+    for (auto k = 0; k < BUCKET_NUM; k++){
+        buckets[k] = EC_POINT_new(group); 
+        EC_POINT_set_to_infinity(group, buckets[k]); 
+    }
+
+    for (auto i = 0; i < LEN; i++){
+        size_t digit = PippengerGetWindow(scalar_limbs + i*LIMB_NUM, LIMB_NUM, j, c); 
+        if (digit != 0) CRYPTO_CHECK(1 == EC_POINT_add(group, buckets[digit-1], buckets[digit-1], A[i].point_ptr, ctx)); 
+    }
+
+    EC_POINT *running_sum = EC_POINT_new(group); 
+    EC_POINT_set_to_infinity(group, running_sum); 
+    EC_POINT_set_to_infinity(group, window_sum); 
+    for (auto k = BUCKET_NUM; k > 0; k--){
+        CRYPTO_CHECK(1 == EC_POINT_add(group, running_sum, running_sum, buckets[k-1], ctx)); 
+        CRYPTO_CHECK(1 == EC_POINT_add(group, window_sum, window_sum, running_sum, ctx)); 
+    }
+
+    EC_POINT_free(running_sum); 
+    for (auto k = 0; k < BUCKET_NUM; k++) EC_POINT_free(buckets[k]); 
+}
+
+// Pippenger bucket method, windows are processed in parallel
+ECPoint PippengerECPointVectorMul(const ECPoint *A, const BigInt *a, size_t LEN)
+{
+    size_t SCALAR_BIT_LEN = BN_num_bits(order); 
+    size_t LIMB_NUM = (SCALAR_BIT_LEN + 63) / 64; 
+
+    // if we are already inside a thread team, the regions below run on one thread 
+    size_t THREAD_NUM = omp_in_parallel() ? 1 : NUMBER_OF_THREADS; 
+
+    // reduce the scalars into [0, order) (callers pass negative or unreduced scalars) and unpack them into limbs
+    std::vector<uint64_t> scalar_limbs(LEN * LIMB_NUM); 
+    #pragma omp parallel for num_threads(THREAD_NUM)
+    for (auto i = 0; i < LEN; i++){
+        BN_CTX *ctx = GetBNCtx(); 
+        BigInt k; 
+        CRYPTO_CHECK(1 == BN_nnmod(k.bn_ptr, a[i].bn_ptr, order, ctx)); 
+        BN_bn2lebinpad(k.bn_ptr, reinterpret_cast<unsigned char*>(scalar_limbs.data() + i*LIMB_NUM), LIMB_NUM*8); 
+    }
+
+    ECPoint result; 
+    if (ECJacobian::ENABLE){
+        // recode every scalar into signed digits in [-(2^{c-1}-1), 2^{c-1}]; the extra window absorbs the last carry
+        size_t c = PippengerSignedWindowSize(LEN, SCALAR_BIT_LEN); 
+        size_t WINDOW_NUM = SCALAR_BIT_LEN / c + 1; 
+        size_t HALF = size_t(1) << (c-1); 
+        std::vector<int32_t> digits(LEN * WINDOW_NUM); 
+        #pragma omp parallel for num_threads(THREAD_NUM)
+        for (auto i = 0; i < LEN; i++){
+            size_t carry = 0; 
+            for (auto j = 0; j < WINDOW_NUM; j++){
+                size_t digit = PippengerGetWindow(scalar_limbs.data() + i*LIMB_NUM, LIMB_NUM, j, c) + carry; 
+                carry = (digit > HALF); 
+                digits[i*WINDOW_NUM + j] = (carry == 1) ? int32_t(digit) - int32_t(size_t(1) << c) : int32_t(digit); 
+            }
+        }
+
+        // load the points and normalize them chunk by chunk, keeping the negations at hand for negative digits
+        std::vector<JacobianPoint> vec_jacobian_A(LEN); 
+        std::vector<AffinePoint> vec_affine_A(LEN); 
+        std::vector<AffinePoint> vec_neg_affine_A(LEN); 
+        size_t CHUNK_LEN = (LEN + THREAD_NUM - 1) / THREAD_NUM; 
+        #pragma omp parallel for num_threads(THREAD_NUM)
+        for (auto t = 0; t < THREAD_NUM; t++){
+            BN_CTX *ctx = GetBNCtx(); 
+            size_t start = t * CHUNK_LEN; 
+            size_t end = std::min(LEN, start + CHUNK_LEN); 
+            if (start >= end) continue; 
+            BIGNUM *X = BN_new(); 
+            BIGNUM *Y = BN_new(); 
+            BIGNUM *Z = BN_new(); 
+            for (auto i = start; i < end; i++){
+                ECJacobian::FromECPoint(vec_jacobian_A[i], A[i].point_ptr, X, Y, Z, ctx); 
+            }
+            BN_free(X); 
+            BN_free(Y); 
+            BN_free(Z); 
+            ECJacobian::BatchNormalize(vec_affine_A.data()+start, vec_jacobian_A.data()+start, end-start); 
+            for (auto i = start; i < end; i++){
+                vec_neg_affine_A[i] = vec_affine_A[i]; 
+                ECJacobian::field.Neg(vec_neg_affine_A[i].y, vec_affine_A[i].y); 
+            }
+        }
+
+        std::vector<JacobianPoint> vec_window_sum(WINDOW_NUM); 
+        #pragma omp parallel for num_threads(THREAD_NUM) schedule(dynamic, 1)
+        for (auto j = 0; j < WINDOW_NUM; j++){
+            PippengerWindowSum(vec_window_sum[j], vec_affine_A.data(), vec_neg_affine_A.data(), 
+                               digits.data(), WINDOW_NUM, LEN, j, c); 
+        }
+
+        // result = sum_j 2^{jc} * window_sum[j], evaluated by Horner's rule from the top window
+        JacobianPoint sum = vec_window_sum[WINDOW_NUM-1]; 
+        for (auto j = WINDOW_NUM - 1; j > 0; j--){
+            for (auto t = 0; t < c; t++) ECJacobian::Double(sum, sum); 
+            ECJacobian::Add(sum, sum, vec_window_sum[j-1]); 
+        }
+        ECJacobian::ToECPoint(result.point_ptr, sum, GetBNCtx()); 
+    }
+    else{
+        size_t c = PippengerWindowSize(LEN); 
+        size_t WINDOW_NUM = (SCALAR_BIT_LEN + c - 1) / c; 
+        std::vector<ECPoint> vec_window_sum(WINDOW_NUM); 
+        #pragma omp parallel for num_threads(THREAD_NUM) schedule(dynamic, 1)
+        for (auto j = 0; j < WINDOW_NUM; j++){
+            BN_CTX *ctx = GetBNCtx(); 
+            PippengerWindowSum(vec_window_sum[j].point_ptr, A, scalar_limbs.data(), LIMB_NUM, LEN, j, c, ctx); 
+        }
+
+        result = vec_window_sum[WINDOW_NUM-1]; 
+        for (auto j = WINDOW_NUM - 1; j > 0; j--){
+            for (auto t = 0; t < c; t++){
+                CRYPTO_CHECK(1 == EC_POINT_dbl(group, result.point_ptr, result.point_ptr, GetBNCtx())); 
+            }
+            CRYPTO_CHECK(1 == EC_POINT_add(group, result.point_ptr, result.point_ptr, vec_window_sum[j-1].point_ptr, GetBNCtx())); 
+        }
+    }
+    return result; 
+}
+
+// mul exp operations
+ECPoint ECPointVectorMul(const ECPoint *A, const BigInt *a, size_t LEN){
+    if (LEN >= PippengerThreshold()) return PippengerECPointVectorMul(A, a, LEN); 
+
+    ECPoint result; 
+    CRYPTO_CHECK(1 == EC_POINTs_mul(group, result.point_ptr, nullptr, LEN, 
+                 (const EC_POINT**)A, (const BIGNUM**)a, GetBNCtx()));
+    return result; 
+}
+
 // mul exp operations
 ECPoint ECPointVectorMul(const std::vector<ECPoint> &vec_A, std::vector<BigInt> &vec_a){
     if (vec_A.size()!=vec_a.size()){
         std::cerr << "vector size does not match" << std::endl; 
         exit(EXIT_FAILURE);
     }
-    ECPoint result; 
-    size_t LEN = vec_A.size(); 
-    int thread_num = omp_get_thread_num();
-    CRYPTO_CHECK(1 == EC_POINTs_mul(group, result.point_ptr, nullptr, LEN, 
-                 (const EC_POINT**)vec_A.data(), (const BIGNUM**)vec_a.data(), bn_ctx[thread_num]));
-    return result; 
+    return ECPointVectorMul(vec_A.data(), vec_a.data(), vec_A.size()); 
 }
 
 // mul exp operations
 ECPoint ECPointVectorMul(const std::vector<ECPoint> &vec_A, std::vector<BigInt> &vec_a, size_t start_index, size_t end_index){
-    std::vector<ECPoint> subvec_A(vec_A.begin()+start_index, vec_A.begin()+end_index);
-    std::vector<BigInt>  subvec_a(vec_a.begin()+start_index, vec_a.begin()+end_index);
-    return ECPointVectorMul(subvec_A, subvec_a); 
+    return ECPointVectorMul(vec_A.data()+start_index, vec_a.data()+start_index, end_index-start_index); 
 }
 
 
@@ -395,7 +687,7 @@ std::vector<ECPoint> ECPointVectorAdd(std::vector<ECPoint> &vec_A, std::vector<E
 
     #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
     for (auto i = 0; i < vec_A.size(); i++) {
-        vec_result[i] = vec_A[i] + vec_B[i]; 
+        AddInto(vec_result[i], vec_A[i], vec_B[i]); 
     }
     return vec_result;
 }
@@ -409,7 +701,7 @@ inline std::vector<ECPoint> ECPointVectorScalar(std::vector<ECPoint> &vec_A, Big
 
     #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
     for (auto i = 0; i < LEN; i++) {
-        vec_result[i] = vec_A[i] * a;  
+        MulInto(vec_result[i], vec_A[i], a);  
     }
     return vec_result;  
 }
@@ -429,7 +721,7 @@ inline std::vector<ECPoint> ECPointVectorProduct(const std::vector<ECPoint> &vec
     
     #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
     for (auto i = 0; i < LEN; i++) {
-        vec_result[i] = vec_A[i] * vec_a[i];  
+        MulInto(vec_result[i], vec_A[i], vec_a[i]);  
     } 
     return vec_result;  
 }
@@ -461,13 +753,159 @@ void PrintECPointVector(const std::vector<ECPoint> &vec_A, std::string note)
     }
 }
 
-/* customized hash for ECPoint class */
+/*
+** batch serialization of ec points, following the ECPOINT_COMPRESSED setting 
+** EC_POINT_point2oct pays one field inversion per point to get affine coordinates; here each thread 
+** normalizes its chunk with a single inversion (Montgomery's trick) and encodes the coordinates directly
+** the point at infinity is encoded as all-zero bytes
+*/
+inline size_t ECPointSerializedByteLen()
+{
+    #ifdef ECPOINT_COMPRESSED
+        return POINT_COMPRESSED_BYTE_LEN; 
+    #else
+        return POINT_BYTE_LEN; 
+    #endif
+}
+
+// encode a normalized point in the octet format of SEC1 (same as EC_POINT_point2oct)
+inline void AffinePointToBytes(const AffinePoint &Q, unsigned char *buffer)
+{
+    size_t POINT_LEN = ECPointSerializedByteLen(); 
+    if (Q.infinity){
+        memset(buffer, 0, POINT_LEN); 
+        return; 
+    }
+    // field elements are 32 bytes, the coordinates take the last BN_BYTE_LEN of them
+    unsigned char x_bytes[32], y_bytes[32]; 
+    ECJacobian::field.ToBytes(x_bytes, Q.x); 
+    ECJacobian::field.ToBytes(y_bytes, Q.y); 
+    memcpy(buffer+1, x_bytes+32-BN_BYTE_LEN, BN_BYTE_LEN); 
+    #ifdef ECPOINT_COMPRESSED
+        buffer[0] = POINT_CONVERSION_COMPRESSED | (y_bytes[31] & 1); 
+    #else
+        buffer[0] = POINT_CONVERSION_UNCOMPRESSED; 
+        memcpy(buffer+1+BN_BYTE_LEN, y_bytes+32-BN_BYTE_LEN, BN_BYTE_LEN); 
+    #endif
+}
+
+void ECPointVectorToBytes(const ECPoint *A, size_t LEN, unsigned char *buffer)
+{
+    size_t POINT_LEN = ECPointSerializedByteLen(); 
+    point_conversion_form_t form = (POINT_LEN == POINT_BYTE_LEN) ? POINT_CONVERSION_UNCOMPRESSED : POINT_CONVERSION_COMPRESSED; 
+
+    size_t THREAD_NUM = omp_in_parallel() ? 1 : NUMBER_OF_THREADS; 
+    size_t CHUNK_LEN = (LEN + THREAD_NUM - 1) / THREAD_NUM; 
+    #pragma omp parallel for num_threads(THREAD_NUM)
+    for (auto t = 0; t < THREAD_NUM; t++){
+        size_t start = t * CHUNK_LEN; 
+        size_t end = std::min(LEN, start + CHUNK_LEN); 
+        if (start >= end) continue; 
+
+        if (!ECJacobian::ENABLE || BN_BYTE_LEN > 32){
+            for (auto i = start; i < end; i++){
+                memset(buffer + i*POINT_LEN, 0, POINT_LEN); 
+                EC_POINT_point2oct(group, A[i].point_ptr, form, buffer + i*POINT_LEN, POINT_LEN, GetBNCtx()); 
+            }
+            continue; 
+        }
+
+        std::vector<JacobianPoint> vec_jacobian_A(end - start); 
+        std::vector<AffinePoint> vec_affine_A(end - start); 
+        BIGNUM *X = BN_new(); 
+        BIGNUM *Y = BN_new(); 
+        BIGNUM *Z = BN_new(); 
+        for (auto i = start; i < end; i++){
+            ECJacobian::FromECPoint(vec_jacobian_A[i-start], A[i].point_ptr, X, Y, Z, GetBNCtx()); 
+        }
+        BN_free(X); 
+        BN_free(Y); 
+        BN_free(Z); 
+        ECJacobian::BatchNormalize(vec_affine_A.data(), vec_jacobian_A.data(), end - start); 
+        for (auto i = start; i < end; i++){
+            AffinePointToBytes(vec_affine_A[i-start], buffer + i*POINT_LEN); 
+        }
+    }
+}
+
+std::vector<unsigned char> ECPointVectorToBytes(const std::vector<ECPoint> &vec_A)
+{
+    std::vector<unsigned char> buffer(vec_A.size() * ECPointSerializedByteLen()); 
+    ECPointVectorToBytes(vec_A.data(), vec_A.size(), buffer.data()); 
+    return buffer; 
+}
+
+// compressed encodings (POINT_COMPRESSED_BYTE_LEN each) whatever ECPOINT_COMPRESSED says; the point at infinity is all-zero bytes
+void ECPointVectorToCompressedBytes(const ECPoint *A, size_t LEN, unsigned char *buffer)
+{
+    if (ECPointSerializedByteLen() == POINT_COMPRESSED_BYTE_LEN){
+        ECPointVectorToBytes(A, LEN, buffer); 
+        return; 
+    }
+
+    // uncompressed 04 || x || y  ==>  (02 | parity of y) || x
+    std::vector<unsigned char> uncompressed_buffer(LEN * POINT_BYTE_LEN); 
+    ECPointVectorToBytes(A, LEN, uncompressed_buffer.data()); 
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS) if(LEN >= 1024)
+    for (auto i = 0; i < LEN; i++){
+        const unsigned char *point = uncompressed_buffer.data() + i*POINT_BYTE_LEN; 
+        unsigned char *compressed_point = buffer + i*POINT_COMPRESSED_BYTE_LEN; 
+        if (point[0] == 0){
+            memset(compressed_point, 0, POINT_COMPRESSED_BYTE_LEN); 
+            continue; 
+        }
+        compressed_point[0] = POINT_CONVERSION_COMPRESSED | (point[POINT_BYTE_LEN-1] & 1); 
+        memcpy(compressed_point+1, point+1, POINT_COMPRESSED_BYTE_LEN-1); 
+    }
+}
+
+// decoding aborts on any encoding that is not a point on the curve; compressed points need a square root each
+void BytesToECPointVector(const unsigned char *buffer, size_t LEN, ECPoint *A)
+{
+    size_t POINT_LEN = ECPointSerializedByteLen(); 
+    bool valid = true; 
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS) reduction(&&:valid)
+    for (auto i = 0; i < LEN; i++){
+        const unsigned char *point = buffer + i*POINT_LEN; 
+        // infinity is written as an all-zero slot; a zero prefix followed by anything else is malformed
+        if (point[0] == 0){
+            bool all_zero = true; 
+            for (auto j = 1; j < POINT_LEN; j++) all_zero = all_zero && (point[j] == 0); 
+            if (all_zero) A[i].SetInfinity(); 
+            valid = all_zero && valid; 
+        }
+        else valid = (1 == EC_POINT_oct2point(group, A[i].point_ptr, point, POINT_LEN, GetBNCtx())) && valid; 
+    }
+    if (!valid){
+        std::cerr << "invalid EC point encoding" << std::endl; 
+        exit(EXIT_FAILURE); 
+    }
+}
+
+std::vector<ECPoint> BytesToECPointVector(const std::vector<unsigned char> &buffer)
+{
+    size_t LEN = buffer.size() / ECPointSerializedByteLen(); 
+    std::vector<ECPoint> vec_A(LEN); 
+    BytesToECPointVector(buffer.data(), LEN, vec_A.data()); 
+    return vec_A; 
+}
+
+/* 
+** customized hash for ECPoint class: the compressed encoding goes to a stack buffer and the 
+** 8 bytes of x after the prefix byte serve as hash value (x is pseudo-random for the points we store)
+*/
 
 class ECPointHash{
 public:
     size_t operator()(const ECPoint& A) const
     {
-        return std::hash<std::string>{}(A.ToByteString());
+        unsigned char buffer[POINT_COMPRESSED_BYTE_LEN];
+        memset(buffer, 0, POINT_COMPRESSED_BYTE_LEN); 
+        EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_COMPRESSED, buffer, 
+                           POINT_COMPRESSED_BYTE_LEN, GetBNCtx());
+        size_t hashvalue; 
+        memcpy(&hashvalue, buffer+1, sizeof(hashvalue)); 
+        return hashvalue; 
     }
 };
 
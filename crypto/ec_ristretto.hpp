@@ -0,0 +1,818 @@
+/****************************************************************************
+this hpp implements the ristretto255 prime-order group (RFC 9496) on top of
+native edwards25519 arithmetic: field elements mod 2^255-19 are 5x51-bit limbs,
+points are kept in extended twisted Edwards coordinates
+unlike EC25519Point (x-only x25519), RistrettoPoint is a full-fledged group:
+addition, negation, fixed-base/variable-base multiplication, canonical 32-byte
+encoding and hash-to-group, with no dependency on a patched OpenSSL
+scalar multiplications use constant-time table lookups
+*****************************************************************************
+* @copyright  MIT license (see LICENSE file)
+*****************************************************************************/
+#ifndef KUNLUN_EC_RISTRETTO_HPP_
+#define KUNLUN_EC_RISTRETTO_HPP_
+
+#include "ec_point.hpp"
+
+// element of GF(2^255-19): value = sum v[i]*2^{51i}, limbs are kept below 2^52 between operations
+struct FE25519{
+    uint64_t v[5];
+};
+
+// extended twisted Edwards coordinates: x = X/Z, y = Y/Z, xy = T/Z on -x^2+y^2 = 1+dx^2y^2
+struct EdwardsPoint{
+    FE25519 X, Y, Z, T;
+};
+
+// precomputed forms for additions: (Y+X, Y-X, 2Z, 2dT); Z2 is 2 for the affine (fixed-base) entries
+struct CachedPoint{
+    FE25519 YplusX, YminusX, Z2, T2d;
+};
+
+namespace Ristretto{
+
+inline const uint64_t MASK51 = (uint64_t(1) << 51) - 1;
+
+inline FE25519 fe_zero = {{0, 0, 0, 0, 0}};
+inline FE25519 fe_one = {{1, 0, 0, 0, 0}};
+
+// curve constants, set by Initialize()
+inline FE25519 fe_d, fe_2d, fe_sqrt_m1, fe_invsqrt_a_minus_d, fe_sqrt_ad_minus_one, fe_one_minus_d_sq, fe_d_minus_one_sq;
+
+/* field arithmetic */
+
+// propagate the carries of t (limbs < 2^63) into r
+inline void Carry(FE25519 &r, uint64_t t0, uint64_t t1, uint64_t t2, uint64_t t3, uint64_t t4)
+{
+    t1 += t0 >> 51; t0 &= MASK51;
+    t2 += t1 >> 51; t1 &= MASK51;
+    t3 += t2 >> 51; t2 &= MASK51;
+    t4 += t3 >> 51; t3 &= MASK51;
+    t0 += 19 * (t4 >> 51); t4 &= MASK51;
+    t1 += t0 >> 51; t0 &= MASK51;
+    r.v[0] = t0; r.v[1] = t1; r.v[2] = t2; r.v[3] = t3; r.v[4] = t4;
+}
+
+inline void Add(FE25519 &r, const FE25519 &a, const FE25519 &b)
+{
+    Carry(r, a.v[0]+b.v[0], a.v[1]+b.v[1], a.v[2]+b.v[2], a.v[3]+b.v[3], a.v[4]+b.v[4]);
+}
+
+// r = a + 4p - b, so that no limb underflows
+inline void Sub(FE25519 &r, const FE25519 &a, const FE25519 &b)
+{
+    const uint64_t P4_0 = 0x1FFFFFFFFFFFB4, P4_i = 0x1FFFFFFFFFFFFC;
+    Carry(r, a.v[0]+P4_0-b.v[0], a.v[1]+P4_i-b.v[1], a.v[2]+P4_i-b.v[2], a.v[3]+P4_i-b.v[3], a.v[4]+P4_i-b.v[4]);
+}
+
+inline void Neg(FE25519 &r, const FE25519 &a)
+{
+    Sub(r, fe_zero, a);
+}
+
+inline void Mul(FE25519 &r, const FE25519 &a, const FE25519 &b)
+{
+    uint64_t a0 = a.v[0], a1 = a.v[1], a2 = a.v[2], a3 = a.v[3], a4 = a.v[4];
+    uint64_t b0 = b.v[0], b1 = b.v[1], b2 = b.v[2], b3 = b.v[3], b4 = b.v[4];
+    // 2^255 = 19 mod p: fold the high products back with a factor 19
+    uint64_t b1_19 = 19*b1, b2_19 = 19*b2, b3_19 = 19*b3, b4_19 = 19*b4;
+
+    uint128_t t0 = (uint128_t)a0*b0 + (uint128_t)a1*b4_19 + (uint128_t)a2*b3_19 + (uint128_t)a3*b2_19 + (uint128_t)a4*b1_19;
+    uint128_t t1 = (uint128_t)a0*b1 + (uint128_t)a1*b0 + (uint128_t)a2*b4_19 + (uint128_t)a3*b3_19 + (uint128_t)a4*b2_19;
+    uint128_t t2 = (uint128_t)a0*b2 + (uint128_t)a1*b1 + (uint128_t)a2*b0 + (uint128_t)a3*b4_19 + (uint128_t)a4*b3_19;
+    uint128_t t3 = (uint128_t)a0*b3 + (uint128_t)a1*b2 + (uint128_t)a2*b1 + (uint128_t)a3*b0 + (uint128_t)a4*b4_19;
+    uint128_t t4 = (uint128_t)a0*b4 + (uint128_t)a1*b3 + (uint128_t)a2*b2 + (uint128_t)a3*b1 + (uint128_t)a4*b0;
+
+    t1 += (uint64_t)(t0 >> 51);
+    t2 += (uint64_t)(t1 >> 51);
+    t3 += (uint64_t)(t2 >> 51);
+    t4 += (uint64_t)(t3 >> 51);
+    uint128_t c = (uint128_t)((uint64_t)t0 & MASK51) + (uint128_t)19 * (uint64_t)(t4 >> 51);
+    uint64_t r0 = (uint64_t)c & MASK51;
+    uint64_t r1 = ((uint64_t)t1 & MASK51) + (uint64_t)(c >> 51);
+    r.v[0] = r0; r.v[1] = r1;
+    r.v[2] = (uint64_t)t2 & MASK51; r.v[3] = (uint64_t)t3 & MASK51; r.v[4] = (uint64_t)t4 & MASK51;
+}
+
+inline void Sqr(FE25519 &r, const FE25519 &a)
+{
+    uint64_t a0 = a.v[0], a1 = a.v[1], a2 = a.v[2], a3 = a.v[3], a4 = a.v[4];
+    uint64_t a0_2 = 2*a0, a1_2 = 2*a1, a1_38 = 38*a1, a2_38 = 38*a2, a3_38 = 38*a3, a3_19 = 19*a3, a4_19 = 19*a4;
+
+    uint128_t t0 = (uint128_t)a0*a0 + (uint128_t)a1_38*a4 + (uint128_t)a2_38*a3;
+    uint128_t t1 = (uint128_t)a0_2*a1 + (uint128_t)a2_38*a4 + (uint128_t)a3_19*a3;
+    uint128_t t2 = (uint128_t)a0_2*a2 + (uint128_t)a1*a1 + (uint128_t)a3_38*a4;
+    uint128_t t3 = (uint128_t)a0_2*a3 + (uint128_t)a1_2*a2 + (uint128_t)a4_19*a4;
+    uint128_t t4 = (uint128_t)a0_2*a4 + (uint128_t)a1_2*a3 + (uint128_t)a2*a2;
+
+    t1 += (uint64_t)(t0 >> 51);
+    t2 += (uint64_t)(t1 >> 51);
+    t3 += (uint64_t)(t2 >> 51);
+    t4 += (uint64_t)(t3 >> 51);
+    uint128_t c = (uint128_t)((uint64_t)t0 & MASK51) + (uint128_t)19 * (uint64_t)(t4 >> 51);
+    uint64_t r0 = (uint64_t)c & MASK51;
+    uint64_t r1 = ((uint64_t)t1 & MASK51) + (uint64_t)(c >> 51);
+    r.v[0] = r0; r.v[1] = r1;
+    r.v[2] = (uint64_t)t2 & MASK51; r.v[3] = (uint64_t)t3 & MASK51; r.v[4] = (uint64_t)t4 & MASK51;
+}
+
+// r = a^{2^k}
+inline void SqrTimes(FE25519 &r, const FE25519 &a, size_t k)
+{
+    r = a;
+    for (auto i = 0; i < k; i++) Sqr(r, r);
+}
+
+// the common prefix of the addition chains below: t = a^{2^250-1}, a11 = a^11
+void Pow2_250_1(FE25519 &t, FE25519 &a11, const FE25519 &a)
+{
+    FE25519 t0, t1, t2;
+    Sqr(t0, a);                                 // 2
+    SqrTimes(t1, t0, 2);                        // 8
+    Mul(t1, a, t1);                             // 9
+    Mul(a11, t0, t1);                           // 11
+    Sqr(t0, a11);                               // 22
+    Mul(t1, t1, t0);                            // 2^5-1
+    SqrTimes(t0, t1, 5);   Mul(t1, t0, t1);     // 2^10-1
+    SqrTimes(t0, t1, 10);  Mul(t2, t0, t1);     // 2^20-1
+    SqrTimes(t0, t2, 20);  Mul(t0, t0, t2);     // 2^40-1
+    SqrTimes(t0, t0, 10);  Mul(t1, t0, t1);     // 2^50-1
+    SqrTimes(t0, t1, 50);  Mul(t2, t0, t1);     // 2^100-1
+    SqrTimes(t0, t2, 100); Mul(t0, t0, t2);     // 2^200-1
+    SqrTimes(t0, t0, 50);  Mul(t, t0, t1);      // 2^250-1
+}
+
+// r = a^{p-2} = a^{-1}
+void Inv(FE25519 &r, const FE25519 &a)
+{
+    FE25519 t, a11;
+    Pow2_250_1(t, a11, a);
+    SqrTimes(t, t, 5);
+    Mul(r, t, a11);
+}
+
+// r = a^{(p-5)/8} = a^{2^252-3}
+void Pow22523(FE25519 &r, const FE25519 &a)
+{
+    FE25519 t, a11;
+    Pow2_250_1(t, a11, a);
+    SqrTimes(t, t, 2);
+    Mul(r, t, a);
+}
+
+// canonical little-endian encoding
+void ToBytes(unsigned char *buffer, const FE25519 &a)
+{
+    FE25519 h;
+    Carry(h, a.v[0], a.v[1], a.v[2], a.v[3], a.v[4]);
+    Carry(h, h.v[0], h.v[1], h.v[2], h.v[3], h.v[4]);
+    // now h < 2^255 + small: subtract p iff h + 19 >= 2^255
+    uint64_t q = (h.v[0] + 19) >> 51;
+    q = (h.v[1] + q) >> 51;
+    q = (h.v[2] + q) >> 51;
+    q = (h.v[3] + q) >> 51;
+    q = (h.v[4] + q) >> 51;
+    h.v[0] += 19 * q;
+    h.v[1] += h.v[0] >> 51; h.v[0] &= MASK51;
+    h.v[2] += h.v[1] >> 51; h.v[1] &= MASK51;
+    h.v[3] += h.v[2] >> 51; h.v[2] &= MASK51;
+    h.v[4] += h.v[3] >> 51; h.v[3] &= MASK51;
+    h.v[4] &= MASK51;
+
+    uint64_t w[4];
+    w[0] = h.v[0] | (h.v[1] << 51);
+    w[1] = (h.v[1] >> 13) | (h.v[2] << 38);
+    w[2] = (h.v[2] >> 26) | (h.v[3] << 25);
+    w[3] = (h.v[3] >> 39) | (h.v[4] << 12);
+    for (auto i = 0; i < 4; i++){
+        for (auto j = 0; j < 8; j++) buffer[8*i+j] = (unsigned char)(w[i] >> (8*j));
+    }
+}
+
+// the top bit is ignored, the result may be non-canonical (>= p)
+void FromBytes(FE25519 &r, const unsigned char *buffer)
+{
+    uint64_t w[4];
+    for (auto i = 0; i < 4; i++){
+        w[i] = 0;
+        for (auto j = 0; j < 8; j++) w[i] |= (uint64_t)buffer[8*i+j] << (8*j);
+    }
+    r.v[0] = w[0] & MASK51;
+    r.v[1] = ((w[0] >> 51) | (w[1] << 13)) & MASK51;
+    r.v[2] = ((w[1] >> 38) | (w[2] << 26)) & MASK51;
+    r.v[3] = ((w[2] >> 25) | (w[3] << 39)) & MASK51;
+    r.v[4] = (w[3] >> 12) & MASK51;
+}
+
+inline bool IsZero(const FE25519 &a)
+{
+    unsigned char buffer[32];
+    ToBytes(buffer, a);
+    unsigned char acc = 0;
+    for (auto i = 0; i < 32; i++) acc |= buffer[i];
+    return acc == 0;
+}
+
+inline bool IsEqual(const FE25519 &a, const FE25519 &b)
+{
+    FE25519 t;
+    Sub(t, a, b);
+    return IsZero(t);
+}
+
+// "negative" means the canonical encoding is odd
+inline bool IsNegative(const FE25519 &a)
+{
+    unsigned char buffer[32];
+    ToBytes(buffer, a);
+    return buffer[0] & 1;
+}
+
+// r = b if flag else r, without branching on flag
+inline void CMov(FE25519 &r, const FE25519 &b, bool flag)
+{
+    uint64_t mask = 0 - (uint64_t)flag;
+    for (auto i = 0; i < 5; i++) r.v[i] ^= mask & (r.v[i] ^ b.v[i]);
+}
+
+inline void CNeg(FE25519 &r, const FE25519 &a, bool flag)
+{
+    FE25519 minus_a;
+    Neg(minus_a, a);
+    r = a;
+    CMov(r, minus_a, flag);
+}
+
+inline void Abs(FE25519 &r, const FE25519 &a)
+{
+    CNeg(r, a, IsNegative(a));
+}
+
+/*
+** SQRT_RATIO_M1 of RFC 9496: r = sqrt(u/v) if u/v is square, otherwise sqrt(i*u/v)
+** r is always non-negative; returns whether u/v is square
+*/
+bool SqrtRatioM1(FE25519 &r, const FE25519 &u, const FE25519 &v)
+{
+    FE25519 v3, v7, t, check, minus_u, minus_u_i;
+    Sqr(v3, v); Mul(v3, v3, v);         // v^3
+    Sqr(v7, v3); Mul(v7, v7, v);        // v^7
+    Mul(t, u, v7);
+    Pow22523(t, t);
+    Mul(t, t, v3);
+    Mul(r, t, u);                       // (u v^3) (u v^7)^{(p-5)/8}
+
+    Sqr(check, r); Mul(check, check, v);
+    Neg(minus_u, u);
+    Mul(minus_u_i, minus_u, fe_sqrt_m1);
+    bool correct_sign = IsEqual(check, u);
+    bool flipped_sign = IsEqual(check, minus_u);
+    bool flipped_sign_i = IsEqual(check, minus_u_i);
+
+    FE25519 r_prime;
+    Mul(r_prime, r, fe_sqrt_m1);
+    CMov(r, r_prime, flipped_sign | flipped_sign_i);
+    Abs(r, r);
+    return correct_sign | flipped_sign;
+}
+
+void FromDecimal(FE25519 &r, const char *dec)
+{
+    BIGNUM *a = BN_new();
+    CRYPTO_CHECK(BN_dec2bn(&a, dec) != 0);
+    unsigned char buffer[32];
+    BN_bn2lebinpad(a, buffer, 32);
+    FromBytes(r, buffer);
+    BN_free(a);
+}
+
+/* Edwards point arithmetic */
+
+inline void SetIdentity(EdwardsPoint &P)
+{
+    P.X = fe_zero; P.Y = fe_one; P.Z = fe_one; P.T = fe_zero;
+}
+
+inline void SetIdentity(CachedPoint &P)
+{
+    P.YplusX = fe_one; P.YminusX = fe_one; Add(P.Z2, fe_one, fe_one); P.T2d = fe_zero;
+}
+
+inline void ToCached(CachedPoint &R, const EdwardsPoint &P)
+{
+    Add(R.YplusX, P.Y, P.X);
+    Sub(R.YminusX, P.Y, P.X);
+    Add(R.Z2, P.Z, P.Z);
+    Mul(R.T2d, P.T, fe_2d);
+}
+
+inline void Neg(EdwardsPoint &R, const EdwardsPoint &P)
+{
+    Neg(R.X, P.X); R.Y = P.Y; R.Z = P.Z; Neg(R.T, P.T);
+}
+
+// R = P + Q (add-2008-hwcd-3), R may alias P
+inline void Add(EdwardsPoint &R, const EdwardsPoint &P, const CachedPoint &Q)
+{
+    FE25519 A, B, C, D, E, F, G, H;
+    Sub(A, P.Y, P.X); Mul(A, A, Q.YminusX);
+    Add(B, P.Y, P.X); Mul(B, B, Q.YplusX);
+    Mul(C, P.T, Q.T2d);
+    Mul(D, P.Z, Q.Z2);
+    Sub(E, B, A); Sub(F, D, C); Add(G, D, C); Add(H, B, A);
+    Mul(R.X, E, F); Mul(R.Y, G, H); Mul(R.T, E, H); Mul(R.Z, F, G);
+}
+
+inline void Add(EdwardsPoint &R, const EdwardsPoint &P, const EdwardsPoint &Q)
+{
+    CachedPoint Q_cached;
+    ToCached(Q_cached, Q);
+    Add(R, P, Q_cached);
+}
+
+// R = 2P (dbl-2008-hwcd), R may alias P; T is not an input, so chained doublings can skip it but the last
+inline void Double(EdwardsPoint &R, const EdwardsPoint &P, bool WITH_T = true)
+{
+    FE25519 XX, YY, ZZ2, XY2, YY_plus_XX, YY_minus_XX, F;
+    Sqr(XX, P.X); Sqr(YY, P.Y);
+    Sqr(ZZ2, P.Z); Add(ZZ2, ZZ2, ZZ2);
+    Add(XY2, P.X, P.Y); Sqr(XY2, XY2);
+    Add(YY_plus_XX, YY, XX); Sub(YY_minus_XX, YY, XX);
+    Sub(XY2, XY2, YY_plus_XX);             // 2XY
+    Sub(F, ZZ2, YY_minus_XX);
+    Mul(R.X, XY2, F); Mul(R.Y, YY_plus_XX, YY_minus_XX); Mul(R.Z, YY_minus_XX, F);
+    if (WITH_T) Mul(R.T, XY2, YY_plus_XX);
+}
+
+inline void CMov(CachedPoint &R, const CachedPoint &Q, bool flag)
+{
+    CMov(R.YplusX, Q.YplusX, flag); CMov(R.YminusX, Q.YminusX, flag); CMov(R.Z2, Q.Z2, flag); CMov(R.T2d, Q.T2d, flag);
+}
+
+// R = digit * table[0] for digit in [-8, 8], where table[j-1] = j * base; constant time in digit
+inline void Select(CachedPoint &R, const CachedPoint *table, int8_t digit)
+{
+    uint8_t negative = (uint8_t)digit >> 7;
+    uint8_t abs_digit = (uint8_t)(digit - ((-(int8_t)negative & digit) << 1));
+    SetIdentity(R);
+    for (auto j = 1; j <= 8; j++) CMov(R, table[j-1], abs_digit == j);
+    // -(Y+X, Y-X, 2Z, 2dT) = (Y-X, Y+X, 2Z, -2dT)
+    CachedPoint minus_R;
+    minus_R.YplusX = R.YminusX; minus_R.YminusX = R.YplusX; minus_R.Z2 = R.Z2; Neg(minus_R.T2d, R.T2d);
+    CMov(R, minus_R, negative);
+}
+
+/* signed radix-16 recoding of a scalar < 2^253: 64 digits in [-8, 8] */
+void ScalarToDigits(int8_t *digits, const BigInt &scalar, BIGNUM *modulus)
+{
+    BigInt k;
+    CRYPTO_CHECK(1 == BN_nnmod(k.bn_ptr, scalar.bn_ptr, modulus, GetBNCtx()));
+    unsigned char buffer[32];
+    BN_bn2lebinpad(k.bn_ptr, buffer, 32);
+    for (auto i = 0; i < 32; i++){
+        digits[2*i] = buffer[i] & 15;
+        digits[2*i+1] = (buffer[i] >> 4) & 15;
+    }
+    int8_t carry = 0;
+    for (auto i = 0; i < 63; i++){
+        digits[i] += carry;
+        carry = (digits[i] + 8) >> 4;
+        digits[i] -= carry << 4;
+    }
+    digits[63] += carry;
+}
+
+/* ristretto255 encoding and decoding (RFC 9496 4.3) */
+
+void Encode(unsigned char *buffer, const EdwardsPoint &P)
+{
+    FE25519 u1, u2, t, invsqrt, den1, den2, z_inv, ix, iy, enchanted_denominator, x, y, den_inv, s;
+    Add(t, P.Z, P.Y); Sub(u1, P.Z, P.Y); Mul(u1, t, u1);
+    Mul(u2, P.X, P.Y);
+    Sqr(t, u2); Mul(t, t, u1);
+    SqrtRatioM1(invsqrt, fe_one, t);
+    Mul(den1, invsqrt, u1);
+    Mul(den2, invsqrt, u2);
+    Mul(z_inv, den1, den2); Mul(z_inv, z_inv, P.T);
+    Mul(ix, P.X, fe_sqrt_m1);
+    Mul(iy, P.Y, fe_sqrt_m1);
+    Mul(enchanted_denominator, den1, fe_invsqrt_a_minus_d);
+
+    Mul(t, P.T, z_inv);
+    bool rotate = IsNegative(t);
+    x = P.X; CMov(x, iy, rotate);
+    y = P.Y; CMov(y, ix, rotate);
+    den_inv = den2; CMov(den_inv, enchanted_denominator, rotate);
+
+    Mul(t, x, z_inv);
+    CNeg(y, y, IsNegative(t));
+    Sub(s, P.Z, y); Mul(s, den_inv, s);
+    Abs(s, s);
+    ToBytes(buffer, s);
+}
+
+// returns false if buffer is not a canonical encoding of a group element
+bool Decode(EdwardsPoint &P, const unsigned char *buffer)
+{
+    FE25519 s, ss, u1, u2, u2_sqr, v, t, invsqrt, den_x, den_y;
+    FromBytes(s, buffer);
+    unsigned char canonical[32];
+    ToBytes(canonical, s);
+    if (memcmp(canonical, buffer, 32) != 0 || IsNegative(s)) return false;
+
+    Sqr(ss, s);
+    Sub(u1, fe_one, ss);
+    Add(u2, fe_one, ss);
+    Sqr(u2_sqr, u2);
+    Sqr(t, u1); Mul(t, t, fe_d); Neg(t, t); Sub(v, t, u2_sqr);  // v = -(d u1^2) - u2^2
+    Mul(t, v, u2_sqr);
+    bool was_square = SqrtRatioM1(invsqrt, fe_one, t);
+    Mul(den_x, invsqrt, u2);
+    Mul(den_y, invsqrt, den_x); Mul(den_y, den_y, v);
+
+    Add(P.X, s, s); Mul(P.X, P.X, den_x); Abs(P.X, P.X);
+    Mul(P.Y, u1, den_y);
+    P.Z = fe_one;
+    Mul(P.T, P.X, P.Y);
+    return was_square && !IsNegative(P.T) && !IsZero(P.Y);
+}
+
+// the one-way map of RFC 9496 4.3.4 applied to 32 bytes
+void Elligator(EdwardsPoint &P, const unsigned char *buffer)
+{
+    FE25519 t, r, u, v, s, s_prime, c, N, w0, w1, w2, w3, tmp;
+    FromBytes(t, buffer);
+    Sqr(r, t); Mul(r, r, fe_sqrt_m1);
+    Add(u, r, fe_one); Mul(u, u, fe_one_minus_d_sq);
+    Mul(tmp, r, fe_d); Add(tmp, tmp, fe_one); Neg(tmp, tmp);   // -1 - r d
+    Add(v, r, fe_d); Mul(v, tmp, v);
+    bool was_square = SqrtRatioM1(s, u, v);
+    Mul(s_prime, s, t); Abs(s_prime, s_prime); Neg(s_prime, s_prime);
+    CMov(s, s_prime, !was_square);
+    Neg(c, fe_one); CMov(c, r, !was_square);
+    Sub(N, r, fe_one); Mul(N, c, N); Mul(N, N, fe_d_minus_one_sq); Sub(N, N, v);
+
+    Add(w0, s, s); Mul(w0, w0, v);
+    Mul(w1, N, fe_sqrt_ad_minus_one);
+    Sqr(tmp, s);
+    Sub(w2, fe_one, tmp);
+    Add(w3, fe_one, tmp);
+    Mul(P.X, w0, w3); Mul(P.Y, w2, w1); Mul(P.Z, w1, w3); Mul(P.T, w0, w2);
+}
+
+// P and Q represent the same ristretto255 element
+bool IsEqual(const EdwardsPoint &P, const EdwardsPoint &Q)
+{
+    FE25519 t1, t2, t3, t4;
+    Mul(t1, P.X, Q.Y); Mul(t2, P.Y, Q.X);
+    Mul(t3, P.Y, Q.Y); Mul(t4, P.X, Q.X);
+    return IsEqual(t1, t2) | IsEqual(t3, t4);
+}
+
+/* scalar multiplication */
+
+// R = scalar * P via signed 4-bit windows
+void Mul(EdwardsPoint &R, const EdwardsPoint &P, const BigInt &scalar, BIGNUM *modulus)
+{
+    int8_t digits[64];
+    ScalarToDigits(digits, scalar, modulus);
+
+    CachedPoint table[8];
+    EdwardsPoint multiple = P;
+    ToCached(table[0], P);
+    for (auto j = 1; j < 8; j++){
+        Add(multiple, multiple, table[0]);
+        ToCached(table[j], multiple);
+    }
+
+    CachedPoint selected;
+    EdwardsPoint Q;
+    SetIdentity(Q);
+    for (auto i = 63; i >= 0; i--){
+        Double(Q, Q, false); Double(Q, Q, false); Double(Q, Q, false); Double(Q, Q);
+        Select(selected, table, digits[i]);
+        Add(Q, Q, selected);
+    }
+    R = Q;
+}
+
+// basepoint table: base_table[8i + j-1] = j * 16^i * B in cached affine form (Z2 = 2)
+inline std::vector<CachedPoint> base_table;
+
+// R = scalar * B with one addition per window and no doubling
+void BaseMul(EdwardsPoint &R, const BigInt &scalar, BIGNUM *modulus)
+{
+    int8_t digits[64];
+    ScalarToDigits(digits, scalar, modulus);
+    CachedPoint selected;
+    EdwardsPoint Q;
+    SetIdentity(Q);
+    for (auto i = 0; i < 64; i++){
+        Select(selected, base_table.data() + 8*i, digits[i]);
+        Add(Q, Q, selected);
+    }
+    R = Q;
+}
+
+void BuildBaseTable(const EdwardsPoint &B)
+{
+    base_table.resize(64*8);
+    EdwardsPoint window_base = B;
+    for (auto i = 0; i < 64; i++){
+        EdwardsPoint multiple = window_base;
+        for (auto j = 0; j < 8; j++){
+            // normalize to Z = 1 so that the entry needs no per-use scaling
+            FE25519 z_inv, x, y, t;
+            Inv(z_inv, multiple.Z);
+            Mul(x, multiple.X, z_inv);
+            Mul(y, multiple.Y, z_inv);
+            Mul(t, x, y);
+            EdwardsPoint affine = {x, y, fe_one, t};
+            ToCached(base_table[8*i+j], affine);
+            Add(multiple, multiple, window_base);
+        }
+        for (auto k = 0; k < 4; k++) Double(window_base, window_base);
+    }
+}
+
+}
+
+
+// C++ class for elements of the ristretto255 group
+class RistrettoPoint{
+public:
+    EdwardsPoint point;
+
+    RistrettoPoint() { Ristretto::SetIdentity(this->point); }
+
+    void SetInfinity() { Ristretto::SetIdentity(this->point); }
+
+    // Returns an RistrettoPoint whose value is (this * scalar).
+    RistrettoPoint Mul(const BigInt& scalar) const;
+
+    // Returns an RistrettoPoint whose value is (this + other).
+    RistrettoPoint Add(const RistrettoPoint& other) const;
+
+    // Returns an RistrettoPoint whose value is (- this).
+    RistrettoPoint Invert() const;
+
+    // Returns an RistrettoPoint whose value is (this - other).
+    RistrettoPoint Sub(const RistrettoPoint& other) const;
+
+    // the identity element of the group
+    bool IsAtInfinity() const;
+
+    // Returns true if this equals point, false otherwise.
+    bool CompareTo(const RistrettoPoint& other) const { return Ristretto::IsEqual(this->point, other.point); }
+
+    // canonical 32-byte encoding
+    void ToBytes(unsigned char *buffer) const { Ristretto::Encode(buffer, this->point); }
+    // returns false if buffer is not a valid encoding
+    bool FromBytes(const unsigned char *buffer) { return Ristretto::Decode(this->point, buffer); }
+    // map 64 uniformly random bytes to the group (ristretto255 element derivation)
+    void FromUniformBytes(const unsigned char *buffer);
+
+    inline bool operator==(const RistrettoPoint& other) const { return this->CompareTo(other); }
+
+    inline bool operator!=(const RistrettoPoint& other) const { return !this->CompareTo(other); }
+
+    inline RistrettoPoint operator-() const { return this->Invert(); }
+
+    inline RistrettoPoint operator+(const RistrettoPoint& other) const { return this->Add(other); }
+
+    inline RistrettoPoint operator*(const BigInt& scalar) const { return this->Mul(scalar); }
+
+    inline RistrettoPoint operator-(const RistrettoPoint& other) const { return this->Sub(other); }
+
+    inline RistrettoPoint& operator+=(const RistrettoPoint& other) { return *this = this->Add(other); }
+
+    inline RistrettoPoint& operator*=(const BigInt& scalar) { return *this = this->Mul(scalar); }
+
+    inline RistrettoPoint& operator-=(const RistrettoPoint& other) { return *this = this->Sub(other); }
+
+    void Print() const;
+
+    void Print(std::string note) const;
+
+    std::string ToByteString() const;
+
+    std::string ToHexString() const;
+
+    friend std::ofstream &operator<<(std::ofstream &fout, const RistrettoPoint &A);
+
+    friend std::ifstream &operator>>(std::ifstream &fin, RistrettoPoint &A);
+};
+
+inline const size_t RISTRETTO_POINT_BYTE_LEN = 32;
+
+inline BIGNUM *ristretto_order;              // 2^252 + 27742317777372353535851937790883648493
+inline RistrettoPoint ristretto_generator;   // the ed25519 basepoint
+
+// variable-base: use RistrettoGeneratorMul for the generator
+RistrettoPoint RistrettoPoint::Mul(const BigInt& scalar) const
+{
+    RistrettoPoint result;
+    Ristretto::Mul(result.point, this->point, scalar, ristretto_order);
+    return result;
+}
+
+// Returns ristretto_generator * scalar, using the basepoint table built at initialization
+RistrettoPoint RistrettoGeneratorMul(const BigInt& scalar)
+{
+    RistrettoPoint result;
+    Ristretto::BaseMul(result.point, scalar, ristretto_order);
+    return result;
+}
+
+RistrettoPoint RistrettoPoint::Add(const RistrettoPoint& other) const
+{
+    RistrettoPoint result;
+    Ristretto::Add(result.point, this->point, other.point);
+    return result;
+}
+
+RistrettoPoint RistrettoPoint::Invert() const
+{
+    RistrettoPoint result;
+    Ristretto::Neg(result.point, this->point);
+    return result;
+}
+
+RistrettoPoint RistrettoPoint::Sub(const RistrettoPoint& other) const
+{
+    return this->Add(other.Invert());
+}
+
+bool RistrettoPoint::IsAtInfinity() const
+{
+    RistrettoPoint identity;
+    return this->CompareTo(identity);
+}
+
+void RistrettoPoint::FromUniformBytes(const unsigned char *buffer)
+{
+    EdwardsPoint P1, P2;
+    Ristretto::Elligator(P1, buffer);
+    Ristretto::Elligator(P2, buffer + 32);
+    Ristretto::Add(this->point, P1, P2);
+}
+
+std::string RistrettoPoint::ToByteString() const
+{
+    std::string str(RISTRETTO_POINT_BYTE_LEN, '0');
+    this->ToBytes(reinterpret_cast<unsigned char*>(&str[0]));
+    return str;
+}
+
+std::string RistrettoPoint::ToHexString() const
+{
+    unsigned char buffer[RISTRETTO_POINT_BYTE_LEN];
+    this->ToBytes(buffer);
+    std::stringstream ss;
+    for (auto i = 0; i < RISTRETTO_POINT_BYTE_LEN; i++){
+        ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(buffer[i]);
+    }
+    return ss.str();
+}
+
+void RistrettoPoint::Print() const
+{
+    std::cout << this->ToHexString() << std::endl;
+}
+
+void RistrettoPoint::Print(std::string note) const
+{
+    std::cout << note << " = ";
+    this->Print();
+}
+
+std::ofstream &operator<<(std::ofstream &fout, const RistrettoPoint &A)
+{
+    unsigned char buffer[RISTRETTO_POINT_BYTE_LEN];
+    A.ToBytes(buffer);
+    fout.write(reinterpret_cast<char *>(buffer), RISTRETTO_POINT_BYTE_LEN);
+    return fout;
+}
+
+std::ifstream &operator>>(std::ifstream &fin, RistrettoPoint &A)
+{
+    unsigned char buffer[RISTRETTO_POINT_BYTE_LEN];
+    fin.read(reinterpret_cast<char *>(buffer), RISTRETTO_POINT_BYTE_LEN);
+    if (!A.FromBytes(buffer)){
+        std::cerr << "invalid ristretto255 encoding" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    return fin;
+}
+
+void Ristretto_Initialize()
+{
+    using namespace Ristretto;
+    FromDecimal(fe_d, "37095705934669439343138083508754565189542113879843219016388785533085940283555");
+    Add(fe_2d, fe_d, fe_d);
+    FromDecimal(fe_sqrt_m1, "19681161376707505956807079304988542015446066515923890162744021073123829784752");
+    FromDecimal(fe_invsqrt_a_minus_d, "54469307008909316920995813868745141605393597292927456921205312896311721017578");
+    FromDecimal(fe_sqrt_ad_minus_one, "25063068953384623474111414158702152701244531502492656460079210482610430750235");
+    FromDecimal(fe_one_minus_d_sq, "1159843021668779879193775521855586647937357759715417654439879720876111806838");
+    FromDecimal(fe_d_minus_one_sq, "40440834346308536858101042469323190826248399146238708352240133220865137265952");
+
+    ristretto_order = BN_new();
+    CRYPTO_CHECK(BN_dec2bn(&ristretto_order, "7237005577332262213973186563042994240857116359379907606001950938285454250989") != 0);
+
+    // encoding of the ed25519 basepoint
+    const unsigned char generator_bytes[32] = {
+        0xe2, 0xf2, 0xae, 0x0a, 0x6a, 0xbc, 0x4e, 0x71, 0xa8, 0x84, 0xa9, 0x61, 0xc5, 0x00, 0x51, 0x5f,
+        0x58, 0xe3, 0x0b, 0x6a, 0xa5, 0x82, 0xdd, 0x8d, 0xb6, 0xa6, 0x59, 0x45, 0xe0, 0x8d, 0x2d, 0x76
+    };
+    CRYPTO_CHECK(ristretto_generator.FromBytes(generator_bytes));
+    BuildBaseTable(ristretto_generator.point);
+}
+
+void Ristretto_Finalize()
+{
+    BN_free(ristretto_order);
+}
+
+
+RistrettoPoint GenRandomRistrettoPoint()
+{
+    unsigned char buffer[64];
+    CRYPTO_CHECK(1 == RAND_bytes(buffer, 64));
+    RistrettoPoint result;
+    result.FromUniformBytes(buffer);
+    return result;
+}
+
+std::vector<RistrettoPoint> GenRandomRistrettoPointVector(size_t LEN)
+{
+    std::vector<RistrettoPoint> vec_A(LEN);
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for (auto i = 0; i < LEN; i++) vec_A[i] = GenRandomRistrettoPoint();
+    return vec_A;
+}
+
+// hash-to-group: SHA-512 of the input fed to the element derivation map
+RistrettoPoint HashToRistrettoPoint(const std::string &input)
+{
+    unsigned char digest[64];
+    SHA512(reinterpret_cast<const unsigned char*>(input.data()), input.size(), digest);
+    RistrettoPoint result;
+    result.FromUniformBytes(digest);
+    return result;
+}
+
+// batch encoding: every encoding needs its own inverse square root, so the batch is spread over threads
+void RistrettoPointVectorToBytes(const RistrettoPoint *A, size_t LEN, unsigned char *buffer)
+{
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for (auto i = 0; i < LEN; i++) A[i].ToBytes(buffer + i*RISTRETTO_POINT_BYTE_LEN);
+}
+
+// exits on an invalid encoding
+void BytesToRistrettoPointVector(const unsigned char *buffer, size_t LEN, RistrettoPoint *A)
+{
+    bool valid = true;
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS) reduction(&&:valid)
+    for (auto i = 0; i < LEN; i++) valid = A[i].FromBytes(buffer + i*RISTRETTO_POINT_BYTE_LEN) && valid;
+    if (!valid){
+        std::cerr << "invalid ristretto255 encoding" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+// the encoding is canonical, so equal points give equal bytes; its first 8 bytes serve as hash value
+class RistrettoPointHash{
+public:
+    size_t operator()(const RistrettoPoint& A) const
+    {
+        unsigned char buffer[RISTRETTO_POINT_BYTE_LEN];
+        A.ToBytes(buffer);
+        size_t hashvalue;
+        memcpy(&hashvalue, buffer, sizeof(hashvalue));
+        return hashvalue;
+    }
+};
+
+
+/*
+** protocols that only need a prime-order group (ElGamal, Naor-Pinkas OT, DDH-based PEQT) are written against GroupPoint:
+** the OpenSSL curve by default, ristretto255 if ENABLE_RISTRETTO_GROUP is defined in ec_group.hpp
+*/
+#ifdef ENABLE_RISTRETTO_GROUP
+typedef RistrettoPoint GroupPoint;
+inline BIGNUM *GroupOrder() { return ristretto_order; }
+inline GroupPoint GroupGenerator() { return ristretto_generator; }
+inline GroupPoint GroupGeneratorMul(const BigInt& scalar) { return RistrettoGeneratorMul(scalar); }
+inline GroupPoint GPower(const GroupPoint &g, bool g_is_generator, const BigInt& scalar) { 
+    return g_is_generator ? RistrettoGeneratorMul(scalar) : g * scalar; 
+}
+inline size_t GroupPointByteLen() { return RISTRETTO_POINT_BYTE_LEN; }
+#else
+typedef ECPoint GroupPoint;
+inline BIGNUM *GroupOrder() { return order; }
+inline GroupPoint GroupGenerator() { return ECPoint(generator); }
+inline GroupPoint GroupGeneratorMul(const BigInt& scalar) { return GeneratorMul(scalar); }
+inline size_t GroupPointByteLen() { return ECPointSerializedByteLen(); }
+#endif
+
+#endif
@@ -0,0 +1,294 @@
+/****************************************************************************
+this hpp implements arithmetic in GF(2^128) = GF(2)[x]/(x^128 + x^7 + x^2 + x + 1)
+bit i of a block is the coefficient of x^i
+a product is 4 carry-less multiplications (256-bit result) plus a reduction of 2 more;
+the batch routines keep sums of products unreduced and reduce once (lazy reduction),
+and use VPCLMULQDQ on zmm (4 products per instruction) when cpuid reports it
+*****************************************************************************
+* @copyright  MIT license (see LICENSE file)
+*****************************************************************************/
+#ifndef KUNLUN_CRYPTO_GF128_HPP_
+#define KUNLUN_CRYPTO_GF128_HPP_
+
+#include "block.hpp"
+
+// comment this line if the compiler does not know the vpclmulqdq/avx512f/avx512bw targets (gcc < 8, clang < 6)
+#define ENABLE_VPCLMUL
+
+namespace GF128{
+
+// x^7 + x^2 + x + 1: the reduction of x^128
+inline const uint64_t MODULUS_OMIT128 = 0b10000111;
+
+inline bool DetectVPCLMUL()
+{
+    #ifdef ENABLE_VPCLMUL
+        __builtin_cpu_init();
+        // Reduce512 shifts bytes within 128-bit lanes, which is an AVX-512BW instruction
+        return __builtin_cpu_supports("vpclmulqdq") && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+    #endif
+    return false;
+}
+
+inline const bool vpclmul = DetectVPCLMUL();
+
+/*
+** a 256-bit product is kept as three parts: low = x0*y0, high = x1*y1, middle = x0*y1 + x1*y0
+** sums of products are sums of the parts, so the parts are combined only once
+*/
+__attribute__((target("pclmul,sse2")))
+inline void MulAccumulate(const block &x, const block &y, block &low, block &middle, block &high)
+{
+    low ^= _mm_clmulepi64_si128(x, y, 0x00);
+    middle ^= _mm_clmulepi64_si128(x, y, 0x10) ^ _mm_clmulepi64_si128(x, y, 0x01);
+    high ^= _mm_clmulepi64_si128(x, y, 0x11);
+}
+
+// reduce low + middle*x^64 + high*x^128
+__attribute__((target("pclmul,sse2")))
+inline block Reduce(block low, block middle, block high)
+{
+    low ^= _mm_slli_si128(middle, 8);
+    high ^= _mm_srli_si128(middle, 8);
+
+    const block modulus = _mm_loadl_epi64((const block*)&MODULUS_OMIT128);
+    // fold the top 64 bits, which spill into high, then the remaining 128 bits of high
+    block impact = _mm_clmulepi64_si128(high, modulus, 0x01);
+    low ^= _mm_slli_si128(impact, 8);
+    high ^= _mm_srli_si128(impact, 8);
+    impact = _mm_clmulepi64_si128(high, modulus, 0x00);
+    return low ^ impact;
+}
+
+__attribute__((target("pclmul,sse2")))
+inline block Mul(const block &x, const block &y)
+{
+    block low = Block::zero_block, middle = Block::zero_block, high = Block::zero_block;
+    MulAccumulate(x, y, low, middle, high);
+    return Reduce(low, middle, high);
+}
+
+#ifdef ENABLE_VPCLMUL
+__attribute__((target("vpclmulqdq,avx512f,avx512bw")))
+inline void MulAccumulate512(const __m512i &x, const __m512i &y, __m512i &low, __m512i &middle, __m512i &high)
+{
+    low = _mm512_xor_si512(low, _mm512_clmulepi64_epi128(x, y, 0x00));
+    middle = _mm512_ternarylogic_epi64(middle, _mm512_clmulepi64_epi128(x, y, 0x10), _mm512_clmulepi64_epi128(x, y, 0x01), 0x96);
+    high = _mm512_xor_si512(high, _mm512_clmulepi64_epi128(x, y, 0x11));
+}
+
+// reduce the 4 lanes independently
+__attribute__((target("vpclmulqdq,avx512f,avx512bw")))
+inline __m512i Reduce512(__m512i low, __m512i middle, __m512i high)
+{
+    low = _mm512_xor_si512(low, _mm512_bslli_epi128(middle, 8));
+    high = _mm512_xor_si512(high, _mm512_bsrli_epi128(middle, 8));
+
+    const __m512i modulus = _mm512_set1_epi64(MODULUS_OMIT128);
+    __m512i impact = _mm512_clmulepi64_epi128(high, modulus, 0x01);
+    low = _mm512_xor_si512(low, _mm512_bslli_epi128(impact, 8));
+    high = _mm512_xor_si512(high, _mm512_bsrli_epi128(impact, 8));
+    impact = _mm512_clmulepi64_epi128(high, modulus, 0x00);
+    return _mm512_xor_si512(low, impact);
+}
+
+// xor of the 4 lanes
+__attribute__((target("avx512f")))
+inline block FoldLanes(const __m512i &a)
+{
+    return _mm512_castsi512_si128(a) ^ _mm512_extracti32x4_epi32(a, 1) ^ _mm512_extracti32x4_epi32(a, 2) ^ _mm512_extracti32x4_epi32(a, 3);
+}
+
+__attribute__((target("vpclmulqdq,avx512f,avx512bw")))
+inline size_t InnerProductVPCLMUL(const block *a, const block *b, size_t LEN, block &low, block &middle, block &high)
+{
+    __m512i low4 = _mm512_setzero_si512(), middle4 = _mm512_setzero_si512(), high4 = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 4 <= LEN; i += 4){
+        MulAccumulate512(_mm512_loadu_si512((const void*)(a + i)), _mm512_loadu_si512((const void*)(b + i)), low4, middle4, high4);
+    }
+    low ^= FoldLanes(low4);
+    middle ^= FoldLanes(middle4);
+    high ^= FoldLanes(high4);
+    return i;
+}
+
+// output[i] = a[i]*b[i] (b_stride = 1) or a[i]*b[0] (b_stride = 0); with ADD the product is xored into output[i]
+template <bool ADD>
+__attribute__((target("vpclmulqdq,avx512f,avx512bw")))
+inline size_t MulVPCLMUL(block *output, const block *a, const block *b, size_t b_stride, size_t LEN)
+{
+    __m512i vb = (b_stride == 0) ? _mm512_broadcast_i32x4(b[0]) : _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 4 <= LEN; i += 4){
+        __m512i low = _mm512_setzero_si512(), middle = _mm512_setzero_si512(), high = _mm512_setzero_si512();
+        if (b_stride) vb = _mm512_loadu_si512((const void*)(b + i));
+        MulAccumulate512(_mm512_loadu_si512((const void*)(a + i)), vb, low, middle, high);
+        __m512i product = Reduce512(low, middle, high);
+        if (ADD) product = _mm512_xor_si512(product, _mm512_loadu_si512((const void*)(output + i)));
+        _mm512_storeu_si512((void*)(output + i), product);
+    }
+    return i;
+}
+
+__attribute__((target("vpclmulqdq,avx512f,avx512bw")))
+inline __m512i Mul512(const __m512i &x, const __m512i &y)
+{
+    __m512i low = _mm512_setzero_si512(), middle = _mm512_setzero_si512(), high = _mm512_setzero_si512();
+    MulAccumulate512(x, y, low, middle, high);
+    return Reduce512(low, middle, high);
+}
+
+// Horner's rule for 8 (then 4) evaluation points at a time; two independent chains hide the multiplication latency
+__attribute__((target("vpclmulqdq,avx512f,avx512bw")))
+inline size_t PowerInnerProductVPCLMUL(block *output, const block *a, const block *d, size_t NUM, size_t LEN)
+{
+    size_t k = 0;
+    for (; k + 8 <= NUM; k += 8){
+        __m512i d0 = _mm512_loadu_si512((const void*)(d + k)), d1 = _mm512_loadu_si512((const void*)(d + k + 4));
+        __m512i acc0 = _mm512_setzero_si512(), acc1 = _mm512_setzero_si512();
+        for (auto j = LEN; j-- > 0; ){
+            __m512i aj = _mm512_broadcast_i32x4(a[j]);
+            acc0 = Mul512(_mm512_xor_si512(acc0, aj), d0);
+            acc1 = Mul512(_mm512_xor_si512(acc1, aj), d1);
+        }
+        _mm512_storeu_si512((void*)(output + k), _mm512_xor_si512(acc0, _mm512_loadu_si512((const void*)(output + k))));
+        _mm512_storeu_si512((void*)(output + k + 4), _mm512_xor_si512(acc1, _mm512_loadu_si512((const void*)(output + k + 4))));
+    }
+    for (; k + 4 <= NUM; k += 4){
+        __m512i d0 = _mm512_loadu_si512((const void*)(d + k));
+        __m512i acc0 = _mm512_setzero_si512();
+        for (auto j = LEN; j-- > 0; ) acc0 = Mul512(_mm512_xor_si512(acc0, _mm512_broadcast_i32x4(a[j])), d0);
+        _mm512_storeu_si512((void*)(output + k), _mm512_xor_si512(acc0, _mm512_loadu_si512((const void*)(output + k))));
+    }
+    return k;
+}
+#endif
+
+// sum of a[i]*b[i], reduced once
+inline block InnerProduct(const block *a, const block *b, size_t LEN)
+{
+    block low = Block::zero_block, middle = Block::zero_block, high = Block::zero_block;
+    size_t i = 0;
+    #ifdef ENABLE_VPCLMUL
+        if (vpclmul) i = InnerProductVPCLMUL(a, b, LEN, low, middle, high);
+    #endif
+    for (; i < LEN; i++) MulAccumulate(a[i], b[i], low, middle, high);
+    return Reduce(low, middle, high);
+}
+
+// output[i] = a[i]*b[i]; output may alias a or b
+inline void Mul(block *output, const block *a, const block *b, size_t LEN)
+{
+    size_t i = 0;
+    #ifdef ENABLE_VPCLMUL
+        if (vpclmul) i = MulVPCLMUL<false>(output, a, b, 1, LEN);
+    #endif
+    for (; i < LEN; i++) output[i] = Mul(a[i], b[i]);
+}
+
+// output[i] = a[i]*b
+inline void ScalarMul(block *output, const block *a, const block &b, size_t LEN)
+{
+    size_t i = 0;
+    #ifdef ENABLE_VPCLMUL
+        if (vpclmul) i = MulVPCLMUL<false>(output, a, &b, 0, LEN);
+    #endif
+    for (; i < LEN; i++) output[i] = Mul(a[i], b);
+}
+
+// output[i] ^= a[i]*b, the row operation of Gaussian elimination
+inline void ScalarMulAdd(block *output, const block *a, const block &b, size_t LEN)
+{
+    size_t i = 0;
+    #ifdef ENABLE_VPCLMUL
+        if (vpclmul) i = MulVPCLMUL<true>(output, a, &b, 0, LEN);
+    #endif
+    for (; i < LEN; i++) output[i] ^= Mul(a[i], b);
+}
+
+/*
+** <(d, d^2, ..., d^LEN), a>: the dense part of an OKVS row with common ratio d
+** Horner's rule takes LEN multiplications and no table of powers
+*/
+inline block PowerInnerProduct(const block *a, const block &d, size_t LEN)
+{
+    block acc = Block::zero_block;
+    for (auto j = LEN; j-- > 0; ) acc = Mul(acc ^ a[j], d);
+    return acc;
+}
+
+// output[k] ^= PowerInnerProduct(a, d[k], LEN) for k < NUM
+inline void PowerInnerProduct(block *output, const block *a, const block *d, size_t NUM, size_t LEN)
+{
+    size_t k = 0;
+    #ifdef ENABLE_VPCLMUL
+        if (vpclmul) k = PowerInnerProductVPCLMUL(output, a, d, NUM, LEN);
+    #endif
+    for (; k < NUM; k++) output[k] ^= PowerInnerProduct(a, d[k], LEN);
+}
+
+/*
+** <g, x> = x[0] + x[1]*X + ... + x[127]*X^127 for the gadget vector g = (1, X, ..., X^127)
+** multiplying by X^i is a shift: the 128 shifted values are summed as 256-bit words and reduced once
+*/
+inline block GadgetInnerProduct(const block *x)
+{
+    uint64_t sum[4] = {0, 0, 0, 0};
+    for (auto i = 0; i < 128; i++){
+        uint64_t w[2];
+        memcpy(w, x + i, 16);
+        size_t q = i / 64, r = i % 64;
+        sum[q] ^= w[0] << r;
+        sum[q+1] ^= w[1] << r;
+        if (r != 0){
+            sum[q+1] ^= w[0] >> (64 - r);
+            sum[q+2] ^= w[1] >> (64 - r);
+        }
+    }
+    return Reduce(Block::MakeBlock(sum[1], sum[0]), Block::zero_block, Block::MakeBlock(sum[3], sum[2]));
+}
+
+// x^{-1} = x^{2^128-2}; 0 is mapped to 0
+inline block Inv(const block &x)
+{
+    // entering round i, a = x^{2^{2^i}-1}; b = a^{2^{2^i}} shifts the ones of the exponent up
+    block a = x;
+    block result = Block::zero_block;
+    for (auto i = 0; i <= 6; i++){
+        block b = a;
+        for (auto j = 0; j < (1 << i); j++) b = Mul(b, b);
+        a = Mul(a, b);
+        // result collects the exponent 0b1...10 with 2^{i+1}-1 ones
+        result = (i == 0) ? b : Mul(result, b);
+    }
+    return result;
+}
+
+// Montgomery's trick: one inversion and 3(LEN-1) multiplications; zeros are mapped to zeros
+inline void BatchInv(block *output, const block *input, size_t LEN)
+{
+    if (LEN == 0) return;
+    const block one = Block::MakeBlock(0, 1);
+    std::vector<block> prefix(LEN);
+    block acc = one;
+    for (auto i = 0; i < LEN; i++){
+        prefix[i] = acc;
+        if (!Block::Compare(input[i], Block::zero_block)) acc = Mul(acc, input[i]);
+    }
+    // acc = product of the nonzero inputs
+    acc = Inv(acc);
+    for (auto i = LEN; i-- > 0; ){
+        if (Block::Compare(input[i], Block::zero_block)){
+            output[i] = Block::zero_block;
+            continue;
+        }
+        block inverse = Mul(acc, prefix[i]);
+        acc = Mul(acc, input[i]);
+        output[i] = inverse;
+    }
+}
+
+}
+
+#endif
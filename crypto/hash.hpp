@@ -10,15 +10,35 @@ this hpp implements hash functions
 #include "../include/global.hpp"
 #include "bigint.hpp"
 #include "ec_point.hpp"
+#include "ec_ristretto.hpp"
+#include "ec_25519.hpp"
+#include "hash_to_curve.hpp"
+#include "sha256_many.hpp"
+#include "blake3.hpp"
+#include "../utility/record_batch.hpp"
 
 inline const size_t HASH_BUFFER_SIZE = 1024*8;
 inline const size_t HASH_OUTPUT_LEN = 32;  // hash output = 256-bit string
 
+/*
+** BasicHash hashes one input, BasicHashMany hashes NUM inputs of the same length stored back to back
+** the two must be switched together
+*/
 //#define BasicHash(input, HASH_INPUT_LEN, output) SM3(input, HASH_INPUT_LEN, output)
 #define BasicHash(input, HASH_INPUT_LEN, output) SHA256(input, HASH_INPUT_LEN, output)
+#define BasicHashMany(input, HASH_INPUT_LEN, NUM, output) MultiSHA256::HashMany(input, HASH_INPUT_LEN, NUM, output)
+
+//#define BasicHash(input, HASH_INPUT_LEN, output) BLAKE3::Hash(input, HASH_INPUT_LEN, output)
+//#define BasicHashMany(input, HASH_INPUT_LEN, NUM, output) BLAKE3::HashMany(input, HASH_INPUT_LEN, NUM, output)
 
 namespace Hash{
 
+// NUM inputs of HASH_INPUT_LEN bytes each (back to back) ==> NUM digests of HASH_OUTPUT_LEN bytes (back to back)
+inline void HashMany(const unsigned char *input, size_t HASH_INPUT_LEN, size_t NUM, unsigned char *output)
+{
+    BasicHashMany(input, HASH_INPUT_LEN, NUM, output); 
+}
+
 // adaptor for SM3: default output length is 256 bit
 void SM3(const unsigned char *input, size_t HASH_INPUT_LEN, unsigned char *output)
 {
@@ -80,6 +100,36 @@ block StringToBlock(const std::string &str_input)
     return _mm_load_si128((block*)&output[0]);
 }
 
+/*
+** NUM variable-length records stored back to back, record i = data[offsets[i], offsets[i+1]) (see RecordBatch)
+** output[i] = StringToBlock(record i), without a std::string per record
+** runs of consecutive records of the same length (phone numbers, fixed-width ids) go through BasicHashMany together
+*/
+void RecordsToBlocks(const unsigned char *data, const uint64_t *offsets, size_t NUM, block *output)
+{
+    const size_t RECORD_CHUNK_LEN = 256;
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS) if(NUM >= (1 << 12))
+    for (auto k = 0; k < NUM; k += RECORD_CHUNK_LEN){
+        size_t CHUNK_LEN = std::min(RECORD_CHUNK_LEN, NUM - k);
+        unsigned char digest[RECORD_CHUNK_LEN * HASH_OUTPUT_LEN];
+        for (size_t i = k, j; i < k + CHUNK_LEN; i = j){
+            size_t RECORD_LEN = offsets[i+1] - offsets[i];
+            for (j = i + 1; j < k + CHUNK_LEN && offsets[j+1] - offsets[j] == RECORD_LEN; j++);
+            if (j - i == 1) BasicHash(data + offsets[i], RECORD_LEN, digest + (i-k)*HASH_OUTPUT_LEN);
+            else BasicHashMany(data + offsets[i], RECORD_LEN, j - i, digest + (i-k)*HASH_OUTPUT_LEN);
+        }
+        for (auto i = 0; i < CHUNK_LEN; i++) output[k+i] = _mm_loadu_si128((block*)(digest + i*HASH_OUTPUT_LEN));
+    }
+}
+
+// the block vector consumed by the PSO protocols
+std::vector<block> RecordsToBlocks(const RecordBatch &batch)
+{
+    std::vector<block> vec_result(batch.Size());
+    RecordsToBlocks(batch.data.data(), batch.offsets.data(), batch.Size(), vec_result.data());
+    return vec_result;
+}
+
 __attribute__((target("sse2")))
 block BytesToBlock(const std::vector<uint8_t> &vec_A) 
 {
@@ -99,7 +149,8 @@ BigInt StringToBigInt(const std::string& str_input){
     return result; 
 }
 
-ECPoint StringToECPoint(const std::string& input) 
+// try-and-increment: only used for curves without a native SSWU map
+ECPoint TryAndIncrementStringToECPoint(const std::string& input) 
 {
     ECPoint ecp_result; 
 
@@ -127,18 +178,57 @@ ECPoint StringToECPoint(const std::string& input)
     return ecp_result;
 }
 
+// RFC 9380 hash_to_curve on prime256v1
+ECPoint StringToECPoint(const std::string& input) 
+{
+    if (HashToCurve::ENABLE_SSWU == false) return TryAndIncrementStringToECPoint(input); 
+
+    ECPoint ecp_result; 
+    JacobianPoint R; 
+    HashToCurve::HashToP256(R, reinterpret_cast<const unsigned char*>(input.data()), input.size()); 
+    ECJacobian::ToECPoint(ecp_result.point_ptr, R, GetBNCtx()); 
+    return ecp_result;
+}
+
 block ECPointToBlock(const ECPoint &A) 
 {
     std::string str_input = A.ToByteString();
     return StringToBlock(str_input);  
 }
 
+block ECPointToBlock(const RistrettoPoint &A) 
+{
+    std::string str_input = A.ToByteString();
+    return StringToBlock(str_input);  
+}
+
+/*
+** batch versions of ECPointToBlock: the points are serialized with one batch normalization 
+** and hashed with one HashMany call
+*/
+void ECPointsToBlocks(const ECPoint *A, size_t LEN, block *output)
+{
+    std::vector<unsigned char> buffer(LEN * POINT_COMPRESSED_BYTE_LEN); 
+    ECPointVectorToCompressedBytes(A, LEN, buffer.data()); 
+    std::vector<unsigned char> digest(LEN * HASH_OUTPUT_LEN); 
+    HashMany(buffer.data(), POINT_COMPRESSED_BYTE_LEN, LEN, digest.data()); 
+    for (auto i = 0; i < LEN; i++) output[i] = _mm_loadu_si128((block*)(digest.data() + i*HASH_OUTPUT_LEN)); 
+}
+
+void ECPointsToBlocks(const RistrettoPoint *A, size_t LEN, block *output)
+{
+    std::vector<unsigned char> buffer(LEN * RISTRETTO_POINT_BYTE_LEN); 
+    RistrettoPointVectorToBytes(A, LEN, buffer.data()); 
+    std::vector<unsigned char> digest(LEN * HASH_OUTPUT_LEN); 
+    HashMany(buffer.data(), RISTRETTO_POINT_BYTE_LEN, LEN, digest.data()); 
+    for (auto i = 0; i < LEN; i++) output[i] = _mm_loadu_si128((block*)(digest.data() + i*HASH_OUTPUT_LEN)); 
+}
+
 std::string ECPointToString(const ECPoint &A) 
 { 
-    int thread_num = omp_get_thread_num();
     unsigned char input[POINT_COMPRESSED_BYTE_LEN];
     unsigned char output[HASH_OUTPUT_LEN]; 
-    EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_COMPRESSED, input, POINT_COMPRESSED_BYTE_LEN, bn_ctx[thread_num]);
+    EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_COMPRESSED, input, POINT_COMPRESSED_BYTE_LEN, GetBNCtx());
     
     size_t HASH_INPUT_LEN = POINT_COMPRESSED_BYTE_LEN;
     BasicHash(input, HASH_INPUT_LEN, output); 
@@ -149,10 +239,9 @@ std::string ECPointToString(const ECPoint &A)
 
 std::vector<uint8_t> ECPointToBytes(const ECPoint &A) 
 { 
-    int thread_num = omp_get_thread_num();
     unsigned char input[POINT_COMPRESSED_BYTE_LEN];
     unsigned char output[HASH_OUTPUT_LEN]; 
-    EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_COMPRESSED, input, POINT_COMPRESSED_BYTE_LEN, bn_ctx[thread_num]);
+    EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_COMPRESSED, input, POINT_COMPRESSED_BYTE_LEN, GetBNCtx());
     
     size_t HASH_INPUT_LEN = POINT_COMPRESSED_BYTE_LEN;
     BasicHash(input, HASH_INPUT_LEN, output);
@@ -163,6 +252,14 @@ std::vector<uint8_t> ECPointToBytes(const ECPoint &A)
     return result; 
 }
 
+// batch version of ECPointToBytes: output takes HASH_OUTPUT_LEN bytes per point
+void ECPointsToBytes(const ECPoint *A, size_t LEN, unsigned char *output)
+{
+    std::vector<unsigned char> buffer(LEN * POINT_COMPRESSED_BYTE_LEN); 
+    ECPointVectorToCompressedBytes(A, LEN, buffer.data()); 
+    HashMany(buffer.data(), POINT_COMPRESSED_BYTE_LEN, LEN, output); 
+}
+
 // Hash-based blocks to block hash
 block BlocksToBlock(const std::vector<block> &input_block)
 {
@@ -189,6 +286,69 @@ block FastBlocksToBlock(const std::vector<block> input_block)
     return vec_B[BLOCK_NUM-1];
 }
 
+/*
+** hash ROW_NUM rows of ROW_BLOCK_LEN blocks each: output[i] = FastBlocksToBlock(row i)
+** the CBC chains of all rows advance together, so each step is one batched ECB call
+*/
+void FastBlocksToBlock(const block *input, size_t ROW_NUM, size_t ROW_BLOCK_LEN, block *output)
+{
+    for (auto i = 0; i < ROW_NUM; i++) output[i] = _mm_xor_si128(input[i*ROW_BLOCK_LEN], AES::IV);
+    AES::FastECBEnc(AES::fixed_enc_key, output, ROW_NUM);
+    for (auto j = 1; j < ROW_BLOCK_LEN; j++){
+        for (auto i = 0; i < ROW_NUM; i++) output[i] = _mm_xor_si128(output[i], input[i*ROW_BLOCK_LEN + j]);
+        AES::FastECBEnc(AES::fixed_enc_key, output, ROW_NUM);
+    }
+}
+
+/*
+** correlation robust hashes from AES under the fixed key pi
+** MMO:  H(x) = pi(x) xor x
+** TMMO: H(x, i) = pi(pi(x) xor i) xor pi(x), tweaked by the index i
+** blocks go through in chunks that fit on the stack, so nothing is allocated and in-place calls are fine
+*/
+const size_t CR_HASH_CHUNK_LEN = 64; 
+
+void CRHashBlocks(const block *input, block *output, size_t LEN)
+{
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS) if(LEN >= (1 << 14))
+    for (auto k = 0; k < LEN; k += CR_HASH_CHUNK_LEN){
+        size_t CHUNK_LEN = std::min(CR_HASH_CHUNK_LEN, LEN - k);
+        block buffer[CR_HASH_CHUNK_LEN];
+        memcpy(buffer, input + k, CHUNK_LEN * sizeof(block));
+        AES::FastECBEnc(AES::fixed_enc_key, buffer, CHUNK_LEN);
+        for (auto i = 0; i < CHUNK_LEN; i++) output[k+i] = _mm_xor_si128(buffer[i], input[k+i]);
+    }
+}
+
+// block i is tweaked by TWEAK_BEGIN + i
+void TCRHashBlocks(const block *input, block *output, size_t LEN, uint64_t TWEAK_BEGIN)
+{
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS) if(LEN >= (1 << 14))
+    for (auto k = 0; k < LEN; k += CR_HASH_CHUNK_LEN){
+        size_t CHUNK_LEN = std::min(CR_HASH_CHUNK_LEN, LEN - k);
+        block buffer[CR_HASH_CHUNK_LEN], tweaked[CR_HASH_CHUNK_LEN];
+        memcpy(buffer, input + k, CHUNK_LEN * sizeof(block));
+        AES::FastECBEnc(AES::fixed_enc_key, buffer, CHUNK_LEN);
+        for (auto i = 0; i < CHUNK_LEN; i++) tweaked[i] = _mm_xor_si128(buffer[i], _mm_set_epi64x(0, TWEAK_BEGIN + k + i));
+        AES::FastECBEnc(AES::fixed_enc_key, tweaked, CHUNK_LEN);
+        for (auto i = 0; i < CHUNK_LEN; i++) output[k+i] = _mm_xor_si128(tweaked[i], buffer[i]);
+    }
+}
+
+/*
+** hash ROW_NUM rows of ROW_BLOCK_LEN blocks each, row i tweaked by TWEAK_BEGIN + i
+** a row is absorbed block by block: c = TMMO(c xor x_j, i) from c = 0, so one-block rows get TMMO(x_0, i)
+*/
+void TCRHashRows(const block *input, size_t ROW_NUM, size_t ROW_BLOCK_LEN, block *output, uint64_t TWEAK_BEGIN)
+{
+    for (auto i = 0; i < ROW_NUM; i++) output[i] = input[i*ROW_BLOCK_LEN];
+    TCRHashBlocks(output, output, ROW_NUM, TWEAK_BEGIN);
+    for (auto j = 1; j < ROW_BLOCK_LEN; j++){
+        for (auto i = 0; i < ROW_NUM; i++) output[i] = _mm_xor_si128(output[i], input[i*ROW_BLOCK_LEN + j]);
+        TCRHashBlocks(output, output, ROW_NUM, TWEAK_BEGIN);
+    }
+}
+
 
 // /* 
 // ** AES-based block to block hash
@@ -222,10 +382,9 @@ int BlockToBytes(const block &var, uint8_t* output, size_t LEN)
     return 1; 
 }
 
-// fast and threadsafe block to ecpoint hash using low level openssl code
-inline ECPoint BlockToECPoint(const block &var)
+// try-and-increment block to ecpoint hash using low level openssl code: only used for curves without a native SSWU map
+inline ECPoint TryAndIncrementBlockToECPoint(const block &var)
 {
-    int thread_num = omp_get_thread_num();
     ECPoint ecp_result; 
     BIGNUM *x = BN_new();
     uint8_t buffer[32]; 
@@ -238,13 +397,105 @@ inline ECPoint BlockToECPoint(const block &var)
         Dedicated_CBCAES(buffer, buffer); // iterated hash, modeled as random oracle
         // BasicHash(buffer, 32, buffer); 
         BN_bin2bn(buffer, 32, x);
-        if(EC_POINT_set_compressed_coordinates(group, ecp_result.point_ptr, x, y_bit, bn_ctx[thread_num])==1) break;              
+        if(EC_POINT_set_compressed_coordinates(group, ecp_result.point_ptr, x, y_bit, GetBNCtx())==1) break;              
     }
     BN_free(x);    
     return ecp_result;
 }
 
+/*
+** hash LEN blocks to ECPoints: RFC 9380 hash_to_curve with the 16 bytes of each block as message
+** every thread maps one chunk and normalizes it with a single field inversion
+*/
+void BlocksToECPoints(const block *input, size_t LEN, ECPoint *output)
+{
+    size_t THREAD_NUM = omp_in_parallel() ? 1 : std::max<size_t>(1, std::min(NUMBER_OF_THREADS, LEN/64));
+    size_t CHUNK_LEN = (LEN + THREAD_NUM - 1) / THREAD_NUM;
 
+    if (HashToCurve::ENABLE_SSWU == false){
+        #pragma omp parallel for num_threads(THREAD_NUM)
+        for (auto i = 0; i < LEN; i++) output[i] = TryAndIncrementBlockToECPoint(input[i]);
+        return;
+    }
+
+    #pragma omp parallel for num_threads(THREAD_NUM)
+    for (auto t = 0; t < THREAD_NUM; t++){
+        size_t begin = t * CHUNK_LEN;
+        size_t end = std::min(LEN, begin + CHUNK_LEN);
+        if (begin >= end) continue;
+
+        std::vector<JacobianPoint> vec_R(end - begin);
+        for (auto i = begin; i < end; i++){
+            HashToCurve::HashToP256(vec_R[i-begin], reinterpret_cast<const unsigned char*>(input + i), sizeof(block));
+        }
+        std::vector<AffinePoint> vec_Q(end - begin);
+        ECJacobian::BatchNormalize(vec_Q.data(), vec_R.data(), end - begin);
+
+        JacobianPoint R;
+        R.Z = ECJacobian::field.one;
+        BN_CTX *ctx = GetBNCtx();
+        for (auto i = begin; i < end; i++){
+            if (vec_Q[i-begin].infinity){
+                EC_POINT_set_to_infinity(group, output[i].point_ptr);
+                continue;
+            }
+            R.X = vec_Q[i-begin].x;
+            R.Y = vec_Q[i-begin].y;
+            ECJacobian::ToECPoint(output[i].point_ptr, R, ctx);
+        }
+    }
+}
+
+// hash LEN blocks to ristretto255: SHA-512 of each block fed to the element derivation map
+void BlocksToECPoints(const block *input, size_t LEN, RistrettoPoint *output)
+{
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS) if(!omp_in_parallel())
+    for (auto i = 0; i < LEN; i++){
+        unsigned char digest[64];
+        SHA512(reinterpret_cast<const unsigned char*>(input + i), sizeof(block), digest);
+        output[i].FromUniformBytes(digest);
+    }
+}
+
+std::vector<ECPoint> BlocksToECPoints(const std::vector<block> &vec_A)
+{
+    std::vector<ECPoint> vec_result(vec_A.size());
+    BlocksToECPoints(vec_A.data(), vec_A.size(), vec_result.data());
+    return vec_result;
+}
+
+// no parallel region: callers often run it inside their own parallel loop
+inline ECPoint BlockToECPoint(const block &var)
+{
+    if (HashToCurve::ENABLE_SSWU == false) return TryAndIncrementBlockToECPoint(var);
+
+    ECPoint ecp_result;
+    JacobianPoint R;
+    HashToCurve::HashToP256(R, reinterpret_cast<const unsigned char*>(&var), sizeof(block));
+    ECJacobian::ToECPoint(ecp_result.point_ptr, R, GetBNCtx());
+    return ecp_result;
+}
+
+/*
+** hash LEN blocks to curve25519 u-coordinates for the x25519 method via Elligator2
+** unlike BlockToBytes, the output is always on the curve rather than possibly on its twist
+*/
+void BlocksToEC25519Points(const block *input, size_t LEN, EC25519Point *output)
+{
+    size_t THREAD_NUM = omp_in_parallel() ? 1 : std::max<size_t>(1, std::min(NUMBER_OF_THREADS, LEN/64));
+    size_t CHUNK_LEN = (LEN + THREAD_NUM - 1) / THREAD_NUM;
+
+    #pragma omp parallel for num_threads(THREAD_NUM)
+    for (auto t = 0; t < THREAD_NUM; t++){
+        size_t begin = t * CHUNK_LEN;
+        size_t end = std::min(LEN, begin + CHUNK_LEN);
+        if (begin >= end) continue;
+
+        std::vector<unsigned char> buffer(32 * (end - begin));
+        HashToCurve::HashToCurve25519(buffer.data(), reinterpret_cast<const unsigned char*>(input + begin), sizeof(block), end - begin);
+        for (auto i = begin; i < end; i++) memcpy(output[i].px, buffer.data() + 32*(i-begin), 32);
+    }
+}
 }
 
 #endif //_HASH_HPP_
@@ -0,0 +1,303 @@
+/****************************************************************************
+this hpp implements hashing to elliptic curves following RFC 9380
+P256_XMD:SHA-256_SSWU_RO_: two simplified SWU maps on the native Montgomery field, added up
+curve25519_XMD:SHA-512_ELL2_NU_: one Elligator2 map to the u-coordinate; the cofactor is
+cleared by the clamped x25519 scalar, so the map output is fed to x25519 directly
+both maps are straight-line code: no retry loop, the running time does not depend on the input
+*****************************************************************************
+* @copyright  MIT license (see LICENSE file)
+*****************************************************************************/
+#ifndef KUNLUN_HASH_TO_CURVE_HPP_
+#define KUNLUN_HASH_TO_CURVE_HPP_
+
+#include "ec_jacobian.hpp"
+#include "ec_ristretto.hpp"
+
+namespace HashToCurve{
+
+// domain separation tags of Kunlun
+inline const std::string DST_P256 = "KUNLUN-V01-CS02-with-P256_XMD:SHA-256_SSWU_RO_";
+inline const std::string DST_CURVE25519 = "KUNLUN-V01-CS02-with-curve25519_XMD:SHA-512_ELL2_NU_";
+
+/* expand_message_xmd (RFC 9380 section 5.3.1) */
+
+struct XMD_SHA256{
+    typedef SHA256_CTX CTX;
+    static const size_t B_LEN = 32;  // output length
+    static const size_t S_LEN = 64;  // block length
+    static void Init(CTX *ctx) { SHA256_Init(ctx); }
+    static void Update(CTX *ctx, const void *data, size_t LEN) { SHA256_Update(ctx, data, LEN); }
+    static void Final(unsigned char *digest, CTX *ctx) { SHA256_Final(digest, ctx); }
+};
+
+struct XMD_SHA512{
+    typedef SHA512_CTX CTX;
+    static const size_t B_LEN = 64;
+    static const size_t S_LEN = 128;
+    static void Init(CTX *ctx) { SHA512_Init(ctx); }
+    static void Update(CTX *ctx, const void *data, size_t LEN) { SHA512_Update(ctx, data, LEN); }
+    static void Final(unsigned char *digest, CTX *ctx) { SHA512_Final(digest, ctx); }
+};
+
+// requires OUTPUT_LEN <= 255*B_LEN and dst.size() <= 255
+template <typename H>
+void ExpandMessageXMD(unsigned char *output, size_t OUTPUT_LEN, const unsigned char *msg, size_t MSG_LEN, const std::string &dst)
+{
+    // Z_pad is exactly one block, so the state after absorbing it is computed once
+    static const typename H::CTX zpad_ctx = [](){
+        typename H::CTX ctx;
+        unsigned char zpad[H::S_LEN] = {0};
+        H::Init(&ctx);
+        H::Update(&ctx, zpad, H::S_LEN);
+        return ctx;
+    }();
+
+    unsigned char dst_len = (unsigned char)dst.size();
+    unsigned char len_i_b_str[3] = {(unsigned char)(OUTPUT_LEN >> 8), (unsigned char)OUTPUT_LEN, 0x00};
+
+    // b_0 = H(Z_pad || msg || I2OSP(len_in_bytes, 2) || I2OSP(0, 1) || DST_prime)
+    unsigned char b_0[H::B_LEN];
+    typename H::CTX ctx = zpad_ctx;
+    H::Update(&ctx, msg, MSG_LEN);
+    H::Update(&ctx, len_i_b_str, 3);
+    H::Update(&ctx, dst.data(), dst.size());
+    H::Update(&ctx, &dst_len, 1);
+    H::Final(b_0, &ctx);
+
+    // b_i = H(strxor(b_0, b_{i-1}) || I2OSP(i, 1) || DST_prime)
+    unsigned char b_i[H::B_LEN] = {0};
+    size_t ELL = (OUTPUT_LEN + H::B_LEN - 1) / H::B_LEN;
+    for (auto i = 1; i <= ELL; i++){
+        for (auto j = 0; j < H::B_LEN; j++) b_i[j] ^= b_0[j];
+        unsigned char counter = (unsigned char)i;
+        H::Init(&ctx);
+        H::Update(&ctx, b_i, H::B_LEN);
+        H::Update(&ctx, &counter, 1);
+        H::Update(&ctx, dst.data(), dst.size());
+        H::Update(&ctx, &dst_len, 1);
+        H::Final(b_i, &ctx);
+        size_t COPY_LEN = std::min(H::B_LEN, OUTPUT_LEN - (i-1)*H::B_LEN);
+        memcpy(output + (i-1)*H::B_LEN, b_i, COPY_LEN);
+    }
+}
+
+
+/* simplified SWU for prime256v1 (RFC 9380 section 6.6.2 and appendix F.2) */
+
+inline bool ENABLE_SSWU = false; // true if the current curve is prime256v1 and the native backend is on
+inline FieldElement sswu_a, sswu_b, sswu_z, sswu_sqrt_minus_z;
+inline uint64_t sqrt_exponent[FIELD_LIMB_NUM]; // (p-3)/4
+
+inline void CMov(FieldElement &r, const FieldElement &b, bool flag)
+{
+    uint64_t mask = 0 - (uint64_t)flag;
+    for (auto i = 0; i < FIELD_LIMB_NUM; i++) r.limb[i] ^= mask & (r.limb[i] ^ b.limb[i]);
+}
+
+inline int Sgn0(const FieldElement &a)
+{
+    unsigned char buffer[32];
+    ECJacobian::field.ToBytes(buffer, a);
+    return buffer[31] & 1;
+}
+
+// reduce a 48-byte big-endian string modulo p: hi*2^256 + lo
+inline void BytesToFieldElement(FieldElement &r, const unsigned char *buffer)
+{
+    unsigned char hi_buffer[32] = {0};
+    memcpy(hi_buffer + 16, buffer, 16);
+    FieldElement hi, lo;
+    ECJacobian::field.FromBytes(hi, hi_buffer);   // hi*R
+    ECJacobian::field.Mul(hi, hi, ECJacobian::field.R2); // hi*2^256*R
+    ECJacobian::field.FromBytes(lo, buffer + 16);
+    ECJacobian::field.Add(r, hi, lo);
+}
+
+// sqrt_ratio for p = 3 mod 4 (appendix F.2.1.2): returns whether u/v is square
+inline bool SqrtRatio(FieldElement &y, const FieldElement &u, const FieldElement &v)
+{
+    const MontField &F = ECJacobian::field;
+    FieldElement tv1, tv2, tv3, y1, y2;
+    F.Sqr(tv1, v);
+    F.Mul(tv2, u, v);
+    F.Mul(tv1, tv1, tv2);
+    F.Exp(y1, tv1, sqrt_exponent, FIELD_LIMB_NUM);
+    F.Mul(y1, y1, tv2);
+    F.Mul(y2, y1, sswu_sqrt_minus_z);
+    F.Sqr(tv3, y1);
+    F.Mul(tv3, tv3, v);
+    bool is_square = F.IsEqual(tv3, u);
+    y = y2;
+    CMov(y, y1, is_square);
+    return is_square;
+}
+
+/*
+** straight-line map_to_curve_simple_swu (appendix F.2)
+** the output is left in Jacobian form with Z = the denominator of x, so no inversion is needed here
+*/
+inline void MapToCurveSSWU(JacobianPoint &R, const FieldElement &u)
+{
+    const MontField &F = ECJacobian::field;
+    FieldElement tv1, tv2, tv3, tv4, tv5, tv6, x, y, y1;
+    F.Sqr(tv1, u);
+    F.Mul(tv1, sswu_z, tv1);
+    F.Sqr(tv2, tv1);
+    F.Add(tv2, tv2, tv1);
+    F.Add(tv3, tv2, F.one);
+    F.Mul(tv3, sswu_b, tv3);
+    F.Neg(tv4, tv2);
+    CMov(tv4, sswu_z, F.IsZero(tv2));
+    F.Mul(tv4, sswu_a, tv4);
+    F.Sqr(tv2, tv3);
+    F.Sqr(tv6, tv4);
+    F.Mul(tv5, sswu_a, tv6);
+    F.Add(tv2, tv2, tv5);
+    F.Mul(tv2, tv2, tv3);
+    F.Mul(tv6, tv6, tv4);
+    F.Mul(tv5, sswu_b, tv6);
+    F.Add(tv2, tv2, tv5);
+    F.Mul(x, tv1, tv3);
+    bool is_gx1_square = SqrtRatio(y1, tv2, tv6);
+    F.Mul(y, tv1, u);
+    F.Mul(y, y, y1);
+    CMov(x, tv3, is_gx1_square);
+    CMov(y, y1, is_gx1_square);
+    FieldElement minus_y;
+    F.Neg(minus_y, y);
+    CMov(y, minus_y, Sgn0(u) != Sgn0(y));
+
+    // (x/tv4, y) = (X/Z^2, Y/Z^3) with Z = tv4
+    F.Mul(R.X, x, tv4);
+    F.Sqr(tv5, tv4);
+    F.Mul(tv5, tv5, tv4);
+    F.Mul(R.Y, y, tv5);
+    R.Z = tv4;
+}
+
+// hash_to_curve for P256_XMD:SHA-256_SSWU_RO_, the result is in Jacobian form
+inline void HashToP256(JacobianPoint &R, const unsigned char *msg, size_t MSG_LEN, const std::string &dst = DST_P256)
+{
+    unsigned char uniform_bytes[96];
+    ExpandMessageXMD<XMD_SHA256>(uniform_bytes, 96, msg, MSG_LEN, dst);
+    FieldElement u0, u1;
+    BytesToFieldElement(u0, uniform_bytes);
+    BytesToFieldElement(u1, uniform_bytes + 48);
+    JacobianPoint Q0, Q1;
+    MapToCurveSSWU(Q0, u0);
+    MapToCurveSSWU(Q1, u1);
+    ECJacobian::Add(R, Q0, Q1); // the cofactor of prime256v1 is 1
+}
+
+void Initialize()
+{
+    ENABLE_SSWU = (curve_id == NID_X9_62_prime256v1) && ECJacobian::ENABLE;
+    if (ENABLE_SSWU == false) return;
+
+    BN_CTX *ctx = BN_CTX_new();
+    BIGNUM *t = BN_new();
+    ECJacobian::field.FromBigNum(sswu_a, curve_params_a);
+    ECJacobian::field.FromBigNum(sswu_b, curve_params_b);
+    // Z = -10
+    BN_set_word(t, 10);
+    BN_sub(t, curve_params_p, t);
+    ECJacobian::field.FromBigNum(sswu_z, t);
+    // (p-3)/4
+    BN_sub(t, curve_params_p, BN_value_one());
+    BN_sub(t, t, BN_value_one());
+    BN_sub(t, t, BN_value_one());
+    BN_rshift(t, t, 2);
+    BN_bn2lebinpad(t, reinterpret_cast<unsigned char*>(sqrt_exponent), 8*FIELD_LIMB_NUM);
+    // sqrt(-Z) = 10^{(p+1)/4} = 10^{(p-3)/4} * 10
+    FieldElement ten;
+    BN_set_word(t, 10);
+    ECJacobian::field.FromBigNum(ten, t);
+    ECJacobian::field.Exp(sswu_sqrt_minus_z, ten, sqrt_exponent, FIELD_LIMB_NUM);
+    ECJacobian::field.Mul(sswu_sqrt_minus_z, sswu_sqrt_minus_z, ten);
+    BN_free(t);
+    BN_CTX_free(ctx);
+}
+
+
+/* Elligator2 for curve25519 (RFC 9380 section 6.7.1), on the radix-2^51 field of ec_ristretto.hpp */
+
+// reduce a 48-byte big-endian string modulo 2^255-19: a + b*2^255 = a + 19*b
+inline void BytesToFE25519(FE25519 &r, const unsigned char *buffer)
+{
+    unsigned char le[48];
+    for (auto i = 0; i < 48; i++) le[i] = buffer[47-i];
+    FE25519 a, b, nineteen = {{19, 0, 0, 0, 0}};
+    Ristretto::FromBytes(a, le); // ignores bit 255
+    // b = bits [255, 384)
+    unsigned char b_bytes[32] = {0};
+    for (auto i = 0; i < 17; i++) b_bytes[i] = (le[31+i] >> 7) | (i+32 < 48 ? (le[32+i] << 1) : 0);
+    Ristretto::FromBytes(b, b_bytes);
+    Ristretto::Mul(b, b, nineteen);
+    Ristretto::Add(r, a, b);
+}
+
+// denominator of x1 = -J/(1+Z*u^2) with Z = 2; set to 1 in the exceptional case 1+2u^2 = 0
+inline void Elligator2Denominator(FE25519 &d, const FE25519 &u)
+{
+    FE25519 tv1;
+    Ristretto::Sqr(tv1, u);
+    Ristretto::Add(tv1, tv1, tv1);
+    Ristretto::Add(d, tv1, Ristretto::fe_one);
+    Ristretto::CMov(d, Ristretto::fe_one, Ristretto::IsZero(d));
+}
+
+// u-coordinate of map_to_curve_elligator2, given the inverse of the denominator
+inline void Elligator2(unsigned char *buffer, const FE25519 &d_inverse)
+{
+    const FE25519 J = {{486662, 0, 0, 0, 0}};
+    FE25519 x1, x2, gx1, t;
+    Ristretto::Mul(x1, J, d_inverse);
+    Ristretto::Neg(x1, x1);
+    // gx1 = x1^3 + J*x1^2 + x1
+    Ristretto::Add(gx1, x1, J);
+    Ristretto::Mul(gx1, gx1, x1);
+    Ristretto::Add(gx1, gx1, Ristretto::fe_one);
+    Ristretto::Mul(gx1, gx1, x1);
+    // x2 = -x1 - J
+    Ristretto::Add(x2, x1, J);
+    Ristretto::Neg(x2, x2);
+    // Legendre symbol gx1^{(p-1)/2} = (gx1^{(p-5)/8})^4 * gx1^2; gx1 is never 0
+    Ristretto::Pow22523(t, gx1);
+    Ristretto::SqrTimes(t, t, 2);
+    Ristretto::Mul(t, t, gx1);
+    Ristretto::Mul(t, t, gx1);
+    Ristretto::CMov(x2, x1, Ristretto::IsEqual(t, Ristretto::fe_one));
+    Ristretto::ToBytes(buffer, x2);
+}
+
+// encode_to_curve for curve25519_XMD:SHA-512_ELL2_NU_ without clear_cofactor: LEN messages of MSG_LEN bytes each
+void HashToCurve25519(unsigned char *output, const unsigned char *msg, size_t MSG_LEN, size_t LEN, const std::string &dst = DST_CURVE25519)
+{
+    std::vector<FE25519> vec_d(LEN);
+    unsigned char uniform_bytes[48];
+    FE25519 u;
+    for (auto i = 0; i < LEN; i++){
+        ExpandMessageXMD<XMD_SHA512>(uniform_bytes, 48, msg + i*MSG_LEN, MSG_LEN, dst);
+        BytesToFE25519(u, uniform_bytes);
+        Elligator2Denominator(vec_d[i], u);
+    }
+    // Montgomery's trick: the denominators are never 0
+    std::vector<FE25519> prefix(LEN);
+    FE25519 acc = Ristretto::fe_one;
+    for (auto i = 0; i < LEN; i++){
+        Ristretto::Mul(acc, acc, vec_d[i]);
+        prefix[i] = acc;
+    }
+    FE25519 acc_inverse, d_inverse;
+    Ristretto::Inv(acc_inverse, acc);
+    for (auto i = LEN; i > 0; i--){
+        if (i > 1) Ristretto::Mul(d_inverse, acc_inverse, prefix[i-2]);
+        else d_inverse = acc_inverse;
+        Ristretto::Mul(acc_inverse, acc_inverse, vec_d[i-1]);
+        Elligator2(output + (i-1)*32, d_inverse);
+    }
+}
+
+}
+
+#endif
@@ -7,6 +7,7 @@
 #define KUNLUN_CRYPTO_PRG_HPP_
 
 #include "aes.hpp"
+#include "../utility/bit_vector.hpp"
 
 #ifdef ENABLE_RDSEED
 #include <x86intrin.h>
@@ -90,44 +91,83 @@ Seed SetSeed(const void* salt = nullptr, uint64_t id = 0) {
     return seed; 
 }
 
-std::vector<block> GenRandomBlocks(Seed &seed, size_t LEN)
-{
-    std::vector<block> vec_b(LEN); 
-    block temp_block[AES::BATCH_SIZE];
-    for(auto i = 0; i < LEN/AES::BATCH_SIZE; i++){
-        for (auto j = 0; j < AES::BATCH_SIZE; j++)
-            temp_block[j] = Block::MakeBlock(0LL, seed.counter++);
-        AES::FastECBEnc(seed.aes_key, temp_block, AES::BATCH_SIZE);
-        memcpy(vec_b.data() + i*AES::BATCH_SIZE, temp_block, AES::BATCH_SIZE*sizeof(block));
-    }
-    size_t REMAIN_LEN = LEN % AES::BATCH_SIZE;
-    for (auto j = 0; j < REMAIN_LEN; j++)
-        temp_block[j] = Block::MakeBlock(0LL, seed.counter++);
-    AES::FastECBEnc(seed.aes_key, temp_block, REMAIN_LEN);
-    memcpy(vec_b.data()+(LEN/AES::BATCH_SIZE)*AES::BATCH_SIZE, temp_block, REMAIN_LEN*sizeof(block));
+/*
+** the PRG is AES in counter mode: the i-th output block is Enc(key, i), i = seed.counter, seed.counter+1, ...
+** since every block depends on its counter only, the stream can be seeked, cut into disjoint
+** sub-streams and filled by several threads with exactly the output of a sequential run
+*/
 
-    return vec_b; 
+// move the stream to a given position
+inline void Seek(Seed &seed, size_t counter)
+{
+    seed.counter = counter;
 }
 
+// encrypt the counters [counter, counter + LEN) into output
+inline void FillCounterRange(const AES::Key &key, size_t counter, block *output, size_t LEN)
+{
+    // work in L1-sized pieces: write the counters, then encrypt them in place
+    const size_t PIECE_LEN = 1024;
+    for (auto i = 0; i < LEN; i += PIECE_LEN){
+        size_t CURRENT_LEN = std::min(PIECE_LEN, LEN - i);
+        for (auto j = 0; j < CURRENT_LEN; j++)
+            output[i+j] = Block::MakeBlock(0LL, counter + i + j);
+        AES::FastECBEnc(key, output + i, CURRENT_LEN);
+    }
+}
 
-// generate a random byte vector
-std::vector<uint8_t> GenRandomBytes(Seed &seed, size_t LEN){
-    std::vector<uint8_t> vec_b(LEN);
-    size_t BLOCK_LEN = size_t(ceil(double(LEN)/16)); 
-    std::vector<block> vec_a(BLOCK_LEN); 
-    vec_a = GenRandomBlocks(seed, BLOCK_LEN);
+// write the next LEN blocks of the stream to output; large fills are shared among threads
+void Fill(Seed &seed, block *output, size_t LEN)
+{
+    size_t THREAD_NUM = omp_in_parallel() ? 1 : std::max<size_t>(1, std::min(NUMBER_OF_THREADS, LEN/(1024*16)));
+    size_t CHUNK_LEN = (LEN + THREAD_NUM - 1) / THREAD_NUM;
+
+    #pragma omp parallel for num_threads(THREAD_NUM)
+    for (auto t = 0; t < THREAD_NUM; t++){
+        size_t begin = t * CHUNK_LEN;
+        size_t end = std::min(LEN, begin + CHUNK_LEN);
+        if (begin < end) FillCounterRange(seed.aes_key, seed.counter + begin, output + begin, end - begin);
+    }
+    seed.counter += LEN;
+}
 
-    memcpy(vec_b.data(), vec_a.data(), LEN); 
+/*
+** cut the next STREAM_NUM*STREAM_LEN blocks of seed into STREAM_NUM disjoint sub-streams of STREAM_LEN blocks:
+** sub-stream i starts at counter seed.counter + i*STREAM_LEN, so their outputs laid end to end
+** equal the sequential output; seed itself moves past all of them
+*/
+std::vector<Seed> Split(Seed &seed, size_t STREAM_NUM, size_t STREAM_LEN)
+{
+    std::vector<Seed> vec_seed(STREAM_NUM, seed);
+    for (auto i = 0; i < STREAM_NUM; i++) vec_seed[i].counter = seed.counter + i * STREAM_LEN;
+    seed.counter += STREAM_NUM * STREAM_LEN;
+    return vec_seed;
+}
 
+std::vector<block> GenRandomBlocks(Seed &seed, size_t LEN)
+{
+    std::vector<block> vec_b(LEN); 
+    Fill(seed, vec_b.data(), LEN);
     return vec_b; 
 }
 
+
 // generate a random byte vector
 void GenRandomBytes(Seed &seed, uint8_t *output, size_t LEN){
-    size_t BLOCK_LEN = size_t(ceil(double(LEN)/16)); 
-    std::vector<block> vec_a(BLOCK_LEN); 
-    vec_a = GenRandomBlocks(seed, BLOCK_LEN);
-    memcpy(output, vec_a.data(), LEN); 
+    size_t BLOCK_LEN = (LEN + 15) / 16;
+    // fill an aligned output of whole blocks directly, anything else through a temporary buffer
+    if (reinterpret_cast<uintptr_t>(output) % sizeof(block) == 0 && LEN % 16 == 0) Fill(seed, (block *)output, BLOCK_LEN);
+    else{
+        std::vector<block> vec_a = GenRandomBlocks(seed, BLOCK_LEN);
+        memcpy(output, vec_a.data(), LEN); 
+    }
+}
+
+// generate a random byte vector
+std::vector<uint8_t> GenRandomBytes(Seed &seed, size_t LEN){
+    std::vector<uint8_t> vec_b(LEN);
+    GenRandomBytes(seed, vec_b.data(), LEN);
+    return vec_b; 
 }
 
 // generate a random bool vector: each byte represent a bit in a sparse way
@@ -141,6 +181,15 @@ std::vector<uint8_t> GenRandomBits(Seed &seed, size_t LEN)
     return vec_b; 
 }
 
+// generate a packed random bit vector
+BitVector GenRandomBitVector(Seed &seed, size_t LEN)
+{
+    BitVector vec_b(LEN);
+    GenRandomBytes(seed, (uint8_t *)vec_b.Data(), vec_b.WordNum() * sizeof(uint64_t));
+    vec_b.ClearPadding();
+    return vec_b;
+}
+
 // generate a random bit matrix (store in column vector order) in byte form
 // std::vector<uint8_t> GenRandomBitMatrix(Seed &seed, size_t ROW_NUM, size_t COLUMN_NUM)
 // {
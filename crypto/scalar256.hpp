@@ -0,0 +1,363 @@
+/****************************************************************************
+this hpp implements Scalar256: a stack-allocated element of Z_order
+(the scalar field of the current EC group) stored as 4x64-bit limbs in Montgomery form
+it reuses the Montgomery kernels of the native EC backend, so none of the arithmetic
+below touches the heap or a BN_CTX
+the ScalarVector* functions at the bottom take/return BigInt vectors, work modulo order
+and run on Scalar256 whenever the order fits in 256 bits
+*****************************************************************************
+* @copyright  MIT license (see LICENSE file)
+*****************************************************************************/
+#ifndef KUNLUN_SCALAR256_HPP_
+#define KUNLUN_SCALAR256_HPP_
+
+#include "ec_jacobian.hpp"
+
+namespace ScalarField{
+
+inline MontField field;     // Z_order
+inline bool ENABLE = false; // false if the order does not fit in 256 bits
+
+void Initialize()
+{
+    ENABLE = field.Initialize(order);
+}
+
+}
+
+class Scalar256{
+public:
+    FieldElement value; // Montgomery form
+
+    Scalar256() { this->value = ScalarField::field.zero; }
+    Scalar256(const BigInt &a) { this->FromBigInt(a); }
+    explicit Scalar256(uint64_t a);
+
+    // any BigInt is accepted and reduced modulo order
+    void FromBigInt(const BigInt &a);
+    BigInt ToBigInt() const;
+    void ToBigInt(BigInt &result) const;
+
+    inline bool IsZero() const { return ScalarField::field.IsZero(this->value); }
+    inline bool operator==(const Scalar256 &other) const { return ScalarField::field.IsEqual(this->value, other.value); }
+    inline bool operator!=(const Scalar256 &other) const { return !(*this == other); }
+
+    inline Scalar256 operator+(const Scalar256 &other) const;
+    inline Scalar256 operator-(const Scalar256 &other) const;
+    inline Scalar256 operator*(const Scalar256 &other) const;
+    inline Scalar256 operator-() const;
+
+    inline Scalar256& operator+=(const Scalar256 &other);
+    inline Scalar256& operator-=(const Scalar256 &other);
+    inline Scalar256& operator*=(const Scalar256 &other);
+
+    inline Scalar256 Square() const;
+    // Returns 0 for 0
+    Scalar256 Inverse() const;
+};
+
+// a Scalar256 array can be handed to the MontField kernels as a FieldElement array
+static_assert(sizeof(Scalar256) == sizeof(FieldElement), "Scalar256 must not carry extra members");
+
+Scalar256::Scalar256(uint64_t a)
+{
+    FieldElement t = ScalarField::field.zero;
+    t.limb[0] = a;
+    // a < 2^64 < order, so a single multiplication by R^2 brings it to Montgomery form
+    ScalarField::field.Mul(this->value, t, ScalarField::field.R2);
+}
+
+void Scalar256::FromBigInt(const BigInt &a)
+{
+    if (BN_is_negative(a.bn_ptr) || BN_cmp(a.bn_ptr, order) >= 0){
+        BigInt a_mod;
+        CRYPTO_CHECK(1 == BN_nnmod(a_mod.bn_ptr, a.bn_ptr, order, GetBNCtx()));
+        ScalarField::field.FromBigNum(this->value, a_mod.bn_ptr);
+    }
+    else ScalarField::field.FromBigNum(this->value, a.bn_ptr);
+}
+
+BigInt Scalar256::ToBigInt() const
+{
+    BigInt result;
+    this->ToBigInt(result);
+    return result;
+}
+
+void Scalar256::ToBigInt(BigInt &result) const
+{
+    ScalarField::field.ToBigNum(result.bn_ptr, this->value);
+}
+
+inline Scalar256 Scalar256::operator+(const Scalar256 &other) const
+{
+    Scalar256 result;
+    ScalarField::field.Add(result.value, this->value, other.value);
+    return result;
+}
+
+inline Scalar256 Scalar256::operator-(const Scalar256 &other) const
+{
+    Scalar256 result;
+    ScalarField::field.Sub(result.value, this->value, other.value);
+    return result;
+}
+
+inline Scalar256 Scalar256::operator*(const Scalar256 &other) const
+{
+    Scalar256 result;
+    ScalarField::field.Mul(result.value, this->value, other.value);
+    return result;
+}
+
+inline Scalar256 Scalar256::operator-() const
+{
+    Scalar256 result;
+    ScalarField::field.Neg(result.value, this->value);
+    return result;
+}
+
+inline Scalar256& Scalar256::operator+=(const Scalar256 &other)
+{
+    ScalarField::field.Add(this->value, this->value, other.value);
+    return *this;
+}
+
+inline Scalar256& Scalar256::operator-=(const Scalar256 &other)
+{
+    ScalarField::field.Sub(this->value, this->value, other.value);
+    return *this;
+}
+
+inline Scalar256& Scalar256::operator*=(const Scalar256 &other)
+{
+    ScalarField::field.Mul(this->value, this->value, other.value);
+    return *this;
+}
+
+inline Scalar256 Scalar256::Square() const
+{
+    Scalar256 result;
+    ScalarField::field.Sqr(result.value, this->value);
+    return result;
+}
+
+Scalar256 Scalar256::Inverse() const
+{
+    Scalar256 result;
+    ScalarField::field.Inv(result.value, this->value);
+    return result;
+}
+
+
+/* vector operations over Scalar256 */
+
+std::vector<Scalar256> BigIntVectorToScalar256Vector(const std::vector<BigInt> &vec_a)
+{
+    size_t LEN = vec_a.size();
+    std::vector<Scalar256> vec_result(LEN);
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for (auto i = 0; i < LEN; i++) vec_result[i].FromBigInt(vec_a[i]);
+    return vec_result;
+}
+
+std::vector<BigInt> Scalar256VectorToBigIntVector(const std::vector<Scalar256> &vec_a)
+{
+    size_t LEN = vec_a.size();
+    std::vector<BigInt> vec_result(LEN);
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for (auto i = 0; i < LEN; i++) vec_a[i].ToBigInt(vec_result[i]);
+    return vec_result;
+}
+
+/*
+** invert the whole vector in place: every thread handles a chunk with Montgomery's trick,
+** so the cost is one inversion per chunk plus 3 multiplications per element; zeros stay zero
+*/
+void Scalar256VectorBatchInverse(std::vector<Scalar256> &vec_a)
+{
+    size_t LEN = vec_a.size();
+    size_t THREAD_NUM = omp_in_parallel() ? 1 : std::max<size_t>(1, std::min(NUMBER_OF_THREADS, LEN/64));
+    size_t CHUNK_LEN = (LEN + THREAD_NUM - 1) / THREAD_NUM;
+
+    #pragma omp parallel for num_threads(THREAD_NUM)
+    for (auto t = 0; t < THREAD_NUM; t++){
+        size_t begin = t * CHUNK_LEN;
+        size_t end = std::min(LEN, begin + CHUNK_LEN);
+        if (begin >= end) continue;
+        FieldElement *chunk = &vec_a[begin].value;
+        ScalarField::field.BatchInv(chunk, chunk, end - begin);
+    }
+}
+
+/* sum_i a[i]*b[i] */
+Scalar256 Scalar256VectorInnerProduct(const std::vector<Scalar256> &vec_a, const std::vector<Scalar256> &vec_b)
+{
+    if (vec_a.size() != vec_b.size()){
+        std::cerr << "vector size does not match!" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    Scalar256 result;
+    FieldElement product;
+    for (auto i = 0; i < vec_a.size(); i++){
+        ScalarField::field.Mul(product, vec_a[i].value, vec_b[i].value);
+        ScalarField::field.Add(result.value, result.value, product);
+    }
+    return result;
+}
+
+/* generate a^n = (a^0, a^1, a^2, ..., a^{n-1}) */
+std::vector<Scalar256> GenScalar256PowerVector(size_t LEN, const Scalar256 &a)
+{
+    std::vector<Scalar256> vec_result(LEN);
+    if (LEN == 0) return vec_result;
+    vec_result[0] = Scalar256(uint64_t(1));
+    for (auto i = 1; i < LEN; i++) vec_result[i] = vec_result[i-1] * a;
+    return vec_result;
+}
+
+
+/*
+** fill vec_a with LEN uniform random scalars, drawn like GenRandomBigIntVectorLessThan from per-thread
+** AES PRGs by rejection sampling, but compared and converted on limbs without ever building a BIGNUM
+*/
+void GenRandomScalar256Vector(Scalar256 *vec_a, size_t LEN)
+{
+    const uint64_t *modulus = ScalarField::field.modulus;
+    size_t TOP_LIMB = FIELD_LIMB_NUM - 1;
+    while (TOP_LIMB > 0 && modulus[TOP_LIMB] == 0) TOP_LIMB--;
+    uint64_t TOP_MASK = ~uint64_t(0) >> __builtin_clzll(modulus[TOP_LIMB]);
+
+    size_t THREAD_NUM = omp_in_parallel() ? 1 : std::max<size_t>(1, std::min(NUMBER_OF_THREADS, LEN/64));
+    size_t CHUNK_LEN = (LEN + THREAD_NUM - 1) / THREAD_NUM;
+
+    #pragma omp parallel for num_threads(THREAD_NUM)
+    for (auto t = 0; t < THREAD_NUM; t++){
+        size_t begin = t * CHUNK_LEN;
+        size_t end = std::min(LEN, begin + CHUNK_LEN);
+        if (begin >= end) continue;
+
+        PRG::Seed seed = PRG::SetSeed(nullptr, t);
+        std::vector<block> vec_candidate;
+        size_t used = 0, available = 0;
+        FieldElement a;
+        for (auto i = begin; i < end; i++){
+            while (true){
+                if (used == available){
+                    available = 2*(end - i) + 8;
+                    vec_candidate = PRG::GenRandomBlocks(seed, 2*available); // 2 blocks per candidate
+                    used = 0;
+                }
+                memcpy(a.limb, vec_candidate.data() + 2*used, sizeof(FieldElement));
+                used++;
+                for (auto j = TOP_LIMB + 1; j < FIELD_LIMB_NUM; j++) a.limb[j] = 0;
+                a.limb[TOP_LIMB] &= TOP_MASK;
+
+                // accept iff a < modulus, compared from the most significant limb
+                int j = TOP_LIMB;
+                while (j > 0 && a.limb[j] == modulus[j]) j--;
+                if (a.limb[j] < modulus[j]) break;
+            }
+            // a < modulus, so one multiplication by R^2 brings it to Montgomery form
+            ScalarField::field.Mul(vec_a[i].value, a, ScalarField::field.R2);
+        }
+    }
+}
+
+std::vector<Scalar256> GenRandomScalar256Vector(size_t LEN)
+{
+    std::vector<Scalar256> vec_result(LEN);
+    GenRandomScalar256Vector(vec_result.data(), LEN);
+    return vec_result;
+}
+
+
+/*
+** BigInt vector operations modulo order
+** the inputs are converted once, the arithmetic is done on Scalar256 and the results converted back;
+** the BigInt path is kept for groups whose order exceeds 256 bits
+*/
+
+/* sum_i a[i]*b[i] mod order */
+BigInt ScalarVectorInnerProduct(std::vector<BigInt> &vec_a, std::vector<BigInt> &vec_b)
+{
+    if (!ScalarField::ENABLE) return BigIntVectorModInnerProduct(vec_a, vec_b, BigInt(order));
+    return Scalar256VectorInnerProduct(BigIntVectorToScalar256Vector(vec_a), BigIntVectorToScalar256Vector(vec_b)).ToBigInt();
+}
+
+/* result[i] = a[i]*b[i] mod order */
+std::vector<BigInt> ScalarVectorProduct(std::vector<BigInt> &vec_a, std::vector<BigInt> &vec_b)
+{
+    if (!ScalarField::ENABLE) return BigIntVectorModProduct(vec_a, vec_b, BigInt(order));
+    if (vec_a.size() != vec_b.size()){
+        std::cerr << "vector size does not match!" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    size_t LEN = vec_a.size();
+    std::vector<BigInt> vec_result(LEN);
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for (auto i = 0; i < LEN; i++){
+        (Scalar256(vec_a[i]) * Scalar256(vec_b[i])).ToBigInt(vec_result[i]);
+    }
+    return vec_result;
+}
+
+/* result[i] = c*a[i] mod order */
+std::vector<BigInt> ScalarVectorScalar(std::vector<BigInt> &vec_a, BigInt &c)
+{
+    if (!ScalarField::ENABLE) return BigIntVectorModScalar(vec_a, c, BigInt(order));
+    size_t LEN = vec_a.size();
+    std::vector<BigInt> vec_result(LEN);
+    Scalar256 s_c(c);
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for (auto i = 0; i < LEN; i++){
+        (Scalar256(vec_a[i]) * s_c).ToBigInt(vec_result[i]);
+    }
+    return vec_result;
+}
+
+/* result[i] = x*a[i] + y*b[i] mod order: the folding step of the inner product argument */
+std::vector<BigInt> ScalarVectorFold(std::vector<BigInt> &vec_a, std::vector<BigInt> &vec_b, BigInt &x, BigInt &y)
+{
+    if (vec_a.size() != vec_b.size()){
+        std::cerr << "vector size does not match!" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    size_t LEN = vec_a.size();
+    if (!ScalarField::ENABLE){
+        std::vector<BigInt> vec_xa = BigIntVectorModScalar(vec_a, x, BigInt(order));
+        std::vector<BigInt> vec_yb = BigIntVectorModScalar(vec_b, y, BigInt(order));
+        return BigIntVectorModAdd(vec_xa, vec_yb, BigInt(order));
+    }
+    std::vector<BigInt> vec_result(LEN);
+    Scalar256 s_x(x), s_y(y);
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for (auto i = 0; i < LEN; i++){
+        (Scalar256(vec_a[i]) * s_x + Scalar256(vec_b[i]) * s_y).ToBigInt(vec_result[i]);
+    }
+    return vec_result;
+}
+
+/* result[i] = a[i]^{-1} mod order */
+std::vector<BigInt> ScalarVectorInverse(std::vector<BigInt> &vec_a)
+{
+    if (!ScalarField::ENABLE) return BigIntVectorModInverse(vec_a, BigInt(order));
+    std::vector<Scalar256> vec_s = BigIntVectorToScalar256Vector(vec_a);
+    Scalar256VectorBatchInverse(vec_s);
+    return Scalar256VectorToBigIntVector(vec_s);
+}
+
+/* generate a^n = (a^0, a^1, a^2, ..., a^{n-1}) mod order */
+std::vector<BigInt> GenScalarPowerVector(size_t LEN, const BigInt &a)
+{
+    if (!ScalarField::ENABLE){
+        std::vector<BigInt> vec_result(LEN);
+        BigInt bn_order(order);
+        if (LEN > 0) vec_result[0] = bn_1;
+        for (auto i = 1; i < LEN; i++) ModMulInto(vec_result[i], vec_result[i-1], a, bn_order);
+        return vec_result;
+    }
+    return Scalar256VectorToBigIntVector(GenScalar256PowerVector(LEN, Scalar256(a)));
+}
+
+#endif
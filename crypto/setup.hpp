@@ -13,6 +13,10 @@ this hpp file define and initialize misc global variables
 
 #include "bigint.hpp"
 #include "ec_group.hpp"
+#include "ec_jacobian.hpp"
+#include "scalar256.hpp"
+#include "ec_ristretto.hpp"
+#include "hash_to_curve.hpp"
 #include "hash.hpp"
 #include "prg.hpp"
 #include "block.hpp"
@@ -22,38 +26,50 @@ void CRYPTO_Initialize()
 {
     BN_Initialize();
     ECGroup_Initialize(); 
+    ECJacobian::Initialize(); // native backend of multi-scalar multiplication
+    ScalarField::Initialize(); // native arithmetic modulo order for Scalar256
+    Ristretto_Initialize(); // ristretto255 constants and basepoint table
+    HashToCurve::Initialize(); // SSWU constants, needs the native backend
     AES_Initialize();   // does not need Finalize() 
 
     /* 
-    * set number of threads to ensure thread_number obtained via omp_get_thread_no() lies in [0, NUMBER_OF_THREADS)  
-    * otherwise segmentation fault may occur when a thread i attempts to access bn_ctx[i], whose memory is not allocated
+    * BN_CTX is thread local, so any number of threads (openmp or not) is safe;
+    * NUMBER_OF_THREADS only sets the default team size and can be changed later via SetNumberOfThreads()
     */
     omp_set_num_threads(NUMBER_OF_THREADS); 
 
-    PrintSplitLine('-'); 
-    std::cout << "GLOBAL ENVIROMENT INFO >>>" << std::endl;
-    std::cout << "NUM OF THREADS = " << NUMBER_OF_THREADS << std::endl;
+    // silent unless PROTOCOL_LOG is set, like the progress messages of the protocols
+    LogSplitLine('-'); 
+    ProtocolLog() << "GLOBAL ENVIROMENT INFO >>>" << std::endl;
+    ProtocolLog() << "NUM OF THREADS = " << NUMBER_OF_THREADS << std::endl;
+    ProtocolLog() << "AES BACKEND = " << AES::BackendName(AES::backend) << std::endl;
+    ProtocolLog() << "SHA256 BACKEND = " << MultiSHA256::BackendName(MultiSHA256::backend) << std::endl;
 
-    std::cout << "EC Curve ID = " << curve_id << std::endl;
-    std::cout << "ECPoint COMPRESSION = "; 
+    ProtocolLog() << "EC Curve ID = " << curve_id << std::endl;
+    ProtocolLog() << "ECPoint COMPRESSION = "; 
     #ifdef ECPOINT_COMPRESSED
-        std::cout << "ON" << std::endl;
+        ProtocolLog() << "ON" << std::endl;
     #else
-        std::cout << "OFF" << std::endl;
+        ProtocolLog() << "OFF" << std::endl;
     #endif
     
+    #ifdef ENABLE_RISTRETTO_GROUP
+        ProtocolLog() << "ElGamal, Naor-Pinkas OT and DDH-based PEQT run on ristretto255; NIZK proofs, Bulletproofs and ADCP stay on EC Curve ID " << curve_id << std::endl; 
+    #endif
+
     #ifdef ENABLE_X25519_ACCELERATION
-        PrintSplitLine('-');  
-        std::cout << "Accelerate ***somewhat*** EC exponentiation using x25519 method powerd by Curve25519 >>>" << std::endl; 
+        LogSplitLine('-');  
+        ProtocolLog() << "Accelerate ***somewhat*** EC exponentiation using x25519 method powerd by Curve25519 >>>" << std::endl; 
     #endif
 
-    PrintSplitLine('-');  
+    LogSplitLine('-');  
 }
 
 void CRYPTO_Finalize()
 {
     BN_Finalize();
     ECGroup_Finalize();
+    Ristretto_Finalize();
 } 
 
 #endif
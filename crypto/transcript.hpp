@@ -0,0 +1,107 @@
+/****************************************************************************
+this hpp implements the Fiat-Shamir transcript shared by the NIZK proofs and Bulletproofs
+the transcript keeps a running SHA-256 state: appending a message absorbs it once, and a challenge
+finalizes a copy of the state, so deriving a challenge costs O(1) instead of rehashing everything so far
+every message is framed as len(label) || label || len(data) || data, which rules out ambiguous concatenations
+a challenge is absorbed back into the transcript, so two successive challenges are never equal
+*****************************************************************************
+* @copyright  MIT license (see LICENSE file)
+*****************************************************************************/
+#ifndef KUNLUN_CRYPTO_TRANSCRIPT_HPP_
+#define KUNLUN_CRYPTO_TRANSCRIPT_HPP_
+
+#include "ec_point.hpp"
+#include "hash.hpp"
+
+class Transcript{
+public:
+    // the label is the domain separator of the whole protocol
+    explicit Transcript(const std::string &label = "Kunlun transcript");
+
+    void Append(const std::string &label, const unsigned char *data, size_t LEN);
+    void Append(const std::string &label, const std::string &str);
+    void Append(const std::string &label, const ECPoint &A);
+    void Append(const std::string &label, const BigInt &a);
+
+    // mark the start of a sub-protocol, e.g. each proof of a chain shares one transcript
+    inline void DomainSeparate(const std::string &label) { this->Append("dom-sep", label); }
+
+    // a 256-bit challenge (not reduced, as Hash::StringToBigInt)
+    BigInt Challenge(const std::string &label);
+
+    // an independent copy continuing from the current state, e.g. one per parallel sub-proof
+    Transcript Fork(const std::string &label) const;
+
+private:
+    SHA256_CTX ctx;
+
+    inline void Absorb(const void *data, size_t LEN) { SHA256_Update(&this->ctx, data, LEN); }
+    inline void AbsorbLength(uint64_t LEN) { this->Absorb(&LEN, sizeof(LEN)); }
+};
+
+Transcript::Transcript(const std::string &label)
+{
+    SHA256_Init(&this->ctx);
+    this->Append("Kunlun", label);
+}
+
+void Transcript::Append(const std::string &label, const unsigned char *data, size_t LEN)
+{
+    this->AbsorbLength(label.size());
+    this->Absorb(label.data(), label.size());
+    this->AbsorbLength(LEN);
+    this->Absorb(data, LEN);
+}
+
+void Transcript::Append(const std::string &label, const std::string &str)
+{
+    this->Append(label, reinterpret_cast<const unsigned char*>(str.data()), str.size());
+}
+
+// same bytes as ECPoint::ToByteString, without the temporary string
+void Transcript::Append(const std::string &label, const ECPoint &A)
+{
+    unsigned char buffer[POINT_COMPRESSED_BYTE_LEN];
+    memset(buffer, 0, POINT_COMPRESSED_BYTE_LEN);
+    EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_COMPRESSED, buffer, POINT_COMPRESSED_BYTE_LEN, GetBNCtx());
+    this->Append(label, buffer, POINT_COMPRESSED_BYTE_LEN);
+}
+
+// same bytes as BigInt::ToByteString
+void Transcript::Append(const std::string &label, const BigInt &a)
+{
+    // zero has an empty encoding; scalars and coordinates of any OpenSSL curve (66 bytes for P-521) fit on the stack
+    const size_t STACK_BUFFER_LEN = 80;
+    unsigned char stack_buffer[STACK_BUFFER_LEN];
+    std::vector<unsigned char> heap_buffer;
+    unsigned char *buffer = stack_buffer;
+    size_t LEN = a.GetByteLength();
+    if (LEN > STACK_BUFFER_LEN){
+        heap_buffer.resize(LEN);
+        buffer = heap_buffer.data();
+    }
+    BN_bn2bin(a.bn_ptr, buffer);
+    this->Append(label, buffer, LEN);
+}
+
+BigInt Transcript::Challenge(const std::string &label)
+{
+    this->Append("challenge", label);
+    SHA256_CTX ctx_copy = this->ctx;
+    unsigned char digest[HASH_OUTPUT_LEN];
+    SHA256_Final(digest, &ctx_copy);
+    this->Append(label, digest, HASH_OUTPUT_LEN);
+
+    BigInt e;
+    BN_bin2bn(digest, HASH_OUTPUT_LEN, e.bn_ptr);
+    return e;
+}
+
+Transcript Transcript::Fork(const std::string &label) const
+{
+    Transcript fork = *this;
+    fork.Append("fork", label);
+    return fork;
+}
+
+#endif
@@ -153,16 +153,15 @@ template <>
 #endif
 inline void Insert(const ECPoint &A)
 {
-   int thread_num = omp_get_thread_num();
    #ifdef ECPOINT_COMPRESSED
       unsigned char buffer[POINT_COMPRESSED_BYTE_LEN];
       memset(buffer, 0, POINT_COMPRESSED_BYTE_LEN);  
-      EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_COMPRESSED, buffer, POINT_COMPRESSED_BYTE_LEN, bn_ctx[thread_num]);
+      EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_COMPRESSED, buffer, POINT_COMPRESSED_BYTE_LEN, GetBNCtx());
       PlainInsert(buffer, POINT_COMPRESSED_BYTE_LEN);
    #else
       unsigned char buffer[POINT_BYTE_LEN]; 
       memset(buffer, 0, POINT_BYTE_LEN); 
-      EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_UNCOMPRESSED, buffer, POINT_BYTE_LEN, bn_ctx[thread_num]);
+      EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_UNCOMPRESSED, buffer, POINT_BYTE_LEN, GetBNCtx());
       PlainInsert(buffer, POINT_BYTE_LEN);
    #endif
 }
@@ -192,10 +191,12 @@ template <>
 #endif
 inline void Insert(const std::vector<ECPoint> &vec_A)
 {   
-   //sequential implementation
+   // serialize the whole batch first: one field inversion per thread instead of one per point
+   size_t POINT_LEN = ECPointSerializedByteLen(); 
+   std::vector<unsigned char> buffer = ECPointVectorToBytes(vec_A); 
    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
    for(auto i = 0; i < vec_A.size(); i++){
-      Insert(vec_A[i]); 
+      PlainInsert(buffer.data() + i*POINT_LEN, POINT_LEN); 
    }
 }
 
@@ -238,16 +239,15 @@ template <>
 #endif
 inline bool Contain(const ECPoint& A) const
 {
-   int thread_num = omp_get_thread_num();
    #ifdef ECPOINT_COMPRESSED
       unsigned char buffer[POINT_COMPRESSED_BYTE_LEN];
       memset(buffer, 0, POINT_COMPRESSED_BYTE_LEN);  
-      EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_COMPRESSED, buffer, POINT_COMPRESSED_BYTE_LEN, bn_ctx[thread_num]);
+      EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_COMPRESSED, buffer, POINT_COMPRESSED_BYTE_LEN, GetBNCtx());
       return PlainContain(buffer, POINT_COMPRESSED_BYTE_LEN);
    #else
       unsigned char buffer[POINT_BYTE_LEN];
       memset(buffer, 0, POINT_BYTE_LEN);  
-      EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_UNCOMPRESSED, buffer, POINT_BYTE_LEN, bn_ctx[thread_num]);
+      EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_UNCOMPRESSED, buffer, POINT_BYTE_LEN, GetBNCtx());
       return PlainContain(buffer, POINT_BYTE_LEN);
    #endif
 }
@@ -277,9 +277,11 @@ inline std::vector<uint8_t> Contain(const std::vector<ECPoint> &vec_A) const
    size_t LEN = vec_A.size();
    std::vector<uint8_t> vec_indication_bit(LEN); 
 
+   size_t POINT_LEN = ECPointSerializedByteLen(); 
+   std::vector<unsigned char> buffer = ECPointVectorToBytes(vec_A); 
    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
    for(auto i = 0; i < vec_A.size(); i++){
-      if(Contain(vec_A[i]) == true) vec_indication_bit[i] = 1;
+      if(PlainContain(buffer.data() + i*POINT_LEN, POINT_LEN) == true) vec_indication_bit[i] = 1;
       else vec_indication_bit[i] = 0; 
    }
    return vec_indication_bit; 
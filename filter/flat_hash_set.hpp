@@ -0,0 +1,288 @@
+/****************************************************************************
+this hpp implements an open-addressing hash set/map for fixed-length keys such as
+serialized ec points (33-byte compressed ECPoint, 32-byte EC25519Point)
+keys are stored inline in one flat table, so neither insertion nor lookup allocates;
+the keys are assumed pseudo-random, so the first 8 bytes (spread by one multiplication)
+serve as the hash value and no hash function is evaluated at all
+unlike the Bloom filter, membership queries have no false positives
+*****************************************************************************
+* @copyright  MIT license (see LICENSE file)
+*****************************************************************************/
+#ifndef KUNLUN_FLAT_HASH_SET_HPP_
+#define KUNLUN_FLAT_HASH_SET_HPP_
+
+#include "../include/std.inc"
+#include "../crypto/ec_point.hpp"
+#include "../crypto/ec_25519.hpp"
+#include "../utility/bit_vector.hpp"
+
+struct FlatHashEmptyValue{};
+
+template <size_t KEY_LEN, typename ValueType = FlatHashEmptyValue>
+class FlatHashMap{
+public:
+    static_assert(KEY_LEN >= 8, "keys must be at least 8 bytes");
+    static const bool HAS_VALUE = !std::is_empty<ValueType>::value;
+
+    FlatHashMap() { this->Reserve(16); }
+    FlatHashMap(size_t MAX_ELEMENT_NUM) { this->Reserve(MAX_ELEMENT_NUM); }
+
+    // make room for MAX_ELEMENT_NUM keys without rehashing (load factor at most 1/2)
+    void Reserve(size_t MAX_ELEMENT_NUM);
+
+    inline size_t Size() const { return this->element_num; }
+
+    // return false if the key is already present (the stored value is then left unchanged)
+    bool Insert(const unsigned char *key, const ValueType &value = ValueType());
+    // insert LEN keys stored back to back
+    void InsertMany(const unsigned char *keys, size_t LEN);
+
+    inline bool Contain(const unsigned char *key) const;
+    // pull the first probe of key into cache ahead of its lookup
+    inline void Prefetch(const unsigned char *key) const;
+    // result[i] = 1 iff keys[i] is present, LEN keys stored back to back; run in parallel
+    std::vector<uint8_t> ContainMany(const unsigned char *keys, size_t LEN) const;
+
+    // return nullptr if the key is absent
+    inline ValueType* Find(const unsigned char *key);
+    inline const ValueType* Find(const unsigned char *key) const;
+
+    // ec point interfaces: ECPoint keys are the compressed encoding, EC25519Point keys the 32 bytes of px
+    void Insert(const std::vector<ECPoint> &vec_A);
+    std::vector<uint8_t> Contain(const std::vector<ECPoint> &vec_A) const;
+    void Insert(const std::vector<EC25519Point> &vec_A);
+    std::vector<uint8_t> Contain(const std::vector<EC25519Point> &vec_A) const;
+
+private:
+    size_t LOG_CAPACITY = 0;
+    size_t element_num = 0;
+    std::vector<uint8_t> control;          // 0 for an empty slot, otherwise 0x80 | 7 bits of the hash
+    std::vector<unsigned char> key_table;  // slot i holds the key at i*KEY_LEN
+    std::vector<ValueType> value_table;    // stays empty for a set
+
+    inline uint64_t Hash(const unsigned char *key) const;
+    inline size_t FindSlot(const unsigned char *key, uint64_t hash, bool &found) const;
+    void Rehash(size_t NEW_LOG_CAPACITY);
+};
+
+// a set is a map without values
+template <size_t KEY_LEN>
+using FlatHashSet = FlatHashMap<KEY_LEN>;
+
+template <size_t KEY_LEN, typename ValueType>
+inline uint64_t FlatHashMap<KEY_LEN, ValueType>::Hash(const unsigned char *key) const
+{
+    uint64_t h;
+    memcpy(&h, key, 8);
+    // Fibonacci hashing: the slot index is taken from the top bits, so a fixed prefix byte does no harm
+    return h * 0x9E3779B97F4A7C15ULL;
+}
+
+template <size_t KEY_LEN, typename ValueType>
+inline size_t FlatHashMap<KEY_LEN, ValueType>::FindSlot(const unsigned char *key, uint64_t hash, bool &found) const
+{
+    size_t MASK = (size_t(1) << this->LOG_CAPACITY) - 1;
+    uint8_t tag = 0x80 | ((hash >> 32) & 0x7F);
+    // linear probing; the table is never more than half full, so an empty slot is always reached
+    for (size_t slot = hash >> (64 - this->LOG_CAPACITY); ; slot = (slot + 1) & MASK){
+        if (this->control[slot] == 0){
+            found = false;
+            return slot;
+        }
+        if (this->control[slot] == tag && memcmp(&this->key_table[slot*KEY_LEN], key, KEY_LEN) == 0){
+            found = true;
+            return slot;
+        }
+    }
+}
+
+template <size_t KEY_LEN, typename ValueType>
+void FlatHashMap<KEY_LEN, ValueType>::Rehash(size_t NEW_LOG_CAPACITY)
+{
+    std::vector<uint8_t> old_control = std::move(this->control);
+    std::vector<unsigned char> old_key_table = std::move(this->key_table);
+    std::vector<ValueType> old_value_table = std::move(this->value_table);
+
+    this->LOG_CAPACITY = NEW_LOG_CAPACITY;
+    size_t CAPACITY = size_t(1) << NEW_LOG_CAPACITY;
+    this->control.assign(CAPACITY, 0);
+    this->key_table.resize(CAPACITY * KEY_LEN);
+    if (HAS_VALUE) this->value_table.resize(CAPACITY);
+
+    bool found;
+    for (auto i = 0; i < old_control.size(); i++){
+        if (old_control[i] == 0) continue;
+        const unsigned char *key = &old_key_table[i*KEY_LEN];
+        size_t slot = this->FindSlot(key, this->Hash(key), found);
+        this->control[slot] = old_control[i];
+        memcpy(&this->key_table[slot*KEY_LEN], key, KEY_LEN);
+        if (HAS_VALUE) this->value_table[slot] = std::move(old_value_table[i]);
+    }
+}
+
+template <size_t KEY_LEN, typename ValueType>
+void FlatHashMap<KEY_LEN, ValueType>::Reserve(size_t MAX_ELEMENT_NUM)
+{
+    size_t NEW_LOG_CAPACITY = 4;
+    while ((size_t(1) << NEW_LOG_CAPACITY) < 2 * MAX_ELEMENT_NUM) NEW_LOG_CAPACITY++;
+    if (NEW_LOG_CAPACITY > this->LOG_CAPACITY) this->Rehash(NEW_LOG_CAPACITY);
+}
+
+template <size_t KEY_LEN, typename ValueType>
+bool FlatHashMap<KEY_LEN, ValueType>::Insert(const unsigned char *key, const ValueType &value)
+{
+    if (2 * (this->element_num + 1) > (size_t(1) << this->LOG_CAPACITY)) this->Rehash(this->LOG_CAPACITY + 1);
+
+    bool found;
+    uint64_t hash = this->Hash(key);
+    size_t slot = this->FindSlot(key, hash, found);
+    if (found) return false;
+
+    this->control[slot] = 0x80 | ((hash >> 32) & 0x7F);
+    memcpy(&this->key_table[slot*KEY_LEN], key, KEY_LEN);
+    if (HAS_VALUE) this->value_table[slot] = value;
+    this->element_num++;
+    return true;
+}
+
+template <size_t KEY_LEN, typename ValueType>
+void FlatHashMap<KEY_LEN, ValueType>::InsertMany(const unsigned char *keys, size_t LEN)
+{
+    this->Reserve(this->element_num + LEN);
+    for (auto i = 0; i < LEN; i++) this->Insert(keys + i*KEY_LEN);
+}
+
+template <size_t KEY_LEN, typename ValueType>
+inline bool FlatHashMap<KEY_LEN, ValueType>::Contain(const unsigned char *key) const
+{
+    bool found;
+    this->FindSlot(key, this->Hash(key), found);
+    return found;
+}
+
+template <size_t KEY_LEN, typename ValueType>
+inline void FlatHashMap<KEY_LEN, ValueType>::Prefetch(const unsigned char *key) const
+{
+    size_t slot = this->Hash(key) >> (64 - this->LOG_CAPACITY);
+    __builtin_prefetch(&this->control[slot]);
+    __builtin_prefetch(&this->key_table[slot*KEY_LEN]);
+}
+
+template <size_t KEY_LEN, typename ValueType>
+std::vector<uint8_t> FlatHashMap<KEY_LEN, ValueType>::ContainMany(const unsigned char *keys, size_t LEN) const
+{
+    // the first probe of each lookup is a cache miss on a large table: prefetch a few lookups ahead
+    const size_t PREFETCH_DISTANCE = 8;
+    std::vector<uint8_t> vec_result(LEN);
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for (auto i = 0; i < LEN; i++){
+        if (i + PREFETCH_DISTANCE < LEN) this->Prefetch(keys + (i+PREFETCH_DISTANCE)*KEY_LEN);
+        vec_result[i] = this->Contain(keys + i*KEY_LEN);
+    }
+    return vec_result;
+}
+
+template <size_t KEY_LEN, typename ValueType>
+inline ValueType* FlatHashMap<KEY_LEN, ValueType>::Find(const unsigned char *key)
+{
+    static_assert(HAS_VALUE, "Find is only available for maps");
+    bool found;
+    size_t slot = this->FindSlot(key, this->Hash(key), found);
+    return found ? &this->value_table[slot] : nullptr;
+}
+
+template <size_t KEY_LEN, typename ValueType>
+inline const ValueType* FlatHashMap<KEY_LEN, ValueType>::Find(const unsigned char *key) const
+{
+    static_assert(HAS_VALUE, "Find is only available for maps");
+    bool found;
+    size_t slot = this->FindSlot(key, this->Hash(key), found);
+    return found ? &this->value_table[slot] : nullptr;
+}
+
+// compressed encodings of ec points via the batch serialization; the point at infinity is all-zero bytes
+inline std::vector<unsigned char> ECPointVectorToCompressedKeys(const std::vector<ECPoint> &vec_A, size_t KEY_LEN)
+{
+    if (KEY_LEN != POINT_COMPRESSED_BYTE_LEN){
+        std::cerr << "key length does not match the compressed point length" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    std::vector<unsigned char> keys(vec_A.size() * KEY_LEN);
+    ECPointVectorToCompressedBytes(vec_A.data(), vec_A.size(), keys.data());
+    return keys;
+}
+
+template <size_t KEY_LEN, typename ValueType>
+void FlatHashMap<KEY_LEN, ValueType>::Insert(const std::vector<ECPoint> &vec_A)
+{
+    std::vector<unsigned char> keys = ECPointVectorToCompressedKeys(vec_A, KEY_LEN);
+    this->InsertMany(keys.data(), vec_A.size());
+}
+
+template <size_t KEY_LEN, typename ValueType>
+std::vector<uint8_t> FlatHashMap<KEY_LEN, ValueType>::Contain(const std::vector<ECPoint> &vec_A) const
+{
+    std::vector<unsigned char> keys = ECPointVectorToCompressedKeys(vec_A, KEY_LEN);
+    return this->ContainMany(keys.data(), vec_A.size());
+}
+
+template <size_t KEY_LEN>
+BitVector ECPointSetContain(const std::vector<ECPoint> &vec_A, const std::vector<ECPoint> &vec_B)
+{
+    FlatHashSet<KEY_LEN> S(vec_A.size());
+    S.Insert(vec_A);
+    std::vector<unsigned char> keys = ECPointVectorToCompressedKeys(vec_B, KEY_LEN);
+
+    const size_t PREFETCH_DISTANCE = 8;
+    size_t LEN = vec_B.size();
+    BitVector result(LEN);
+    result.Generate([&](size_t i){
+        if (i + PREFETCH_DISTANCE < LEN) S.Prefetch(keys.data() + (i+PREFETCH_DISTANCE)*KEY_LEN);
+        return S.Contain(keys.data() + i*KEY_LEN);
+    });
+    return result;
+}
+
+/*
+** bit i of the result is 1 iff vec_B[i] is in vec_A, with the key width picked at runtime from POINT_COMPRESSED_BYTE_LEN
+** (the compressed length of the current curve), so callers need not hard-code it
+*/
+inline BitVector ECPointSetContain(const std::vector<ECPoint> &vec_A, const std::vector<ECPoint> &vec_B)
+{
+    switch (POINT_COMPRESSED_BYTE_LEN){
+        case 21: return ECPointSetContain<21>(vec_A, vec_B); // 160-bit curves
+        case 25: return ECPointSetContain<25>(vec_A, vec_B); // 192-bit curves
+        case 29: return ECPointSetContain<29>(vec_A, vec_B); // 224-bit curves
+        case 33: return ECPointSetContain<33>(vec_A, vec_B); // 256-bit curves
+        case 49: return ECPointSetContain<49>(vec_A, vec_B); // 384-bit curves
+        case 67: return ECPointSetContain<67>(vec_A, vec_B); // 521-bit curves
+        default:
+            std::cerr << "no flat hash set for " << POINT_COMPRESSED_BYTE_LEN << "-byte points" << std::endl;
+            exit(EXIT_FAILURE);
+    }
+}
+
+template <size_t KEY_LEN, typename ValueType>
+void FlatHashMap<KEY_LEN, ValueType>::Insert(const std::vector<EC25519Point> &vec_A)
+{
+    static_assert(KEY_LEN == 32, "EC25519Point keys are 32 bytes");
+    this->Reserve(this->element_num + vec_A.size());
+    for (auto i = 0; i < vec_A.size(); i++) this->Insert(vec_A[i].px);
+}
+
+template <size_t KEY_LEN, typename ValueType>
+std::vector<uint8_t> FlatHashMap<KEY_LEN, ValueType>::Contain(const std::vector<EC25519Point> &vec_A) const
+{
+    static_assert(KEY_LEN == 32, "EC25519Point keys are 32 bytes");
+    const size_t PREFETCH_DISTANCE = 8;
+    size_t LEN = vec_A.size();
+    std::vector<uint8_t> vec_result(LEN);
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for (auto i = 0; i < LEN; i++){
+        if (i + PREFETCH_DISTANCE < LEN) this->Prefetch(vec_A[i+PREFETCH_DISTANCE].px);
+        vec_result[i] = this->Contain(vec_A[i].px);
+    }
+    return vec_result;
+}
+
+#endif
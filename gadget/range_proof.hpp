@@ -97,7 +97,7 @@ PP Setup(TwistedExponentialElGamal::PP &pp_enc, Bullet::PP &pp_bullet)
 
 
 Proof_type1 Prove(PP &pp, Instance &instance, BigInt &LEFT_BOUND, BigInt &RIGHT_BOUND, 
-                   Witness_type1 &witness, std::string &transcript_str)
+                   Witness_type1 &witness, Transcript &transcript)
 {
     Proof_type1 proof; 
     if (CheckRange(LEFT_BOUND, RIGHT_BOUND, pp.bullet_part.RANGE_LEN)==false)
@@ -116,7 +116,7 @@ Proof_type1 Prove(PP &pp, Instance &instance, BigInt &LEFT_BOUND, BigInt &RIGHT_
     ptke_witness.v = witness.m;
     ptke_witness.r = witness.r;
 
-    proof.ptke_proof = PlaintextKnowledge::Prove(ptke_pp, ptke_instance, ptke_witness, transcript_str);  
+    proof.ptke_proof = PlaintextKnowledge::Prove(ptke_pp, ptke_instance, ptke_witness, transcript);  
     
 
     Bullet::Instance bullet_instance; 
@@ -130,14 +130,14 @@ Proof_type1 Prove(PP &pp, Instance &instance, BigInt &LEFT_BOUND, BigInt &RIGHT_
     AdjustBulletInstance(pp.bullet_part, LEFT_BOUND, RIGHT_BOUND, bullet_instance); 
     AdjustBulletWitness(pp.bullet_part, LEFT_BOUND, RIGHT_BOUND, bullet_witness); 
 
-    Bullet::Prove(pp.bullet_part, bullet_instance, bullet_witness, transcript_str, proof.bullet_proof);
+    Bullet::Prove(pp.bullet_part, bullet_instance, bullet_witness, transcript, proof.bullet_proof);
 
     return proof; 
 }
 
 
 bool Verify(PP &pp, Instance &instance, BigInt &LEFT_BOUND, BigInt &RIGHT_BOUND, 
-                    std::string &transcript_str, Proof_type1 &proof)
+                    Transcript &transcript, Proof_type1 &proof)
 {
     bool V1, V2; 
 
@@ -146,21 +146,21 @@ bool Verify(PP &pp, Instance &instance, BigInt &LEFT_BOUND, BigInt &RIGHT_BOUND,
     ptke_instance.pk = instance.pk; 
     ptke_instance.ct = instance.ct;
 
-    V1 = PlaintextKnowledge::Verify(ptke_pp, ptke_instance, transcript_str, proof.ptke_proof);  
+    V1 = PlaintextKnowledge::Verify(ptke_pp, ptke_instance, transcript, proof.ptke_proof);  
 
     Bullet::Instance bullet_instance;  
     bullet_instance.C = {instance.ct.Y, instance.ct.Y}; 
 
     AdjustBulletInstance(pp.bullet_part, LEFT_BOUND, RIGHT_BOUND, bullet_instance);  
 
-    V2 = Bullet::FastVerify(pp.bullet_part, bullet_instance, transcript_str, proof.bullet_proof);
+    V2 = Bullet::FastVerify(pp.bullet_part, bullet_instance, transcript, proof.bullet_proof);
 
     return V1 && V2; 
 
 }
 
 void Prove(PP &pp, Instance &instance, BigInt &LEFT_BOUND, BigInt &RIGHT_BOUND, 
-                   Witness_type2 &witness, std::string &transcript_str, Proof_type2 &proof)
+                   Witness_type2 &witness, Transcript &transcript, Proof_type2 &proof)
 {
     if (CheckRange(LEFT_BOUND, RIGHT_BOUND, pp.bullet_part.RANGE_LEN)==false)
     {
@@ -183,6 +183,7 @@ void Prove(PP &pp, Instance &instance, BigInt &LEFT_BOUND, BigInt &RIGHT_BOUND,
     DLOGEquality::PP dlogeq_pp = DLOGEquality::Setup();
     DLOGEquality::Instance dlogeq_instance;
     dlogeq_instance.g1 = pp.enc_part.g; 
+    dlogeq_instance.G1_IS_GENERATOR = pp.enc_part.G_IS_GENERATOR; 
     dlogeq_instance.h1 = instance.pk; 
     dlogeq_instance.g2 = proof.refresh_ct.Y - instance.ct.Y;  
     dlogeq_instance.h2 = proof.refresh_ct.X - instance.ct.X;
@@ -190,7 +191,7 @@ void Prove(PP &pp, Instance &instance, BigInt &LEFT_BOUND, BigInt &RIGHT_BOUND,
     DLOGEquality::Witness dlogeq_witness;
     dlogeq_witness.w = witness.sk;  
 
-    proof.dlogeq_proof = DLOGEquality::Prove(dlogeq_pp, dlogeq_instance, dlogeq_witness, transcript_str);  
+    proof.dlogeq_proof = DLOGEquality::Prove(dlogeq_pp, dlogeq_instance, dlogeq_witness, transcript);  
     
     PlaintextKnowledge::PP ptke_pp = PlaintextKnowledge::Setup(pp.enc_part); 
     PlaintextKnowledge::Instance ptke_instance; 
@@ -201,7 +202,7 @@ void Prove(PP &pp, Instance &instance, BigInt &LEFT_BOUND, BigInt &RIGHT_BOUND,
     ptke_witness.v = m; 
     ptke_witness.r = r_star; 
 
-    proof.ptke_proof = PlaintextKnowledge::Prove(ptke_pp, ptke_instance, ptke_witness, transcript_str); 
+    proof.ptke_proof = PlaintextKnowledge::Prove(ptke_pp, ptke_instance, ptke_witness, transcript); 
 
     Bullet::Instance bullet_instance; 
     bullet_instance.C = {proof.refresh_ct.Y, proof.refresh_ct.Y}; 
@@ -214,30 +215,31 @@ void Prove(PP &pp, Instance &instance, BigInt &LEFT_BOUND, BigInt &RIGHT_BOUND,
     AdjustBulletWitness(pp.bullet_part, LEFT_BOUND, RIGHT_BOUND, bullet_witness);
 
 
-    Bullet::Prove(pp.bullet_part, bullet_instance, bullet_witness, transcript_str, proof.bullet_proof);
+    Bullet::Prove(pp.bullet_part, bullet_instance, bullet_witness, transcript, proof.bullet_proof);
 }
 
 
 bool Verify(PP &pp, Instance &instance, BigInt &LEFT_BOUND, BigInt &RIGHT_BOUND, 
-            std::string &transcript_str, Proof_type2 &proof)
+            Transcript &transcript, Proof_type2 &proof)
 {
     bool V1, V2, V3; 
 
     DLOGEquality::PP dlogeq_pp = DLOGEquality::Setup();
     DLOGEquality::Instance dlogeq_instance;
     dlogeq_instance.g1 = pp.enc_part.g; 
+    dlogeq_instance.G1_IS_GENERATOR = pp.enc_part.G_IS_GENERATOR; 
     dlogeq_instance.h1 = instance.pk; 
     dlogeq_instance.g2 = proof.refresh_ct.Y - instance.ct.Y;  
     dlogeq_instance.h2 = proof.refresh_ct.X - instance.ct.X;
 
-    V1 = DLOGEquality::Verify(dlogeq_pp, dlogeq_instance, transcript_str, proof.dlogeq_proof);   
+    V1 = DLOGEquality::Verify(dlogeq_pp, dlogeq_instance, transcript, proof.dlogeq_proof);   
 
     PlaintextKnowledge::PP ptke_pp = PlaintextKnowledge::Setup(pp.enc_part); 
     PlaintextKnowledge::Instance ptke_instance;
     ptke_instance.pk = instance.pk; 
     ptke_instance.ct = proof.refresh_ct; 
 
-    V2 = PlaintextKnowledge::Verify(ptke_pp, ptke_instance, transcript_str, proof.ptke_proof); 
+    V2 = PlaintextKnowledge::Verify(ptke_pp, ptke_instance, transcript, proof.ptke_proof); 
 
 
     Bullet::Instance bullet_instance; 
@@ -245,7 +247,7 @@ bool Verify(PP &pp, Instance &instance, BigInt &LEFT_BOUND, BigInt &RIGHT_BOUND,
 
     AdjustBulletInstance(pp.bullet_part, LEFT_BOUND, RIGHT_BOUND, bullet_instance); 
 
-    V3 = Bullet::FastVerify(pp.bullet_part, bullet_instance, transcript_str, proof.bullet_proof); 
+    V3 = Bullet::FastVerify(pp.bullet_part, bullet_instance, transcript, proof.bullet_proof); 
 
     return V1 && V2 && V3; 
 }
@@ -1,6 +1,6 @@
 /****************************************************************************
 this hpp file define global variables for the Kunlun lib 
-NUMBER_OF_THREADS indicates the maximum number of threads that openmp works
+NUMBER_OF_THREADS indicates the number of threads that openmp works, configurable at runtime
 *****************************************************************************
 * @author     developed by Yu Chen
 * @copyright  MIT license (see LICENSE file)
@@ -16,12 +16,16 @@ inline std::random_device rd;
 inline std::mt19937 global_built_in_prg(rd());
 
 /* 
-* default setting: set the maximum thread num as num of physical cores
-* you can switch to **N** thread setting by assign NUMBER_OF_THREADS = N by hand
+* default setting: the number of threads openmp would use, i.e., OMP_NUM_THREADS if set, otherwise the number of cores
+* switch to **N** threads at runtime by calling SetNumberOfThreads(N)
 */
-// inline const size_t NUMBER_OF_THREADS = NUMBER_OF_PHYSICAL_CORES;  
+inline size_t NUMBER_OF_THREADS = omp_get_max_threads();  
 
-inline const size_t NUMBER_OF_THREADS = 8;  
+void SetNumberOfThreads(size_t THREAD_NUM)
+{
+    NUMBER_OF_THREADS = std::max<size_t>(THREAD_NUM, 1); 
+    omp_set_num_threads(NUMBER_OF_THREADS); 
+}
 
 inline const size_t CHECK_BUFFER_SIZE = 1024*8;
 
@@ -32,16 +32,16 @@ public:
     Baxos() = default;
     Baxos(const uint64_t item_num, const uint64_t bin_size, const uint8_t sparse_weight = 3, const uint8_t statistical_security_parameter = 40, const PRG::Seed *seed = nullptr);
     template <typename idx_type>
-    void impl_solve(const std::vector<block> &keys, const std::vector<value_type> &values, std::vector<value_type> &output, PRG::Seed *prng, uint8_t thread_num);
+    void impl_solve(const std::vector<block> &keys, const std::vector<value_type> &values, std::vector<value_type> &output, PRG::Seed *prng, size_t thread_num);
     template <typename idx_type>
-    void impl_decode(const std::vector<block> &keys, std::vector<value_type> &values, const std::vector<value_type> &output, uint8_t thread_num);
+    void impl_decode(const std::vector<block> &keys, std::vector<value_type> &values, const std::vector<value_type> &output, size_t thread_num);
     template <typename idx_type>
     void impl_decode_batch(block *keys, value_type *values, uint64_t batch_len, value_type *output);
     // template <typename idx_type>
     // void impl_decode_bin(block *keys, uint64_t len, block *keys_indexes, block *output,
     //                      OKVS<idx_type, dense_type> &paxos);
-    void solve(const std::vector<block> &keys, const std::vector<value_type> &values, std::vector<value_type> &output, PRG::Seed *prng = nullptr, uint8_t thread_num = 1);
-    void decode(const std::vector<block> &keys, std::vector<value_type> &values, const std::vector<value_type> &output, uint8_t thread_num = 1);
+    void solve(const std::vector<block> &keys, const std::vector<value_type> &values, std::vector<value_type> &output, PRG::Seed *prng = nullptr, size_t thread_num = 1);
+    void decode(const std::vector<block> &keys, std::vector<value_type> &values, const std::vector<value_type> &output, size_t thread_num = 1);
 };
 
 template <DenseType dense_type, typename value_type>
@@ -95,7 +95,7 @@ Baxos<dense_type, value_type>::Baxos(const uint64_t item_num, const uint64_t bin
 }
 template <DenseType dense_type, typename value_type>
 template <typename idx_type>
-inline void Baxos<dense_type, value_type>::impl_solve(const std::vector<block> &keys, const std::vector<value_type> &values, std::vector<value_type> &output, PRG::Seed *prng, uint8_t thread_num)
+inline void Baxos<dense_type, value_type>::impl_solve(const std::vector<block> &keys, const std::vector<value_type> &values, std::vector<value_type> &output, PRG::Seed *prng, size_t thread_num)
 {
     if (bin_num == 1)
     {
@@ -107,7 +107,6 @@ inline void Baxos<dense_type, value_type>::impl_solve(const std::vector<block> &
     }
     else
     {
-        omp_set_num_threads(thread_num);
         auto total_bin_num = thread_num * bin_num;
         // thread_1:bin_0,bin_1,...,bin_
         // thread_2:bin_0,bin_1,...,bin_
@@ -135,21 +134,21 @@ inline void Baxos<dense_type, value_type>::impl_solve(const std::vector<block> &
                 -----------------------------------------------------------------------------------------------
         */
 
-        auto get_item_bin_thread = [&](uint8_t bin_idx, uint8_t thread_idx)
+        auto get_item_bin_thread = [&](uint64_t bin_idx, size_t thread_idx)
         {
             auto bin_begin = bin_idx * bin_size_all_thread;
             auto thread_begin = thread_idx * bin_size_per_thread;
 
             return item_to_bin_thread.get() + bin_begin + thread_begin;
         };
-        auto get_value_bin_thread = [&](uint8_t bin_idx, uint8_t thread_idx)
+        auto get_value_bin_thread = [&](uint64_t bin_idx, size_t thread_idx)
         {
             auto bin_begin = bin_idx * bin_size_all_thread;
             auto thread_begin = thread_idx * bin_size_per_thread;
 
             return value_to_bin_thread.get() + bin_begin + thread_begin;
         };
-        auto get_hash_bin_thread = [&](uint8_t bin_idx, uint8_t thread_idx)
+        auto get_hash_bin_thread = [&](uint64_t bin_idx, size_t thread_idx)
         {
             auto bin_begin = bin_idx * bin_size_all_thread;
             auto thread_begin = thread_idx * bin_size_per_thread;
@@ -166,9 +165,10 @@ inline void Baxos<dense_type, value_type>::impl_solve(const std::vector<block> &
         const uint64_t keys_size = keys.size();
         block *keys_data = (block *)keys.data();
 
-#pragma omp parallel
+        // one iteration per slot of the per-thread arrays, so every slot is filled whatever team size OpenMP grants
+#pragma omp parallel for num_threads(thread_num) schedule(static, 1)
+        for (size_t thread_id = 0; thread_id < thread_num; thread_id++)
         {
-            const uint8_t thread_id = omp_get_thread_num();
             uint64_t begin = (keys_size * thread_id) / thread_num;
             const uint64_t len = keys_size * (thread_id + 1) / thread_num - begin;
 
@@ -229,119 +229,115 @@ inline void Baxos<dense_type, value_type>::impl_solve(const std::vector<block> &
             //             else
             //                 assignment_done_future.get();
         }
-#pragma omp parallel
+        // Use different threads to process each bin.
+#pragma omp parallel for num_threads(thread_num) schedule(static, 1)
+        for (uint64_t bin_idx = 0; bin_idx < bin_num; bin_idx++)
         {
+            uint32_t bin_size = 0;
+            for (auto bin_size_thread_bin : bin_size_thread)
+                bin_size += bin_size_thread_bin[bin_idx];
 
-            // Use different threads to process each bin.
-            uint8_t thread_id = omp_get_thread_num();
-            for (auto bin_idx = thread_id; bin_idx < bin_num; bin_idx += thread_num)
-            {
-                uint32_t bin_size = 0;
-                for (auto bin_size_thread_bin : bin_size_thread)
-                    bin_size += bin_size_thread_bin[bin_idx];
-
-                assert(bin_size <= item_num_per_bin); // 0:262420 1:261874 2:262425 3:261857
+            assert(bin_size <= item_num_per_bin); // 0:262420 1:261874 2:262425 3:261857
 
-                // Initialize small-sized single-threaded OKVS
-                OKVS<idx_type, dense_type, value_type> paxos;
-                paxos.item_num = bin_size;
-                paxos.sparse_weight = sparse_weight;
-                paxos.sparse_size = sparse_size;
-                paxos.dense_size = dense_size;
-                paxos.total_size = total_size;
-                paxos.seed = seed;
-                paxos.statistical_security_parameter = statistical_security_parameter;
-                paxos.g_limit = g_limit;
+            // Initialize small-sized single-threaded OKVS
+            OKVS<idx_type, dense_type, value_type> paxos;
+            paxos.item_num = bin_size;
+            paxos.sparse_weight = sparse_weight;
+            paxos.sparse_size = sparse_size;
+            paxos.dense_size = dense_size;
+            paxos.total_size = total_size;
+            paxos.seed = seed;
+            paxos.statistical_security_parameter = statistical_security_parameter;
+            paxos.g_limit = g_limit;
 
-                // Allocate storage space for variables, the process is similar to the OKVS::allocate() function
-                auto allocate_size = sizeof(idx_type) * (item_num_per_bin * sparse_weight * 2 + sparse_size) + sizeof(idx_type *) * sparse_size;
-                std::unique_ptr<uint8_t[]> storage(new uint8_t[allocate_size]);
-                uint8_t *iter = storage.get();
+            // Allocate storage space for variables, the process is similar to the OKVS::allocate() function
+            auto allocate_size = sizeof(idx_type) * (item_num_per_bin * sparse_weight * 2 + sparse_size) + sizeof(idx_type *) * sparse_size;
+            std::unique_ptr<uint8_t[]> storage(new uint8_t[allocate_size]);
+            uint8_t *iter = storage.get();
 
-                paxos.h_sparse.resize(iter, item_num_per_bin, sparse_weight);
-                iter += item_num_per_bin * sparse_weight * sizeof(idx_type);
+            paxos.h_sparse.resize(iter, item_num_per_bin, sparse_weight);
+            iter += item_num_per_bin * sparse_weight * sizeof(idx_type);
 
-                paxos.col_weights = (idx_type *)iter;
-                iter += sparse_size * sizeof(idx_type);
+            paxos.col_weights = (idx_type *)iter;
+            iter += sparse_size * sizeof(idx_type);
 
-                idx_type **col_begin = (idx_type **)iter;
-                iter += sparse_size * sizeof(idx_type *);
+            idx_type **col_begin = (idx_type **)iter;
+            iter += sparse_size * sizeof(idx_type *);
 
-                paxos.h_cols.resize(iter, sparse_size);
-                iter += item_num_per_bin * sparse_weight * sizeof(idx_type);
+            paxos.h_cols.resize(iter, sparse_size);
+            iter += item_num_per_bin * sparse_weight * sizeof(idx_type);
 
-                assert(iter == storage.get() + allocate_size);
+            assert(iter == storage.get() + allocate_size);
 
-                auto bin_begin = bin_idx * bin_size_all_thread;
-                auto values_pointer = value_to_bin_thread.get() + bin_begin;
-                auto hashes_pointer = hash_to_bin_thread.get() + bin_begin;
-                auto output_pointer = output.data() + bin_idx * total_size;
+            auto bin_begin = bin_idx * bin_size_all_thread;
+            auto values_pointer = value_to_bin_thread.get() + bin_begin;
+            auto hashes_pointer = hash_to_bin_thread.get() + bin_begin;
+            auto output_pointer = output.data() + bin_idx * total_size;
 
-                // Merges an entire row of entries in the table, eliminating empty slots
-                // Since the addresses of the incoming std::arrays in the encoding process need to be continuous,
-                // it is necessary to merge the entries of multiple threads belonging to the same bin
+            // Merges an entire row of entries in the table, eliminating empty slots
+            // Since the addresses of the incoming std::arrays in the encoding process need to be continuous,
+            // it is necessary to merge the entries of multiple threads belonging to the same bin
 
-                auto bin_pos = bin_size_thread[0][bin_idx];
-                assert(hashes_pointer == get_hash_bin_thread(bin_idx, 0));
+            auto bin_pos = bin_size_thread[0][bin_idx];
+            assert(hashes_pointer == get_hash_bin_thread(bin_idx, 0));
 
-                for (auto thread_idx = 1; thread_idx < thread_num; thread_idx++)
-                {
-                    auto size = bin_size_thread[thread_idx][bin_idx];
-                    auto hash_thread = get_hash_bin_thread(bin_idx, thread_idx);
-                    auto value_thread = get_value_bin_thread(bin_idx, thread_idx);
+            for (auto thread_idx = 1; thread_idx < thread_num; thread_idx++)
+            {
+                auto size = bin_size_thread[thread_idx][bin_idx];
+                auto hash_thread = get_hash_bin_thread(bin_idx, thread_idx);
+                auto value_thread = get_value_bin_thread(bin_idx, thread_idx);
 
-                    memmove(hashes_pointer + bin_pos, hash_thread, size * sizeof(block));
+                memmove(hashes_pointer + bin_pos, hash_thread, size * sizeof(block));
 
-                    for (auto j = 0; j < size; j++, bin_pos++)
-                    {
-                        values_pointer[bin_pos] = value_thread[j];
-                    }
+                for (auto j = 0; j < size; j++, bin_pos++)
+                {
+                    values_pointer[bin_pos] = value_thread[j];
                 }
+            }
 
-                // Initialization process, similar to OKVS::set_keys
-                memset(paxos.col_weights, 0, sizeof(idx_type) * sparse_size);
+            // Initialization process, similar to OKVS::set_keys
+            memset(paxos.col_weights, 0, sizeof(idx_type) * sparse_size);
+            {
+                paxos.h_dense = hashes_pointer;
+                paxos.sparse_weight = sparse_weight;
+                paxos.weight_nodes.reset(new typename OKVS<idx_type, dense_type, value_type>::weight_node[sparse_size]);
+
+                paxos.weight_set.resize(200);
+                paxos.mModVals.reserve(sparse_weight);
+                paxos.mMods.reserve(sparse_weight);
+                for (uint8_t ii = 0; ii < sparse_weight; ++ii)
                 {
-                    paxos.h_dense = hashes_pointer;
-                    paxos.sparse_weight = sparse_weight;
-                    paxos.weight_nodes.reset(new typename OKVS<idx_type, dense_type, value_type>::weight_node[sparse_size]);
-
-                    paxos.weight_set.resize(200);
-                    paxos.mModVals.reserve(sparse_weight);
-                    paxos.mMods.reserve(sparse_weight);
-                    for (uint8_t ii = 0; ii < sparse_weight; ++ii)
-                    {
-                        const idx_type temp = sparse_size - ii;
-                        paxos.mModVals[ii] = (temp);
-                        paxos.mMods[ii] = (gen_divider(temp));
-                    }
-                    paxos.set_sparse();
-                    paxos.weight_statistic();
-                    paxos.init_hcols();
+                    const idx_type temp = sparse_size - ii;
+                    paxos.mModVals[ii] = (temp);
+                    paxos.mMods[ii] = (gen_divider(temp));
                 }
-                paxos.encode(values_pointer, output_pointer, prng);
+                paxos.set_sparse();
+                paxos.weight_statistic();
+                paxos.init_hcols();
+            }
+            paxos.encode(values_pointer, output_pointer, prng);
 #ifndef NDEBUG
 
-                // Check in advance that the single encode process is executed correctly,
-                // this process will not happen during the actual execution
-
-                std::vector<value_type> temp(total_size);
-                memcpy(temp.data(), output_pointer, total_size * sizeof(value_type));
-                std::vector<value_type> v2(bin_size);
-                block t;
-                paxos.decode(&keys[get_item_bin_thread(bin_idx, thread_id)[0]], 1, output_pointer,values_pointer, &t);
-                paxos.decode(0, bin_size, output_pointer, v2.data(), paxos.h_dense);
-                // std::cout << bin_size << "  " << output_pointer << " " << bin_idx << " " << Block::BlockToInt64(output_pointer[0])
-                //           << " " << Block::BlockToInt64(values_pointer[bin_size - 1]) << " " << paxos.h_sparse[bin_size - 1][0] << std::endl;
-                
-                /**for (auto ij = 0; ij < v2.size(); ij++)
+            // Check in advance that the single encode process is executed correctly,
+            // this process will not happen during the actual execution
+
+            std::vector<value_type> temp(total_size);
+            memcpy(temp.data(), output_pointer, total_size * sizeof(value_type));
+            std::vector<value_type> v2(bin_size);
+            block t;
+            paxos.decode(&keys[get_item_bin_thread(bin_idx, 0)[0]], 1, output_pointer,values_pointer, &t);
+            paxos.decode(0, bin_size, output_pointer, v2.data(), paxos.h_dense);
+            // std::cout << bin_size << "  " << output_pointer << " " << bin_idx << " " << Block::BlockToInt64(output_pointer[0])
+            //           << " " << Block::BlockToInt64(values_pointer[bin_size - 1]) << " " << paxos.h_sparse[bin_size - 1][0] << std::endl;
+            
+            /**for (auto ij = 0; ij < v2.size(); ij++)
+            {
+                if (v2[ij] != values_pointer[ij])
                 {
-                    if (v2[ij] != values_pointer[ij])
-                    {
-                        throw;
-                    }
-                }**/
+                    throw;
+                }
+            }**/
 #endif
-            }
         }
     }
 }
@@ -485,7 +481,7 @@ inline void Baxos<dense_type, value_type>::impl_decode_batch(block *keys, value_
 }
 template <DenseType dense_type, typename value_type>
 template <typename idx_type>
-inline void Baxos<dense_type, value_type>::impl_decode(const std::vector<block> &keys, std::vector<value_type> &values, const std::vector<value_type> &output, uint8_t thread_num)
+inline void Baxos<dense_type, value_type>::impl_decode(const std::vector<block> &keys, std::vector<value_type> &values, const std::vector<value_type> &output, size_t thread_num)
 {
     if (bin_num == 1)
     {
@@ -493,15 +489,13 @@ inline void Baxos<dense_type, value_type>::impl_decode(const std::vector<block>
         paxos.decode(keys.data(), keys.size(), output.data(), values.data());
         return;
     }
-    omp_set_num_threads(thread_num);
-
     auto keys_size = keys.size();
     auto keys_begin = keys.data();
     auto values_begin = values.data();
-#pragma omp parallel
+    // Assign the keys std::array and values ​​std::array to different threads
+#pragma omp parallel for num_threads(thread_num) schedule(static, 1)
+    for (size_t thread_id = 0; thread_id < thread_num; thread_id++)
     {
-        // Assign the keys std::array and values ​​std::array to different threads
-        uint8_t thread_id = omp_get_thread_num();
         uint64_t begin = (keys_size * thread_id) / thread_num;
         uint64_t len = keys_size * (thread_id + 1) / thread_num - begin;
 
@@ -512,7 +506,7 @@ inline void Baxos<dense_type, value_type>::impl_decode(const std::vector<block>
 }
 
 template <DenseType dense_type, typename value_type>
-inline void Baxos<dense_type, value_type>::solve(const std::vector<block> &keys, const std::vector<value_type> &values, std::vector<value_type> &output, PRG::Seed *prng, uint8_t thread_num)
+inline void Baxos<dense_type, value_type>::solve(const std::vector<block> &keys, const std::vector<value_type> &values, std::vector<value_type> &output, PRG::Seed *prng, size_t thread_num)
 {
     // Calculate the number of bits occupied by a single variable that occupies the largest space among member variables
     auto bit_len = log2_ceil(sparse_size + 1);
@@ -537,7 +531,7 @@ inline void Baxos<dense_type, value_type>::solve(const std::vector<block> &keys,
 }
 
 template <DenseType dense_type, typename value_type>
-inline void Baxos<dense_type, value_type>::decode(const std::vector<block> &keys, std::vector<value_type> &values, const std::vector<value_type> &output, uint8_t thread_num)
+inline void Baxos<dense_type, value_type>::decode(const std::vector<block> &keys, std::vector<value_type> &values, const std::vector<value_type> &output, size_t thread_num)
 {
     auto bit_len = log2_ceil(sparse_size + 1);
     if (bit_len <= 8)
@@ -577,7 +571,7 @@ void test_baxos_BlockArrayValue()
     
     auto start = std::chrono::steady_clock::now();
     Baxos<gf_128, BlockArrayValue> baxos(n, bin_size, 3);
-    uint8_t thread_num = 4;
+    size_t thread_num = 4;
     baxos.solve(k, v, out, 0, thread_num);
     auto end = std::chrono::steady_clock::now();
     std::cout << "encode"
@@ -616,7 +610,7 @@ void test_baxos_block()
 
     auto start = std::chrono::steady_clock::now();
     Baxos<gf_128> baxos(n, bin_size, 3);
-    uint8_t thread_num = 4;
+    size_t thread_num = 4;
     baxos.solve(k, v, out, 0, thread_num);
     auto end = std::chrono::steady_clock::now();
     std::cout << "encode"
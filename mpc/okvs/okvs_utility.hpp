@@ -11,6 +11,7 @@
 
 #include "../../include/std.inc"
 #include "../../crypto/block.hpp"
+#include "../../crypto/gf128.hpp"
 #include <vector>
 
 //BlockArrayValue
@@ -51,12 +52,15 @@ struct BlockArrayValue
       return false;
    }
    
+   // debug dump, on stderr so that it never mixes with the output of a protocol
    void Print(){
    	uint32_t len = sizeof(var)/sizeof(block);
    	for(auto i = 0; i < len; ++i){
-   		Block::PrintBlock(var[i]);
+   		uint64_t *data = (uint64_t*)&var[i];
+   		std::cerr << std::hex << std::setw(16) << std::setfill('0') << data[1] << " " 
+   		          << std::setw(16) << data[0] << std::dec << std::endl;
    	}
-   	std::cout << "" << std::endl;
+   	std::cerr << std::endl;
    }
    
 };
@@ -464,87 +468,25 @@ inline void doMod32(uint64_t *vals, divider *divider, const uint64_t &modVal)
 template <typename T1,typename T2>
 inline T1 gf128_mul(const T1 x, const T2 y){return T1();}
 
-__attribute__((target("pclmul,sse2")))
+// the field arithmetic lives in crypto/gf128.hpp
 inline block gf128_mul(const block x, const block y)
 {
-
-    block x0y0 = _mm_clmulepi64_si128(x, y, 0x00);
-    block x1y0 = _mm_clmulepi64_si128(x, y, 0x10);
-    block x0y1 = _mm_clmulepi64_si128(x, y, 0x01);
-    block x1y1 = _mm_clmulepi64_si128(x, y, 0x11);
-    x1y0 = (x1y0 ^ x0y1);
-    x0y1 = _mm_slli_si128(x1y0, 8);
-    x1y0 = _mm_srli_si128(x1y0, 8);
-    x0y0 = (x0y0 ^ x0y1);
-    x1y1 = (x1y1 ^ x1y0);
-
-    auto mul256_low = x0y0;
-    auto mul256_high = x1y1;
-
-    static const constexpr std::uint64_t mod_omit128 = 0b10000111;
-
-    const block modulus_omit128 = _mm_loadl_epi64((const block *)&(mod_omit128));
-    block impact = _mm_clmulepi64_si128(mul256_high, modulus_omit128, 0x01);
-    mul256_low = _mm_xor_si128(mul256_low, _mm_slli_si128(impact, 8));
-    mul256_high = _mm_xor_si128(mul256_high, _mm_srli_si128(impact, 8));
-
-    impact = _mm_clmulepi64_si128(mul256_high, modulus_omit128, 0x00);
-    mul256_low = _mm_xor_si128(mul256_low, impact);
-
-    return mul256_low;
+    return GF128::Mul(x, y);
 }
 
 // gf128_mul overload and return z : z.var[i] = gf128_mul(x.var[i], y)
 inline BlockArrayValue gf128_mul(const BlockArrayValue x, const block y)
 {
-	uint32_t len = sizeof(BlockArrayValue)/sizeof(block);
-	block res[len];
-	for(auto i = 0; i< len; ++i){
-		res[i] = gf128_mul(((block*)(&x))[i],y);
-	}
-	return ((BlockArrayValue*)(&res))[0];
-
+	BlockArrayValue result;
+	GF128::ScalarMul(result.var, x.var, y, sizeof(result.var)/sizeof(block));
+	return result;
 }
 
-
-
 inline block gf128_inv(const block x)
 {
-    // x^{-1}=x^{2^128-1-1}=x^{2^128-2}=x^{0b1111...0} the count of 1 in x = 127 ,the count of 0 in x = 1
-    block a = x;
-
-    block result = Block::zero_block;
-    for (uint8_t i = 0; i <= 6; ++i)
-    {
-        /* entering the loop a = x^{0b1...1}  the count of 1 in a = 2^i  */
-        block b = a;
-        for (uint8_t j = 0; j < (1 << i); ++j)
-        {
-            b = gf128_mul(b, b);
-        }
-        /* after the loop b = a^{2^{2^i}} = x^{0b1...10...0} the count of 0 in b = 2^i  */
-        a = gf128_mul(a, b);
-        /* now a = x^{0b1...1} the count of 1 in a = 2^{i+1}*/
-
-        if (i == 0)
-        {
-            result = b;
-        }
-        else
-        {
-            result = gf128_mul(result, b);
-            /* now result = x^{0b1...10} the count of 1 in result = 2^{i+1}-1 */
-        }
-    }
-
-    /* finally result = x^{0b1...10} the count of 1 in result = 2^7-1 =127. That's what we need.*/
-    // auto one_block = Block::MakeBlock(0, 1);
-    // auto mul_result = gf128_mul(result, x);
-    // assert(Block::Compare(one_block, mul_result));
-
-    /* now result = x^{2^128-2} */
-    return result;
+    return GF128::Inv(x);
 }
+
 bool prev_combination(std::vector<uint8_t>& comb, uint64_t n) {
     int k = comb.size();
     for (int i = k - 1; i >= 0; --i) {
@@ -587,29 +529,17 @@ bool check_invert_gf128(std::vector<std::vector<block>> &mat)
 
         auto mat_i_i_inv = gf128_inv(mat[i][i]);
 
-        for (auto j = 0; j < n; j++)
-        {
-            if (i == j)
-            {
-                mat[i][j] = one_block;
-            }
-            else
-            {
-                mat[i][j] = gf128_mul(mat[i][j], mat_i_i_inv);
-            }
-            Inv[i][j] = gf128_mul(Inv[i][j], mat_i_i_inv);
-        }
+        GF128::ScalarMul(mat[i].data(), mat[i].data(), mat_i_i_inv, n);
+        GF128::ScalarMul(Inv[i].data(), Inv[i].data(), mat_i_i_inv, n);
+        mat[i][i] = one_block;
 
         for (auto j = 0; j < n; j++)
         {
             if (j != i)
             {
                 auto mat_j_i = mat[j][i];
-                for (auto k = 0; k < n; k++)
-                {
-                    mat[j][k] ^= gf128_mul(mat[i][k], mat_j_i);
-                    Inv[j][k] ^= gf128_mul(Inv[i][k], mat_j_i);
-                }
+                GF128::ScalarMulAdd(mat[j].data(), mat[i].data(), mat_j_i, n);
+                GF128::ScalarMulAdd(Inv[j].data(), Inv[i].data(), mat_j_i, n);
             }
         }
     }
@@ -780,7 +710,7 @@ inline void show_time(std::chrono::time_point<std::chrono::steady_clock> start,
 {
 #ifndef NDEBUG
     auto end = std::chrono::steady_clock::now();
-    std::cout << str << ":" << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+    std::cerr << str << ":" << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
 #endif
 }
 
@@ -483,7 +483,7 @@ inline bool OKVS<idx_type, dense_type, value_type>::ReadObject(std::string file_
    fin >> dense_type_2;
    if (dense_type_2 != dense_type)
    {
-      std::cout << "OKVS built with wrong dense type" << std::endl;
+      std::cerr << "OKVS built with wrong dense type" << std::endl;
       return false;
    }
    calculate_sparse_size();
@@ -1463,11 +1463,7 @@ void OKVS<idx_type, dense_type, value_type>::backfill_gf128(block *values, block
 
       for (auto i = 0; i < len; i++)
       {
-         auto &output_ = output[sparse_size + i];
-         for (auto j = 0; j < len; j++)
-         {
-            output_ ^= gf128_mul(values_[j], E_gf128[i][j]);
-         }
+         output[sparse_size + i] ^= GF128::InnerProduct(values_.data(), E_gf128[i].data(), len);
       }
    }
    else if (prng)
@@ -1497,14 +1493,7 @@ void OKVS<idx_type, dense_type, value_type>::backfill_gf128(block *values, block
 
       if (g || prng)
       {
-         auto common_ratio_d = h_dense[row];
-         auto d_iter_j = common_ratio_d;
-         temp_block ^= gf128_mul(output[sparse_size], d_iter_j);
-         for (auto j = 1; j < dense_size; j++)
-         {
-            d_iter_j = gf128_mul(d_iter_j, common_ratio_d);
-            temp_block ^= gf128_mul(output[sparse_size + j], d_iter_j);
-         }
+         temp_block ^= GF128::PowerInnerProduct(output + sparse_size, h_dense[row], dense_size);
       }
 
       output[col] = temp_block;
@@ -1877,7 +1866,7 @@ inline void OKVS<idx_type, dense_type, value_type>::triangulate()
                const idx_type first_row = triangular_c_rows.back();
                if (Block::Compare(h_dense[row], h_dense[first_row]))
                {
-                  std::cout << "Duplicate keys!" << std::endl;
+                  std::cerr << "Duplicate keys!" << std::endl;
                   throw;
                }
                else
@@ -2015,6 +2004,11 @@ inline void OKVS<idx_type, dense_type, value_type>::decode_1(const block *key, c
    }
    else
    {
+      if constexpr (std::is_same<value_type, block>::value)
+      {
+         *value ^= GF128::PowerInnerProduct(output + sparse_size, *dense_pointer, dense_size);
+         return;
+      }
       const block common_ratio_d = *dense_pointer;
       block d_i = *dense_pointer;
       if (dense_size > 0)
@@ -2255,6 +2249,12 @@ inline void OKVS<idx_type, dense_type, value_type>::decode_32(const block *keys,
    }
    else if (dense_type == gf_128)
    {
+      // block values: Horner's rule over the 32 keys at once
+      if constexpr (std::is_same<value_type, block>::value)
+      {
+         GF128::PowerInnerProduct(values, output + sparse_size, dense_pointer, 32, dense_size);
+         return;
+      }
 
       if (dense_size > 0)
       {
@@ -79,9 +79,10 @@ void FetchPP(PP &pp, std::string pp_filename)
 ** the default permutation_map should be an identity mapping
 ** return a random field element in Z_p as key
 */
-std::vector<uint8_t> Server(NetIO &io, PP &pp, std::vector<uint64_t> permutation_map, size_t INPUT_NUM)
+std::vector<uint8_t> Server(Channel &io, PP &pp, std::vector<uint64_t> permutation_map, size_t INPUT_NUM)
 {
-    PrintSplitLine('-'); 
+    auto phase = io.Phase("DDH-based OPRF"); 
+    LogSplitLine('-'); 
     auto start_time = std::chrono::steady_clock::now(); 
 
     BigInt k = GenRandomBigIntLessThan(order); // pick a key k
@@ -97,68 +98,74 @@ std::vector<uint8_t> Server(NetIO &io, PP &pp, std::vector<uint64_t> permutation
 
     io.SendECPoints(vec_Fk_mask_X.data(), INPUT_NUM);
 
-    std::cout <<"DDH-based (permuted)-OPRF [step 2]: Server ===> F_k(mask_x_i) ===> Client";
-    #ifdef ECPOINT_COMPRESSED
-        std::cout << " [" << (double)POINT_COMPRESSED_BYTE_LEN*INPUT_NUM/(1024*1024) << " MB]" << std::endl;
-    #else
-        std::cout << " [" << (double)POINT_BYTE_LEN*INPUT_NUM/(1024*1024) << " MB]" << std::endl;
-    #endif
+    ProtocolLog() <<"DDH-based (permuted)-OPRF [step 2]: Server ===> F_k(mask_x_i) ===> Client" << std::endl;
 
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "DDH-based (permuted)-OPRF: Server side takes time = " 
+    ProtocolLog() << "DDH-based (permuted)-OPRF: Server side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 
     return k.ToByteVector(BN_BYTE_LEN); 
 }
 
+// PRF values are the hashes of F_k(x) = H(x)^k, computed in one batch
+std::vector<std::vector<uint8_t>> HashPRFValues(const std::vector<ECPoint> &vec_Fk_X)
+{
+    size_t INPUT_NUM = vec_Fk_X.size(); 
+    std::vector<unsigned char> digest(INPUT_NUM * HASH_OUTPUT_LEN); 
+    Hash::ECPointsToBytes(vec_Fk_X.data(), INPUT_NUM, digest.data()); 
+    std::vector<std::vector<uint8_t>> vec_PRF_value(INPUT_NUM); 
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for(auto i = 0; i < INPUT_NUM; i++){
+        vec_PRF_value[i].assign(digest.begin() + i*HASH_OUTPUT_LEN, digest.begin() + (i+1)*HASH_OUTPUT_LEN); 
+    }
+    return vec_PRF_value; 
+}
+
 std::vector<std::vector<uint8_t>> Evaluate(PP &pp, std::vector<uint8_t> &key, std::vector<block> &vec_X, size_t INPUT_NUM)
 {
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
     auto start_time = std::chrono::steady_clock::now(); 
 
     BigInt k; 
     k.FromByteVector(key); 
     std::vector<ECPoint> vec_Fk_X(INPUT_NUM);
-    std::vector<std::vector<uint8_t>> vec_PRF_value(INPUT_NUM, std::vector<uint8_t> (HASH_OUTPUT_LEN, 0)); 
+    Hash::BlocksToECPoints(vec_X.data(), INPUT_NUM, vec_Fk_X.data()); 
     #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
     for(auto i = 0; i < INPUT_NUM; i++){ 
-        vec_Fk_X[i] = Hash::BlockToECPoint(vec_X[i]) * k;
-        vec_PRF_value[i] = Hash::ECPointToBytes(vec_Fk_X[i]); 
+        vec_Fk_X[i] = vec_Fk_X[i] * k;
     }
+    std::vector<std::vector<uint8_t>> vec_PRF_value = HashPRFValues(vec_Fk_X); 
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "DDH-based OPRF: Server side evaluation takes time = " 
+    ProtocolLog() << "DDH-based OPRF: Server side evaluation takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;        
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 
     return vec_PRF_value; 
 }
 
-std::vector<std::vector<uint8_t>> Client(NetIO &io, PP &pp, std::vector<block> &vec_X, size_t INPUT_NUM) 
+std::vector<std::vector<uint8_t>> Client(Channel &io, PP &pp, std::vector<block> &vec_X, size_t INPUT_NUM) 
 {    
-    PrintSplitLine('-'); 
+    auto phase = io.Phase("DDH-based OPRF"); 
+    LogSplitLine('-'); 
 
     auto start_time = std::chrono::steady_clock::now(); 
 
     BigInt r = GenRandomBigIntLessThan(order); // pick a mask
 
     std::vector<ECPoint> vec_mask_X(INPUT_NUM); 
+    Hash::BlocksToECPoints(vec_X.data(), INPUT_NUM, vec_mask_X.data()); // H(x_i)
     #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
     for(auto i = 0; i < INPUT_NUM; i++){
-        vec_mask_X[i] = Hash::BlockToECPoint(vec_X[i]) * r; // H(x_i)^r
+        vec_mask_X[i] = vec_mask_X[i] * r; // H(x_i)^r
     } 
     io.SendECPoints(vec_mask_X.data(), INPUT_NUM);
     
-    std::cout <<"DDH-based (permuted)-OPRF [step 1]: Client ===> mask_x_i ===> Server"; 
-    #ifdef ECPOINT_COMPRESSED
-        std::cout << " [" << (double)POINT_COMPRESSED_BYTE_LEN*INPUT_NUM/(1024*1024) << " MB]" << std::endl;
-    #else
-        std::cout << " [" << (double)POINT_BYTE_LEN*INPUT_NUM/(1024*1024) << " MB]" << std::endl;
-    #endif
+    ProtocolLog() <<"DDH-based (permuted)-OPRF [step 1]: Client ===> mask_x_i ===> Server" << std::endl; 
 
     // first receive incoming data
     std::vector<ECPoint> vec_Fk_mask_X(INPUT_NUM);
@@ -166,18 +173,17 @@ std::vector<std::vector<uint8_t>> Client(NetIO &io, PP &pp, std::vector<block> &
 
     BigInt r_inverse = r.ModInverse(order); 
     std::vector<ECPoint> vec_Fk_X(INPUT_NUM);
-    std::vector<std::vector<uint8_t>> vec_PRF_value(INPUT_NUM, std::vector<uint8_t> (HASH_OUTPUT_LEN, 0)); 
     #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
     for(auto i = 0; i < INPUT_NUM; i++){
         vec_Fk_X[i] = vec_Fk_mask_X[i] * r_inverse; 
-        vec_PRF_value[i] = Hash::ECPointToBytes(vec_Fk_X[i]); 
     }
+    std::vector<std::vector<uint8_t>> vec_PRF_value = HashPRFValues(vec_Fk_X); 
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "DDH-based (permuted)-OPRF: Client side takes time = " 
+    ProtocolLog() << "DDH-based (permuted)-OPRF: Client side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;        
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 
     return vec_PRF_value; 
 
@@ -172,26 +172,21 @@ void PrintPP(const PP &pp)
 
 /* 
 instantiate a small range PRF F: {0,1}^128 * {0,1}^* -> {0,1}^128 using AES
-** H1: {0,1}^* -> {0,1}^256
-** H1(x) = (z_0||z_1)
+** H1: {0,1}^128 -> {0,1}^256
+** H1(x) = (z_0||z_1) = (CRHash(x)||CRHash(x xor 1^128)), the fixed-key AES hash of two domain separated inputs
 ** F_k(x) = ECBEnc(k, z_0) xor z_1
 */
 std::vector<block> Encode(std::vector<block> &vec_X, block& key)
 {
     size_t INPUT_NUM = vec_X.size(); 
-    std::vector<std::vector<uint8_t>> vec_H1_X(INPUT_NUM, std::vector<uint8_t>(HASH_OUTPUT_LEN));
-    
 
     std::vector<block> vec_Z0(INPUT_NUM);
     std::vector<block> vec_Z1(INPUT_NUM); 
 
+    Hash::CRHashBlocks(vec_X.data(), vec_Z0.data(), INPUT_NUM); 
     #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-    for (auto i = 0; i < INPUT_NUM; i++){
-        BasicHash((uint8_t*)(vec_X.data() + i), sizeof(block), vec_H1_X[i].data());
-        // H1(x) = (x_left||x_right)
-        memcpy(&vec_Z0[i], vec_H1_X[i].data(), sizeof(block)); 
-        memcpy(&vec_Z1[i], vec_H1_X[i].data()+sizeof(block), sizeof(block)); 
-    }
+    for (auto i = 0; i < INPUT_NUM; i++) vec_Z1[i] = vec_X[i]^Block::all_one_block; 
+    Hash::CRHashBlocks(vec_Z1.data(), vec_Z1.data(), INPUT_NUM); 
         
     AES::Key aes_enc_key = AES::GenEncKey(key);
     AES::FastECBEnc(aes_enc_key, vec_Z0.data(), INPUT_NUM);
@@ -211,38 +206,37 @@ std::vector<std::vector<uint8_t>> Packing(PP &pp, std::vector<std::vector<uint8_
 {
     size_t matrix_width_byte = (pp.MATRIX_WIDTH + 7) >> 3;
 
-	std::vector<std::vector<uint8_t>> matrix_input(pp.MATRIX_HEIGHT, std::vector<uint8_t>(matrix_width_byte, 0));
+    // rows of matrix_input are laid out back to back, so that they can be hashed in one batch
+	std::vector<uint8_t> matrix_input(pp.MATRIX_HEIGHT * matrix_width_byte, 0);
 
     // convert the matrix_mapping_values[matrix_width][matrix_height_byte] to matrix_input[matrix_height][matrix_width_byte]
     #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
 	for (auto low_index = 0; low_index < pp.MATRIX_HEIGHT; low_index += pp.BATCH_SIZE){
 		for (auto i = 0; i < pp.MATRIX_WIDTH; i++){
 			for (auto j = low_index; j < low_index + pp.BATCH_SIZE; j++){
-				matrix_input[j][i >> 3] |= (uint8_t)((bool)(matrix_mapping_values[i][j >> 3] & (1 << (j & 7)))) << (i & 7);
+				matrix_input[j * matrix_width_byte + (i >> 3)] |= (uint8_t)((bool)(matrix_mapping_values[i][j >> 3] & (1 << (j & 7)))) << (i & 7);
 			}
 		}
 	}
 
-    uint8_t buffer[HASH_OUTPUT_LEN];
-    //uint8_t split_hash_values[pp.OUTPUT_LEN]; 
-    std::vector<std::vector<uint8_t>> result;
+    // hash all rows in one batch (H2: {0,1}^w -> {0,1}^{\ell2})
+    std::vector<uint8_t> digest(pp.MATRIX_HEIGHT * HASH_OUTPUT_LEN); 
+    Hash::HashMany(matrix_input.data(), matrix_width_byte, pp.MATRIX_HEIGHT, digest.data()); 
 
+    std::vector<std::vector<uint8_t>> result(pp.MATRIX_HEIGHT);
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
 	for (auto i = 0; i < pp.MATRIX_HEIGHT; i++){
-        BasicHash(matrix_input[i].data(), matrix_width_byte, buffer);
-        result.emplace_back(std::vector<uint8_t>(buffer, buffer + pp.RANGE_SIZE)); 
-
-        // // convert the H1_OUTPUT_LEN uint8_t array to a OUTPUT_LEN string 
-        // memcpy(split_hash_values, vec_hash_values, pp.OUTPUT_LEN);
-        // result[i] = std::string((char*)(split_hash_values), pp.OUTPUT_LEN);
+        result[i].assign(digest.begin() + i * HASH_OUTPUT_LEN, digest.begin() + i * HASH_OUTPUT_LEN + pp.RANGE_SIZE); 
 	}
 
     return result;
 }
 
 // server obtains a matrix with dimension m*w as the OPRF key
-std::vector<uint8_t> Server(NetIO &io, PP &pp)
+std::vector<uint8_t> Server(Channel &io, PP &pp)
 {
-    PrintSplitLine('-'); 
+    auto phase = io.Phase("OTE-based OPRF"); 
+    LogSplitLine('-'); 
     auto start_time = std::chrono::steady_clock::now(); 
 
     /* step 1: base OT (page 10 figure 4 item1) */
@@ -284,9 +278,9 @@ std::vector<uint8_t> Server(NetIO &io, PP &pp)
         
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "OTE-based OPRF: Server side takes time = " 
+    ProtocolLog() << "OTE-based OPRF: Server side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;        
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 
     // flatten 2D matrix_C to 1D key
     std::vector<uint8_t> key(pp.MATRIX_WIDTH * pp.MATRIX_HEIGHT); 
@@ -300,7 +294,7 @@ std::vector<uint8_t> Server(NetIO &io, PP &pp)
 // server evaluates OPRF values with input set use its own OPRF key
 std::vector<std::vector<uint8_t>> Evaluate(PP &pp, std::vector<uint8_t> &key, std::vector<block> &vec_X, size_t INPUT_NUM)
 {
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
     auto start_time = std::chrono::steady_clock::now(); 
     
     // fold 1D key to 2D matrix_C
@@ -371,17 +365,18 @@ std::vector<std::vector<uint8_t>> Evaluate(PP &pp, std::vector<uint8_t> &key, st
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "OTE-based OPRF: Server side evaluation takes time = " 
+    ProtocolLog() << "OTE-based OPRF: Server side evaluation takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;        
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 
     return vec_Fk_X;
 }
 
 // client obtains OPRF values with input set
-std::vector<std::vector<uint8_t>> Client(NetIO &io, PP &pp, std::vector<block> &vec_Y, size_t INPUT_NUM)
+std::vector<std::vector<uint8_t>> Client(Channel &io, PP &pp, std::vector<block> &vec_Y, size_t INPUT_NUM)
 {
-    PrintSplitLine('-'); 
+    auto phase = io.Phase("OTE-based OPRF"); 
+    LogSplitLine('-'); 
     auto start_time = std::chrono::steady_clock::now(); 
     
     /* step 1: base OT (page 10 figure 4 item1) */
@@ -490,18 +485,17 @@ std::vector<std::vector<uint8_t>> Client(NetIO &io, PP &pp, std::vector<block> &
 		}
     }
     
-    PrintSplitLine('-');
-    std::cout << "OTE-based OPRF: Client ===> matrix_B ===> Server [" 
-              << (double)(pp.MATRIX_WIDTH * matrix_height_byte)/(1 << 20) << " MB]" << std::endl;
+    LogSplitLine('-');
+    ProtocolLog() << "OTE-based OPRF: Client ===> matrix_B ===> Server" << std::endl; 
 
     /* step4: compute \Psi = H2(A1[v[1]] || ... || Aw[v[w]]) */
     std::vector<std::vector<uint8_t>> vec_Fk_Y = Packing(pp, matrix_mapping_values);
     
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "OTE-based OPRF: Client side takes time = " 
+    ProtocolLog() << "OTE-based OPRF: Client side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;        
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 
     return vec_Fk_Y;
 }
@@ -93,8 +93,9 @@ namespace VOLEOPRF
         
         return pp;
     }
-    std::vector<std::vector<uint8_t>> Client(NetIO &io, PP &pp, std::vector<block> &vec_X, size_t ITEM_NUM)
+    std::vector<std::vector<uint8_t>> Client(Channel &io, PP &pp, std::vector<block> &vec_X, size_t ITEM_NUM)
     {
+        auto phase = io.Phase("VOLE-based OPRF"); 
         auto start_time = std::chrono::steady_clock::now();
         // the seed used to generate the initial random data
         PRG::Seed seed = PRG::SetSeed();
@@ -115,7 +116,7 @@ namespace VOLEOPRF
         // Fig 4.Step 3:VOLE
         std::vector<block> A;
         std::vector<block> C;
-        PrintSplitLine('-');
+        LogSplitLine('-');
         //std::cout << "length of VOLE = " << size << std::endl; 
         A = VOLE::VOLE_A(io, size, C); 
 
@@ -149,21 +150,21 @@ namespace VOLEOPRF
         pp.okvs.decode(vec_X, output, C, pp.thread_num);
         auto end_time = std::chrono::steady_clock::now();
         
-    	PrintSplitLine('-');
-    std::cout << "VOLE-based OPRF [step 1]: Receiver ===> vec_A ===> Sender [" 
-              << (double)(P.size())/(1 << 16) << " MB]" << std::endl; 
+    	LogSplitLine('-');
+    ProtocolLog() << "VOLE-based OPRF [step 1]: Receiver ===> vec_A ===> Sender" << std::endl; 
                      
         auto running_time = end_time - start_time;
-        std::cout << "VOLE-based OPRF [step 2]: Receiver side takes "
+        ProtocolLog() << "VOLE-based OPRF [step 2]: Receiver side takes "
                   << std::chrono::duration<double, std::milli>(running_time).count() << " ms to calculate vec_A and Fk_X." << std::endl;
-        PrintSplitLine('-');
+        LogSplitLine('-');
         return BlockToV8(output);
     }
 
-    std::vector<uint8_t> Server(NetIO &io, PP &pp)
-    //std::vector<block> Server(NetIO &io, PP &pp)
+    std::vector<uint8_t> Server(Channel &io, PP &pp)
+    //std::vector<block> Server(Channel &io, PP &pp)
     {
-        PrintSplitLine('-');
+        auto phase = io.Phase("VOLE-based OPRF"); 
+        LogSplitLine('-');
 	
 	auto start_time = std::chrono::steady_clock::now();
         // the seed used to generate the initial random data
@@ -194,27 +195,11 @@ namespace VOLEOPRF
         io.ReceiveBlocks(P_pointer, size);
 
         // Fig 4.Step 4: the sender computes K=B+A*Delta
-        uint64_t i = 0;
-        auto Delta = pp.Delta;
-        for (; i + 8 <= size; i += 8, K_pointer += 8, P_pointer += 8)
-        {
-            K_pointer[0] ^= gf128_mul(Delta, P_pointer[0]);
-            K_pointer[1] ^= gf128_mul(Delta, P_pointer[1]);
-            K_pointer[2] ^= gf128_mul(Delta, P_pointer[2]);
-            K_pointer[3] ^= gf128_mul(Delta, P_pointer[3]);
-            K_pointer[4] ^= gf128_mul(Delta, P_pointer[4]);
-            K_pointer[5] ^= gf128_mul(Delta, P_pointer[5]);
-            K_pointer[6] ^= gf128_mul(Delta, P_pointer[6]);
-            K_pointer[7] ^= gf128_mul(Delta, P_pointer[7]);
-        }
-        for (; i < size; i++, K_pointer++, P_pointer++)
-        {
-            *K_pointer ^= gf128_mul(Delta, *P_pointer);
-        }
+        GF128::ScalarMulAdd(K_pointer, P_pointer, pp.Delta, size);
 
         auto end_time = std::chrono::steady_clock::now();
         auto running_time = end_time - start_time;
-        std::cout << "VOLE-based OPRF [step 3]: Sender side takes "
+        ProtocolLog() << "VOLE-based OPRF [step 3]: Sender side takes "
                   << std::chrono::duration<double, std::milli>(running_time).count() << " ms to calculate OPRF_KEY." << std::endl;
         return BlockToByte(K);
         
@@ -236,16 +221,17 @@ namespace VOLEOPRF
         
         auto end_time = std::chrono::steady_clock::now();
         auto running_time = end_time - start_time;
-        std::cout << "VOLE-based OPRF [step 4]: Sender side takes "
+        ProtocolLog() << "VOLE-based OPRF [step 4]: Sender side takes "
                   << std::chrono::duration<double, std::milli>(running_time).count() << " ms to calculate Fk_Y." << std::endl;
-        PrintSplitLine('-');
+        LogSplitLine('-');
         return BlockToV8(output);
     }
     
     //Client1, Server1 and Evaluate1 just for test_voleoprf.cpp
 
-    std::vector<block> Client1(NetIO &io, PP &pp, std::vector<block> &vec_X, size_t ITEM_NUM)
+    std::vector<block> Client1(Channel &io, PP &pp, std::vector<block> &vec_X, size_t ITEM_NUM)
     {
+        auto phase = io.Phase("VOLE-based OPRF"); 
         
         // the seed used to generate the initial random data
         PRG::Seed seed = PRG::SetSeed();
@@ -266,7 +252,7 @@ namespace VOLEOPRF
         // Fig 4.Step 3:VOLE
         std::vector<block> A;
         std::vector<block> C;
-        PrintSplitLine('-');
+        LogSplitLine('-');
         //std::cout << "length of VOLE = " << size << std::endl; 
         A = VOLE::VOLE_A(io, size, C); 
 
@@ -299,16 +285,16 @@ namespace VOLEOPRF
         std::vector<block> output(ITEM_NUM);
         pp.okvs.decode(vec_X, output, C, pp.thread_num);
         
-    	PrintSplitLine('-');
-    std::cout << "VOLE-based OPRF: Receiver ===> vector_A ===> Sender [" 
-              << (double)(P.size())/(1 << 16) << " MB]" << std::endl; 
+    	LogSplitLine('-');
+    ProtocolLog() << "VOLE-based OPRF: Receiver ===> vector_A ===> Sender" << std::endl; 
                      
         return output;
     }
 
-    std::vector<uint8_t> Server1(NetIO &io, PP &pp)
+    std::vector<uint8_t> Server1(Channel &io, PP &pp)
     {
-        PrintSplitLine('-');
+        auto phase = io.Phase("VOLE-based OPRF"); 
+        LogSplitLine('-');
 
         // the seed used to generate the initial random data
         PRG::Seed seed = PRG::SetSeed();
@@ -340,23 +326,7 @@ namespace VOLEOPRF
         io.ReceiveBlocks(P_pointer, size);
 
         // Fig 4.Step 4: the sender computes K=B+A*Delta
-        uint64_t i = 0;
-        auto Delta = pp.Delta;
-        for (; i + 8 <= size; i += 8, K_pointer += 8, P_pointer += 8)
-        {
-            K_pointer[0] ^= gf128_mul(Delta, P_pointer[0]);
-            K_pointer[1] ^= gf128_mul(Delta, P_pointer[1]);
-            K_pointer[2] ^= gf128_mul(Delta, P_pointer[2]);
-            K_pointer[3] ^= gf128_mul(Delta, P_pointer[3]);
-            K_pointer[4] ^= gf128_mul(Delta, P_pointer[4]);
-            K_pointer[5] ^= gf128_mul(Delta, P_pointer[5]);
-            K_pointer[6] ^= gf128_mul(Delta, P_pointer[6]);
-            K_pointer[7] ^= gf128_mul(Delta, P_pointer[7]);
-        }
-        for (; i < size; i++, K_pointer++, P_pointer++)
-        {
-            *K_pointer ^= gf128_mul(Delta, *P_pointer);
-        }
+        GF128::ScalarMulAdd(K_pointer, P_pointer, pp.Delta, size);
         
         return BlockToByte(K);
     }
@@ -96,8 +96,9 @@ void FetchPP(PP &pp, std::string pp_filename)
 }
 
 // implement random OT send
-void RandomSend(NetIO &io, PP &pp, std::vector<block> &vec_K0, std::vector<block> &vec_K1, size_t EXTEND_LEN)
+void RandomSend(Channel &io, PP &pp, std::vector<block> &vec_K0, std::vector<block> &vec_K1, size_t EXTEND_LEN)
 {
+    auto phase = io.Phase("ALSZ OTE"); 
     /* 
     ** Phase 1: sender obtains a random blended matrix Q of matrix T and U from receiver
     ** T and U are tall and skinny matrix, to use base OT oblivious transfer T and U, 
@@ -120,7 +121,7 @@ void RandomSend(NetIO &io, PP &pp, std::vector<block> &vec_K0, std::vector<block
     // first receive 1-out-2 two keys from the receiver 
     std::vector<block> vec_Q_seed = NPOT::Receive(io, pp.baseOT, vec_sender_selection_bit, COLUMN_NUM);
 
-    std::cout << "ALSZ OTE [step 1]: Sender obliviously get " << BASE_LEN 
+    ProtocolLog() << "ALSZ OTE [step 1]: Sender obliviously get " << BASE_LEN 
               << " number of keys from Receiver via base OT" << std::endl; 
     /* 
     ** invoke base OT COLUMN_NUM times to obtain a matrix Q
@@ -128,17 +129,14 @@ void RandomSend(NetIO &io, PP &pp, std::vector<block> &vec_K0, std::vector<block
     */
 
     #ifdef DEBUG
-        std::cout << "ALSZ OTE: Sender obliviuosly get "<< COLUMM_NUM << " number of seeds from Receiver" << std::endl; 
+        ProtocolLog() << "ALSZ OTE: Sender obliviuosly get "<< COLUMM_NUM << " number of seeds from Receiver" << std::endl; 
     #endif
 
     std::vector<block> Q(ROW_NUM/128*COLUMN_NUM); // size = ROW_NUM/128 * COLUMN_NUM 
-    std::vector<block> Q_column; // size = ROW_NUM/128
-    // compute Q
+    // compute Q column by column
     for(auto j = 0; j < COLUMN_NUM; j++){
         PRG::ReSeed(seed, &vec_Q_seed[j], 0); 
-        Q_column = PRG::GenRandomBlocks(seed, ROW_NUM/128);
-        //Q.insert(Q.end(), Q_column.begin(), Q_column.end());
-        memcpy(Q.data()+ROW_NUM/128*j, Q_column.data(), ROW_NUM/8);   
+        PRG::Fill(seed, Q.data()+ROW_NUM/128*j, ROW_NUM/128);
     } 
 
     std::vector<block> P(ROW_NUM/128 * COLUMN_NUM); 
@@ -146,44 +144,35 @@ void RandomSend(NetIO &io, PP &pp, std::vector<block> &vec_K0, std::vector<block
 
     // compute Q XOR sP
     for(auto j = 0; j < COLUMN_NUM; j++){
-        for(auto i = 0; i < ROW_NUM/128; i++){
-            if(vec_sender_selection_bit[j] == 1){
-                Q[j*ROW_NUM/128 + i] ^= P[j*ROW_NUM/128 + i]; 
-            }
+        if(vec_sender_selection_bit[j] == 1){
+            Block::XorInto(Q.data()+j*ROW_NUM/128, Q.data()+j*ROW_NUM/128, P.data()+j*ROW_NUM/128, ROW_NUM/128); 
         }
     }
 
-    // transpose Q XOR sP 
-    std::vector<block> Q_transpose(ROW_NUM/128 * COLUMN_NUM);  
-    BitMatrixTranspose((uint8_t*)Q.data(), COLUMN_NUM, ROW_NUM, (uint8_t*)Q_transpose.data());  
-
-    #ifdef DEBUG
-        std::cout << "ALSZ OTE: Sender transposes matrix Q XOR sP" << std::endl; 
-    #endif
-
     // generate dense representation of selection block
     std::vector<block> vec_sender_selection_block(COLUMN_NUM/128); 
     Block::FromSparseBytes(vec_sender_selection_bit.data(), COLUMN_NUM, vec_sender_selection_block.data(), COLUMN_NUM/128); 
 
-    // begin to transmit the real message
-    std::vector<block> vec_outer_C0(ROW_NUM); 
-    std::vector<block> vec_outer_C1(ROW_NUM); 
+    // transpose Q XOR sP tile by tile and hash the rows of each tile right away, tweaked by the row index
+    FastBitMatrixTransposeRows(Q.data(), COLUMN_NUM, ROW_NUM, [&](size_t ROW_BEGIN, block *Q_rows){
+        Hash::TCRHashRows(Q_rows, 128, COLUMN_NUM/128, vec_K0.data()+ROW_BEGIN, ROW_BEGIN); 
+        for(auto i = 0; i < 128; i++){
+            Block::XorInto(Q_rows+i*COLUMN_NUM/128, Q_rows+i*COLUMN_NUM/128, vec_sender_selection_block.data(), COLUMN_NUM/128);
+        }
+        Hash::TCRHashRows(Q_rows, 128, COLUMN_NUM/128, vec_K1.data()+ROW_BEGIN, ROW_BEGIN); 
+    }); 
 
-    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-    for(auto i = 0; i < ROW_NUM; i++)
-    {
-        std::vector<block> Q_row(COLUMN_NUM/128);
-        memcpy(Q_row.data(), Q_transpose.data()+i*COLUMN_NUM/128, COLUMN_NUM/8); 
-        vec_K0[i] = Hash::FastBlocksToBlock(Q_row); 
-        vec_K1[i] = Hash::FastBlocksToBlock(Block::XOR(Q_row, vec_sender_selection_block));
-    }
+    #ifdef DEBUG
+        ProtocolLog() << "ALSZ OTE: Sender transposes matrix Q XOR sP" << std::endl; 
+    #endif
 }
 
 // implement random receive: note this random ot is slightly different from Beaver's ROT
 // cause receiver can choose selection bit itself
-void RandomReceive(NetIO &io, PP &pp, std::vector<block> &vec_K, 
-                    std::vector<uint8_t> &vec_receiver_selection_bit, size_t EXTEND_LEN)
+void RandomReceive(Channel &io, PP &pp, std::vector<block> &vec_K, 
+                    const BitVector &vec_receiver_selection_bit, size_t EXTEND_LEN)
 {
+    auto phase = io.Phase("ALSZ OTE"); 
     // prepare a random matrix
     size_t ROW_NUM = EXTEND_LEN; 
     size_t COLUMN_NUM = pp.BASE_LEN; 
@@ -203,70 +192,63 @@ void RandomReceive(NetIO &io, PP &pp, std::vector<block> &vec_K,
 
     //std::cout << "still clean here [1]" << std::endl;
 
-    std::cout << "ALSZ OTE [step 1]: Receiver transmits "<< COLUMN_NUM << " number of seeds to Sender via base OT" 
+    ProtocolLog() << "ALSZ OTE [step 1]: Receiver transmits "<< COLUMN_NUM << " number of seeds to Sender via base OT" 
               << std::endl; 
     
     // block representations for matrix T, U, and P: size = ROW_NUM/128*COLUMN_NUM
     std::vector<block> T(ROW_NUM/128*COLUMN_NUM);
     std::vector<block> P(ROW_NUM/128*COLUMN_NUM);
 
-    std::vector<block> T_column, U_column, P_column; 
+    std::vector<block> U_column(ROW_NUM/128); 
 
     // generate the dense representation of selection block
     std::vector<block> vec_receiver_selection_block(ROW_NUM/128); 
-    Block::FromSparseBytes(vec_receiver_selection_bit.data(), ROW_NUM, vec_receiver_selection_block.data(), ROW_NUM/128); 
+    if(vec_receiver_selection_bit.Size() != ROW_NUM){
+        std::cerr << "size of selection bits does not match" << std::endl; 
+        exit(EXIT_FAILURE); 
+    }
+    // the packed bits are already in block order
+    memcpy(vec_receiver_selection_block.data(), vec_receiver_selection_bit.Data(), ROW_NUM/8); 
     
     for(auto j = 0; j < COLUMN_NUM; j++){
         // generate two random matrixs
+        block *T_column = T.data()+ROW_NUM/128*j; 
+        block *P_column = P.data()+ROW_NUM/128*j; 
         PRG::ReSeed(seed, &vec_T_seed[j], 0); 
-        T_column = PRG::GenRandomBlocks(seed, ROW_NUM/128);
-        //T.insert(T.end(), T_column.begin(), T_column.end()); 
-        memcpy(T.data()+ROW_NUM/128*j, T_column.data(), ROW_NUM/8); 
+        PRG::Fill(seed, T_column, ROW_NUM/128);
 
         PRG::ReSeed(seed, &vec_U_seed[j], 0);  
-        U_column = PRG::GenRandomBlocks(seed, ROW_NUM/128); 
+        PRG::Fill(seed, U_column.data(), ROW_NUM/128); 
         
         // generate adjust matrix  
-        std::vector<block> P_column = Block::XOR(T_column, U_column); // T xor U
-        P_column = Block::XOR(P_column, vec_receiver_selection_block); // T xor U xor selection_block
-        //P.insert(P.end(), P_column.begin(), P_column.end());
-        memcpy(P.data()+ROW_NUM/128*j, P_column.data(), ROW_NUM/8);  
+        Block::XorInto(P_column, T_column, U_column.data(), ROW_NUM/128); // T xor U
+        Block::XorInto(P_column, P_column, vec_receiver_selection_block.data(), ROW_NUM/128); // T xor U xor selection_block
     } 
 
     // Phase 1: transmit adjust bit matrix
     io.SendBlocks(P.data(), ROW_NUM/128*COLUMN_NUM); 
-    std::cout << "ALSZ OTE [step 2]: Receiver ===> " << ROW_NUM << "*" << COLUMN_NUM << " adjust bit matrix ===> Sender" 
-              << " [" << (double)ROW_NUM/128*COLUMN_NUM*16/(1024*1024) << " MB]" << std::endl;
+    ProtocolLog() << "ALSZ OTE [step 2]: Receiver ===> " << ROW_NUM << "*" << COLUMN_NUM << " adjust bit matrix ===> Sender" << std::endl; 
 
-    // transpose T
-    std::vector<block> T_transpose(ROW_NUM/128 * COLUMN_NUM); 
-    BitMatrixTranspose((uint8_t*)T.data(), COLUMN_NUM, ROW_NUM, (uint8_t*)T_transpose.data());
+    // transpose T tile by tile and hash the rows of each tile right away, tweaked by the row index
+    FastBitMatrixTransposeRows(T.data(), COLUMN_NUM, ROW_NUM, [&](size_t ROW_BEGIN, block *T_rows){
+        Hash::TCRHashRows(T_rows, 128, COLUMN_NUM/128, vec_K.data()+ROW_BEGIN, ROW_BEGIN); 
+    }); 
 
     #ifdef DEBUG
-        std::cout << "ALSZ OTE: Receiver transposes matrix T" << std::endl; 
+        ProtocolLog() << "ALSZ OTE: Receiver transposes matrix T" << std::endl; 
     #endif
-
-    //std::cout << "still clean here [2]" << std::endl;
-
-    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-    for(auto i = 0; i < ROW_NUM; i++)
-    {
-        std::vector<block> T_row(COLUMN_NUM/128);  
-        memcpy(T_row.data(), T_transpose.data()+i*COLUMN_NUM/128, COLUMN_NUM/8); 
-
-        vec_K[i] = Hash::FastBlocksToBlock(T_row); 
-    } 
 }
 
-void Send(NetIO &io, PP &pp, std::vector<block> &vec_m0, std::vector<block> &vec_m1, size_t EXTEND_LEN) 
+void Send(Channel &io, PP &pp, std::vector<block> &vec_m0, std::vector<block> &vec_m1, size_t EXTEND_LEN) 
 {
+    auto phase = io.Phase("ALSZ OTE"); 
     /* 
     ** Phase 1: sender obtains a random secret sharing matrix Q of matrix T from receiver
     ** T is a tall matrix, to use base OT oblivious transfer T, 
     ** the sender first oblivous get 1-out-of-2 keys per column from receiver via base OT 
     ** receiver then send encryptions of the original column and shared column under k0 and k1 respectively
     */
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 	auto start_time = std::chrono::steady_clock::now(); 
 
     // prepare to receive a secret shared matrix Q from receiver
@@ -284,30 +266,26 @@ void Send(NetIO &io, PP &pp, std::vector<block> &vec_m0, std::vector<block> &vec
     std::vector<block> vec_outer_C0(ROW_NUM); 
     std::vector<block> vec_outer_C1(ROW_NUM); 
 
-    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-    for(auto i = 0; i < ROW_NUM; i++)
-    {       
-        vec_outer_C0[i] = vec_m0[i]^vec_K0[i]; 
-        vec_outer_C1[i] = vec_m1[i]^vec_K1[i];
-    }
+    Block::XorInto(vec_outer_C0.data(), vec_m0.data(), vec_K0.data(), ROW_NUM); 
+    Block::XorInto(vec_outer_C1.data(), vec_m1.data(), vec_K1.data(), ROW_NUM); 
     io.SendBlocks(vec_outer_C0.data(), ROW_NUM); 
     io.SendBlocks(vec_outer_C1.data(), ROW_NUM);
 
     
-    std::cout << "ALSZ OTE [step 3]: Sender ===> (vec_C0, vec_C1) ===> Receiver" 
-              << "[" << (double)ROW_NUM*16*2/(1024*1024) << " MB]" << std::endl; 
+    ProtocolLog() << "ALSZ OTE [step 3]: Sender ===> (vec_C0, vec_C1) ===> Receiver" << std::endl; 
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "ALSZ OTE: Sender side takes time " 
+    ProtocolLog() << "ALSZ OTE: Sender side takes time " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 }
 
 
-std::vector<block> Receive(NetIO &io, PP &pp, std::vector<uint8_t> &vec_receiver_selection_bit, size_t EXTEND_LEN)
+std::vector<block> Receive(Channel &io, PP &pp, const BitVector &vec_receiver_selection_bit, size_t EXTEND_LEN)
 {
-    PrintSplitLine('-'); 
+    auto phase = io.Phase("ALSZ OTE"); 
+    LogSplitLine('-'); 
   
     auto start_time = std::chrono::steady_clock::now(); 
 
@@ -329,7 +307,7 @@ std::vector<block> Receive(NetIO &io, PP &pp, std::vector<uint8_t> &vec_receiver
     io.ReceiveBlocks(vec_outer_C1.data(), ROW_NUM);
 
     #ifdef DEBUG
-        std::cout << "ALSZ OTE: Receiver get "<< ROW_NUM << " pair of ciphertexts from Sender" << std::endl; 
+        ProtocolLog() << "ALSZ OTE: Receiver get "<< ROW_NUM << " pair of ciphertexts from Sender" << std::endl; 
     #endif
 
     std::vector<block> vec_result(ROW_NUM);
@@ -345,31 +323,32 @@ std::vector<block> Receive(NetIO &io, PP &pp, std::vector<uint8_t> &vec_receiver
     }   
 
     #ifdef DEBUG
-        std::cout << "ALSZ OTE: Receiver obtains "<< ROW_NUM << " number of messages from Sender" << std::endl; 
-        PrintSplitLine('*'); 
+        ProtocolLog() << "ALSZ OTE: Receiver obtains "<< ROW_NUM << " number of messages from Sender" << std::endl; 
+        LogSplitLine('*'); 
     #endif
 
-    std::cout << "ALSZ OTE [step 4]: Receiver obtains vec_m" << std::endl; 
+    ProtocolLog() << "ALSZ OTE [step 4]: Receiver obtains vec_m" << std::endl; 
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "ALSZ OTE: Receiver side takes time " 
+    ProtocolLog() << "ALSZ OTE: Receiver side takes time " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
 
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 
     return vec_result; 
 }
 
-void OnesidedSend(NetIO &io, PP &pp, std::vector<block> &vec_m, size_t EXTEND_LEN) 
+void OnesidedSend(Channel &io, PP &pp, std::vector<block> &vec_m, size_t EXTEND_LEN) 
 {
+    auto phase = io.Phase("ALSZ OTE"); 
     /* 
     ** Phase 1: sender obtains a random secret sharing matrix Q of matrix T from receiver
     ** T is a tall matrix, to use base OT oblivious transfer T, 
     ** the sender first oblivous get 1-out-of-2 keys per column from receiver via base OT 
     ** receiver then send encryptions of the original column and shared column under k0 and k1 respectively
     */	
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 	
     auto start_time = std::chrono::steady_clock::now(); 
 
@@ -387,33 +366,29 @@ void OnesidedSend(NetIO &io, PP &pp, std::vector<block> &vec_m, size_t EXTEND_LE
     // begin to transmit the real message
     std::vector<block> vec_outer_C(ROW_NUM);
 
-    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-    for(auto i = 0; i < ROW_NUM; i++)
-    {
-        vec_outer_C[i] = vec_m[i]^vec_K1[i];
-    }
+    Block::XorInto(vec_outer_C.data(), vec_m.data(), vec_K1.data(), ROW_NUM); 
     io.SendBlocks(vec_outer_C.data(), ROW_NUM); 
 
-    std::cout << "ALSZ OTE [step 3]: Sender ===> vec_C ===> Receiver" << " [" 
-              << (double)ROW_NUM*16/(1024*1024) << " MB]" << std::endl;
+    ProtocolLog() << "ALSZ OTE [step 3]: Sender ===> vec_C ===> Receiver" << std::endl; 
 
     #ifdef DEBUG
-        std::cout << "ALSZ OTE: Sender sends "<< ROW_NUM << " number of ciphertexts to receiver" << std::endl; 
-        PrintSplitLine('*'); 
+        ProtocolLog() << "ALSZ OTE: Sender sends "<< ROW_NUM << " number of ciphertexts to receiver" << std::endl; 
+        LogSplitLine('*'); 
     #endif
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "ALSZ OTE: Sender side takes time " 
+    ProtocolLog() << "ALSZ OTE: Sender side takes time " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
 
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 }
 
 // the size of vec_result = the hamming weight of vec_selection_bit
-std::vector<block> OnesidedReceive(NetIO &io, PP &pp, std::vector<uint8_t> &vec_receiver_selection_bit, size_t EXTEND_LEN)
+std::vector<block> OnesidedReceive(Channel &io, PP &pp, const BitVector &vec_receiver_selection_bit, size_t EXTEND_LEN)
 {
-    PrintSplitLine('-'); 
+    auto phase = io.Phase("ALSZ OTE"); 
+    LogSplitLine('-'); 
 
     std::vector<block> vec_result;
     // first act as sender in base OT
@@ -441,18 +416,18 @@ std::vector<block> OnesidedReceive(NetIO &io, PP &pp, std::vector<uint8_t> &vec_
     }   
 
     #ifdef DEBUG
-        std::cout << "ALSZ OTE: Receiver get "<< ROW_NUM << " number of ciphertexts from Sender" << std::endl; 
-        PrintSplitLine('*'); 
+        ProtocolLog() << "ALSZ OTE: Receiver get "<< ROW_NUM << " number of ciphertexts from Sender" << std::endl; 
+        LogSplitLine('*'); 
     #endif
 
-    std::cout << "ALSZ OTE [step 4]: Receiver obtains vec_m" << std::endl; 
+    ProtocolLog() << "ALSZ OTE [step 4]: Receiver obtains vec_m" << std::endl; 
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "ALSZ OTE: Receiver side takes time " 
+    ProtocolLog() << "ALSZ OTE: Receiver side takes time " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
 
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 
     return vec_result; 
 }
@@ -465,11 +440,12 @@ std::vector<block> OnesidedReceive(NetIO &io, PP &pp, std::vector<uint8_t> &vec_
 */
 
 // one-sided version
-void OnesidedSendByteVector(NetIO &io, PP &pp, std::vector<std::vector<uint8_t>> &vec_m, size_t EXTEND_LEN) 
+void OnesidedSendByteVector(Channel &io, PP &pp, std::vector<std::vector<uint8_t>> &vec_m, size_t EXTEND_LEN) 
 {
-    PrintSplitLine('-'); 
+    auto phase = io.Phase("ALSZ OTE"); 
+    LogSplitLine('-'); 
 	
-    std::cout << "one-sided OTe: sender side" << std::endl; 
+    ProtocolLog() << "one-sided OTe: sender side" << std::endl; 
 
     auto start_time = std::chrono::steady_clock::now(); 
 
@@ -489,26 +465,26 @@ void OnesidedSendByteVector(NetIO &io, PP &pp, std::vector<std::vector<uint8_t>>
     io.SendBytesVector(vec_outer_C); 
 
     size_t ITEM_LEN = vec_outer_C[0].size();
-    std::cout << "ALSZ OTE [step 3]: Sender ===> vec_C ===> Receiver" << " [" 
-              << (double)EXTEND_LEN*ITEM_LEN/(1024*1024) << " MB]" << std::endl;
+    ProtocolLog() << "ALSZ OTE [step 3]: Sender ===> vec_C ===> Receiver" << std::endl; 
 
     #ifdef DEBUG
-        std::cout << "ALSZ OTE: Sender sends "<< EXTEND_LEN << " number of ciphertexts to receiver" << std::endl; 
-        PrintSplitLine('*'); 
+        ProtocolLog() << "ALSZ OTE: Sender sends "<< EXTEND_LEN << " number of ciphertexts to receiver" << std::endl; 
+        LogSplitLine('*'); 
     #endif
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "ALSZ OTE: Sender side takes time " 
+    ProtocolLog() << "ALSZ OTE: Sender side takes time " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
 
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 }
 
-std::vector<std::vector<uint8_t>> OnesidedReceiveByteVector(NetIO &io, PP &pp, 
-                                  std::vector<uint8_t> &vec_receiver_selection_bit, size_t EXTEND_LEN)
+std::vector<std::vector<uint8_t>> OnesidedReceiveByteVector(Channel &io, PP &pp, 
+                                  const BitVector &vec_receiver_selection_bit, size_t EXTEND_LEN)
 {
-    PrintSplitLine('-'); 
+    auto phase = io.Phase("ALSZ OTE"); 
+    LogSplitLine('-'); 
     
     auto start_time = std::chrono::steady_clock::now(); 
 
@@ -528,28 +504,29 @@ std::vector<std::vector<uint8_t>> OnesidedReceiveByteVector(NetIO &io, PP &pp,
     }   
 
     #ifdef DEBUG
-        std::cout << "ALSZ OTE: Receiver gets "<< EXTEND_LEN << " number of ciphertexts from Sender" << std::endl; 
-        PrintSplitLine('*'); 
+        ProtocolLog() << "ALSZ OTE: Receiver gets "<< EXTEND_LEN << " number of ciphertexts from Sender" << std::endl; 
+        LogSplitLine('*'); 
     #endif
 
-    std::cout << "ALSZ OTE [step 4]: Receiver obtains vec_m" << std::endl; 
+    ProtocolLog() << "ALSZ OTE [step 4]: Receiver obtains vec_m" << std::endl; 
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "ALSZ OTE: Receiver side takes time " 
+    ProtocolLog() << "ALSZ OTE: Receiver side takes time " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
 
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 
     return vec_result; 
 }
 
 // standard version
-void SendByteVector(NetIO &io, PP &pp, std::vector<std::vector<uint8_t>> &vec_m0, std::vector<std::vector<uint8_t>> &vec_m1, size_t EXTEND_LEN) 
+void SendByteVector(Channel &io, PP &pp, std::vector<std::vector<uint8_t>> &vec_m0, std::vector<std::vector<uint8_t>> &vec_m1, size_t EXTEND_LEN) 
 {
-    PrintSplitLine('-'); 
+    auto phase = io.Phase("ALSZ OTE"); 
+    LogSplitLine('-'); 
 	
-    std::cout << "OTe: sender side" << std::endl; 
+    ProtocolLog() << "OTe: sender side" << std::endl; 
 
     auto start_time = std::chrono::steady_clock::now(); 
 
@@ -573,25 +550,25 @@ void SendByteVector(NetIO &io, PP &pp, std::vector<std::vector<uint8_t>> &vec_m0
     io.SendBytesVector(vec_outer_C1);
 
     size_t ITEM_LEN = vec_outer_C0[0].size();
-    std::cout << "ALSZ OTE [step 3]: Sender ===> (vec_C0, vec_C1） ===> Receiver" << " [" 
-              << (double)EXTEND_LEN*ITEM_LEN*2/(1024*1024) << " MB]" << std::endl;
+    ProtocolLog() << "ALSZ OTE [step 3]: Sender ===> (vec_C0, vec_C1） ===> Receiver" << std::endl; 
 
     #ifdef DEBUG
-        std::cout << "ALSZ OTE: Sender sends "<< EXTEND_LEN << " number of ciphertexts to receiver" << std::endl; 
-        PrintSplitLine('*'); 
+        ProtocolLog() << "ALSZ OTE: Sender sends "<< EXTEND_LEN << " number of ciphertexts to receiver" << std::endl; 
+        LogSplitLine('*'); 
     #endif
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "ALSZ OTE: Sender side takes time " 
+    ProtocolLog() << "ALSZ OTE: Sender side takes time " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
 
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 }
 
-std::vector<std::vector<uint8_t>> ReceiveByteVector(NetIO &io, PP &pp, std::vector<uint8_t> &vec_receiver_selection_bit, size_t EXTEND_LEN)
+std::vector<std::vector<uint8_t>> ReceiveByteVector(Channel &io, PP &pp, const BitVector &vec_receiver_selection_bit, size_t EXTEND_LEN)
 {
-    PrintSplitLine('-'); 
+    auto phase = io.Phase("ALSZ OTE"); 
+    LogSplitLine('-'); 
     
     auto start_time = std::chrono::steady_clock::now(); 
 
@@ -616,21 +593,46 @@ std::vector<std::vector<uint8_t>> ReceiveByteVector(NetIO &io, PP &pp, std::vect
     }   
 
     #ifdef DEBUG
-        std::cout << "ALSZ OTE: Receiver gets "<< EXTEND_LEN << " number of ciphertexts from Sender" << std::endl; 
-        PrintSplitLine('*'); 
+        ProtocolLog() << "ALSZ OTE: Receiver gets "<< EXTEND_LEN << " number of ciphertexts from Sender" << std::endl; 
+        LogSplitLine('*'); 
     #endif
 
-    std::cout << "ALSZ OTE [step 4]: Receiver obtains vec_m" << std::endl; 
+    ProtocolLog() << "ALSZ OTE [step 4]: Receiver obtains vec_m" << std::endl; 
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "ALSZ OTE: Receiver side takes time " 
+    ProtocolLog() << "ALSZ OTE: Receiver side takes time " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
 
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 
     return vec_result; 
 }
 
+/* 
+** the receivers above take packed selection bits;
+** these overloads keep accepting one selection bit per byte
+*/
+std::vector<block> Receive(Channel &io, PP &pp, const std::vector<uint8_t> &vec_receiver_selection_bit, size_t EXTEND_LEN)
+{
+    return Receive(io, pp, PackSelectionBits(vec_receiver_selection_bit, EXTEND_LEN), EXTEND_LEN); 
+}
+
+std::vector<block> OnesidedReceive(Channel &io, PP &pp, const std::vector<uint8_t> &vec_receiver_selection_bit, size_t EXTEND_LEN)
+{
+    return OnesidedReceive(io, pp, PackSelectionBits(vec_receiver_selection_bit, EXTEND_LEN), EXTEND_LEN); 
+}
+
+std::vector<std::vector<uint8_t>> OnesidedReceiveByteVector(Channel &io, PP &pp, 
+                                  const std::vector<uint8_t> &vec_receiver_selection_bit, size_t EXTEND_LEN)
+{
+    return OnesidedReceiveByteVector(io, pp, PackSelectionBits(vec_receiver_selection_bit, EXTEND_LEN), EXTEND_LEN); 
+}
+
+std::vector<std::vector<uint8_t>> ReceiveByteVector(Channel &io, PP &pp, const std::vector<uint8_t> &vec_receiver_selection_bit, size_t EXTEND_LEN)
+{
+    return ReceiveByteVector(io, pp, PackSelectionBits(vec_receiver_selection_bit, EXTEND_LEN), EXTEND_LEN); 
+}
+
 }
 #endif
@@ -94,8 +94,9 @@ void FetchPP(PP &pp, std::string pp_filename)
 }
 
 
-void RandomSend(NetIO &io, PP &pp, std::vector<block> &vec_K0, std::vector<block> &vec_K1, size_t EXTEND_LEN)
+void RandomSend(Channel &io, PP &pp, std::vector<block> &vec_K0, std::vector<block> &vec_K1, size_t EXTEND_LEN)
 {
+    auto phase = io.Phase("IKNP OTE"); 
     // prepare to receive a secret shared matrix Q from receiver
     PRG::Seed seed = PRG::SetSeed(nullptr, 0); // initialize PRG seed
     
@@ -108,7 +109,7 @@ void RandomSend(NetIO &io, PP &pp, std::vector<block> &vec_K0, std::vector<block
     // first receive 1-out-2 two keys from the receiver 
     std::vector<block> vec_inner_K = NPOT::Receive(io, pp.baseOT, vec_sender_selection_bit, COLUMN_NUM);
 
-    std::cout << "IKNP OTE [step 1]: Sender obliviously get " << pp.BASE_LEN 
+    ProtocolLog() << "IKNP OTE [step 1]: Sender obliviously get " << pp.BASE_LEN 
               << " number of keys from Receiver via base OT" << std::endl; 
     /* 
     ** invoke base OT BASE_LEN times to obtain a matrix Q
@@ -119,7 +120,6 @@ void RandomSend(NetIO &io, PP &pp, std::vector<block> &vec_K0, std::vector<block
     std::vector<block> vec_inner_C1(ROW_NUM/128); 
 
     std::vector<block> vec_inner_pad(ROW_NUM/128); // the one-time pad used to decrypt C
-    std::vector<block> vec_inner_plaintext(ROW_NUM/128);   // the plaintext
     
     std::vector<block> Q(ROW_NUM/128 * COLUMN_NUM); // the matrix sender is going to receive from receiver (dense form)
     
@@ -131,46 +131,40 @@ void RandomSend(NetIO &io, PP &pp, std::vector<block> &vec_K0, std::vector<block
 
         // use K[i] as seed to derive the one-time pad
         PRG::ReSeed(seed, &vec_inner_K[j], 0);    
-        vec_inner_pad = PRG::GenRandomBlocks(seed, ROW_NUM/128);
+        PRG::Fill(seed, vec_inner_pad.data(), ROW_NUM/128);
 
-        if(vec_sender_selection_bit[j] == 0){
-            vec_inner_plaintext = Block::XOR(vec_inner_C0, vec_inner_pad);
-        }
-        else{
-            vec_inner_plaintext = Block::XOR(vec_inner_C1, vec_inner_pad);   
-        } 
-        memcpy(Q.data()+j*ROW_NUM/128, vec_inner_plaintext.data(), ROW_NUM/8); 
+        // decrypt straight into the j-th column of Q
+        const block *vec_inner_C = (vec_sender_selection_bit[j] == 0) ? vec_inner_C0.data() : vec_inner_C1.data(); 
+        Block::XorInto(Q.data()+j*ROW_NUM/128, vec_inner_C, vec_inner_pad.data(), ROW_NUM/128); 
     }   
 
     #ifdef DEBUG
-        std::cout << "IKNP OTE: Sender obliviously get "<< COLUMN_NUM << " pair of ciphertexts from Receiver" << std::endl; 
+        ProtocolLog() << "IKNP OTE: Sender obliviously get "<< COLUMN_NUM << " pair of ciphertexts from Receiver" << std::endl; 
     #endif
     
 
-    // transpose Q
-    std::vector<block> Q_transpose(ROW_NUM/128 * COLUMN_NUM); 
-    BitMatrixTranspose((uint8_t*)Q.data(), COLUMN_NUM, ROW_NUM, (uint8_t*)Q_transpose.data());  
-
-    #ifdef DEBUG
-        std::cout << "IKNP OTE: Sender transposes matrix Q" << std::endl; 
-    #endif
-
     // generate dense representation of selection block
     std::vector<block> vec_sender_selection_block(COLUMN_NUM/128); 
     Block::FromSparseBytes(vec_sender_selection_bit.data(), COLUMN_NUM, vec_sender_selection_block.data(), COLUMN_NUM/128); 
 
-    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-    for(auto i = 0; i < ROW_NUM; i++){
-        std::vector<block> Q_row_block(COLUMN_NUM/128);
-        memcpy(Q_row_block.data(), Q_transpose.data()+i*COLUMN_NUM/128, COLUMN_NUM/8); 
-        vec_K0[i] = Hash::FastBlocksToBlock(Q_row_block); 
-        vec_K1[i] = Hash::FastBlocksToBlock(Block::XOR(Q_row_block, vec_sender_selection_block));
-    }
+    // transpose Q tile by tile and hash the rows of each tile right away, tweaked by the row index
+    FastBitMatrixTransposeRows(Q.data(), COLUMN_NUM, ROW_NUM, [&](size_t ROW_BEGIN, block *Q_rows){
+        Hash::TCRHashRows(Q_rows, 128, COLUMN_NUM/128, vec_K0.data()+ROW_BEGIN, ROW_BEGIN); 
+        for(auto i = 0; i < 128; i++){
+            Block::XorInto(Q_rows+i*COLUMN_NUM/128, Q_rows+i*COLUMN_NUM/128, vec_sender_selection_block.data(), COLUMN_NUM/128);
+        }
+        Hash::TCRHashRows(Q_rows, 128, COLUMN_NUM/128, vec_K1.data()+ROW_BEGIN, ROW_BEGIN); 
+    }); 
+
+    #ifdef DEBUG
+        ProtocolLog() << "IKNP OTE: Sender transposes matrix Q" << std::endl; 
+    #endif
 }
 
-void RandomReceive(NetIO &io, PP &pp, std::vector<block> &vec_K, 
-                    std::vector<uint8_t> &vec_receiver_selection_bit, size_t EXTEND_LEN)
+void RandomReceive(Channel &io, PP &pp, std::vector<block> &vec_K, 
+                    const BitVector &vec_receiver_selection_bit, size_t EXTEND_LEN)
 {
+    auto phase = io.Phase("IKNP OTE"); 
     PRG::Seed seed = PRG::SetSeed(nullptr, 0); 
 
     size_t ROW_NUM = EXTEND_LEN;
@@ -185,15 +179,19 @@ void RandomReceive(NetIO &io, PP &pp, std::vector<block> &vec_K,
     
     NPOT::Send(io, pp.baseOT, vec_inner_K0, vec_inner_K1, COLUMN_NUM); 
 
-    std::cout << "IKNP OTE [step 1]: Receiver transmits "<< pp.BASE_LEN << " number of keys to Sender via base OT" 
+    ProtocolLog() << "IKNP OTE [step 1]: Receiver transmits "<< pp.BASE_LEN << " number of keys to Sender via base OT" 
               << std::endl; 
 
     // generate the dense representation of selection block
     std::vector<block> vec_receiver_selection_block(ROW_NUM/128); 
-    Block::FromSparseBytes(vec_receiver_selection_bit.data(), ROW_NUM, vec_receiver_selection_block.data(), ROW_NUM/128); 
+    if(vec_receiver_selection_bit.Size() != ROW_NUM){
+        std::cerr << "size of selection bits does not match" << std::endl; 
+        exit(EXIT_FAILURE); 
+    }
+    // the packed bits are already in block order
+    memcpy(vec_receiver_selection_block.data(), vec_receiver_selection_bit.Data(), ROW_NUM/8); 
 
     // Phase 1: transmit ciphertext a.k.a. random shared matrix
-    std::vector<block> vec_inner_m0(ROW_NUM/128); 
     std::vector<block> vec_inner_m1(ROW_NUM/128); 
 
     std::vector<block> vec_inner_C0(ROW_NUM/128); 
@@ -203,53 +201,46 @@ void RandomReceive(NetIO &io, PP &pp, std::vector<block> &vec_K,
     // for every column: prepare two column vectors
     for(auto j = 0; j < COLUMN_NUM; j++)
     {
-        // set vec_m0 be the jth column of T
-        memcpy(vec_inner_m0.data(), T.data() + j*ROW_NUM/128, ROW_NUM/8); 
+        // m0 is the jth column of T
+        const block *vec_inner_m0 = T.data() + j*ROW_NUM/128; 
 
         // set vec_m1 = vec_m0 xor selection_block
-        vec_inner_m1 = Block::XOR(vec_inner_m0, vec_receiver_selection_block);
+        Block::XorInto(vec_inner_m1.data(), vec_inner_m0, vec_receiver_selection_block.data(), ROW_NUM/128);
 
         PRG::ReSeed(seed, &vec_inner_K0[j], 0); 
-        vec_inner_pad = PRG::GenRandomBlocks(seed, ROW_NUM/128);
-        vec_inner_C0 = Block::XOR(vec_inner_m0, vec_inner_pad); 
+        PRG::Fill(seed, vec_inner_pad.data(), ROW_NUM/128);
+        Block::XorInto(vec_inner_C0.data(), vec_inner_m0, vec_inner_pad.data(), ROW_NUM/128); 
         
         PRG::ReSeed(seed, &vec_inner_K1[j], 0); 
-        vec_inner_pad = PRG::GenRandomBlocks(seed, ROW_NUM/128);
-        vec_inner_C1 = Block::XOR(vec_inner_m1, vec_inner_pad);
+        PRG::Fill(seed, vec_inner_pad.data(), ROW_NUM/128);
+        Block::XorInto(vec_inner_C1.data(), vec_inner_m1.data(), vec_inner_pad.data(), ROW_NUM/128);
 
         io.SendBlocks(vec_inner_C0.data(), ROW_NUM/128); 
         io.SendBlocks(vec_inner_C1.data(), ROW_NUM/128);
     }   
 
-    std::cout << "IKNP OTE [step 2]: Receiver ===> 2 encrypted matrix ===> Sender" 
-              << " [" << (double)COLUMN_NUM*ROW_NUM/128*16*2/(1024*1024) << " MB]" << std::endl; 
+    ProtocolLog() << "IKNP OTE [step 2]: Receiver ===> 2 encrypted matrix ===> Sender" << std::endl; 
     
-    std::vector<block> T_transpose(ROW_NUM/128 * COLUMN_NUM); 
-    BitMatrixTranspose((uint8_t*)T.data(), COLUMN_NUM, ROW_NUM, (uint8_t*)T_transpose.data());
+    // transpose T tile by tile and hash the rows of each tile right away, tweaked by the row index
+    FastBitMatrixTransposeRows(T.data(), COLUMN_NUM, ROW_NUM, [&](size_t ROW_BEGIN, block *T_rows){
+        Hash::TCRHashRows(T_rows, 128, COLUMN_NUM/128, vec_K.data()+ROW_BEGIN, ROW_BEGIN); 
+    }); 
 
     #ifdef DEBUG
-        std::cout << "IKNP OTE: Receiver transposes matrix T" << std::endl; 
+        ProtocolLog() << "IKNP OTE: Receiver transposes matrix T" << std::endl; 
     #endif
-
-    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-    for(auto i = 0; i < ROW_NUM; i++)
-    {
-        std::vector<block> T_row(COLUMN_NUM/128);  
-        memcpy(T_row.data(), T_transpose.data()+i*COLUMN_NUM/128, COLUMN_NUM/8); 
-        
-        vec_K[i] = Hash::FastBlocksToBlock(T_row); 
-    }  
 }
 
-void Send(NetIO &io, PP &pp, std::vector<block> &vec_m0, std::vector<block> &vec_m1, size_t EXTEND_LEN) 
+void Send(Channel &io, PP &pp, std::vector<block> &vec_m0, std::vector<block> &vec_m1, size_t EXTEND_LEN) 
 {
+    auto phase = io.Phase("IKNP OTE"); 
     /* 
     ** Phase 1: sender obtains a random secret sharing matrix Q of matrix T from receiver
     ** T is a tall matrix, to use base OT oblivious transfer T, 
     ** the sender first oblivous get 1-out-of-2 keys per column from receiver via base OT 
     ** receiver then send encryptions of the original column and shared column under k0 and k1 respectively
     */
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 	auto start_time = std::chrono::steady_clock::now(); 
 
     // prepare to receive a secret shared matrix Q from receiver
@@ -267,30 +258,26 @@ void Send(NetIO &io, PP &pp, std::vector<block> &vec_m0, std::vector<block> &vec
     std::vector<block> vec_outer_C0(ROW_NUM); 
     std::vector<block> vec_outer_C1(ROW_NUM); 
 
-    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-    for(auto i = 0; i < ROW_NUM; i++)
-    {       
-        vec_outer_C0[i] = vec_m0[i]^vec_K0[i]; 
-        vec_outer_C1[i] = vec_m1[i]^vec_K1[i];
-    }
+    Block::XorInto(vec_outer_C0.data(), vec_m0.data(), vec_K0.data(), ROW_NUM); 
+    Block::XorInto(vec_outer_C1.data(), vec_m1.data(), vec_K1.data(), ROW_NUM); 
     io.SendBlocks(vec_outer_C0.data(), ROW_NUM); 
     io.SendBlocks(vec_outer_C1.data(), ROW_NUM);
 
     
-    std::cout << "IKNP OTE [step 3]: Sender ===> (vec_C0, vec_C1) ===> Receiver" 
-              << "[" << (double)ROW_NUM*16*2/(1024*1024) << " MB]" << std::endl; 
+    ProtocolLog() << "IKNP OTE [step 3]: Sender ===> (vec_C0, vec_C1) ===> Receiver" << std::endl; 
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "IKNP OTE: Sender side takes time " 
+    ProtocolLog() << "IKNP OTE: Sender side takes time " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 }
 
 
-std::vector<block> Receive(NetIO &io, PP &pp, std::vector<uint8_t> &vec_receiver_selection_bit, size_t EXTEND_LEN)
+std::vector<block> Receive(Channel &io, PP &pp, const BitVector &vec_receiver_selection_bit, size_t EXTEND_LEN)
 {
-    PrintSplitLine('-'); 
+    auto phase = io.Phase("IKNP OTE"); 
+    LogSplitLine('-'); 
   
     auto start_time = std::chrono::steady_clock::now(); 
 
@@ -312,7 +299,7 @@ std::vector<block> Receive(NetIO &io, PP &pp, std::vector<uint8_t> &vec_receiver
     io.ReceiveBlocks(vec_outer_C1.data(), ROW_NUM);
 
     #ifdef DEBUG
-        std::cout << "IKNP OTE: Receiver get "<< ROW_NUM << " pair of ciphertexts from Sender" << std::endl; 
+        ProtocolLog() << "IKNP OTE: Receiver get "<< ROW_NUM << " pair of ciphertexts from Sender" << std::endl; 
     #endif
 
     std::vector<block> vec_result(ROW_NUM);
@@ -328,31 +315,32 @@ std::vector<block> Receive(NetIO &io, PP &pp, std::vector<uint8_t> &vec_receiver
     }   
 
     #ifdef DEBUG
-        std::cout << "IKNP OTE: Receiver obtains "<< ROW_NUM << " number of messages from Sender" << std::endl; 
-        PrintSplitLine('*'); 
+        ProtocolLog() << "IKNP OTE: Receiver obtains "<< ROW_NUM << " number of messages from Sender" << std::endl; 
+        LogSplitLine('*'); 
     #endif
 
-    std::cout << "IKNP OTE [step 4]: Receiver obtains vec_m" << std::endl; 
+    ProtocolLog() << "IKNP OTE [step 4]: Receiver obtains vec_m" << std::endl; 
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "IKNP OTE: Receiver side takes time " 
+    ProtocolLog() << "IKNP OTE: Receiver side takes time " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
 
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 
     return vec_result; 
 }
 
-void OnesidedSend(NetIO &io, PP &pp, std::vector<block> &vec_m, size_t EXTEND_LEN) 
+void OnesidedSend(Channel &io, PP &pp, std::vector<block> &vec_m, size_t EXTEND_LEN) 
 {
+    auto phase = io.Phase("IKNP OTE"); 
     /* 
     ** Phase 1: sender obtains a random secret sharing matrix Q of matrix T from receiver
     ** T is a tall matrix, to use base OT oblivious transfer T, 
     ** the sender first oblivous get 1-out-of-2 keys per column from receiver via base OT 
     ** receiver then send encryptions of the original column and shared column under k0 and k1 respectively
     */	
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 	
     auto start_time = std::chrono::steady_clock::now(); 
 
@@ -370,33 +358,29 @@ void OnesidedSend(NetIO &io, PP &pp, std::vector<block> &vec_m, size_t EXTEND_LE
     // begin to transmit the real message
     std::vector<block> vec_outer_C(ROW_NUM);
 
-    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-    for(auto i = 0; i < ROW_NUM; i++)
-    {
-        vec_outer_C[i] = vec_m[i]^vec_K1[i];
-    }
+    Block::XorInto(vec_outer_C.data(), vec_m.data(), vec_K1.data(), ROW_NUM); 
     io.SendBlocks(vec_outer_C.data(), ROW_NUM); 
 
-    std::cout << "IKNP OTE [step 3]: Sender ===> vec_C ===> Receiver" << " [" 
-              << (double)ROW_NUM*16/(1024*1024) << " MB]" << std::endl;
+    ProtocolLog() << "IKNP OTE [step 3]: Sender ===> vec_C ===> Receiver" << std::endl; 
 
     #ifdef DEBUG
-        std::cout << "IKNP OTE: Sender sends "<< ROW_NUM << " number of ciphertexts to receiver" << std::endl; 
-        PrintSplitLine('*'); 
+        ProtocolLog() << "IKNP OTE: Sender sends "<< ROW_NUM << " number of ciphertexts to receiver" << std::endl; 
+        LogSplitLine('*'); 
     #endif
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "IKNP OTE: Sender side takes time " 
+    ProtocolLog() << "IKNP OTE: Sender side takes time " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
 
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 }
 
 // the size of vec_result = the hamming weight of vec_selection_bit
-std::vector<block> OnesidedReceive(NetIO &io, PP &pp, std::vector<uint8_t> &vec_receiver_selection_bit, size_t EXTEND_LEN)
+std::vector<block> OnesidedReceive(Channel &io, PP &pp, const BitVector &vec_receiver_selection_bit, size_t EXTEND_LEN)
 {
-    PrintSplitLine('-'); 
+    auto phase = io.Phase("IKNP OTE"); 
+    LogSplitLine('-'); 
 
     std::vector<block> vec_result;
     // first act as sender in base OT
@@ -424,21 +408,35 @@ std::vector<block> OnesidedReceive(NetIO &io, PP &pp, std::vector<uint8_t> &vec_
     }   
 
     #ifdef DEBUG
-        std::cout << "IKNP OTE: Receiver get "<< ROW_NUM << " number of ciphertexts from Sender" << std::endl; 
-        PrintSplitLine('*'); 
+        ProtocolLog() << "IKNP OTE: Receiver get "<< ROW_NUM << " number of ciphertexts from Sender" << std::endl; 
+        LogSplitLine('*'); 
     #endif
 
-    std::cout << "IKNP OTE [step 4]: Receiver obtains vec_m" << std::endl; 
+    ProtocolLog() << "IKNP OTE [step 4]: Receiver obtains vec_m" << std::endl; 
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "IKNP OTE: Receiver side takes time " 
+    ProtocolLog() << "IKNP OTE: Receiver side takes time " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
 
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 
     return vec_result; 
 }
 
+/* 
+** the receivers above take packed selection bits;
+** these overloads keep accepting one selection bit per byte
+*/
+std::vector<block> Receive(Channel &io, PP &pp, const std::vector<uint8_t> &vec_receiver_selection_bit, size_t EXTEND_LEN)
+{
+    return Receive(io, pp, PackSelectionBits(vec_receiver_selection_bit, EXTEND_LEN), EXTEND_LEN); 
+}
+
+std::vector<block> OnesidedReceive(Channel &io, PP &pp, const std::vector<uint8_t> &vec_receiver_selection_bit, size_t EXTEND_LEN)
+{
+    return OnesidedReceive(io, pp, PackSelectionBits(vec_receiver_selection_bit, EXTEND_LEN), EXTEND_LEN); 
+}
+
 }
 #endif
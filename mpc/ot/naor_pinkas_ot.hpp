@@ -8,6 +8,7 @@
 
 #include "../../include/std.inc"
 #include "../../crypto/ec_point.hpp"
+#include "../../crypto/ec_ristretto.hpp"
 #include "../../crypto/hash.hpp"
 #include "../../netio/stream_channel.hpp"
 
@@ -18,11 +19,13 @@
  * https://dl.acm.org/doi/10.5555/365411.365502
 */
 
+// runs on GroupPoint: define ENABLE_RISTRETTO_GROUP to switch from the OpenSSL curve to ristretto255
 namespace NPOT{
 
 struct PP
 {
-	ECPoint g;
+	GroupPoint g;
+	bool G_IS_GENERATOR = false;
 };
 
 
@@ -44,13 +47,15 @@ std::ofstream &operator<<(std::ofstream &fout, const PP &pp)
 std::ifstream &operator>>(std::ifstream &fin, PP &pp)
 {
 	fin >> pp.g; 
+	pp.G_IS_GENERATOR = (pp.g == GroupGenerator()); 
 	return fin; 
 }
 
 PP Setup()
 {
 	PP pp; 
-	pp.g = ECPoint(generator);
+	pp.g = GroupGenerator();
+	pp.G_IS_GENERATOR = true; 
 	return pp; 
 }
 
@@ -82,30 +87,30 @@ void FetchPP(PP &pp, std::string pp_filename)
     fin.close(); 
 }
 
-void Send(NetIO &io, PP &pp, const std::vector<block>& vec_m0, const std::vector<block> &vec_m1, size_t LEN)
+void Send(Channel &io, PP &pp, const std::vector<block>& vec_m0, const std::vector<block> &vec_m1, size_t LEN)
 {	
-	PrintSplitLine('-');
+	auto phase = io.Phase("Naor-Pinkas OT"); 
+	LogSplitLine('-');
 	auto start_time = std::chrono::steady_clock::now(); 
 
 	if(vec_m0.size()!=LEN || vec_m1.size()!=LEN){
 		std::cerr << "size does not match" << std::endl; 
 	} 
 
-	std::vector<BigInt> vec_r(LEN); // randomness used for encryption
-	std::vector<ECPoint> vec_pk0(LEN);
+	std::vector<BigInt> vec_r = GenRandomBigIntVectorLessThan(LEN, GroupOrder()); // randomness used for encryption
+	std::vector<GroupPoint> vec_pk0(LEN);
 
-	std::vector<ECPoint> vec_X(LEN); // the first ciphertext component 
-	std::vector<ECPoint> vec_Z(LEN); // the initial form of second ciphertext component 
+	std::vector<GroupPoint> vec_X(LEN); // the first ciphertext component 
+	std::vector<GroupPoint> vec_Z(LEN); // the initial form of second ciphertext component 
 
 	// offline process
-	BigInt d = GenRandomBigIntLessThan(order);
-	ECPoint C = pp.g * d;  // compute C = g^d
+	BigInt d = GenRandomBigIntLessThan(GroupOrder());
+	GroupPoint C = GPower(pp.g, pp.G_IS_GENERATOR, d);  // compute C = g^d
 
 	//  compute g^r[i] and C^r[i]
 	#pragma omp parallel for num_threads(NUMBER_OF_THREADS)
 	for(auto i = 0; i < LEN; i++) {
-		vec_r[i] = GenRandomBigIntLessThan(order);
-		vec_X[i] = pp.g * vec_r[i];
+		vec_X[i] = GPower(pp.g, pp.G_IS_GENERATOR, vec_r[i]);
 		vec_Z[i] = C * vec_r[i];
 	}
 
@@ -113,13 +118,12 @@ void Send(NetIO &io, PP &pp, const std::vector<block>& vec_m0, const std::vector
 	io.SendECPoints(&C, 1);
 	io.SendECPoints(vec_X.data(), LEN); 
 
-	std::cout <<"Naor-Pinkas OT [step 1]: Sender ===> (C, vec_X) ===> Receiver";
-    std::cout << " [" << (double)POINT_BYTE_LEN*(LEN+1)/(1024*1024) << " MB]" << std::endl;
+	ProtocolLog() <<"Naor-Pinkas OT [step 1]: Sender ===> (C, vec_X) ===> Receiver" << std::endl;
 
 	io.ReceiveECPoints(vec_pk0.data(), LEN); 
 
-	std::vector<ECPoint> vec_K0(LEN); // session key
-	std::vector<ECPoint> vec_K1(LEN); // session key
+	std::vector<GroupPoint> vec_K0(LEN); // session key
+	std::vector<GroupPoint> vec_K1(LEN); // session key
 	std::vector<block> vec_Y0(LEN);  
 	std::vector<block> vec_Y1(LEN); 
 
@@ -128,46 +132,51 @@ void Send(NetIO &io, PP &pp, const std::vector<block>& vec_m0, const std::vector
 	for(auto i = 0 ; i < LEN; ++i) {
 		vec_K0[i] = vec_pk0[i] * vec_r[i];
 		vec_K1[i] = vec_Z[i] - vec_K0[i];
-		vec_Y0[i] = Hash::ECPointToBlock(vec_K0[i]) ^ vec_m0[i];
-		vec_Y1[i] = Hash::ECPointToBlock(vec_K1[i]) ^ vec_m1[i];
+	}
+	// hash the session keys in batch
+	Hash::ECPointsToBlocks(vec_K0.data(), LEN, vec_Y0.data()); 
+	Hash::ECPointsToBlocks(vec_K1.data(), LEN, vec_Y1.data()); 
+	#pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+	for(auto i = 0 ; i < LEN; ++i) {
+		vec_Y0[i] ^= vec_m0[i];
+		vec_Y1[i] ^= vec_m1[i];
 	}
 
 	io.SendBlocks(vec_Y0.data(), LEN);
 	io.SendBlocks(vec_Y1.data(), LEN);
 
-	std::cout <<"Naor-Pinkas OT [step 3]: Sender ===> (vec_Y0, vec_Y1) ===> Receiver";
-    std::cout << " [" << (double)POINT_BYTE_LEN*LEN*2/(1024*1024) << " MB]" << std::endl;
+	ProtocolLog() <<"Naor-Pinkas OT [step 3]: Sender ===> (vec_Y0, vec_Y1) ===> Receiver" << std::endl;
 
 	auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "Naor-Pinkas OT: Sender side takes time " 
+    ProtocolLog() << "Naor-Pinkas OT: Sender side takes time " 
 	          << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
 
-	PrintSplitLine('-');
+	LogSplitLine('-');
 }
 
-std::vector<block> Receive(NetIO &io, PP &pp, const std::vector<uint8_t> &vec_selection_bit, size_t LEN)
+std::vector<block> Receive(Channel &io, PP &pp, const std::vector<uint8_t> &vec_selection_bit, size_t LEN)
 {	
-	PrintSplitLine('-');
+	auto phase = io.Phase("Naor-Pinkas OT"); 
+	LogSplitLine('-');
 	auto start_time = std::chrono::steady_clock::now(); 
 	std::vector<block> vec_result(LEN);  
 	if(vec_result.size()!=LEN || vec_selection_bit.size()!=LEN){
 		std::cerr << "size does not match" << std::endl; 
 	}
 
-	std::vector<BigInt> vec_sk(LEN);
-	std::vector<ECPoint> vec_X(LEN); 
-	std::vector<ECPoint> vec_pk0(LEN);
+	std::vector<BigInt> vec_sk = GenRandomBigIntVectorLessThan(LEN, GroupOrder());
+	std::vector<GroupPoint> vec_X(LEN); 
+	std::vector<GroupPoint> vec_pk0(LEN);
 	
-	ECPoint C; 	
+	GroupPoint C; 	
 	io.ReceiveECPoints(&C, 1); 
 	io.ReceiveECPoints(vec_X.data(), LEN);
 
 	// send pk0[i]
 	#pragma omp parallel for num_threads(NUMBER_OF_THREADS)
 	for(auto i = 0; i < LEN; i++) {
-		vec_sk[i] = GenRandomBigIntLessThan(order);
-		vec_pk0[i] = pp.g * vec_sk[i];
+		vec_pk0[i] = GPower(pp.g, pp.G_IS_GENERATOR, vec_sk[i]);
 		if(vec_selection_bit[i] == 1){
 			vec_pk0[i] = C - vec_pk0[i]; 
 		}
@@ -175,11 +184,10 @@ std::vector<block> Receive(NetIO &io, PP &pp, const std::vector<uint8_t> &vec_se
 
 	io.SendECPoints(vec_pk0.data(), LEN);
 
-	std::cout <<"Naor-Pinkas OT [step 2]: Receiver ===> vec_pk0 ===> Sender";
-    std::cout << " [" << (double)POINT_BYTE_LEN*LEN/(1024*1024) << " MB]" << std::endl;
+	ProtocolLog() <<"Naor-Pinkas OT [step 2]: Receiver ===> vec_pk0 ===> Sender" << std::endl;
 
 	// compute Kb[i]
-	std::vector<ECPoint> vec_K(LEN); 
+	std::vector<GroupPoint> vec_K(LEN); 
 	std::vector<block> vec_Y0(LEN); 
 	std::vector<block> vec_Y1(LEN); 
 
@@ -190,22 +198,27 @@ std::vector<block> Receive(NetIO &io, PP &pp, const std::vector<uint8_t> &vec_se
 	#pragma omp parallel for num_threads(NUMBER_OF_THREADS)
 	for(auto i = 0; i < LEN; i++) {
 		vec_K[i] = vec_X[i] * vec_sk[i];
+	}
+	// hash the session keys in batch
+	Hash::ECPointsToBlocks(vec_K.data(), LEN, vec_result.data()); 
+	#pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+	for(auto i = 0; i < LEN; i++) {
 		if(vec_selection_bit[i] == 0){
-			vec_result[i] = vec_Y0[i] ^ Hash::ECPointToBlock(vec_K[i]);
+			vec_result[i] ^= vec_Y0[i];
 		}
 		else{
-			vec_result[i] = vec_Y1[i] ^ Hash::ECPointToBlock(vec_K[i]);
+			vec_result[i] ^= vec_Y1[i];
 		}
 	}
 
-	std::cout <<"Naor-Pinkas OT [step 4]: Receiver obtains vec_m" << std::endl;
+	ProtocolLog() <<"Naor-Pinkas OT [step 4]: Receiver obtains vec_m" << std::endl;
 
 	auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "Naor-Pinkas OT: Receiver side takes time " 
+    ProtocolLog() << "Naor-Pinkas OT: Receiver side takes time " 
 	          << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
 
-    PrintSplitLine('-');
+    LogSplitLine('-');
 	return vec_result; 
 }
 
@@ -3,12 +3,14 @@
 
 #include "../../include/std.inc"
 #include "../../crypto/ec_point.hpp"
+#include "../../crypto/ec_ristretto.hpp"
 #include "../../crypto/hash.hpp"
 #include "../../netio/stream_channel.hpp"
 
 
 /*
 ** implement DDH-based PEQT based on DDH-based OPRF
+** runs on GroupPoint: define ENABLE_RISTRETTO_GROUP to switch from the OpenSSL curve to ristretto255
 */
 
 namespace DDHPEQT{
@@ -16,9 +18,10 @@ namespace DDHPEQT{
 using Serialization::operator<<; 
 using Serialization::operator>>; 
 
-std::vector<uint64_t> Send(NetIO &io, std::vector<block> &vec_Y, size_t ROW_NUM, size_t COLUMN_NUM)
+std::vector<uint64_t> Send(Channel &io, std::vector<block> &vec_Y, size_t ROW_NUM, size_t COLUMN_NUM)
 {
-    PrintSplitLine('-'); 
+    auto phase = io.Phase("DDH-based PEQT"); 
+    LogSplitLine('-'); 
     auto start_time = std::chrono::steady_clock::now(); 
     
     size_t LEN = vec_Y.size(); 
@@ -26,7 +29,7 @@ std::vector<uint64_t> Send(NetIO &io, std::vector<block> &vec_Y, size_t ROW_NUM,
         std::cerr << "size does not match" << std::endl; 
     }
 
-    BigInt k = GenRandomBigIntLessThan(order); // pick a key k
+    BigInt k = GenRandomBigIntLessThan(GroupOrder()); // pick a key k
 
     std::vector<uint64_t> row_map(ROW_NUM);
     for(auto i = 0; i < ROW_NUM; i++) row_map[i] = i; 
@@ -43,51 +46,44 @@ std::vector<uint64_t> Send(NetIO &io, std::vector<block> &vec_Y, size_t ROW_NUM,
         }
     }
 
-    std::vector<ECPoint> vec_Fk_permuted_Y(LEN);
+    std::vector<GroupPoint> vec_Hash_Y(LEN); 
+    Hash::BlocksToECPoints(vec_Y.data(), LEN, vec_Hash_Y.data()); 
+    std::vector<GroupPoint> vec_Fk_permuted_Y(LEN);
     #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
     for(auto i = 0; i < LEN; i++){
-        vec_Fk_permuted_Y[permutation_map[i]] = Hash::BlockToECPoint(vec_Y[i]) * k; 
+        vec_Fk_permuted_Y[permutation_map[i]] = vec_Hash_Y[i] * k; 
     }
     
-    std::vector<ECPoint> vec_mask_X(LEN); 
+    std::vector<GroupPoint> vec_mask_X(LEN); 
     io.ReceiveECPoints(vec_mask_X.data(), LEN);     
     
     io.SendECPoints(vec_Fk_permuted_Y.data(), LEN); 
-    std::cout <<"DDH-based PEQT [step 2]: Sender ===> Permutation[F_k(y_i)] ===> Receiver";
-    #ifdef ECPOINT_COMPRESSED
-        std::cout << " [" << (double)POINT_COMPRESSED_BYTE_LEN*LEN/(1024*1024) << " MB]" << std::endl;
-    #else
-        std::cout << " [" << (double)POINT_BYTE_LEN*LEN/(1024*1024) << " MB]" << std::endl;
-    #endif
+    ProtocolLog() <<"DDH-based PEQT [step 2]: Sender ===> Permutation[F_k(y_i)] ===> Receiver" << std::endl;
 
 
-    std::vector<ECPoint> vec_Fk_permuted_mask_X(LEN);
+    std::vector<GroupPoint> vec_Fk_permuted_mask_X(LEN);
     #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
     for(auto i = 0; i < LEN; i++){
         vec_Fk_permuted_mask_X[permutation_map[i]] = vec_mask_X[i] * k; 
     }
     
     io.SendECPoints(vec_Fk_permuted_mask_X.data(), LEN); 
-    std::cout <<"DDH-based PEQT [step 2]: Sender ===> Permutation[F_k(mask_x_i)] ===> Receiver";
-    #ifdef ECPOINT_COMPRESSED
-        std::cout << " [" << (double)POINT_COMPRESSED_BYTE_LEN*LEN/(1024*1024) << " MB]" << std::endl;
-    #else
-        std::cout << " [" << (double)POINT_BYTE_LEN*LEN/(1024*1024) << " MB]" << std::endl;
-    #endif
+    ProtocolLog() <<"DDH-based PEQT [step 2]: Sender ===> Permutation[F_k(mask_x_i)] ===> Receiver" << std::endl;
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "DDH-based PEQT: Sender side takes time = " 
+    ProtocolLog() << "DDH-based PEQT: Sender side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
     
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 
     return permutation_map; 
 }
 
-std::vector<uint8_t> Receive(NetIO &io, std::vector<block> &vec_X, size_t ROW_NUM, size_t COLUMN_NUM) 
+std::vector<uint8_t> Receive(Channel &io, std::vector<block> &vec_X, size_t ROW_NUM, size_t COLUMN_NUM) 
 {    
-    PrintSplitLine('-'); 
+    auto phase = io.Phase("DDH-based PEQT"); 
+    LogSplitLine('-'); 
     
     size_t LEN = vec_X.size(); 
     if(LEN != ROW_NUM*COLUMN_NUM){
@@ -96,31 +92,27 @@ std::vector<uint8_t> Receive(NetIO &io, std::vector<block> &vec_X, size_t ROW_NU
 
     auto start_time = std::chrono::steady_clock::now(); 
 
-    BigInt r = GenRandomBigIntLessThan(order); // pick a key
+    BigInt r = GenRandomBigIntLessThan(GroupOrder()); // pick a key
 
-    std::vector<ECPoint> vec_mask_X(LEN); 
+    std::vector<GroupPoint> vec_mask_X(LEN); 
+    Hash::BlocksToECPoints(vec_X.data(), LEN, vec_mask_X.data()); 
     #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
     for(auto i = 0; i < LEN; i++){
-        vec_mask_X[i] = Hash::BlockToECPoint(vec_X[i]) * r; 
+        vec_mask_X[i] = vec_mask_X[i] * r; 
     } 
 
     io.SendECPoints(vec_mask_X.data(), LEN);
 
-    std::cout <<"DDH-based PEQT [step 1]: Receiver ===> mask_x_i ===> Sender"; 
-    #ifdef ECPOINT_COMPRESSED
-        std::cout << " [" << (double)POINT_COMPRESSED_BYTE_LEN*LEN/(1024*1024) << " MB]" << std::endl;
-    #else
-        std::cout << " [" << (double)POINT_BYTE_LEN*LEN/(1024*1024) << " MB]" << std::endl;
-    #endif
+    ProtocolLog() <<"DDH-based PEQT [step 1]: Receiver ===> mask_x_i ===> Sender" << std::endl; 
 
-    std::vector<ECPoint> vec_Fk_permuted_Y(LEN);
+    std::vector<GroupPoint> vec_Fk_permuted_Y(LEN);
     io.ReceiveECPoints(vec_Fk_permuted_Y.data(), LEN); // receive Fk_permuted_Y from Sender
 
-    std::vector<ECPoint> vec_Fk_permuted_mask_X(LEN);
+    std::vector<GroupPoint> vec_Fk_permuted_mask_X(LEN);
     io.ReceiveECPoints(vec_Fk_permuted_mask_X.data(), LEN); // receive Fk_permuted_Y from Sender
 
     std::vector<uint8_t> vec_result(LEN);
-    BigInt r_inverse = r.ModInverse(order); 
+    BigInt r_inverse = r.ModInverse(GroupOrder()); 
     #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
     for(auto i = 0; i < LEN; i++){
         vec_result[i] = vec_Fk_permuted_Y[i].CompareTo(vec_Fk_permuted_mask_X[i] * r_inverse); 
@@ -128,10 +120,10 @@ std::vector<uint8_t> Receive(NetIO &io, std::vector<block> &vec_X, size_t ROW_NU
     
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "DDH-based PEQT: Receiver side takes time = " 
+    ProtocolLog() << "DDH-based PEQT: Receiver side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
     
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 
     return vec_result; 
 }
@@ -117,14 +117,15 @@ void FetchPP(PP &pp, std::string pp_filename)
     fin.close(); 
 }
 
-void Send(NetIO &io, PP &pp, std::vector<block> &vec_Y)
+void Send(Channel &io, PP &pp, std::vector<block> &vec_Y)
 {
+    auto phase = io.Phase("cwPRF-based PSI"); 
     if(vec_Y.size() != pp.SENDER_ITEM_NUM){
         std::cerr << "input size of vec_Y does not match public parameters" << std::endl;
         exit(1);  // EXIT_FAILURE  
     }
 
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
     auto start_time = std::chrono::steady_clock::now(); 
 
     uint8_t k1[32];
@@ -134,16 +135,15 @@ void Send(NetIO &io, PP &pp, std::vector<block> &vec_Y)
     std::vector<EC25519Point> vec_Hash_Y(pp.SENDER_ITEM_NUM);
     std::vector<EC25519Point> vec_Fk1_Y(pp.SENDER_ITEM_NUM);
 
+    Hash::BlocksToEC25519Points(vec_Y.data(), pp.SENDER_ITEM_NUM, vec_Hash_Y.data()); 
     #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
     for(auto i = 0; i < pp.SENDER_ITEM_NUM; i++){
-        Hash::BlockToBytes(vec_Y[i], vec_Hash_Y[i].px, 32); 
         x25519_scalar_mulx(vec_Fk1_Y[i].px, k1, vec_Hash_Y[i].px); 
     }
 
     io.SendEC25519Points(vec_Fk1_Y.data(), pp.SENDER_ITEM_NUM); 
     
-    std::cout <<"cwPRF-based PSI [step 1]: Sender ===> F_k1(y_i) ===> Receiver";
-    std::cout << " [" << 32*pp.SENDER_ITEM_NUM/(1024*1024) << " MB]" << std::endl;
+    ProtocolLog() <<"cwPRF-based PSI [step 1]: Sender ===> F_k1(y_i) ===> Receiver" << std::endl;
 
     std::vector<EC25519Point> vec_Fk2_X(pp.RECEIVER_ITEM_NUM); 
     io.ReceiveEC25519Points(vec_Fk2_X.data(), pp.RECEIVER_ITEM_NUM);
@@ -161,25 +161,25 @@ void Send(NetIO &io, PP &pp, std::vector<block> &vec_Y)
     }
 
     io.SendStringVector(vec_TRUNCATE_Fk1k2_X, pp.TRUNCATE_LEN); 
-    std::cout <<"cwPRF-based PSI [step 3]: Sender ===> Truncate(F_k1k2(x_i)) ===> Receiver";
-    std::cout << " [" << pp.TRUNCATE_LEN*pp.RECEIVER_ITEM_NUM/(1024*1024) << " MB]" << std::endl;
+    ProtocolLog() <<"cwPRF-based PSI [step 3]: Sender ===> Truncate(F_k1k2(x_i)) ===> Receiver" << std::endl;
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "cwPRF-based PSI: Sender side takes time = " 
+    ProtocolLog() << "cwPRF-based PSI: Sender side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
     
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 }
 
-std::vector<block> Receive(NetIO &io, PP &pp, std::vector<block> &vec_X) 
+std::vector<block> Receive(Channel &io, PP &pp, std::vector<block> &vec_X) 
 {    
+    auto phase = io.Phase("cwPRF-based PSI"); 
     if(vec_X.size() != pp.RECEIVER_ITEM_NUM){
         std::cerr << "input size of vec_X does not match public parameters" << std::endl;
         exit(1);  // EXIT_FAILURE  
     }
     
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
     auto start_time = std::chrono::steady_clock::now(); 
 
     uint8_t k2[32];
@@ -188,9 +188,9 @@ std::vector<block> Receive(NetIO &io, PP &pp, std::vector<block> &vec_X)
 
     std::vector<EC25519Point> vec_Hash_X(pp.RECEIVER_ITEM_NUM); 
     std::vector<EC25519Point> vec_Fk2_X(pp.RECEIVER_ITEM_NUM); 
+    Hash::BlocksToEC25519Points(vec_X.data(), pp.RECEIVER_ITEM_NUM, vec_Hash_X.data()); 
     #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
     for(auto i = 0; i < pp.RECEIVER_ITEM_NUM; i++){
-        Hash::BlockToBytes(vec_X[i], vec_Hash_X[i].px, 32); 
         x25519_scalar_mulx(vec_Fk2_X[i].px, k2, vec_Hash_X[i].px); 
     } 
 
@@ -201,9 +201,7 @@ std::vector<block> Receive(NetIO &io, PP &pp, std::vector<block> &vec_X)
     // then send
     io.SendEC25519Points(vec_Fk2_X.data(), pp.RECEIVER_ITEM_NUM);
 
-    std::cout <<"cwPRF-based PSI [step 2]: Receiver ===> F_k2(x_i) ===> Sender"; 
-
-    std::cout << " [" << 32*pp.RECEIVER_ITEM_NUM/(1024*1024) << " MB]" << std::endl;
+    ProtocolLog() <<"cwPRF-based PSI [step 2]: Receiver ===> F_k2(x_i) ===> Sender" << std::endl; 
 
     std::vector<EC25519Point> vec_Fk2k1_Y(pp.SENDER_ITEM_NUM);
     #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
@@ -227,10 +225,10 @@ std::vector<block> Receive(NetIO &io, PP &pp, std::vector<block> &vec_X)
     
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "cwPRF-based PSI: Receiver side takes time = " 
+    ProtocolLog() << "cwPRF-based PSI: Receiver side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
 
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
     
     return vec_intersection; 
 }
@@ -94,17 +94,18 @@ void FetchPP(PP &pp, std::string pp_filename)
 
 // returns union_id and X_id
 std::tuple<std::vector<std::vector<uint8_t>>, std::vector<std::vector<uint8_t>>> 
-Send(NetIO &io, PP &pp, std::vector<block> &vec_X, size_t ITEM_LEN)
+Send(Channel &io, PP &pp, std::vector<block> &vec_X, size_t ITEM_LEN)
 {
+    auto phase = io.Phase("mqRPMT-based private-ID"); 
     if(vec_X.size() != pp.SENDER_ITEM_NUM){
         std::cerr << "|X| does not match public parameter" << std::endl; 
         exit(1); // EXIT_FAILURE  
     }
 
     auto start_time = std::chrono::steady_clock::now();   
-    PrintSplitLine('-');
+    LogSplitLine('-');
 
-    std::cout << "[Private-ID from distributed OPRF+PSU] Phase 1: compute sender's ID using distributed OPRF (run OPRF twice)>>>" << std::endl;
+    ProtocolLog() << "[Private-ID from distributed OPRF+PSU] Phase 1: compute sender's ID using distributed OPRF (run OPRF twice)>>>" << std::endl;
 
     // first act as server: compute F_k1(X)
     std::vector<uint8_t> k1 = OPRF::Server(io, pp.oprf_part); 
@@ -118,7 +119,7 @@ Send(NetIO &io, PP &pp, std::vector<block> &vec_X, size_t ITEM_LEN)
         vec_X_id[i] = XOR(vec_Fk1_X[i], vec_Fk2_X[i]); 
     }     
 
-    std::cout << "[Private-ID from distributed OPRF+PSU] Phase 2: execute PSU >>>" << std::endl;
+    ProtocolLog() << "[Private-ID from distributed OPRF+PSU] Phase 2: execute PSU >>>" << std::endl;
     mqRPMTPSU::Send(io, pp.psu_part, vec_X_id, ITEM_LEN);
 
     std::vector<std::vector<uint8_t>> vec_union_id; 
@@ -126,7 +127,7 @@ Send(NetIO &io, PP &pp, std::vector<block> &vec_X, size_t ITEM_LEN)
     
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "[Private-ID from distributed OPRF+PSU]: Sender side takes time = " 
+    ProtocolLog() << "[Private-ID from distributed OPRF+PSU]: Sender side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
 
     return {vec_union_id, vec_X_id};
@@ -134,17 +135,18 @@ Send(NetIO &io, PP &pp, std::vector<block> &vec_X, size_t ITEM_LEN)
 
 // returns union_id and Y_id
 std::tuple<std::vector<std::vector<uint8_t>>, std::vector<std::vector<uint8_t>>> 
-Receive(NetIO &io, PP &pp, std::vector<block> &vec_Y, size_t ITEM_LEN) 
+Receive(Channel &io, PP &pp, std::vector<block> &vec_Y, size_t ITEM_LEN) 
 {
+    auto phase = io.Phase("mqRPMT-based private-ID"); 
     if(vec_Y.size() != pp.RECEIVER_ITEM_NUM){
         std::cerr << "|Y| does not match public parameter" << std::endl; 
         exit(1); // EXIT_FAILURE  
     }
     
     auto start_time = std::chrono::steady_clock::now();  
-    PrintSplitLine('-');
+    LogSplitLine('-');
 
-    std::cout << "[Private-ID from distributed OPRF+PSU] Phase 1: compute receiver's ID using distributed OPRF (run OPRF twice)>>>" << std::endl;
+    ProtocolLog() << "[Private-ID from distributed OPRF+PSU] Phase 1: compute receiver's ID using distributed OPRF (run OPRF twice)>>>" << std::endl;
 
     // first act as client: compute F_k1(Y)
     std::vector<std::vector<uint8_t>> vec_Fk1_Y = OPRF::Client(io, pp.oprf_part, vec_Y, pp.RECEIVER_ITEM_NUM); 
@@ -160,26 +162,25 @@ Receive(NetIO &io, PP &pp, std::vector<block> &vec_Y, size_t ITEM_LEN)
         vec_Y_id[i] = XOR(vec_Fk1_Y[i], vec_Fk2_Y[i]); 
     }     
 
-    PrintSplitLine('-');
-    std::cout << "[Private-ID from distributed OPRF+PSU] Phase 2: execute PSU >>>" << std::endl;
+    LogSplitLine('-');
+    ProtocolLog() << "[Private-ID from distributed OPRF+PSU] Phase 2: execute PSU >>>" << std::endl;
 
     std::vector<std::vector<uint8_t>> vec_union_id = mqRPMTPSU::Receive(io, pp.psu_part, vec_Y_id, ITEM_LEN); 
 
     size_t UNION_SIZE = vec_union_id.size(); 
     
-    PrintSplitLine('-');
-    std::cout << "[Private-ID from distributed OPRF+PSU] Phase 3: Receiver ===> vec_union_id >>> Sender";
-    std::cout << " [" << (double)ITEM_LEN*UNION_SIZE/(1024*1024) << " MB]" << std::endl;
+    LogSplitLine('-');
+    ProtocolLog() << "[Private-ID from distributed OPRF+PSU] Phase 3: Receiver ===> vec_union_id >>> Sender" << std::endl;
 
     std::shuffle(vec_union_id.begin(), vec_union_id.end(), global_built_in_prg);
     io.SendBytesVector(vec_union_id); 
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "[Private-ID from distributed OPRF+PSU]: Receiver side takes time = " 
+    ProtocolLog() << "[Private-ID from distributed OPRF+PSU]: Receiver side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
         
-    PrintSplitLine('-');
+    LogSplitLine('-');
        
     return {vec_union_id, vec_Y_id};
 }
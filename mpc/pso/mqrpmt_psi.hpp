@@ -102,46 +102,48 @@ void FetchPP(PP &pp, std::string pp_filename)
     fin.close(); 
 }
 
-void Send(NetIO &io, PP &pp, std::vector<block> &vec_X) 
+void Send(Channel &io, PP &pp, std::vector<block> &vec_X) 
 {
+    auto phase = io.Phase("mqRPMT-based PSI"); 
     if(vec_X.size() != pp.SENDER_ITEM_NUM){
         std::cerr << "|X| does not match public parameter" << std::endl; 
         exit(1); // EXIT_FAILURE  
     }
 
     auto start_time = std::chrono::steady_clock::now(); 
-    std::cout << "[mqRPMT-based PSI] Phase 1: execute mqRPMT >>>" << std::endl;
+    ProtocolLog() << "[mqRPMT-based PSI] Phase 1: execute mqRPMT >>>" << std::endl;
     cwPRFmqRPMT::Client(io, pp.mqrpmt_part, vec_X);
 
-    std::cout << "[mqRPMT-based PSI] Phase 2: execute one-sided OTe >>>" << std::endl;
+    ProtocolLog() << "[mqRPMT-based PSI] Phase 2: execute one-sided OTe >>>" << std::endl;
     // get the intersection X \cup Y via one-sided OT from receiver
     ALSZOTE::OnesidedSend(io, pp.ote_part, vec_X, vec_X.size()); 
     
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "[mqRPMT-based PSI]: Sender side takes time = " 
+    ProtocolLog() << "[mqRPMT-based PSI]: Sender side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
 }
 
-std::vector<block> Receive(NetIO &io, PP &pp, std::vector<block> &vec_Y) 
+std::vector<block> Receive(Channel &io, PP &pp, std::vector<block> &vec_Y) 
 {
+    auto phase = io.Phase("mqRPMT-based PSI"); 
     if(vec_Y.size() != pp.RECEIVER_ITEM_NUM){
         std::cerr << "|Y| does not match public parameter" << std::endl; 
         exit(1); // EXIT_FAILURE  
     }
 
     auto start_time = std::chrono::steady_clock::now(); 
-    std::cout << "[mqRPMT-based PSI] Phase 1: execute mqRPMT >>>" << std::endl;
-    std::vector<uint8_t> vec_indication_bit = cwPRFmqRPMT::Server(io, pp.mqrpmt_part, vec_Y);
+    ProtocolLog() << "[mqRPMT-based PSI] Phase 1: execute mqRPMT >>>" << std::endl;
+    BitVector vec_indication_bit = cwPRFmqRPMT::Server(io, pp.mqrpmt_part, vec_Y);
 
-    std::cout << "[mqRPMT-based PSI] Phase 2: execute one-sided OTe >>>" << std::endl;
+    ProtocolLog() << "[mqRPMT-based PSI] Phase 2: execute one-sided OTe >>>" << std::endl;
     // get the intersection X \cup Y via one-sided OT from receiver
     std::vector<block> vec_intersection = ALSZOTE::OnesidedReceive(io, pp.ote_part, 
-                                                vec_indication_bit, vec_indication_bit.size()); 
+                                                vec_indication_bit, vec_indication_bit.Size()); 
     
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "[mqRPMT-based PSI]: Server side takes time = " 
+    ProtocolLog() << "[mqRPMT-based PSI]: Server side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
     
     return vec_intersection;
@@ -101,50 +101,49 @@ void FetchPP(PP &pp, std::string pp_filename)
 }
 
 
-void Send(NetIO &io, PP &pp, std::vector<block> &vec_X) 
+void Send(Channel &io, PP &pp, std::vector<block> &vec_X) 
 {
+    auto phase = io.Phase("mqRPMT-based PSI-card"); 
     if(vec_X.size() != pp.SENDER_ITEM_NUM){
         std::cerr << "|X| does not match public parameter" << std::endl; 
         exit(1); // EXIT_FAILURE  
     }
     
     auto start_time = std::chrono::steady_clock::now(); 
-    PrintSplitLine('-');
-    std::cout << "[mqRPMT-based PSI-card] Phase 1: execute mqRPMT >>>" << std::endl;
+    LogSplitLine('-');
+    ProtocolLog() << "[mqRPMT-based PSI-card] Phase 1: execute mqRPMT >>>" << std::endl;
     cwPRFmqRPMT::Client(io, pp.mqrpmt_part, vec_X);
     
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "[mqRPMT-based PSI-card]: Sender side takes time = " 
+    ProtocolLog() << "[mqRPMT-based PSI-card]: Sender side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
         
-    PrintSplitLine('-');
+    LogSplitLine('-');
 }
 
-size_t Receive(NetIO &io, PP &pp, std::vector<block> &vec_Y) 
+size_t Receive(Channel &io, PP &pp, std::vector<block> &vec_Y) 
 {
+    auto phase = io.Phase("mqRPMT-based PSI-card"); 
     if(vec_Y.size() != pp.RECEIVER_ITEM_NUM){
         std::cerr << "|Y| does not match public parameter" << std::endl; 
         exit(1); // EXIT_FAILURE  
     }
 
     auto start_time = std::chrono::steady_clock::now(); 
-    PrintSplitLine('-');
+    LogSplitLine('-');
 
-    std::cout << "[mqRPMT-based PSI-card] Phase 1: execute mqRPMT >>>" << std::endl;
-    std::vector<uint8_t> vec_indication_bit = cwPRFmqRPMT::Server(io, pp.mqrpmt_part, vec_Y);
+    ProtocolLog() << "[mqRPMT-based PSI-card] Phase 1: execute mqRPMT >>>" << std::endl;
+    BitVector vec_indication_bit = cwPRFmqRPMT::Server(io, pp.mqrpmt_part, vec_Y);
         
-    size_t INTERSECTION_CARDINALITY = 0; 
-    for(auto i = 0; i < vec_indication_bit.size(); i++){
-        INTERSECTION_CARDINALITY += vec_indication_bit[i]; 
-    } 
+    size_t INTERSECTION_CARDINALITY = vec_indication_bit.Count(); 
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "[mqRPMT-based PSI-card]: Receiver side takes time = " 
+    ProtocolLog() << "[mqRPMT-based PSI-card]: Receiver side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
     
-    PrintSplitLine('-');
+    LogSplitLine('-');
         
     return INTERSECTION_CARDINALITY;
 }
@@ -116,8 +116,9 @@ void FetchPP(PP &pp, std::string pp_filename)
 }
 
 
-std::tuple<size_t, BigInt> Send(NetIO &io, PP &pp, std::vector<block> &vec_X, std::vector<BigInt> &vec_v) 
+std::tuple<size_t, BigInt> Send(Channel &io, PP &pp, std::vector<block> &vec_X, std::vector<BigInt> &vec_v) 
 {
+    auto phase = io.Phase("mqRPMT-based PSI-card-sum"); 
     if(vec_X.size() != pp.SENDER_ITEM_NUM){
         std::cerr << "|X| does not match public parameter" << std::endl; 
         exit(1); // EXIT_FAILURE 
@@ -134,8 +135,8 @@ std::tuple<size_t, BigInt> Send(NetIO &io, PP &pp, std::vector<block> &vec_X, st
 
     auto start_time = std::chrono::steady_clock::now(); 
         
-    PrintSplitLine('-');
-    std::cout << "[mqRPMT-based PSI-card-sum] Phase 1: execute mqRPMT >>>" << std::endl;
+    LogSplitLine('-');
+    ProtocolLog() << "[mqRPMT-based PSI-card-sum] Phase 1: execute mqRPMT >>>" << std::endl;
     
     cwPRFmqRPMT::Client(io, pp.mqrpmt_part, vec_X);
 
@@ -152,49 +153,47 @@ std::tuple<size_t, BigInt> Send(NetIO &io, PP &pp, std::vector<block> &vec_X, st
         vec_m1[i] = vec_v[i].ToByteVector(pp.LOG_SUM_BOUND/8);
     }
 
-    std::cout << "[mqRPMT-based PSI-card-sum] Phase 2: execute OTe >>>" << std::endl;
+    ProtocolLog() << "[mqRPMT-based PSI-card-sum] Phase 2: execute OTe >>>" << std::endl;
     ALSZOTE::SendByteVector(io, pp.ote_part, vec_m0, vec_m1, pp.SENDER_ITEM_NUM); 
 
     size_t CARDINALITY; 
     io.ReceiveInteger(CARDINALITY);
     BigInt SUM; 
     io.ReceiveBigInt(SUM, pp.LOG_SUM_BOUND/8);  
-    std::cout << "[mqRPMT-based PSI-card-sum] Phase 3: Sender obtains (CARDINALITY, masked_SUM) from Receiver" << std::endl;
+    ProtocolLog() << "[mqRPMT-based PSI-card-sum] Phase 3: Sender obtains (CARDINALITY, masked_SUM) from Receiver" << std::endl;
     
     SUM = (SUM - mask) % SUM_BOUND; 
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "[mqRPMT-based PSI-card-sum]: Receiver side takes time = " 
+    ProtocolLog() << "[mqRPMT-based PSI-card-sum]: Receiver side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
 
-    PrintSplitLine('-');
+    LogSplitLine('-');
 
     return {CARDINALITY, SUM}; 
 }
 
-size_t Receive(NetIO &io, PP &pp, std::vector<block> &vec_Y) 
+size_t Receive(Channel &io, PP &pp, std::vector<block> &vec_Y) 
 {
+    auto phase = io.Phase("mqRPMT-based PSI-card-sum"); 
     if(vec_Y.size() != pp.RECEIVER_ITEM_NUM){
         std::cerr << "|Y| does not match public parameter" << std::endl; 
         exit(1); // EXIT_FAILURE 
     }
 
     auto start_time = std::chrono::steady_clock::now();     
-    PrintSplitLine('-');
-    std::cout << "[mqRPMT-based PSI-card-sum] Phase 1: execute mqRPMT >>>" << std::endl;
-    std::vector<uint8_t> vec_indication_bit = cwPRFmqRPMT::Server(io, pp.mqrpmt_part, vec_Y);
+    LogSplitLine('-');
+    ProtocolLog() << "[mqRPMT-based PSI-card-sum] Phase 1: execute mqRPMT >>>" << std::endl;
+    BitVector vec_indication_bit = cwPRFmqRPMT::Server(io, pp.mqrpmt_part, vec_Y);
 
-    std::cout << "[mqRPMT-based PSI-card-sum] Phase 2: execute OTe >>>" << std::endl;
+    ProtocolLog() << "[mqRPMT-based PSI-card-sum] Phase 2: execute OTe >>>" << std::endl;
     std::vector<std::vector<uint8_t>> vec_result = ALSZOTE::ReceiveByteVector(io, pp.ote_part, 
-        vec_indication_bit, vec_indication_bit.size());
+        vec_indication_bit, vec_indication_bit.Size());
 
     std::vector<BigInt> vec_v(pp.RECEIVER_ITEM_NUM); 
 
-    size_t CARDINALITY = 0; 
-    for(auto i = 0; i < vec_indication_bit.size(); i++){
-        CARDINALITY += vec_indication_bit[i]; 
-    }
+    size_t CARDINALITY = vec_indication_bit.Count(); 
 
     BigInt masked_SUM = bn_0; 
     BigInt SUM_BOUND = BigInt(pow(2, pp.LOG_SUM_BOUND)); 
@@ -207,15 +206,14 @@ size_t Receive(NetIO &io, PP &pp, std::vector<block> &vec_Y)
     io.SendInteger(CARDINALITY);
 
     io.SendBigInt(masked_SUM, pp.LOG_SUM_BOUND/8);  
-    std::cout << "[mqRPMT-based PSI-card-sum] Phase 3: Receiver  ===> (CARDINALITY, masked_SUM) ===> Sender";
-    std::cout << " [" << (sizeof(CARDINALITY) + pp.LOG_SUM_BOUND/8)/(1024*1024) << " MB]" << std::endl;
+    ProtocolLog() << "[mqRPMT-based PSI-card-sum] Phase 3: Receiver  ===> (CARDINALITY, masked_SUM) ===> Sender" << std::endl;
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "[mqRPMT-based PSI-card-sum]: Sender side takes time = " 
+    ProtocolLog() << "[mqRPMT-based PSI-card-sum]: Sender side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
         
-    PrintSplitLine('-');
+    LogSplitLine('-');
 
     return CARDINALITY;
 }
@@ -100,52 +100,51 @@ void FetchPP(PP &pp, std::string pp_filename)
     fin.close(); 
 }
 
-void Send(NetIO &io, PP &pp, std::vector<block> &vec_X) 
+void Send(Channel &io, PP &pp, std::vector<block> &vec_X) 
 {
+    auto phase = io.Phase("mqRPMT-based PSU"); 
     if(vec_X.size() != pp.SENDER_ITEM_NUM){
         std::cerr << "|X| does not match public parameter" << std::endl; 
         exit(1); 
     }
 
     auto start_time = std::chrono::steady_clock::now(); 
-    PrintSplitLine('-');
-    std::cout << "[mqRPMT-based PSU] Phase 1: execute mqRPMT >>>" << std::endl;
+    LogSplitLine('-');
+    ProtocolLog() << "[mqRPMT-based PSU] Phase 1: execute mqRPMT >>>" << std::endl;
     cwPRFmqRPMT::Client(io, pp.mqrpmt_part, vec_X);
         
-    std::cout << "[mqRPMT-based PSU] Phase 2: execute one-sided OTe >>>" << std::endl;
+    ProtocolLog() << "[mqRPMT-based PSU] Phase 2: execute one-sided OTe >>>" << std::endl;
     // get the intersection X \cup Y via one-sided OT from receiver
     ALSZOTE::OnesidedSend(io, pp.ote_part, vec_X, pp.SENDER_ITEM_NUM); 
     
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "[mqRPMT-based PSU]: Sender side takes time = " 
+    ProtocolLog() << "[mqRPMT-based PSU]: Sender side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
         
-    PrintSplitLine('-');
+    LogSplitLine('-');
 }
 
-std::vector<block> Receive(NetIO &io, PP &pp, std::vector<block> &vec_Y) 
+std::vector<block> Receive(Channel &io, PP &pp, std::vector<block> &vec_Y) 
 {
+    auto phase = io.Phase("mqRPMT-based PSU"); 
     if(vec_Y.size() != pp.RECEIVER_ITEM_NUM){
         std::cerr << "|Y| does not match public parameter" << std::endl; 
         exit(1); 
     }
 
     auto start_time = std::chrono::steady_clock::now();    
-    PrintSplitLine('-');
-    std::cout << "[mqRPMT-based PSU] Phase 1: execute mqRPMT >>>" << std::endl;
-    std::vector<uint8_t> vec_indication_bit = cwPRFmqRPMT::Server(io, pp.mqrpmt_part, vec_Y);
+    LogSplitLine('-');
+    ProtocolLog() << "[mqRPMT-based PSU] Phase 1: execute mqRPMT >>>" << std::endl;
+    BitVector vec_indication_bit = cwPRFmqRPMT::Server(io, pp.mqrpmt_part, vec_Y);
        
     // flip the indication bit to get elements in Y\X
-    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-    for(auto i = 0; i < vec_indication_bit.size(); i++){
-        vec_indication_bit[i] ^= 0x01; 
-    } 
+    vec_indication_bit = ~vec_indication_bit; 
 
-    std::cout << "Phase 2: execute one-sided OTe >>>" << std::endl;
+    ProtocolLog() << "Phase 2: execute one-sided OTe >>>" << std::endl;
     // get the intersection X \cup Y via one-sided OT from receiver
     std::vector<block> vec_X_diff = ALSZOTE::OnesidedReceive(io, pp.ote_part, 
-                                                             vec_indication_bit, vec_indication_bit.size()); 
+                                                             vec_indication_bit, vec_indication_bit.Size()); 
     std::vector<block> vec_union = vec_Y; 
     for(auto i = 0; i < vec_X_diff.size(); i++){
         vec_union.emplace_back(vec_X_diff[i]);
@@ -153,25 +152,26 @@ std::vector<block> Receive(NetIO &io, PP &pp, std::vector<block> &vec_Y)
     
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "[mqRPMT-based PSU]: Receiver side takes time = " 
+    ProtocolLog() << "[mqRPMT-based PSU]: Receiver side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
         
-    PrintSplitLine('-');
+    LogSplitLine('-');
 
     return vec_union;
 }
 
 // support arbirary item (encode as uint8_t array)
-void Send(NetIO &io, PP &pp, std::vector<std::vector<uint8_t>> &vec_X, size_t ITEM_LEN) 
+void Send(Channel &io, PP &pp, std::vector<std::vector<uint8_t>> &vec_X, size_t ITEM_LEN) 
 {
+    auto phase = io.Phase("mqRPMT-based PSU"); 
     if(vec_X.size() != pp.SENDER_ITEM_NUM){
         std::cerr << "|X| does not match public parameter" << std::endl; 
         exit(1); // EXIT_FAILURE  
     }
 
     auto start_time = std::chrono::steady_clock::now(); 
-    PrintSplitLine('-');
-    std::cout << "[mqRPMT-based PSU] Phase 1: execute mqRPMT >>>" << std::endl;
+    LogSplitLine('-');
+    ProtocolLog() << "[mqRPMT-based PSU] Phase 1: execute mqRPMT >>>" << std::endl;
 
     std::vector<block> vec_Block_X(pp.SENDER_ITEM_NUM); 
     #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
@@ -180,7 +180,7 @@ void Send(NetIO &io, PP &pp, std::vector<std::vector<uint8_t>> &vec_X, size_t IT
     }
     cwPRFmqRPMT::Client(io, pp.mqrpmt_part, vec_Block_X);
         
-    std::cout << "[mqRPMT-based PSU] Phase 2: execute one-sided OTe >>>" << std::endl;
+    ProtocolLog() << "[mqRPMT-based PSU] Phase 2: execute one-sided OTe >>>" << std::endl;
 
     size_t original_size_send = vec_X.size();
     size_t padded_size_send = (original_size_send + 127) / 128 * 128;
@@ -198,48 +198,46 @@ void Send(NetIO &io, PP &pp, std::vector<std::vector<uint8_t>> &vec_X, size_t IT
     
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "[mqRPMT-based PSU]: Sender side takes time = " 
+    ProtocolLog() << "[mqRPMT-based PSU]: Sender side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
         
-    PrintSplitLine('-');
+    LogSplitLine('-');
 }
 
-std::vector<std::vector<uint8_t>> Receive(NetIO &io, PP &pp, std::vector<std::vector<uint8_t>> &vec_Y, size_t ITEM_LEN) 
+std::vector<std::vector<uint8_t>> Receive(Channel &io, PP &pp, std::vector<std::vector<uint8_t>> &vec_Y, size_t ITEM_LEN) 
 {
+    auto phase = io.Phase("mqRPMT-based PSU"); 
     if(vec_Y.size() != pp.RECEIVER_ITEM_NUM){
         std::cerr << "|Y| does not match public parameter" << std::endl; 
         exit(1); // EXIT_FAILURE  
     }
     
     auto start_time = std::chrono::steady_clock::now();     
-    PrintSplitLine('-');
-    std::cout << "[mqRPMT-based PSU] Phase 1: execute mqRPMT >>>" << std::endl;
+    LogSplitLine('-');
+    ProtocolLog() << "[mqRPMT-based PSU] Phase 1: execute mqRPMT >>>" << std::endl;
      
     std::vector<block> vec_Block_Y(pp.RECEIVER_ITEM_NUM); 
     #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
     for(auto i = 0; i < vec_Y.size(); i++){
         vec_Block_Y[i] = Hash::BytesToBlock(vec_Y[i]); 
     }
-    std::vector<uint8_t> vec_indication_bit = cwPRFmqRPMT::Server(io, pp.mqrpmt_part, vec_Block_Y);
+    BitVector vec_indication_bit = cwPRFmqRPMT::Server(io, pp.mqrpmt_part, vec_Block_Y);
        
     // flip the indication bit to get elements in Y\X
-    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-    for(auto i = 0; i < vec_indication_bit.size(); i++){
-        vec_indication_bit[i] ^= 0x01; 
-    } 
+    vec_indication_bit = ~vec_indication_bit; 
 
-    std::cout << "[mqRPMT-based PSU] Phase 2: execute one-sided OTe >>>" << std::endl;
+    ProtocolLog() << "[mqRPMT-based PSU] Phase 2: execute one-sided OTe >>>" << std::endl;
 
     //fix issue 15
-    size_t original_size_recv = vec_indication_bit.size();
+    size_t original_size_recv = vec_indication_bit.Size();
     // pad vector to be multiple of 128
     size_t padded_size_recv = (original_size_recv + 127) / 128 * 128;
     // we assume the padded positions are 0
-    vec_indication_bit.resize(padded_size_recv, 0);
+    vec_indication_bit.Resize(padded_size_recv, 0);
 
     // get the intersection X \cup Y via one-sided OT from receiver
     std::vector<std::vector<uint8_t>> vec_X_diff; 
-    // vec_X_diff = ALSZOTE::OnesidedReceiveByteVector(io, pp.ote_part, vec_indication_bit, vec_indication_bit.size()); 
+    // vec_X_diff = ALSZOTE::OnesidedReceiveByteVector(io, pp.ote_part, vec_indication_bit, vec_indication_bit.Size()); 
     vec_X_diff = ALSZOTE::OnesidedReceiveByteVector(io, pp.ote_part, vec_indication_bit, padded_size_recv);
     std::vector<std::vector<uint8_t>> vec_union = vec_Y; 
     for(auto i = 0; i < vec_X_diff.size(); i++){
@@ -248,10 +246,10 @@ std::vector<std::vector<uint8_t>> Receive(NetIO &io, PP &pp, std::vector<std::ve
     
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "[mqRPMT-based PSU]: Receiver side takes time = " 
+    ProtocolLog() << "[mqRPMT-based PSU]: Receiver side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
         
-    PrintSplitLine('-');
+    LogSplitLine('-');
 
     return vec_union;
 }
@@ -6,7 +6,9 @@
 #include "../../crypto/prg.hpp"
 #include "../../crypto/block.hpp"
 #include "../../netio/stream_channel.hpp"
+#include "../../netio/async_channel.hpp"
 #include "../../filter/bloom_filter.hpp"
+#include "../../filter/flat_hash_set.hpp"
 #include "../../utility/serialization.hpp"
 
 /*
@@ -14,7 +16,7 @@
 ** cuckoo filter is not gurantteed to be safe here, cause the filter may reveal the order of X
 */
 
-
+// comment this line to send the PRF values themselves and test membership exactly with FlatHashSet
 #define BLOOMFILTER 
 
 namespace cwPRFmqRPMT{
@@ -22,6 +24,9 @@ namespace cwPRFmqRPMT{
 using Serialization::operator<<; 
 using Serialization::operator>>; 
 
+// points per pipeline chunk: chunk k is computed while chunk k-1 is on the wire
+const size_t PIPELINE_CHUNK_LEN = 1 << 14; 
+
 struct PP
 {
     size_t statistical_security_parameter; // default=40 
@@ -91,44 +96,55 @@ void FetchPP(PP &pp, std::string pp_filename)
 }
 
 #ifndef ENABLE_X25519_ACCELERATION
-std::vector<uint8_t> Server(NetIO &io, PP &pp, std::vector<block> &vec_Y)
+BitVector Server(Channel &io, PP &pp, std::vector<block> &vec_Y)
 {
+    auto phase = io.Phase("cwPRF-based mqRPMT"); 
     if(pp.SERVER_LEN != vec_Y.size()){
         std::cerr << "input size of vec_Y does not match public parameters" << std::endl;
         exit(1);  
     }
 
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
     auto start_time = std::chrono::steady_clock::now(); 
     
     BigInt k1 = GenRandomBigIntLessThan(order); // pick a key k1
 
+    size_t POINT_LEN = ECPointSerializedByteLen(); 
     std::vector <ECPoint> vec_Fk1_Y(pp.SERVER_LEN);
-    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-    for(auto i = 0; i < pp.SERVER_LEN; i++){
-        vec_Fk1_Y[i] = Hash::BlockToECPoint(vec_Y[i]) * k1; // H(y_i)^k1
-    }
-
-    io.SendECPoints(vec_Fk1_Y.data(), pp.SERVER_LEN); 
-    
-    std::cout <<"cwPRF-based mqRPMT [step 1]: Server ===> F_k1(y_i) ===> Client";
-    #ifdef ECPOINT_COMPRESSED
-        std::cout << " [" << (double)POINT_COMPRESSED_BYTE_LEN * pp.SERVER_LEN/(1024*1024) << " MB]" << std::endl;
-    #else
-        std::cout << " [" << (double)POINT_BYTE_LEN*pp.SERVER_LEN/(1024*1024) << " MB]" << std::endl;
-    #endif
-
+    std::vector<unsigned char> vec_Fk1_Y_bytes(pp.SERVER_LEN*POINT_LEN); 
     std::vector<ECPoint> vec_Fk2_X(pp.CLIENT_LEN); 
-    io.ReceiveECPoints(vec_Fk2_X.data(), pp.CLIENT_LEN);
-
+    std::vector<unsigned char> vec_Fk2_X_bytes(pp.CLIENT_LEN*POINT_LEN); 
     std::vector<ECPoint> vec_Fk1k2_X(pp.CLIENT_LEN); 
-    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-    for(auto i = 0; i < pp.CLIENT_LEN; i++){ 
-        vec_Fk1k2_X[i] = vec_Fk2_X[i] * k1; 
+    {
+        // F_k2(x_i) streams in while F_k1(y_i) is computed and sent chunk by chunk
+        AsyncNetIO async_io(io); 
+        async_io.PostReceive(vec_Fk2_X_bytes.data(), pp.CLIENT_LEN*POINT_LEN, PIPELINE_CHUNK_LEN*POINT_LEN); 
+
+        for(size_t begin = 0; begin < pp.SERVER_LEN; begin += PIPELINE_CHUNK_LEN){
+            size_t end = std::min(pp.SERVER_LEN, begin + PIPELINE_CHUNK_LEN); 
+            Hash::BlocksToECPoints(vec_Y.data()+begin, end-begin, vec_Fk1_Y.data()+begin); // H(y_i)
+            #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+            for(auto i = begin; i < end; i++){
+                vec_Fk1_Y[i] = vec_Fk1_Y[i] * k1; // H(y_i)^k1
+            }
+            ECPointVectorToBytes(vec_Fk1_Y.data()+begin, end-begin, vec_Fk1_Y_bytes.data()+begin*POINT_LEN); 
+            async_io.AsyncSend(vec_Fk1_Y_bytes.data()+begin*POINT_LEN, (end-begin)*POINT_LEN); 
+        }
+
+        ProtocolLog() <<"cwPRF-based mqRPMT [step 1]: Server ===> F_k1(y_i) ===> Client" << std::endl;
+
+        // (H(x_i)^k2)^k1 for each chunk as soon as it is in
+        async_io.StreamingReceive([&](size_t begin, size_t end){
+            BytesToECPointVector(vec_Fk2_X_bytes.data()+begin, (end-begin)/POINT_LEN, vec_Fk2_X.data()+begin/POINT_LEN); 
+            #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+            for(auto i = begin/POINT_LEN; i < end/POINT_LEN; i++){ 
+                vec_Fk1k2_X[i] = vec_Fk2_X[i] * k1; 
+            }
+        }); 
     }
 
-    // compute the indication bit vector
-    std::vector<uint8_t> vec_indication_bit(pp.CLIENT_LEN);
+    // compute the indication bit vector, packed as it is computed
+    BitVector vec_indication_bit(pp.CLIENT_LEN);
 
     #ifdef BLOOMFILTER
         BloomFilter filter; 
@@ -141,67 +157,73 @@ std::vector<uint8_t> Server(NetIO &io, PP &pp, std::vector<block> &vec_Y)
         // reconstruct bloom filter  
         filter.ReadObject(buffer);  
         delete[] buffer; 
-        vec_indication_bit = filter.Contain(vec_Fk1k2_X); 
+        // the buffer of F_k2(x_i) is free again: reuse it for the encodings of F_k1k2(x_i)
+        ECPointVectorToBytes(vec_Fk1k2_X.data(), pp.CLIENT_LEN, vec_Fk2_X_bytes.data()); 
+        vec_indication_bit.Generate([&](size_t i){
+            return filter.PlainContain(vec_Fk2_X_bytes.data() + i*POINT_LEN, POINT_LEN); 
+        }); 
     #else
         std::vector<ECPoint> vec_Fk2k1_Y(pp.SERVER_LEN);
         io.ReceiveECPoints(vec_Fk2k1_Y.data(), pp.SERVER_LEN);
-        std::unordered_set<ECPoint, ECPointHash> S;
-        for(auto i = 0; i < pp.SERVER_LEN; i++){
-            S.insert(vec_Fk2k1_Y[i]); 
-        }
-        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-        for(auto i = 0; i < pp.CLIENT_LEN; i++){
-            if(S.find(vec_Fk1k2_X[i]) == S.end()) vec_indication_bit[i] = 0;  
-            else vec_indication_bit[i] = 1;
-        }
+        // exact membership test: keys are the compressed points of the current curve, stored inline
+        vec_indication_bit = ECPointSetContain(vec_Fk2k1_Y, vec_Fk1k2_X); 
     #endif
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "cwPRF-based mqRPMT: Server side takes time = " 
+    ProtocolLog() << "cwPRF-based mqRPMT: Server side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
     
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 
     return vec_indication_bit; 
 }
 
-void Client(NetIO &io, PP &pp, std::vector<block> &vec_X) 
+void Client(Channel &io, PP &pp, std::vector<block> &vec_X) 
 {    
+    auto phase = io.Phase("cwPRF-based mqRPMT"); 
     if(pp.CLIENT_LEN != vec_X.size()){
         std::cerr << "input size of vec_Y does not match public parameters" << std::endl;
         exit(1);  
     }
     
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
     auto start_time = std::chrono::steady_clock::now(); 
 
     BigInt k2 = GenRandomBigIntLessThan(order); // pick a key
 
+    size_t POINT_LEN = ECPointSerializedByteLen(); 
     std::vector<ECPoint> vec_Fk2_X(pp.CLIENT_LEN); 
-    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-    for(auto i = 0; i < pp.CLIENT_LEN; i++){
-        vec_Fk2_X[i] = Hash::BlockToECPoint(vec_X[i]) * k2; // H(x_i)^k2
-    } 
-
-    // first receive incoming data
+    std::vector<unsigned char> vec_Fk2_X_bytes(pp.CLIENT_LEN*POINT_LEN); 
     std::vector<ECPoint> vec_Fk1_Y(pp.SERVER_LEN);
-    io.ReceiveECPoints(vec_Fk1_Y.data(), pp.SERVER_LEN); // receive Fk1_Y from Server
-
-    // then send
-    io.SendECPoints(vec_Fk2_X.data(), pp.CLIENT_LEN);
+    std::vector<unsigned char> vec_Fk1_Y_bytes(pp.SERVER_LEN*POINT_LEN); 
+    std::vector<ECPoint> vec_Fk2k1_Y(pp.SERVER_LEN);
+    {
+        // F_k1(y_i) streams in while F_k2(x_i) is computed and sent chunk by chunk
+        AsyncNetIO async_io(io); 
+        async_io.PostReceive(vec_Fk1_Y_bytes.data(), pp.SERVER_LEN*POINT_LEN, PIPELINE_CHUNK_LEN*POINT_LEN); 
+
+        for(size_t begin = 0; begin < pp.CLIENT_LEN; begin += PIPELINE_CHUNK_LEN){
+            size_t end = std::min(pp.CLIENT_LEN, begin + PIPELINE_CHUNK_LEN); 
+            Hash::BlocksToECPoints(vec_X.data()+begin, end-begin, vec_Fk2_X.data()+begin); // H(x_i)
+            #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+            for(auto i = begin; i < end; i++){
+                vec_Fk2_X[i] = vec_Fk2_X[i] * k2; // H(x_i)^k2
+            }
+            ECPointVectorToBytes(vec_Fk2_X.data()+begin, end-begin, vec_Fk2_X_bytes.data()+begin*POINT_LEN); 
+            async_io.AsyncSend(vec_Fk2_X_bytes.data()+begin*POINT_LEN, (end-begin)*POINT_LEN); 
+        }
 
-    std::cout <<"cwPRF-based mqRPMT [step 2]: Client ===> F_k2(x_i) ===> Server"; 
-    #ifdef ECPOINT_COMPRESSED
-        std::cout << " [" << (double)POINT_COMPRESSED_BYTE_LEN*pp.CLIENT_LEN/(1024*1024) << " MB]" << std::endl;
-    #else
-        std::cout << " [" << (double)POINT_BYTE_LEN*pp.CLIENT_LEN/(1024*1024) << " MB]" << std::endl;
-    #endif
+        ProtocolLog() <<"cwPRF-based mqRPMT [step 2]: Client ===> F_k2(x_i) ===> Server" << std::endl; 
 
-    std::vector<ECPoint> vec_Fk2k1_Y(pp.SERVER_LEN);
-    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-    for(auto i = 0; i < pp.SERVER_LEN; i++){
-        vec_Fk2k1_Y[i] = vec_Fk1_Y[i] * k2; 
+        // (H(y_i)^k1)^k2 for each chunk as soon as it is in
+        async_io.StreamingReceive([&](size_t begin, size_t end){
+            BytesToECPointVector(vec_Fk1_Y_bytes.data()+begin, (end-begin)/POINT_LEN, vec_Fk1_Y.data()+begin/POINT_LEN); 
+            #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+            for(auto i = begin/POINT_LEN; i < end/POINT_LEN; i++){
+                vec_Fk2k1_Y[i] = vec_Fk1_Y[i] * k2; 
+            }
+        }); 
     }
 
     // generate and send bloom filter
@@ -213,40 +235,35 @@ void Client(NetIO &io, PP &pp, std::vector<block> &vec_X)
         char *buffer = new char[filter_size]; 
         filter.WriteObject(buffer);
         io.SendBytes(buffer, filter_size); 
-        std::cout <<"cwPRF-based mqRPMT [step 2]: Client ===> BloomFilter(F_k2k1(y_i)) ===> Server";
-        std::cout << " [" << (double)filter_size/(1024*1024) << " MB]" << std::endl;
+        ProtocolLog() <<"cwPRF-based mqRPMT [step 2]: Client ===> BloomFilter(F_k2k1(y_i)) ===> Server" << std::endl;
         delete[] buffer; 
     #else
         // permutation
         std::shuffle(vec_Fk2k1_Y.begin(), vec_Fk2k1_Y.end(), global_built_in_prg);
         io.SendECPoints(vec_Fk2k1_Y.data(), pp.SERVER_LEN); 
-        std::cout <<"cwPRF-based mqRPMT [step 2]: Client ===> Permutation(F_k2k1(y_i)) ===> Server"; 
-        #ifdef ECPOINT_COMPRESSED
-            std::cout << " [" << (double)POINT_COMPRESSED_BYTE_LEN * pp.SERVER_LEN/(1024*1024) << " MB]" << std::endl;
-        #else
-            std::cout << " [" << (double)POINT_BYTE_LEN*pp.SERVER_LEN/(1024*1024) << " MB]" << std::endl;
-        #endif
+        ProtocolLog() <<"cwPRF-based mqRPMT [step 2]: Client ===> Permutation(F_k2k1(y_i)) ===> Server" << std::endl; 
     #endif
     
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "cwPRF-based mqRPMT: Client side takes time = " 
+    ProtocolLog() << "cwPRF-based mqRPMT: Client side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
 
         
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 }
 
 #else
 
-std::vector<uint8_t> Server(NetIO &io, PP &pp, std::vector<block> &vec_Y)
+BitVector Server(Channel &io, PP &pp, std::vector<block> &vec_Y)
 {
+    auto phase = io.Phase("cwPRF-based mqRPMT"); 
     if(pp.SERVER_LEN != vec_Y.size()){
         std::cerr << "input size of vec_Y does not match public parameters" << std::endl;
         exit(1);  
     }
 
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
     auto start_time = std::chrono::steady_clock::now(); 
 
     std::vector<uint8_t> k1(32);
@@ -255,30 +272,35 @@ std::vector<uint8_t> Server(NetIO &io, PP &pp, std::vector<block> &vec_Y)
 
     std::vector<EC25519Point> vec_Hash_Y(pp.SERVER_LEN);
     std::vector<EC25519Point> vec_Fk1_Y(pp.SERVER_LEN);
-
-    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-    for(auto i = 0; i < pp.SERVER_LEN; i++){
-        Hash::BlockToBytes(vec_Y[i], vec_Hash_Y[i].px, 32); 
-        vec_Fk1_Y[i] = vec_Hash_Y[i] * k1; 
-    }
-
-    io.SendEC25519Points(vec_Fk1_Y.data(), pp.SERVER_LEN); 
-    
-    std::cout <<"cwPRF-based mqRPMT [step 1]: Server ===> F_k1(y_i) ===> Client";
-    
-    std::cout << " [" << 32*pp.SERVER_LEN/(1024*1024) << " MB]" << std::endl;
-
     std::vector<EC25519Point> vec_Fk2_X(pp.CLIENT_LEN); 
-    io.ReceiveEC25519Points(vec_Fk2_X.data(), pp.CLIENT_LEN);
-
     std::vector<EC25519Point> vec_Fk1k2_X(pp.CLIENT_LEN); 
-    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-    for(auto i = 0; i < pp.CLIENT_LEN; i++){ 
-        vec_Fk1k2_X[i] = vec_Fk2_X[i] * k1; // (H(x_i)^k2)^k1
+    {
+        // F_k2(x_i) streams in while F_k1(y_i) is computed and sent chunk by chunk
+        AsyncNetIO async_io(io); 
+        async_io.PostReceive(vec_Fk2_X.data(), 32*pp.CLIENT_LEN, 32*PIPELINE_CHUNK_LEN); 
+
+        for(size_t begin = 0; begin < pp.SERVER_LEN; begin += PIPELINE_CHUNK_LEN){
+            size_t end = std::min(pp.SERVER_LEN, begin + PIPELINE_CHUNK_LEN); 
+            Hash::BlocksToEC25519Points(vec_Y.data()+begin, end-begin, vec_Hash_Y.data()+begin); 
+            #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+            for(auto i = begin; i < end; i++){
+                vec_Fk1_Y[i] = vec_Hash_Y[i] * k1; 
+            }
+            async_io.AsyncSend(vec_Fk1_Y.data()+begin, 32*(end-begin)); 
+        }
+
+        ProtocolLog() <<"cwPRF-based mqRPMT [step 1]: Server ===> F_k1(y_i) ===> Client" << std::endl;
+
+        async_io.StreamingReceive([&](size_t begin, size_t end){
+            #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+            for(auto i = begin/32; i < end/32; i++){ 
+                vec_Fk1k2_X[i] = vec_Fk2_X[i] * k1; // (H(x_i)^k2)^k1
+            }
+        }); 
     }
 
-    // compute the indication bit vector
-    std::vector<uint8_t> vec_indication_bit(pp.CLIENT_LEN);
+    // compute the indication bit vector, packed as it is computed
+    BitVector vec_indication_bit(pp.CLIENT_LEN);
 
     #ifdef BLOOMFILTER
         BloomFilter filter; 
@@ -291,39 +313,39 @@ std::vector<uint8_t> Server(NetIO &io, PP &pp, std::vector<block> &vec_Y)
         // reconstruct bloom filter  
         filter.ReadObject(buffer);  
         delete[] buffer; 
-        vec_indication_bit = filter.Contain(vec_Fk1k2_X); 
+        vec_indication_bit.Generate([&](size_t i){ return filter.Contain(vec_Fk1k2_X[i]); }); 
     #else
         std::vector<EC25519Point> vec_Fk2k1_Y(pp.SERVER_LEN);
         io.ReceiveEC25519Points(vec_Fk2k1_Y.data(), pp.SERVER_LEN);
-        std::unordered_set<EC25519Point, EC25519PointHash> S;
-        for(auto i = 0; i < pp.SERVER_LEN; i++){
-            S.insert(vec_Fk2k1_Y[i]); 
-        }
-        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-        for(auto i = 0; i < pp.CLIENT_LEN; i++){
-            if(S.find(vec_Fk1k2_X[i]) == S.end()) vec_indication_bit[i] = 0;  
-            else vec_indication_bit[i] = 1;
-        }
+        FlatHashSet<32> S(pp.SERVER_LEN);
+        S.Insert(vec_Fk2k1_Y); 
+        // the first probe of a lookup is a cache miss on a large table: prefetch a few lookups ahead
+        const size_t PREFETCH_DISTANCE = 8; 
+        vec_indication_bit.Generate([&](size_t i){
+            if(i + PREFETCH_DISTANCE < pp.CLIENT_LEN) S.Prefetch(vec_Fk1k2_X[i+PREFETCH_DISTANCE].px); 
+            return S.Contain(vec_Fk1k2_X[i].px); 
+        }); 
     #endif
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "cwPRF-mqRPMT: Server side takes time = " 
+    ProtocolLog() << "cwPRF-mqRPMT: Server side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
     
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 
     return vec_indication_bit; 
 }
 
-void Client(NetIO &io, PP &pp, std::vector<block> &vec_X) 
+void Client(Channel &io, PP &pp, std::vector<block> &vec_X) 
 {    
+    auto phase = io.Phase("cwPRF-based mqRPMT"); 
     if(pp.CLIENT_LEN != vec_X.size()){
         std::cerr << "input size of vec_X does not match public parameters" << std::endl;
         exit(1);  
     }
     
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
     auto start_time = std::chrono::steady_clock::now(); 
 
     std::vector<uint8_t> k2(32);
@@ -332,28 +354,31 @@ void Client(NetIO &io, PP &pp, std::vector<block> &vec_X)
 
     std::vector<EC25519Point> vec_Hash_X(pp.CLIENT_LEN); 
     std::vector<EC25519Point> vec_Fk2_X(pp.CLIENT_LEN); 
-    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-    for(auto i = 0; i < pp.CLIENT_LEN; i++){
-        Hash::BlockToBytes(vec_X[i], vec_Hash_X[i].px, 32); 
-        vec_Fk2_X[i] = vec_Hash_X[i] * k2; 
-    } 
-
-    // first receive incoming data
     std::vector<EC25519Point> vec_Fk1_Y(pp.SERVER_LEN);
-    io.ReceiveEC25519Points(vec_Fk1_Y.data(), pp.SERVER_LEN); // receive Fk1_Y from Server
-
-    // then send
-    io.SendEC25519Points(vec_Fk2_X.data(), pp.CLIENT_LEN);
-
-    std::cout <<"cwPRF-based mqRPMT [step 2]: Client ===> F_k2(x_i) ===> Server"; 
-
-    std::cout << " [" << 32*pp.CLIENT_LEN/(1024*1024) << " MB]" << std::endl;
+    std::vector<EC25519Point> vec_Fk2k1_Y(pp.SERVER_LEN);
+    {
+        // F_k1(y_i) streams in while F_k2(x_i) is computed and sent chunk by chunk
+        AsyncNetIO async_io(io); 
+        async_io.PostReceive(vec_Fk1_Y.data(), 32*pp.SERVER_LEN, 32*PIPELINE_CHUNK_LEN); 
+
+        for(size_t begin = 0; begin < pp.CLIENT_LEN; begin += PIPELINE_CHUNK_LEN){
+            size_t end = std::min(pp.CLIENT_LEN, begin + PIPELINE_CHUNK_LEN); 
+            Hash::BlocksToEC25519Points(vec_X.data()+begin, end-begin, vec_Hash_X.data()+begin); 
+            #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+            for(auto i = begin; i < end; i++){
+                vec_Fk2_X[i] = vec_Hash_X[i] * k2; 
+            }
+            async_io.AsyncSend(vec_Fk2_X.data()+begin, 32*(end-begin)); 
+        }
 
+        ProtocolLog() <<"cwPRF-based mqRPMT [step 2]: Client ===> F_k2(x_i) ===> Server" << std::endl; 
 
-    std::vector<EC25519Point> vec_Fk2k1_Y(pp.SERVER_LEN);
-    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-    for(auto i = 0; i < pp.SERVER_LEN; i++){
-        vec_Fk2k1_Y[i] = vec_Fk1_Y[i] * k2; // (H(y_i)^k1)^k2
+        async_io.StreamingReceive([&](size_t begin, size_t end){
+            #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+            for(auto i = begin/32; i < end/32; i++){
+                vec_Fk2k1_Y[i] = vec_Fk1_Y[i] * k2; // (H(y_i)^k1)^k2
+            }
+        }); 
     }
 
 
@@ -365,23 +390,21 @@ void Client(NetIO &io, PP &pp, std::vector<block> &vec_X)
         char *buffer = new char[filter_size]; 
         filter.WriteObject(buffer);
         io.SendBytes(buffer, filter_size); 
-        std::cout <<"cwPRF-based mqRPMT [step 2]: Client ===> BloomFilter(F_k2k1(y_i)) ===> Server";
-        std::cout << " [" << (double)filter_size/(1024*1024) << " MB]" << std::endl;
+        ProtocolLog() <<"cwPRF-based mqRPMT [step 2]: Client ===> BloomFilter(F_k2k1(y_i)) ===> Server" << std::endl;
         delete[] buffer; 
     #else
     // permutation
         std::shuffle(vec_Fk2k1_Y.begin(), vec_Fk2k1_Y.end(), global_built_in_prg);
         io.SendEC25519Points(vec_Fk2k1_Y.data(), pp.SERVER_LEN); 
-        std::cout <<"cwPRF-based mqRPMT [step 2]: Client ===> Permutation(F_k2k1(y_i)) ===> Server"; 
-        std::cout << " [" << (double)32 * pp.SERVER_LEN/(1024*1024) << " MB]" << std::endl;
+        ProtocolLog() <<"cwPRF-based mqRPMT [step 2]: Client ===> Permutation(F_k2k1(y_i)) ===> Server" << std::endl; 
     #endif
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "cwPRF-mqRPMT: Client side takes time = " 
+    ProtocolLog() << "cwPRF-mqRPMT: Client side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
         
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 }
 
 #endif
@@ -390,7 +413,7 @@ void Client(NetIO &io, PP &pp, std::vector<block> &vec_X)
 #endif
 
 // previous code using C interface of X25519: roughly 10% faster than current code using C++ interfaces  
-// std::vector<uint8_t> Server(NetIO &io, PP &pp, std::vector<block> &vec_Y)
+// std::vector<uint8_t> Server(Channel &io, PP &pp, std::vector<block> &vec_Y)
 // {
 //     if(pp.SERVER_LEN != vec_Y.size()){
 //         std::cerr << "input size of vec_Y does not match public parameters" << std::endl;
@@ -461,7 +484,7 @@ void Client(NetIO &io, PP &pp, std::vector<block> &vec_X)
 //     return vec_indication_bit; 
 // }
 
-// void Client(NetIO &io, PP &pp, std::vector<block> &vec_X) 
+// void Client(Channel &io, PP &pp, std::vector<block> &vec_X) 
 // {    
 //     if(pp.CLIENT_LEN != vec_X.size()){
 //         std::cerr << "input size of vec_X does not match public parameters" << std::endl;
@@ -103,7 +103,8 @@ void FetchPP(PP &pp, std::string pp_filename)
     fin >> pp; 
     fin.close(); 
 }
-#ifndef ENABLE_X25519_ACCELERATION
+// written against the ElGamal instance over ECPoint
+#if !defined(ENABLE_X25519_ACCELERATION) && !defined(ENABLE_RISTRETTO_GROUP)
 BlockArrayValue CTtoBlockArrayValue(ElGamal::CT &ct){
     std::vector<unsigned char> ct_buffer(2*POINT_BYTE_LEN);   
     std::vector<unsigned char> refill_buffer(sizeof(BlockArrayValue),0);    
@@ -119,14 +120,18 @@ ElGamal::CT BlockArrayValueToCT(BlockArrayValue &BlockArrayValue){
 	return ct;
 }
 
-std::vector<uint8_t> Server(NetIO &io, PP &pp, std::vector<block> &vec_Y){
+BitVector Server(Channel &io, PP &pp, std::vector<block> &vec_Y){
+    auto phase = io.Phase("rrPKE-based mqRPMT"); 
+    // the OKVS output is far above ZEROCOPY_THRESHOLD: with auto flush off NetIO pins it instead of copying it
+    bool auto_flush = io.GetAutoFlush(); 
+    io.SetAutoFlush(false); 
  
     if(pp.SERVER_LEN != vec_Y.size()){
         std::cerr << "input size of vec_Y does not match public parameters" << std::endl;
         exit(1);  
     }
 
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
     
     auto start_time = std::chrono::steady_clock::now(); 
     
@@ -164,8 +169,7 @@ std::vector<uint8_t> Server(NetIO &io, PP &pp, std::vector<block> &vec_Y){
     Baxos<gf_128, BlockArrayValue> baxos(pp.SERVER_LEN, bin_size, 3, pp.statistical_security_parameter);
     auto out_length = baxos.bin_num * baxos.total_size;//calculate the output length of OKVS::decode(vec_Y,vec_out)
     std::vector<BlockArrayValue> vec_out(out_length);
-    uint8_t baxos_thread_num = NUMBER_OF_THREADS;
-    baxos.solve(vec_Y, vec_value, vec_out, 0, baxos_thread_num);
+    baxos.solve(vec_Y, vec_value, vec_out, 0, NUMBER_OF_THREADS);
   
        
     //send the output of OKVS::decode to client
@@ -176,37 +180,38 @@ std::vector<uint8_t> Server(NetIO &io, PP &pp, std::vector<block> &vec_Y){
     io.ReceiveBytes(vec_rerand.data(), pp.CLIENT_LEN * VALUE_BYTE_LEN);
 
     // decrypt the ciphertext and compare with initial m to get final output
-    std::vector<uint8_t> vec_indication_bit(pp.CLIENT_LEN,0);
-    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-    for(auto i = 0; i < pp.CLIENT_LEN; i++){
+    BitVector vec_indication_bit(pp.CLIENT_LEN);
+    vec_indication_bit.Generate([&](size_t i){
     	ElGamal::CT ct = BlockArrayValueToCT(vec_rerand[i]);
     	ECPoint dec_m = ElGamal::Dec(pp_elgamal, sk, ct);
-    	if(m == dec_m){
-    		vec_indication_bit[i] = 1;
-    	}    		
-    }
+    	return m == dec_m; 
+    });
+    io.Flush(); 
+    io.SetAutoFlush(auto_flush); 
     
-    std::cout <<"rrPRF-based mqRPMT [step 1]: Server ===> [pk, Encode(y_i, z_i)--> D] ===> Client";
-    std::cout << " [" << (double)VALUE_BYTE_LEN*out_length/(1024*1024) << " MB]" << std::endl;
+    ProtocolLog() <<"rrPRF-based mqRPMT [step 1]: Server ===> [pk, Encode(y_i, z_i)--> D] ===> Client" << std::endl;
    
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "rrPRF-based mqRPMT: Server side takes time = " 
+    ProtocolLog() << "rrPRF-based mqRPMT: Server side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
     
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 
     return vec_indication_bit; 
 }
 
-void Client(NetIO &io, PP &pp, std::vector<block> &vec_X) 
+void Client(Channel &io, PP &pp, std::vector<block> &vec_X) 
 {    
+    auto phase = io.Phase("rrPKE-based mqRPMT"); 
+    bool auto_flush = io.GetAutoFlush(); 
+    io.SetAutoFlush(false); 
     if(pp.CLIENT_LEN != vec_X.size()){
         std::cerr << "input size of vec_Y does not match public parameters" << std::endl;
         exit(1);  
     }
     
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
     auto start_time = std::chrono::steady_clock::now(); 
     
     // receive pk from server
@@ -224,8 +229,7 @@ void Client(NetIO &io, PP &pp, std::vector<block> &vec_X)
     
     // decode vec_X with out[]
     std::vector<BlockArrayValue> vec_decode(pp.CLIENT_LEN);
-    uint8_t thread_num = NUMBER_OF_THREADS;
-    baxos.decode(vec_X, vec_decode, vec_out, thread_num);
+    baxos.decode(vec_X, vec_decode, vec_out, NUMBER_OF_THREADS);
     
     // re-rand the cipher and transfer it to BlockArrayValue
     std::vector<BlockArrayValue> vec_rerand(pp.CLIENT_LEN);
@@ -236,17 +240,18 @@ void Client(NetIO &io, PP &pp, std::vector<block> &vec_X)
 	vec_rerand[i] = CTtoBlockArrayValue(new_ct);
     }
     io.SendBytes(vec_rerand.data(), pp.CLIENT_LEN * VALUE_BYTE_LEN);
-   
+    // vec_rerand may still be pinned for a zero-copy send
+    io.Flush(); 
+    io.SetAutoFlush(auto_flush); 
 
-    std::cout <<"rrPKE-based mqRPMT [step 2]: Client ===> [pk, Re-Rand(decode(D,x_i),r)]===> Server"; 
-    std::cout << " [" << (double)VALUE_BYTE_LEN*pp.CLIENT_LEN/(1024*1024) << " MB]" << std::endl;
+    ProtocolLog() <<"rrPKE-based mqRPMT [step 2]: Client ===> [pk, Re-Rand(decode(D,x_i),r)]===> Server" << std::endl; 
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "rrPKE-based mqRPMT: Client side takes time = " 
+    ProtocolLog() << "rrPKE-based mqRPMT: Client side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
 
-    PrintSplitLine('-'); 
+    LogSplitLine('-'); 
 }
 
 #endif
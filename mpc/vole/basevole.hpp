@@ -24,6 +24,7 @@ In detail, we implement the protocol in Figure:15 with p = p^r = 2^128.
 #include "../ot/alsz_ote.hpp"
 #include "../../crypto/aes.hpp"
 #include"../../crypto/block.hpp"
+#include "../../crypto/gf128.hpp"
 
 
 namespace VOLE {
@@ -31,25 +32,22 @@ namespace VOLE {
 	//In the end, A obtains w and B obtains v, satisfying w = v + u*delta.
 	
 	// call baseVOLE once
-	std::vector<block> baseVOLE_A(NetIO &io,block* ptr_u = nullptr);
-	std::vector<block> baseVOLE_B(NetIO &io,block* ptr_delta = nullptr);
+	std::vector<block> baseVOLE_A(Channel &io,block* ptr_u = nullptr);
+	std::vector<block> baseVOLE_B(Channel &io,block* ptr_delta = nullptr);
 	
 	// call baseVOLE t times
-	void baseVOLE_tA(NetIO &io, uint64_t t, std::vector<block>& vec_u, std::vector<block>& vec_w);
-	void baseVOLE_tB(NetIO &io, uint64_t t, std::vector<block>& vec_v, block delta);
+	void baseVOLE_tA(Channel &io, uint64_t t, std::vector<block>& vec_u, std::vector<block>& vec_w);
+	void baseVOLE_tB(Channel &io, uint64_t t, std::vector<block>& vec_v, block delta);
 	
 	
-	inline block gf128_mul(const block x, const block y);
-	// <g,vec_x> = gf128_mul(2^0,vec_x[0])+...+gf128_mul(2^127,vec_x[127])
-	inline block gadget_innerProduct(std::vector<block> vec_x);
+	// <g,vec_x> = 2^0*vec_x[0]+...+2^127*vec_x[127] in GF(2^128), see GF128::GadgetInnerProduct
+	inline block gadget_innerProduct(const std::vector<block> &vec_x);
 	
 
 	// return [u, w = share_(U*delta)]
-	std::vector<block> baseVOLE_A(NetIO &io, block* ptr_u){
+	std::vector<block> baseVOLE_A(Channel &io, block* ptr_u){
+		auto phase = io.Phase("base VOLE"); 
 
-		// set fixed seed for PRG 
-		PRG::Seed prg_seed = PRG::SetSeed(fixed_seed, 0);	
-			
 		// set a random seed to sample 128 pairs of random K0, K1 
 		PRG::Seed seed_k = PRG::SetSeed();
 		std::vector<block> vec_k0 = PRG::GenRandomBlocks(seed_k, 128);
@@ -74,8 +72,8 @@ namespace VOLE {
 		std::vector<block> vec_w0(128);
 		std::vector<block> vec_w1(128);
 
-		AES::FastECBEnc(prg_seed.aes_key, vec_k0.data(), 128, vec_w0.data());
-		AES::FastECBEnc(prg_seed.aes_key, vec_k1.data(), 128, vec_w1.data());
+		Hash::CRHashBlocks(vec_k0.data(), vec_w0.data(), 128);
+		Hash::CRHashBlocks(vec_k1.data(), vec_w1.data(), 128);
 		
 		// get u
 		block u;
@@ -115,7 +113,8 @@ namespace VOLE {
 	}
 	
 	// return [delta, v = share_(u*delta)]
-	std::vector<block> baseVOLE_B(NetIO &io,block* ptr_delta){
+	std::vector<block> baseVOLE_B(Channel &io,block* ptr_delta){
+		auto phase = io.Phase("base VOLE"); 
 		block delta;
 		// if there is no given delta
 		if(ptr_delta == nullptr){
@@ -168,12 +167,9 @@ namespace VOLE {
 		
 		std::vector<block> vec_k = Receive(io, pp, vec_delta_bit, 128);
 		
-		// set fixed seed for PRG 
-		PRG::Seed prg_seed = PRG::SetSeed(fixed_seed, 0);
-		
-		//calculate vec_w = PRF(w)
+		//calculate vec_w = H(k) with the fixed-key correlation robust hash
 		std::vector<block> vec_w(128);
-		AES::FastECBEnc(prg_seed.aes_key, vec_k.data(), 128, vec_w.data());
+		Hash::CRHashBlocks(vec_k.data(), vec_w.data(), 128);
 	
 		// receive vec_gama from A
 		std::vector<block> vec_gama(128);
@@ -201,15 +197,13 @@ namespace VOLE {
 	
 
 	// return [u, w = share_(U*delta)]
-	void baseVOLE_tA(NetIO &server_io, uint64_t t, std::vector<block>& vec_u, std::vector<block>& vec_w){
+	void baseVOLE_tA(Channel &server_io, uint64_t t, std::vector<block>& vec_u, std::vector<block>& vec_w){
+		auto phase = server_io.Phase("base VOLE"); 
 		vec_u.resize(t);
 		vec_w.resize(t);
 		uint64_t BASE_LEN = 128;
 		uint64_t EXTEND_LEN = t * 128;
 		
-		// set fixed seed for PRG 
-		PRG::Seed prg_seed = PRG::SetSeed(fixed_seed, 0);	
-			
 		// set a random seed to sample 128 pairs of random K0, K1 
 		PRG::Seed seed_k = PRG::SetSeed();
 		std::vector<block> vec_k0 = PRG::GenRandomBlocks(seed_k, EXTEND_LEN);
@@ -234,8 +228,8 @@ namespace VOLE {
 		std::vector<block> vec_w0(EXTEND_LEN);
 		std::vector<block> vec_w1(EXTEND_LEN);
 
-		AES::FastECBEnc(prg_seed.aes_key, vec_k0.data(), EXTEND_LEN, vec_w0.data());
-		AES::FastECBEnc(prg_seed.aes_key, vec_k1.data(), EXTEND_LEN, vec_w1.data());
+		Hash::CRHashBlocks(vec_k0.data(), vec_w0.data(), EXTEND_LEN);
+		Hash::CRHashBlocks(vec_k1.data(), vec_w1.data(), EXTEND_LEN);
 		
 		// there is no given u
 		vec_u = PRG::GenRandomBlocks(seed_k, t);
@@ -262,15 +256,14 @@ namespace VOLE {
 		
 		// calculate <g,w0> 
 		for(auto i = 0; i < t; ++i){
-			auto begin = vec_w0.begin() + (i*128);
-			std::vector<block> temp_vec_w0(begin, begin+128);
-			vec_w[i] = gadget_innerProduct(temp_vec_w0);
+			vec_w[i] = GF128::GadgetInnerProduct(vec_w0.data() + i*128);
 		}
 
 	}
 	
 	// return delta, [v = share_(u*delta)]
-	void baseVOLE_tB(NetIO &client_io, uint64_t t, std::vector<block>& vec_v, block delta){
+	void baseVOLE_tB(Channel &client_io, uint64_t t, std::vector<block>& vec_v, block delta){
+		auto phase = client_io.Phase("base VOLE"); 
 		vec_v.resize(t);
 		
 		uint64_t BASE_LEN = 128;
@@ -317,12 +310,9 @@ namespace VOLE {
     		}
 		std::vector<block> vec_k = ALSZOTE::Receive(client_io, pp, vec_select_bit, EXTEND_LEN);
 		
-		// set fixed seed for PRG 
-		PRG::Seed prg_seed = PRG::SetSeed(fixed_seed, 0);
-		
-		//calculate vec_w = PRF(w)
+		//calculate vec_w = H(k) with the fixed-key correlation robust hash
 		std::vector<block> vec_w(EXTEND_LEN);
-		AES::FastECBEnc(prg_seed.aes_key, vec_k.data(), EXTEND_LEN, vec_w.data());
+		Hash::CRHashBlocks(vec_k.data(), vec_w.data(), EXTEND_LEN);
 	
 		// receive vec_gama from A
 		std::vector<block> vec_gama(EXTEND_LEN);
@@ -347,50 +337,10 @@ namespace VOLE {
 
 
 	
-	__attribute__((target("pclmul,sse2")))
-	inline block gf128_mul(const block x, const block y)
-	{
-
-  	  block x0y0 = _mm_clmulepi64_si128(x, y, 0x00);
-  	  block x1y0 = _mm_clmulepi64_si128(x, y, 0x10);
-  	  block x0y1 = _mm_clmulepi64_si128(x, y, 0x01);
-  	  block x1y1 = _mm_clmulepi64_si128(x, y, 0x11);
-  	  x1y0 = (x1y0 ^ x0y1);
-  	  x0y1 = _mm_slli_si128(x1y0, 8);
-   	  x1y0 = _mm_srli_si128(x1y0, 8);
-   	  x0y0 = (x0y0 ^ x0y1);
-   	  x1y1 = (x1y1 ^ x1y0);
-
-   	  auto mul256_low = x0y0;
-   	  auto mul256_high = x1y1;
-
-   	  static const constexpr std::uint64_t mod_omit128 = 0b10000111;
-
-  	  const block modulus_omit128 = _mm_loadl_epi64((const block *)&(mod_omit128));
-  	  block impact = _mm_clmulepi64_si128(mul256_high, modulus_omit128, 0x01);
-   	  mul256_low = _mm_xor_si128(mul256_low, _mm_slli_si128(impact, 8));
-   	  mul256_high = _mm_xor_si128(mul256_high, _mm_srli_si128(impact, 8));
-
-    	  impact = _mm_clmulepi64_si128(mul256_high, modulus_omit128, 0x00);
-   	  mul256_low = _mm_xor_si128(mul256_low, impact);
-
-    	  return mul256_low;
-	}
-	// calculate <g,vec_x> = gf128_mul(2^0,vec_x[0])+...+gf128_mul(2^127,vec_x[127])
-	inline block gadget_innerProduct(std::vector<block> vec_x){
+	// calculate <g,vec_x> = 2^0*vec_x[0]+...+2^127*vec_x[127]
+	inline block gadget_innerProduct(const std::vector<block> &vec_x){
 		assert(vec_x.size() == 128);
-		block x = _mm_set_epi64x(0LL, 0ll);
-		for(auto i = 0; i < 128; ++i){
-			block wi;
-			if(i<64){
-				wi = _mm_set_epi64x(0LL, 1LL << i);
-			}
-			else{
-				wi = _mm_set_epi64x(1LL << (i-64), 0LL);
-			}
-			x ^= gf128_mul(wi, vec_x[i]);
-		}
-		return x;
+		return GF128::GadgetInnerProduct(vec_x.data());
 	}
 	
 	
@@ -31,13 +31,13 @@ namespace VOLE {
 
 	//(1) VOLE = baseVOLE + tmpVOLE
 	//A obtains vec_A and vec_C, B obtains vec_B and delta, satisfying vec_B = vec_C + vec_A*delta.
-	std::vector<block> VOLE_A(NetIO &A_io, uint64_t N_item, std::vector<block>& vec_C, uint64_t t = 128);
-	void VOLE_B(NetIO &B_io, uint64_t N_item, std::vector<block>& vec_B, block delta, uint64_t t = 128);
+	std::vector<block> VOLE_A(Channel &A_io, uint64_t N_item, std::vector<block>& vec_C, uint64_t t = 128);
+	void VOLE_B(Channel &B_io, uint64_t N_item, std::vector<block>& vec_B, block delta, uint64_t t = 128);
 	
 	
 	// (2) tmpVOLE = t * spVOLE + ExConvCode
-	void tmpVOLE_B(NetIO &B_io, uint64_t N_item, uint64_t t, std::vector<block> vec_v, std::vector<block>& vec_B);
-	std::vector<block> tmpVOLE_A(NetIO& A_io, uint64_t N_item, uint64_t t, std::vector<block>& vec_C, std::vector<block> vec_u, std::vector<block> vec_w);
+	void tmpVOLE_B(Channel &B_io, uint64_t N_item, uint64_t t, std::vector<block> vec_v, std::vector<block>& vec_B);
+	std::vector<block> tmpVOLE_A(Channel &A_io, uint64_t N_item, uint64_t t, std::vector<block>& vec_C, std::vector<block> vec_u, std::vector<block> vec_w);
 	
 	block FullEval(uint8_t depth, block k, std::vector<block>& vec_leaf, std::vector<block>& vec_m0, std::vector<block>& vec_m1);
 	std::vector<block> PuncEval(uint8_t depth, block beta, block* ptr_m, uint8_t* ptr_selection_bit);
@@ -56,7 +56,8 @@ namespace VOLE {
 	
 	//(1) VOLE = baseVOLE + tmpVOLE
 	//(1.1) return vec_A and vec_C
-	std::vector<block> VOLE_A(NetIO &A_io, uint64_t N_item, std::vector<block>& vec_C, uint64_t t){
+	std::vector<block> VOLE_A(Channel &A_io, uint64_t N_item, std::vector<block>& vec_C, uint64_t t){
+		auto phase = A_io.Phase("VOLE"); 
 		std::vector<block> vec_u;
 		std::vector<block> vec_w;
 		std::vector<block> vec_A;
@@ -78,7 +79,8 @@ namespace VOLE {
 	}
 	
 	//(1.2) return vec_B
-	void VOLE_B(NetIO &B_io, uint64_t N_item, std::vector<block>& vec_B, block delta, uint64_t t){
+	void VOLE_B(Channel &B_io, uint64_t N_item, std::vector<block>& vec_B, block delta, uint64_t t){
+	 	auto phase = B_io.Phase("VOLE"); 
 	 	std::vector<block> vec_v;
 		
 		if (N_item < 256)
@@ -96,7 +98,8 @@ namespace VOLE {
 	
 	//(2) tmpVOLE = t * spVOLE + ExConvCode
 	//(2.1) return vec_B with input vec_v	
-	void tmpVOLE_B(NetIO &server_io, uint64_t N_item, uint64_t t, std::vector<block> vec_v, std::vector<block>& vec_leaf) {
+	void tmpVOLE_B(Channel &server_io, uint64_t N_item, uint64_t t, std::vector<block> vec_v, std::vector<block>& vec_leaf) {
+		auto phase = server_io.Phase("VOLE"); 
 		if (!vec_leaf.empty()) {
 			vec_leaf.clear();
 		}
@@ -173,16 +176,17 @@ namespace VOLE {
 		// print the output just for test
 		N_item /= 2;		
 		for(auto i = 0;i < N_item; ++i){
-			std::cout << i << std::endl;
+			ProtocolLog() << i << std::endl;
 			Block::PrintBlock(vec_leaf[i]);
-			std::cout << "  " << std::endl;
+			ProtocolLog() << "  " << std::endl;
 		}
 		*/
 	
 	}
 	
 	//(2.2) return vec_A and vec_C with input vec_u and vec_w	
-	std::vector<block> tmpVOLE_A(NetIO& client_io, uint64_t N_item, uint64_t t, std::vector<block>& vec_leaf, std::vector<block> vec_u, std::vector<block> vec_w) {
+	std::vector<block> tmpVOLE_A(Channel &client_io, uint64_t N_item, uint64_t t, std::vector<block>& vec_leaf, std::vector<block> vec_u, std::vector<block> vec_w) {
+		auto phase = client_io.Phase("VOLE"); 
 		if (!vec_leaf.empty()) {
 			vec_leaf.clear();
 		}
@@ -236,6 +240,8 @@ namespace VOLE {
 			uint64_t add_mod =128 - (select_len % 128);
 			EXTEND_LEN = select_len + add_mod;
 			
+			// the padding OTs choose m0, their outputs are dropped below
+			vec_select_bit.resize(EXTEND_LEN, 0);
 			vec_total_m = ALSZOTE::Receive(client_io, pp, vec_select_bit, EXTEND_LEN);
 			vec_total_m.resize(select_len);
 		}
@@ -284,16 +290,16 @@ namespace VOLE {
 		N_item /= 2;
 		block delta = _mm_set_epi64x(0x2c9e2e7639500ed4,0x97f40bbf3a16f778);
 		for(auto i = 0; i < N_item; ++i){
-			std::cout << i << std::endl;
+			ProtocolLog() << i << std::endl;
 			if(!Block::Compare(a0,base_field_A[i])){
 				 //std::cout << i << std::endl;
-				Block::PrintBlock(vec_leaf[i]^gf128_mul(base_field_A[i],delta));
-				PrintSplitLine('-');
+				Block::PrintBlock(vec_leaf[i]^GF128::Mul(base_field_A[i],delta));
+				LogSplitLine('-');
 			}
 			else{Block::PrintBlock(vec_leaf[i]);}
 			//Block::PrintBlock(vec_leaf[i]);
 			
-			std::cout << "  " << std::endl;
+			ProtocolLog() << "  " << std::endl;
 		}
 		*/
 		
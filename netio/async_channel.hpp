@@ -0,0 +1,188 @@
+/****************************************************************************
+this hpp implements an asynchronous wrapper around any Channel, so that a protocol can compute chunk k
+while chunk k-1 is on the wire
+sends are queued to a background I/O thread: at most SLOT_NUM of them are in flight, beyond that AsyncSend blocks
+a posted receive fills the destination on a second thread, and StreamingReceive hands every chunk to the caller
+as soon as it is in; post the receive before a long run of sends, otherwise two parties that both send first
+fill each other's socket buffers and stall
+while an AsyncNetIO is alive, the underlying channel must only be used directly after Drain()
+the metrics of the underlying channel count each chunk as a message, and the exchange as the caller's round trips
+*****************************************************************************
+* @copyright  MIT license (see LICENSE file)
+*****************************************************************************/
+#ifndef KUNLUN_NET_IO_ASYNC_CHANNEL
+#define KUNLUN_NET_IO_ASYNC_CHANNEL
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <deque>
+#include "channel.hpp"
+
+class AsyncNetIO{
+public:
+	explicit AsyncNetIO(Channel &io, size_t SLOT_NUM = 4);
+	~AsyncNetIO();
+
+	AsyncNetIO(const AsyncNetIO&) = delete;
+	AsyncNetIO& operator=(const AsyncNetIO&) = delete;
+
+	// queue LEN bytes for sending: the data must stay valid and unchanged until the future is ready
+	std::future<void> AsyncSend(const void *data, size_t LEN);
+
+	// wait until every queued send is on the wire
+	void Drain();
+
+	// start receiving LEN bytes into data in the background, in chunks of CHUNK_LEN bytes (the last one may be shorter)
+	void PostReceive(void *data, size_t LEN, size_t CHUNK_LEN);
+
+	// handle(begin, end) runs on the calling thread for the byte range of each chunk of the posted receive, in order
+	template <typename Handler>
+	void StreamingReceive(Handler handle);
+
+	template <typename Handler>
+	void StreamingReceive(void *data, size_t LEN, size_t CHUNK_LEN, Handler handle);
+
+private:
+	struct SendTask{
+		const void *data;
+		size_t LEN;
+		std::promise<void> done;
+	};
+
+	Channel &io;
+	bool io_auto_flush;  // the setting of io before this wrapper, restored on destruction
+	size_t SLOT_NUM;
+	std::deque<SendTask> queue;  // the front task is the one being sent
+	std::mutex queue_mutex;
+	std::condition_variable queue_cv;
+	bool stop = false;
+	std::thread sender;
+
+	// the posted receive
+	char *receive_data = nullptr;
+	size_t RECEIVE_LEN = 0;
+	size_t RECEIVE_CHUNK_LEN = 1;
+	size_t RECEIVED_CHUNK_NUM = 0;
+	std::mutex receive_mutex;
+	std::condition_variable receive_cv;
+	std::thread receiver;
+
+	void SendLoop();
+	void ReceiveLoop();
+};
+
+AsyncNetIO::AsyncNetIO(Channel &io, size_t SLOT_NUM) : io(io), SLOT_NUM(std::max<size_t>(1, SLOT_NUM))
+{
+	// every send must reach the wire by itself: the I/O thread never leaves bytes in the send buffer
+	this->io_auto_flush = this->io.GetAutoFlush();
+	this->io.SetAutoFlush(true);
+	this->sender = std::thread(&AsyncNetIO::SendLoop, this);
+}
+
+AsyncNetIO::~AsyncNetIO()
+{
+	if(this->receiver.joinable()) this->receiver.join();
+	this->Drain();
+	{
+		std::lock_guard<std::mutex> lock(this->queue_mutex);
+		this->stop = true;
+	}
+	this->queue_cv.notify_all();
+	this->sender.join();
+	this->io.SetAutoFlush(this->io_auto_flush);
+}
+
+void AsyncNetIO::SendLoop()
+{
+	std::unique_lock<std::mutex> lock(this->queue_mutex);
+	while(true){
+		this->queue_cv.wait(lock, [this]{ return this->stop || !this->queue.empty(); });
+		if(this->queue.empty()) return;
+
+		// a deque keeps references to its elements valid across push_back
+		SendTask &task = this->queue.front();
+		lock.unlock();
+		this->io.SendChunk(task.data, task.LEN);
+		task.done.set_value();
+		lock.lock();
+
+		this->queue.pop_front();
+		this->queue_cv.notify_all();
+	}
+}
+
+std::future<void> AsyncNetIO::AsyncSend(const void *data, size_t LEN)
+{
+	this->io.MarkSend(); 
+	std::unique_lock<std::mutex> lock(this->queue_mutex);
+	this->queue_cv.wait(lock, [this]{ return this->queue.size() < this->SLOT_NUM; });
+	this->queue.push_back({data, LEN, std::promise<void>()});
+	std::future<void> done = this->queue.back().done.get_future();
+	this->queue_cv.notify_all();
+	return done;
+}
+
+void AsyncNetIO::Drain()
+{
+	std::unique_lock<std::mutex> lock(this->queue_mutex);
+	this->queue_cv.wait(lock, [this]{ return this->queue.empty(); });
+}
+
+void AsyncNetIO::ReceiveLoop()
+{
+	size_t CHUNK_NUM = (this->RECEIVE_LEN + this->RECEIVE_CHUNK_LEN - 1) / this->RECEIVE_CHUNK_LEN;
+	for(size_t k = 0; k < CHUNK_NUM; k++){
+		size_t begin = k * this->RECEIVE_CHUNK_LEN;
+		size_t end = std::min(this->RECEIVE_LEN, begin + this->RECEIVE_CHUNK_LEN);
+		this->io.ReceiveChunk(this->receive_data + begin, end - begin);
+		{
+			std::lock_guard<std::mutex> lock(this->receive_mutex);
+			this->RECEIVED_CHUNK_NUM = k + 1;
+		}
+		this->receive_cv.notify_one();
+	}
+}
+
+void AsyncNetIO::PostReceive(void *data, size_t LEN, size_t CHUNK_LEN)
+{
+	if(this->receiver.joinable()){
+		std::cerr << "AsyncNetIO: the previous receive is still posted" << std::endl;
+		exit(EXIT_FAILURE);
+	}
+	this->receive_data = (char*)data;
+	this->RECEIVE_LEN = LEN;
+	this->RECEIVE_CHUNK_LEN = std::max<size_t>(1, CHUNK_LEN);
+	this->RECEIVED_CHUNK_NUM = 0;
+	this->receiver = std::thread(&AsyncNetIO::ReceiveLoop, this);
+}
+
+template <typename Handler>
+void AsyncNetIO::StreamingReceive(Handler handle)
+{
+	if(!this->receiver.joinable()){
+		std::cerr << "AsyncNetIO: no receive is posted" << std::endl;
+		exit(EXIT_FAILURE);
+	}
+	// the caller waits for the peer here: one round trip if it has sent since its last receive
+	this->io.MarkReceive(); 
+	size_t CHUNK_NUM = (this->RECEIVE_LEN + this->RECEIVE_CHUNK_LEN - 1) / this->RECEIVE_CHUNK_LEN;
+	for(size_t k = 0; k < CHUNK_NUM; k++){
+		{
+			std::unique_lock<std::mutex> lock(this->receive_mutex);
+			this->receive_cv.wait(lock, [&]{ return this->RECEIVED_CHUNK_NUM > k; });
+		}
+		handle(k * this->RECEIVE_CHUNK_LEN, std::min(this->RECEIVE_LEN, (k + 1) * this->RECEIVE_CHUNK_LEN));
+	}
+	this->receiver.join();
+}
+
+template <typename Handler>
+void AsyncNetIO::StreamingReceive(void *data, size_t LEN, size_t CHUNK_LEN, Handler handle)
+{
+	this->PostReceive(data, LEN, CHUNK_LEN);
+	this->StreamingReceive(handle);
+}
+
+#endif
@@ -0,0 +1,510 @@
+/****************************************************************************
+this hpp defines the channel interface that every transport implements
+a transport only moves bytes (SendSpans, ReceiveDataInternal, and Flush if it buffers);
+the typed helpers for blocks, points, big integers and vectors are written once on top of them,
+so protocol code taking a Channel& runs over TCP (NetIO), in-process threads (LoopbackChannel)
+or shared memory (ShmChannel) alike
+every channel also counts its traffic and time per named phase (see channel_metrics.hpp)
+*****************************************************************************
+* @copyright  MIT license (see LICENSE file)
+*****************************************************************************/
+#ifndef KUNLUN_NET_IO_CHANNEL
+#define KUNLUN_NET_IO_CHANNEL
+
+#include "../include/std.inc"
+#include "../crypto/ec_point.hpp"
+#include "../crypto/ec_25519.hpp"
+#include "../crypto/ec_ristretto.hpp"
+#include "../utility/bit_vector.hpp"
+#include "channel_metrics.hpp"
+#include <mutex>
+#include <ctime>
+
+// one piece of a scatter-gather send
+struct ByteSpan{
+	const void *data;
+	size_t LEN;
+};
+
+class Channel{
+public:
+	Channel() { this->ResetMetrics(); } 
+	virtual ~Channel() = default; 
+
+	// the bytes on the wire are the concatenation of the NUM spans
+	virtual void SendSpans(const ByteSpan *spans, size_t NUM) = 0; 
+	// returns once exactly LEN bytes have arrived
+	virtual void ReceiveDataInternal(const void *data, size_t LEN) = 0; 
+
+	// by default every send is delivered when it returns; buffering transports override these
+	virtual void SetAutoFlush(bool flag) {} 
+	virtual bool GetAutoFlush() const { return true; } 
+	virtual void Flush() {} 
+	// returns once the data of earlier sends is no longer read, so a temporary buffer may be freed; transports that
+	// keep reading it after the send returns (MSG_ZEROCOPY with auto flush off in NetIO) override this
+	virtual void ReleaseSendData() {} 
+
+	void SendDataInternal(const void *data, size_t LEN); 
+
+	void SendBytes(const void *data, size_t LEN);  
+	void ReceiveBytes(void *data, size_t LEN); 
+
+	/*
+	** for wrappers that move one logical message in chunks on their own threads (see AsyncNetIO):
+	** a chunk is charged its bytes and one message, but no round trip; the calling flow charges
+	** its logical send and receive with MarkSend and MarkReceive, so the round trips do not depend on the chunking
+	*/
+	void SendChunk(const void *data, size_t LEN); 
+	void ReceiveChunk(void *data, size_t LEN); 
+	void MarkSend(); 
+	void MarkReceive(); 
+
+	void SendBlocks(const block* data, size_t LEN);
+	void ReceiveBlocks(block* data, size_t LEN);  
+
+	void SendBlock(const block &a);
+	void ReceiveBlock(block &a);  
+
+	void SendECPoints(const ECPoint* vec_A, size_t LEN); 
+	void ReceiveECPoints(ECPoint* vec_A, size_t LEN); 
+
+	// overloads for ristretto255 points
+	void SendECPoints(const RistrettoPoint* vec_A, size_t LEN); 
+	void ReceiveECPoints(RistrettoPoint* vec_A, size_t LEN); 
+
+	void SendEC25519Points(const EC25519Point* vec_A, size_t LEN); 
+	void ReceiveEC25519Points(EC25519Point* vec_A, size_t LEN); 
+
+	void SendECPoint(const ECPoint &A);
+	void ReceiveECPoint(ECPoint &A);
+
+	void SendBigInt(const BigInt &a);
+	void ReceiveBigInt(BigInt &a);
+
+	void SendBigInt(const BigInt &a, size_t LEN);
+	void ReceiveBigInt(BigInt &a, size_t LEN);
+
+	void SendBits(uint8_t *data, size_t LEN);
+	void ReceiveBits(uint8_t *data, size_t LEN); 
+
+	// packed: ceil(LEN/8) bytes on the wire; the receiver sizes A beforehand
+	void SendBits(const BitVector &A);
+	void ReceiveBits(BitVector &A); 
+
+	void SendString(char *data, size_t LEN);
+	void ReceiveString(char *data, size_t LEN); 
+
+	void SendString(std::string &str);
+	void ReceiveString(std::string &str); 
+
+	template <typename T>
+	void SendInteger(const T &n);
+
+	template <typename T>
+	void ReceiveInteger(T &n);
+
+	void SendBytesVector(const std::vector<std::vector<uint8_t>> &A); 
+	void ReceiveBytesVector(std::vector<std::vector<uint8_t>> &A); 
+
+	void SendStringVector(const std::vector<std::string>& A, size_t LEN); 
+	void ReceiveStringVector(std::vector<std::string> &A, size_t LEN); 
+
+	// closes the phase it opened when it goes out of scope
+	class PhaseGuard{
+	public:
+		PhaseGuard(Channel &io, const std::string &name) : io(io) { io.BeginPhase(name); }
+		~PhaseGuard() { io.EndPhase(); }
+		PhaseGuard(const PhaseGuard&) = delete; 
+		PhaseGuard& operator=(const PhaseGuard&) = delete; 
+	private:
+		Channel &io; 
+	};
+
+	/*
+	** auto phase = io.Phase("name"): traffic and time go to this phase until the guard is destroyed
+	** reopening the innermost phase (a wrapper calling its overload) does not nest it in itself
+	*/
+	PhaseGuard Phase(const std::string &name) { return PhaseGuard(*this, name); }
+	void BeginPhase(const std::string &name); 
+	void EndPhase(); 
+
+	// a snapshot with the time charged up to now
+	ChannelMetrics GetMetrics(); 
+	void ResetMetrics(); 
+
+private:
+	std::mutex metrics_mutex; 
+	ChannelMetrics metrics; 
+	std::vector<size_t> phase_stack; // indices into metrics.phases, the innermost last
+	bool last_was_send = false; 
+	std::chrono::steady_clock::time_point last_wall_time; 
+	std::clock_t last_cpu_time; 
+
+	// the caller holds metrics_mutex
+	void ChargeTime(); 
+	void CountSend(size_t LEN, bool MARK = true); 
+	void CountReceive(size_t LEN, bool MARK = true); 
+	void CountRoundTrip(); 
+};
+
+void Channel::ChargeTime()
+{
+	auto wall_time = std::chrono::steady_clock::now(); 
+	std::clock_t cpu_time = std::clock(); 
+	PhaseMetrics &phase = this->metrics.phases[this->phase_stack.back()]; 
+	phase.WALL_MS += std::chrono::duration<double, std::milli>(wall_time - this->last_wall_time).count(); 
+	phase.CPU_MS += 1000.0 * (cpu_time - this->last_cpu_time) / CLOCKS_PER_SEC; 
+	this->last_wall_time = wall_time; 
+	this->last_cpu_time = cpu_time; 
+}
+
+void Channel::BeginPhase(const std::string &name)
+{
+	std::lock_guard<std::mutex> lock(this->metrics_mutex); 
+	this->ChargeTime(); 
+
+	size_t parent = this->phase_stack.back(); 
+	const std::string &parent_name = this->metrics.phases[parent].name; 
+	std::string full_name; 
+	if(parent == 0) full_name = name; 
+	else if(parent_name.substr(parent_name.rfind('/') + 1) == name) full_name = parent_name; 
+	else full_name = parent_name + "/" + name; 
+
+	size_t index = 0; 
+	while(index < this->metrics.phases.size() && this->metrics.phases[index].name != full_name) index++; 
+	if(index == this->metrics.phases.size()){
+		this->metrics.phases.emplace_back(); 
+		this->metrics.phases.back().name = full_name; 
+	}
+	this->phase_stack.emplace_back(index); 
+}
+
+void Channel::EndPhase()
+{
+	std::lock_guard<std::mutex> lock(this->metrics_mutex); 
+	this->ChargeTime(); 
+	if(this->phase_stack.size() > 1) this->phase_stack.pop_back(); 
+}
+
+ChannelMetrics Channel::GetMetrics()
+{
+	std::lock_guard<std::mutex> lock(this->metrics_mutex); 
+	this->ChargeTime(); 
+	return this->metrics; 
+}
+
+void Channel::ResetMetrics()
+{
+	std::lock_guard<std::mutex> lock(this->metrics_mutex); 
+	this->metrics.phases.assign(1, PhaseMetrics()); 
+	this->metrics.phases[0].name = "unphased"; 
+	this->phase_stack.assign(1, 0); 
+	this->last_was_send = false; 
+	this->last_wall_time = std::chrono::steady_clock::now(); 
+	this->last_cpu_time = std::clock(); 
+}
+
+void Channel::CountSend(size_t LEN, bool MARK)
+{
+	std::lock_guard<std::mutex> lock(this->metrics_mutex); 
+	PhaseMetrics &phase = this->metrics.phases[this->phase_stack.back()]; 
+	phase.BYTES_SENT += LEN; 
+	phase.MESSAGES_SENT++; 
+	if(MARK) this->last_was_send = true; 
+}
+
+void Channel::CountReceive(size_t LEN, bool MARK)
+{
+	std::lock_guard<std::mutex> lock(this->metrics_mutex); 
+	PhaseMetrics &phase = this->metrics.phases[this->phase_stack.back()]; 
+	phase.BYTES_RECEIVED += LEN; 
+	phase.MESSAGES_RECEIVED++; 
+	if(MARK) this->CountRoundTrip(); 
+}
+
+void Channel::CountRoundTrip()
+{
+	if(this->last_was_send) this->metrics.phases[this->phase_stack.back()].ROUND_TRIPS++; 
+	this->last_was_send = false; 
+}
+
+void Channel::MarkSend()
+{
+	std::lock_guard<std::mutex> lock(this->metrics_mutex); 
+	this->last_was_send = true; 
+}
+
+void Channel::MarkReceive()
+{
+	std::lock_guard<std::mutex> lock(this->metrics_mutex); 
+	this->CountRoundTrip(); 
+}
+
+// the very basic send function 
+void Channel::SendDataInternal(const void *data, size_t LEN)
+{
+	this->CountSend(LEN); 
+	ByteSpan span = {data, LEN}; 
+	this->SendSpans(&span, 1); 
+}
+
+void Channel::SendBytes(const void* data, size_t LEN) 
+{
+	SendDataInternal(data, LEN); 
+}
+
+void Channel::ReceiveBytes(void* data, size_t LEN) 
+{
+	this->CountReceive(LEN); 
+	ReceiveDataInternal(data, LEN); 
+}
+
+void Channel::SendChunk(const void *data, size_t LEN) 
+{
+	this->CountSend(LEN, false); 
+	ByteSpan span = {data, LEN}; 
+	this->SendSpans(&span, 1); 
+}
+
+void Channel::ReceiveChunk(void *data, size_t LEN) 
+{
+	this->CountReceive(LEN, false); 
+	ReceiveDataInternal(data, LEN); 
+}
+
+void Channel::SendBlocks(const block* data, size_t LEN) 
+{
+	SendBytes(data, LEN*sizeof(block));
+}
+
+void Channel::ReceiveBlocks(block* data, size_t LEN) 
+{
+	ReceiveBytes(data, LEN*sizeof(block));
+}
+
+void Channel::SendBits(uint8_t *data, size_t LEN) 
+{
+	SendBytes(data, LEN);
+}
+
+void Channel::ReceiveBits(uint8_t *data, size_t LEN) 
+{
+	ReceiveBytes(data, LEN);
+}
+
+void Channel::SendBits(const BitVector &A) 
+{
+	SendBytes(A.Data(), A.ByteSize());
+}
+
+void Channel::ReceiveBits(BitVector &A) 
+{
+	ReceiveBytes(A.Data(), A.ByteSize());
+	A.ClearPadding(); 
+}
+
+void Channel::SendString(char *data, size_t LEN) 
+{
+	SendBytes(data, LEN);
+}
+
+void Channel::ReceiveString(char *data, size_t LEN) 
+{
+	ReceiveBytes(data, LEN);  
+}
+
+void Channel::SendString(std::string &str) 
+{
+	SendBytes(&str[0], str.size());
+}
+
+void Channel::ReceiveString(std::string &str) 
+{
+	ReceiveBytes(&str[0], str.size()); 
+}
+
+void Channel::SendECPoints(const ECPoint* A, size_t LEN) 
+{
+	// batch serialization shares one field inversion per thread chunk
+	size_t POINT_LEN = ECPointSerializedByteLen(); 
+	std::vector<unsigned char> buffer(LEN*POINT_LEN);
+	ECPointVectorToBytes(A, LEN, buffer.data()); 
+	SendBytes(buffer.data(), buffer.size());
+	this->ReleaseSendData(); 
+}
+
+void Channel::ReceiveECPoints(ECPoint* A, size_t LEN) 
+{
+	size_t POINT_LEN = ECPointSerializedByteLen(); 
+	std::vector<unsigned char> buffer(LEN*POINT_LEN);
+	ReceiveBytes(buffer.data(), buffer.size()); 
+	BytesToECPointVector(buffer.data(), LEN, A); 
+}
+
+void Channel::SendECPoints(const RistrettoPoint* A, size_t LEN) 
+{
+	std::vector<unsigned char> buffer(LEN*RISTRETTO_POINT_BYTE_LEN);
+	RistrettoPointVectorToBytes(A, LEN, buffer.data()); 
+	SendBytes(buffer.data(), buffer.size());
+	this->ReleaseSendData(); 
+}
+
+void Channel::ReceiveECPoints(RistrettoPoint* A, size_t LEN) 
+{
+	std::vector<unsigned char> buffer(LEN*RISTRETTO_POINT_BYTE_LEN);
+	ReceiveBytes(buffer.data(), buffer.size()); 
+	BytesToRistrettoPointVector(buffer.data(), LEN, A); 
+}
+
+// an EC25519Point is its 32 bytes px, so arrays go on the wire as they are
+static_assert(sizeof(EC25519Point) == 32, "EC25519Point must be exactly px"); 
+
+void Channel::SendEC25519Points(const EC25519Point* A, size_t LEN) 
+{
+	SendBytes(A, 32*LEN);
+}
+
+void Channel::ReceiveEC25519Points(EC25519Point* A, size_t LEN) 
+{
+	ReceiveBytes(A, 32*LEN); 
+}
+
+
+
+void Channel::SendECPoint(const ECPoint &A) 
+{
+	#ifdef ECPOINT_COMPRESSED
+		unsigned char buffer[POINT_COMPRESSED_BYTE_LEN];
+		EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_COMPRESSED, buffer, POINT_COMPRESSED_BYTE_LEN, GetBNCtx());
+		SendBytes(buffer, POINT_COMPRESSED_BYTE_LEN);
+	#else
+		unsigned char buffer[POINT_BYTE_LEN];
+		EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_UNCOMPRESSED, buffer, POINT_BYTE_LEN, GetBNCtx());
+		SendBytes(buffer, POINT_BYTE_LEN);
+	#endif
+}
+
+void Channel::ReceiveECPoint(ECPoint &A) 
+{
+	#ifdef ECPOINT_COMPRESSED
+		unsigned char buffer[POINT_COMPRESSED_BYTE_LEN];
+		ReceiveBytes(buffer, POINT_COMPRESSED_BYTE_LEN); 
+		EC_POINT_oct2point(group, A.point_ptr, buffer, POINT_COMPRESSED_BYTE_LEN, GetBNCtx());
+	#else
+		unsigned char buffer[POINT_BYTE_LEN];
+		ReceiveBytes(buffer, POINT_BYTE_LEN); 
+		EC_POINT_oct2point(group, A.point_ptr, buffer, POINT_BYTE_LEN, GetBNCtx());
+	#endif
+}
+
+void Channel::SendBigInt(const BigInt &a) 
+{
+	unsigned char buffer[BN_BYTE_LEN];
+	memset(buffer, 0, BN_BYTE_LEN); 
+	BN_bn2binpad(a.bn_ptr, buffer, BN_BYTE_LEN);
+	SendBytes(buffer, BN_BYTE_LEN);	
+}
+
+void Channel::ReceiveBigInt(BigInt &a) 
+{
+	unsigned char buffer[BN_BYTE_LEN];
+	ReceiveBytes(buffer, BN_BYTE_LEN); 
+	BN_bin2bn(buffer, BN_BYTE_LEN, a.bn_ptr);         
+}
+
+void Channel::SendBigInt(const BigInt &a, size_t LEN)
+{
+	unsigned char buffer[LEN];
+	memset(buffer, 0, LEN); 
+	BN_bn2binpad(a.bn_ptr, buffer, LEN);
+	SendBytes(buffer, LEN);	
+}
+
+void Channel::ReceiveBigInt(BigInt &a, size_t LEN) 
+{
+	unsigned char buffer[LEN];
+	ReceiveBytes(buffer, LEN); 
+	BN_bin2bn(buffer, LEN, a.bn_ptr);         
+}
+// T could be any built-in data type, such as block or int
+template <typename T>
+void Channel::SendInteger(const T &n)
+{
+	SendBytes(&n, sizeof(T));
+}
+template <typename T>
+void Channel::ReceiveInteger(T &n)
+{
+	ReceiveBytes(&n, sizeof(T));
+}
+
+
+void Channel::SendBlock(const block &a) 
+{
+	SendBytes(&a, sizeof(block));
+}
+
+void Channel::ReceiveBlock(block &a) 
+{
+	ReceiveBytes(&a, sizeof(block));
+}
+
+
+// NUM = length of array; LEN = length of each item
+void Channel::SendBytesVector(const std::vector<std::vector<uint8_t>>& A) 
+{
+	size_t NUM = A.size(); 
+	size_t LEN = A[0].size(); 
+	// header and rows gathered into one send, same bytes as sending NUM, LEN and the concatenated rows
+	std::vector<ByteSpan> spans(NUM + 2); 
+	spans[0] = {&NUM, sizeof(NUM)}; 
+	spans[1] = {&LEN, sizeof(LEN)}; 
+	for(auto i = 0; i < NUM; i++) spans[i+2] = {A[i].data(), LEN}; 
+	this->CountSend(2*sizeof(size_t) + NUM*LEN); 
+	SendSpans(spans.data(), spans.size()); 
+}
+
+void Channel::ReceiveBytesVector(std::vector<std::vector<uint8_t>> &A) 
+{
+	// header and rows come as one message, counted once to match SendBytesVector
+	size_t NUM, LEN; 
+	ReceiveDataInternal(&NUM, sizeof(NUM));
+	ReceiveDataInternal(&LEN, sizeof(LEN));  
+
+	std::vector<unsigned char> buffer(LEN*NUM);
+	ReceiveDataInternal(buffer.data(), LEN*NUM);
+	this->CountReceive(2*sizeof(size_t) + NUM*LEN); 
+
+	A.resize(NUM); 
+	for(auto i = 0; i < NUM; i++) {
+		A[i] = std::vector<uint8_t>(buffer.data()+i*LEN, buffer.data()+(i+1)*LEN); 
+	}
+}
+
+// NUM = length of vector; LEN = length of each item
+void Channel::SendStringVector(const std::vector<std::string>& A, size_t LEN) 
+{
+	size_t NUM = A.size(); 
+	std::vector<ByteSpan> spans(NUM + 1); 
+	spans[0] = {&NUM, sizeof(NUM)}; 
+	for(auto i = 0; i < NUM; i++) spans[i+1] = {A[i].data(), LEN}; 
+	this->CountSend(sizeof(size_t) + NUM*LEN); 
+	SendSpans(spans.data(), spans.size()); 
+}
+
+void Channel::ReceiveStringVector(std::vector<std::string> &A, size_t LEN) 
+{
+	size_t NUM; 
+	ReceiveDataInternal(&NUM, sizeof(NUM));  
+
+	std::vector<char> buffer(LEN*NUM);
+	ReceiveDataInternal(buffer.data(), LEN*NUM);
+	this->CountReceive(sizeof(size_t) + NUM*LEN); 
+
+	A.resize(NUM); 
+	for(auto i = 0; i < NUM; i++) {
+		A[i] = std::string(buffer.data()+i*LEN, buffer.data()+(i+1)*LEN);  
+	}
+}
+
+#endif
@@ -0,0 +1,109 @@
+/****************************************************************************
+this hpp defines the communication and timing metrics a Channel collects
+traffic and time are charged to the innermost open phase only, so the phases add up to the total;
+a phase opened inside another one is named parent/child
+*****************************************************************************
+* @copyright  MIT license (see LICENSE file)
+*****************************************************************************/
+#ifndef KUNLUN_NET_IO_CHANNEL_METRICS
+#define KUNLUN_NET_IO_CHANNEL_METRICS
+
+#include "../include/std.inc"
+
+struct PhaseMetrics{
+	std::string name;
+	size_t BYTES_SENT = 0;
+	size_t BYTES_RECEIVED = 0;
+	size_t MESSAGES_SENT = 0;
+	size_t MESSAGES_RECEIVED = 0;
+	size_t ROUND_TRIPS = 0; // times this party waited for the peer right after sending
+	double WALL_MS = 0;
+	double CPU_MS = 0;      // CPU time of the whole process, all threads
+
+	void Accumulate(const PhaseMetrics &other)
+	{
+		this->BYTES_SENT += other.BYTES_SENT;
+		this->BYTES_RECEIVED += other.BYTES_RECEIVED;
+		this->MESSAGES_SENT += other.MESSAGES_SENT;
+		this->MESSAGES_RECEIVED += other.MESSAGES_RECEIVED;
+		this->ROUND_TRIPS += other.ROUND_TRIPS;
+		this->WALL_MS += other.WALL_MS;
+		this->CPU_MS += other.CPU_MS;
+	}
+
+	std::string ToJSON() const
+	{
+		std::string escaped_name;
+		for(char ch : this->name){
+			if(ch == '"' || ch == '\\') escaped_name += '\\';
+			escaped_name += ch;
+		}
+		std::ostringstream out;
+		out << "{\"name\": \"" << escaped_name << "\""
+		    << ", \"bytes_sent\": " << this->BYTES_SENT
+		    << ", \"bytes_received\": " << this->BYTES_RECEIVED
+		    << ", \"messages_sent\": " << this->MESSAGES_SENT
+		    << ", \"messages_received\": " << this->MESSAGES_RECEIVED
+		    << ", \"round_trips\": " << this->ROUND_TRIPS
+		    << ", \"wall_ms\": " << this->WALL_MS
+		    << ", \"cpu_ms\": " << this->CPU_MS << "}";
+		return out.str();
+	}
+};
+
+struct ChannelMetrics{
+	std::vector<PhaseMetrics> phases; // in order of first entry; traffic outside any phase is in phases[0]
+
+	PhaseMetrics Total() const
+	{
+		PhaseMetrics total;
+		total.name = "total";
+		for(auto &phase : this->phases) total.Accumulate(phase);
+		return total;
+	}
+
+	// the phase named name, or an empty one
+	PhaseMetrics Find(const std::string &name) const
+	{
+		for(auto &phase : this->phases){
+			if(phase.name == name) return phase;
+		}
+		PhaseMetrics empty;
+		empty.name = name;
+		return empty;
+	}
+
+	std::string ToJSON() const
+	{
+		std::string json = "{\"phases\": [";
+		for(auto i = 0; i < this->phases.size(); i++){
+			if(i > 0) json += ", ";
+			json += this->phases[i].ToJSON();
+		}
+		json += "], \"total\": " + this->Total().ToJSON() + "}";
+		return json;
+	}
+
+	void Print() const
+	{
+		std::cout << std::left << std::setw(56) << "phase" << std::right
+		          << std::setw(12) << "sent (MB)" << std::setw(12) << "recv (MB)"
+		          << std::setw(8) << "msgs" << std::setw(8) << "rounds"
+		          << std::setw(12) << "wall (ms)" << std::setw(12) << "cpu (ms)" << std::endl;
+		auto print_row = [](const PhaseMetrics &phase){
+			std::cout << std::left << std::setw(56) << phase.name << std::right << std::fixed << std::setprecision(3)
+			          << std::setw(12) << double(phase.BYTES_SENT)/(1024*1024)
+			          << std::setw(12) << double(phase.BYTES_RECEIVED)/(1024*1024)
+			          << std::setw(8) << phase.MESSAGES_SENT + phase.MESSAGES_RECEIVED
+			          << std::setw(8) << phase.ROUND_TRIPS << std::setprecision(1)
+			          << std::setw(12) << phase.WALL_MS << std::setw(12) << phase.CPU_MS
+			          << std::defaultfloat << std::endl;
+		};
+		for(auto &phase : this->phases){
+			if(phase.MESSAGES_SENT + phase.MESSAGES_RECEIVED > 0) print_row(phase);
+		}
+		print_row(this->Total());
+	}
+};
+
+#endif
@@ -0,0 +1,181 @@
+/****************************************************************************
+this hpp implements a channel that emulates a slower, longer link on top of another channel, in user space
+(no root, no tc): the sending side paces the bytes at the link bandwidth and a delivery thread releases
+every slice to the wrapped channel one-way latency (plus jitter) after it has left the emulated link
+the wire format is unchanged; wrap both parties to shape both directions
+the traffic is charged to the metrics of this channel only: the slices go through the transport of the wrapped
+channel without being counted again there
+*****************************************************************************
+* @copyright  MIT license (see LICENSE file)
+*****************************************************************************/
+#ifndef KUNLUN_NET_IO_EMULATED_CHANNEL
+#define KUNLUN_NET_IO_EMULATED_CHANNEL
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <random>
+#include "channel.hpp"
+
+struct LinkProfile{
+	std::string name;
+	double BANDWIDTH_MBPS; // megabits per second, each direction
+	double RTT_MS;         // round-trip time: half of it is added to each direction
+	double JITTER_MS;      // extra one-way delay, uniform in [0, JITTER_MS]; bytes are never reordered
+};
+
+inline const LinkProfile LINK_LAN = {"lan", 10000, 0.2, 0};
+inline const LinkProfile LINK_METRO = {"metro", 1000, 50, 2};
+inline const LinkProfile LINK_WAN = {"wan", 100, 200, 10};
+
+// pacing granularity: a slice leaves the emulated link as a whole (the depth of the token bucket)
+inline const size_t EMULATED_SLICE_LEN = 1024*64;
+// bytes on the emulated link before a send blocks, at least two bandwidth-delay products (a well-tuned TCP window)
+inline const size_t EMULATED_MIN_QUEUE_LEN = 1024*1024*4;
+
+class EmulatedChannel : public Channel{
+public:
+	EmulatedChannel(Channel &io, const LinkProfile &profile);
+	~EmulatedChannel();
+
+	EmulatedChannel(const EmulatedChannel&) = delete;
+	EmulatedChannel& operator=(const EmulatedChannel&) = delete;
+
+	void SendSpans(const ByteSpan *spans, size_t NUM) override;
+	void ReceiveDataInternal(const void *data, size_t LEN) override;
+
+	// wait until every byte sent so far has been released to the wrapped channel
+	void Flush() override;
+
+private:
+	typedef std::chrono::steady_clock Clock;
+	struct Slice{
+		Clock::time_point release;
+		std::vector<unsigned char> data;
+	};
+
+	Channel &io;
+	bool io_auto_flush;  // the setting of io before this wrapper, restored on destruction
+	LinkProfile profile;
+	size_t QUEUE_LEN;
+
+	std::deque<Slice> queue;
+	size_t QUEUED_LEN = 0;
+	std::mutex queue_mutex;
+	std::condition_variable queue_cv;
+	bool stop = false;
+	std::thread deliverer;
+
+	Clock::time_point link_free;    // when the emulated link has sent everything queued so far
+	Clock::time_point last_release;
+	std::mt19937_64 jitter_prg;
+
+	void Enqueue(std::vector<unsigned char> &&slice);
+	void DeliverLoop();
+};
+
+EmulatedChannel::EmulatedChannel(Channel &io, const LinkProfile &profile) : io(io), profile(profile)
+{
+	if(!(profile.BANDWIDTH_MBPS > 0) || profile.RTT_MS < 0 || profile.JITTER_MS < 0){
+		std::cerr << "error: link profile " << profile.name << " needs a positive bandwidth and non-negative RTT and jitter" << std::endl;
+		exit(EXIT_FAILURE);
+	}
+	double BDP = profile.BANDWIDTH_MBPS * 1e6 / 8 * profile.RTT_MS / 1000;
+	this->QUEUE_LEN = std::max(EMULATED_MIN_QUEUE_LEN, size_t(2 * BDP));
+	this->link_free = this->last_release = Clock::now();
+	this->jitter_prg.seed(std::random_device{}());
+
+	// the delivery thread sends while the caller receives
+	this->io_auto_flush = this->io.GetAutoFlush();
+	this->io.SetAutoFlush(true);
+	this->deliverer = std::thread(&EmulatedChannel::DeliverLoop, this);
+}
+
+EmulatedChannel::~EmulatedChannel()
+{
+	this->Flush();
+	{
+		std::lock_guard<std::mutex> lock(this->queue_mutex);
+		this->stop = true;
+	}
+	this->queue_cv.notify_all();
+	this->deliverer.join();
+	this->io.SetAutoFlush(this->io_auto_flush);
+}
+
+void EmulatedChannel::Enqueue(std::vector<unsigned char> &&slice)
+{
+	std::unique_lock<std::mutex> lock(this->queue_mutex);
+	this->queue_cv.wait(lock, [&]{ return this->QUEUED_LEN + slice.size() <= this->QUEUE_LEN; });
+
+	// the slice leaves the link once the link is free and has pushed its bits, then travels one way
+	auto now = Clock::now();
+	auto transmit_time = std::chrono::duration<double>(slice.size() * 8 / (this->profile.BANDWIDTH_MBPS * 1e6));
+	double delay_ms = this->profile.RTT_MS / 2;
+	if(this->profile.JITTER_MS > 0) delay_ms += std::uniform_real_distribution<double>(0, this->profile.JITTER_MS)(this->jitter_prg);
+	this->link_free = std::max(now, this->link_free) + std::chrono::duration_cast<Clock::duration>(transmit_time);
+	auto release = this->link_free + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(delay_ms));
+	this->last_release = std::max(this->last_release, release);
+
+	this->QUEUED_LEN += slice.size();
+	this->queue.push_back({this->last_release, std::move(slice)});
+	this->queue_cv.notify_all();
+}
+
+void EmulatedChannel::DeliverLoop()
+{
+	std::unique_lock<std::mutex> lock(this->queue_mutex);
+	while(true){
+		this->queue_cv.wait(lock, [this]{ return this->stop || !this->queue.empty(); });
+		if(this->queue.empty()) return;
+
+		// releases are in order, so the front is always the next one due
+		Slice &slice = this->queue.front();
+		lock.unlock();
+		std::this_thread::sleep_until(slice.release);
+		ByteSpan span = {slice.data.data(), slice.data.size()};
+		this->io.SendSpans(&span, 1);
+		lock.lock();
+
+		this->QUEUED_LEN -= slice.data.size();
+		this->queue.pop_front();
+		this->queue_cv.notify_all();
+	}
+}
+
+void EmulatedChannel::SendSpans(const ByteSpan *spans, size_t NUM)
+{
+	std::vector<unsigned char> slice;
+	slice.reserve(EMULATED_SLICE_LEN);
+	for(auto i = 0; i < NUM; i++){
+		const unsigned char *data = (const unsigned char*)spans[i].data;
+		size_t LEN = spans[i].LEN;
+		while(LEN > 0){
+			size_t COPY_LEN = std::min(LEN, EMULATED_SLICE_LEN - slice.size());
+			slice.insert(slice.end(), data, data + COPY_LEN);
+			data += COPY_LEN;
+			LEN -= COPY_LEN;
+			if(slice.size() == EMULATED_SLICE_LEN){
+				this->Enqueue(std::move(slice));
+				slice = std::vector<unsigned char>();
+				slice.reserve(EMULATED_SLICE_LEN);
+			}
+		}
+	}
+	if(slice.size() > 0) this->Enqueue(std::move(slice));
+}
+
+void EmulatedChannel::ReceiveDataInternal(const void *data, size_t LEN)
+{
+	// what we sent is already on its way: the delivery thread does not need the caller
+	this->io.ReceiveDataInternal(data, LEN);
+}
+
+void EmulatedChannel::Flush()
+{
+	std::unique_lock<std::mutex> lock(this->queue_mutex);
+	this->queue_cv.wait(lock, [this]{ return this->queue.empty(); });
+}
+
+#endif
@@ -0,0 +1,102 @@
+/****************************************************************************
+this hpp implements an in-memory channel for running both parties as threads of one process,
+so that benchmarks measure the protocols without the kernel TCP stack
+each direction is a queue of messages: a send copies its spans into one message and never blocks,
+a receive waits until enough bytes are queued
+*****************************************************************************
+* @copyright  MIT license (see LICENSE file)
+*****************************************************************************/
+#ifndef KUNLUN_NET_IO_LOOPBACK_CHANNEL
+#define KUNLUN_NET_IO_LOOPBACK_CHANNEL
+
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include "channel.hpp"
+
+// one direction of a loopback pair
+struct LoopbackPipe{
+	std::mutex pipe_mutex;
+	std::condition_variable pipe_cv;
+	std::deque<std::vector<unsigned char>> messages;
+	size_t FRONT_BEGIN = 0; // bytes of messages.front() already received
+};
+
+class LoopbackChannel : public Channel{
+public:
+	LoopbackChannel() = default;
+
+	LoopbackChannel(const LoopbackChannel&) = delete;
+	LoopbackChannel& operator=(const LoopbackChannel&) = delete;
+
+	void SendSpans(const ByteSpan *spans, size_t NUM) override;
+	void ReceiveDataInternal(const void *data, size_t LEN) override;
+
+	friend void ConnectLoopback(LoopbackChannel &A, LoopbackChannel &B);
+
+private:
+	std::shared_ptr<LoopbackPipe> out;
+	std::shared_ptr<LoopbackPipe> in;
+};
+
+// what A sends arrives at B, and vice versa
+void ConnectLoopback(LoopbackChannel &A, LoopbackChannel &B)
+{
+	A.out = B.in = std::make_shared<LoopbackPipe>();
+	B.out = A.in = std::make_shared<LoopbackPipe>();
+}
+
+void LoopbackChannel::SendSpans(const ByteSpan *spans, size_t NUM)
+{
+	if(this->out == nullptr){
+		std::cerr << "error: loopback channel is not connected" << std::endl;
+		exit(EXIT_FAILURE);
+	}
+	size_t TOTAL_LEN = 0;
+	for(auto i = 0; i < NUM; i++) TOTAL_LEN += spans[i].LEN;
+	if(TOTAL_LEN == 0) return;
+
+	// copy outside the lock
+	std::vector<unsigned char> message(TOTAL_LEN);
+	size_t OFFSET = 0;
+	for(auto i = 0; i < NUM; i++){
+		memcpy(message.data() + OFFSET, spans[i].data, spans[i].LEN);
+		OFFSET += spans[i].LEN;
+	}
+	{
+		std::lock_guard<std::mutex> lock(this->out->pipe_mutex);
+		this->out->messages.emplace_back(std::move(message));
+	}
+	this->out->pipe_cv.notify_one();
+}
+
+void LoopbackChannel::ReceiveDataInternal(const void *data, size_t LEN)
+{
+	if(this->in == nullptr){
+		std::cerr << "error: loopback channel is not connected" << std::endl;
+		exit(EXIT_FAILURE);
+	}
+	char *output = (char*)data;
+	size_t HAVE_RECEIVE_LEN = 0;
+	std::unique_lock<std::mutex> lock(this->in->pipe_mutex);
+	while(HAVE_RECEIVE_LEN < LEN){
+		this->in->pipe_cv.wait(lock, [this]{ return !this->in->messages.empty(); });
+
+		// only the receiver touches the front message, and push_back keeps it in place: copy it unlocked
+		std::vector<unsigned char> &front = this->in->messages.front();
+		size_t COPY_LEN = std::min(LEN - HAVE_RECEIVE_LEN, front.size() - this->in->FRONT_BEGIN);
+		lock.unlock();
+		memcpy(output + HAVE_RECEIVE_LEN, front.data() + this->in->FRONT_BEGIN, COPY_LEN);
+		lock.lock();
+
+		HAVE_RECEIVE_LEN += COPY_LEN;
+		this->in->FRONT_BEGIN += COPY_LEN;
+		if(this->in->FRONT_BEGIN == front.size()){
+			this->in->messages.pop_front();
+			this->in->FRONT_BEGIN = 0;
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,283 @@
+/****************************************************************************
+this hpp implements a channel between two processes on one host over POSIX shared memory
+the segment holds one single-producer single-consumer ring buffer per direction: head and tail are
+free-running byte counters, so neither side takes a lock; a blocked side yields for a while, then sleeps in short steps
+the server creates the segment and removes its name as soon as the client has attached, like accept() on a socket;
+a blocked side fails once the peer has closed its channel or its process is gone
+*****************************************************************************
+* @copyright  MIT license (see LICENSE file)
+*****************************************************************************/
+#ifndef KUNLUN_NET_IO_SHM_CHANNEL
+#define KUNLUN_NET_IO_SHM_CHANNEL
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <atomic>
+#include <thread>
+#include "channel.hpp"
+
+inline const size_t SHM_RING_LEN = 1024*1024*16;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared memory rings need lock-free 64-bit atomics");
+
+struct ShmRing{
+	alignas(64) std::atomic<uint64_t> head; // bytes written by the producer
+	alignas(64) std::atomic<uint64_t> tail; // bytes read by the consumer
+};
+
+static_assert(std::atomic<int32_t>::is_always_lock_free, "shared memory headers need lock-free 32-bit atomics");
+
+struct ShmHeader{
+	std::atomic<uint32_t> state;     // 0: being set up; 1: ready; 2: the client has attached
+	uint64_t RING_LEN;
+	std::atomic<int32_t> pid[2];     // pid[0]: server process; pid[1]: client process
+	std::atomic<uint32_t> closed[2]; // set by each side when its channel is destroyed
+	ShmRing ring[2];                 // ring[0]: server ===> client; ring[1]: client ===> server
+};
+
+// spin on yield first (the peer is usually about to move), then back off to sleeping; returns true once sleeping
+inline bool ShmBackoff(size_t &round)
+{
+	if(round < 1024){
+		round++;
+		std::this_thread::yield();
+		return false;
+	}
+	std::this_thread::sleep_for(std::chrono::microseconds(50));
+	return true;
+}
+
+// EPERM means the process exists but belongs to another user
+inline bool ShmProcessAlive(int32_t pid)
+{
+	return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+}
+
+class ShmChannel : public Channel{
+public:
+	// party is "server" or "client"; name is the segment name, e.g. "/kunlun_psi"
+	ShmChannel(std::string party, std::string name, size_t RING_LEN = SHM_RING_LEN);
+	~ShmChannel();
+
+	ShmChannel(const ShmChannel&) = delete;
+	ShmChannel& operator=(const ShmChannel&) = delete;
+
+	void SendSpans(const ByteSpan *spans, size_t NUM) override;
+	void ReceiveDataInternal(const void *data, size_t LEN) override;
+
+private:
+	bool IS_SERVER;
+	int side;           // 0: server; 1: client, the index into pid[] and closed[] of the header
+	std::string name;
+	ShmHeader *header;
+	void *segment = MAP_FAILED;
+	size_t SEGMENT_LEN = 0;
+	uint64_t RING_LEN = 0;
+
+	ShmRing *out_ring;
+	ShmRing *in_ring;
+	unsigned char *out_data;
+	unsigned char *in_data;
+
+	void Write(const unsigned char *data, size_t LEN);
+	// exits if the peer has closed its channel or its process is gone
+	void CheckPeer() const;
+	// true if name still refers to the segment with inode INODE
+	bool IsCurrentSegment(ino_t INODE) const;
+};
+
+ShmChannel::ShmChannel(std::string party, std::string name, size_t RING_LEN)
+{
+	if(party != "server" && party != "client"){
+		std::cerr << "error: party should be either server or client" << std::endl;
+		exit(EXIT_FAILURE);
+	}
+	this->IS_SERVER = (party == "server");
+	this->side = this->IS_SERVER ? 0 : 1;
+	this->name = (name.size() > 0 && name[0] == '/') ? name : "/" + name;
+
+	int fd;
+	if(this->IS_SERVER){
+		shm_unlink(this->name.c_str()); // left over by a crashed run
+		fd = shm_open(this->name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+		if(fd < 0){
+			perror("error: fail to create the shared memory segment");
+			exit(EXIT_FAILURE);
+		}
+		this->SEGMENT_LEN = sizeof(ShmHeader) + 2*RING_LEN;
+		if(ftruncate(fd, this->SEGMENT_LEN) != 0){
+			perror("error: fail to size the shared memory segment");
+			exit(EXIT_FAILURE);
+		}
+		this->segment = mmap(nullptr, this->SEGMENT_LEN, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		close(fd);
+		if(this->segment == MAP_FAILED){
+			perror("error: fail to map the shared memory segment");
+			exit(EXIT_FAILURE);
+		}
+
+		// the segment starts zeroed, which is a valid state for every counter
+		this->header = (ShmHeader*)this->segment;
+		this->header->RING_LEN = RING_LEN;
+		this->header->pid[0].store(getpid(), std::memory_order_relaxed);
+		this->header->state.store(1, std::memory_order_release);
+		ProtocolLog() << "waiting for the client to attach to " << this->name << std::endl;
+		while(this->header->state.load(std::memory_order_acquire) != 2){
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		shm_unlink(this->name.c_str());
+	}
+	else{
+		/*
+		** the server may not have created or sized the segment yet, and the name may still refer to the segment 
+		** of a crashed run, whose header can read "ready": attach only to a segment whose server process is alive, 
+		** and give up a segment once the name no longer refers to it (the new server has replaced it)
+		*/
+		while(true){
+			fd = shm_open(this->name.c_str(), O_RDWR, 0);
+			if(fd < 0){
+				if(errno != ENOENT){
+					perror("error: fail to open the shared memory segment");
+					exit(EXIT_FAILURE);
+				}
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+				continue;
+			}
+			struct stat info;
+			if(fstat(fd, &info) != 0 || info.st_size <= sizeof(ShmHeader)){
+				close(fd);
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+				continue;
+			}
+			this->SEGMENT_LEN = info.st_size;
+			this->segment = mmap(nullptr, this->SEGMENT_LEN, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			close(fd);
+			if(this->segment == MAP_FAILED){
+				perror("error: fail to map the shared memory segment");
+				exit(EXIT_FAILURE);
+			}
+			this->header = (ShmHeader*)this->segment;
+
+			bool attached = false;
+			while(true){
+				uint32_t state = 1;
+				if(ShmProcessAlive(this->header->pid[0].load(std::memory_order_relaxed))){
+					this->header->pid[1].store(getpid(), std::memory_order_relaxed);
+					attached = this->header->state.compare_exchange_strong(state, 2, std::memory_order_acq_rel);
+					if(attached) break;
+				}
+				if(!this->IsCurrentSegment(info.st_ino)) break;
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+			if(attached) break;
+			munmap(this->segment, this->SEGMENT_LEN);
+			this->segment = MAP_FAILED;
+		}
+	}
+	unsigned char *ring_data = (unsigned char*)this->segment + sizeof(ShmHeader);
+	this->RING_LEN = this->header->RING_LEN;
+	// RING_LEN comes from the segment: both rings must lie inside what was mapped
+	if(this->RING_LEN == 0 || this->RING_LEN > (this->SEGMENT_LEN - sizeof(ShmHeader))/2){
+		std::cerr << "error: shared memory segment " << this->name << " does not hold two rings of " << this->RING_LEN << " bytes" << std::endl;
+		exit(EXIT_FAILURE);
+	}
+
+	this->out_ring = &this->header->ring[this->side];
+	this->in_ring = &this->header->ring[1-this->side];
+	this->out_data = ring_data + this->side*this->RING_LEN;
+	this->in_data = ring_data + (1-this->side)*this->RING_LEN;
+	ProtocolLog() << party << " attaches to " << this->name << std::endl;
+}
+
+ShmChannel::~ShmChannel()
+{
+	if(this->segment == MAP_FAILED) return;
+	this->header->closed[this->side].store(1, std::memory_order_release);
+	munmap(this->segment, this->SEGMENT_LEN);
+}
+
+bool ShmChannel::IsCurrentSegment(ino_t INODE) const
+{
+	int fd = shm_open(this->name.c_str(), O_RDONLY, 0);
+	if(fd < 0) return false;
+	struct stat info;
+	bool current = (fstat(fd, &info) == 0 && info.st_ino == INODE);
+	close(fd);
+	return current;
+}
+
+void ShmChannel::CheckPeer() const
+{
+	int peer = 1 - this->side;
+	if(this->header->closed[peer].load(std::memory_order_acquire) != 0){
+		std::cerr << "error: connection closed by the peer" << std::endl;
+		exit(EXIT_FAILURE);
+	}
+	if(!ShmProcessAlive(this->header->pid[peer].load(std::memory_order_relaxed))){
+		std::cerr << "error: the peer process has exited" << std::endl;
+		exit(EXIT_FAILURE);
+	}
+}
+
+void ShmChannel::Write(const unsigned char *data, size_t LEN)
+{
+	size_t round = 0;
+	while(LEN > 0){
+		uint64_t head = this->out_ring->head.load(std::memory_order_relaxed);
+		uint64_t tail = this->out_ring->tail.load(std::memory_order_acquire);
+		size_t FREE_LEN = this->RING_LEN - (head - tail);
+		if(FREE_LEN == 0){
+			if(ShmBackoff(round)) this->CheckPeer();
+			continue;
+		}
+		round = 0;
+
+		size_t COPY_LEN = std::min(LEN, FREE_LEN);
+		size_t OFFSET = head % this->RING_LEN;
+		size_t FIRST_LEN = std::min(COPY_LEN, this->RING_LEN - OFFSET);
+		memcpy(this->out_data + OFFSET, data, FIRST_LEN);
+		memcpy(this->out_data, data + FIRST_LEN, COPY_LEN - FIRST_LEN);
+		this->out_ring->head.store(head + COPY_LEN, std::memory_order_release);
+
+		data += COPY_LEN;
+		LEN -= COPY_LEN;
+	}
+}
+
+void ShmChannel::SendSpans(const ByteSpan *spans, size_t NUM)
+{
+	for(auto i = 0; i < NUM; i++) this->Write((const unsigned char*)spans[i].data, spans[i].LEN);
+}
+
+void ShmChannel::ReceiveDataInternal(const void *data, size_t LEN)
+{
+	unsigned char *output = (unsigned char*)data;
+	size_t round = 0;
+	while(LEN > 0){
+		uint64_t tail = this->in_ring->tail.load(std::memory_order_relaxed);
+		uint64_t head = this->in_ring->head.load(std::memory_order_acquire);
+		size_t READY_LEN = head - tail;
+		if(READY_LEN == 0){
+			// the data the peer sent before closing is still read
+			if(ShmBackoff(round)) this->CheckPeer();
+			continue;
+		}
+		round = 0;
+
+		size_t COPY_LEN = std::min(LEN, READY_LEN);
+		size_t OFFSET = tail % this->RING_LEN;
+		size_t FIRST_LEN = std::min(COPY_LEN, this->RING_LEN - OFFSET);
+		memcpy(output, this->in_data + OFFSET, FIRST_LEN);
+		memcpy(output + FIRST_LEN, this->in_data, COPY_LEN - FIRST_LEN);
+		this->in_ring->tail.store(tail + COPY_LEN, std::memory_order_release);
+
+		output += COPY_LEN;
+		LEN -= COPY_LEN;
+	}
+}
+
+#endif
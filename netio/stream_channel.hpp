@@ -12,78 +12,82 @@
 #include <netinet/tcp.h>
 #include <netinet/in.h>
 #include <sys/socket.h> // Include this header file for using socket feature
+#include <sys/uio.h>
+#include <poll.h>
+#include <limits.h>
+#include <errno.h>
 
-#include "../include/std.inc"
-#include "../crypto/ec_point.hpp"
-#include "../crypto/ec_25519.hpp"
+// MSG_ZEROCOPY needs Linux >= 4.14
+#if defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+	#define KUNLUN_ZEROCOPY
+	#include <linux/errqueue.h>
+#endif
+
+// macOS has no MSG_NOSIGNAL
+#ifndef MSG_NOSIGNAL
+	#define MSG_NOSIGNAL 0
+#endif
+
+#include "channel.hpp"
 
 inline const size_t NETWORK_BUFFER_SIZE = 1024*1024;
-//inline const size_t FILE_BUFFER_SIZE = 1024*16;
+// a receive at least this long goes straight into the destination, shorter ones are served from the read-ahead buffer
+inline const size_t DIRECT_RECEIVE_LEN = 1024*64;
+// with auto flush off, a send at least this long uses MSG_ZEROCOPY where the kernel supports it: the pages are pinned instead of copied
+inline const size_t ZEROCOPY_THRESHOLD = 1024*1024*16;
 
-class NetIO{ 
+class NetIO : public Channel{ 
 public:
 	bool IS_SERVER;
 	int server_master_socket = -1; 
 	int connect_socket = -1;
-	FILE *stream = nullptr; 
-	char *buffer = nullptr; 
 
 	std::string address;
 	int port;
 
 	NetIO(std::string party, std::string address, int port); 
+	~NetIO(); 
+
+	// the object owns the socket
+	NetIO(const NetIO&) = delete; 
+	NetIO& operator=(const NetIO&) = delete; 
 
 	void SetNodelay();
 	void SetDelay();
 
-	void SendDataInternal(const void *data, size_t LEN); 
-	void ReceiveDataInternal(const void *data, size_t LEN); 
-
-	void SendBytes(const void *data, size_t LEN);  
-	void ReceiveBytes(void *data, size_t LEN); 
-
-	void SendBlocks(const block* data, size_t LEN);
-	void ReceiveBlocks(block* data, size_t LEN);  
-
-	void SendBlock(const block &a);
-	void ReceiveBlock(block &a);  
-
-	void SendECPoints(const ECPoint* vec_A, size_t LEN); 
-	void ReceiveECPoints(ECPoint* vec_A, size_t LEN); 
-
-	// specialization for ECPOints on curve 25519
-	void SendEC25519Points(const EC25519Point* vec_A, size_t LEN); 
-	void ReceiveEC25519Points(EC25519Point* vec_A, size_t LEN); 
-
-	void SendECPoint(const ECPoint &A);
-	void ReceiveECPoint(ECPoint &A);
-
-	void SendBigInt(const BigInt &a);
-	void ReceiveBigInt(BigInt &a);
-
-	void SendBigInt(const BigInt &a, size_t LEN);
-	void ReceiveBigInt(BigInt &a, size_t LEN);
-
-	void SendBits(uint8_t *data, size_t LEN);
-	void ReceiveBits(uint8_t *data, size_t LEN); 
+	/*
+	** with auto flush on (the default) every send is on the wire when it returns
+	** with auto flush off, sends shorter than the buffer are coalesced until Flush(), the next receive
+	** (the peer may be waiting for them) or a full buffer; sends of ZEROCOPY_THRESHOLD or more go out zero-copy,
+	** and their data must stay unchanged until Flush() or the next receive returns
+	*/
+	void SetAutoFlush(bool flag) override; 
+	bool GetAutoFlush() const override { return this->auto_flush; } 
+	void Flush() override; 
+	void ReleaseSendData() override; 
+	// sends handed to the kernel with MSG_ZEROCOPY so far, 0 where the kernel does not support it
+	uint32_t ZeroCopySends() const { return this->zerocopy_issued; } 
 
-	void SendString(char *data, size_t LEN);
-	void ReceiveString(char *data, size_t LEN); 
+	// gather NUM spans into one sendmsg, without copying them into a contiguous buffer
+	void SendSpans(const ByteSpan *spans, size_t NUM) override; 
 
-	void SendString(std::string &str);
-	void ReceiveString(std::string &str); 
+	void ReceiveDataInternal(const void *data, size_t LEN) override; 
 
-	template <typename T>
-	void SendInteger(const T &n);
+private:
+	bool auto_flush = true; 
+	std::vector<unsigned char> send_buffer; 
+	size_t SEND_BUFFER_LEN = 0; 
 
-	template <typename T>
-	void ReceiveInteger(T &n);
+	std::vector<unsigned char> receive_buffer; 
+	size_t RECEIVE_BUFFER_BEGIN = 0; 
+	size_t RECEIVE_BUFFER_END = 0; 
 
-	void SendBytesVector(const std::vector<std::vector<uint8_t>> &A); 
-	void ReceiveBytesVector(std::vector<std::vector<uint8_t>> &A); 
+	bool zerocopy = false; 
+	uint32_t zerocopy_issued = 0; 
+	uint32_t zerocopy_completed = 0; 
 
-	void SendStringVector(const std::vector<std::string>& A, size_t LEN); 
-	void ReceiveStringVector(std::vector<std::string> &A, size_t LEN); 
+	void SendIOVectors(struct iovec *iov, size_t NUM, bool use_zerocopy); 
+	void WaitZeroCopy(); 
 };
 
 NetIO::NetIO(std::string party, std::string address, int port)
@@ -128,7 +132,7 @@ NetIO::NetIO(std::string party, std::string address, int port)
 			exit(EXIT_FAILURE);
 		}
 		else{
-			std::cout << "server is listening connection request from client >>>" << std::endl;
+			ProtocolLog() << "server is listening connection request from client >>>" << std::endl;
 		}	
 		// accept request from the client
 		struct sockaddr_in client_address; // structure that holds ip and port
@@ -161,17 +165,26 @@ NetIO::NetIO(std::string party, std::string address, int port)
 			exit(EXIT_FAILURE);	
 		}
 		else{
-			std::cout << "client connects to server successfully >>>" << std::endl;
+			ProtocolLog() << "client connects to server successfully >>>" << std::endl;
 		}
 	}
 	
 	SetNodelay(); 
 
-	// very impprotant: bind the socket to a file stream
-	stream = fdopen(this->connect_socket, "wb+"); 
-	buffer = new char[NETWORK_BUFFER_SIZE];
-	memset(buffer, 0, NETWORK_BUFFER_SIZE);
-	setvbuf(stream, buffer, _IOFBF, NETWORK_BUFFER_SIZE); // Specifies a buffer for stream
+	this->send_buffer.resize(NETWORK_BUFFER_SIZE); 
+	this->receive_buffer.resize(NETWORK_BUFFER_SIZE); 
+
+	#ifdef KUNLUN_ZEROCOPY
+		const int one = 1;
+		this->zerocopy = (setsockopt(this->connect_socket, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) == 0); 
+	#endif
+}
+
+NetIO::~NetIO()
+{
+	this->Flush(); 
+	if(this->connect_socket >= 0) close(this->connect_socket); 
+	if(this->server_master_socket >= 0) close(this->server_master_socket); 
 }
 
 
@@ -189,305 +202,192 @@ void NetIO::SetDelay()
 
 /*
 ** first define basic send/receive functions
-** if we directly use the send/receive socket function
-** the buffer will be overflowed when the data is massive
-** it is important to buffer the data to the stream, which is binded with the socket
-** the underlying mechanism will thus do the slice automatically to ensure the server/client will not crash
+** sends go through sendmsg on the socket: large data is never copied into an intermediate buffer,
+** and small messages are only buffered when auto flush is off
+** receives shorter than DIRECT_RECEIVE_LEN read ahead into receive_buffer, so a run of small receives costs one recv
 ** then implement functions send/receiver bytes and more advanced types of data 
 */
 
-// the very basic send function 
-void NetIO::SendDataInternal(const void *data, size_t LEN)
-{
-	size_t HAVE_SENT_LEN = 0; 
-	// continue write data to stream until all reach the desired LEN
-	while(HAVE_SENT_LEN < LEN) {
-		size_t SENT_LEN = fwrite((char*)data+HAVE_SENT_LEN, 1, LEN-HAVE_SENT_LEN, stream);
-		if (SENT_LEN >= 0) HAVE_SENT_LEN+=SENT_LEN;
-		else fprintf(stderr, "error: fail to send data %zu\n", SENT_LEN);
-	}
-	/* 
-	** very important: 
-	** if stream is not explicitly flushed, the data will not be sent
-	*/
-	fflush(stream); 
-}
-
-// the very basic receive function
-void NetIO::ReceiveDataInternal(const void *data, size_t LEN)
-{
-	size_t HAVE_RECEIVE_LEN = 0;
-	// continue receive data to stream until all reach the desired LEN
-	while(HAVE_RECEIVE_LEN < LEN) {
-		size_t RECEIVE_LEN = fread((char*)data+HAVE_RECEIVE_LEN, 1, LEN-HAVE_RECEIVE_LEN, stream);
-		if (RECEIVE_LEN >= 0) HAVE_RECEIVE_LEN+=RECEIVE_LEN;
-		else fprintf(stderr, "error: fail to receive data %zu\n", RECEIVE_LEN);
-	}
-}
-
-
-void NetIO::SendBytes(const void* data, size_t LEN) 
-{
-	SendDataInternal(data, LEN); 
-}
-
-void NetIO::ReceiveBytes(void* data, size_t LEN) 
-{
-	ReceiveDataInternal(data, LEN); 
-}
-
-void NetIO::SendBlocks(const block* data, size_t LEN) 
-{
-	SendBytes(data, LEN*sizeof(block));
-}
-
-void NetIO::ReceiveBlocks(block* data, size_t LEN) 
-{
-	ReceiveBytes(data, LEN*sizeof(block));
-}
-
-void NetIO::SendBits(uint8_t *data, size_t LEN) 
-{
-	SendBytes(data, LEN);
-}
-
-void NetIO::ReceiveBits(uint8_t *data, size_t LEN) 
-{
-	ReceiveBytes(data, LEN);
-}
-
-void NetIO::SendString(char *data, size_t LEN) 
-{
-	SendBytes(data, LEN);
-}
-
-void NetIO::ReceiveString(char *data, size_t LEN) 
-{
-	ReceiveBytes(data, LEN);  
-}
-
-void NetIO::SendString(std::string &str) 
-{
-	SendBytes(&str[0], str.size());
-}
-
-void NetIO::ReceiveString(std::string &str) 
-{
-	ReceiveBytes(&str[0], str.size()); 
-}
-
-void NetIO::SendECPoints(const ECPoint* A, size_t LEN) 
-{
-	int thread_num = omp_get_thread_num();
-	#ifdef ECPOINT_COMPRESSED
-		unsigned char* buffer = new unsigned char[LEN*POINT_COMPRESSED_BYTE_LEN];
-		for(auto i = 0; i < LEN; i++) {
-    		EC_POINT_point2oct(group, A[i].point_ptr, POINT_CONVERSION_COMPRESSED, 
-				               buffer + i*POINT_COMPRESSED_BYTE_LEN, POINT_COMPRESSED_BYTE_LEN, bn_ctx[thread_num]);
-    	}
-		SendBytes(buffer, LEN*POINT_COMPRESSED_BYTE_LEN);
-	#else
-		unsigned char* buffer = new unsigned char[LEN*POINT_BYTE_LEN];
-		for(auto i = 0; i < LEN; i++) {
-    		EC_POINT_point2oct(group, A[i].point_ptr, POINT_CONVERSION_UNCOMPRESSED, 
-				               buffer + i*POINT_BYTE_LEN, POINT_BYTE_LEN, bn_ctx[thread_num]);
-    	}
-		SendBytes(buffer, LEN*POINT_BYTE_LEN);
-	#endif
-	
-	delete[] buffer; 
-}
+// sendmsg until every byte of the iovecs is out; the iovecs are consumed
+void NetIO::SendIOVectors(struct iovec *iov, size_t NUM, bool use_zerocopy)
+{
+	while(NUM > 0 && iov->iov_len == 0) { iov++; NUM--; }
+	while(NUM > 0){
+		struct msghdr msg; 
+		memset(&msg, 0, sizeof(msg)); 
+		msg.msg_iov = iov; 
+		msg.msg_iovlen = std::min<size_t>(NUM, IOV_MAX); 
+		// a closed peer shows up as an error, not as SIGPIPE
+		int flags = MSG_NOSIGNAL; 
+		#ifdef KUNLUN_ZEROCOPY
+			if(use_zerocopy) flags |= MSG_ZEROCOPY; 
+		#endif
+		ssize_t SENT_LEN = sendmsg(this->connect_socket, &msg, flags); 
+		if(SENT_LEN < 0){
+			if(errno == EINTR) continue; 
+			// out of pinned-page budget: copy as usual
+			if(use_zerocopy && errno == ENOBUFS){
+				use_zerocopy = false; 
+				continue; 
+			}
+			perror("error: fail to send data"); 
+			exit(EXIT_FAILURE); 
+		}
+		if(use_zerocopy) this->zerocopy_issued++; 
 
-void NetIO::ReceiveECPoints(ECPoint* A, size_t LEN) 
-{
-	int thread_num = omp_get_thread_num();
-	#ifdef ECPOINT_COMPRESSED
-		unsigned char* buffer = new unsigned char[LEN*POINT_COMPRESSED_BYTE_LEN];
-		ReceiveBytes(buffer, LEN*POINT_COMPRESSED_BYTE_LEN); 
-		for(auto i = 0; i < LEN; i++) {
-			EC_POINT_oct2point(group, A[i].point_ptr, buffer+i*POINT_COMPRESSED_BYTE_LEN, 
-			                   POINT_COMPRESSED_BYTE_LEN, bn_ctx[thread_num]);
+		while(NUM > 0 && size_t(SENT_LEN) >= iov->iov_len){
+			SENT_LEN -= iov->iov_len; 
+			iov++; 
+			NUM--; 
 		}
-	#else
-		unsigned char* buffer = new unsigned char[LEN*POINT_BYTE_LEN];
-		ReceiveBytes(buffer, LEN*POINT_BYTE_LEN); 
-		for(auto i = 0; i < LEN; i++) {
-			EC_POINT_oct2point(group, A[i].point_ptr, buffer+i*POINT_BYTE_LEN, POINT_BYTE_LEN, bn_ctx[thread_num]);
+		if(NUM > 0){
+			iov->iov_base = (char*)iov->iov_base + SENT_LEN; 
+			iov->iov_len -= SENT_LEN; 
 		}
-	#endif
-
-	delete[] buffer; 
-}
-
-
-void NetIO::SendEC25519Points(const EC25519Point* A, size_t LEN) 
-{
-	unsigned char* buffer = new unsigned char[32*LEN];
-	for(auto i = 0; i < LEN; i++) {
-    	memcpy(buffer+i*32, A[i].px, 32);  
-    }
-	SendBytes(buffer, 32*LEN);
-	delete[] buffer; 
-}
-
-void NetIO::ReceiveEC25519Points(EC25519Point* A, size_t LEN) 
-{
-	unsigned char* buffer = new unsigned char[32*LEN];
-	ReceiveBytes(buffer, 32*LEN); 
-	for(auto i = 0; i < LEN; i++){
-		memcpy(A[i].px, buffer+i*32, 32);  
 	}
-	delete[] buffer; 
 }
 
-
-
-void NetIO::SendECPoint(const ECPoint &A) 
-{
-	int thread_num = omp_get_thread_num();
-	#ifdef ECPOINT_COMPRESSED
-		unsigned char buffer[POINT_COMPRESSED_BYTE_LEN];
-		EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_COMPRESSED, buffer, POINT_COMPRESSED_BYTE_LEN, bn_ctx[thread_num]);
-		SendBytes(buffer, POINT_COMPRESSED_BYTE_LEN);
-	#else
-		unsigned char buffer[POINT_BYTE_LEN];
-		EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_UNCOMPRESSED, buffer, POINT_BYTE_LEN, bn_ctx[thread_num]);
-		SendBytes(buffer, POINT_BYTE_LEN);
-	#endif
-}
-
-void NetIO::ReceiveECPoint(ECPoint &A) 
-{
-	int thread_num = omp_get_thread_num();
-	#ifdef ECPOINT_COMPRESSED
-		unsigned char buffer[POINT_COMPRESSED_BYTE_LEN];
-		ReceiveBytes(buffer, POINT_COMPRESSED_BYTE_LEN); 
-		EC_POINT_oct2point(group, A.point_ptr, buffer, POINT_COMPRESSED_BYTE_LEN, bn_ctx[thread_num]);
-	#else
-		unsigned char buffer[POINT_BYTE_LEN];
-		ReceiveBytes(buffer, POINT_BYTE_LEN); 
-		EC_POINT_oct2point(group, A.point_ptr, buffer, POINT_BYTE_LEN, bn_ctx[thread_num]);
+// collect the completion notifications of the zero-copy sends from the socket error queue
+void NetIO::WaitZeroCopy()
+{
+	#ifdef KUNLUN_ZEROCOPY
+		while(this->zerocopy_completed != this->zerocopy_issued){
+			// with no events requested, poll only wakes up on POLLERR (a non-empty error queue), POLLHUP or POLLNVAL
+			struct pollfd pfd = {this->connect_socket, 0, 0}; 
+			if(poll(&pfd, 1, -1) < 0){
+				if(errno == EINTR) continue; 
+				perror("error: fail to wait for zero-copy notifications"); 
+				exit(EXIT_FAILURE); 
+			}
+
+			char control[128]; 
+			struct msghdr msg; 
+			memset(&msg, 0, sizeof(msg)); 
+			msg.msg_control = control; 
+			msg.msg_controllen = sizeof(control); 
+			if(recvmsg(this->connect_socket, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0){
+				if(errno == EINTR) continue; 
+				if(errno != EAGAIN){
+					perror("error: fail to read zero-copy notifications"); 
+					exit(EXIT_FAILURE); 
+				}
+				// woken up with an empty error queue: the connection failed before the sends completed
+				int socket_error = 0; 
+				socklen_t SOCKET_ERROR_LEN = sizeof(socket_error); 
+				getsockopt(this->connect_socket, SOL_SOCKET, SO_ERROR, &socket_error, &SOCKET_ERROR_LEN); 
+				if(socket_error != 0) std::cerr << "error: zero-copy send failed: " << strerror(socket_error) << std::endl; 
+				else std::cerr << "error: connection closed by the peer" << std::endl; 
+				exit(EXIT_FAILURE); 
+			}
+			for(struct cmsghdr *cm = CMSG_FIRSTHDR(&msg); cm != nullptr; cm = CMSG_NXTHDR(&msg, cm)){
+				struct sock_extended_err *serr = (struct sock_extended_err*)CMSG_DATA(cm); 
+				// [ee_info, ee_data] is the range of completed sends
+				if(serr->ee_errno == 0 && serr->ee_origin == SO_EE_ORIGIN_ZEROCOPY) this->zerocopy_completed = serr->ee_data + 1; 
+			}
+		}
 	#endif
 }
 
-void NetIO::SendBigInt(const BigInt &a) 
+void NetIO::SetAutoFlush(bool flag)
 {
-	unsigned char buffer[BN_BYTE_LEN];
-	memset(buffer, 0, BN_BYTE_LEN); 
-	BN_bn2binpad(a.bn_ptr, buffer, BN_BYTE_LEN);
-	SendBytes(buffer, BN_BYTE_LEN);	
+	if(flag) this->Flush(); 
+	this->auto_flush = flag; 
 }
 
-void NetIO::ReceiveBigInt(BigInt &a) 
+// the zero-copy sends are collected here, so they overlap with whatever the caller did since
+void NetIO::Flush()
 {
-	unsigned char buffer[BN_BYTE_LEN];
-	ReceiveBytes(buffer, BN_BYTE_LEN); 
-	BN_bin2bn(buffer, BN_BYTE_LEN, a.bn_ptr);         
-}
-
-void NetIO::SendBigInt(const BigInt &a, size_t LEN)
-{
-	unsigned char buffer[LEN];
-	memset(buffer, 0, LEN); 
-	BN_bn2binpad(a.bn_ptr, buffer, LEN);
-	SendBytes(buffer, LEN);	
-}
-
-void NetIO::ReceiveBigInt(BigInt &a, size_t LEN) 
-{
-	unsigned char buffer[LEN];
-	ReceiveBytes(buffer, LEN); 
-	BN_bin2bn(buffer, LEN, a.bn_ptr);         
-}
-// T could be any built-in data type, such as block or int
-template <typename T>
-void NetIO::SendInteger(const T &n)
-{
-	SendBytes(&n, sizeof(T));
-}
-template <typename T>
-void NetIO::ReceiveInteger(T &n)
-{
-	ReceiveBytes(&n, sizeof(T));
-}
-
-
-void NetIO::SendBlock(const block &a) 
-{
-	SendBytes(&a, sizeof(block));
-}
-
-void NetIO::ReceiveBlock(block &a) 
-{
-	ReceiveBytes(&a, sizeof(block));
+	if(this->SEND_BUFFER_LEN > 0){
+		struct iovec iov = {this->send_buffer.data(), this->SEND_BUFFER_LEN}; 
+		this->SEND_BUFFER_LEN = 0; 
+		this->SendIOVectors(&iov, 1, false); 
+	}
+	if(this->zerocopy_issued != this->zerocopy_completed) this->WaitZeroCopy(); 
 }
 
-
-// NUM = length of array; LEN = length of each item
-void NetIO::SendBytesVector(const std::vector<std::vector<uint8_t>>& A) 
+// the buffered bytes were copied, only the zero-copy sends still read the caller's data
+void NetIO::ReleaseSendData()
 {
-	size_t NUM = A.size(); 
-	size_t LEN = A[0].size(); 
-	SendInteger(NUM);
-	SendInteger(LEN);  
-
-	unsigned char* buffer = new unsigned char[LEN*NUM];
-	for(auto i = 0; i < NUM; i++) {
-    	memcpy(buffer+i*LEN, A[i].data(), LEN); 
-    }
-	SendBytes(buffer, LEN*NUM);
-	
-	delete[] buffer; 
+	if(this->zerocopy_issued != this->zerocopy_completed) this->WaitZeroCopy(); 
 }
 
-void NetIO::ReceiveBytesVector(std::vector<std::vector<uint8_t>> &A) 
+void NetIO::SendSpans(const ByteSpan *spans, size_t NUM)
 {
-	size_t NUM, LEN; 
-	ReceiveInteger(NUM);
-	ReceiveInteger(LEN);  
+	size_t TOTAL_LEN = 0; 
+	for(auto i = 0; i < NUM; i++) TOTAL_LEN += spans[i].LEN; 
 
-	unsigned char* buffer = new unsigned char[LEN*NUM];
-	ReceiveBytes(buffer, LEN*NUM);
+	if(!this->auto_flush && this->SEND_BUFFER_LEN + TOTAL_LEN <= NETWORK_BUFFER_SIZE){
+		for(auto i = 0; i < NUM; i++){
+			memcpy(this->send_buffer.data() + this->SEND_BUFFER_LEN, spans[i].data, spans[i].LEN); 
+			this->SEND_BUFFER_LEN += spans[i].LEN; 
+		}
+		return; 
+	}
 
-	A.resize(NUM); 
-	for(auto i = 0; i < NUM; i++) {
-    	A[i] = std::vector<uint8_t>(buffer+i*LEN, buffer+(i+1)*LEN); 
-    }
-	
-	delete[] buffer; 
+	// the buffered bytes go first, then the spans straight from the caller's memory
+	// a zero-copy send returns before the kernel is done with its pages, so send_buffer is never part of it
+	bool use_zerocopy = this->zerocopy && !this->auto_flush && TOTAL_LEN >= ZEROCOPY_THRESHOLD; 
+	const size_t STACK_IOV_NUM = 8; 
+	struct iovec stack_iov[STACK_IOV_NUM]; 
+	std::vector<struct iovec> heap_iov; 
+	struct iovec *iov = stack_iov; 
+	if(NUM + 1 > STACK_IOV_NUM){
+		heap_iov.resize(NUM + 1); 
+		iov = heap_iov.data(); 
+	}
+	size_t IOV_NUM = 0; 
+	// with auto flush on the buffer stays empty and is never written, so a concurrent receive can check it safely
+	if(this->SEND_BUFFER_LEN > 0){
+		iov[IOV_NUM++] = {this->send_buffer.data(), this->SEND_BUFFER_LEN}; 
+		this->SEND_BUFFER_LEN = 0; 
+		if(use_zerocopy){
+			this->SendIOVectors(iov, 1, false); 
+			IOV_NUM = 0; 
+		}
+	}
+	for(auto i = 0; i < NUM; i++) iov[IOV_NUM++] = {const_cast<void*>(spans[i].data), spans[i].LEN}; 
+	this->SendIOVectors(iov, IOV_NUM, use_zerocopy); 
 }
 
-// NUM = length of vector; LEN = length of each item
-void NetIO::SendStringVector(const std::vector<std::string>& A, size_t LEN) 
+// the very basic receive function
+void NetIO::ReceiveDataInternal(const void *data, size_t LEN)
 {
-	size_t NUM = A.size(); 
-	SendInteger(NUM);
-
-	unsigned char* buffer = new unsigned char[LEN*NUM];
-	for(auto i = 0; i < NUM; i++) {
-    	memcpy(buffer+i*LEN, A[i].data(), LEN); 
-    }
-	SendBytes(buffer, LEN*NUM);
-	
-	delete[] buffer; 
-}
+	// the peer may be waiting for what we have buffered before it replies
+	this->Flush(); 
 
-void NetIO::ReceiveStringVector(std::vector<std::string> &A, size_t LEN) 
-{
-	size_t NUM; 
-	ReceiveInteger(NUM);  
+	char *output = (char*)data; 
+	size_t BUFFERED_LEN = std::min(LEN, this->RECEIVE_BUFFER_END - this->RECEIVE_BUFFER_BEGIN); 
+	memcpy(output, this->receive_buffer.data() + this->RECEIVE_BUFFER_BEGIN, BUFFERED_LEN); 
+	this->RECEIVE_BUFFER_BEGIN += BUFFERED_LEN; 
+	size_t HAVE_RECEIVE_LEN = BUFFERED_LEN; 
 
-	unsigned char* buffer = new unsigned char[LEN*NUM];
-	ReceiveBytes(buffer, LEN*NUM);
+	// continue receive data until all reach the desired LEN
+	while(HAVE_RECEIVE_LEN < LEN) {
+		bool direct = (LEN - HAVE_RECEIVE_LEN >= DIRECT_RECEIVE_LEN); 
+		ssize_t RECEIVE_LEN; 
+		if(direct) RECEIVE_LEN = recv(this->connect_socket, output + HAVE_RECEIVE_LEN, LEN - HAVE_RECEIVE_LEN, MSG_WAITALL); 
+		else RECEIVE_LEN = recv(this->connect_socket, this->receive_buffer.data(), NETWORK_BUFFER_SIZE, 0); 
+
+		if(RECEIVE_LEN < 0 && errno == EINTR) continue; 
+		if(RECEIVE_LEN == 0){
+			std::cerr << "error: connection closed by the peer" << std::endl; 
+			exit(EXIT_FAILURE); 
+		}
+		if(RECEIVE_LEN < 0){
+			perror("error: fail to receive data"); 
+			exit(EXIT_FAILURE); 
+		}
 
-	A.resize(NUM); 
-	for(auto i = 0; i < NUM; i++) {
-		A[i] = std::string(buffer+i*LEN, buffer+(i+1)*LEN);  
-    }
-	
-	delete[] buffer; 
+		if(direct) HAVE_RECEIVE_LEN += RECEIVE_LEN; 
+		else{
+			size_t COPY_LEN = std::min<size_t>(RECEIVE_LEN, LEN - HAVE_RECEIVE_LEN); 
+			memcpy(output + HAVE_RECEIVE_LEN, this->receive_buffer.data(), COPY_LEN); 
+			HAVE_RECEIVE_LEN += COPY_LEN; 
+			this->RECEIVE_BUFFER_BEGIN = COPY_LEN; 
+			this->RECEIVE_BUFFER_END = RECEIVE_LEN; 
+		}
+	}
 }
 
 
-
 #endif  //NETWORK_IO_CHANNEL
@@ -118,10 +118,12 @@ void BuildSaveTable(ECPoint &g, size_t RANGE_LEN, size_t TRADEOFF_NUM, std::stri
     std::vector<ECPoint> startpoint(BUILD_TASK_NUM); 
     std::vector<size_t> startindex(BUILD_TASK_NUM); 
 
+    bool g_is_generator = (g == ECPoint(generator)); // g is pp.g for exponential ElGamal, pp.h for the twisted one
+
     #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
     for (auto i = 0; i < BUILD_TASK_NUM; i++){
         startindex[i] = i * SLICED_BABYSTEP_NUM;  // generate start index
-        startpoint[i] = g * startindex[i];     // compute start point
+        startpoint[i] = GPower(g, g_is_generator, BigInt(startindex[i]));     // compute start point
     }
     
     // allocate memory
@@ -149,7 +151,7 @@ void BuildSaveTable(ECPoint &g, size_t RANGE_LEN, size_t TRADEOFF_NUM, std::stri
 
     // compute and save giantstep and anchor points for slicedrange
     giantstep.ReInitialize(); 
-    giantstep = g * BigInt(BABYSTEP_NUM); 
+    giantstep = GPower(g, g_is_generator, BigInt(BABYSTEP_NUM)); 
     giantstep = giantstep.Invert();   // set giantstep = -g^BABYSTEP_NUM
     
     ECPoint giantgiantstep = giantstep * BigInt(SLICED_GIANTSTEP_NUM);
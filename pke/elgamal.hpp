@@ -3,6 +3,7 @@
 
 #include "../crypto/ec_point.hpp"
 #include "../crypto/ec_25519.hpp"
+#include "../crypto/ec_ristretto.hpp"
 #include "../crypto/prg.hpp"
 #include "../utility/print.hpp"
 
@@ -19,18 +20,23 @@ namespace ElGamal{
 using Serialization::operator<<; 
 using Serialization::operator>>; 
 
-#ifndef ENABLE_X25519_ACCELERATION
+/* 
+ * the re-randomizable branch runs on GroupPoint: the OpenSSL curve by default, 
+ * or ristretto255 when ENABLE_RISTRETTO_GROUP is defined (which also takes precedence over x25519)
+*/
+#if defined(ENABLE_RISTRETTO_GROUP) || !defined(ENABLE_X25519_ACCELERATION)
 // define the structure of PP
 struct PP
 { 
-    ECPoint g; // random generator 
+    GroupPoint g; // random generator 
+    bool G_IS_GENERATOR = false;
 };
 
 // define the structure of ciphertext
 struct CT
 {
-    ECPoint X; // X = g^r 
-    ECPoint Y; // Y = pk^r + M  
+    GroupPoint X; // X = g^r 
+    GroupPoint Y; // Y = pk^r + M  
 };
 
 
@@ -43,6 +49,7 @@ std::ofstream &operator<<(std::ofstream &fout, const ElGamal::PP &pp)
 std::ifstream &operator>>(std::ifstream &fin, ElGamal::PP &pp)
 {
     fin >> pp.g; 
+    pp.G_IS_GENERATOR = (pp.g == GroupGenerator()); 
     return fin;
 }
 
@@ -83,7 +90,8 @@ PP Setup()
 { 
     PP pp; 
   
-    pp.g = ECPoint(generator); 
+    pp.g = GroupGenerator(); 
+    pp.G_IS_GENERATOR = true; 
 
     #ifdef PRINT
         std::cout << "generate the public parameters for ElGamal >>>" << std::endl; 
@@ -95,10 +103,10 @@ PP Setup()
 
 
 /* KeyGen algorithm */ 
-std::tuple<ECPoint, BigInt> KeyGen(const PP &pp)
+std::tuple<GroupPoint, BigInt> KeyGen(const PP &pp)
 { 
-    BigInt sk = GenRandomBigIntLessThan(order); // sk \sample Z_p
-    ECPoint pk = pp.g * sk; // pk = g^sk  
+    BigInt sk = GenRandomBigIntLessThan(GroupOrder()); // sk \sample Z_p
+    GroupPoint pk = GPower(pp.g, pp.G_IS_GENERATOR, sk); // pk = g^sk  
 
     #ifdef PRINT
         std::cout << "key generation finished >>>" << std::endl;  
@@ -111,14 +119,14 @@ std::tuple<ECPoint, BigInt> KeyGen(const PP &pp)
 
 
 /* Encryption algorithm: compute CT = Enc(pk, m; r) */ 
-CT Enc(const PP &pp, const ECPoint &pk, const ECPoint &m)
+CT Enc(const PP &pp, const GroupPoint &pk, const GroupPoint &m)
 { 
     CT ct;
     // generate the random coins 
-    BigInt r = GenRandomBigIntLessThan(order); 
+    BigInt r = GenRandomBigIntLessThan(GroupOrder()); 
 
     // begin encryption
-    ct.X = pp.g * r; // X = g^r
+    ct.X = GPower(pp.g, pp.G_IS_GENERATOR, r); // X = g^r
     ct.Y = pk * r + m;     // Y = pk^r g^m
 
     #ifdef DEBUG
@@ -130,11 +138,11 @@ CT Enc(const PP &pp, const ECPoint &pk, const ECPoint &m)
 }
 
 /* Encryption algorithm: compute CT = Enc(pk, m; r): with explicit randomness */ 
-CT Enc(const PP &pp, const ECPoint &pk, const ECPoint &m, const BigInt &r)
+CT Enc(const PP &pp, const GroupPoint &pk, const GroupPoint &m, const BigInt &r)
 { 
     CT ct; 
     // begin encryption
-    ct.X = pp.g * r; // X = g^r
+    ct.X = GPower(pp.g, pp.G_IS_GENERATOR, r); // X = g^r
     ct.Y = pk * r + m; // Y = g^r m
 
     #ifdef DEBUG
@@ -149,13 +157,13 @@ CT Enc(const PP &pp, const ECPoint &pk, const ECPoint &m, const BigInt &r)
 ** re-rand ciphertext CT  
 ** run by anyone
 */ 
-CT ReRand(const PP &pp, const ECPoint &pk, const CT &ct)
+CT ReRand(const PP &pp, const GroupPoint &pk, const CT &ct)
 { 
     CT ct_new; 
-    BigInt r = GenRandomBigIntLessThan(order); 
+    BigInt r = GenRandomBigIntLessThan(GroupOrder()); 
 
     // begin re-encryption with the given randomness 
-    ct_new.X = ct.X + pp.g * r; // ct_new.X = ct.X + g^r 
+    ct_new.X = ct.X + GPower(pp.g, pp.G_IS_GENERATOR, r); // ct_new.X = ct.X + g^r 
     ct_new.Y = ct.Y + pk * r; // ct_new.Y = ct.Y + pk^r 
 
     #ifdef DEBUG
@@ -167,23 +175,23 @@ CT ReRand(const PP &pp, const ECPoint &pk, const CT &ct)
 }
 
 // decrypt 
-ECPoint Dec(const PP &pp, const BigInt &sk, const CT &ct)
+GroupPoint Dec(const PP &pp, const BigInt &sk, const CT &ct)
 { 
     return ct.Y - ct.X * sk; 
 }
 
 
+#ifndef ENABLE_RISTRETTO_GROUP
 std::vector<unsigned char> CTtoByteArray(ElGamal::CT &ct)
 { 
-    int thread_num = omp_get_thread_num();
 	#ifdef ECPOINT_COMPRESSED
 		std::vector<unsigned char> buffer(POINT_COMPRESSED_BYTE_LEN*2);
-		EC_POINT_point2oct(group, ct.X.point_ptr, POINT_CONVERSION_COMPRESSED, buffer.data(), POINT_COMPRESSED_BYTE_LEN, bn_ctx[thread_num]);
-        EC_POINT_point2oct(group, ct.Y.point_ptr, POINT_CONVERSION_COMPRESSED, buffer.data()+POINT_COMPRESSED_BYTE_LEN, POINT_COMPRESSED_BYTE_LEN, bn_ctx[thread_num]);
+		EC_POINT_point2oct(group, ct.X.point_ptr, POINT_CONVERSION_COMPRESSED, buffer.data(), POINT_COMPRESSED_BYTE_LEN, GetBNCtx());
+        EC_POINT_point2oct(group, ct.Y.point_ptr, POINT_CONVERSION_COMPRESSED, buffer.data()+POINT_COMPRESSED_BYTE_LEN, POINT_COMPRESSED_BYTE_LEN, GetBNCtx());
 	#else
 		std::vector<unsigned char> buffer(POINT_BYTE_LEN*2);
-		EC_POINT_point2oct(group, ct.X.point_ptr, POINT_CONVERSION_UNCOMPRESSED, buffer.data(), POINT_BYTE_LEN, bn_ctx[thread_num]);
-        EC_POINT_point2oct(group, ct.Y.point_ptr, POINT_CONVERSION_UNCOMPRESSED, buffer.data()+POINT_BYTE_LEN, POINT_BYTE_LEN, bn_ctx[thread_num]);
+		EC_POINT_point2oct(group, ct.X.point_ptr, POINT_CONVERSION_UNCOMPRESSED, buffer.data(), POINT_BYTE_LEN, GetBNCtx());
+        EC_POINT_point2oct(group, ct.Y.point_ptr, POINT_CONVERSION_UNCOMPRESSED, buffer.data()+POINT_BYTE_LEN, POINT_BYTE_LEN, GetBNCtx());
  
 	#endif
 
@@ -193,17 +201,35 @@ std::vector<unsigned char> CTtoByteArray(ElGamal::CT &ct)
 ElGamal::CT ByteArraytoCT(std::vector<unsigned char> &buffer)
 { 
     ElGamal::CT ct; 
-    int thread_num = omp_get_thread_num();
     #ifdef ECPOINT_COMPRESSED
-        EC_POINT_oct2point(group, ct.X.point_ptr, buffer.data(), POINT_COMPRESSED_BYTE_LEN, bn_ctx[thread_num]);
-        EC_POINT_oct2point(group, ct.Y.point_ptr, buffer.data()+POINT_COMPRESSED_BYTE_LEN, POINT_COMPRESSED_BYTE_LEN, bn_ctx[thread_num]);
+        EC_POINT_oct2point(group, ct.X.point_ptr, buffer.data(), POINT_COMPRESSED_BYTE_LEN, GetBNCtx());
+        EC_POINT_oct2point(group, ct.Y.point_ptr, buffer.data()+POINT_COMPRESSED_BYTE_LEN, POINT_COMPRESSED_BYTE_LEN, GetBNCtx());
     #else
-        EC_POINT_oct2point(group, ct.X.point_ptr, buffer.data(), POINT_BYTE_LEN, bn_ctx[thread_num]); 
-        EC_POINT_oct2point(group, ct.Y.point_ptr, buffer.data()+POINT_BYTE_LEN, POINT_BYTE_LEN, bn_ctx[thread_num]); 
+        EC_POINT_oct2point(group, ct.X.point_ptr, buffer.data(), POINT_BYTE_LEN, GetBNCtx()); 
+        EC_POINT_oct2point(group, ct.Y.point_ptr, buffer.data()+POINT_BYTE_LEN, POINT_BYTE_LEN, GetBNCtx()); 
     #endif
     
     return ct;            
 }
+#else
+std::vector<unsigned char> CTtoByteArray(ElGamal::CT &ct)
+{ 
+    std::vector<unsigned char> buffer(RISTRETTO_POINT_BYTE_LEN*2);
+    ct.X.ToBytes(buffer.data()); 
+    ct.Y.ToBytes(buffer.data()+RISTRETTO_POINT_BYTE_LEN); 
+    return buffer;            
+}
+
+ElGamal::CT ByteArraytoCT(std::vector<unsigned char> &buffer)
+{ 
+    ElGamal::CT ct; 
+    if (!ct.X.FromBytes(buffer.data()) || !ct.Y.FromBytes(buffer.data()+RISTRETTO_POINT_BYTE_LEN)){
+        std::cerr << "invalid ristretto255 encoding" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    return ct;            
+}
+#endif
 
 
 #else
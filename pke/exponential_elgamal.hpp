@@ -2,6 +2,7 @@
 #define EXPONENTIAL_ELGAMAL_HPP_
 
 #include "calculate_dlog.hpp"
+#include "../crypto/ec_fixed_base.hpp"
 
 namespace ExponentialElGamal{
  
@@ -15,6 +16,7 @@ struct PP
     BigInt MSG_SIZE; // the size of message space
     size_t TRADEOFF_NUM; // default value = 0; tunning it in [0, RANGE_LEN/2], ++ leads bigger table and less time 
     ECPoint g; // random generator 
+    bool G_IS_GENERATOR = false;
 };
 
 // define the structure of ciphertext
@@ -45,6 +47,7 @@ std::ifstream &operator>>(std::ifstream &fin, ExponentialElGamal::PP &pp)
     fin >> pp.MSG_LEN >> pp.TRADEOFF_NUM; 
     fin >> pp.MSG_SIZE;
     fin >> pp.g; 
+    pp.G_IS_GENERATOR = (pp.g == ECPoint(generator)); 
     return fin;
 }
 
@@ -140,6 +143,7 @@ PP Setup(size_t MSG_LEN, size_t TRADEOFF_NUM)
     #endif
   
     pp.g = ECPoint(generator); 
+    pp.G_IS_GENERATOR = true; 
 
     #ifdef PRINT
         std::cout << "generate the public parameters for Exponential ElGamal >>>" << std::endl; 
@@ -173,7 +177,7 @@ void Initialize(PP &pp)
 std::tuple<ECPoint, BigInt> KeyGen(const PP &pp)
 { 
     BigInt sk = GenRandomBigIntLessThan(order); // sk \sample Z_p
-    ECPoint pk = pp.g * sk; // pk = g^sk  
+    ECPoint pk = GPower(pp.g, pp.G_IS_GENERATOR, sk); // pk = g^sk  
 
     #ifdef PRINT
         std::cout << "key generation finished >>>" << std::endl;  
@@ -193,7 +197,7 @@ CT Enc(const PP &pp, const ECPoint &pk, const BigInt &m)
     BigInt r = GenRandomBigIntLessThan(order); 
 
     // begin encryption
-    ct.X = pp.g * r; // X = g^r
+    ct.X = GPower(pp.g, pp.G_IS_GENERATOR, r); // X = g^r
     
     // vectormul using wNAF method, which is fast than naive ct.Y = pk * r + pp.g * m;  
     std::vector<ECPoint> vec_A{pk, pp.g}; 
@@ -213,7 +217,7 @@ CT Enc(const PP &pp, const ECPoint &pk, const BigInt &m, const BigInt &r)
 { 
     CT ct; 
     // begin encryption
-    ct.X = pp.g * r; // X = g^r
+    ct.X = GPower(pp.g, pp.G_IS_GENERATOR, r); // X = g^r
     std::vector<ECPoint> vec_A{pk, pp.g}; 
     std::vector<BigInt> vec_a{r, m};
     ct.Y = ECPointVectorMul(vec_A, vec_a); // Y = g^r h^m
@@ -226,6 +230,24 @@ CT Enc(const PP &pp, const ECPoint &pk, const BigInt &m, const BigInt &r)
     return ct; 
 }
 
+/* 
+** Encryption algorithm with the precomputed table of pk: pays off when one pk encrypts many messages, 
+** since Y = pk^r g^m dominates the cost of Enc
+*/ 
+CT Enc(const PP &pp, const FixedBaseTable &pk_table, const BigInt &m, const BigInt &r)
+{ 
+    CT ct; 
+    ct.X = GPower(pp.g, pp.G_IS_GENERATOR, r); // X = g^r
+    ct.Y = pk_table.Mul(r) + GPower(pp.g, pp.G_IS_GENERATOR, m); // Y = pk^r g^m
+    return ct; 
+}
+
+CT Enc(const PP &pp, const FixedBaseTable &pk_table, const BigInt &m)
+{ 
+    BigInt r = GenRandomBigIntLessThan(order); 
+    return Enc(pp, pk_table, m, r); 
+}
+
 /* Decryption algorithm: compute m = Dec(sk, CT) */ 
 BigInt Dec(const PP &pp, const BigInt& sk, const CT &ct)
 { 
@@ -254,7 +276,7 @@ CT ReEnc(const PP &pp, const ECPoint &pk, const BigInt &sk, const CT &ct, const
     ECPoint M = ct.Y - ct.X * sk; // M = Y - X^sk = g^m
 
     // begin re-encryption with the given randomness 
-    ct_new.X = pp.g * r; // CT_new.X = g^r 
+    ct_new.X = GPower(pp.g, pp.G_IS_GENERATOR, r); // CT_new.X = g^r 
     ct_new.Y = pk * r + M; // CT_new.Y = pk^r + M 
 
     #ifdef DEBUG
@@ -275,7 +297,7 @@ CT ReRand(const PP &pp, const ECPoint &pk, const CT &ct)
     BigInt r = GenRandomBigIntLessThan(order); 
 
     // begin re-encryption with the given randomness 
-    ct_new.X = ct.X + pp.g * r; // ct_new.X = ct.X + g^r 
+    ct_new.X = ct.X + GPower(pp.g, pp.G_IS_GENERATOR, r); // ct_new.X = ct.X + g^r 
     ct_new.Y = ct.Y + pk * r; // ct_new.Y = ct.Y + pk^r 
 
     #ifdef DEBUG
@@ -325,8 +347,8 @@ CT ScalarMul(CT &ct, const BigInt &k)
 MRCT Enc(const PP &pp, const std::vector<ECPoint> &vec_pk, const BigInt &m, const BigInt &r)
 {  
     MRCT ct; 
-    ct.X = pp.g * r; // Y = g^r
-    ECPoint M = pp.g * m; // M = g^m
+    ct.X = GPower(pp.g, pp.G_IS_GENERATOR, r); // Y = g^r
+    ECPoint M = GPower(pp.g, pp.G_IS_GENERATOR, m); // M = g^m
     size_t n = vec_pk.size(); 
     for(auto i = 0; i < n; i++){
         ct.vec_Y.emplace_back(vec_pk[i] * r + M); 
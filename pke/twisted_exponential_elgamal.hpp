@@ -2,6 +2,7 @@
 #define TWISTED_EXPONENTIAL_ELGAMAL_HPP_
 
 #include "calculate_dlog.hpp"
+#include "../crypto/ec_fixed_base.hpp"
 
 namespace TwistedExponentialElGamal{
 
@@ -15,6 +16,9 @@ struct PP
     BigInt MSG_SIZE; // the size of message space
     size_t TRADEOFF_NUM; // default value = RANGE_LEN/2; tunning it in [0, RANGE_LEN/2], ++ leads bigger table and less time 
     ECPoint g, h; // two random generators 
+    bool G_IS_GENERATOR = false;
+    FixedBaseTable h_table; // precomputed table of h, saved with pp
+    bool USE_H_TABLE = false; // h_table is known to be the table of h: checked once, when it is built or loaded
 };
 
 // define the structure of ciphertext
@@ -83,11 +87,19 @@ std::string MRCTToByteString(MRCT &ct)
 }
 
 
+/*
+** the h table follows h behind a tag; pp written before the table was added stops at h, 
+** so a missing tag means an old file and the table is rebuilt instead of read
+*/
+inline const char H_TABLE_TAG[8] = {'K', 'L', 'H', 'T', 'A', 'B', 'L', 'E'}; 
+
 std::ofstream &operator<<(std::ofstream &fout, const TwistedExponentialElGamal::PP &pp)
 {
     fout << pp.MSG_LEN << pp.TRADEOFF_NUM;
     fout << pp.MSG_SIZE; 
     fout << pp.g << pp.h; 
+    fout.write(H_TABLE_TAG, sizeof(H_TABLE_TAG)); 
+    fout << pp.h_table; 
     return fout; 
 }
 
@@ -96,6 +108,20 @@ std::ifstream &operator>>(std::ifstream &fin, TwistedExponentialElGamal::PP &pp)
     fin >> pp.MSG_LEN >> pp.TRADEOFF_NUM; 
     fin >> pp.MSG_SIZE;
     fin >> pp.g >> pp.h; 
+    pp.G_IS_GENERATOR = (pp.g == ECPoint(generator)); 
+
+    std::streampos position = fin.tellg(); 
+    char tag[sizeof(H_TABLE_TAG)]; 
+    fin.read(tag, sizeof(tag)); 
+    if (fin.gcount() == sizeof(tag) && memcmp(tag, H_TABLE_TAG, sizeof(tag)) == 0) fin >> pp.h_table; 
+    else{
+        fin.clear(); 
+        fin.seekg(position); 
+        pp.h_table = FixedBaseTable(); 
+    }
+    // a table of another point (or an empty one) is rebuilt
+    if (!(pp.h_table.base == pp.h) || (pp.h_table.table.empty() && ECJacobian::ENABLE)) pp.h_table.Build(pp.h); 
+    pp.USE_H_TABLE = !pp.h_table.table.empty(); 
     return fin;
 }
 
@@ -143,9 +169,12 @@ PP Setup(size_t MSG_LEN, size_t TRADEOFF_NUM)
     #endif
   
     pp.g = ECPoint(generator); 
+    pp.G_IS_GENERATOR = true; 
 
     /* generate pp.h via deterministic and transparent manner */
     pp.h = Hash::StringToECPoint(pp.g.ToByteString());   
+    pp.h_table.Build(pp.h); 
+    pp.USE_H_TABLE = !pp.h_table.table.empty(); 
 
     #ifdef DEBUG
         std::cout << "generate the public parameters for twisted exponential ElGamal >>>" << std::endl; 
@@ -179,7 +208,7 @@ void Initialize(PP &pp)
 std::tuple<ECPoint, BigInt> KeyGen(const PP &pp)
 { 
     BigInt sk = GenRandomBigIntLessThan(order); // sk \sample Z_p
-    ECPoint pk = pp.g * sk; // pk = g^sk  
+    ECPoint pk = GPower(pp.g, pp.G_IS_GENERATOR, sk); // pk = g^sk  
 
     #ifdef DEBUG
         std::cout << "key generation finished >>>" << std::endl;  
@@ -191,6 +220,13 @@ std::tuple<ECPoint, BigInt> KeyGen(const PP &pp)
 }
 
 
+/* compute h^m, using the table of h if pp comes from Setup or deserialization */
+inline ECPoint HPower(const PP &pp, const BigInt &m)
+{
+    if (pp.USE_H_TABLE) return pp.h_table.Mul(m); 
+    return pp.h * m; 
+}
+
 /* Encryption algorithm: compute CT = Enc(pk, m; r) */ 
 CT Enc(const PP &pp, const ECPoint &pk, const BigInt &m)
 { 
@@ -201,10 +237,8 @@ CT Enc(const PP &pp, const ECPoint &pk, const BigInt &m)
     // begin encryption
     ct.X = pk * r; // X = pk^r
     
-    // vectormul using wNAF method, which is fast than naive ct.Y = pp.g * r + pp.h * m;  
-    std::vector<ECPoint> vec_A{pp.g, pp.h}; 
-    std::vector<BigInt> vec_a{r, m};
-    ct.Y = ECPointVectorMul(vec_A, vec_a);     // Y = g^r h^m
+    // both g and h are fixed bases, which is faster than the wNAF vectormul of (g, h)
+    ct.Y = GPower(pp.g, pp.G_IS_GENERATOR, r) + HPower(pp, m); // Y = g^r h^m
 
     #ifdef DEBUG
         std::cout << "twisted exponential ElGamal encryption finishes >>>"<< std::endl;
@@ -221,9 +255,7 @@ CT Enc(const PP &pp, const ECPoint &pk, const BigInt &m, const BigInt &r)
     // begin encryption
     ct.X = pk * r; // X = pk^r
     
-    std::vector<ECPoint> vec_A{pp.g, pp.h}; 
-    std::vector<BigInt> vec_a{r, m};
-    ct.Y = ECPointVectorMul(vec_A, vec_a); // CT.Y = pp.g * r + pp.h * m; 
+    ct.Y = GPower(pp.g, pp.G_IS_GENERATOR, r) + HPower(pp, m); // CT.Y = pp.g * r + pp.h * m; 
 
     #ifdef DEBUG
         std::cout << "twisted exponential ElGamal encryption finishes >>>"<< std::endl;
@@ -233,6 +265,24 @@ CT Enc(const PP &pp, const ECPoint &pk, const BigInt &m, const BigInt &r)
     return ct; 
 }
 
+/* 
+** Encryption algorithm with the precomputed table of pk: pays off when one pk encrypts many messages, 
+** since X = pk^r dominates the cost of Enc
+*/ 
+CT Enc(const PP &pp, const FixedBaseTable &pk_table, const BigInt &m, const BigInt &r)
+{ 
+    CT ct; 
+    ct.X = pk_table.Mul(r); // X = pk^r
+    ct.Y = GPower(pp.g, pp.G_IS_GENERATOR, r) + HPower(pp, m); // Y = g^r h^m
+    return ct; 
+}
+
+CT Enc(const PP &pp, const FixedBaseTable &pk_table, const BigInt &m)
+{ 
+    BigInt r = GenRandomBigIntLessThan(order); 
+    return Enc(pp, pk_table, m, r); 
+}
+
 
 /* Decryption algorithm: compute m = Dec(sk, CT) */ 
 BigInt Dec(const PP &pp, const BigInt& sk, const CT &ct)
@@ -257,7 +307,7 @@ CT Enc(const PP &pp, const ECPoint &pk, const ECPoint &m, const BigInt &r)
     CT ct; 
     // begin encryption
     ct.X = pk * r; // X = pk^r
-    ct.Y = pp.g * r + m; // Y = g^r m
+    ct.Y = GPower(pp.g, pp.G_IS_GENERATOR, r) + m; // Y = g^r m
     return ct;
 }
 
@@ -281,7 +331,7 @@ CT ReEnc(const PP &pp, const ECPoint &pk, const BigInt &sk, const CT &ct, const
 
     // begin re-encryption with the given randomness 
     ct_new.X = pk * r; // CT_new.X = pk^r 
-    ct_new.Y = pp.g * r + M; // CT_new.Y = g^r 
+    ct_new.Y = GPower(pp.g, pp.G_IS_GENERATOR, r) + M; // CT_new.Y = g^r 
 
     #ifdef DEBUG
         std::cout << "refresh ciphertext succeeds >>>"<< std::endl;
@@ -302,7 +352,7 @@ CT ReRand(const PP &pp, const ECPoint &pk, const CT &ct)
 
     // begin re-encryption with the given randomness 
     ct_new.X = ct.X + pk * r; // ct_new.X = ct.X + pk^r 
-    ct_new.Y = ct.Y + pp.g * r; // ct_new.Y = ct.Y + g^r 
+    ct_new.Y = ct.Y + GPower(pp.g, pp.G_IS_GENERATOR, r); // ct_new.Y = ct.Y + g^r 
 
     #ifdef DEBUG
         std::cout << "rerand ciphertext succeeds >>>" << std::endl;
@@ -356,7 +406,7 @@ MRCT Enc(const PP &pp, const std::vector<ECPoint> &vec_pk, const BigInt &m, cons
         ct.vec_X.emplace_back(vec_pk[i] * r); 
     }
 
-    ct.Y = pp.g * r + pp.h * m; // Y = g^r h^m
+    ct.Y = GPower(pp.g, pp.G_IS_GENERATOR, r) + HPower(pp, m); // Y = g^r h^m
    
     #ifdef DEBUG
         std::cout << n <<"-recipient 1-message twisted exponential ElGamal encryption finishes >>>"<< std::endl;
@@ -59,7 +59,7 @@ std::tuple<PP, SP> Setup(size_t N_max)
 std::tuple<ECPoint, BigInt> KeyGen(PP &pp)
 {
     BigInt sk = GenRandomBigIntLessThan(order); 
-    ECPoint vk = pp.enc_part.g * sk;
+    ECPoint vk = GPower(pp.enc_part.g, pp.enc_part.G_IS_GENERATOR, sk);
     return {vk, sk};      
 }  
 
@@ -68,7 +68,7 @@ Signature Sign(PP &pp, BigInt &sk, std::vector<ECPoint> &vec_R, std::string &mes
 {    
     Signature sigma; 
 
-    ECPoint vk = pp.enc_part.g * sk; 
+    ECPoint vk = GPower(pp.enc_part.g, pp.enc_part.G_IS_GENERATOR, sk); 
 
     size_t N = vec_R.size();
     size_t l = N;  
@@ -84,7 +84,7 @@ Signature Sign(PP &pp, BigInt &sk, std::vector<ECPoint> &vec_R, std::string &mes
     
     BigInt t = GenRandomBigIntLessThan(order); 
     BigInt s = GenRandomBigIntLessThan(order); 
-    sigma.ct_s = TwistedExponentialElGamal::Enc(pp.enc_part, pp.ek, pp.enc_part.g * s, t); 
+    sigma.ct_s = TwistedExponentialElGamal::Enc(pp.enc_part, pp.ek, GPower(pp.enc_part.g, pp.enc_part.G_IS_GENERATOR, s), t); 
 
     
     std::vector<TwistedExponentialElGamal::CT> vec_CT(N); 
@@ -104,11 +104,12 @@ Signature Sign(PP &pp, BigInt &sk, std::vector<ECPoint> &vec_R, std::string &mes
     nizk_witness.r = r; 
     nizk_witness.l = l;
 
-    std::string transcript_str = message; 
+    Transcript transcript("accountable ring signature"); 
+    transcript.Append("message", message); 
 
-    sigma.correct_encryption_proof = EncRelation::Prove(nizk_pp, nizk_instance, nizk_witness, transcript_str); 
+    sigma.correct_encryption_proof = EncRelation::Prove(nizk_pp, nizk_instance, nizk_witness, transcript); 
 
-    BigInt x = Hash::StringToBigInt(transcript_str);
+    BigInt x = transcript.Challenge("x");
 
     sigma.z_s = (sk * x + s) % order; 
     sigma.z_t = (r * x + t) % order; 
@@ -137,14 +138,15 @@ bool Verify(PP &pp, std::vector<ECPoint> &vec_R, std::string &message, Signature
     
     std::vector<bool> vec_condition(2, true); 
 
-    std::string transcript_str = message;     
-    vec_condition[0] = EncRelation::Verify(nizk_pp, nizk_instance, transcript_str, sigma.correct_encryption_proof); 
+    Transcript transcript("accountable ring signature"); 
+    transcript.Append("message", message);     
+    vec_condition[0] = EncRelation::Verify(nizk_pp, nizk_instance, transcript, sigma.correct_encryption_proof); 
 
-    BigInt x = Hash::StringToBigInt(transcript_str);
+    BigInt x = transcript.Challenge("x");
 
     TwistedExponentialElGamal::CT ct_left = TwistedExponentialElGamal::ScalarMul(sigma.ct_vk, x); 
     ct_left = TwistedExponentialElGamal::HomoAdd(ct_left, sigma.ct_s); 
-    TwistedExponentialElGamal::CT ct_right = TwistedExponentialElGamal::Enc(pp.enc_part, pp.ek, pp.enc_part.g * sigma.z_s, sigma.z_t); 
+    TwistedExponentialElGamal::CT ct_right = TwistedExponentialElGamal::Enc(pp.enc_part, pp.ek, GPower(pp.enc_part.g, pp.enc_part.G_IS_GENERATOR, sigma.z_s), sigma.z_t); 
     vec_condition[1] = (ct_left == ct_right); 
 
     bool Validity = vec_condition[0] && vec_condition[1]; 
@@ -186,6 +188,7 @@ std::tuple<ECPoint, DLOGEquality::Proof> Open(PP &pp, SP &sp, std::vector<ECPoin
     
     DLOGEquality::Instance nizk_instance; 
     nizk_instance.g1 = pp.enc_part.g; 
+    nizk_instance.G1_IS_GENERATOR = pp.enc_part.G_IS_GENERATOR; 
     nizk_instance.h1 = pp.ek; 
     nizk_instance.g2 = sigma.ct_vk.Y - vk; 
     nizk_instance.h2 = sigma.ct_vk.X; 
@@ -193,8 +196,8 @@ std::tuple<ECPoint, DLOGEquality::Proof> Open(PP &pp, SP &sp, std::vector<ECPoin
     DLOGEquality::Witness nizk_witness; 
     nizk_witness.w = sp.dk;
 
-    std::string transcript_str = ""; 
-    correct_decryption_proof = DLOGEquality::Prove(nizk_pp, nizk_instance, nizk_witness, transcript_str); 
+    Transcript transcript; 
+    correct_decryption_proof = DLOGEquality::Prove(nizk_pp, nizk_instance, nizk_witness, transcript); 
 
     return {vk, correct_decryption_proof}; 
 }
@@ -208,13 +211,14 @@ bool Justify(PP &pp, std::vector<ECPoint> &vec_R, Signature &sigma,
     
     DLOGEquality::Instance nizk_instance; 
     nizk_instance.g1 = pp.enc_part.g; 
+    nizk_instance.G1_IS_GENERATOR = pp.enc_part.G_IS_GENERATOR; 
     nizk_instance.h1 = pp.ek; 
     nizk_instance.g2 = sigma.ct_vk.Y - vk;
     nizk_instance.h2 = sigma.ct_vk.X; 
 
-    std::string transcript_str = "";
+    Transcript transcript;
 
-    bool Validity = DLOGEquality::Verify(nizk_pp, nizk_instance, transcript_str, correct_decryption_proof); 
+    bool Validity = DLOGEquality::Verify(nizk_pp, nizk_instance, transcript, correct_decryption_proof); 
 
     if(Validity == true){
         std::cout << "the opening is correct" << std::endl;
@@ -10,6 +10,7 @@ namespace Schnorr{
 struct PP
 {  
     ECPoint g; 
+    bool G_IS_GENERATOR = false;
 };
 
 
@@ -42,6 +43,7 @@ std::ofstream &operator<<(std::ofstream &fout, const PP &pp)
 std::ifstream &operator>>(std::ifstream &fin, PP &pp)
 {
     fin >> pp.g;
+    pp.G_IS_GENERATOR = (pp.g == ECPoint(generator)); 
     return fin;  
 }
 
@@ -67,6 +69,7 @@ PP Setup()
 {
     PP pp; 
     pp.g = ECPoint(generator); 
+    pp.G_IS_GENERATOR = true; 
     return pp; 
 }
 
@@ -75,7 +78,7 @@ PP Setup()
 std::tuple<ECPoint, BigInt> KeyGen(const PP &pp)
 { 
     BigInt sk = GenRandomBigIntLessThan(order); // sk \sample Z_p
-    ECPoint pk = pp.g * sk; // pk = g^sk  
+    ECPoint pk = GPower(pp.g, pp.G_IS_GENERATOR, sk); // pk = g^sk  
 
     #ifdef DEBUG
         std::cout << "key generation finished >>>" << std::endl;  
@@ -92,7 +95,7 @@ SIG Sign(const PP &pp, const BigInt &sk, const std::string &message)
 {
     SIG sigma; // define the signature
     BigInt r = GenRandomBigIntLessThan(order);
-    sigma.A = pp.g*r; 
+    sigma.A = GPower(pp.g, pp.G_IS_GENERATOR, r); 
 
     // compute e = H(A||m)
     BigInt e = Hash::StringToBigInt(sigma.A.ToByteString() + message);
@@ -115,7 +118,7 @@ bool Verify(const PP &pp, const ECPoint &pk, std::string &message, SIG &sigma)
     // compute e = H(A||m)
     BigInt e = Hash::StringToBigInt(sigma.A.ToByteString() + message);
 
-    ECPoint LEFT = pp.g*sigma.z; // LEFT = g^z 
+    ECPoint LEFT = GPower(pp.g, pp.G_IS_GENERATOR, sigma.z); // LEFT = g^z 
     ECPoint RIGHT = pk*e + sigma.A;   // RIGHT = pk^e + A
 
     if(LEFT == RIGHT) Validity = true; 
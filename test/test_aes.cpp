@@ -1,6 +1,41 @@
 #include "../crypto/aes.hpp"
 #include "../crypto/setup.hpp"
 
+// every available backend must agree with the AES-NI kernel, for lengths that leave a tail
+void test_aes_backend(size_t LEN)
+{
+    PrintSplitLine('-'); 
+    std::cout << "AES backend test begins >>>>>>" << std::endl; 
+
+    PRG::Seed seed = PRG::SetSeed(fixed_seed, 0); 
+    std::vector<block> vec_plaintext = PRG::GenRandomBlocks(seed, LEN); 
+    std::vector<block> vec_expected(LEN), vec_ciphertext(LEN); 
+
+    AES::Backend detected_backend = AES::backend; 
+    bool flag = true; 
+    for(auto b = 0; b <= detected_backend; b++){
+        AES::backend = AES::Backend(b); 
+        auto start_time = std::chrono::steady_clock::now(); 
+        for(auto i = 0; i < 16; i++) AES::FastECBEnc(AES::fixed_enc_key, vec_plaintext.data(), LEN, vec_ciphertext.data());
+        auto end_time = std::chrono::steady_clock::now(); 
+        auto running_time = end_time - start_time;
+        std::cout << AES::BackendName(AES::backend) << ": encrypting " << 16*LEN << " blocks takes " 
+        << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+        if(b == AES::AESNI) vec_expected = vec_ciphertext; 
+        for(auto l = 0; l < 40; l++){
+            std::vector<block> vec_short(vec_plaintext.begin(), vec_plaintext.begin() + l); 
+            AES::FastECBEnc(AES::fixed_enc_key, vec_short.data(), l); // in place
+            flag = flag && (memcmp(vec_short.data(), vec_expected.data(), l*sizeof(block)) == 0); 
+        }
+        flag = flag && Block::Compare(vec_ciphertext, vec_expected); 
+    }
+    AES::backend = detected_backend; 
+
+    if(flag) std::cout << "all AES backends agree" << std::endl; 
+    else std::cout << "AES backends disagree" << std::endl; 
+}
+
 int main()
 {  
     CRYPTO_Initialize(); 
@@ -34,6 +69,8 @@ int main()
     Block::PrintBlocks(data, 4); 
     PrintSplitLine('-');
 
+    test_aes_backend(1024*1024 + 7); 
+
     CRYPTO_Finalize(); 
     return 0; 
 }
\ No newline at end of file
@@ -97,6 +97,7 @@ void FetchTestCase(OTETestcase &testcase, std::string testcase_filename)
 
 int main()
 {
+	PROTOCOL_LOG = true; 
 	CRYPTO_Initialize(); 
 
 	PrintSplitLine('-'); 
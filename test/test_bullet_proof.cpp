@@ -20,7 +20,7 @@ void GenRandomBulletInstanceWitness(Bullet::PP &pp, Bullet::Instance &instance,
         if (STATEMENT_FLAG == true){
             witness.v[i] = witness.v[i] % bn_range_size;  
         }
-        instance.C[i] = pp.g * witness.r[i] + pp.h * witness.v[i]; 
+        instance.C[i] = GPower(pp.g, pp.G_IS_GENERATOR, witness.r[i]) + pp.h * witness.v[i]; 
     }
     std::cout << "random instance generation finished" << std::endl;
     PrintBigIntVector(witness.v, "witness.v");  
@@ -42,7 +42,7 @@ void GenBoundaryBulletInstanceWitness(Bullet::PP &pp, Bullet::Instance &instance
         else{
             witness.v[i] = bn_2.ModExp(exp, order) - bn_1;
         } 
-        instance.C[i] = pp.g * witness.r[i] + pp.h * witness.v[i]; 
+        instance.C[i] = GPower(pp.g, pp.G_IS_GENERATOR, witness.r[i]) + pp.h * witness.v[i]; 
     }
     PrintBigIntVector(witness.v, "witness.v"); 
 }
@@ -65,11 +65,11 @@ void test_bulletproof_boundary(size_t RANGE_LEN, size_t MAX_AGG_NUM, std::string
 
     GenBoundaryBulletInstanceWitness(pp, instance, witness, BOUNDARY_FLAG); 
 
-    std::string transcript_str; 
+    Transcript transcript; 
     
     auto start_time = std::chrono::steady_clock::now(); // start to count the time
-    transcript_str = ""; 
-    Bullet::Prove(pp, instance, witness, transcript_str, proof);
+    transcript = Transcript(); 
+    Bullet::Prove(pp, instance, witness, transcript, proof);
     auto end_time = std::chrono::steady_clock::now(); // end to count the time
     auto running_time = end_time - start_time;
     std::cout << "proof generation takes time = " 
@@ -78,8 +78,8 @@ void test_bulletproof_boundary(size_t RANGE_LEN, size_t MAX_AGG_NUM, std::string
     PrintSplitLine('-'); 
     
     start_time = std::chrono::steady_clock::now(); // start to count the time
-    transcript_str = ""; 
-    Bullet::Verify(pp, instance, transcript_str, proof);
+    transcript = Transcript(); 
+    Bullet::Verify(pp, instance, transcript, proof);
     end_time = std::chrono::steady_clock::now(); // end to count the time
     running_time = end_time - start_time;
     std::cout << "proof verification takes time = " 
@@ -88,8 +88,8 @@ void test_bulletproof_boundary(size_t RANGE_LEN, size_t MAX_AGG_NUM, std::string
     PrintSplitLine('-'); 
     
     start_time = std::chrono::steady_clock::now(); // start to count the time
-    transcript_str = ""; 
-    Bullet::FastVerify(pp, instance, transcript_str, proof);
+    transcript = Transcript(); 
+    Bullet::FastVerify(pp, instance, transcript, proof);
     end_time = std::chrono::steady_clock::now(); // end to count the time
     running_time = end_time - start_time;
     std::cout << "fast proof verification takes time = " 
@@ -117,11 +117,11 @@ void test_bulletproof(size_t RANGE_LEN, size_t MAX_AGG_NUM, bool STATEMENT_FLAG)
 
     GenRandomBulletInstanceWitness(pp, instance, witness, STATEMENT_FLAG); 
 
-    std::string transcript_str; 
+    Transcript transcript; 
     
     auto start_time = std::chrono::steady_clock::now(); // start to count the time
-    transcript_str = ""; 
-    Bullet::Prove(pp, instance, witness, transcript_str, proof);
+    transcript = Transcript(); 
+    Bullet::Prove(pp, instance, witness, transcript, proof);
     auto end_time = std::chrono::steady_clock::now(); // end to count the time
     auto running_time = end_time - start_time;
     std::cout << "proof generation takes time = " 
@@ -129,8 +129,8 @@ void test_bulletproof(size_t RANGE_LEN, size_t MAX_AGG_NUM, bool STATEMENT_FLAG)
 
     PrintSplitLine('-'); 
     start_time = std::chrono::steady_clock::now(); // start to count the time
-    transcript_str = ""; 
-    Bullet::Verify(pp, instance, transcript_str, proof);
+    transcript = Transcript(); 
+    Bullet::Verify(pp, instance, transcript, proof);
     end_time = std::chrono::steady_clock::now(); // end to count the time
     running_time = end_time - start_time;
     std::cout << "proof verification takes time = " 
@@ -138,8 +138,8 @@ void test_bulletproof(size_t RANGE_LEN, size_t MAX_AGG_NUM, bool STATEMENT_FLAG)
 
     PrintSplitLine('-'); 
     start_time = std::chrono::steady_clock::now(); // start to count the time
-    transcript_str = ""; 
-    Bullet::FastVerify(pp, instance, transcript_str, proof);
+    transcript = Transcript(); 
+    Bullet::FastVerify(pp, instance, transcript, proof);
     end_time = std::chrono::steady_clock::now(); // end to count the time
     running_time = end_time - start_time;
     std::cout << "fast proof verification takes time = " 
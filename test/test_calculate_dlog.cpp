@@ -33,7 +33,7 @@ void benchmark_dlog(size_t RANGE_LEN, size_t TRADEOFF_NUM, size_t TEST_NUM)
     for(auto i = 0; i < TEST_NUM; i++)
     {
         x[i] = GenRandomBigIntLessThan(MAX); 
-        Y[i] = g * x[i];  
+        Y[i] = GeneratorMul(x[i]);  
     }
 
     /* test dlog efficiency */ 
@@ -102,6 +102,7 @@ void FetchTestInstance(RPMTTestcase &testcase, std::string testcase_filename)
 
 int main()
 {
+    PROTOCOL_LOG = true; 
     CRYPTO_Initialize(); 
 
     PrintSplitLine('-'); 
@@ -149,25 +150,28 @@ int main()
   
     if(party == "server"){
         NetIO server("server", "", 8080);
-        std::vector<uint8_t> vec_indication_bit_real;
-        
-        vec_indication_bit_real = cwPRFmqRPMT::Server(server, pp, testcase.vec_Y);
-
-        size_t HAMMING_WEIGHT = 0;
-        for(auto i = 0; i < pp.CLIENT_LEN; i++){
-            if(vec_indication_bit_real[i] == 1) HAMMING_WEIGHT++; 
-        } 
+        BitVector vec_indication_bit_real = cwPRFmqRPMT::Server(server, pp, testcase.vec_Y);
+
+        size_t HAMMING_WEIGHT = vec_indication_bit_real.Count();
         std::cout << "correct Hamming weight = " << testcase.HAMMING_WEIGHT << std::endl;
         std::cout << "real Hamming weight = " << HAMMING_WEIGHT << std::endl;
 
         double error_probability = abs(double(testcase.HAMMING_WEIGHT)-double(HAMMING_WEIGHT))/double(testcase.HAMMING_WEIGHT); 
         std::cout << "cwPRF-based mqRPMT test succeeds with probability " << (1 - error_probability) << std::endl; 
+
+        PrintSplitLine('-'); 
+        server.GetMetrics().Print(); 
+        std::cout << server.GetMetrics().ToJSON() << std::endl; 
     }
 
     if(party == "client")
     {
         NetIO client("client", "127.0.0.1", 8080);  
         cwPRFmqRPMT::Client(client, pp, testcase.vec_X);
+
+        PrintSplitLine('-'); 
+        client.GetMetrics().Print(); 
+        std::cout << client.GetMetrics().ToJSON() << std::endl; 
     } 
 
     PrintSplitLine('-'); 
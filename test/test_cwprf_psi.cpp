@@ -122,6 +122,7 @@ void FetchTestCase(TestCase &testcase, std::string testcase_filename)
 
 int main()
 {
+    PROTOCOL_LOG = true; 
     CRYPTO_Initialize(); 
 
     std::cout << "cwPRF-based PSI test begins >>>" << std::endl; 
@@ -68,6 +68,7 @@ void FetchTestCase(DDHOPRFTestCase &testcase, std::string testcase_filename)
 
 int main()
 {
+	PROTOCOL_LOG = true; 
 	CRYPTO_Initialize(); 
 
     std::cout << "DDH-based OPRF test begins >>>" << std::endl; 
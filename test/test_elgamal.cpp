@@ -8,18 +8,18 @@ void benchmark_test(size_t TEST_NUM)
     std::cout << "begin the benchmark test >>>"<< std::endl;
     PrintSplitLine('-'); 
 
-#ifndef ENABLE_X25519_ACCELERATION
+#if defined(ENABLE_RISTRETTO_GROUP) || !defined(ENABLE_X25519_ACCELERATION)
     ElGamal::PP pp = ElGamal::Setup();
-    ECPoint pk[TEST_NUM];                      // pk
-    BigInt sk[TEST_NUM];                       // sk
-    ECPoint m[TEST_NUM];                        // messages  
-    ECPoint m_real[TEST_NUM];                  // decrypted messages
-    ElGamal::CT ct[TEST_NUM];            // ct
-    ElGamal::CT ct_new[TEST_NUM];            // ct
+    std::vector<GroupPoint> pk(TEST_NUM);                      // pk
+    std::vector<BigInt> sk(TEST_NUM);                       // sk
+    std::vector<GroupPoint> m(TEST_NUM);                        // messages  
+    std::vector<GroupPoint> m_real(TEST_NUM);                  // decrypted messages
+    std::vector<ElGamal::CT> ct(TEST_NUM);            // ct
+    std::vector<ElGamal::CT> ct_new(TEST_NUM);            // ct
 
     for(auto i = 0; i < TEST_NUM; i++)
     {
-        m[i] = GenRandomECPoint();  
+        m[i] = GroupGeneratorMul(GenRandomBigIntLessThan(GroupOrder()));  
     }
 
     /* test keygen efficiency */ 
@@ -138,12 +138,12 @@ void function_test()
     std::cout << "begin the functionality test >>>"<< std::endl;
     PrintSplitLine('-'); 
 
-#ifndef ENABLE_X25519_ACCELERATION
+#if defined(ENABLE_RISTRETTO_GROUP) || !defined(ENABLE_X25519_ACCELERATION)
     ElGamal::PP pp = ElGamal::Setup();
-    ECPoint pk;                      // pk
+    GroupPoint pk;                      // pk
     BigInt sk;              // sk
-    ECPoint m_random;     // message  
-    ECPoint m_real;       // decrypted message
+    GroupPoint m_random;     // message  
+    GroupPoint m_real;       // decrypted message
     ElGamal::CT ct;            // ct   
     ElGamal::CT ct_new;            // ct    
 
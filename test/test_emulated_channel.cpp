@@ -0,0 +1,278 @@
+#include "../netio/loopback_channel.hpp"
+#include "../netio/emulated_channel.hpp"
+#include "../mpc/rpmt/cwprf_mqrpmt.hpp"
+#include "../mpc/rpmt/rrpke_mqrpmt.hpp"
+#include "../mpc/oprf/ote_oprf.hpp"
+#include "../mpc/oprf/vole_oprf.hpp"
+#include "../crypto/setup.hpp"
+
+/*
+** both parties run as threads of this process over a loopback pair, each side wrapped in an EmulatedChannel,
+** so every direction sees the bandwidth, latency and jitter of the profile
+*/
+template <typename ServerFunction, typename ClientFunction>
+void RunOverLink(const LinkProfile &profile, std::string protocol, ServerFunction server_function, ClientFunction client_function)
+{
+    LoopbackChannel server_loopback, client_loopback;
+    ConnectLoopback(server_loopback, client_loopback);
+
+    double server_time, client_time;
+    PhaseMetrics server_total, client_total;
+    auto start_time = std::chrono::steady_clock::now();
+    std::thread server_thread([&]{
+        EmulatedChannel server_io(server_loopback, profile);
+        server_function(server_io);
+        server_io.Flush();
+        server_time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+        server_total = server_io.GetMetrics().Total();
+    });
+    {
+        EmulatedChannel client_io(client_loopback, profile);
+        client_function(client_io);
+        client_io.Flush();
+        client_time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+        client_total = client_io.GetMetrics().Total();
+    }
+    server_thread.join();
+
+    std::cout << "[" << profile.name << "] " << protocol << ": Server side takes time = " << server_time
+              << " ms, Client side takes time = " << client_time << " ms" << std::endl;
+    std::cout << "[" << profile.name << "] " << protocol << ": Server ===> Client " << double(server_total.BYTES_SENT)/(1024*1024)
+              << " MB, Client ===> Server " << double(client_total.BYTES_SENT)/(1024*1024) << " MB, "
+              << std::max(server_total.ROUND_TRIPS, client_total.ROUND_TRIPS) << " round trips" << std::endl;
+}
+
+// average time of a ping-pong, and the best of three 4 MB transfers each answered by an integer, in ms
+void MeasureLink(const LinkProfile &profile, double &rtt, double &bulk_time)
+{
+    size_t ROUND_NUM = 4;
+    size_t BULK_NUM = 3;
+    size_t BULK_LEN = 1024*1024*4;
+    std::vector<uint8_t> bulk(BULK_LEN);
+
+    LoopbackChannel server_loopback, client_loopback;
+    ConnectLoopback(server_loopback, client_loopback);
+    std::thread server_thread([&]{
+        EmulatedChannel server_io(server_loopback, profile);
+        for(auto i = 0; i < ROUND_NUM; i++){
+            size_t n;
+            server_io.ReceiveInteger(n);
+            server_io.SendInteger(n);
+        }
+        std::vector<uint8_t> buffer(BULK_LEN);
+        for(auto i = 0; i < BULK_NUM; i++){
+            server_io.ReceiveBytes(buffer.data(), BULK_LEN);
+            server_io.SendInteger(BULK_LEN);
+        }
+    });
+
+    EmulatedChannel client_io(client_loopback, profile);
+    auto start_time = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < ROUND_NUM; i++){
+        size_t n;
+        client_io.SendInteger(i);
+        client_io.ReceiveInteger(n);
+    }
+    auto end_time = std::chrono::steady_clock::now();
+    rtt = std::chrono::duration<double, std::milli>(end_time - start_time).count() / ROUND_NUM;
+
+    bulk_time = std::numeric_limits<double>::max();
+    for(auto i = 0; i < BULK_NUM; i++){
+        start_time = std::chrono::steady_clock::now();
+        client_io.SendBytes(bulk.data(), BULK_LEN);
+        size_t n;
+        client_io.ReceiveInteger(n);
+        end_time = std::chrono::steady_clock::now();
+        bulk_time = std::min(bulk_time, std::chrono::duration<double, std::milli>(end_time - start_time).count());
+    }
+    server_thread.join();
+}
+
+// a ping-pong and a bulk transfer should take what the profile predicts
+bool test_link_profile(const LinkProfile &profile)
+{
+    // what the emulation itself costs on this host (copies and thread hand-offs): the same exchange over an unshaped link
+    double host_rtt, host_bulk_time;
+    MeasureLink({"unshaped", 1e9, 0, 0}, host_rtt, host_bulk_time);
+
+    double rtt, bulk_time;
+    MeasureLink(profile, rtt, bulk_time);
+
+    // each direction adds half the RTT and at most JITTER_MS
+    double max_rtt = profile.RTT_MS + 2 * profile.JITTER_MS;
+    double min_bulk_time = 1024*1024*4 * 8 / (profile.BANDWIDTH_MBPS * 1e3) + profile.RTT_MS;
+    double max_bulk_time = min_bulk_time + 2 * profile.JITTER_MS;
+    std::cout << "[" << profile.name << "] measured RTT = " << rtt << " ms (profile: " << profile.RTT_MS
+              << " ms + jitter up to " << 2 * profile.JITTER_MS << " ms, host: " << host_rtt << " ms)" << std::endl;
+    std::cout << "[" << profile.name << "] 4 MB round trip takes " << bulk_time << " ms (profile: "
+              << min_bulk_time << " ms, host: " << host_bulk_time << " ms)" << std::endl;
+
+    // the emulated link is never faster than the profile, and slower by at most 10%, the host cost and 1 ms
+    bool flag = (rtt >= profile.RTT_MS) && (rtt <= max_rtt * 1.1 + host_rtt + 1)
+             && (bulk_time >= min_bulk_time) && (bulk_time <= max_bulk_time * 1.1 + host_bulk_time + 1);
+    if(flag) std::cout << "link emulation test succeeds" << std::endl;
+    else std::cerr << "link emulation test fails" << std::endl;
+    return flag;
+}
+
+// a message is counted once, by the emulated channel: the slices it forwards are not counted again by the wrapped one
+bool test_emulated_metrics()
+{
+    size_t LEN = EMULATED_SLICE_LEN * 16;
+    std::vector<uint8_t> buffer(LEN);
+    LoopbackChannel server_loopback, client_loopback;
+    ConnectLoopback(server_loopback, client_loopback);
+    PhaseMetrics client_total;
+    {
+        std::thread server_thread([&]{
+            EmulatedChannel server_io(server_loopback, {"unshaped", 1e9, 0, 0});
+            std::vector<uint8_t> server_buffer(LEN);
+            server_io.ReceiveBytes(server_buffer.data(), LEN);
+            server_io.SendInteger(LEN);
+        });
+        EmulatedChannel client_io(client_loopback, {"unshaped", 1e9, 0, 0});
+        client_io.SendBytes(buffer.data(), LEN);
+        size_t n;
+        client_io.ReceiveInteger(n);
+        client_total = client_io.GetMetrics().Total();
+        server_thread.join();
+    }
+    PhaseMetrics inner_total = client_loopback.GetMetrics().Total();
+    bool flag = (client_total.MESSAGES_SENT == 1) && (client_total.BYTES_SENT == LEN) && (client_total.MESSAGES_RECEIVED == 1)
+             && (client_total.ROUND_TRIPS == 1) && (inner_total.MESSAGES_SENT == 0) && (inner_total.MESSAGES_RECEIVED == 0)
+             && (inner_total.ROUND_TRIPS == 0);
+    if(flag) std::cout << "emulated channel metrics test succeeds" << std::endl;
+    else std::cerr << "emulated channel metrics test fails" << std::endl;
+    return flag;
+}
+
+// the client learns which of its items are in the server set from the server's OPRF values
+std::vector<block> IntersectByOPRFValues(const std::vector<block> &vec_X, const std::vector<std::string> &vec_Fk_X, 
+                                         const std::vector<std::string> &vec_Fk_Y)
+{
+    std::unordered_set<std::string> S(vec_Fk_Y.begin(), vec_Fk_Y.end());
+    std::vector<block> vec_intersection;
+    for(auto i = 0; i < vec_X.size(); i++){
+        if(S.find(vec_Fk_X[i]) != S.end()) vec_intersection.emplace_back(vec_X[i]);
+    }
+    return vec_intersection;
+}
+
+// returns whether the OPRF-based PSI runs found the planted intersection
+bool BenchmarkPSIPaths(const LinkProfile &profile, size_t LOG_LEN)
+{
+    size_t LEN = size_t(1) << LOG_LEN;
+    PRG::Seed seed = PRG::SetSeed(fixed_seed, 0);
+    std::vector<block> vec_Y = PRG::GenRandomBlocks(seed, LEN); // server set
+    std::vector<block> vec_X = PRG::GenRandomBlocks(seed, LEN); // client set: half of it in the server set
+    for(auto i = 0; i < LEN; i += 2) vec_X[i] = vec_Y[i];
+
+    PrintSplitLine('-');
+    std::cout << "set size = 2^" << LOG_LEN << ", link = " << profile.BANDWIDTH_MBPS << " Mbps, RTT "
+              << profile.RTT_MS << " ms, jitter " << profile.JITTER_MS << " ms" << std::endl;
+    PrintSplitLine('-');
+
+    cwPRFmqRPMT::PP cwprf_pp = cwPRFmqRPMT::Setup(40, LOG_LEN, LOG_LEN);
+    RunOverLink(profile, "cwPRF-based mqRPMT",
+        [&](Channel &io){ cwPRFmqRPMT::Server(io, cwprf_pp, vec_Y); },
+        [&](Channel &io){ cwPRFmqRPMT::Client(io, cwprf_pp, vec_X); });
+
+    #if !defined(ENABLE_X25519_ACCELERATION) && !defined(ENABLE_RISTRETTO_GROUP)
+        rrPKEmqRPMT::PP rrpke_pp = rrPKEmqRPMT::Setup(40, LOG_LEN, LOG_LEN);
+        RunOverLink(profile, "rrPKE-based mqRPMT",
+            [&](Channel &io){ rrPKEmqRPMT::Server(io, rrpke_pp, vec_Y); },
+            [&](Channel &io){ rrPKEmqRPMT::Client(io, rrpke_pp, vec_X); });
+    #else
+        // rrPKE needs ElGamal over the OpenSSL curve, which the x25519 build replaces
+        std::cout << "[" << profile.name << "] rrPKE-based mqRPMT: not run, comment out ENABLE_X25519_ACCELERATION "
+                  << "in crypto/ec_group.hpp to include it" << std::endl;
+    #endif
+
+    // OPRF-based PSI: the server evaluates the OPRF on its own set and sends the values over,
+    // the client keeps the items whose OPRF value is among them
+    size_t INTERSECTION_LEN = 0;
+    auto ToStrings = [](const std::vector<std::vector<uint8_t>> &vec_bytes){
+        std::vector<std::string> vec_str(vec_bytes.size());
+        for(auto i = 0; i < vec_bytes.size(); i++) vec_str[i].assign(vec_bytes[i].begin(), vec_bytes[i].end());
+        return vec_str;
+    };
+    // Evaluate and Client both draw the salts from pp.common_seed: each party needs its own copy, as in two processes
+    OTEOPRF::PP ote_pp = OTEOPRF::Setup(LOG_LEN);
+    RunOverLink(profile, "OTE-based OPRF PSI",
+        [&, server_pp = ote_pp](Channel &io) mutable {
+            std::vector<uint8_t> key = OTEOPRF::Server(io, server_pp);
+            std::vector<std::vector<uint8_t>> vec_Fk_Y = OTEOPRF::Evaluate(server_pp, key, vec_Y, LEN);
+            io.SendBytesVector(vec_Fk_Y);
+        },
+        [&, client_pp = ote_pp](Channel &io) mutable {
+            std::vector<std::vector<uint8_t>> vec_Fk_X = OTEOPRF::Client(io, client_pp, vec_X, LEN);
+            std::vector<std::vector<uint8_t>> vec_Fk_Y;
+            io.ReceiveBytesVector(vec_Fk_Y);
+            INTERSECTION_LEN = IntersectByOPRFValues(vec_X, ToStrings(vec_Fk_X), ToStrings(vec_Fk_Y)).size();
+        });
+    std::cout << "[" << profile.name << "] OTE-based OPRF PSI: intersection size = " << INTERSECTION_LEN 
+              << " (expected " << LEN/2 << ")" << std::endl;
+    bool flag = (INTERSECTION_LEN == LEN/2);
+
+    auto BlocksToStrings = [](const std::vector<block> &vec_block){
+        std::vector<std::string> vec_str(vec_block.size());
+        for(auto i = 0; i < vec_block.size(); i++) vec_str[i].assign((const char*)&vec_block[i], sizeof(block));
+        return vec_str;
+    };
+    VOLEOPRF::PP vole_pp = VOLEOPRF::Setup(LOG_LEN);
+    RunOverLink(profile, "VOLE-based OPRF PSI",
+        [&](Channel &io){
+            std::vector<uint8_t> key = VOLEOPRF::Server1(io, vole_pp);
+            std::vector<block> vec_Fk_Y = VOLEOPRF::Evaluate1(vole_pp, key, vec_Y, LEN);
+            io.SendBlocks(vec_Fk_Y.data(), LEN);
+        },
+        [&](Channel &io){
+            std::vector<block> vec_Fk_X = VOLEOPRF::Client1(io, vole_pp, vec_X, LEN);
+            std::vector<block> vec_Fk_Y(LEN);
+            io.ReceiveBlocks(vec_Fk_Y.data(), LEN);
+            INTERSECTION_LEN = IntersectByOPRFValues(vec_X, BlocksToStrings(vec_Fk_X), BlocksToStrings(vec_Fk_Y)).size();
+        });
+    std::cout << "[" << profile.name << "] VOLE-based OPRF PSI: intersection size = " << INTERSECTION_LEN 
+              << " (expected " << LEN/2 << ")" << std::endl;
+    flag = flag && (INTERSECTION_LEN == LEN/2);
+    if(!flag) std::cerr << "OPRF-based PSI finds a wrong intersection" << std::endl;
+    return flag;
+}
+
+int main()
+{
+    CRYPTO_Initialize();
+
+    PrintSplitLine('-');
+    std::cout << "network emulation test begins >>>" << std::endl;
+    PrintSplitLine('-');
+
+    size_t LOG_LEN = 16;
+
+    std::string choice;
+    std::cout << "please select the link profile: lan, metro, wan, or custom ==> ";
+    std::getline(std::cin, choice);
+    LinkProfile profile = LINK_LAN;
+    if(choice == "metro") profile = LINK_METRO;
+    if(choice == "wan") profile = LINK_WAN;
+    if(choice == "custom"){
+        profile.name = "custom";
+        std::cout << "bandwidth (Mbps), RTT (ms) and jitter (ms) ==> ";
+        std::cin >> profile.BANDWIDTH_MBPS >> profile.RTT_MS >> profile.JITTER_MS;
+        if(!std::cin || !(profile.BANDWIDTH_MBPS > 0) || profile.RTT_MS < 0 || profile.JITTER_MS < 0){
+            std::cerr << "bandwidth must be positive, RTT and jitter non-negative" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    bool flag = test_emulated_metrics();
+    flag = test_link_profile(profile) && flag;
+    flag = BenchmarkPSIPaths(profile, LOG_LEN) && flag;
+
+    PrintSplitLine('-');
+    std::cout << "network emulation test ends >>>" << std::endl;
+    PrintSplitLine('-');
+
+    CRYPTO_Finalize();
+    return flag ? 0 : EXIT_FAILURE;
+}
@@ -178,6 +178,16 @@ void function_test(size_t MSG_LEN, size_t TRADEOFF_NUM)
         std::cout << "decryption succeeds for right boundary" << std::endl;
     }
 
+    FixedBaseTable pk_table(pk); 
+    BigInt r = GenRandomBigIntLessThan(order); 
+    CT = ExponentialElGamal::Enc(pp, pk_table, m_random, r);
+    if(!(CT == ExponentialElGamal::Enc(pp, pk, m_random, r)) || ExponentialElGamal::Dec(pp, sk, CT) != m_random){ 
+        std::cout << "encryption with the table of pk fails" << std::endl;
+    }
+    else{
+        std::cout << "encryption with the table of pk succeeds" << std::endl;
+    }
+
 }
 
 
@@ -0,0 +1,92 @@
+#include "../crypto/setup.hpp"
+#include "../crypto/prg.hpp"
+#include "../filter/flat_hash_set.hpp"
+#include "../filter/bloom_filter.hpp"
+
+// half of the queries hit the set
+void test_flat_hash_set_25519(size_t LOG_LEN)
+{
+    PrintSplitLine('-');
+    std::cout << "begin the test of flat hash set on EC25519Point >>>" << std::endl;
+    PrintSplitLine('-');
+
+    size_t LEN = size_t(1) << LOG_LEN;
+    PRG::Seed seed = PRG::SetSeed(fixed_seed, 0);
+    std::vector<EC25519Point> vec_Y(LEN), vec_X(LEN);
+    for(auto i = 0; i < LEN; i++){
+        PRG::GenRandomBytes(seed, vec_Y[i].px, 32);
+        if(i % 2 == 0) vec_X[i] = vec_Y[(7*i) % LEN];
+        else PRG::GenRandomBytes(seed, vec_X[i].px, 32);
+    }
+
+    auto start_time = std::chrono::steady_clock::now();
+    std::unordered_set<EC25519Point, EC25519PointHash> S;
+    for(auto i = 0; i < LEN; i++) S.insert(vec_Y[i]);
+    std::vector<uint8_t> vec_expected_bit(LEN);
+    for(auto i = 0; i < LEN; i++) vec_expected_bit[i] = (S.find(vec_X[i]) != S.end());
+    auto end_time = std::chrono::steady_clock::now();
+    auto running_time = end_time - start_time;
+    std::cout << "unordered_set: insert + query #" << LEN << " elements take "
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    start_time = std::chrono::steady_clock::now();
+    BloomFilter filter(LEN, 40);
+    filter.Insert(vec_Y);
+    std::vector<uint8_t> vec_bloom_bit = filter.Contain(vec_X);
+    end_time = std::chrono::steady_clock::now();
+    running_time = end_time - start_time;
+    std::cout << "BloomFilter: insert + query #" << LEN << " elements take "
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    start_time = std::chrono::steady_clock::now();
+    FlatHashSet<32> flat_set(LEN);
+    flat_set.Insert(vec_Y);
+    std::vector<uint8_t> vec_flat_bit = flat_set.Contain(vec_X);
+    end_time = std::chrono::steady_clock::now();
+    running_time = end_time - start_time;
+    std::cout << "FlatHashSet: insert + query #" << LEN << " elements take "
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    if(vec_flat_bit == vec_expected_bit && flat_set.Size() == S.size()) std::cout << "FlatHashSet is correct" << std::endl;
+    else std::cout << "FlatHashSet is wrong" << std::endl;
+}
+
+void test_flat_hash_map_ecpoint(size_t LEN)
+{
+    PrintSplitLine('-');
+    std::cout << "begin the test of flat hash map on ECPoint >>>" << std::endl;
+    PrintSplitLine('-');
+
+    std::vector<ECPoint> vec_A = GenRandomECPointVector(LEN);
+    vec_A[0].SetInfinity();
+    std::vector<unsigned char> keys = ECPointVectorToCompressedKeys(vec_A, 33);
+
+    // map each point to its index, then look the points up one by one
+    FlatHashMap<33, size_t> map;
+    for(auto i = 0; i < LEN; i++) map.Insert(keys.data() + 33*i, i);
+    bool flag = (map.Size() == LEN) && (map.Insert(keys.data(), 0) == false);
+    for(auto i = 0; i < LEN; i++){
+        const size_t *index = map.Find(keys.data() + 33*i);
+        flag = flag && (index != nullptr) && (*index == i);
+    }
+
+    FlatHashSet<33> flat_set;
+    flat_set.Insert(std::vector<ECPoint>(vec_A.begin(), vec_A.begin() + LEN/2));
+    std::vector<uint8_t> vec_bit = flat_set.Contain(vec_A);
+    for(auto i = 0; i < LEN; i++) flag = flag && (vec_bit[i] == (i < LEN/2));
+
+    if(flag) std::cout << "FlatHashMap on ECPoint is correct" << std::endl;
+    else std::cout << "FlatHashMap on ECPoint is wrong" << std::endl;
+}
+
+int main()
+{
+    CRYPTO_Initialize();
+
+    test_flat_hash_set_25519(20);
+
+    test_flat_hash_map_ecpoint(1024*4);
+
+    CRYPTO_Finalize();
+    return 0;
+}
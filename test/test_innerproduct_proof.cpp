@@ -39,10 +39,10 @@ void test_innerproduct_proof()
     InnerProduct::Proof proof; 
 
     auto start_time = std::chrono::steady_clock::now(); // start to count the time
-    std::string transcript_str = ""; 
-    transcript_str += instance.P.ToByteString(); 
+    Transcript transcript; 
+    transcript.Append("P", instance.P); 
 
-    InnerProduct::Prove(pp, instance, witness, transcript_str, proof);
+    InnerProduct::Prove(pp, instance, witness, transcript, proof);
     
     auto end_time = std::chrono::steady_clock::now(); // end to count the time
     auto running_time = end_time - start_time;
@@ -50,18 +50,18 @@ void test_innerproduct_proof()
     << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
 
     start_time = std::chrono::steady_clock::now(); // start to count the time
-    transcript_str = ""; 
-    transcript_str += instance.P.ToByteString(); 
-    InnerProduct::Verify(pp, instance, transcript_str, proof); 
+    transcript = Transcript(); 
+    transcript.Append("P", instance.P); 
+    InnerProduct::Verify(pp, instance, transcript, proof); 
     end_time = std::chrono::steady_clock::now(); // end to count the time
     running_time = end_time - start_time;
     std::cout << "inner-product proof verification takes time = " 
     << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
 
     start_time = std::chrono::steady_clock::now(); // start to count the time
-    transcript_str = ""; 
-    transcript_str += instance.P.ToByteString(); 
-    InnerProduct::FastVerify(pp, instance, transcript_str, proof); 
+    transcript = Transcript(); 
+    transcript.Append("P", instance.P); 
+    InnerProduct::FastVerify(pp, instance, transcript, proof); 
     end_time = std::chrono::steady_clock::now(); // end to count the time
     running_time = end_time - start_time;
     std::cout << "fast inner-product proof verification takes time = " 
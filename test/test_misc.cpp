@@ -1,10 +1,18 @@
 //#define DEBUG
 #include "../crypto/ec_point.hpp"
+#include "../crypto/ec_fixed_base.hpp"
+#include "../crypto/scalar256.hpp"
+#include "../crypto/ec_ristretto.hpp"
 #include "../crypto/prg.hpp"
 #include "../crypto/hash.hpp"
+#include "../crypto/transcript.hpp"
+#include "../crypto/gf128.hpp"
 #include "../utility/print.hpp"
 #include "../crypto/setup.hpp"
 
+// correctness tests that failed, reported through the exit code
+size_t FAILED_TEST_NUM = 0; 
+
 
 void benchmark_ecc(size_t TEST_NUM)
 {
@@ -16,7 +24,6 @@ void benchmark_ecc(size_t TEST_NUM)
     ECPoint B[TEST_NUM]; 
     BigInt k[TEST_NUM];                  // scalars
 
-    ECPoint g = ECPoint(generator); 
     ECPoint pk = GenRandomGenerator(); 
 
     for(auto i = 0; i < TEST_NUM; i++)
@@ -28,7 +35,7 @@ void benchmark_ecc(size_t TEST_NUM)
     
     for(auto i = 0; i < TEST_NUM; i++)
     {
-        A[i] = g * k[i]; 
+        A[i] = GeneratorMul(k[i]); 
     }
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
@@ -63,19 +70,973 @@ void benchmark_ecc(size_t TEST_NUM)
 
 void test_hash_to_point(size_t LEN)
 {
+    // RFC 9380 test vectors (msg = "")
+    bool flag = true; 
+    if (HashToCurve::ENABLE_SSWU){
+        JacobianPoint R; 
+        HashToCurve::HashToP256(R, nullptr, 0, "QUUX-V01-CS02-with-P256_XMD:SHA-256_SSWU_RO_"); 
+        ECPoint P; 
+        ECJacobian::ToECPoint(P.point_ptr, R, GetBNCtx()); 
+        BigInt x, y; 
+        EC_POINT_get_affine_coordinates(group, P.point_ptr, x.bn_ptr, y.bn_ptr, GetBNCtx()); 
+        flag = flag && (x.ToHexString() == "2C15230B26DBC6FC9A37051158C95B79656E17A1A920B11394CA91C44247D3E4"); 
+        flag = flag && (y.ToHexString() == "8A7A74985CC5C776CDFE4B1F19884970453912E9D31528C060BE9AB5C43E8415"); 
+    }
+    // map_to_curve output of curve25519_XMD:SHA-512_ELL2_NU_, before clear_cofactor
+    unsigned char u[32]; 
+    HashToCurve::HashToCurve25519(u, nullptr, 0, 1, "QUUX-V01-CS02-with-curve25519_XMD:SHA-512_ELL2_NU_"); 
+    BigInt u_bn; 
+    BN_lebin2bn(u, 32, u_bn.bn_ptr); 
+    flag = flag && (u_bn.ToHexString() == "51125222DA5E763D97F3C10FCC92EA6860B9CCBBD2EB1285728F566721C1E65B"); 
+
     PRG::Seed seed = PRG::SetSeed(fixed_seed, 0); // initialize PRG
     std::vector<block> vec_M = PRG::GenRandomBlocks(seed, LEN);
-    
+    std::vector<ECPoint> vec_A(LEN); 
 
     auto start_time = std::chrono::steady_clock::now(); 
     #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
     for(auto i = 0; i < LEN; i++){
-        Hash::BlockToECPoint(vec_M[i]); 
+        vec_A[i] = Hash::TryAndIncrementBlockToECPoint(vec_M[i]); 
+    }
+    auto end_time = std::chrono::steady_clock::now(); 
+    auto running_time = end_time - start_time;
+    std::cout << "try-and-increment hash to point takes time = " 
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    start_time = std::chrono::steady_clock::now(); 
+    std::vector<ECPoint> vec_B = Hash::BlocksToECPoints(vec_M); 
+    end_time = std::chrono::steady_clock::now(); 
+    running_time = end_time - start_time;
+    std::cout << "batch hash to point takes time = " 
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    start_time = std::chrono::steady_clock::now(); 
+    std::vector<EC25519Point> vec_C(LEN); 
+    Hash::BlocksToEC25519Points(vec_M.data(), LEN, vec_C.data()); 
+    end_time = std::chrono::steady_clock::now(); 
+    running_time = end_time - start_time;
+    std::cout << "batch hash to curve25519 takes time = " 
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    for (auto i = 0; i < LEN; i++){
+        flag = flag && vec_B[i].IsOnCurve() && (vec_B[i] == Hash::BlockToECPoint(vec_M[i])); 
+    }
+    if (flag) std::cout << "hash to point is correct" << std::endl; 
+    else{
+        std::cout << "hash to point is wrong" << std::endl; 
+        FAILED_TEST_NUM++; 
+    }
+}
+
+void test_multi_scalar_mul(size_t LEN)
+{
+    std::vector<ECPoint> vec_A = GenRandomECPointVector(LEN); 
+    std::vector<BigInt> vec_a = GenRandomBigIntVectorLessThan(LEN, order); 
+    // exercise negative scalars, repeated points and the point at infinity
+    vec_a[0] = -vec_a[0]; 
+    vec_A[1] = vec_A[2]; 
+    vec_A[3].SetInfinity(); 
+
+    auto start_time = std::chrono::steady_clock::now(); 
+    ECPoint naive_result; 
+    CRYPTO_CHECK(1 == EC_POINTs_mul(group, naive_result.point_ptr, nullptr, LEN, 
+                 (const EC_POINT**)vec_A.data(), (const BIGNUM**)vec_a.data(), GetBNCtx()));
+    auto end_time = std::chrono::steady_clock::now(); 
+    auto running_time = end_time - start_time;
+    std::cout << "EC_POINTs_mul with " << LEN << " terms takes time = " 
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    start_time = std::chrono::steady_clock::now(); 
+    ECPoint result = PippengerECPointVectorMul(vec_A.data(), vec_a.data(), LEN); 
+    end_time = std::chrono::steady_clock::now(); 
+    running_time = end_time - start_time;
+    std::cout << "Pippenger MSM with " << LEN << " terms takes time = " 
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    if (result == naive_result) std::cout << "Pippenger MSM result is correct" << std::endl; 
+    else{
+        std::cout << "Pippenger MSM result is wrong" << std::endl; 
+        FAILED_TEST_NUM++; 
+    }
+}
+
+// where PippengerThreshold() comes from: both MSM paths over growing lengths, on one thread and on the full team
+void benchmark_multi_scalar_mul(size_t MAX_LEN)
+{
+    size_t DEFAULT_THREAD_NUM = NUMBER_OF_THREADS; 
+    std::vector<ECPoint> vec_A = GenRandomECPointVector(MAX_LEN); 
+    std::vector<BigInt> vec_a = GenRandomBigIntVectorLessThan(MAX_LEN, order); 
+
+    for (auto THREAD_NUM : {size_t(1), DEFAULT_THREAD_NUM}){
+        SetNumberOfThreads(THREAD_NUM); 
+        std::cout << "MSM crossover with " << THREAD_NUM << " thread(s), threshold = " << PippengerThreshold() << std::endl; 
+        for (size_t LEN = 64; LEN <= MAX_LEN; LEN *= 2){
+            auto start_time = std::chrono::steady_clock::now(); 
+            ECPoint naive_result; 
+            CRYPTO_CHECK(1 == EC_POINTs_mul(group, naive_result.point_ptr, nullptr, LEN, 
+                         (const EC_POINT**)vec_A.data(), (const BIGNUM**)vec_a.data(), GetBNCtx()));
+            auto end_time = std::chrono::steady_clock::now(); 
+            double naive_time = std::chrono::duration <double, std::milli> (end_time - start_time).count(); 
+
+            start_time = std::chrono::steady_clock::now(); 
+            ECPoint result = PippengerECPointVectorMul(vec_A.data(), vec_a.data(), LEN); 
+            end_time = std::chrono::steady_clock::now(); 
+            double pippenger_time = std::chrono::duration <double, std::milli> (end_time - start_time).count(); 
+
+            std::cout << LEN << " terms: EC_POINTs_mul " << naive_time << " ms, Pippenger " << pippenger_time << " ms" << std::endl; 
+            if (result != naive_result) std::cerr << "the two MSM results differ" << std::endl; 
+        }
+        if (THREAD_NUM == DEFAULT_THREAD_NUM) break; 
+    }
+    SetNumberOfThreads(DEFAULT_THREAD_NUM); 
+}
+
+void test_fixed_base_table(size_t LEN)
+{
+    ECPoint A = GenRandomECPoint(); 
+    std::vector<BigInt> vec_a = GenRandomBigIntVectorLessThan(LEN, order); 
+    vec_a[0] = -vec_a[0]; 
+
+    auto start_time = std::chrono::steady_clock::now(); 
+    FixedBaseTable table(A); 
+    auto end_time = std::chrono::steady_clock::now(); 
+    auto running_time = end_time - start_time;
+    std::cout << "building fixed-base table takes time = " 
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    std::vector<ECPoint> vec_naive_result(LEN); 
+    start_time = std::chrono::steady_clock::now(); 
+    for(auto i = 0; i < LEN; i++) vec_naive_result[i] = A * vec_a[i]; 
+    end_time = std::chrono::steady_clock::now(); 
+    running_time = end_time - start_time;
+    std::cout << "variable-base mul takes time = " 
+    << std::chrono::duration <double, std::milli> (running_time).count()/LEN << " ms" << std::endl;
+
+    std::vector<ECPoint> vec_result(LEN); 
+    start_time = std::chrono::steady_clock::now(); 
+    for(auto i = 0; i < LEN; i++) vec_result[i] = table.Mul(vec_a[i]); 
+    end_time = std::chrono::steady_clock::now(); 
+    running_time = end_time - start_time;
+    std::cout << "fixed-base mul takes time = " 
+    << std::chrono::duration <double, std::milli> (running_time).count()/LEN << " ms" << std::endl;
+
+    std::string table_filename = "fixed_base_table.test"; 
+    SaveFixedBaseTable(table, table_filename); 
+    FixedBaseTable loaded_table; 
+    FetchFixedBaseTable(loaded_table, table_filename); 
+    std::remove(table_filename.c_str()); 
+    std::vector<ECPoint> vec_batch_result = loaded_table.MulMany(vec_a); 
+
+    if (vec_result == vec_naive_result && vec_batch_result == vec_naive_result) 
+        std::cout << "fixed-base table results are correct" << std::endl; 
+    else{
+        std::cout << "fixed-base table results are wrong" << std::endl; 
+        FAILED_TEST_NUM++; 
+    }
+}
+
+void test_batch_serialization(size_t LEN)
+{
+    std::vector<ECPoint> vec_A = GenRandomECPointVector(LEN); 
+    vec_A[0].SetInfinity(); 
+    size_t POINT_LEN = ECPointSerializedByteLen(); 
+
+    std::vector<unsigned char> naive_buffer(LEN * POINT_LEN, 0); 
+    auto start_time = std::chrono::steady_clock::now(); 
+    for(auto i = 1; i < LEN; i++){
+        EC_POINT_point2oct(group, vec_A[i].point_ptr, 
+                           (POINT_LEN == POINT_BYTE_LEN) ? POINT_CONVERSION_UNCOMPRESSED : POINT_CONVERSION_COMPRESSED, 
+                           naive_buffer.data() + i*POINT_LEN, POINT_LEN, GetBNCtx()); 
+    }
+    auto end_time = std::chrono::steady_clock::now(); 
+    auto running_time = end_time - start_time;
+    std::cout << "point-by-point serialization takes time = " 
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    start_time = std::chrono::steady_clock::now(); 
+    std::vector<unsigned char> buffer = ECPointVectorToBytes(vec_A); 
+    end_time = std::chrono::steady_clock::now(); 
+    running_time = end_time - start_time;
+    std::cout << "batch serialization takes time = " 
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    std::vector<ECPoint> vec_B = BytesToECPointVector(buffer); 
+    if (buffer == naive_buffer && vec_A == vec_B) std::cout << "batch serialization is correct" << std::endl; 
+    else{
+        std::cout << "batch serialization is wrong" << std::endl; 
+        FAILED_TEST_NUM++; 
+    }
+}
+
+void test_scalar256(size_t LEN)
+{
+    std::vector<BigInt> vec_a = GenRandomBigIntVectorLessThan(LEN, order); 
+    std::vector<BigInt> vec_b = GenRandomBigIntVectorLessThan(LEN, order); 
+    BigInt c = GenRandomBigIntLessThan(order); 
+
+    auto start_time = std::chrono::steady_clock::now(); 
+    std::vector<BigInt> vec_ac = BigIntVectorModScalar(vec_a, c, BigInt(order)); 
+    std::vector<BigInt> vec_inverse = BigIntVectorModInverse(vec_a, BigInt(order)); 
+    BigInt inner_product = BigIntVectorModInnerProduct(vec_a, vec_b, BigInt(order)); 
+    auto end_time = std::chrono::steady_clock::now(); 
+    auto running_time = end_time - start_time;
+    std::cout << "BigInt scalar vector ops take time = " 
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    start_time = std::chrono::steady_clock::now(); 
+    std::vector<BigInt> vec_ac_native = ScalarVectorScalar(vec_a, c); 
+    std::vector<BigInt> vec_inverse_native = ScalarVectorInverse(vec_a); 
+    BigInt inner_product_native = ScalarVectorInnerProduct(vec_a, vec_b); 
+    end_time = std::chrono::steady_clock::now(); 
+    running_time = end_time - start_time;
+    std::cout << "Scalar256 scalar vector ops take time = " 
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    Scalar256 s_c(c); 
+    bool flag = (vec_ac == vec_ac_native) && (vec_inverse == vec_inverse_native) && (inner_product == inner_product_native) 
+             && ((s_c * s_c.Inverse()) == Scalar256(uint64_t(1))) && ((s_c - s_c).IsZero()) 
+             && (Scalar256(-c) == -s_c) && ((s_c + Scalar256(order)).ToBigInt() == c); 
+    if (flag) std::cout << "Scalar256 is correct" << std::endl; 
+    else{
+        std::cout << "Scalar256 is wrong" << std::endl; 
+        FAILED_TEST_NUM++; 
+    }
+}
+
+void test_random_scalar(size_t LEN)
+{
+    auto start_time = std::chrono::steady_clock::now(); 
+    std::vector<BigInt> vec_a(LEN); 
+    for(auto i = 0; i < LEN; i++) vec_a[i] = GenRandomBigIntLessThan(order); 
+    auto end_time = std::chrono::steady_clock::now(); 
+    auto running_time = end_time - start_time;
+    std::cout << "BN_rand_range generates " << LEN << " scalars in " 
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    start_time = std::chrono::steady_clock::now(); 
+    std::vector<BigInt> vec_b = GenRandomBigIntVectorLessThan(LEN, order); 
+    end_time = std::chrono::steady_clock::now(); 
+    running_time = end_time - start_time;
+    std::cout << "PRG sampler generates " << LEN << " BigInt scalars in " 
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    start_time = std::chrono::steady_clock::now(); 
+    std::vector<Scalar256> vec_c = GenRandomScalar256Vector(LEN); 
+    end_time = std::chrono::steady_clock::now(); 
+    running_time = end_time - start_time;
+    std::cout << "PRG sampler generates " << LEN << " Scalar256 scalars in " 
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    // range and distinctness checks, plus a histogram for a tiny modulus
+    std::vector<BigInt> vec_c_bigint = Scalar256VectorToBigIntVector(vec_c); 
+    bool flag = true; 
+    for(auto i = 0; i < LEN; i++){
+        flag = flag && (BN_cmp(vec_b[i].bn_ptr, order) < 0) && !vec_b[i].IsZero() && (vec_c_bigint[i] != vec_b[i]); 
+        if(i > 0) flag = flag && (vec_b[i] != vec_b[i-1]) && (vec_c[i] != vec_c[i-1]); 
+    }
+    std::vector<BigInt> vec_d = GenRandomBigIntVectorLessThan(LEN, BigInt(6)); 
+    std::vector<size_t> histogram(6, 0); 
+    for(auto i = 0; i < LEN; i++) histogram[vec_d[i].ToUint64()]++; 
+    for(auto j = 0; j < 6; j++) flag = flag && (histogram[j] > LEN/6 * 0.9) && (histogram[j] < LEN/6 * 1.1); 
+    if (flag) std::cout << "random scalar sampler is correct" << std::endl; 
+    else{
+        std::cout << "random scalar sampler is wrong" << std::endl; 
+        FAILED_TEST_NUM++; 
+    }
+}
+
+void test_prg_stream(size_t LEN)
+{
+    PRG::Seed seed = PRG::SetSeed(fixed_seed, 0); 
+
+    auto start_time = std::chrono::steady_clock::now(); 
+    std::vector<block> vec_a = PRG::GenRandomBlocks(seed, LEN); 
+    auto end_time = std::chrono::steady_clock::now(); 
+    auto running_time = end_time - start_time;
+    std::cout << "PRG generates " << LEN << " blocks in " 
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    // block i of the stream is Enc(key, i)
+    bool flag = (seed.counter == LEN); 
+    for(auto i = 0; i < LEN; i += LEN/64){
+        block expected = Block::MakeBlock(0LL, i); 
+        AES::Enc(seed.aes_key, expected); 
+        flag = flag && Block::Compare(expected, vec_a[i]); 
+    }
+
+    // sub-streams filled in any order give the sequential output
+    PRG::Seed seed_copy = PRG::SetSeed(fixed_seed, 0); 
+    std::vector<PRG::Seed> vec_seed = PRG::Split(seed_copy, 4, LEN/4); 
+    std::vector<block> vec_b(LEN); 
+    for(int i = 3; i >= 0; i--) PRG::Fill(vec_seed[i], vec_b.data() + i*LEN/4, LEN/4); 
+    flag = flag && Block::Compare(vec_a, vec_b) && (seed_copy.counter == LEN); 
+
+    // seek back into the middle of the stream
+    PRG::Seek(seed_copy, 5); 
+    std::vector<uint8_t> vec_c(33); 
+    PRG::GenRandomBytes(seed_copy, vec_c.data() + 1, 32); // unaligned output
+    flag = flag && (memcmp(vec_c.data() + 1, vec_a.data() + 5, 32) == 0) && (seed_copy.counter == 7); 
+
+    if (flag) std::cout << "PRG stream is correct" << std::endl; 
+    else{
+        std::cout << "PRG stream is wrong" << std::endl; 
+        FAILED_TEST_NUM++; 
+    }
+}
+
+void test_bit_vector(size_t LEN)
+{
+    PRG::Seed seed = PRG::SetSeed(fixed_seed, 0); 
+    std::vector<uint8_t> vec_a = PRG::GenRandomBits(seed, LEN); 
+    std::vector<uint8_t> vec_b = PRG::GenRandomBits(seed, LEN); 
+    BitVector bit_a(vec_a), bit_b(vec_b); 
+
+    size_t count_and = 0, count_xor = 0; 
+    std::vector<size_t> vec_one_index; 
+    for(auto i = 0; i < LEN; i++){
+        count_and += vec_a[i] & vec_b[i]; 
+        count_xor += vec_a[i] ^ vec_b[i]; 
+        if(vec_a[i]) vec_one_index.emplace_back(i); 
+    }
+
+    auto start_time = std::chrono::steady_clock::now(); 
+    size_t count = bit_a.Count(); 
+    auto end_time = std::chrono::steady_clock::now(); 
+    auto running_time = end_time - start_time;
+    std::cout << "BitVector counts " << LEN << " bits in " 
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    std::vector<size_t> vec_visited; 
+    bit_a.ForEachOne([&](size_t i){ vec_visited.emplace_back(i); }); 
+
+    bool flag = (bit_a.ToSparseBytes() == vec_a) && (count == vec_one_index.size()) 
+             && ((bit_a & bit_b).Count() == count_and) && ((bit_a ^ bit_b).Count() == count_xor) 
+             && ((~bit_a).Count() == LEN - count) && ((bit_a | ~bit_a) == BitVector(LEN, true)) 
+             && (vec_visited == vec_one_index) && (bit_a.Select(count/2) == vec_one_index[count/2]) 
+             && (bit_a.Select(count) == LEN); 
+    if (flag) std::cout << "BitVector is correct" << std::endl; 
+    else{
+        std::cout << "BitVector is wrong" << std::endl; 
+        FAILED_TEST_NUM++; 
+    }
+}
+
+// compare every transpose kernel and the fused row hash against the SSE2 routine
+void test_fast_transpose(size_t ROW_NUM)
+{
+    bool flag = true; 
+    for(size_t COLUMN_NUM : {128, 256}){
+        PRG::Seed seed = PRG::SetSeed(fixed_seed, 0); 
+        std::vector<block> T = PRG::GenRandomBlocks(seed, ROW_NUM/128*COLUMN_NUM); 
+
+        std::vector<block> T_expected(ROW_NUM/128*COLUMN_NUM); 
+        BitMatrixTranspose((uint8_t*)T.data(), COLUMN_NUM, ROW_NUM, (uint8_t*)T_expected.data()); 
+
+        std::vector<block> T_transpose(ROW_NUM/128*COLUMN_NUM); 
+        FastBitMatrixTranspose(T.data(), COLUMN_NUM, ROW_NUM, T_transpose.data()); 
+        flag = flag && (memcmp(T_transpose.data(), T_expected.data(), ROW_NUM/8*COLUMN_NUM) == 0); 
+
+        std::vector<TransposeTileFunction> vec_kernel = {TransposeTileSSE2}; 
+        if (__builtin_cpu_supports("avx2")) vec_kernel.emplace_back(TransposeTileAVX2); 
+        if (__builtin_cpu_supports("avx512bw")) vec_kernel.emplace_back(TransposeTileAVX512); 
+        for(auto TransposeTile : vec_kernel){
+            std::fill(T_transpose.begin(), T_transpose.end(), Block::zero_block); 
+            for(auto t = 0; t < ROW_NUM/128; t++) 
+                TransposeTileRow(TransposeTile, T.data(), COLUMN_NUM, ROW_NUM, t, T_transpose.data() + t*COLUMN_NUM); 
+            flag = flag && (memcmp(T_transpose.data(), T_expected.data(), ROW_NUM/8*COLUMN_NUM) == 0); 
+        }
+
+        std::vector<block> vec_digest(ROW_NUM); 
+        FastBitMatrixTransposeRows(T.data(), COLUMN_NUM, ROW_NUM, [&](size_t ROW_BEGIN, block *rows){
+            Hash::FastBlocksToBlock(rows, 128, COLUMN_NUM/128, vec_digest.data() + ROW_BEGIN); 
+        }); 
+        for(auto i = 0; i < ROW_NUM; i += 997){
+            std::vector<block> row(T_expected.begin() + i*COLUMN_NUM/128, T_expected.begin() + (i+1)*COLUMN_NUM/128); 
+            flag = flag && Block::Compare(vec_digest[i], Hash::FastBlocksToBlock(row)); 
+        }
+    }
+    if (flag) std::cout << "tiled transpose is correct" << std::endl; 
+    else{
+        std::cout << "tiled transpose is wrong" << std::endl; 
+        FAILED_TEST_NUM++; 
+    }
+}
+
+void benchmark_fast_transpose(size_t ROW_NUM)
+{
+    for(size_t COLUMN_NUM : {128, 256}){
+        PRG::Seed seed = PRG::SetSeed(fixed_seed, 0); 
+        std::vector<block> T = PRG::GenRandomBlocks(seed, ROW_NUM/128*COLUMN_NUM); 
+        std::vector<block> T_transpose(ROW_NUM/128*COLUMN_NUM); 
+
+        auto start_time = std::chrono::steady_clock::now(); 
+        BitMatrixTranspose((uint8_t*)T.data(), COLUMN_NUM, ROW_NUM, (uint8_t*)T_transpose.data()); 
+        auto end_time = std::chrono::steady_clock::now(); 
+        auto running_time = end_time - start_time;
+        std::cout << "SSE2 transpose of " << ROW_NUM << "x" << COLUMN_NUM << " bits takes " 
+        << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+        start_time = std::chrono::steady_clock::now(); 
+        FastBitMatrixTranspose(T.data(), COLUMN_NUM, ROW_NUM, T_transpose.data()); 
+        end_time = std::chrono::steady_clock::now(); 
+        running_time = end_time - start_time;
+        std::cout << "tiled transpose of " << ROW_NUM << "x" << COLUMN_NUM << " bits takes " 
+        << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+    }
+}
+
+// check the batched CR hashes against single block AES
+void test_cr_hash(size_t LEN)
+{
+    PRG::Seed seed = PRG::SetSeed(fixed_seed, 0); 
+    std::vector<block> vec_X = PRG::GenRandomBlocks(seed, LEN); 
+    std::vector<block> vec_H(LEN), vec_TH(LEN); 
+    Hash::CRHashBlocks(vec_X.data(), vec_H.data(), LEN); 
+    Hash::TCRHashBlocks(vec_X.data(), vec_TH.data(), LEN, 5); 
+
+    bool flag = true; 
+    for(auto i = 0; i < LEN; i += 101){
+        block pi_x = vec_X[i]; 
+        AES::Enc(AES::fixed_enc_key, pi_x); 
+        block expected_TH = pi_x^Block::MakeBlock(0, 5 + i); 
+        AES::Enc(AES::fixed_enc_key, expected_TH); 
+        flag = flag && Block::Compare(vec_H[i], pi_x^vec_X[i]) && Block::Compare(vec_TH[i], expected_TH^pi_x); 
+    }
+    // in place, and rows of one block are hashed like single blocks
+    std::vector<block> vec_Y = vec_X; 
+    Hash::TCRHashBlocks(vec_Y.data(), vec_Y.data(), LEN, 5); 
+    std::vector<block> vec_row_digest(LEN); 
+    Hash::TCRHashRows(vec_X.data(), LEN, 1, vec_row_digest.data(), 5); 
+    flag = flag && Block::Compare(vec_Y, vec_TH) && Block::Compare(vec_row_digest, vec_TH); 
+
+    if (flag) std::cout << "CR hash is correct" << std::endl; 
+    else{
+        std::cout << "CR hash is wrong" << std::endl; 
+        FAILED_TEST_NUM++; 
+    }
+}
+
+// time the batched CR hashes against the per-row hash
+void benchmark_cr_hash(size_t LEN)
+{
+    PRG::Seed seed = PRG::SetSeed(fixed_seed, 0); 
+    std::vector<block> vec_X = PRG::GenRandomBlocks(seed, LEN); 
+    std::vector<block> vec_H(LEN); 
+
+    auto start_time = std::chrono::steady_clock::now(); 
+    for(auto i = 0; i < LEN; i++) vec_H[i] = Hash::FastBlocksToBlock(std::vector<block>{vec_X[i]}); 
+    auto end_time = std::chrono::steady_clock::now(); 
+    auto running_time = end_time - start_time;
+    std::cout << "per-row FastBlocksToBlock on " << LEN << " blocks takes " 
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    start_time = std::chrono::steady_clock::now(); 
+    Hash::CRHashBlocks(vec_X.data(), vec_H.data(), LEN); 
+    end_time = std::chrono::steady_clock::now(); 
+    running_time = end_time - start_time;
+    std::cout << "CRHashBlocks on " << LEN << " blocks takes " 
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    start_time = std::chrono::steady_clock::now(); 
+    Hash::TCRHashBlocks(vec_X.data(), vec_H.data(), LEN, 5); 
+    end_time = std::chrono::steady_clock::now(); 
+    running_time = end_time - start_time;
+    std::cout << "TCRHashBlocks on " << LEN << " blocks takes " 
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+}
+
+// every multi-buffer backend this CPU supports must agree with one SHA256 call per input
+std::vector<MultiSHA256::Backend> SupportedHashManyBackends()
+{
+    std::vector<MultiSHA256::Backend> vec_backend = {MultiSHA256::OPENSSL}; 
+    if(__builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1")) vec_backend.push_back(MultiSHA256::SHANI); 
+    if(__builtin_cpu_supports("avx2")) vec_backend.push_back(MultiSHA256::AVX2); 
+    if(__builtin_cpu_supports("avx512f")) vec_backend.push_back(MultiSHA256::AVX512); 
+    return vec_backend; 
+}
+
+void test_hash_many(size_t LEN)
+{
+    const size_t HASH_INPUT_LEN = 33; 
+    PRG::Seed seed = PRG::SetSeed(fixed_seed, 0); 
+    std::vector<unsigned char> input(LEN * HASH_INPUT_LEN); 
+    PRG::GenRandomBytes(seed, input.data(), input.size()); 
+
+    std::vector<unsigned char> expected_digest(LEN * HASH_OUTPUT_LEN), digest(LEN * HASH_OUTPUT_LEN); 
+    for(auto i = 0; i < LEN; i++) SHA256(input.data() + i*HASH_INPUT_LEN, HASH_INPUT_LEN, expected_digest.data() + i*HASH_OUTPUT_LEN); 
+
+    bool flag = true; 
+    for(auto b : SupportedHashManyBackends()){
+        MultiSHA256::HashMany(input.data(), HASH_INPUT_LEN, LEN, digest.data(), b); 
+        flag = flag && (digest == expected_digest); 
+    }
+
+    // BLAKE3 digests of "" and "abc"
+    unsigned char blake3_digest[BLAKE3::OUTPUT_LEN]; 
+    auto ToHex = [](const unsigned char *bytes, size_t LEN){
+        char hex[3]; std::string str; 
+        for(auto i = 0; i < LEN; i++){ snprintf(hex, 3, "%02x", bytes[i]); str += hex; }
+        return str; 
+    }; 
+    BLAKE3::Hash((const unsigned char*)"", 0, blake3_digest); 
+    flag = flag && (ToHex(blake3_digest, 32) == "af1349b9f5f9a1a6a0404dea36dcc9499bcb25c9adc112b7cc9a93cae41f3262"); 
+    BLAKE3::Hash((const unsigned char*)"abc", 3, blake3_digest); 
+    flag = flag && (ToHex(blake3_digest, 32) == "6437b3ac38465133ffb63b75273a8db548c558465d79db03fd359c6cd5bd9d85"); 
+
+    // official BLAKE3 test vectors: input byte i is i mod 251, lengths around chunk and tree boundaries
+    std::vector<std::pair<size_t, std::string>> vec_blake3_vector = {
+        {1023, "10108970eeda3eb932baac1428c7a2163b0e924c9a9e25b35bba72b28f70bd11"}, 
+        {1024, "42214739f095a406f3fc83deb889744ac00df831c10daa55189b5d121c855af7"}, 
+        {1025, "d00278ae47eb27b34faecf67b4fe263f82d5412916c1ffd97c8cb7fb814b8444"}, 
+        {2048, "e776b6028c7cd22a4d0ba182a8bf62205d2ef576467e838ed6f2529b85fba24a"}, 
+        {2049, "5f4d72f40d7a5f82b15ca2b2e44b1de3c2ef86c426c95c1af0b6879522563030"}, 
+        {8193, "bab6c09cb8ce8cf459261398d2e7aef35700bf488116ceb94a36d0f5f1b7bc3b"}, 
+        {102400, "bc3e3d41a1146b069abffad3c0d44860cf664390afce4d9661f7902e7943e085"}
+    }; 
+    for(auto &test_vector : vec_blake3_vector){
+        std::vector<unsigned char> blake3_input(test_vector.first); 
+        for(auto i = 0; i < blake3_input.size(); i++) blake3_input[i] = i % 251; 
+        BLAKE3::Hash(blake3_input.data(), blake3_input.size(), blake3_digest); 
+        flag = flag && (ToHex(blake3_digest, 32) == test_vector.second); 
+    }
+
+    // the batch point hashes agree with the single ones
+    std::vector<ECPoint> vec_A = GenRandomECPointVector(256); 
+    std::vector<block> vec_block(vec_A.size()); 
+    Hash::ECPointsToBlocks(vec_A.data(), vec_A.size(), vec_block.data()); 
+    for(auto i = 0; i < vec_A.size(); i++) flag = flag && Block::Compare(vec_block[i], Hash::ECPointToBlock(vec_A[i])); 
+
+    if (flag) std::cout << "HashMany is correct" << std::endl; 
+    else{
+        std::cout << "HashMany is wrong" << std::endl; 
+        FAILED_TEST_NUM++; 
+    }
+}
+
+void benchmark_hash_many(size_t LEN)
+{
+    const size_t HASH_INPUT_LEN = 33; 
+    PRG::Seed seed = PRG::SetSeed(fixed_seed, 0); 
+    std::vector<unsigned char> input(LEN * HASH_INPUT_LEN); 
+    PRG::GenRandomBytes(seed, input.data(), input.size()); 
+    std::vector<unsigned char> digest(LEN * HASH_OUTPUT_LEN); 
+
+    auto start_time = std::chrono::steady_clock::now(); 
+    for(auto i = 0; i < LEN; i++) SHA256(input.data() + i*HASH_INPUT_LEN, HASH_INPUT_LEN, digest.data() + i*HASH_OUTPUT_LEN); 
+    auto end_time = std::chrono::steady_clock::now(); 
+    auto running_time = end_time - start_time;
+    std::cout << "per-input SHA256 on " << LEN << " inputs takes " 
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    for(auto b : SupportedHashManyBackends()){
+        start_time = std::chrono::steady_clock::now(); 
+        MultiSHA256::HashMany(input.data(), HASH_INPUT_LEN, LEN, digest.data(), b); 
+        end_time = std::chrono::steady_clock::now(); 
+        running_time = end_time - start_time;
+        std::cout << "HashMany (" << MultiSHA256::BackendName(b) << ") on " << LEN << " inputs takes " 
+        << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+    }
+}
+
+void test_transcript(size_t ROUND_NUM)
+{
+    std::vector<ECPoint> vec_A = GenRandomECPointVector(2*ROUND_NUM); 
+
+    Transcript transcript; 
+    std::vector<BigInt> vec_x(ROUND_NUM); 
+    for(auto i = 0; i < ROUND_NUM; i++){
+        transcript.Append("L", vec_A[2*i]); 
+        transcript.Append("R", vec_A[2*i+1]); 
+        vec_x[i] = transcript.Challenge("x"); 
+    }
+
+    // the verifier replays the same challenges
+    Transcript replay; 
+    bool flag = true; 
+    for(auto i = 0; i < ROUND_NUM; i++){
+        replay.Append("L", vec_A[2*i]); 
+        replay.Append("R", vec_A[2*i+1]); 
+        flag = flag && (replay.Challenge("x") == vec_x[i]); 
+    }
+
+    // successive challenges differ, and so do challenges under other labels or in other forks
+    Transcript left = replay.Fork("left"), right = replay.Fork("right"); 
+    BigInt x1 = replay.Challenge("x"), x2 = replay.Challenge("x"); 
+    flag = flag && (x1 != x2) && (left.Challenge("x") != right.Challenge("x")); 
+    Transcript other_label("other protocol"); 
+    other_label.Append("L", vec_A[0]); 
+    other_label.Append("R", vec_A[1]); 
+    flag = flag && (other_label.Challenge("x") != vec_x[0]); 
+
+    if (flag) std::cout << "Transcript is correct" << std::endl; 
+    else{
+        std::cout << "Transcript is wrong" << std::endl; 
+        FAILED_TEST_NUM++; 
+    }
+}
+
+void benchmark_transcript(size_t ROUND_NUM)
+{
+    std::vector<ECPoint> vec_A = GenRandomECPointVector(2*ROUND_NUM); 
+
+    // the old way: rehash the whole transcript string for every challenge
+    auto start_time = std::chrono::steady_clock::now(); 
+    std::string transcript_str; 
+    for(auto i = 0; i < ROUND_NUM; i++){
+        transcript_str += vec_A[2*i].ToByteString() + vec_A[2*i+1].ToByteString(); 
+        Hash::StringToBigInt(transcript_str); 
+    }
+    auto end_time = std::chrono::steady_clock::now(); 
+    auto running_time = end_time - start_time;
+    std::cout << "string transcript: " << ROUND_NUM << " challenges take " 
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    start_time = std::chrono::steady_clock::now(); 
+    Transcript transcript; 
+    for(auto i = 0; i < ROUND_NUM; i++){
+        transcript.Append("L", vec_A[2*i]); 
+        transcript.Append("R", vec_A[2*i+1]); 
+        transcript.Challenge("x"); 
+    }
+    end_time = std::chrono::steady_clock::now(); 
+    running_time = end_time - start_time;
+    std::cout << "Transcript: " << ROUND_NUM << " challenges take " 
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+}
+
+void test_block_kernels(size_t LEN)
+{
+    PRG::Seed seed = PRG::SetSeed(fixed_seed, 0); 
+    std::vector<block> vec_a = PRG::GenRandomBlocks(seed, LEN); 
+    std::vector<block> vec_b = PRG::GenRandomBlocks(seed, LEN); 
+    for(auto i = 0; i < LEN; i += 3) vec_b[i] = vec_a[i]; 
+    block c = vec_a[1]; 
+
+    std::vector<block> vec_xor(LEN), vec_and(LEN), vec_scalar(LEN); 
+    std::vector<uint8_t> vec_mask(LEN); 
+    Block::XorInto(vec_xor.data(), vec_a.data(), vec_b.data(), LEN); 
+    Block::AndInto(vec_and.data(), vec_a.data(), vec_b.data(), LEN); 
+    Block::XorScalarInto(vec_scalar.data(), vec_a.data(), c, LEN); 
+    Block::EqualMask(vec_mask.data(), vec_a.data(), vec_b.data(), LEN); 
+
+    bool flag = true; 
+    for(auto i = 0; i < LEN; i++){
+        flag = flag && Block::Compare(vec_xor[i], vec_a[i]^vec_b[i]) && Block::Compare(vec_and[i], vec_a[i]&vec_b[i]) 
+                    && Block::Compare(vec_scalar[i], vec_a[i]^c) && (vec_mask[i] == Block::Compare(vec_a[i], vec_b[i])); 
+    }
+    // in place, on a short odd-length span
+    std::vector<block> vec_c(vec_a.begin(), vec_a.begin() + 7); 
+    Block::XorInto(vec_c.data(), vec_c.data(), vec_b.data(), 7); 
+    for(auto i = 0; i < 7; i++) flag = flag && Block::Compare(vec_c[i], vec_xor[i]); 
+
+    // every EqualMask kernel this CPU supports, not only the dispatched one
+    std::vector<void(*)(uint8_t*, const block*, const block*, size_t)> vec_equal_kernel = {Block::EqualMaskSSE2}; 
+    if (__builtin_cpu_supports("sse4.1")) vec_equal_kernel.emplace_back(Block::EqualMaskSSE4); 
+    if (__builtin_cpu_supports("avx2")) vec_equal_kernel.emplace_back(Block::EqualMaskAVX2); 
+    if (__builtin_cpu_supports("avx512f")) vec_equal_kernel.emplace_back(Block::EqualMaskAVX512); 
+    for(auto EqualMaskKernel : vec_equal_kernel){
+        std::vector<uint8_t> vec_kernel_mask(LEN); 
+        EqualMaskKernel(vec_kernel_mask.data(), vec_a.data(), vec_b.data(), LEN); 
+        flag = flag && (vec_kernel_mask == vec_mask); 
+    }
+
+    if (flag) std::cout << "block kernels are correct" << std::endl; 
+    else{
+        std::cout << "block kernels are wrong" << std::endl; 
+        FAILED_TEST_NUM++; 
+    }
+}
+
+void benchmark_block_kernels(size_t LEN)
+{
+    PRG::Seed seed = PRG::SetSeed(fixed_seed, 0); 
+    std::vector<block> vec_a = PRG::GenRandomBlocks(seed, LEN); 
+    std::vector<block> vec_b = PRG::GenRandomBlocks(seed, LEN); 
+    std::vector<block> vec_xor(LEN); 
+
+    // many short calls, as in the column loops of OT extension
+    const size_t SPAN_LEN = 64; 
+    auto start_time = std::chrono::steady_clock::now(); 
+    for(auto i = 0; i + SPAN_LEN <= LEN; i += SPAN_LEN){
+        std::vector<block> vec_span_a(vec_a.begin() + i, vec_a.begin() + i + SPAN_LEN); 
+        std::vector<block> vec_span_b(vec_b.begin() + i, vec_b.begin() + i + SPAN_LEN); 
+        std::vector<block> vec_span_xor = Block::XOR(vec_span_a, vec_span_b); 
+        memcpy(vec_xor.data() + i, vec_span_xor.data(), SPAN_LEN*16); 
+    }
+    auto end_time = std::chrono::steady_clock::now(); 
+    auto running_time = end_time - start_time;
+    std::cout << "copy + XOR on " << LEN/SPAN_LEN << " spans of " << SPAN_LEN << " blocks takes " 
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    start_time = std::chrono::steady_clock::now(); 
+    for(auto i = 0; i + SPAN_LEN <= LEN; i += SPAN_LEN) Block::XorInto(vec_xor.data() + i, vec_a.data() + i, vec_b.data() + i, SPAN_LEN); 
+    end_time = std::chrono::steady_clock::now(); 
+    running_time = end_time - start_time;
+    std::cout << "XorInto on " << LEN/SPAN_LEN << " spans of " << SPAN_LEN << " blocks takes " 
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+}
+
+void test_gf128(size_t LEN)
+{
+    // schoolbook reference: shift-and-add, reducing x^128 = x^7 + x^2 + x + 1 bit by bit
+    auto NaiveMul = [](block x, block y){
+        uint64_t a[2], b[2], r[2] = {0, 0}; 
+        memcpy(a, &x, 16); memcpy(b, &y, 16); 
+        for(auto i = 0; i < 128; i++){
+            if((b[i/64] >> (i%64)) & 1){ r[0] ^= a[0]; r[1] ^= a[1]; }
+            uint64_t carry = a[1] >> 63; 
+            a[1] = (a[1] << 1) | (a[0] >> 63); 
+            a[0] = (a[0] << 1) ^ (carry * 0x87); 
+        }
+        return Block::MakeBlock(r[1], r[0]); 
+    }; 
+
+    PRG::Seed seed = PRG::SetSeed(fixed_seed, 0); 
+    std::vector<block> vec_a = PRG::GenRandomBlocks(seed, LEN); 
+    std::vector<block> vec_b = PRG::GenRandomBlocks(seed, LEN); 
+    vec_a[2] = Block::zero_block; 
+    block c = vec_b[0]; 
+    const block one = Block::MakeBlock(0, 1); 
+
+    std::vector<block> vec_mul(LEN), vec_scalar(LEN), vec_inv(LEN), vec_add(vec_b); 
+    GF128::Mul(vec_mul.data(), vec_a.data(), vec_b.data(), LEN); 
+    GF128::ScalarMul(vec_scalar.data(), vec_a.data(), c, LEN); 
+    GF128::ScalarMulAdd(vec_add.data(), vec_a.data(), c, LEN); 
+    GF128::BatchInv(vec_inv.data(), vec_a.data(), LEN); 
+
+    bool flag = true; 
+    block inner_product = Block::zero_block; 
+    for(auto i = 0; i < LEN; i++){
+        block product = NaiveMul(vec_a[i], vec_b[i]); 
+        inner_product ^= product; 
+        flag = flag && Block::Compare(vec_mul[i], product) && Block::Compare(vec_scalar[i], NaiveMul(vec_a[i], c)) 
+                    && Block::Compare(vec_add[i], vec_b[i]^vec_scalar[i]); 
+        if(Block::Compare(vec_a[i], Block::zero_block)) flag = flag && Block::Compare(vec_inv[i], Block::zero_block); 
+        else flag = flag && Block::Compare(GF128::Mul(vec_inv[i], vec_a[i]), one); 
     }
+    flag = flag && Block::Compare(GF128::InnerProduct(vec_a.data(), vec_b.data(), LEN), inner_product); 
+    flag = flag && Block::Compare(GF128::Mul(GF128::Inv(c), c), one); 
+
+    // gadget vector g = (1, x, ..., x^127)
+    std::vector<block> vec_gadget(128); 
+    for(auto i = 0; i < 128; i++) vec_gadget[i] = (i < 64) ? Block::MakeBlock(0, 1ULL << i) : Block::MakeBlock(1ULL << (i-64), 0); 
+    flag = flag && Block::Compare(GF128::GadgetInnerProduct(vec_b.data()), GF128::InnerProduct(vec_gadget.data(), vec_b.data(), 128)); 
+
+    // dense row of OKVS: sum of a[j]*d^{j+1}, for 13 evaluation points
+    const size_t DENSE_LEN = 40, POINT_NUM = 13; 
+    std::vector<block> vec_eval(vec_b.begin(), vec_b.begin() + POINT_NUM); 
+    GF128::PowerInnerProduct(vec_eval.data(), vec_a.data(), vec_b.data() + 1, POINT_NUM, DENSE_LEN); 
+    for(auto k = 0; k < POINT_NUM; k++){
+        block d = vec_b[k+1], d_j = d, expect = vec_b[k]; 
+        for(auto j = 0; j < DENSE_LEN; j++){
+            expect ^= NaiveMul(vec_a[j], d_j); 
+            d_j = NaiveMul(d_j, d); 
+        }
+        flag = flag && Block::Compare(vec_eval[k], expect); 
+    }
+
+    block sum = Block::zero_block; 
+    for(auto i = 0; i < LEN; i++) sum ^= GF128::Mul(vec_a[i], vec_b[i]); 
+    flag = flag && Block::Compare(sum, GF128::InnerProduct(vec_a.data(), vec_b.data(), LEN)); 
+
+    if (flag) std::cout << "GF(2^128) arithmetic is correct" << std::endl; 
+    else{
+        std::cout << "GF(2^128) arithmetic is wrong" << std::endl; 
+        FAILED_TEST_NUM++; 
+    }
+}
+
+// one reduction per product vs one reduction per inner product
+void benchmark_gf128(size_t LEN)
+{
+    PRG::Seed seed = PRG::SetSeed(fixed_seed, 0); 
+    std::vector<block> vec_a = PRG::GenRandomBlocks(seed, LEN); 
+    std::vector<block> vec_b = PRG::GenRandomBlocks(seed, LEN); 
+
+    auto start_time = std::chrono::steady_clock::now(); 
+    block sum = Block::zero_block; 
+    for(auto i = 0; i < LEN; i++) sum ^= GF128::Mul(vec_a[i], vec_b[i]); 
+    auto end_time = std::chrono::steady_clock::now(); 
+    auto running_time = end_time - start_time;
+    std::cout << "inner product of " << LEN << " elements by single multiplications takes " 
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    start_time = std::chrono::steady_clock::now(); 
+    block lazy_sum = GF128::InnerProduct(vec_a.data(), vec_b.data(), LEN); 
+    end_time = std::chrono::steady_clock::now(); 
+    running_time = end_time - start_time;
+    std::cout << "inner product of " << LEN << " elements with lazy reduction takes " 
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+    // use both sums so that neither loop is optimized away
+    if (!Block::Compare(sum, lazy_sum)) std::cerr << "the two inner products differ" << std::endl; 
+}
+
+// a mix of fixed-width ids (equal-length runs) and emails of varying length, some with \r\n endings
+std::vector<std::string> WriteRecordFile(const std::string &filename, size_t LEN)
+{
+    std::ofstream fout(filename, std::ios::binary); 
+    std::vector<std::string> vec_record(LEN); 
+    for(auto i = 0; i < LEN; i++){
+        if(i % 1000 < 600) vec_record[i] = "+86" + std::to_string(13000000000 + i); 
+        else vec_record[i] = "user" + std::to_string(size_t(i) * 7919 % 100003) + "@example.com"; 
+        if(i % 4999 == 0) vec_record[i] = ""; 
+        std::string line = vec_record[i] + ((i % 3 == 0) ? "\r\n" : "\n"); 
+        // not operator<<, which serialization.hpp overloads for binary files
+        fout.write(line.data(), line.size()); 
+    }
+    fout.close(); 
+    return vec_record; 
+}
+
+// the old way: one std::string per line, hashed one by one
+std::vector<block> LoadLinesAsBlocks(const std::string &filename)
+{
+    std::ifstream fin(filename, std::ios::binary); 
+    std::vector<std::string> vec_line; 
+    for(std::string line; std::getline(fin, line); ){
+        if(!line.empty() && line.back() == '\r') line.pop_back(); 
+        vec_line.emplace_back(line); 
+    }
+    fin.close(); 
+    std::vector<block> vec_digest(vec_line.size()); 
+    for(auto i = 0; i < vec_line.size(); i++) vec_digest[i] = Hash::StringToBlock(vec_line[i]); 
+    return vec_digest; 
+}
+
+void test_records_to_blocks(size_t LEN)
+{
+    std::string filename = "records.test"; 
+    std::vector<std::string> vec_record = WriteRecordFile(filename, LEN); 
+    RecordBatch batch = LoadRecordBatch(filename); 
+    std::vector<block> vec_fast = Hash::RecordsToBlocks(batch); 
+    std::vector<block> vec_slow = LoadLinesAsBlocks(filename); 
+    std::remove(filename.c_str()); 
+
+    bool flag = (batch.Size() == LEN) && (vec_slow.size() == LEN); 
+    for(auto i = 0; flag && i < LEN; i++){
+        flag = (batch[i] == vec_record[i]) && Block::Compare(vec_fast[i], vec_slow[i]); 
+    }
+
+    if (flag) std::cout << "RecordsToBlocks is correct" << std::endl; 
+    else{
+        std::cout << "RecordsToBlocks is wrong" << std::endl; 
+        FAILED_TEST_NUM++; 
+    }
+}
+
+void benchmark_records_to_blocks(size_t LEN)
+{
+    std::string filename = "records.test"; 
+    WriteRecordFile(filename, LEN); 
+
+    auto start_time = std::chrono::steady_clock::now(); 
+    RecordBatch batch = LoadRecordBatch(filename); 
+    std::vector<block> vec_fast = Hash::RecordsToBlocks(batch); 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "hash to point takes time = " 
+    std::cout << "loading and hashing " << LEN << " records via RecordBatch takes " 
+    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    start_time = std::chrono::steady_clock::now(); 
+    std::vector<block> vec_slow = LoadLinesAsBlocks(filename); 
+    end_time = std::chrono::steady_clock::now(); 
+    running_time = end_time - start_time;
+    std::cout << "loading and hashing " << LEN << " records via std::string takes " 
     << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+    std::remove(filename.c_str()); 
+}
+
+void test_ristretto(size_t LEN)
+{
+    // RFC 9496 test vectors: multiples of the generator and hash-to-group
+    std::vector<std::string> vec_multiple_hex = {
+        "0000000000000000000000000000000000000000000000000000000000000000", 
+        "e2f2ae0a6abc4e71a884a961c500515f58e30b6aa582dd8db6a65945e08d2d76", 
+        "6a493210f7499cd17fecb510ae0cea23a110e8d5b901f8acadd3095c73a3b919", 
+        "94741f5d5d52755ece4f23f044ee27d5d1ea1e2bd196b462166b16152a9d0259"
+    }; 
+    bool flag = true; 
+    RistrettoPoint P = ristretto_generator * BigInt(size_t(2)); 
+    for (auto k = 0; k < vec_multiple_hex.size(); k++){
+        flag = flag && ((ristretto_generator * BigInt(size_t(k))).ToHexString() == vec_multiple_hex[k]); 
+        flag = flag && (RistrettoGeneratorMul(BigInt(size_t(k))).ToHexString() == vec_multiple_hex[k]); 
+    }
+    std::string uniform_hex = "5d1be09e3d0c82fc538112490e35701979d99e06ca3e2b5b54bffe8b4dc772c1"
+                              "4d98b696a1bbfb5ca32c436cc61c16563790306c79eaca7705668b47dffe5bb6"; 
+    unsigned char uniform_bytes[64]; 
+    for (auto i = 0; i < 64; i++) uniform_bytes[i] = std::stoi(uniform_hex.substr(2*i, 2), nullptr, 16); 
+    RistrettoPoint H; 
+    H.FromUniformBytes(uniform_bytes); 
+    flag = flag && (H.ToHexString() == "3066f82a1a747d45120d1740f14358531a8f04bbffe6a819f86dfe50f44a0a46"); 
+
+    // group laws against the fixed-base path
+    BigInt a = GenRandomBigIntLessThan(ristretto_order); 
+    BigInt b = GenRandomBigIntLessThan(ristretto_order); 
+    RistrettoPoint Q = GenRandomRistrettoPoint(); 
+    flag = flag && (P * a == RistrettoGeneratorMul(a * BigInt(size_t(2)))); 
+    flag = flag && (Q * a + Q * b == Q * (a + b)) && (Q * a - Q * a).IsAtInfinity(); 
+    // Mul reduces the scalar mod the order, so Q * order would only test Q * 0: go through order-1 instead
+    RistrettoPoint Q_order_minus_one = Q * (BigInt(ristretto_order) - bn_1); 
+    flag = flag && !Q_order_minus_one.IsAtInfinity() && (Q_order_minus_one + Q).IsAtInfinity() && (Q * (-a) == -(Q * a)); 
+
+    std::vector<RistrettoPoint> vec_A = GenRandomRistrettoPointVector(LEN); 
+    std::vector<unsigned char> buffer(LEN * RISTRETTO_POINT_BYTE_LEN); 
+    RistrettoPointVectorToBytes(vec_A.data(), LEN, buffer.data()); 
+    std::vector<RistrettoPoint> vec_B(LEN); 
+    BytesToRistrettoPointVector(buffer.data(), LEN, vec_B.data()); 
+    flag = flag && (vec_A == vec_B); 
+
+    if (flag) std::cout << "ristretto255 is correct" << std::endl; 
+    else{
+        std::cout << "ristretto255 is wrong" << std::endl; 
+        FAILED_TEST_NUM++; 
+    }
+
+    std::vector<BigInt> vec_a = GenRandomBigIntVectorLessThan(LEN, ristretto_order); 
+    auto start_time = std::chrono::steady_clock::now(); 
+    for (auto i = 0; i < LEN; i++) vec_B[i] = vec_A[i] * vec_a[i]; 
+    auto end_time = std::chrono::steady_clock::now(); 
+    auto running_time = end_time - start_time;
+    std::cout << "average ristretto255 variable-base mul takes time = " 
+    << std::chrono::duration <double, std::milli> (running_time).count()/LEN << " ms" << std::endl;
+
+    start_time = std::chrono::steady_clock::now(); 
+    for (auto i = 0; i < LEN; i++) vec_B[i] = RistrettoGeneratorMul(vec_a[i]); 
+    end_time = std::chrono::steady_clock::now(); 
+    running_time = end_time - start_time;
+    std::cout << "average ristretto255 fixed-base mul takes time = " 
+    << std::chrono::duration <double, std::milli> (running_time).count()/LEN << " ms" << std::endl;
+}
+
+// run EC operations from threads that openmp knows nothing about
+void test_foreign_threads(size_t THREAD_NUM)
+{
+    ECPoint A = GenRandomECPoint(); 
+    BigInt a = GenRandomBigIntLessThan(order); 
+    ECPoint expected_result = A * a; 
+
+    size_t REGISTERED_NUM = BNCtxRegistry().size(); 
+    std::vector<int> vec_correct(THREAD_NUM, 0); 
+    std::vector<std::thread> vec_thread; 
+    for(auto t = 0; t < THREAD_NUM; t++){
+        vec_thread.emplace_back([&, t](){
+            bool correct = true; 
+            for(auto i = 0; i < 100; i++) correct = correct && (A * a == expected_result); 
+            vec_correct[t] = correct; 
+        }); 
+    }
+    for(auto &thread : vec_thread) thread.join(); 
+    // the contexts of exited threads are gone; BN_Finalize releases the pooled workers' ones too, and they come back on use
+    bool released = (BNCtxRegistry().size() == REGISTERED_NUM); 
+    BN_Finalize(); 
+    released = released && BNCtxRegistry().empty() && (A * a == expected_result); 
+
+    if (std::count(vec_correct.begin(), vec_correct.end(), 1) == THREAD_NUM && released) 
+        std::cout << "EC operations from " << THREAD_NUM << " foreign threads are correct" << std::endl; 
+    else{
+        std::cout << "EC operations from foreign threads are wrong" << std::endl; 
+        FAILED_TEST_NUM++; 
+    }
 }
 
 // void test_fast_hash_to_point(size_t LEN)
@@ -152,7 +1113,7 @@ void test_hash_to_point(size_t LEN)
 // }
 
 
-int main()
+int main(int argc, char *argv[])
 {  
     CRYPTO_Initialize(); 
 
@@ -162,6 +1123,52 @@ int main()
 
     // test_hash_to_point(TEST_NUM);
 
+    test_multi_scalar_mul(4096); 
+
+    test_fixed_base_table(1024); 
+
+    test_foreign_threads(4*NUMBER_OF_THREADS); 
+
+    test_batch_serialization(1024*16); 
+
+    test_scalar256(1024*16); 
+
+    test_random_scalar(1024*16); 
+
+    test_prg_stream(1024*1024); 
+
+    test_bit_vector(1024*1024 + 5); 
+
+    test_fast_transpose(1024*1024); 
+
+    test_cr_hash(1024*1024); 
+
+    test_hash_many(1024*1024); 
+
+    test_records_to_blocks(1024*1024); 
+
+    test_transcript(1024*4); 
+
+    test_block_kernels(1024*1024 + 3); 
+
+    test_gf128(1024*64 + 3); 
+
+    test_ristretto(1024); 
+
+    test_hash_to_point(1024*4); 
+
+    // timings are only taken on request: ./test_misc benchmark
+    if(argc > 1 && std::string(argv[1]) == "benchmark"){
+        benchmark_multi_scalar_mul(1024*16); 
+        benchmark_fast_transpose(1024*1024); 
+        benchmark_cr_hash(1024*1024); 
+        benchmark_hash_many(1024*1024); 
+        benchmark_records_to_blocks(1024*1024); 
+        benchmark_transcript(1024*4); 
+        benchmark_block_kernels(1024*1024 + 3); 
+        benchmark_gf128(1024*64 + 3); 
+    }
+
 
     // std::string test_filename = "testio.txt";
     // std::ofstream fout; 
@@ -208,6 +1215,10 @@ int main()
     std::cout << "ok" << std::endl;
 
     CRYPTO_Finalize(); 
+    if(FAILED_TEST_NUM != 0){
+        std::cerr << FAILED_TEST_NUM << " correctness tests failed" << std::endl; 
+        return EXIT_FAILURE; 
+    }
     return 0; 
 }
 
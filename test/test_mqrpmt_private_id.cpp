@@ -116,6 +116,7 @@ void FetchTestCase(TestCase &testcase, std::string testcase_filename)
 
 int main()
 {
+    PROTOCOL_LOG = true; 
     CRYPTO_Initialize(); 
 
     std::cout << "Private-ID test begins >>>" << std::endl; 
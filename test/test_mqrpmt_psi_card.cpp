@@ -114,6 +114,7 @@ void FetchTestCase(TestCase &testcase, std::string testcase_filename)
 
 int main()
 {
+    PROTOCOL_LOG = true; 
     CRYPTO_Initialize(); 
 
     std::cout << "mqRPMT-based PSI-card test begins >>>" << std::endl; 
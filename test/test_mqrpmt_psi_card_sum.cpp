@@ -153,6 +153,7 @@ void FetchTestCase(TestCase &testcase, std::string testcase_filename)
 
 int main()
 {
+    PROTOCOL_LOG = true; 
     CRYPTO_Initialize(); 
 
     std::cout << "mqRPMT-based PSI-card-sum test begins >>>" << std::endl; 
@@ -66,6 +66,7 @@ void FetchTestCase(std::vector<block> &vec_m0, std::vector<block> &vec_m1,
 
 int main()
 { 
+	PROTOCOL_LOG = true; 
 	CRYPTO_Initialize(); 
 
 	PrintSplitLine('-'); 
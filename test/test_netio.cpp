@@ -1,9 +1,46 @@
 #include "../netio/stream_channel.hpp"
+#include "../netio/loopback_channel.hpp"
+#include "../netio/shm_channel.hpp"
+#include "../netio/async_channel.hpp"
 
-void test_client()
+/*
+** both parties send 16 MB chunk by chunk and receive the peer's 16 MB at the same time
+** the receive is posted first, so neither side stalls on a full socket buffer
+*/
+bool test_async_exchange(Channel &io, uint64_t self_tag, uint64_t peer_tag)
 {
-	NetIO client("client", "127.0.0.1", 8080);
+	size_t LEN = 1 << 20; 
+	size_t CHUNK_LEN = 1 << 14; 
+	std::vector<block> vec_send(LEN); 
+	std::vector<block> vec_receive(LEN); 
 
+	auto start_time = std::chrono::steady_clock::now(); 
+	bool flag = true; 
+	// the wrapper turns auto flush on for its I/O thread and must hand io back as it found it
+	io.SetAutoFlush(false); 
+	bool auto_flush = io.GetAutoFlush(); 
+	{
+		AsyncNetIO async_io(io); 
+		async_io.PostReceive(vec_receive.data(), LEN*16, CHUNK_LEN*16); 
+		for(size_t begin = 0; begin < LEN; begin += CHUNK_LEN){
+			for(auto i = begin; i < begin + CHUNK_LEN; i++) vec_send[i] = Block::MakeBlock(self_tag, i); 
+			async_io.AsyncSend(vec_send.data() + begin, CHUNK_LEN*16); 
+		}
+		async_io.StreamingReceive([&](size_t begin, size_t end){
+			for(auto i = begin/16; i < end/16; i++) flag = flag && Block::Compare(vec_receive[i], Block::MakeBlock(peer_tag, i)); 
+		}); 
+	}
+	flag = flag && (io.GetAutoFlush() == auto_flush); 
+	io.SetAutoFlush(true); 
+	auto end_time = std::chrono::steady_clock::now(); 
+	auto running_time = end_time - start_time;
+	std::cout << "exchanging " << (double)LEN*16/(1024*1024) << " MB each way asynchronously takes " 
+	<< std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+	return flag; 
+}
+
+bool test_client(Channel &client)
+{
 	std::string message;
 
 	//std::getline(std::cin, message);
@@ -12,12 +49,41 @@ void test_client()
 
 	message = "world";
 	client.SendString(message);
+
+	// every third bit set, sent packed
+	BitVector vec_bit(1000); 
+	for(auto i = 0; i < vec_bit.Size(); i += 3) vec_bit.Set(i, true); 
+	client.SendBits(vec_bit); 
+
+	// small messages coalesced into one send
+	client.SetAutoFlush(false); 
+	for(size_t i = 0; i < 1000; i++) client.SendInteger(i); 
+	std::vector<std::vector<uint8_t>> vec_row(100, std::vector<uint8_t>(33)); 
+	for(auto i = 0; i < vec_row.size(); i++) vec_row[i][0] = i; 
+	client.SendBytesVector(vec_row); 
+	client.Flush(); 
+
+	// 64 MB in one send, above ZEROCOPY_THRESHOLD of NetIO: vec_block is left alone until Flush
+	size_t LEN = 1 << 22; 
+	std::vector<block> vec_block(LEN); 
+	for(auto i = 0; i < LEN; i++) vec_block[i] = Block::MakeBlock(i, ~uint64_t(i)); 
+	auto start_time = std::chrono::steady_clock::now(); 
+	client.SendBlocks(vec_block.data(), LEN); 
+	client.Flush(); 
+	client.SetAutoFlush(true); 
+	auto end_time = std::chrono::steady_clock::now(); 
+	auto running_time = end_time - start_time;
+	std::cout << "sending " << LEN*16/(1024*1024) << " MB takes " 
+	<< std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+	bool flag = test_async_exchange(client, 2, 1); 
+	if(flag) std::cout << "AsyncNetIO test succeeds" << std::endl; 
+	else std::cout << "AsyncNetIO test fails" << std::endl; 
+	return flag; 
 }
 
-void test_server()
+bool test_server(Channel &server)
 {
-	NetIO server("server", "", 8080); 
-	
 	std::string message(5, '0'); 
 
 	server.ReceiveString(message);
@@ -25,29 +91,191 @@ void test_server()
 
 	server.ReceiveString(message);
 	std::cout << "message from client: " << message << std::endl; 
+
+	BitVector vec_bit(1000); 
+	server.ReceiveBits(vec_bit); 
+	std::cout << "bit vector from client: " << vec_bit.ByteSize() << " bytes, " 
+	          << vec_bit.Count() << " ones (expect 334)" << std::endl; 
+
+	bool flag = true; 
+	for(size_t i = 0; i < 1000; i++){
+		size_t n; 
+		server.ReceiveInteger(n); 
+		flag = flag && (n == i); 
+	}
+	std::vector<std::vector<uint8_t>> vec_row; 
+	server.ReceiveBytesVector(vec_row); 
+	flag = flag && (vec_row.size() == 100) && (vec_row[0].size() == 33); 
+	for(auto i = 0; flag && i < vec_row.size(); i++) flag = (vec_row[i][0] == i); 
+
+	size_t LEN = 1 << 22; 
+	std::vector<block> vec_block(LEN); 
+	server.ReceiveBlocks(vec_block.data(), LEN); 
+	for(auto i = 0; i < LEN; i++) flag = flag && Block::Compare(vec_block[i], Block::MakeBlock(i, ~uint64_t(i))); 
+
+	if(flag) std::cout << "Channel test succeeds" << std::endl; 
+	else std::cout << "Channel test fails" << std::endl; 
+
+	bool async_flag = test_async_exchange(server, 1, 2); 
+	if(async_flag) std::cout << "AsyncNetIO test succeeds" << std::endl; 
+	else std::cout << "AsyncNetIO test fails" << std::endl; 
+	return flag && async_flag; 
 }
 
-void test_netio(std::string party)
+// phases nest as parent/child, and each byte is charged to the innermost open phase only
+bool test_channel_metrics()
 {
+	LoopbackChannel server, client; 
+	ConnectLoopback(server, client); 
+	std::vector<uint8_t> buffer(1000); 
+
+	std::thread server_thread([&]{
+		auto phase = server.Phase("query"); 
+		server.ReceiveBytes(buffer.data(), 1000); 
+		server.SendInteger(buffer.size()); 
+	}); 
+	{
+		auto phase = client.Phase("query"); 
+		{
+			auto inner_phase = client.Phase("upload"); 
+			client.SendBytes(buffer.data(), 1000); 
+		}
+		size_t n; 
+		client.ReceiveInteger(n); 
+	}
+	server_thread.join(); 
+
+	ChannelMetrics metrics = client.GetMetrics(); 
+	PhaseMetrics query = metrics.Find("query"); 
+	PhaseMetrics upload = metrics.Find("query/upload"); 
+	PhaseMetrics total = metrics.Total(); 
+	bool flag = (upload.BYTES_SENT == 1000) && (upload.MESSAGES_SENT == 1) 
+	         && (query.BYTES_SENT == 0) && (query.BYTES_RECEIVED == sizeof(size_t)) && (query.ROUND_TRIPS == 1) 
+	         && (total.BYTES_SENT == 1000) && (total.BYTES_RECEIVED == sizeof(size_t)) 
+	         && (server.GetMetrics().Find("query").ROUND_TRIPS == 0); 
+	metrics.Print(); 
+	std::cout << metrics.ToJSON() << std::endl; 
+
+	// a vector is one message on both sides
+	server_thread = std::thread([&]{
+		auto phase = server.Phase("vectors"); 
+		std::vector<std::vector<uint8_t>> vec_row; 
+		std::vector<std::string> vec_str; 
+		server.ReceiveBytesVector(vec_row); 
+		server.ReceiveStringVector(vec_str, 8); 
+	}); 
+	{
+		auto phase = client.Phase("vectors"); 
+		client.SendBytesVector(std::vector<std::vector<uint8_t>>(10, std::vector<uint8_t>(33))); 
+		client.SendStringVector(std::vector<std::string>(10, std::string(8, 'a')), 8); 
+	}
+	server_thread.join(); 
+	PhaseMetrics vectors_sent = client.GetMetrics().Find("vectors"); 
+	PhaseMetrics vectors_received = server.GetMetrics().Find("vectors"); 
+	bool vector_flag = (vectors_sent.MESSAGES_SENT == 2) && (vectors_received.MESSAGES_RECEIVED == 2) 
+	                && (vectors_sent.BYTES_SENT == vectors_received.BYTES_RECEIVED); 
+	return flag && vector_flag; 
+}
+
+/*
+** a pipelined exchange is one round trip for each party however many chunks it takes, 
+** and the answer sent after it adds none to the party that only receives it
+*/
+bool test_async_round_trips()
+{
+	LoopbackChannel server, client; 
+	ConnectLoopback(server, client); 
+	size_t LEN = 1 << 20; 
+	size_t CHUNK_LEN = 1 << 12; 
+	size_t CHUNK_NUM = LEN / CHUNK_LEN; 
+
+	auto exchange = [&](Channel &io, std::vector<uint8_t> &buffer_send, std::vector<uint8_t> &buffer_receive){
+		auto phase = io.Phase("exchange"); 
+		AsyncNetIO async_io(io); 
+		async_io.PostReceive(buffer_receive.data(), LEN, CHUNK_LEN); 
+		for(size_t begin = 0; begin < LEN; begin += CHUNK_LEN) async_io.AsyncSend(buffer_send.data() + begin, CHUNK_LEN); 
+		async_io.StreamingReceive([](size_t begin, size_t end){}); 
+	}; 
+
+	std::vector<uint8_t> server_send(LEN), server_receive(LEN), client_send(LEN), client_receive(LEN); 
+	std::thread server_thread([&]{
+		exchange(server, server_send, server_receive); 
+		size_t n; 
+		server.ReceiveInteger(n); 
+	}); 
+	exchange(client, client_send, client_receive); 
+	client.SendInteger(LEN); 
+	server_thread.join(); 
+
+	bool flag = true; 
+	for(Channel *io : {(Channel*)&server, (Channel*)&client}){
+		ChannelMetrics metrics = io->GetMetrics(); 
+		PhaseMetrics phase = metrics.Find("exchange"); 
+		flag = flag && (phase.ROUND_TRIPS == 1) && (phase.MESSAGES_SENT == CHUNK_NUM) && (phase.MESSAGES_RECEIVED == CHUNK_NUM) 
+		            && (phase.BYTES_SENT == LEN) && (phase.BYTES_RECEIVED == LEN) && (metrics.Total().ROUND_TRIPS == 1); 
+	}
+	return flag; 
+}
+
+// false if any check of this party fails
+bool test_netio(std::string party)
+{
+	bool flag = true; 
 	if (party == "server")
 	{
-		test_server(); 
+		NetIO server("server", "", 8080); 
+		flag = test_server(server); 
 	}
 
 	if (party == "client")
 	{
-		test_client(); 
+		NetIO client("client", "127.0.0.1", 8080);
+		flag = test_client(client); 
 	}
 
+	// both parties as threads of this process
+	if (party == "loopback")
+	{
+		LoopbackChannel server, client; 
+		ConnectLoopback(server, client); 
+		bool server_flag = true; 
+		std::thread server_thread([&]{ server_flag = test_server(server); }); 
+		flag = test_client(client); 
+		server_thread.join(); 
+		flag = flag && server_flag; 
+
+		bool metrics_flag = test_channel_metrics(); 
+		if(metrics_flag) std::cout << "channel metrics test succeeds" << std::endl; 
+		else std::cout << "channel metrics test fails" << std::endl; 
+
+		bool round_trip_flag = test_async_round_trips(); 
+		if(round_trip_flag) std::cout << "pipelined round trip test succeeds" << std::endl; 
+		else std::cout << "pipelined round trip test fails" << std::endl; 
+		flag = flag && metrics_flag && round_trip_flag; 
+	}
+
+	if (party == "shm_server")
+	{
+		ShmChannel server("server", "kunlun_test_netio"); 
+		flag = test_server(server); 
+	}
+
+	if (party == "shm_client")
+	{
+		ShmChannel client("client", "kunlun_test_netio"); 
+		flag = test_client(client); 
+	}
+	return flag; 
 }
 
 int main()
 {
     std::string party; 
 
-	std::cout << "please select your role (hint: first start server, then start the client) >>> "; 
+	std::cout << "please select your role: server/client over TCP (first start server, then start the client), " 
+	          << "loopback (both in this process), or shm_server/shm_client over shared memory >>> "; 
     std::getline(std::cin, party); // first receiver (acts as server), then sender (acts as client)
-	test_netio(party);
+	bool flag = test_netio(party);
 
-	return 0; 
-}
\ No newline at end of file
+	return flag ? 0 : EXIT_FAILURE; 
+}
@@ -38,14 +38,14 @@ void test_nizk_dlog_equality(bool flag)
     DLOGEquality::Witness witness;  
 
 
-    std::string transcript_str;
+    Transcript transcript;
 
     // test the standard version
 
     GenRandomDDHInstanceWitness(pp, instance, witness, flag); 
     auto start_time = std::chrono::steady_clock::now(); // start to count the time
-    transcript_str = "";
-    DLOGEquality::Proof proof = DLOGEquality::Prove(pp, instance, witness, transcript_str); 
+    transcript = Transcript();
+    DLOGEquality::Proof proof = DLOGEquality::Prove(pp, instance, witness, transcript); 
     auto end_time = std::chrono::steady_clock::now(); // end to count the time
     auto running_time = end_time - start_time;
     std::cout << "DDH proof generation takes time = " 
@@ -53,8 +53,8 @@ void test_nizk_dlog_equality(bool flag)
 
 
     start_time = std::chrono::steady_clock::now(); // start to count the time
-    transcript_str = "";
-    DLOGEquality::Verify(pp, instance, transcript_str, proof);
+    transcript = Transcript();
+    DLOGEquality::Verify(pp, instance, transcript, proof);
     end_time = std::chrono::steady_clock::now(); // end to count the time
     running_time = end_time - start_time;
     std::cout << "DDH proof verification takes time = " 
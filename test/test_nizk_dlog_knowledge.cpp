@@ -23,14 +23,14 @@ void test_nizk_dlog_knowledge()
     DLOGKnowledge::Instance instance; 
     DLOGKnowledge::Witness witness; 
 
-    std::string transcript_str;
+    Transcript transcript;
 
     // test the standard version
 
     GenRandomDLOGInstanceWitness(pp, instance, witness); 
     auto start_time = std::chrono::steady_clock::now(); // start to count the time
-    transcript_str = "";
-    DLOGKnowledge::Proof proof = DLOGKnowledge::Prove(pp, instance, witness, transcript_str); 
+    transcript = Transcript();
+    DLOGKnowledge::Proof proof = DLOGKnowledge::Prove(pp, instance, witness, transcript); 
     auto end_time = std::chrono::steady_clock::now(); // end to count the time
     auto running_time = end_time - start_time;
     std::cout << "DLOG proof generation takes time = " 
@@ -38,8 +38,8 @@ void test_nizk_dlog_knowledge()
 
 
     start_time = std::chrono::steady_clock::now(); // start to count the time
-    transcript_str = "";
-    DLOGKnowledge::Verify(pp, instance, transcript_str, proof);
+    transcript = Transcript();
+    DLOGKnowledge::Verify(pp, instance, transcript, proof);
     end_time = std::chrono::steady_clock::now(); // end to count the time
     running_time = end_time - start_time;
     std::cout << "DLOG proof verification takes time = " 
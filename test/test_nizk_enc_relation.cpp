@@ -57,21 +57,21 @@ void test_nizk_enc_relation(bool flag)
     EncRelation::Instance instance; 
     EncRelation::Witness witness; 
 
-    std::string transcript_str; 
+    Transcript transcript; 
 
     GenRandomEncInstanceWitness(pp, instance, witness, flag); 
     auto start_time = std::chrono::steady_clock::now(); // start to count the time
-    transcript_str = ""; 
+    transcript = Transcript(); 
 
-    EncRelation::Proof proof = EncRelation::Prove(pp, instance, witness, transcript_str); 
+    EncRelation::Proof proof = EncRelation::Prove(pp, instance, witness, transcript); 
     auto end_time = std::chrono::steady_clock::now(); // end to count the time
     auto running_time = end_time - start_time;
     std::cout << "proof generation takes time = " 
     << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
 
     start_time = std::chrono::steady_clock::now(); // start to count the time
-    transcript_str = ""; 
-    EncRelation::Verify(pp, instance, transcript_str, proof);
+    transcript = Transcript(); 
+    EncRelation::Verify(pp, instance, transcript, proof);
     end_time = std::chrono::steady_clock::now(); // end to count the time
     running_time = end_time - start_time;
     std::cout << "proof verification takes time = " 
@@ -46,20 +46,20 @@ void test_nizk_plaintext_equality(bool flag)
     PlaintextEquality::Instance instance; 
     PlaintextEquality::Witness witness; 
 
-    std::string transcript_str; 
+    Transcript transcript; 
 
     GenRandomTripleEncInstanceWitness(pp, instance, witness, flag); 
     auto start_time = std::chrono::steady_clock::now(); // start to count the time
-    transcript_str = ""; 
-    PlaintextEquality::Proof proof = PlaintextEquality::Prove(pp, instance, witness, transcript_str); 
+    transcript = Transcript(); 
+    PlaintextEquality::Proof proof = PlaintextEquality::Prove(pp, instance, witness, transcript); 
     auto end_time = std::chrono::steady_clock::now(); // end to count the time
     auto running_time = end_time - start_time;
     std::cout << "proof generation takes time = " 
     << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
 
     start_time = std::chrono::steady_clock::now(); // start to count the time
-    transcript_str = ""; 
-    PlaintextEquality::Verify(pp, instance, transcript_str, proof);
+    transcript = Transcript(); 
+    PlaintextEquality::Verify(pp, instance, transcript, proof);
     end_time = std::chrono::steady_clock::now(); // end to count the time
     running_time = end_time - start_time;
     std::cout << "proof verification takes time = " 
@@ -33,19 +33,19 @@ void test_nizk_plaintext_knowledge()
 
     GenRandomEncInstanceWitness(pp, instance, witness); 
 
-    std::string transcript_str; 
+    Transcript transcript; 
 
     auto start_time = std::chrono::steady_clock::now(); // start to count the time
-    transcript_str = ""; 
-    PlaintextKnowledge::Proof proof = PlaintextKnowledge::Prove(pp, instance, witness, transcript_str); 
+    transcript = Transcript(); 
+    PlaintextKnowledge::Proof proof = PlaintextKnowledge::Prove(pp, instance, witness, transcript); 
     auto end_time = std::chrono::steady_clock::now(); // end to count the time
     auto running_time = end_time - start_time;
     std::cout << "proof generation takes time = " 
     << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
 
     start_time = std::chrono::steady_clock::now(); // start to count the time
-    transcript_str = ""; 
-    PlaintextKnowledge::Verify(pp, instance, transcript_str, proof); 
+    transcript = Transcript(); 
+    PlaintextKnowledge::Verify(pp, instance, transcript, proof); 
     end_time = std::chrono::steady_clock::now(); // end to count the time
     running_time = end_time - start_time;
     std::cout << "proof verification takes time = " 
@@ -58,6 +58,7 @@ void FetchTestCase(OTEOPRFTestCase &testcase, std::string testcase_filename)
 
 int main()
 {
+	PROTOCOL_LOG = true; 
 	CRYPTO_Initialize(); 
 
     std::cout << "OTE-based OPRF test begins >>>" << std::endl; 
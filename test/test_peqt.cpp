@@ -67,6 +67,7 @@ void FetchTestInstance(PEQTTestcase &testcase, std::string testcase_filename)
 
 int main()
 {
+    PROTOCOL_LOG = true; 
     CRYPTO_Initialize(); 
 
     PrintSplitLine('-'); 
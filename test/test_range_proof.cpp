@@ -59,19 +59,19 @@ void test_gadget1(BigInt &LEFT_BOUND, BigInt &RIGHT_BOUND, size_t &RANGE_LEN, si
     Gadget::Witness_type1 witness; 
     GenRandomGadget1InstanceWitness(pp, instance, witness);
  
-    std::string transcript_str; 
+    Transcript transcript; 
     
     auto start_time = std::chrono::steady_clock::now(); // start to count the time
-    transcript_str = ""; 
-    Gadget::Proof_type1 proof = Gadget::Prove(pp, instance, LEFT_BOUND, RIGHT_BOUND, witness, transcript_str); 
+    transcript = Transcript(); 
+    Gadget::Proof_type1 proof = Gadget::Prove(pp, instance, LEFT_BOUND, RIGHT_BOUND, witness, transcript); 
     auto end_time = std::chrono::steady_clock::now(); // end to count the time
     auto running_time = end_time - start_time;
     std::cout << "proof generation takes time = " 
     << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
 
     start_time = std::chrono::steady_clock::now(); // start to count the time
-    transcript_str = ""; 
-    Gadget::Verify(pp, instance, LEFT_BOUND, RIGHT_BOUND,  transcript_str, proof); 
+    transcript = Transcript(); 
+    Gadget::Verify(pp, instance, LEFT_BOUND, RIGHT_BOUND,  transcript, proof); 
     end_time = std::chrono::steady_clock::now(); // end to count the time
     running_time = end_time - start_time;
     std::cout << "proof verification takes time = " 
@@ -98,19 +98,19 @@ void test_gadget2(BigInt &LEFT_BOUND, BigInt &RIGHT_BOUND, size_t &RANGE_LEN, si
     Gadget::Witness_type2 witness; 
     GenRandomGadget2InstanceWitness(pp, instance, witness);
     Gadget::Proof_type2 proof;  
-    std::string transcript_str; 
+    Transcript transcript; 
     
     auto start_time = std::chrono::steady_clock::now(); // start to count the time
-    transcript_str = ""; 
-    Gadget::Prove(pp, instance, LEFT_BOUND, RIGHT_BOUND, witness, transcript_str, proof); 
+    transcript = Transcript(); 
+    Gadget::Prove(pp, instance, LEFT_BOUND, RIGHT_BOUND, witness, transcript, proof); 
     auto end_time = std::chrono::steady_clock::now(); // end to count the time
     auto running_time = end_time - start_time;
     std::cout << "proof generation takes time = " 
     << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
 
     start_time = std::chrono::steady_clock::now(); // start to count the time
-    transcript_str = ""; 
-    Gadget::Verify(pp, instance, LEFT_BOUND, RIGHT_BOUND, transcript_str, proof); 
+    transcript = Transcript(); 
+    Gadget::Verify(pp, instance, LEFT_BOUND, RIGHT_BOUND, transcript, proof); 
     end_time = std::chrono::steady_clock::now(); // end to count the time
     running_time = end_time - start_time;
     std::cout << "proof verification takes time = " 
@@ -99,10 +99,24 @@ void FetchTestInstance(RPMTTestcase &testcase, std::string testcase_filename)
     fin.close(); 
 }
 
+// the OKVS output (server) and the re-randomized ciphertexts (client) are each above ZEROCOPY_THRESHOLD
+bool CheckZeroCopy(NetIO &io, std::string party)
+{
+    std::cout << party << " zero-copy sends = " << io.ZeroCopySends() << std::endl; 
+#ifdef KUNLUN_ZEROCOPY
+    bool flag = (io.ZeroCopySends() > 0); 
+    if(flag) std::cout << party << " zero-copy test succeeds" << std::endl; 
+    else std::cout << party << " zero-copy test fails" << std::endl; 
+    return flag; 
+#else
+    return true; 
+#endif
+}
 
 int main()
 {
-#ifndef ENABLE_X25519_ACCELERATION
+#if !defined(ENABLE_X25519_ACCELERATION) && !defined(ENABLE_RISTRETTO_GROUP)
+    PROTOCOL_LOG = true; 
     CRYPTO_Initialize(); 
 
     PrintSplitLine('-'); 
@@ -144,39 +158,61 @@ int main()
     PrintSplitLine('-'); 
 
     std::string party;
-    std::cout << "please select your role between server and client (hint: first start server, then start client) ==> ";  
+    std::cout << "please select your role between server and client (hint: first start server, then start client), "
+              << "or loopback (both in this process) ==> ";  
     std::getline(std::cin, party); // first the server, then the client
     PrintSplitLine('-'); 
   
-    if(party == "server"){
-        NetIO server("server", "", 8080);
-        std::vector<uint8_t> vec_indication_bit_real; 
-        vec_indication_bit_real = rrPKEmqRPMT::Server(server, pp, testcase.vec_Y); 
+    bool flag = true; 
+    auto run_server = [&](NetIO &server){
+        BitVector vec_indication_bit_real = rrPKEmqRPMT::Server(server, pp, testcase.vec_Y);
 
-        size_t HAMMING_WEIGHT = 0;
-        for(auto i = 0; i < pp.CLIENT_LEN; i++){
-            if(vec_indication_bit_real[i] == 1) HAMMING_WEIGHT++; 
-        } 
+        size_t HAMMING_WEIGHT = vec_indication_bit_real.Count();
         std::cout << "correct Hamming weight = " << testcase.HAMMING_WEIGHT << std::endl;
         std::cout << "real Hamming weight = " << HAMMING_WEIGHT << std::endl;
 
         double error_probability = abs(double(testcase.HAMMING_WEIGHT)-double(HAMMING_WEIGHT))/double(testcase.HAMMING_WEIGHT); 
         std::cout << "rrPKE-based mqRPMT test succeeds with probability " << (1 - error_probability) << std::endl; 
+        return CheckZeroCopy(server, "server"); 
+    }; 
+    auto run_client = [&](NetIO &client){
+        rrPKEmqRPMT::Client(client, pp, testcase.vec_X);
+        return CheckZeroCopy(client, "client"); 
+    }; 
+
+    if(party == "server"){
+        NetIO server("server", "", 8080);
+        flag = run_server(server); 
     }
 
     if(party == "client")
     {
         NetIO client("client", "127.0.0.1", 8080); 
-        rrPKEmqRPMT::Client(client, pp, testcase.vec_X);
+        flag = run_client(client); 
     } 
 
+    // the server must be listening before the client connects
+    if(party == "loopback")
+    {
+        bool server_flag = true; 
+        std::thread server_thread([&]{
+            NetIO server("server", "", 8080);
+            server_flag = run_server(server); 
+        }); 
+        std::this_thread::sleep_for(std::chrono::milliseconds(500)); 
+        NetIO client("client", "127.0.0.1", 8080); 
+        flag = run_client(client); 
+        server_thread.join(); 
+        flag = flag && server_flag; 
+    }
+
     PrintSplitLine('-'); 
     std::cout << "rrPKE-based mqRPMT test ends >>>" << std::endl; 
     PrintSplitLine('-'); 
 
     CRYPTO_Finalize();   
     
-    return 0; 
+    return flag ? 0 : 1; 
     
 #else
     std::cout << "We haven't provided _X25519 version for this!" << std::endl; 
@@ -177,6 +177,36 @@ void function_test(size_t MSG_LEN, size_t TRADEOFF_NUM)
         std::cout << "decryption succeeds for right boundary" << std::endl;
     }
 
+    FixedBaseTable pk_table(pk); 
+    BigInt r = GenRandomBigIntLessThan(order); 
+    ct = TwistedExponentialElGamal::Enc(pp, pk_table, m_random, r);
+    if(!(ct == TwistedExponentialElGamal::Enc(pp, pk, m_random, r)) || TwistedExponentialElGamal::Dec(pp, sk, ct) != m_random){ 
+        std::cout << "encryption with the table of pk fails" << std::endl;
+    }
+    else{
+        std::cout << "encryption with the table of pk succeeds" << std::endl;
+    }
+
+    // pp written before h_table was saved with it stops at h; loading it must rebuild the table and leave what follows intact
+    using Serialization::operator<<; 
+    using Serialization::operator>>; 
+    std::string pp_filename = "twisted_elgamal_pp.test"; 
+    std::ofstream fout(pp_filename, std::ios::binary); 
+    fout << pp.MSG_LEN << pp.TRADEOFF_NUM << pp.MSG_SIZE << pp.g << pp.h << pk; 
+    fout << pp << pk; 
+    fout.close(); 
+    TwistedExponentialElGamal::PP old_pp, new_pp; 
+    ECPoint old_pk, new_pk; 
+    std::ifstream fin(pp_filename, std::ios::binary); 
+    fin >> old_pp >> old_pk >> new_pp >> new_pk; 
+    fin.close(); 
+    std::remove(pp_filename.c_str()); 
+    if(old_pk == pk && new_pk == pk && old_pp.h_table.Mul(r) == pp.h * r && new_pp.h_table.Mul(r) == pp.h * r){ 
+        std::cout << "loading pp with and without the h table succeeds" << std::endl;
+    }
+    else{
+        std::cout << "loading pp with and without the h table fails" << std::endl;
+    }
 }
 
 
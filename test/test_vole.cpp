@@ -53,6 +53,7 @@ void FetchTestCase(VOLETestcase &testcase, std::string testcase_filename)
 int main()
 {
     
+	PROTOCOL_LOG = true; 
 	CRYPTO_Initialize(); 
 
 	PrintSplitLine('-'); 
@@ -94,7 +95,7 @@ int main()
  	// calculate vec_C + vec_A*delta
         for (auto i = 0; i < N_item; ++i)
         {
-        	vec_C[i] ^= VOLE::gf128_mul(delta,vec_A[i]);
+        	vec_C[i] ^= GF128::Mul(delta,vec_A[i]);
         }
         
         // test if vec_B == vec_C + vec_A*delta
@@ -1,5 +1,6 @@
 #include "../mpc/oprf/vole_oprf.hpp"
 #include "../crypto/setup.hpp"
+#include "../netio/loopback_channel.hpp"
 
 struct VOLEOPRFTestCase
 {
@@ -19,9 +20,53 @@ VOLEOPRFTestCase GenTestCase(size_t LOG_INPUT_NUM)
     return testcase;
 }
 
+void RunServer(Channel &server_io, VOLEOPRF::PP &pp, VOLEOPRFTestCase &testcase)
+{
+    auto start_time = std::chrono::steady_clock::now(); 
+    std::vector<uint8_t> oprf_key = VOLEOPRF::Server1(server_io, pp);
+    std::vector<block> vec_Fk_X = VOLEOPRF::Evaluate1(pp, oprf_key, testcase.vec_Y, pp.INPUT_NUM);
+    auto end_time = std::chrono::steady_clock::now();
+    
+    server_io.SendBlocks(vec_Fk_X.data(), pp.INPUT_NUM);
+    
+    auto running_time = end_time - start_time;
+    std::cout << "VOLE-based OPRF: Server side takes time = "
+              << std::chrono::duration<double, std::milli>(running_time).count() << " ms" << std::endl;
+    PrintSplitLine('-');
+}
+
+void RunClient(Channel &client_io, VOLEOPRF::PP &pp, VOLEOPRFTestCase &testcase)
+{
+    PrintSplitLine('-'); 
+    
+    auto start_time = std::chrono::steady_clock::now();   
+    std::vector<block> vec_Fk_Y = VOLEOPRF::Client1(client_io, pp, testcase.vec_Y, pp.INPUT_NUM);
+	auto end_time = std::chrono::steady_clock::now();
+    
+    // receive vec_Fk_X from sender/server
+    std::vector<block> vec_Fk_X(pp.INPUT_NUM);
+    client_io.ReceiveBlocks(vec_Fk_X.data(), pp.INPUT_NUM);
+    
+    if(Block::Compare(vec_Fk_Y,vec_Fk_X)==true){
+    	PrintSplitLine('-');
+    	std::cout << "VOLEOPRF test succeeds" << std::endl; 
+    }
+    else
+    {
+    	PrintSplitLine('-');
+    	std::cout << "VOLEOPRF test fails" << std::endl; 
+    }   
+     
+    auto running_time = end_time - start_time;
+    std::cout << "VOLE-based OPRF: Client side takes time = "
+              << std::chrono::duration<double, std::milli>(running_time).count() << " ms" << std::endl;
+    PrintSplitLine('-');
+}
+
 int main()
 {
-    CRYPTO_Initialize();
+    PROTOCOL_LOG = true; 
+    CRYPTO_Initialize(); 
 
     std::cout << "VOLE-based OPRF test begins >>>" << std::endl;
 
@@ -42,57 +87,29 @@ int main()
     testcase = GenTestCase(LOG_INPUT_NUM);
 
     std::string party;
-    std::cout << "please select your role between server and receiver (hint: first start server, then start client) ==> ";
+    std::cout << "please select your role between server and client (hint: first start server, then start client), or loopback to run both ==> ";
     std::getline(std::cin, party);
 
     if (party == "server")
     {
-        
         NetIO server_io("server", "", 8080);
-        
-        auto start_time = std::chrono::steady_clock::now(); 
-        std::vector<uint8_t> oprf_key = VOLEOPRF::Server1(server_io, pp);
-        std::vector<block> vec_Fk_X = VOLEOPRF::Evaluate1(pp, oprf_key, testcase.vec_Y, pp.INPUT_NUM);
-        auto end_time = std::chrono::steady_clock::now();
-        
-        server_io.SendBlocks(vec_Fk_X.data(), pp.INPUT_NUM);
-        
-        auto running_time = end_time - start_time;
-        std::cout << "VOLE-based OPRF: Server side takes time = "
-                  << std::chrono::duration<double, std::milli>(running_time).count() << " ms" << std::endl;
-        PrintSplitLine('-');          
-
+        RunServer(server_io, pp, testcase);
     }
 
     if (party == "client")
     {
         NetIO client_io("client", "127.0.0.1", 8080);
-        
-        PrintSplitLine('-'); 
-        
-        auto start_time = std::chrono::steady_clock::now();   
-        std::vector<block> vec_Fk_Y = VOLEOPRF::Client1(client_io, pp, testcase.vec_Y, pp.INPUT_NUM);
-	auto end_time = std::chrono::steady_clock::now();
-        
-        // receive vec_Fk_X from sender/server
-        std::vector<block> vec_Fk_X(pp.INPUT_NUM);
-        client_io.ReceiveBlocks(vec_Fk_X.data(), pp.INPUT_NUM);
-        
-        if(Block::Compare(vec_Fk_Y,vec_Fk_X)==true){
-        	PrintSplitLine('-');
-        	std::cout << "VOLEOPRF test succeeds" << std::endl; 
-        }
-        else
-        {
-        	PrintSplitLine('-');
-        	std::cout << "VOLEOPRF test fails" << std::endl; 
-        }   
-         
-        auto running_time = end_time - start_time;
-        std::cout << "VOLE-based OPRF: Client side takes time = "
-                  << std::chrono::duration<double, std::milli>(running_time).count() << " ms" << std::endl;
-        PrintSplitLine('-');        
+        RunClient(client_io, pp, testcase);
+    }
 
+    // both parties as threads of this process: compute cost without the TCP stack
+    if (party == "loopback")
+    {
+        LoopbackChannel server_io, client_io;
+        ConnectLoopback(server_io, client_io);
+        std::thread server_thread([&]{ RunServer(server_io, pp, testcase); });
+        RunClient(client_io, pp, testcase);
+        server_thread.join();
     }
 
     CRYPTO_Finalize();
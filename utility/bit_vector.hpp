@@ -0,0 +1,219 @@
+/****************************************************************************
+this hpp implements BitVector: a bit vector packed into 64-bit words
+bit i is bit (i%64) of word i/64, so the word array read as bytes is the dense little-endian
+encoding: it can be sent as is, and a multiple of 128 bits copies straight into blocks
+(same bit order as Block::FromSparseBytes)
+the bits beyond Size() in the last word are kept zero
+*****************************************************************************
+* @copyright  MIT license (see LICENSE file)
+*****************************************************************************/
+#ifndef KUNLUN_UTILITY_BIT_VECTOR_HPP_
+#define KUNLUN_UTILITY_BIT_VECTOR_HPP_
+
+#include "../include/global.hpp"
+
+class BitVector{
+public:
+    BitVector() {}
+    explicit BitVector(size_t LEN, bool value = false) { this->Resize(LEN, value); }
+    // pack a sparse bit vector (one bit per byte, any nonzero byte counts as 1)
+    explicit BitVector(const std::vector<uint8_t> &vec_bit);
+
+    // one bit per byte
+    std::vector<uint8_t> ToSparseBytes() const;
+
+    void Resize(size_t LEN, bool value = false);
+
+    inline size_t Size() const { return this->bit_num; }
+    inline size_t WordNum() const { return this->word.size(); }
+    inline size_t ByteSize() const { return (this->bit_num + 7) / 8; }
+    inline uint64_t* Data() { return this->word.data(); }
+    inline const uint64_t* Data() const { return this->word.data(); }
+
+    inline bool operator[](size_t i) const { return (this->word[i/64] >> (i%64)) & 1; }
+    inline void Set(size_t i, bool value);
+
+    BitVector& operator&=(const BitVector &other);
+    BitVector& operator|=(const BitVector &other);
+    BitVector& operator^=(const BitVector &other);
+    BitVector operator&(const BitVector &other) const { BitVector result = *this; return result &= other; }
+    BitVector operator|(const BitVector &other) const { BitVector result = *this; return result |= other; }
+    BitVector operator^(const BitVector &other) const { BitVector result = *this; return result ^= other; }
+    BitVector operator~() const;
+
+    inline bool operator==(const BitVector &other) const { return this->bit_num == other.bit_num && this->word == other.word; }
+    inline bool operator!=(const BitVector &other) const { return !(*this == other); }
+
+    // the number of ones (hamming weight)
+    size_t Count() const;
+    // the position of the k-th one (k counts from 0); Size() if there are not that many ones
+    size_t Select(size_t k) const;
+    // call f(i) for every i with bit i = 1, in increasing order
+    template <typename Function>
+    void ForEachOne(Function f) const;
+
+    // set bit i = f(i) for every i < Size(), in parallel: each thread writes whole words, so writes never race
+    template <typename Function>
+    void Generate(Function f);
+
+    // zero the bits beyond Size(): needed after writing the words directly, e.g. receiving them
+    void ClearPadding();
+
+    void Print() const;
+
+private:
+    std::vector<uint64_t> word;
+    size_t bit_num = 0;
+
+    void CheckSize(const BitVector &other) const;
+};
+
+BitVector::BitVector(const std::vector<uint8_t> &vec_bit)
+{
+    this->Resize(vec_bit.size());
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS) if(vec_bit.size() > (1 << 16))
+    for (size_t j = 0; j < this->word.size(); j++){
+        size_t begin = j * 64;
+        size_t end = std::min(vec_bit.size(), begin + 64);
+        uint64_t w = 0;
+        for (auto i = begin; i < end; i++) w |= uint64_t(vec_bit[i] != 0) << (i - begin);
+        this->word[j] = w;
+    }
+}
+
+std::vector<uint8_t> BitVector::ToSparseBytes() const
+{
+    std::vector<uint8_t> vec_bit(this->bit_num);
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS) if(this->bit_num > (1 << 16))
+    for (size_t i = 0; i < this->bit_num; i++) vec_bit[i] = (*this)[i];
+    return vec_bit;
+}
+
+void BitVector::Resize(size_t LEN, bool value)
+{
+    size_t OLD_LEN = this->bit_num;
+    this->word.resize((LEN + 63) / 64, value ? ~uint64_t(0) : 0);
+    this->bit_num = LEN;
+    // the tail of the old last word is zero, set it if the new bits are ones
+    if (value) for (auto i = OLD_LEN; i < std::min(LEN, (OLD_LEN + 63) / 64 * 64); i++) this->Set(i, true);
+    this->ClearPadding();
+}
+
+inline void BitVector::Set(size_t i, bool value)
+{
+    uint64_t mask = uint64_t(1) << (i%64);
+    if (value) this->word[i/64] |= mask;
+    else this->word[i/64] &= ~mask;
+}
+
+void BitVector::CheckSize(const BitVector &other) const
+{
+    if (this->bit_num != other.bit_num){
+        std::cerr << "BitVector: sizes do not match" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+BitVector& BitVector::operator&=(const BitVector &other)
+{
+    this->CheckSize(other);
+    for (size_t j = 0; j < this->word.size(); j++) this->word[j] &= other.word[j];
+    return *this;
+}
+
+BitVector& BitVector::operator|=(const BitVector &other)
+{
+    this->CheckSize(other);
+    for (size_t j = 0; j < this->word.size(); j++) this->word[j] |= other.word[j];
+    return *this;
+}
+
+BitVector& BitVector::operator^=(const BitVector &other)
+{
+    this->CheckSize(other);
+    for (size_t j = 0; j < this->word.size(); j++) this->word[j] ^= other.word[j];
+    return *this;
+}
+
+BitVector BitVector::operator~() const
+{
+    BitVector result = *this;
+    for (size_t j = 0; j < result.word.size(); j++) result.word[j] = ~result.word[j];
+    result.ClearPadding();
+    return result;
+}
+
+// the loop is vectorized when the target has a vector popcount (e.g. -mavx512vpopcntdq)
+__attribute__((target("popcnt")))
+size_t BitVector::Count() const
+{
+    size_t count = 0;
+    for (size_t j = 0; j < this->word.size(); j++) count += __builtin_popcountll(this->word[j]);
+    return count;
+}
+
+__attribute__((target("popcnt")))
+size_t BitVector::Select(size_t k) const
+{
+    for (size_t j = 0; j < this->word.size(); j++){
+        uint64_t w = this->word[j];
+        size_t count = __builtin_popcountll(w);
+        if (k >= count){
+            k -= count;
+            continue;
+        }
+        // drop the lowest k ones of w, then the lowest remaining one is the answer
+        for (size_t i = 0; i < k; i++) w &= w - 1;
+        return j * 64 + __builtin_ctzll(w);
+    }
+    return this->bit_num;
+}
+
+template <typename Function>
+void BitVector::ForEachOne(Function f) const
+{
+    for (size_t j = 0; j < this->word.size(); j++){
+        for (uint64_t w = this->word[j]; w != 0; w &= w - 1) f(j * 64 + __builtin_ctzll(w));
+    }
+}
+
+template <typename Function>
+void BitVector::Generate(Function f)
+{
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for (size_t j = 0; j < this->word.size(); j++){
+        size_t begin = j * 64;
+        size_t end = std::min(this->bit_num, begin + 64);
+        uint64_t w = 0;
+        for (auto i = begin; i < end; i++) w |= uint64_t(f(i) != 0) << (i - begin);
+        this->word[j] = w;
+    }
+}
+
+void BitVector::ClearPadding()
+{
+    if (this->bit_num % 64 != 0) this->word.back() &= (uint64_t(1) << (this->bit_num % 64)) - 1;
+}
+
+void BitVector::Print() const
+{
+    for (size_t i = 0; i < this->bit_num; i++) std::cout << (*this)[i];
+    std::cout << std::endl;
+}
+
+/*
+** one selection bit per byte packed into LEN bits, for the byte-vector OT receivers:
+** callers must supply at least LEN bits, bits beyond LEN are ignored
+*/
+inline BitVector PackSelectionBits(const std::vector<uint8_t> &vec_selection_bit, size_t LEN)
+{
+    if (vec_selection_bit.size() < LEN){
+        std::cerr << "selection bits are fewer than the number of OTs" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    BitVector selection_bit(vec_selection_bit);
+    selection_bit.Resize(LEN);
+    return selection_bit;
+}
+
+#endif
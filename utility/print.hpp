@@ -19,6 +19,23 @@ void PrintSplitLine(char ch)
     std::cout << std::endl;
 }
 
+/*
+** progress messages of the protocols are silent unless PROTOCOL_LOG is set (the test programs set it):
+** a library caller gets a clean stdout, and the numbers are in the channel metrics
+*/
+inline bool PROTOCOL_LOG = false; 
+
+inline std::ostream &ProtocolLog()
+{
+    static thread_local std::ostream silent(nullptr); 
+    return PROTOCOL_LOG ? std::cout : silent; 
+}
+
+inline void LogSplitLine(char ch)
+{
+    if (PROTOCOL_LOG) PrintSplitLine(ch); 
+}
+
 // print uint_8 in hex
 void PrintBytes(uint8_t* A, size_t LEN)
 {
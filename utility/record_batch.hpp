@@ -0,0 +1,76 @@
+/****************************************************************************
+this hpp implements a batch of variable-length records (emails, phone numbers, device ids)
+records are stored back to back in one byte buffer, record i = data[offsets[i], offsets[i+1]),
+the layout of an Arrow string column: loading millions of records makes two allocations, not millions
+*****************************************************************************
+* @copyright  MIT license (see LICENSE file)
+*****************************************************************************/
+#ifndef KUNLUN_UTILITY_RECORD_BATCH_HPP_
+#define KUNLUN_UTILITY_RECORD_BATCH_HPP_
+
+#include "../include/std.inc"
+
+struct RecordBatch{
+    std::vector<unsigned char> data;
+    std::vector<uint64_t> offsets = {0};  // always Size()+1 entries
+
+    inline size_t Size() const { return this->offsets.size() - 1; }
+
+    inline void Reserve(size_t RECORD_NUM, size_t BYTE_LEN)
+    {
+        this->offsets.reserve(RECORD_NUM + 1);
+        this->data.reserve(BYTE_LEN);
+    }
+
+    inline void Append(const unsigned char *record, size_t LEN)
+    {
+        this->data.insert(this->data.end(), record, record + LEN);
+        this->offsets.emplace_back(this->data.size());
+    }
+
+    inline void Append(const std::string &record)
+    {
+        this->Append(reinterpret_cast<const unsigned char*>(record.data()), record.size());
+    }
+
+    inline std::string operator[](size_t i) const
+    {
+        return std::string(reinterpret_cast<const char*>(this->data.data()) + this->offsets[i], this->offsets[i+1] - this->offsets[i]);
+    }
+};
+
+/*
+** one record per line; "\r\n" line endings are accepted, and a final newline does not start an empty record
+** the whole file is read with one call and split in place
+*/
+inline RecordBatch LoadRecordBatch(const std::string &filename)
+{
+    std::ifstream fin(filename, std::ios::binary | std::ios::ate);
+    if (!fin){
+        std::cerr << filename << " open error" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    RecordBatch batch;
+    size_t FILE_LEN = fin.tellg();
+    batch.data.resize(FILE_LEN);
+    fin.seekg(0);
+    fin.read(reinterpret_cast<char*>(batch.data.data()), FILE_LEN);
+    fin.close();
+
+    // compact the records over the line endings
+    size_t end = 0;
+    for (size_t begin = 0; begin < FILE_LEN; ){
+        const unsigned char *newline = static_cast<const unsigned char*>(memchr(batch.data.data() + begin, '\n', FILE_LEN - begin));
+        size_t line_end = newline ? newline - batch.data.data() : FILE_LEN;
+        size_t LEN = line_end - begin;
+        if (LEN > 0 && batch.data[begin + LEN - 1] == '\r') LEN--;
+        memmove(batch.data.data() + end, batch.data.data() + begin, LEN);
+        end += LEN;
+        batch.offsets.emplace_back(end);
+        begin = line_end + 1;
+    }
+    batch.data.resize(end);
+    return batch;
+}
+
+#endif
@@ -19,6 +19,7 @@ struct PP
     size_t MAX_AGG_NUM; // number of sub-argument (for now, we require m to be the power of 2)
 
     ECPoint g, h;
+    bool G_IS_GENERATOR = false; 
     ECPoint u; // used for inside innerproduct statement
     std::vector<ECPoint> vec_g, vec_h; // the pp of innerproduct part    
 };
@@ -38,6 +39,7 @@ std::ifstream &operator>>(std::ifstream &fin, PP& pp)
     fin >> pp.RANGE_LEN >> pp.LOG_RANGE_LEN >> pp.MAX_AGG_NUM; 
 
     fin >> pp.g >> pp.h >> pp.u;
+    pp.G_IS_GENERATOR = (pp.g == ECPoint(generator)); 
 
     pp.vec_g.resize(pp.RANGE_LEN * pp.MAX_AGG_NUM); 
     pp.vec_h.resize(pp.RANGE_LEN * pp.MAX_AGG_NUM); 
@@ -85,13 +87,7 @@ std::ifstream &operator>>(std::ifstream &fin, Proof &proof)
 /* generate a^n = (a^0, a^1, a^2, ..., a^{n-1}) */ 
 std::vector<BigInt> GenBigIntPowerVector(size_t LEN, const BigInt &a)
 {
-    std::vector<BigInt> vec_result(LEN);
-    vec_result[0] = BigInt(bn_1); 
-    for (auto i = 1; i < LEN; i++)
-    {
-        vec_result[i] = (vec_result[i-1] * a) % order; // result[i] = result[i-1]*a % order
-    }
-    return vec_result; 
+    return GenScalarPowerVector(LEN, a); 
 }
 
 void PrintProof(Proof &proof)
@@ -126,6 +122,7 @@ PP Setup(size_t &RANGE_LEN, size_t &MAX_AGG_NUM)
     pp.MAX_AGG_NUM = MAX_AGG_NUM; 
  
     pp.g = generator; 
+    pp.G_IS_GENERATOR = true; 
     pp.h = Hash::StringToECPoint(pp.g.ToByteString()); 
     pp.u = GenRandomGenerator();
 
@@ -136,7 +133,7 @@ PP Setup(size_t &RANGE_LEN, size_t &MAX_AGG_NUM)
 }
 
 // statement C = g^r h^v and v \in [0, 2^n-1]
-void Prove(PP &pp, Instance &instance, Witness &witness, std::string &transcript_str, Proof &proof)
+void Prove(PP &pp, Instance &instance, Witness &witness, Transcript &transcript, Proof &proof)
 { 
     auto start_time = std::chrono::steady_clock::now(); 
 
@@ -194,15 +191,15 @@ void Prove(PP &pp, Instance &instance, Witness &witness, std::string &transcript
     proof.S = ECPointVectorMul(vec_A, vec_a); // Eq (47) 
 
     // Eq (49, 50) compute y and z
-    transcript_str += proof.A.ToByteString(); 
-    BigInt y = Hash::StringToBigInt(transcript_str);
+    transcript.Append("A", proof.A); 
+    BigInt y = transcript.Challenge("y");
 
     BigInt y_inverse = y.ModInverse(order);
      
     std::vector<BigInt> vec_y_inverse_power = GenBigIntPowerVector(LEN, y_inverse); // y^{-i+1}
 
-    transcript_str += proof.S.ToByteString(); 
-    BigInt z = Hash::StringToBigInt(transcript_str);
+    transcript.Append("S", proof.S); 
+    BigInt z = transcript.Challenge("z");
 
     BigInt z_square = z.ModSquare(order);
     BigInt z_cubic = (z * z_square) % order;
@@ -226,7 +223,7 @@ void Prove(PP &pp, Instance &instance, Witness &witness, std::string &transcript
     // compute r(X)     
     std::vector<BigInt> vec_y_power = GenBigIntPowerVector(LEN, y); // y^nm
     std::vector<BigInt> vec_zz_temp = BigIntVectorModAdd(vec_z_unary, vec_aR, BigInt(order)); // vec_t = aR + z1^nm
-    std::vector<BigInt> poly_rr0 = BigIntVectorModProduct(vec_y_power, vec_zz_temp, BigInt(order)); // y^nm(aR + z1^nm)
+    std::vector<BigInt> poly_rr0 = ScalarVectorProduct(vec_y_power, vec_zz_temp); // y^nm(aR + z1^nm)
     
     std::vector<BigInt> vec_short_2_power = GenBigIntPowerVector(pp.RANGE_LEN, bn_2); // 2^n
 
@@ -240,18 +237,18 @@ void Prove(PP &pp, Instance &instance, Witness &witness, std::string &transcript
         for (auto i = 0; i < (n-j)*pp.RANGE_LEN; i++) 
             vec_zz_temp[j*pp.RANGE_LEN+i] = bn_0;
 
-        vec_zz_temp = BigIntVectorModScalar(vec_zz_temp, vec_adjust_z_power[j], BigInt(order)); 
+        vec_zz_temp = ScalarVectorScalar(vec_zz_temp, vec_adjust_z_power[j]); 
         poly_rr0 = BigIntVectorModAdd(poly_rr0, vec_zz_temp, BigInt(order));  
     }
-    std::vector<BigInt> poly_rr1 = BigIntVectorModProduct(vec_y_power, vec_sR, BigInt(order)); //y^nsR X
+    std::vector<BigInt> poly_rr1 = ScalarVectorProduct(vec_y_power, vec_sR); //y^nsR X
 
     // compute t(X) 
-    BigInt t0 = BigIntVectorModInnerProduct(poly_ll0, poly_rr0, BigInt(order)); 
-    BigInt bn_temp1 = BigIntVectorModInnerProduct(poly_ll1, poly_rr0, BigInt(order)); 
-    BigInt bn_temp2 = BigIntVectorModInnerProduct(poly_ll0, poly_rr1, BigInt(order));
+    BigInt t0 = ScalarVectorInnerProduct(poly_ll0, poly_rr0); 
+    BigInt bn_temp1 = ScalarVectorInnerProduct(poly_ll1, poly_rr0); 
+    BigInt bn_temp2 = ScalarVectorInnerProduct(poly_ll0, poly_rr1);
     BigInt t1 = (bn_temp1 + bn_temp2) % BigInt(order);  
   
-    BigInt t2 = BigIntVectorModInnerProduct(poly_ll1, poly_rr1, BigInt(order)); 
+    BigInt t2 = ScalarVectorInnerProduct(poly_ll1, poly_rr1); 
 
     // Eq (53) -- commit to t1, t2
     // P picks tau1 and tau2
@@ -267,19 +264,19 @@ void Prove(PP &pp, Instance &instance, Witness &witness, std::string &transcript
     proof.T2 = ECPointVectorMul(vec_A, vec_a); //pp.g * tau2 + pp.h * t2; mul(tau2, pp.g, t2, pp.h);    
 
     // Eq (56) -- compute the challenge x
-    transcript_str += proof.T1.ToByteString() + proof.T2.ToByteString(); 
-    BigInt x = Hash::StringToBigInt(transcript_str); 
+    transcript.Append("T1", proof.T1); 
+    transcript.Append("T2", proof.T2); 
+    BigInt x = transcript.Challenge("x"); 
 
     BigInt x_square = x.ModSquare(order);   
 
     // compute the value of l(x) and r(x) at point x
-    vec_zz_temp = BigIntVectorModScalar(poly_ll1, x, BigInt(order));
-    std::vector<BigInt> llx = BigIntVectorModAdd(poly_ll0, vec_zz_temp, BigInt(order));
+    BigInt bn_one = bn_1; 
+    std::vector<BigInt> llx = ScalarVectorFold(poly_ll0, poly_ll1, bn_one, x); // l(x) = l0 + l1 x
 
-    vec_zz_temp = BigIntVectorModScalar(poly_rr1, x, BigInt(order)); 
-    std::vector<BigInt> rrx = BigIntVectorModAdd(poly_rr0, vec_zz_temp, BigInt(order)); 
+    std::vector<BigInt> rrx = ScalarVectorFold(poly_rr0, poly_rr1, bn_one, x); // r(x) = r0 + r1 x
 
-    proof.tx = BigIntVectorModInnerProduct(llx, rrx, BigInt(order));  // Eq (60)  
+    proof.tx = ScalarVectorInnerProduct(llx, rrx);  // Eq (60)  
  
     // compute taux
     proof.taux = (tau1 * x + tau2 * x_square) % order; //proof.taux = tau2*x_square + tau1*x; 
@@ -301,8 +298,7 @@ void Prove(PP &pp, Instance &instance, Witness &witness, std::string &transcript
     std::copy(pp.vec_h.begin(), pp.vec_h.begin()+LEN, ip_pp.vec_h.begin()); 
     ip_pp.vec_h = ECPointVectorProduct(ip_pp.vec_h, vec_y_inverse_power);  // ip_pp.vec_h = vec_h_new  
 
-    transcript_str += x.ToByteString();  
-    BigInt e = Hash::StringToBigInt(transcript_str);   
+    BigInt e = transcript.Challenge("e");  // play the role of x_u
 
     InnerProduct::Witness ip_witness;
     ip_witness.vec_a = llx; // ip_witness.vec_a = llx
@@ -323,14 +319,14 @@ void Prove(PP &pp, Instance &instance, Witness &witness, std::string &transcript
 
     ip_instance.P = ECPointVectorMul(vec_A, vec_a);  
  
-    InnerProduct::Prove(ip_pp, ip_instance, ip_witness, transcript_str, proof.ip_proof); 
+    InnerProduct::Prove(ip_pp, ip_instance, ip_witness, transcript, proof.ip_proof); 
 
     #ifdef DEBUG
         std::cout << "Bullet Proof Generation Succeeds >>>" << std::endl; 
     #endif
 }
 
-bool Verify(PP &pp, Instance &instance, std::string &transcript_str, Proof &proof)
+bool Verify(PP &pp, Instance &instance, Transcript &transcript, Proof &proof)
 {
     #ifdef DEBUG
         std::cout << "begin to check the proof" << std::endl; 
@@ -338,23 +334,23 @@ bool Verify(PP &pp, Instance &instance, std::string &transcript_str, Proof &proo
 
     bool V1, V2, Validity; // variables for checking results
 
-    transcript_str += proof.A.ToByteString(); 
-    BigInt y = Hash::StringToBigInt(transcript_str);  //recover the challenge y
+    transcript.Append("A", proof.A); 
+    BigInt y = transcript.Challenge("y");  //recover the challenge y
     BigInt y_inverse = y.ModInverse(order);  
     
-    transcript_str += proof.S.ToByteString(); 
-    BigInt z = Hash::StringToBigInt(transcript_str); // recover the challenge z
+    transcript.Append("S", proof.S); 
+    BigInt z = transcript.Challenge("z"); // recover the challenge z
 
     BigInt z_minus = z.ModNegate(order); 
     BigInt z_square = z.ModSquare(order); // (z*z)%q; 
     BigInt z_cubic = (z * z_square) % order; 
 
-    transcript_str += proof.T1.ToByteString() + proof.T2.ToByteString(); 
-    BigInt x = Hash::StringToBigInt(transcript_str); 
+    transcript.Append("T1", proof.T1); 
+    transcript.Append("T2", proof.T2); 
+    BigInt x = transcript.Challenge("x"); 
     BigInt x_square = x.ModSquare(order);  // (x*x)%q;  //recover the challenge x from PI
 
-    transcript_str += x.ToByteString(); 
-    BigInt e = Hash::StringToBigInt(transcript_str);  // play the role of x_u
+    BigInt e = transcript.Challenge("e");  // play the role of x_u
 
     size_t n = instance.C.size();
     size_t LEN = pp.RANGE_LEN * n; // l = nm 
@@ -380,8 +376,8 @@ bool Verify(PP &pp, Instance &instance, std::string &transcript_str, Proof &proo
     sum_z = (sum_z * z) % order;  
 
     // compute delta_yz (pp. 21)    
-    BigInt bn_temp1 = BigIntVectorModInnerProduct(vec_1_power, vec_y_power, BigInt(order)); 
-    BigInt bn_temp2 = BigIntVectorModInnerProduct(vec_short_1_power, vec_short_2_power, BigInt(order)); 
+    BigInt bn_temp1 = ScalarVectorInnerProduct(vec_1_power, vec_y_power); 
+    BigInt bn_temp2 = ScalarVectorInnerProduct(vec_short_1_power, vec_short_2_power); 
 
     BigInt bn_c0 = z.ModSub(z_square, order); // z-z^2
     bn_temp1 = bn_c0 * bn_temp1; 
@@ -391,7 +387,7 @@ bool Verify(PP &pp, Instance &instance, std::string &transcript_str, Proof &proo
 
 
     // check Eq (72)  
-    ECPoint LEFT = pp.g * proof.taux + pp.h * proof.tx;  // LEFT = g^{\taux} h^\hat{t}
+    ECPoint LEFT = GPower(pp.g, pp.G_IS_GENERATOR, proof.taux) + pp.h * proof.tx;  // LEFT = g^{\taux} h^\hat{t}
 
     // the intermediate variables used to compute the right value
     std::vector<ECPoint> vec_A; 
@@ -447,11 +443,11 @@ bool Verify(PP &pp, Instance &instance, std::string &transcript_str, Proof &proo
     std::vector<BigInt> vec_z_minus_unary(LEN, z_minus); 
     std::move(vec_z_minus_unary.begin(), vec_z_minus_unary.end(), vec_a.begin()); // LEFT += g^{-1 z^n} 
 
-    std::vector<BigInt> vec_rr = BigIntVectorModScalar(vec_y_power, z, BigInt(order)); // z y^nm
+    std::vector<BigInt> vec_rr = ScalarVectorScalar(vec_y_power, z); // z y^nm
     std::vector<BigInt> temp_vec_zz; 
     for(auto j = 1; j <= n; j++)
     {
-        temp_vec_zz = BigIntVectorModScalar(vec_2_power, vec_adjust_z_power[j], BigInt(order)); 
+        temp_vec_zz = ScalarVectorScalar(vec_2_power, vec_adjust_z_power[j]); 
         for(auto i = 0; i < pp.RANGE_LEN; i++)
         {
             vec_rr[(j-1)*pp.RANGE_LEN+i] = (vec_rr[(j-1)*pp.RANGE_LEN+i] + temp_vec_zz[i]) % order;            
@@ -467,7 +463,7 @@ bool Verify(PP &pp, Instance &instance, std::string &transcript_str, Proof &proo
 
     ip_instance.P = ECPointVectorMul(vec_A, vec_a);  // set P_new = A + S^x + h^{-mu} u^tx  
 
-    V2 = InnerProduct::FastVerify(ip_pp, ip_instance, transcript_str, proof.ip_proof); 
+    V2 = InnerProduct::FastVerify(ip_pp, ip_instance, transcript, proof.ip_proof); 
     #ifdef DEBUG
         std::cout << std::boolalpha << "Condition 2 (Aggregating Log Size BulletProof) = " << V2 << std::endl; 
     #endif
@@ -486,30 +482,30 @@ bool Verify(PP &pp, Instance &instance, std::string &transcript_str, Proof &proo
 }
 
 
-bool FastVerify(const PP &pp, Instance &instance, std::string &transcript_str, Proof &proof)
+bool FastVerify(const PP &pp, Instance &instance, Transcript &transcript, Proof &proof)
 {
     #ifdef DEBUG
         std::cout << "begin to check the proof" << std::endl; 
     #endif
 
     // prepare Eq (97)
-    transcript_str += proof.A.ToByteString(); 
-    BigInt y = Hash::StringToBigInt(transcript_str);  //recover the challenge y
+    transcript.Append("A", proof.A); 
+    BigInt y = transcript.Challenge("y");  //recover the challenge y
     BigInt y_inverse = y.ModInverse(order); 
 
-    transcript_str += proof.S.ToByteString(); 
-    BigInt z = Hash::StringToBigInt(transcript_str); // recover the challenge z
+    transcript.Append("S", proof.S); 
+    BigInt z = transcript.Challenge("z"); // recover the challenge z
 
     BigInt z_minus = z.ModNegate(order); 
     BigInt z_square = z.ModSquare(order); // (z*z)%q; 
     BigInt z_cubic = (z * z_square) % order; 
 
-    transcript_str += proof.T1.ToByteString() + proof.T2.ToByteString(); 
-    BigInt x = Hash::StringToBigInt(transcript_str); 
+    transcript.Append("T1", proof.T1); 
+    transcript.Append("T2", proof.T2); 
+    BigInt x = transcript.Challenge("x"); 
     BigInt x_square = x.ModSquare(order);  // (x*x)%q;  //recover the challenge x from PI
 
-    transcript_str += x.ToByteString(); 
-    BigInt e = Hash::StringToBigInt(transcript_str);  // play the role of x_u
+    BigInt e = transcript.Challenge("e");  // play the role of x_u
 
     size_t n = instance.C.size();
     size_t VECTOR_LEN = pp.RANGE_LEN * n; 
@@ -538,8 +534,8 @@ bool FastVerify(const PP &pp, Instance &instance, std::string &transcript_str, P
     sum_z = (sum_z * z) % order;  
 
     // compute delta_yz (pp. 21)    
-    BigInt bn_temp1 = BigIntVectorModInnerProduct(vec_1_power, vec_y_power, BigInt(order)); 
-    BigInt bn_temp2 = BigIntVectorModInnerProduct(vec_short_1_power, vec_short_2_power, BigInt(order)); 
+    BigInt bn_temp1 = ScalarVectorInnerProduct(vec_1_power, vec_y_power); 
+    BigInt bn_temp2 = ScalarVectorInnerProduct(vec_short_1_power, vec_short_2_power); 
 
     BigInt bn_c0 = z.ModSub(z_square, order); // z-z^2
     bn_temp1 = bn_c0 * bn_temp1; 
@@ -600,8 +596,9 @@ bool FastVerify(const PP &pp, Instance &instance, std::string &transcript_str, P
     
     for (auto i = 0; i < LOG_VECTOR_LEN; i++)
     {  
-        transcript_str += proof.ip_proof.vec_L[i].ToByteString() + proof.ip_proof.vec_R[i].ToByteString(); 
-        vec_x[i] = Hash::StringToBigInt(transcript_str); // reconstruct the challenge
+        transcript.Append("L", proof.ip_proof.vec_L[i]); 
+        transcript.Append("R", proof.ip_proof.vec_R[i]); 
+        vec_x[i] = transcript.Challenge("x"); // reconstruct the challenge
 
         vec_x_square[i] = vec_x[i].ModSquare(order); 
         vec_x_inverse[i] = vec_x[i].ModInverse(order);  
@@ -610,7 +607,7 @@ bool FastVerify(const PP &pp, Instance &instance, std::string &transcript_str, P
 
     // compute vec_s and vec_s_inverse
     std::vector<BigInt> vec_s = InnerProduct::FastComputeVectorSS(vec_x_square, vec_x_inverse); // page 15: the s vector    
-    std::vector<BigInt> vec_s_inverse = BigIntVectorModInverse(vec_s, BigInt(order));  // the s^{-1} vector
+    std::vector<BigInt> vec_s_inverse = ScalarVectorInverse(vec_s);  // the s^{-1} vector
     vec_s = BigIntVectorScalar(vec_s, proof.ip_proof.a); 
     vec_s_inverse = BigIntVectorScalar(vec_s_inverse, proof.ip_proof.b); 
 
@@ -622,10 +619,10 @@ bool FastVerify(const PP &pp, Instance &instance, std::string &transcript_str, P
     index_a += VECTOR_LEN; 
  
 
-    std::vector<BigInt> vec_rr = BigIntVectorModScalar(vec_y_power, z, BigInt(order)); // z y^nm
+    std::vector<BigInt> vec_rr = ScalarVectorScalar(vec_y_power, z); // z y^nm
     std::vector<BigInt> temp_vec_zz; 
     for(auto j = 1; j <= n; j++){
-        temp_vec_zz = BigIntVectorModScalar(vec_2_power, vec_adjust_z_power[j], BigInt(order)); 
+        temp_vec_zz = ScalarVectorScalar(vec_2_power, vec_adjust_z_power[j]); 
         for(auto i = 0; i < pp.RANGE_LEN; i++)
             vec_rr[(j-1)*pp.RANGE_LEN+i] = (vec_rr[(j-1)*pp.RANGE_LEN+i] + temp_vec_zz[i]) % order;            
     }
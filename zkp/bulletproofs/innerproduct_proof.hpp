@@ -6,6 +6,8 @@ this hpp implements the inner product proof system
 
 #include "../../crypto/ec_point.hpp"
 #include "../../crypto/hash.hpp"
+#include "../../crypto/transcript.hpp"
+#include "../../crypto/scalar256.hpp"
 
 namespace InnerProduct{
 
@@ -147,6 +149,7 @@ void ComputeVectorSS(std::vector<BigInt> &vec_s, std::vector<BigInt> &vec_x, std
     
     // compute s[0], ..., s[i-1]
     // vector<BIGNUM *> vec_s(n); 
+    BigInt bn_order(order); 
     uint64_t flag; 
     for (auto i = 0; i < n; i++)
     {
@@ -155,10 +158,10 @@ void ComputeVectorSS(std::vector<BigInt> &vec_s, std::vector<BigInt> &vec_x, std
         {
             flag = GetTheNthBitofInt(i, j, m);
             if (flag == 1){
-                vec_s[i] = (vec_s[i] * vec_x[j]) % order;
+                vec_s[i].ModMulInPlace(vec_x[j], bn_order);
             } 
             else{
-                vec_s[i] = (vec_s[i] * vec_x_inverse[j]) % order;
+                vec_s[i].ModMulInPlace(vec_x_inverse[j], bn_order);
             } 
         }
     }
@@ -188,9 +191,9 @@ PP Setup(size_t VECTOR_LEN, bool INITIAL_FLAG)
 
 /* 
     Generate an argument PI for Relation 3 on pp.13: P = g^a h^b u^<a,b> 
-    transcript_str is introduced to be used as a sub-protocol 
+    the transcript is passed in so that it can be used as a sub-protocol 
 */
-void Prove(PP pp, Instance instance, Witness witness, std::string &transcript_str, Proof &proof)
+void Prove(PP pp, Instance instance, Witness witness, Transcript &transcript, Proof &proof)
 {
     if (pp.vec_g.size()!=pp.vec_h.size()) 
     {
@@ -238,8 +241,8 @@ void Prove(PP pp, Instance instance, Witness witness, std::string &transcript_st
 
 
         // compute cL, cR
-        BigInt cL = BigIntVectorModInnerProduct(vec_aL, vec_bR, BigInt(order)); // Eq (21)        
-        BigInt cR = BigIntVectorModInnerProduct(vec_aR, vec_bL, BigInt(order)); // Eq (22)
+        BigInt cL = ScalarVectorInnerProduct(vec_aL, vec_bR); // Eq (21)        
+        BigInt cR = ScalarVectorInnerProduct(vec_aR, vec_bL); // Eq (22)
 
         // compute L, R
         std::vector<ECPoint> vec_A(2*n+1); 
@@ -273,8 +276,9 @@ void Prove(PP pp, Instance instance, Witness witness, std::string &transcript_st
         proof.vec_R.emplace_back(R);  // store the n-th round L and R values
 
         // compute the challenge
-        transcript_str += L.ToByteString() + R.ToByteString(); 
-        BigInt x = Hash::StringToBigInt(transcript_str); // compute the n-th round challenge Eq (26,27)
+        transcript.Append("L", L); 
+        transcript.Append("R", R); 
+        BigInt x = transcript.Challenge("x"); // compute the n-th round challenge Eq (26,27)
 
         // x.Print(); 
         BigInt x_inverse = x.ModInverse(order);
@@ -314,21 +318,16 @@ void Prove(PP pp, Instance instance, Witness witness, std::string &transcript_st
         // generate new witness
         Witness witness_sub; 
     
-        vec_aL = BigIntVectorModScalar(vec_aL, x, BigInt(order)); 
-        vec_aR = BigIntVectorModScalar(vec_aR, x_inverse, BigInt(order)); 
-        witness_sub.vec_a = BigIntVectorModAdd(vec_aL, vec_aR, BigInt(order)); // Eq (33)
-
-        vec_bL = BigIntVectorModScalar(vec_bL, x_inverse, BigInt(order)); 
-        vec_bR = BigIntVectorModScalar(vec_bR, x, BigInt(order)); 
-        witness_sub.vec_b = BigIntVectorModAdd(vec_bL, vec_bR, BigInt(order)); // Eq (34)
+        witness_sub.vec_a = ScalarVectorFold(vec_aL, vec_aR, x, x_inverse); // Eq (33)
+        witness_sub.vec_b = ScalarVectorFold(vec_bL, vec_bR, x_inverse, x); // Eq (34)
 
         // recursively invoke the InnerProduct proof
-        Prove(pp_sub, instance_sub, witness_sub, transcript_str, proof); 
+        Prove(pp_sub, instance_sub, witness_sub, transcript, proof); 
     }
 }
 
 /* Check if PI is a valid proof for inner product statement (G1^w = H1 and G2^w = H2) */
-bool Verify(PP &pp, Instance &instance, std::string &transcript_str, Proof &proof)
+bool Verify(PP &pp, Instance &instance, Transcript &transcript, Proof &proof)
 {
     if(IsPowerOfTwo(pp.VECTOR_LEN)==false){
         std::cerr << "VECTOR_LEN must be power of 2" << std::endl; 
@@ -346,8 +345,9 @@ bool Verify(PP &pp, Instance &instance, std::string &transcript_str, Proof &proo
     
     for (auto i = 0; i < pp.LOG_VECTOR_LEN; i++)
     {  
-        transcript_str += proof.vec_L[i].ToByteString() + proof.vec_R[i].ToByteString(); 
-        vec_x[i] = Hash::StringToBigInt(transcript_str); // reconstruct the challenge
+        transcript.Append("L", proof.vec_L[i]); 
+        transcript.Append("R", proof.vec_R[i]); 
+        vec_x[i] = transcript.Challenge("x"); // reconstruct the challenge
 
         vec_x_square[i] = vec_x[i].ModSquare(order); 
         vec_x_inverse[i] = vec_x[i].ModInverse(order);  
@@ -364,13 +364,13 @@ bool Verify(PP &pp, Instance &instance, std::string &transcript_str, Proof &proo
 
 
     ComputeVectorSS(vec_s, vec_x, vec_x_inverse); // page 15: the s vector
-    vec_s_inverse = BigIntVectorModInverse(vec_s, BigInt(order));  // the s^{-1} vector
+    vec_s_inverse = ScalarVectorInverse(vec_s);  // the s^{-1} vector
     vec_s = BigIntVectorScalar(vec_s, proof.a); 
     vec_s_inverse = BigIntVectorScalar(vec_s_inverse, proof.b); 
 
 
-    std::move(pp.vec_g.begin(), pp.vec_g.end(), vec_A.begin());
-    std::move(pp.vec_h.begin(), pp.vec_h.end(), vec_A.begin()+pp.VECTOR_LEN);
+    std::copy(pp.vec_g.begin(), pp.vec_g.end(), vec_A.begin());
+    std::copy(pp.vec_h.begin(), pp.vec_h.end(), vec_A.begin()+pp.VECTOR_LEN);
     vec_A[2*pp.VECTOR_LEN] = pp.u; 
 
     std::move(vec_s.begin(), vec_s.end(), vec_a.begin()); // pp.vec_g, vec_s
@@ -381,8 +381,8 @@ bool Verify(PP &pp, Instance &instance, std::string &transcript_str, Proof &proo
 
     // compute right
     vec_A.resize(2*pp.LOG_VECTOR_LEN+1);  
-    std::move(proof.vec_L.begin(), proof.vec_L.end(), vec_A.begin()); 
-    std::move(proof.vec_R.begin(), proof.vec_R.end(), vec_A.begin()+pp.LOG_VECTOR_LEN); 
+    std::copy(proof.vec_L.begin(), proof.vec_L.end(), vec_A.begin()); 
+    std::copy(proof.vec_R.begin(), proof.vec_R.end(), vec_A.begin()+pp.LOG_VECTOR_LEN); 
 
     vec_a.resize(2*pp.LOG_VECTOR_LEN+1);
     std::move(vec_x_square.begin(), vec_x_square.end(), vec_a.begin()); 
@@ -418,11 +418,12 @@ std::vector<BigInt> FastComputeVectorSS(std::vector<BigInt> &vec_x_square, std::
     size_t m = vec_x_inverse.size(); 
     size_t n = pow(2, m); 
     std::vector<BigInt> vec_s(n, bn_1); 
+    BigInt bn_order(order); 
     
     for (auto j = 0; j < m; j++){
         vec_s[0] *= vec_x_inverse[j];
     }
-    vec_s[0] = vec_s[0] % order; 
+    vec_s[0] %= bn_order; 
 
     // // first compute even
     // for (auto i = 2; i < n; i+=2){
@@ -440,11 +441,22 @@ std::vector<BigInt> FastComputeVectorSS(std::vector<BigInt> &vec_x_square, std::
     *  since we use iterative approach, such precursor always exists
     *  let the differing position be k
     *  then we have z = y * x[k]^2
-    *  we can find the position of z's first 1 as floor(log2())  
+    *  we can find the position of z's first 1 as floor(log2())
     */
+    if (ScalarField::ENABLE){
+        std::vector<Scalar256> vec_s_native(n);
+        std::vector<Scalar256> vec_x_square_native = BigIntVectorToScalar256Vector(vec_x_square);
+        vec_s_native[0] = Scalar256(vec_s[0]);
+        for (auto i = 1; i < n; i++){
+            int k = floor(log2(i));
+            vec_s_native[i] = vec_s_native[i-(1<<k)] * vec_x_square_native[m-1-k];
+        }
+        return Scalar256VectorToBigIntVector(vec_s_native);
+    }
+
     for (auto i = 1; i < n; i++){
         int k = floor(log2(i)); // position of the first 1 of j: e.g, k of 110 = 2 
-        vec_s[i] = (vec_s[i-(1<<k)] * vec_x_square[m-1-k]) % order; 
+        ModMulInto(vec_s[i], vec_s[i-(1<<k)], vec_x_square[m-1-k], bn_order); 
     }
 
     return vec_s;    
@@ -452,7 +464,7 @@ std::vector<BigInt> FastComputeVectorSS(std::vector<BigInt> &vec_x_square, std::
 
 
 // this is the optimized verifier algorithm
-bool FastVerify(PP &pp, Instance &instance, std::string &transcript_str, Proof &proof)
+bool FastVerify(PP &pp, Instance &instance, Transcript &transcript, Proof &proof)
 {
     if(IsPowerOfTwo(pp.VECTOR_LEN)==false){
         std::cerr << "VECTOR_LEN must be power of 2" << std::endl; 
@@ -470,8 +482,9 @@ bool FastVerify(PP &pp, Instance &instance, std::string &transcript_str, Proof &
     
     for (auto i = 0; i < pp.LOG_VECTOR_LEN; i++)
     {  
-        transcript_str += proof.vec_L[i].ToByteString() + proof.vec_R[i].ToByteString(); 
-        vec_x[i] = Hash::StringToBigInt(transcript_str); // reconstruct the challenge
+        transcript.Append("L", proof.vec_L[i]); 
+        transcript.Append("R", proof.vec_R[i]); 
+        vec_x[i] = transcript.Challenge("x"); // reconstruct the challenge
         //vec_x[i].Print();
         vec_x_square[i] = vec_x[i].ModSquare(order); 
         vec_x_inverse[i] = vec_x[i].ModInverse(order);  
@@ -484,14 +497,14 @@ bool FastVerify(PP &pp, Instance &instance, std::string &transcript_str, Proof &
 
     // compute scalar for g and h
     std::vector<BigInt> vec_s = FastComputeVectorSS(vec_x_square, vec_x_inverse); // page 15: the s vector
-    std::vector<BigInt> vec_s_inverse = BigIntVectorModInverse(vec_s, BigInt(order));  // the s^{-1} vector
+    std::vector<BigInt> vec_s_inverse = ScalarVectorInverse(vec_s);  // the s^{-1} vector
     vec_s = BigIntVectorScalar(vec_s, proof.a); 
     vec_s_inverse = BigIntVectorScalar(vec_s_inverse, proof.b); 
 
-    std::move(pp.vec_g.begin(), pp.vec_g.end(), vec_A.begin()); 
-    std::move(pp.vec_h.begin(), pp.vec_h.end(), vec_A.begin()+pp.VECTOR_LEN);
-    std::move(proof.vec_L.begin(), proof.vec_L.end(), vec_A.begin()+2*pp.VECTOR_LEN); 
-    std::move(proof.vec_R.begin(), proof.vec_R.end(), vec_A.begin()+2*pp.VECTOR_LEN+pp.LOG_VECTOR_LEN); 
+    std::copy(pp.vec_g.begin(), pp.vec_g.end(), vec_A.begin()); 
+    std::copy(pp.vec_h.begin(), pp.vec_h.end(), vec_A.begin()+pp.VECTOR_LEN);
+    std::copy(proof.vec_L.begin(), proof.vec_L.end(), vec_A.begin()+2*pp.VECTOR_LEN); 
+    std::copy(proof.vec_R.begin(), proof.vec_R.end(), vec_A.begin()+2*pp.VECTOR_LEN+pp.LOG_VECTOR_LEN); 
     vec_A[2*pp.VECTOR_LEN+2*pp.LOG_VECTOR_LEN] = pp.u; 
 
 
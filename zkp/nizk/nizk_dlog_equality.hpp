@@ -6,6 +6,7 @@ this hpp implements NIZKPoK for discrete logarithm equality
 
 #include "../../crypto/ec_point.hpp"
 #include "../../crypto/hash.hpp"
+#include "../../crypto/transcript.hpp"
 
 namespace DLOGEquality{
 
@@ -21,6 +22,7 @@ struct PP
 struct Instance
 {
     ECPoint g1, h1, g2, h2; 
+    bool G1_IS_GENERATOR = false;    // set by the caller when g1 is the curve generator
 }; 
 
 struct Witness
@@ -79,6 +81,15 @@ std::string ProofToByteString(Proof &proof)
 }
 
 
+void AppendInstance(Transcript &transcript, Instance &instance)
+{
+    transcript.DomainSeparate("DLOG equality"); 
+    transcript.Append("g1", instance.g1); 
+    transcript.Append("g2", instance.g2); 
+    transcript.Append("h1", instance.h1); 
+    transcript.Append("h2", instance.h2); 
+}
+
 /* Setup algorithm: do nothing */ 
 PP Setup()
 { 
@@ -89,22 +100,22 @@ PP Setup()
 
 
 // Generate a NIZK proof PI for g1^w = h1 and g2^w = h2
-Proof Prove(PP &pp, Instance &instance, Witness &witness, std::string &transcript_str)
+Proof Prove(PP &pp, Instance &instance, Witness &witness, Transcript &transcript)
 {
     Proof proof; 
     // initialize the transcript with instance 
-    transcript_str += instance.g1.ToByteString() + instance.g2.ToByteString() 
-                    + instance.h1.ToByteString() + instance.h2.ToByteString(); 
+    AppendInstance(transcript, instance); 
     // begin to generate proof
     BigInt a = GenRandomBigIntLessThan(BigInt(order)); // P's randomness used to generate A1, A2
 
-    proof.A1 = instance.g1 * a; // A1 = g1^a
+    proof.A1 = GPower(instance.g1, instance.G1_IS_GENERATOR, a); // A1 = g1^a
     proof.A2 = instance.g2 * a; // A2 = g2^a
 
     // update the transcript 
-    transcript_str += proof.A1.ToByteString() + proof.A2.ToByteString(); 
+    transcript.Append("A1", proof.A1); 
+    transcript.Append("A2", proof.A2); 
     // compute the challenge
-    BigInt e = Hash::StringToBigInt(transcript_str); // V's challenge in Zq; 
+    BigInt e = transcript.Challenge("e"); // V's challenge in Zq; 
 
     // compute the response
     proof.z = (a + e * witness.w) % order; // z = a+e*w mod q
@@ -120,21 +131,21 @@ Proof Prove(PP &pp, Instance &instance, Witness &witness, std::string &transcrip
     Check if PI is a valid NIZK proof for statenent (G1^w = H1 and G2^w = H2)
 */
 
-bool Verify(PP &pp, Instance &instance, std::string &transcript_str, Proof &proof)
+bool Verify(PP &pp, Instance &instance, Transcript &transcript, Proof &proof)
 {
     // initialize the transcript with instance 
-    transcript_str += instance.g1.ToByteString() + instance.g2.ToByteString() 
-                    + instance.h1.ToByteString() + instance.h2.ToByteString(); 
+    AppendInstance(transcript, instance); 
 
     // update the transcript 
-    transcript_str += proof.A1.ToByteString() + proof.A2.ToByteString(); 
+    transcript.Append("A1", proof.A1); 
+    transcript.Append("A2", proof.A2); 
     // compute the challenge
-    BigInt e = Hash::StringToBigInt(transcript_str); // V's challenge in Zq; 
+    BigInt e = transcript.Challenge("e"); // V's challenge in Zq; 
 
     bool condition1, condition2; 
 
     ECPoint LEFT, RIGHT;
-    LEFT = instance.g1 * proof.z; // LEFT = g1^z
+    LEFT = GPower(instance.g1, instance.G1_IS_GENERATOR, proof.z); // LEFT = g1^z
     RIGHT = proof.A1 + instance.h1 * e;  // RIGHT = A1 h1^e  
 
     condition1 = (LEFT==RIGHT); //check g1^z = A1 h1^e
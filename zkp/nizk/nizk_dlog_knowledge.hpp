@@ -6,6 +6,7 @@ this hpp implements NIZKPoK for discrete logarithm equality
 
 #include "../../crypto/ec_point.hpp"
 #include "../../crypto/hash.hpp"
+#include "../../crypto/transcript.hpp"
 
 namespace DLOGKnowledge{
 
@@ -21,6 +22,7 @@ struct PP
 struct Instance
 {
     ECPoint g, h; 
+    bool G_IS_GENERATOR = false;     // set by the caller when g is the curve generator
 }; 
 
 struct Witness
@@ -75,6 +77,13 @@ std::string ProofToByteString(Proof &proof)
 }
 
 
+void AppendInstance(Transcript &transcript, Instance &instance)
+{
+    transcript.DomainSeparate("DLOG knowledge"); 
+    transcript.Append("g", instance.g); 
+    transcript.Append("h", instance.h); 
+}
+
 /* Setup algorithm: do nothing */ 
 PP Setup()
 { 
@@ -85,20 +94,20 @@ PP Setup()
 
 
 // Generate a NIZK proof PI for g1^w = h1 and g2^w = h2
-Proof Prove(PP &pp, Instance &instance, Witness &witness, std::string &transcript_str)
+Proof Prove(PP &pp, Instance &instance, Witness &witness, Transcript &transcript)
 {
     Proof proof; 
     // initialize the transcript with instance 
-    transcript_str += instance.g.ToByteString() + instance.h.ToByteString(); 
+    AppendInstance(transcript, instance); 
     // begin to generate proof
     BigInt a = GenRandomBigIntLessThan(BigInt(order)); // P's randomness used to generate A1, A2
 
-    proof.A = instance.g * a; // A = g1^r
+    proof.A = GPower(instance.g, instance.G_IS_GENERATOR, a); // A = g1^r
 
     // update the transcript 
-    transcript_str += proof.A.ToByteString(); 
+    transcript.Append("A", proof.A); 
     // compute the challenge
-    BigInt e = Hash::StringToBigInt(transcript_str); // V's challenge in Zq; 
+    BigInt e = transcript.Challenge("e"); // V's challenge in Zq; 
 
     // compute the response
     proof.z = (a + e * witness.w) % order; // z = a+e*w mod q
@@ -114,19 +123,19 @@ Proof Prove(PP &pp, Instance &instance, Witness &witness, std::string &transcrip
     Check if PI is a valid NIZK proof for statenent (G1^w = H1 and G2^w = H2)
 */
 
-bool Verify(PP &pp, Instance &instance, std::string &transcript_str, Proof &proof)
+bool Verify(PP &pp, Instance &instance, Transcript &transcript, Proof &proof)
 {
     // initialize the transcript with instance 
-    transcript_str += instance.g.ToByteString() + instance.h.ToByteString(); 
+    AppendInstance(transcript, instance); 
 
     // update the transcript 
-    transcript_str += proof.A.ToByteString(); 
+    transcript.Append("A", proof.A); 
     // compute the challenge
-    BigInt e = Hash::StringToBigInt(transcript_str); // V's challenge in Zq; 
+    BigInt e = transcript.Challenge("e"); // V's challenge in Zq; 
 
     
     ECPoint LEFT, RIGHT;
-    LEFT = instance.g * proof.z; // LEFT = g^z
+    LEFT = GPower(instance.g, instance.G_IS_GENERATOR, proof.z); // LEFT = g^z
     RIGHT = proof.A + instance.h * e;  // RIGHT = A h^e  
 
     bool Validity = (LEFT==RIGHT); //check g^z = A h^e 
@@ -8,6 +8,7 @@ by replacing ElGamal with twisted ElGamal
 
 #include "../../crypto/ec_point.hpp"
 #include "../../crypto/hash.hpp"
+#include "../../crypto/transcript.hpp"
 #include "../../pke/twisted_exponential_elgamal.hpp"
 #include "../../commitment/pedersen.hpp"
 #include "../../utility/polymul.hpp"
@@ -76,7 +77,7 @@ std::vector<size_t> Decompose(size_t l, size_t n, size_t m)
     return vec_index;  
 }  
 
-Proof Prove(PP &pp, Instance &instance, Witness &witness, std::string &transcript_str)
+Proof Prove(PP &pp, Instance &instance, Witness &witness, Transcript &transcript)
 {    
     Proof proof;
     size_t N = instance.vec_CT.size();
@@ -126,13 +127,14 @@ Proof Prove(PP &pp, Instance &instance, Witness &witness, std::string &transcrip
     }
     proof.D = Pedersen::Commit(pp.com_part, vec_d, rD);
 
-    transcript_str += proof.B.ToByteString(); 
-    transcript_str += proof.A.ToByteString();
-    transcript_str += proof.C.ToByteString();
-    transcript_str += proof.D.ToByteString(); 
+    transcript.DomainSeparate("encryption relation"); 
+    transcript.Append("B", proof.B); 
+    transcript.Append("A", proof.A);
+    transcript.Append("C", proof.C);
+    transcript.Append("D", proof.D); 
 
     // compute the challenge
-    BigInt x = Hash::StringToBigInt(transcript_str); // apply FS-transform to generate the challenge
+    BigInt x = transcript.Challenge("x"); // apply FS-transform to generate the challenge
 
     // compute the response     
     proof.vec_f.resize(pp.m * pp.n); 
@@ -194,18 +196,19 @@ Proof Prove(PP &pp, Instance &instance, Witness &witness, std::string &transcrip
 
 
 // check NIZK proof PI for Ci = Enc(pki, m; r) the witness is (r1, r2, m)
-bool Verify(PP &pp, Instance &instance, std::string &transcript_str, Proof &proof)
+bool Verify(PP &pp, Instance &instance, Transcript &transcript, Proof &proof)
 {    
     size_t N = instance.vec_CT.size();
     pp.m = log(N)/log(pp.n);
     
-    transcript_str += proof.B.ToByteString(); 
-    transcript_str += proof.A.ToByteString();
-    transcript_str += proof.C.ToByteString();
-    transcript_str += proof.D.ToByteString(); 
+    transcript.DomainSeparate("encryption relation"); 
+    transcript.Append("B", proof.B); 
+    transcript.Append("A", proof.A);
+    transcript.Append("C", proof.C);
+    transcript.Append("D", proof.D); 
 
     // compute the challenge
-    BigInt x = Hash::StringToBigInt(transcript_str); // apply FS-transform to generate the challenge
+    BigInt x = transcript.Challenge("x"); // apply FS-transform to generate the challenge
 
     std::vector<bool> vec_condition(4, true);
     // check condition 1
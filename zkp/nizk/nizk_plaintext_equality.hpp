@@ -7,6 +7,7 @@ this hpp implements NIZKPoK for three twisited ElGamal ciphertexts
 
 #include "../../crypto/ec_point.hpp"
 #include "../../crypto/hash.hpp"
+#include "../../crypto/transcript.hpp"
 #include "../../pke/twisted_exponential_elgamal.hpp"
 
 namespace PlaintextEquality{
@@ -121,20 +122,24 @@ PP Setup(TwistedExponentialElGamal::PP pp_enc)
     return pp;
 }
 
-// generate NIZK proof for Ci = Enc(pki, v; r) i={1,2,3} the witness is (r, v)
-Proof Prove(PP &pp, Instance &instance, Witness &witness, std::string &transcript_str)
-{    
-    Proof proof; 
-    // initialize the transcript with instance
+void AppendInstance(Transcript &transcript, Instance &instance)
+{
+    transcript.DomainSeparate("plaintext equality"); 
     for(auto i = 0; i < instance.vec_pk.size(); i++){
-        transcript_str += instance.vec_pk[i].ToByteString();
+        transcript.Append("pk_i", instance.vec_pk[i]);
     }
-
     for(auto i = 0; i < instance.vec_pk.size(); i++){
-        transcript_str += instance.ct.vec_X[i].ToByteString();
+        transcript.Append("X_i", instance.ct.vec_X[i]);
     } 
+    transcript.Append("Y", instance.ct.Y); 
+}
 
-    transcript_str += instance.ct.Y.ToByteString(); 
+// generate NIZK proof for Ci = Enc(pki, v; r) i={1,2,3} the witness is (r, v)
+Proof Prove(PP &pp, Instance &instance, Witness &witness, Transcript &transcript)
+{    
+    Proof proof; 
+    // initialize the transcript with instance
+    AppendInstance(transcript, instance); 
 
     BigInt a = GenRandomBigIntLessThan(order);
     size_t n = instance.vec_pk.size();
@@ -150,12 +155,12 @@ Proof Prove(PP &pp, Instance &instance, Witness &witness, std::string &transcrip
 
     // update the transcript with the first round message
     for(auto i = 0; i < instance.vec_pk.size(); i++){
-        transcript_str += proof.vec_A[i].ToByteString();
+        transcript.Append("A_i", proof.vec_A[i]);
     } 
-    transcript_str += proof.B.ToByteString();  
+    transcript.Append("B", proof.B);  
                      
     // compute the challenge
-    BigInt e = Hash::StringToBigInt(transcript_str); // apply FS-transform to generate the challenge
+    BigInt e = transcript.Challenge("e"); // apply FS-transform to generate the challenge
 
     // compute the response 
     proof.z = (a + e * witness.r) % order; // z = a+e*r mod q 
@@ -170,26 +175,18 @@ Proof Prove(PP &pp, Instance &instance, Witness &witness, std::string &transcrip
 
 
 // check NIZK proof PI for Ci = Enc(pki, m; r) the witness is (r1, r2, m)
-bool Verify(PP &pp, Instance &instance, std::string &transcript_str, Proof &proof)
+bool Verify(PP &pp, Instance &instance, Transcript &transcript, Proof &proof)
 {
     // initialize the transcript with instance
-    for(auto i = 0; i < instance.vec_pk.size(); i++){
-        transcript_str += instance.vec_pk[i].ToByteString();
-    }
-
-    for(auto i = 0; i < instance.vec_pk.size(); i++){
-        transcript_str += instance.ct.vec_X[i].ToByteString();
-    } 
-
-    transcript_str += instance.ct.Y.ToByteString(); 
+    AppendInstance(transcript, instance); 
 
     for(auto i = 0; i < instance.vec_pk.size(); i++){
-        transcript_str += proof.vec_A[i].ToByteString();
+        transcript.Append("A_i", proof.vec_A[i]);
     } 
-    transcript_str += proof.B.ToByteString();  
+    transcript.Append("B", proof.B);  
     
     // compute the challenge
-    BigInt e = Hash::StringToBigInt(transcript_str); // apply FS-transform to generate the challenge
+    BigInt e = transcript.Challenge("e"); // apply FS-transform to generate the challenge
 
     size_t n = instance.vec_pk.size();
     std::vector<bool> vec_condition(n+1);
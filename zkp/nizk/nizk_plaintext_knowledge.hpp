@@ -6,6 +6,7 @@ this hpp implements NIZKPoK for twisted ElGamal ciphertext
 
 #include "../../crypto/ec_point.hpp"
 #include "../../crypto/hash.hpp"
+#include "../../crypto/transcript.hpp"
 #include "../../pke/twisted_exponential_elgamal.hpp"
 
 namespace PlaintextKnowledge{
@@ -104,12 +105,20 @@ PP Setup(TwistedExponentialElGamal::PP pp_enc)
 }
 
 
+void AppendInstance(Transcript &transcript, Instance &instance)
+{
+    transcript.DomainSeparate("plaintext knowledge"); 
+    transcript.Append("pk", instance.pk); 
+    transcript.Append("X", instance.ct.X); 
+    transcript.Append("Y", instance.ct.Y); 
+}
+
 // generate NIZK proof for C = Enc(pk, v; r) with witness (r, v)
-Proof Prove(PP &pp, Instance &instance, Witness &witness, std::string &transcript_str)
+Proof Prove(PP &pp, Instance &instance, Witness &witness, Transcript &transcript)
 {   
     Proof proof;
     // initialize the transcript with instance 
-    transcript_str += instance.pk.ToByteString() + instance.ct.X.ToByteString() + instance.ct.Y.ToByteString(); 
+    AppendInstance(transcript, instance); 
     
     BigInt a = GenRandomBigIntLessThan(order); 
     proof.A = instance.pk * a; // A = pk^a
@@ -122,10 +131,11 @@ Proof Prove(PP &pp, Instance &instance, Witness &witness, std::string &transcrip
     proof.B = ECPointVectorMul(vec_base, vec_x); // B = g^a h^b
 
     // update the transcript with the first round message
-    transcript_str += proof.A.ToByteString() + proof.B.ToByteString(); 
+    transcript.Append("A", proof.A); 
+    transcript.Append("B", proof.B); 
 
     // computer the challenge
-    BigInt e = Hash::StringToBigInt(transcript_str); // V's challenge in Zq: apply FS-transform to generate the challenge
+    BigInt e = transcript.Challenge("e"); // V's challenge in Zq: apply FS-transform to generate the challenge
     
     // compute the response 
     proof.z1 = (a + e * witness.r) % order; // z1 = a+e*r mod q
@@ -140,16 +150,17 @@ Proof Prove(PP &pp, Instance &instance, Witness &witness, std::string &transcrip
 
 
 // check NIZKPoK for C = Enc(pk, v; r) 
-bool Verify(PP &pp, Instance &instance, std::string &transcript_str, Proof &proof)
+bool Verify(PP &pp, Instance &instance, Transcript &transcript, Proof &proof)
 {    
     // initialize the transcript with instance 
-    transcript_str += instance.pk.ToByteString() + instance.ct.X.ToByteString() + instance.ct.Y.ToByteString(); 
+    AppendInstance(transcript, instance); 
 
     // update the transcript with the first round message
-    transcript_str += proof.A.ToByteString() + proof.B.ToByteString(); 
+    transcript.Append("A", proof.A); 
+    transcript.Append("B", proof.B); 
     
     // recover the challenge
-    BigInt e = Hash::StringToBigInt(transcript_str); // apply FS-transform to generate the challenge
+    BigInt e = transcript.Challenge("e"); // apply FS-transform to generate the challenge
 
     std::vector<bool> vec_condition(2); 
     ECPoint LEFT, RIGHT;